@@ -241,6 +241,21 @@ dashboard_log_record_cmd_callback (GimpAction *action,
                             G_CALLBACK (gimp_toggle_button_update),
                             &info->params.progressive);
 
+          toggle = gtk_check_button_new_with_mnemonic (_("_Trace"));
+          gimp_help_set_help_data (toggle,
+                                   _("Write trace spans to a separate file "
+                                     "next to the log"),
+                                   NULL);
+          gtk_box_pack_start (GTK_BOX (hbox), toggle, FALSE, FALSE, 0);
+          gtk_widget_show (toggle);
+
+          gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (toggle),
+                                        info->params.trace);
+
+          g_signal_connect (toggle, "toggled",
+                            G_CALLBACK (gimp_toggle_button_update),
+                            &info->params.trace);
+
           g_signal_connect (dialog, "response",
                             G_CALLBACK (dashboard_log_record_response),
                             dashboard);
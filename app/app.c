@@ -54,6 +54,7 @@
 
 #include "core/gimp.h"
 #include "core/gimp-batch.h"
+#include "core/gimp-trace.h"
 #include "core/gimp-user-install.h"
 #include "core/gimpimage.h"
 
@@ -183,7 +184,8 @@ app_run (const gchar         *full_prog_name,
          gboolean             show_debug_menu,
          GimpStackTraceMode   stack_trace_mode,
          GimpPDBCompatMode    pdb_compat_mode,
-         const gchar         *backtrace_file)
+         const gchar         *backtrace_file,
+         GFile               *profile_startup_file)
 {
   GimpInitStatusFunc  update_status_func = NULL;
   Gimp               *gimp;
@@ -194,6 +196,9 @@ app_run (const gchar         *full_prog_name,
   const gchar        *abort_message;
   GError             *font_error = NULL;
 
+  if (profile_startup_file)
+    gimp_trace_start ();
+
   if (filenames && filenames[0] && ! filenames[1] &&
       g_file_test (filenames[0], G_FILE_TEST_IS_DIR))
     {
@@ -261,7 +266,9 @@ app_run (const gchar         *full_prog_name,
 
   g_object_unref (gimpdir);
 
+  gimp_trace_begin ("startup", "load-config");
   gimp_load_config (gimp, alternate_system_gimprc, alternate_gimprc);
+  gimp_trace_end ();
 
   /* Initialize the error handling after creating/migrating the config
    * directory because it will create some folders for backup and crash
@@ -284,7 +291,9 @@ app_run (const gchar         *full_prog_name,
     app_abort (no_interface, abort_message);
 
   /*  initialize lowlevel stuff  */
+  gimp_trace_begin ("startup", "gegl-init");
   gimp_gegl_init (gimp);
+  gimp_trace_end ();
 
   /*  Connect our restore_after callback before gui_init() connects
    *  theirs, so ours runs first and can grab the initial monitor
@@ -296,7 +305,11 @@ app_run (const gchar         *full_prog_name,
 
 #ifndef GIMP_CONSOLE_COMPILATION
   if (! no_interface)
-    update_status_func = gui_init (gimp, no_splash);
+    {
+      gimp_trace_begin ("startup", "gui-init");
+      update_status_func = gui_init (gimp, no_splash);
+      gimp_trace_end ();
+    }
 #endif
 
   if (! update_status_func)
@@ -305,11 +318,15 @@ app_run (const gchar         *full_prog_name,
   /*  Create all members of the global Gimp instance which need an already
    *  parsed gimprc, e.g. the data factories
    */
+  gimp_trace_begin ("startup", "initialize");
   gimp_initialize (gimp, update_status_func);
+  gimp_trace_end ();
 
   /*  Load all data files
    */
+  gimp_trace_begin ("startup", "restore");
   gimp_restore (gimp, update_status_func, &font_error);
+  gimp_trace_end ();
 
   /*  enable autosave late so we don't autosave when the
    *  monitor resolution is set in gui_init()
@@ -388,6 +405,8 @@ app_run (const gchar         *full_prog_name,
     {
       gint i;
 
+      gimp_trace_begin ("startup", "open-files");
+
       for (i = 0; filenames[i] != NULL; i++)
         {
           if (run_loop)
@@ -400,6 +419,8 @@ app_run (const gchar         *full_prog_name,
               g_object_unref (file);
             }
         }
+
+      gimp_trace_end ();
     }
 
   /* The software is now fully loaded and ready to be used and get
@@ -407,6 +428,24 @@ app_run (const gchar         *full_prog_name,
    */
   gimp->initialized = TRUE;
 
+  if (profile_startup_file)
+    {
+      GError *error = NULL;
+
+      if (! gimp_trace_stop (profile_startup_file, &error))
+        {
+          g_printerr ("Writing startup profile '%s' failed: %s\n",
+                      gimp_file_get_utf8_name (profile_startup_file),
+                      error->message);
+          g_clear_error (&error);
+        }
+      else if (gimp->be_verbose)
+        {
+          g_print ("Wrote startup profile '%s'\n",
+                   gimp_file_get_utf8_name (profile_startup_file));
+        }
+    }
+
   if (font_error)
     {
       gimp_message_literal (gimp, NULL,
@@ -51,7 +51,8 @@ void  app_run       (const gchar         *full_prog_name,
                      gboolean             show_debug_menu,
                      GimpStackTraceMode   stack_trace_mode,
                      GimpPDBCompatMode    pdb_compat_mode,
-                     const gchar         *backtrace_file);
+                     const gchar         *backtrace_file,
+                     GFile               *profile_startup_file);
 
 
 #endif /* __APP_H__ */
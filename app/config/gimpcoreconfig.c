@@ -107,6 +107,8 @@ enum
   PROP_UNDO_LEVELS,
   PROP_UNDO_SIZE,
   PROP_UNDO_PREVIEW_SIZE,
+  PROP_BRUSH_CACHE_SIZE,
+  PROP_BRUSH_CACHE_PRECISION,
   PROP_FILTER_HISTORY_SIZE,
   PROP_PLUGINRC_PATH,
   PROP_LAYER_PREVIEWS,
@@ -121,6 +123,7 @@ enum
   PROP_IMPORT_PROMOTE_DITHER,
   PROP_IMPORT_ADD_ALPHA,
   PROP_IMPORT_RAW_PLUG_IN,
+  PROP_RESIDENT_FILE_PLUG_INS,
   PROP_EXPORT_FILE_TYPE,
   PROP_EXPORT_COLOR_PROFILE,
   PROP_EXPORT_COMMENT,
@@ -623,6 +626,20 @@ gimp_core_config_class_init (GimpCoreConfigClass *klass)
                          GIMP_PARAM_STATIC_STRINGS |
                          GIMP_CONFIG_PARAM_RESTART);
 
+  GIMP_CONFIG_PROP_MEMSIZE (object_class, PROP_BRUSH_CACHE_SIZE,
+                            "brush-cache-size",
+                            "Brush cache size",
+                            BRUSH_CACHE_SIZE_BLURB,
+                            0, GIMP_MAX_MEMSIZE, 1 << 26, /* 64MB */
+                            GIMP_PARAM_STATIC_STRINGS);
+
+  GIMP_CONFIG_PROP_INT (object_class, PROP_BRUSH_CACHE_PRECISION,
+                        "brush-cache-precision",
+                        "Brush cache precision",
+                        BRUSH_CACHE_PRECISION_BLURB,
+                        0, 1024, 64,
+                        GIMP_PARAM_STATIC_STRINGS);
+
   GIMP_CONFIG_PROP_INT (object_class, PROP_FILTER_HISTORY_SIZE,
                         "plug-in-history-size", /* compat name */
                         "Filter history size",
@@ -772,6 +789,13 @@ gimp_core_config_class_init (GimpCoreConfigClass *klass)
                          GIMP_PARAM_STATIC_STRINGS |
                          GIMP_CONFIG_PARAM_RESTART);
 
+  GIMP_CONFIG_PROP_BOOLEAN (object_class, PROP_RESIDENT_FILE_PLUG_INS,
+                            "resident-file-plug-ins",
+                            "Keep file plug-ins resident",
+                            RESIDENT_FILE_PLUG_INS_BLURB,
+                            FALSE,
+                            GIMP_PARAM_STATIC_STRINGS);
+
   GIMP_CONFIG_PROP_ENUM (object_class, PROP_EXPORT_FILE_TYPE,
                          "export-file-type",
                          "Default export file type",
@@ -1104,6 +1128,12 @@ gimp_core_config_set_property (GObject      *object,
     case PROP_UNDO_PREVIEW_SIZE:
       core_config->undo_preview_size = g_value_get_enum (value);
       break;
+    case PROP_BRUSH_CACHE_SIZE:
+      core_config->brush_cache_size = g_value_get_uint64 (value);
+      break;
+    case PROP_BRUSH_CACHE_PRECISION:
+      core_config->brush_cache_precision = g_value_get_int (value);
+      break;
     case PROP_PLUGINRC_PATH:
       g_free (core_config->plug_in_rc_path);
       core_config->plug_in_rc_path = g_value_dup_string (value);
@@ -1167,6 +1197,9 @@ gimp_core_config_set_property (GObject      *object,
       g_free (core_config->import_raw_plug_in);
       core_config->import_raw_plug_in = g_value_dup_string (value);
       break;
+    case PROP_RESIDENT_FILE_PLUG_INS:
+      core_config->resident_file_plug_ins = g_value_get_boolean (value);
+      break;
     case PROP_EXPORT_FILE_TYPE:
       core_config->export_file_type = g_value_get_enum (value);
       break;
@@ -1366,6 +1399,12 @@ gimp_core_config_get_property (GObject    *object,
     case PROP_UNDO_PREVIEW_SIZE:
       g_value_set_enum (value, core_config->undo_preview_size);
       break;
+    case PROP_BRUSH_CACHE_SIZE:
+      g_value_set_uint64 (value, core_config->brush_cache_size);
+      break;
+    case PROP_BRUSH_CACHE_PRECISION:
+      g_value_set_int (value, core_config->brush_cache_precision);
+      break;
     case PROP_PLUGINRC_PATH:
       g_value_set_string (value, core_config->plug_in_rc_path);
       break;
@@ -1423,6 +1462,9 @@ gimp_core_config_get_property (GObject    *object,
     case PROP_IMPORT_RAW_PLUG_IN:
       g_value_set_string (value, core_config->import_raw_plug_in);
       break;
+    case PROP_RESIDENT_FILE_PLUG_INS:
+      g_value_set_boolean (value, core_config->resident_file_plug_ins);
+      break;
     case PROP_EXPORT_FILE_TYPE:
       g_value_set_enum (value, core_config->export_file_type);
       break;
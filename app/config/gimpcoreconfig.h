@@ -82,6 +82,8 @@ struct _GimpCoreConfig
   gint                    levels_of_undo;
   guint64                 undo_size;
   GimpViewSize            undo_preview_size;
+  guint64                 brush_cache_size;
+  gint                    brush_cache_precision;
   gint                    filter_history_size;
   gchar                  *plug_in_rc_path;
   gboolean                layer_previews;
@@ -96,6 +98,7 @@ struct _GimpCoreConfig
   gboolean                import_promote_dither;
   gboolean                import_add_alpha;
   gchar                  *import_raw_plug_in;
+  gboolean                resident_file_plug_ins;
   GimpExportFileType      export_file_type;
   gboolean                export_color_profile;
   gboolean                export_comment;
@@ -50,6 +50,7 @@ enum
   PROP_SWAP_PATH,
   PROP_SWAP_COMPRESSION,
   PROP_NUM_PROCESSORS,
+  PROP_PIN_ASYNC_THREADS,
   PROP_TILE_CACHE_SIZE,
   PROP_USE_OPENCL,
 
@@ -130,6 +131,14 @@ gimp_gegl_config_class_init (GimpGeglConfigClass *klass)
                         1, max_n_threads, n_threads,
                         GIMP_PARAM_STATIC_STRINGS);
 
+  GIMP_CONFIG_PROP_BOOLEAN (object_class, PROP_PIN_ASYNC_THREADS,
+                            "pin-async-threads",
+                            "Pin async threads to processors",
+                            PIN_ASYNC_THREADS_BLURB,
+                            FALSE,
+                            GIMP_PARAM_STATIC_STRINGS |
+                            GIMP_CONFIG_PARAM_RESTART);
+
   memory_size = gimp_get_physical_memory_size ();
 
   /* limit to the amount one process can handle */
@@ -216,6 +225,9 @@ gimp_gegl_config_set_property (GObject      *object,
     case PROP_NUM_PROCESSORS:
       gegl_config->num_processors = g_value_get_int (value);
       break;
+    case PROP_PIN_ASYNC_THREADS:
+      gegl_config->pin_async_threads = g_value_get_boolean (value);
+      break;
     case PROP_TILE_CACHE_SIZE:
       gegl_config->tile_cache_size = g_value_get_uint64 (value);
       break;
@@ -255,6 +267,9 @@ gimp_gegl_config_get_property (GObject    *object,
     case PROP_NUM_PROCESSORS:
       g_value_set_int (value, gegl_config->num_processors);
       break;
+    case PROP_PIN_ASYNC_THREADS:
+      g_value_set_boolean (value, gegl_config->pin_async_threads);
+      break;
     case PROP_TILE_CACHE_SIZE:
       g_value_set_uint64 (value, gegl_config->tile_cache_size);
       break;
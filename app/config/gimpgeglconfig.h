@@ -39,6 +39,7 @@ struct _GimpGeglConfig
   gchar    *swap_path;
   gchar    *swap_compression;
   gint      num_processors;
+  gboolean  pin_async_threads;
   guint64   tile_cache_size;
   gboolean  use_opencl;
 };
@@ -217,6 +217,12 @@ _("Add an alpha channel to all layers of imported images.")
 #define IMPORT_RAW_PLUG_IN_BLURB \
 _("Which plug-in to use for importing raw digital camera files.")
 
+#define RESIDENT_FILE_PLUG_INS_BLURB \
+_("Keep file plug-ins running after a non-interactive load or export, " \
+  "and reuse them for the next ones, instead of starting a new plug-in " \
+  "process for every file.  This speeds up batch processing of many " \
+  "files, but plug-ins keep their state between files.")
+
 #define EXPORT_FILE_TYPE_BLURB \
 _("Export file type used by default.")
 
@@ -325,6 +331,12 @@ _("Sets the size of the navigation preview available in the lower right " \
 #define NUM_PROCESSORS_BLURB \
 _("Sets how many threads GIMP should use for operations that support it.")
 
+#define PIN_ASYNC_THREADS_BLURB \
+"When enabled, pins each of the threads GIMP uses for asynchronous tasks, " \
+"such as loading and decoding, to a processor of its own.  This can help " \
+"on machines with several memory nodes.  It does not affect the threads " \
+"GEGL uses for rendering."
+
 #define PALETTE_PATH_BLURB \
 "Sets the palette search path."
 
@@ -722,6 +734,16 @@ _("Sets an upper limit to the memory that is used per image to keep " \
 #define UNDO_PREVIEW_SIZE_BLURB \
 _("Sets the size of the previews in the Undo History.")
 
+#define BRUSH_CACHE_SIZE_BLURB \
+_("Sets an upper limit to the memory used to cache transformed brushes " \
+  "while painting.")
+
+#define BRUSH_CACHE_PRECISION_BLURB \
+_("Sets how finely the size, angle, aspect ratio and hardness of brushes " \
+  "are rounded before looking them up in the brush cache.  Lower values " \
+  "make the cache more effective when these vary from dab to dab; 0 " \
+  "disables rounding.")
+
 #define USE_HELP_BLURB \
 _("When enabled, pressing F1 will open the help browser.")
 
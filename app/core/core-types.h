@@ -229,7 +229,10 @@ typedef struct _GimpWaitable                    GimpWaitable;    /* dummy typede
 
 typedef struct _GimpBacktrace                   GimpBacktrace;
 typedef struct _GimpBoundSeg                    GimpBoundSeg;
+typedef struct _GimpBoundaryCache               GimpBoundaryCache;
+typedef struct _GimpChunkCostModel              GimpChunkCostModel;
 typedef struct _GimpChunkIterator               GimpChunkIterator;
+typedef struct _GimpColorIndex                  GimpColorIndex;
 typedef struct _GimpCoords                      GimpCoords;
 typedef struct _GimpGradientSegment             GimpGradientSegment;
 typedef struct _GimpPaletteEntry                GimpPaletteEntry;
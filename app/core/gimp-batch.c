@@ -42,7 +42,8 @@
 
 static void  gimp_batch_exit_after_callback (Gimp          *gimp) G_GNUC_NORETURN;
 
-static void  gimp_batch_run_cmd             (Gimp          *gimp,
+static GimpPDBStatusType
+             gimp_batch_run_cmd             (Gimp          *gimp,
                                              const gchar   *proc_name,
                                              GimpProcedure *procedure,
                                              GimpRunMode    run_mode,
@@ -100,11 +101,40 @@ gimp_batch_run (Gimp         *gimp,
 
       if (eval_proc)
         {
-          gint i;
+          gint64 total_time = 0;
+          gint   n_failed   = 0;
+          gint   i;
 
           for (i = 0; batch_commands[i]; i++)
-            gimp_batch_run_cmd (gimp, batch_interpreter, eval_proc,
-                                GIMP_RUN_NONINTERACTIVE, batch_commands[i]);
+            {
+              GimpPDBStatusType status;
+              gint64            start_time;
+              gint64            time;
+
+              start_time = g_get_monotonic_time ();
+
+              status = gimp_batch_run_cmd (gimp, batch_interpreter, eval_proc,
+                                           GIMP_RUN_NONINTERACTIVE,
+                                           batch_commands[i]);
+
+              time = g_get_monotonic_time () - start_time;
+
+              total_time += time;
+
+              if (status != GIMP_PDB_SUCCESS)
+                n_failed++;
+
+              if (gimp->be_verbose)
+                g_print ("batch command %d: %s, %.3f s\n",
+                         i + 1,
+                         status == GIMP_PDB_SUCCESS ? "success" : "failure",
+                         (gdouble) time / G_TIME_SPAN_SECOND);
+            }
+
+          if (gimp->be_verbose)
+            g_print ("batch commands: %d, failed: %d, total time: %.3f s\n",
+                     i, n_failed,
+                     (gdouble) total_time / G_TIME_SPAN_SECOND);
         }
       else
         {
@@ -141,17 +171,18 @@ GIMP_IS_PARAM_SPEC_RUN_MODE (GParamSpec *pspec)
           pspec->value_type == GIMP_TYPE_RUN_MODE);
 }
 
-static void
+static GimpPDBStatusType
 gimp_batch_run_cmd (Gimp          *gimp,
                     const gchar   *proc_name,
                     GimpProcedure *procedure,
                     GimpRunMode    run_mode,
                     const gchar   *cmd)
 {
-  GimpValueArray *args;
-  GimpValueArray *return_vals;
-  GError         *error = NULL;
-  gint            i     = 0;
+  GimpValueArray    *args;
+  GimpValueArray    *return_vals;
+  GimpPDBStatusType  status;
+  GError            *error = NULL;
+  gint               i     = 0;
 
   args = gimp_procedure_get_arguments (procedure);
 
@@ -173,7 +204,9 @@ gimp_batch_run_cmd (Gimp          *gimp,
                                              NULL, &error,
                                              proc_name, args);
 
-  switch (g_value_get_enum (gimp_value_array_index (return_vals, 0)))
+  status = g_value_get_enum (gimp_value_array_index (return_vals, 0));
+
+  switch (status)
     {
     case GIMP_PDB_EXECUTION_ERROR:
       if (error)
@@ -202,6 +235,9 @@ gimp_batch_run_cmd (Gimp          *gimp,
     case GIMP_PDB_SUCCESS:
       g_printerr ("batch command executed successfully\n");
       break;
+
+    default:
+      break;
     }
 
   gimp_value_array_unref (return_vals);
@@ -210,5 +246,5 @@ gimp_batch_run_cmd (Gimp          *gimp,
   if (error)
     g_error_free (error);
 
-  return;
+  return status;
 }
@@ -32,9 +32,11 @@
 #include "gimp-gradients.h"
 #include "gimp-memsize.h"
 #include "gimp-palettes.h"
+#include "gimp-trace.h"
 #include "gimpcontainer.h"
 #include "gimpbrush-load.h"
 #include "gimpbrush.h"
+#include "gimpbrushcache.h"
 #include "gimpbrushclipboard.h"
 #include "gimpbrushgenerated-load.h"
 #include "gimpbrushpipe-load.h"
@@ -59,6 +61,11 @@
 #include "gimp-intl.h"
 
 
+static void   gimp_data_factories_brush_cache_notify (GimpCoreConfig *config,
+                                                      GParamSpec     *pspec,
+                                                      Gimp           *gimp);
+
+
 void
 gimp_data_factories_init (Gimp *gimp)
 {
@@ -74,6 +81,7 @@ gimp_data_factories_init (Gimp *gimp)
                                   gimp_brush_get_standard);
   gimp_object_set_static_name (GIMP_OBJECT (gimp->brush_factory),
                                "brush factory");
+  gimp_data_loader_factory_set_parallel (gimp->brush_factory, TRUE);
   gimp_data_loader_factory_add_loader (gimp->brush_factory,
                                        "GIMP Brush",
                                        gimp_brush_load,
@@ -115,6 +123,7 @@ gimp_data_factories_init (Gimp *gimp)
                                   gimp_dynamics_get_standard);
   gimp_object_set_static_name (GIMP_OBJECT (gimp->dynamics_factory),
                                "dynamics factory");
+  gimp_data_loader_factory_set_parallel (gimp->dynamics_factory, TRUE);
   gimp_data_loader_factory_add_loader (gimp->dynamics_factory,
                                        "GIMP Paint Dynamics",
                                        gimp_dynamics_load,
@@ -131,6 +140,7 @@ gimp_data_factories_init (Gimp *gimp)
                                   NULL);
   gimp_object_set_static_name (GIMP_OBJECT (gimp->mybrush_factory),
                                "mypaint brush factory");
+  gimp_data_loader_factory_set_parallel (gimp->mybrush_factory, TRUE);
   gimp_data_loader_factory_add_loader (gimp->mybrush_factory,
                                        "MyPaint Brush",
                                        gimp_mybrush_load,
@@ -147,6 +157,7 @@ gimp_data_factories_init (Gimp *gimp)
                                   gimp_pattern_get_standard);
   gimp_object_set_static_name (GIMP_OBJECT (gimp->pattern_factory),
                                "pattern factory");
+  gimp_data_loader_factory_set_parallel (gimp->pattern_factory, TRUE);
   gimp_data_loader_factory_add_loader (gimp->pattern_factory,
                                        "GIMP Pattern",
                                        gimp_pattern_load,
@@ -166,6 +177,7 @@ gimp_data_factories_init (Gimp *gimp)
                                   gimp_gradient_get_standard);
   gimp_object_set_static_name (GIMP_OBJECT (gimp->gradient_factory),
                                "gradient factory");
+  gimp_data_loader_factory_set_parallel (gimp->gradient_factory, TRUE);
   gimp_data_loader_factory_add_loader (gimp->gradient_factory,
                                        "GIMP Gradient",
                                        gimp_gradient_load,
@@ -187,6 +199,7 @@ gimp_data_factories_init (Gimp *gimp)
                                   gimp_palette_get_standard);
   gimp_object_set_static_name (GIMP_OBJECT (gimp->palette_factory),
                                "palette factory");
+  gimp_data_loader_factory_set_parallel (gimp->palette_factory, TRUE);
   gimp_data_loader_factory_add_loader (gimp->palette_factory,
                                        "GIMP Palette",
                                        gimp_palette_load,
@@ -209,6 +222,9 @@ gimp_data_factories_init (Gimp *gimp)
                                   NULL);
   gimp_object_set_static_name (GIMP_OBJECT (gimp->tool_preset_factory),
                                "tool preset factory");
+  /*  no gimp_data_loader_factory_set_parallel() here, loading a tool
+   *  preset creates tool options, which is not thread-safe
+   */
   gimp_data_loader_factory_add_loader (gimp->tool_preset_factory,
                                        "GIMP Tool Preset",
                                        gimp_tool_preset_load,
@@ -352,6 +368,14 @@ gimp_data_factories_load (Gimp               *gimp,
 {
   g_return_if_fail (GIMP_IS_GIMP (gimp));
 
+  g_signal_connect_object (gimp->config, "notify::brush-cache-size",
+                           G_CALLBACK (gimp_data_factories_brush_cache_notify),
+                           gimp, 0);
+  g_signal_connect_object (gimp->config, "notify::brush-cache-precision",
+                           G_CALLBACK (gimp_data_factories_brush_cache_notify),
+                           gimp, 0);
+  gimp_data_factories_brush_cache_notify (gimp->config, NULL, gimp);
+
   /*  initialize the list of gimp brushes    */
   status_callback (NULL, _("Brushes"), 0.1);
   gimp_data_factory_data_init (gimp->brush_factory, gimp->user_context,
@@ -384,7 +408,9 @@ gimp_data_factories_load (Gimp               *gimp,
 
   /*  initialize the color history   */
   status_callback (NULL, _("Color History"), 0.55);
+  gimp_trace_begin ("startup", "color-history");
   gimp_palettes_load (gimp);
+  gimp_trace_end ();
 
   /*  initialize the list of gimp fonts   */
   status_callback (NULL, _("Fonts"), 0.6);
@@ -401,6 +427,7 @@ gimp_data_factories_load (Gimp               *gimp,
 
   /* update tag cache */
   status_callback (NULL, _("Updating tag cache"), 0.75);
+  gimp_trace_begin ("startup", "tag-cache");
   gimp_tag_cache_load (gimp->tag_cache);
   gimp_tag_cache_add_container (gimp->tag_cache,
                                 gimp_data_factory_get_container (gimp->brush_factory));
@@ -418,6 +445,7 @@ gimp_data_factories_load (Gimp               *gimp,
                                 gimp_data_factory_get_container (gimp->font_factory));
   gimp_tag_cache_add_container (gimp->tag_cache,
                                 gimp_data_factory_get_container (gimp->tool_preset_factory));
+  gimp_trace_end ();
 }
 
 void
@@ -438,3 +466,15 @@ gimp_data_factories_save (Gimp *gimp)
 
   gimp_palettes_save (gimp);
 }
+
+
+/*  private functions  */
+
+static void
+gimp_data_factories_brush_cache_notify (GimpCoreConfig *config,
+                                        GParamSpec     *pspec,
+                                        Gimp           *gimp)
+{
+  gimp_brush_cache_set_limits (config->brush_cache_size,
+                               config->brush_cache_precision);
+}
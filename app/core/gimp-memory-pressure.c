@@ -0,0 +1,223 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimp-memory-pressure.c
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <gegl.h>
+#include <gio/gio.h>
+
+#include "core-types.h"
+
+#include "gimp.h"
+#include "gimp-memory-pressure.h"
+#include "gimpbrush.h"
+#include "gimpcontainer.h"
+#include "gimpdatafactory.h"
+
+
+typedef struct
+{
+  guint           id;
+  gint            priority;
+  GimpReclaimFunc func;
+  gpointer        user_data;
+} GimpReclaimer;
+
+
+/*  local function prototypes  */
+
+static gint   gimp_memory_pressure_compare_reclaimers (const GimpReclaimer        *reclaimer1,
+                                                       const GimpReclaimer        *reclaimer2);
+
+static void   gimp_memory_pressure_low_memory_warning (GMemoryMonitor             *monitor,
+                                                       GMemoryMonitorWarningLevel  level,
+                                                       Gimp                       *gimp);
+
+static void   gimp_memory_pressure_reclaim_brushes    (Gimp                       *gimp,
+                                                       gpointer                    user_data);
+
+
+/*  local variables  */
+
+static guint next_reclaimer_id = 1;
+
+
+/*  public functions  */
+
+void
+gimp_memory_pressure_init (Gimp *gimp)
+{
+  g_return_if_fail (GIMP_IS_GIMP (gimp));
+  g_return_if_fail (gimp->memory_monitor == NULL);
+
+  /*  the monitor is backed by the system's notifications where there are
+   *  any, such as the kernel's pressure stall information on linux
+   */
+  gimp->memory_monitor = g_memory_monitor_dup_default ();
+
+  if (gimp->memory_monitor)
+    {
+      g_signal_connect (gimp->memory_monitor, "low-memory-warning",
+                        G_CALLBACK (gimp_memory_pressure_low_memory_warning),
+                        gimp);
+    }
+
+  gimp_memory_pressure_add_reclaimer (gimp, GIMP_RECLAIM_PRIORITY_CHEAP,
+                                      gimp_memory_pressure_reclaim_brushes,
+                                      NULL);
+}
+
+void
+gimp_memory_pressure_exit (Gimp *gimp)
+{
+  g_return_if_fail (GIMP_IS_GIMP (gimp));
+
+  if (gimp->memory_monitor)
+    {
+      g_signal_handlers_disconnect_by_func (
+        gimp->memory_monitor,
+        gimp_memory_pressure_low_memory_warning,
+        gimp);
+
+      g_clear_object (&gimp->memory_monitor);
+    }
+
+  g_list_free_full (gimp->memory_reclaimers, g_free);
+  gimp->memory_reclaimers = NULL;
+}
+
+guint
+gimp_memory_pressure_add_reclaimer (Gimp            *gimp,
+                                    gint             priority,
+                                    GimpReclaimFunc  func,
+                                    gpointer         user_data)
+{
+  GimpReclaimer *reclaimer;
+
+  g_return_val_if_fail (GIMP_IS_GIMP (gimp), 0);
+  g_return_val_if_fail (func != NULL, 0);
+
+  reclaimer = g_new0 (GimpReclaimer, 1);
+
+  reclaimer->id        = next_reclaimer_id++;
+  reclaimer->priority  = priority;
+  reclaimer->func      = func;
+  reclaimer->user_data = user_data;
+
+  gimp->memory_reclaimers =
+    g_list_insert_sorted (gimp->memory_reclaimers, reclaimer,
+                          (GCompareFunc) gimp_memory_pressure_compare_reclaimers);
+
+  return reclaimer->id;
+}
+
+void
+gimp_memory_pressure_remove_reclaimer (Gimp  *gimp,
+                                       guint  id)
+{
+  GList *list;
+
+  g_return_if_fail (GIMP_IS_GIMP (gimp));
+
+  for (list = gimp->memory_reclaimers; list; list = g_list_next (list))
+    {
+      GimpReclaimer *reclaimer = list->data;
+
+      if (reclaimer->id == id)
+        {
+          gimp->memory_reclaimers =
+            g_list_delete_link (gimp->memory_reclaimers, list);
+
+          g_free (reclaimer);
+
+          return;
+        }
+    }
+
+  g_return_if_reached ();
+}
+
+void
+gimp_memory_pressure_reclaim (Gimp                       *gimp,
+                              GMemoryMonitorWarningLevel  level)
+{
+  gint   max_priority;
+  GList *list;
+
+  g_return_if_fail (GIMP_IS_GIMP (gimp));
+
+  if (level >= G_MEMORY_MONITOR_WARNING_LEVEL_CRITICAL)
+    max_priority = G_MAXINT;
+  else if (level >= G_MEMORY_MONITOR_WARNING_LEVEL_MEDIUM)
+    max_priority = GIMP_RECLAIM_PRIORITY_COSTLY - 1;
+  else
+    max_priority = GIMP_RECLAIM_PRIORITY_DEFAULT - 1;
+
+  if (gimp->be_verbose)
+    g_printerr ("memory pressure (level %d), reclaiming caches\n", level);
+
+  list = gimp->memory_reclaimers;
+
+  while (list)
+    {
+      GimpReclaimer *reclaimer = list->data;
+
+      if (reclaimer->priority > max_priority)
+        break;
+
+      /*  reclaimers may remove themselves  */
+      list = g_list_next (list);
+
+      reclaimer->func (gimp, reclaimer->user_data);
+    }
+}
+
+
+/*  private functions  */
+
+static gint
+gimp_memory_pressure_compare_reclaimers (const GimpReclaimer *reclaimer1,
+                                         const GimpReclaimer *reclaimer2)
+{
+  return reclaimer1->priority - reclaimer2->priority;
+}
+
+static void
+gimp_memory_pressure_low_memory_warning (GMemoryMonitor             *monitor,
+                                         GMemoryMonitorWarningLevel  level,
+                                         Gimp                       *gimp)
+{
+  gimp_memory_pressure_reclaim (gimp, level);
+}
+
+static void
+gimp_memory_pressure_reclaim_brushes (Gimp     *gimp,
+                                      gpointer  user_data)
+{
+  GimpContainer *brushes;
+
+  if (! gimp->brush_factory)
+    return;
+
+  brushes = gimp_data_factory_get_container (gimp->brush_factory);
+
+  gimp_container_foreach (brushes,
+                          (GFunc) gimp_brush_flush_mipmaps, NULL);
+}
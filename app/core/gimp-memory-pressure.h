@@ -0,0 +1,52 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimp-memory-pressure.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GIMP_MEMORY_PRESSURE_H__
+#define __GIMP_MEMORY_PRESSURE_H__
+
+
+/*  reclaimers run in order of priority, the lowest first.  the higher the
+ *  memory pressure, the more of them run.
+ */
+#define GIMP_RECLAIM_PRIORITY_CHEAP   0   /* cheap to rebuild, such as caches
+                                           * of data that is still around
+                                           */
+#define GIMP_RECLAIM_PRIORITY_DEFAULT 100
+#define GIMP_RECLAIM_PRIORITY_COSTLY  200 /* only under critical pressure  */
+
+
+typedef void (* GimpReclaimFunc) (Gimp     *gimp,
+                                  gpointer  user_data);
+
+
+void    gimp_memory_pressure_init             (Gimp                       *gimp);
+void    gimp_memory_pressure_exit             (Gimp                       *gimp);
+
+guint   gimp_memory_pressure_add_reclaimer    (Gimp                       *gimp,
+                                               gint                        priority,
+                                               GimpReclaimFunc             func,
+                                               gpointer                    user_data);
+void    gimp_memory_pressure_remove_reclaimer (Gimp                       *gimp,
+                                               guint                       id);
+
+void    gimp_memory_pressure_reclaim          (Gimp                       *gimp,
+                                               GMemoryMonitorWarningLevel  level);
+
+
+#endif /* __GIMP_MEMORY_PRESSURE_H__ */
@@ -32,6 +32,10 @@
 #include <windows.h>
 #endif
 
+#ifdef HAVE_SCHED_SETAFFINITY
+#include <sched.h>
+#endif
+
 extern "C"
 {
 
@@ -44,9 +48,15 @@ extern "C"
 #include "gimpasync.h"
 #include "gimpcancelable.h"
 
-
 #define GIMP_PARALLEL_MAX_THREADS           64
-#define GIMP_PARALLEL_RUN_ASYNC_MAX_THREADS  1
+
+/* gimp_parallel_run_async() tasks run concurrently, on up to
+ * num-processors threads.  a task must not rely on other tasks not running
+ * at the same time: it should only work on data it owns, or on copies, and
+ * leave shared state to its async's callbacks, which run in the main
+ * thread.
+ */
+#define GIMP_PARALLEL_RUN_ASYNC_MAX_THREADS GIMP_PARALLEL_MAX_THREADS
 
 
 typedef struct
@@ -56,44 +66,118 @@ typedef struct
   GimpRunAsyncFunc  func;
   gpointer          user_data;
   GDestroyNotify    user_data_destroy_func;
+
+  GList             link;
+  gint64            enqueue_time;
 } GimpParallelRunAsyncTask;
 
 typedef struct
 {
-  GThread   *thread;
+  GMutex     mutex;
+  GQueue     tasks;
+
+  /* the number of queued tasks, and the priority of the task at the head of
+   * the queue (or G_MAXINT if the queue is empty).  both are only modified
+   * while holding the queue's mutex, but are read without it, in order to
+   * pick a queue to steal from.
+   */
+  gint       n_tasks;
+  gint       head_priority;
+
+  /* the async the queue's thread is currently running; protected by the
+   * queue's mutex.
+   */
+  GimpAsync *current_async;
+} GimpParallelRunAsyncQueue;
 
-  gboolean   quit;
+typedef struct
+{
+  GThread  *thread;
+  gint      index;
 
-  GimpAsync *current_async;
+  gboolean  quit;
 } GimpParallelRunAsyncThread;
 
+typedef struct
+{
+  GeglParallelDistributeFunc  func;
+  gpointer                    user_data;
+  gint                        n;
 
-/*  local function prototypes  */
+  gint                        next_i;
+  gint                        n_active;
+} GimpParallelDistributeJob;
+
+typedef struct
+{
+  /* only modified by the corresponding thread, but read by the dashboard:
+   * n_steals is accessed atomically, and queue_wait_time, which may tear on
+   * 32-bit targets, while holding the corresponding queue's mutex
+   */
+  gint      n_steals;
+  gint64    queue_wait_time;
+} GimpParallelRunAsyncStats;
 
-static void                       gimp_parallel_notify_num_processors   (GimpGeglConfig             *config);
 
-static void                       gimp_parallel_set_n_threads           (gint                        n_threads,
-                                                                         gboolean                    finish_tasks);
+/*  local function prototypes  */
 
-static void                       gimp_parallel_run_async_set_n_threads (gint                        n_threads,
-                                                                         gboolean                    finish_tasks);
-static gpointer                   gimp_parallel_run_async_thread_func   (GimpParallelRunAsyncThread *thread);
-static void                       gimp_parallel_run_async_enqueue_task  (GimpParallelRunAsyncTask   *task);
-static GimpParallelRunAsyncTask * gimp_parallel_run_async_dequeue_task  (void);
-static gboolean                   gimp_parallel_run_async_execute_task  (GimpParallelRunAsyncTask   *task);
-static void                       gimp_parallel_run_async_abort_task    (GimpParallelRunAsyncTask   *task);
-static void                       gimp_parallel_run_async_cancel        (GimpAsync                  *async);
-static void                       gimp_parallel_run_async_waiting       (GimpAsync                  *async);
+static void                       gimp_parallel_notify_num_processors          (GimpGeglConfig             *config);
+
+static void                       gimp_parallel_set_n_threads                  (gint                        n_threads,
+                                                                                gboolean                    finish_tasks);
+
+static void                       gimp_parallel_run_async_set_n_threads        (gint                        n_threads,
+                                                                                gboolean                    finish_tasks);
+static gpointer                   gimp_parallel_run_async_thread_func          (GimpParallelRunAsyncThread *thread);
+static void                       gimp_parallel_run_async_pin_thread           (GimpParallelRunAsyncThread *thread);
+static void                       gimp_parallel_run_async_enqueue_task         (GimpParallelRunAsyncTask   *task,
+                                                                                gint                        queue_index);
+static GimpParallelRunAsyncTask * gimp_parallel_run_async_dequeue_task         (gint                        queue_index);
+static GimpParallelRunAsyncTask * gimp_parallel_run_async_acquire_task         (GimpParallelRunAsyncThread *thread);
+static gint                       gimp_parallel_run_async_get_highest_priority (void);
+static void                       gimp_parallel_run_async_update_queue         (GimpParallelRunAsyncQueue  *queue);
+static gboolean                   gimp_parallel_run_async_execute_task         (GimpParallelRunAsyncTask   *task);
+static void                       gimp_parallel_run_async_abort_task           (GimpParallelRunAsyncTask   *task);
+static GimpParallelRunAsyncTask * gimp_parallel_run_async_lock_task            (GimpAsync                  *async,
+                                                                                GimpParallelRunAsyncQueue **queue);
+static void                       gimp_parallel_run_async_cancel               (GimpAsync                  *async);
+static void                       gimp_parallel_run_async_waiting              (GimpAsync                  *async);
+
+static void                       gimp_parallel_distribute_run_job             (GimpParallelDistributeJob  *job);
+static gboolean                   gimp_parallel_distribute_help                (void);
+static void                       gimp_parallel_distribute_remove_job          (GimpParallelDistributeJob  *job);
 
 
 /*  local variables  */
 
 static gint                       gimp_parallel_run_async_n_threads = 0;
 static GimpParallelRunAsyncThread gimp_parallel_run_async_threads[GIMP_PARALLEL_RUN_ASYNC_MAX_THREADS];
+static GimpParallelRunAsyncQueue  gimp_parallel_run_async_queues[GIMP_PARALLEL_RUN_ASYNC_MAX_THREADS];
+static GimpParallelRunAsyncStats  gimp_parallel_run_async_stats[GIMP_PARALLEL_RUN_ASYNC_MAX_THREADS];
+
+static GPrivate                   gimp_parallel_run_async_current_thread;
+static guint                      gimp_parallel_run_async_next_queue = 0;
 
+/* the mutex and the condition are only used to put idle threads to sleep,
+ * and to wake them up.  the task queues are protected by their own mutexes.
+ */
 static GMutex                     gimp_parallel_run_async_mutex;
 static GCond                      gimp_parallel_run_async_cond;
-static GQueue                     gimp_parallel_run_async_queue = G_QUEUE_INIT;
+static gint                       gimp_parallel_run_async_n_queued = 0;
+static gint                       gimp_parallel_run_async_n_idle   = 0;
+
+/* whether to pin each async thread to its own processor; see
+ * gimp_parallel_run_async_pin_thread().
+ */
+static gboolean                   gimp_parallel_pin_threads = FALSE;
+
+/* pending distribute jobs of worker threads, which idle worker threads help
+ * to process
+ */
+static GMutex                     gimp_parallel_distribute_mutex;
+static GCond                      gimp_parallel_distribute_cond;
+static GQueue                     gimp_parallel_distribute_jobs   = G_QUEUE_INIT;
+static gint                       gimp_parallel_distribute_n_jobs = 0;
 
 
 /*  public functions  */
@@ -103,11 +187,15 @@ void
 gimp_parallel_init (Gimp *gimp)
 {
   GimpGeglConfig *config;
+  gint            i;
 
   g_return_if_fail (GIMP_IS_GIMP (gimp));
 
   config = GIMP_GEGL_CONFIG (gimp->config);
 
+  for (i = 0; i < GIMP_PARALLEL_RUN_ASYNC_MAX_THREADS; i++)
+    gimp_parallel_run_async_queues[i].head_priority = G_MAXINT;
+
   g_signal_connect (config, "notify::num-processors",
                     G_CALLBACK (gimp_parallel_notify_num_processors),
                     NULL);
@@ -143,21 +231,28 @@ gimp_parallel_run_async_full (gint             priority,
 {
   GimpAsync                *async;
   GimpParallelRunAsyncTask *task;
+  gint                      n_threads;
 
   g_return_val_if_fail (func != NULL, NULL);
 
   async = gimp_async_new ();
 
-  task = g_slice_new (GimpParallelRunAsyncTask);
+  task = g_slice_new0 (GimpParallelRunAsyncTask);
 
   task->async                  = GIMP_ASYNC (g_object_ref (async));
   task->priority               = priority;
   task->func                   = func;
   task->user_data              = user_data;
   task->user_data_destroy_func = user_data_destroy_func;
+  task->link.data              = task;
+
+  n_threads = g_atomic_int_get (&gimp_parallel_run_async_n_threads);
 
-  if (gimp_parallel_run_async_n_threads > 0)
+  if (n_threads > 0)
     {
+      GimpParallelRunAsyncThread *thread;
+      gint                        queue_index;
+
       g_signal_connect_after (async, "cancel",
                               G_CALLBACK (gimp_parallel_run_async_cancel),
                               NULL);
@@ -165,13 +260,27 @@ gimp_parallel_run_async_full (gint             priority,
                               G_CALLBACK (gimp_parallel_run_async_waiting),
                               NULL);
 
-      g_mutex_lock (&gimp_parallel_run_async_mutex);
+      thread = (GimpParallelRunAsyncThread *) g_private_get (
+        &gimp_parallel_run_async_current_thread);
 
-      gimp_parallel_run_async_enqueue_task (task);
+      /* tasks created by a worker thread are pushed to the thread's own
+       * queue, and are stolen by other threads if they become idle.  tasks
+       * created by any other thread are distributed between the queues in a
+       * round-robin fashion.
+       */
+      if (thread)
+        {
+          queue_index = thread->index;
+        }
+      else
+        {
+          queue_index = (guint) g_atomic_int_add (
+            (gint *) &gimp_parallel_run_async_next_queue, 1);
+        }
 
-      g_cond_signal (&gimp_parallel_run_async_cond);
+      queue_index %= n_threads;
 
-      g_mutex_unlock (&gimp_parallel_run_async_mutex);
+      gimp_parallel_run_async_enqueue_task (task, queue_index);
     }
   else
     {
@@ -207,6 +316,7 @@ gimp_parallel_run_async_independent_full (gint             priority,
   task->priority  = priority;
   task->func      = func;
   task->user_data = user_data;
+  task->link.data = task;
 
   thread = g_thread_new (
     "async-ind",
@@ -249,6 +359,249 @@ gimp_parallel_run_async_independent_full (gint             priority,
   return async;
 }
 
+/* gimp_parallel_distribute() and friends are drop-in replacements for the
+ * corresponding gegl_parallel_distribute*() functions.  when called outside
+ * of an async worker thread, they simply forward the call to GEGL.  when
+ * called from within an async task, however, GEGL's thread pool might
+ * already be in use by another task, in which case GEGL would process the
+ * entire work serially, or otherwise the task would compete with the rest of
+ * the async threads for the processors.  instead, the work is split only
+ * between the calling thread and the currently-idle async threads, which
+ * join in processing it.
+ */
+void
+gimp_parallel_distribute (gint                       max_n,
+                          GeglParallelDistributeFunc func,
+                          gpointer                   user_data)
+{
+  GimpParallelDistributeJob job;
+  gint                      n;
+
+  g_return_if_fail (func != NULL);
+
+  if (! g_private_get (&gimp_parallel_run_async_current_thread))
+    {
+      gegl_parallel_distribute (max_n, func, user_data);
+
+      return;
+    }
+
+  n = g_atomic_int_get (&gimp_parallel_run_async_n_idle) + 1;
+
+  if (max_n > 0)
+    n = MIN (n, max_n);
+
+  if (n <= 1)
+    {
+      func (0, 1, user_data);
+
+      return;
+    }
+
+  job.func      = func;
+  job.user_data = user_data;
+  job.n         = n;
+  job.next_i    = 0;
+  job.n_active  = 1;
+
+  g_mutex_lock (&gimp_parallel_distribute_mutex);
+
+  g_queue_push_tail (&gimp_parallel_distribute_jobs, &job);
+
+  g_atomic_int_set (&gimp_parallel_distribute_n_jobs,
+                    gimp_parallel_distribute_jobs.length);
+
+  g_mutex_unlock (&gimp_parallel_distribute_mutex);
+
+  /* wake up the idle threads */
+  g_mutex_lock (&gimp_parallel_run_async_mutex);
+
+  g_cond_broadcast (&gimp_parallel_run_async_cond);
+
+  g_mutex_unlock (&gimp_parallel_run_async_mutex);
+
+  gimp_parallel_distribute_run_job (&job);
+
+  /* wait for the helping threads to finish their part */
+  g_mutex_lock (&gimp_parallel_distribute_mutex);
+
+  gimp_parallel_distribute_remove_job (&job);
+
+  job.n_active--;
+
+  while (job.n_active > 0)
+    {
+      g_cond_wait (&gimp_parallel_distribute_cond,
+                   &gimp_parallel_distribute_mutex);
+    }
+
+  g_mutex_unlock (&gimp_parallel_distribute_mutex);
+}
+
+void
+gimp_parallel_distribute_range (gsize                           size,
+                                gdouble                         thread_cost,
+                                GeglParallelDistributeRangeFunc func,
+                                gpointer                        user_data)
+{
+  gint n_threads;
+
+  g_return_if_fail (func != NULL);
+
+  if (! g_private_get (&gimp_parallel_run_async_current_thread))
+    {
+      gegl_parallel_distribute_range (size, thread_cost, func, user_data);
+
+      return;
+    }
+
+  if (size == 0)
+    return;
+
+  n_threads = g_atomic_int_get (&gimp_parallel_run_async_n_idle) + 1;
+
+  if (thread_cost > 0.0)
+    n_threads = MIN (n_threads, size / thread_cost);
+
+  n_threads = CLAMP (n_threads,
+                     1, (gint) MIN (size, (gsize) GIMP_PARALLEL_MAX_THREADS));
+
+  if (n_threads == 1)
+    {
+      func (0, size, user_data);
+
+      return;
+    }
+
+  gimp_parallel_distribute (
+    n_threads,
+    [=] (gint i,
+         gint n)
+    {
+      gsize offset;
+      gsize sub_size;
+
+      offset   = (2 * i       * size + n) / (2 * n);
+      sub_size = (2 * (i + 1) * size + n) / (2 * n) - offset;
+
+      func (offset, sub_size, user_data);
+    });
+}
+
+void
+gimp_parallel_distribute_area (const GeglRectangle            *area,
+                               gdouble                         thread_cost,
+                               GeglSplitStrategy               split_strategy,
+                               GeglParallelDistributeAreaFunc  func,
+                               gpointer                        user_data)
+{
+  GeglRectangle whole_area;
+  gint          n_threads;
+
+  g_return_if_fail (area != NULL);
+  g_return_if_fail (func != NULL);
+
+  if (! g_private_get (&gimp_parallel_run_async_current_thread))
+    {
+      gegl_parallel_distribute_area (area, thread_cost, split_strategy,
+                                     func, user_data);
+
+      return;
+    }
+
+  if (area->width <= 0 || area->height <= 0)
+    return;
+
+  if (split_strategy == GEGL_SPLIT_STRATEGY_AUTO)
+    {
+      if (area->width > area->height)
+        split_strategy = GEGL_SPLIT_STRATEGY_VERTICAL;
+      else
+        split_strategy = GEGL_SPLIT_STRATEGY_HORIZONTAL;
+    }
+
+  n_threads = g_atomic_int_get (&gimp_parallel_run_async_n_idle) + 1;
+
+  if (thread_cost > 0.0)
+    n_threads = MIN (n_threads,
+                     (gdouble) area->width * area->height / thread_cost);
+
+  if (split_strategy == GEGL_SPLIT_STRATEGY_VERTICAL)
+    n_threads = MIN (n_threads, area->width);
+  else
+    n_threads = MIN (n_threads, area->height);
+
+  n_threads = CLAMP (n_threads, 1, GIMP_PARALLEL_MAX_THREADS);
+
+  if (n_threads == 1)
+    {
+      func (area, user_data);
+
+      return;
+    }
+
+  whole_area = *area;
+
+  gimp_parallel_distribute (
+    n_threads,
+    [=] (gint i,
+         gint n)
+    {
+      GeglRectangle sub_area = whole_area;
+
+      if (split_strategy == GEGL_SPLIT_STRATEGY_VERTICAL)
+        {
+          sub_area.x     = (2 * i       * whole_area.width + n) / (2 * n);
+          sub_area.width = (2 * (i + 1) * whole_area.width + n) / (2 * n) -
+                           sub_area.x;
+
+          sub_area.x    += whole_area.x;
+        }
+      else
+        {
+          sub_area.y      = (2 * i       * whole_area.height + n) / (2 * n);
+          sub_area.height = (2 * (i + 1) * whole_area.height + n) / (2 * n) -
+                            sub_area.y;
+
+          sub_area.y     += whole_area.y;
+        }
+
+      func (&sub_area, user_data);
+    });
+}
+
+gint
+gimp_parallel_run_async_get_n_steals (void)
+{
+  gint n_steals = 0;
+  gint i;
+
+  for (i = 0; i < GIMP_PARALLEL_RUN_ASYNC_MAX_THREADS; i++)
+    n_steals += g_atomic_int_get (&gimp_parallel_run_async_stats[i].n_steals);
+
+  return n_steals;
+}
+
+gdouble
+gimp_parallel_run_async_get_queue_wait_time (void)
+{
+  gint64 queue_wait_time = 0;
+  gint   i;
+
+  for (i = 0; i < GIMP_PARALLEL_RUN_ASYNC_MAX_THREADS; i++)
+    {
+      GimpParallelRunAsyncQueue *queue = &gimp_parallel_run_async_queues[i];
+
+      g_mutex_lock (&queue->mutex);
+
+      queue_wait_time += gimp_parallel_run_async_stats[i].queue_wait_time;
+
+      g_mutex_unlock (&queue->mutex);
+    }
+
+  return queue_wait_time / (gdouble) G_TIME_SPAN_SECOND;
+}
+
 
 /*  private functions  */
 
@@ -256,6 +609,11 @@ gimp_parallel_run_async_independent_full (gint             priority,
 static void
 gimp_parallel_notify_num_processors (GimpGeglConfig *config)
 {
+  /* "pin-async-threads" only affects threads created from now on, which
+   * is why changing it requires a restart
+   */
+  gimp_parallel_pin_threads = config->pin_async_threads;
+
   gimp_parallel_set_n_threads (config->num_processors,
                                /* finish_tasks = */ TRUE);
 }
@@ -282,7 +640,8 @@ gimp_parallel_run_async_set_n_threads (gint     n_threads,
           GimpParallelRunAsyncThread *thread =
             &gimp_parallel_run_async_threads[i];
 
-          thread->quit = FALSE;
+          thread->index = i;
+          thread->quit  = FALSE;
 
           thread->thread = g_thread_new (
             "async",
@@ -292,45 +651,73 @@ gimp_parallel_run_async_set_n_threads (gint     n_threads,
     }
   else if (n_threads < gimp_parallel_run_async_n_threads) /* need less threads */
     {
-      g_mutex_lock (&gimp_parallel_run_async_mutex);
+      gint old_n_threads = gimp_parallel_run_async_n_threads;
+
+      /* stop distributing new tasks to the removed threads' queues */
+      g_atomic_int_set (&gimp_parallel_run_async_n_threads, n_threads);
 
-      for (i = n_threads; i < gimp_parallel_run_async_n_threads; i++)
+      for (i = n_threads; i < old_n_threads; i++)
         {
           GimpParallelRunAsyncThread *thread =
             &gimp_parallel_run_async_threads[i];
+          GimpParallelRunAsyncQueue  *queue  =
+            &gimp_parallel_run_async_queues[i];
 
-          thread->quit = TRUE;
+          g_atomic_int_set (&thread->quit, TRUE);
 
-          if (thread->current_async && ! finish_tasks)
-            gimp_cancelable_cancel (GIMP_CANCELABLE (thread->current_async));
+          g_mutex_lock (&queue->mutex);
+
+          if (queue->current_async && ! finish_tasks)
+            gimp_cancelable_cancel (GIMP_CANCELABLE (queue->current_async));
+
+          g_mutex_unlock (&queue->mutex);
         }
 
+      g_mutex_lock (&gimp_parallel_run_async_mutex);
+
       g_cond_broadcast (&gimp_parallel_run_async_cond);
 
       g_mutex_unlock (&gimp_parallel_run_async_mutex);
 
-      for (i = n_threads; i < gimp_parallel_run_async_n_threads; i++)
+      for (i = n_threads; i < old_n_threads; i++)
         {
           GimpParallelRunAsyncThread *thread =
             &gimp_parallel_run_async_threads[i];
 
           g_thread_join (thread->thread);
         }
+
+      /* move the tasks of the removed threads' queues to the remaining
+       * queues
+       */
+      if (n_threads > 0)
+        {
+          for (i = n_threads; i < old_n_threads; i++)
+            {
+              GimpParallelRunAsyncTask *task;
+
+              while ((task = gimp_parallel_run_async_dequeue_task (i)))
+                gimp_parallel_run_async_enqueue_task (task, i % n_threads);
+            }
+        }
     }
 
-  gimp_parallel_run_async_n_threads = n_threads;
+  g_atomic_int_set (&gimp_parallel_run_async_n_threads, n_threads);
 
   if (n_threads == 0)
     {
-      GimpParallelRunAsyncTask *task;
-
       /* finish remaining tasks */
-      while ((task = gimp_parallel_run_async_dequeue_task ()))
+      for (i = 0; i < GIMP_PARALLEL_RUN_ASYNC_MAX_THREADS; i++)
         {
-          if (finish_tasks)
-            while (gimp_parallel_run_async_execute_task (task));
-          else
-            gimp_parallel_run_async_abort_task (task);
+          GimpParallelRunAsyncTask *task;
+
+          while ((task = gimp_parallel_run_async_dequeue_task (i)))
+            {
+              if (finish_tasks)
+                while (gimp_parallel_run_async_execute_task (task));
+              else
+                gimp_parallel_run_async_abort_task (task);
+            }
         }
     }
 }
@@ -338,57 +725,135 @@ gimp_parallel_run_async_set_n_threads (gint     n_threads,
 static gpointer
 gimp_parallel_run_async_thread_func (GimpParallelRunAsyncThread *thread)
 {
-  g_mutex_lock (&gimp_parallel_run_async_mutex);
+  GimpParallelRunAsyncQueue *queue = &gimp_parallel_run_async_queues[thread->index];
+  GimpParallelRunAsyncStats *stats = &gimp_parallel_run_async_stats[thread->index];
+
+  g_private_set (&gimp_parallel_run_async_current_thread, thread);
+
+  if (gimp_parallel_pin_threads)
+    gimp_parallel_run_async_pin_thread (thread);
 
   while (TRUE)
     {
       GimpParallelRunAsyncTask *task;
 
-      while (! thread->quit &&
-             (task = gimp_parallel_run_async_dequeue_task ()))
+      while (! g_atomic_int_get (&thread->quit) &&
+             (task = gimp_parallel_run_async_acquire_task (thread)))
         {
           gboolean resume;
 
-          thread->current_async = GIMP_ASYNC (g_object_ref (task->async));
+          g_mutex_lock (&queue->mutex);
+
+          stats->queue_wait_time += g_get_monotonic_time () -
+                                    task->enqueue_time;
+
+          queue->current_async = GIMP_ASYNC (g_object_ref (task->async));
+
+          g_mutex_unlock (&queue->mutex);
 
           do
             {
-              g_mutex_unlock (&gimp_parallel_run_async_mutex);
-
               resume = gimp_parallel_run_async_execute_task (task);
-
-              g_mutex_lock (&gimp_parallel_run_async_mutex);
             }
           while (resume &&
-                 (g_queue_is_empty (&gimp_parallel_run_async_queue) ||
+                 (g_atomic_int_get (&gimp_parallel_run_async_n_queued) == 0 ||
                   task->priority <
-                  ((GimpParallelRunAsyncTask *)
-                     g_queue_peek_head (
-                       &gimp_parallel_run_async_queue))->priority));
+                  gimp_parallel_run_async_get_highest_priority ()));
+
+          g_mutex_lock (&queue->mutex);
 
-          g_clear_object (&thread->current_async);
+          g_clear_object (&queue->current_async);
+
+          g_mutex_unlock (&queue->mutex);
 
           if (resume)
-            gimp_parallel_run_async_enqueue_task (task);
+            gimp_parallel_run_async_enqueue_task (task, thread->index);
         }
 
-      if (thread->quit)
+      if (g_atomic_int_get (&thread->quit))
         break;
 
-      g_cond_wait (&gimp_parallel_run_async_cond,
-                   &gimp_parallel_run_async_mutex);
+      if (gimp_parallel_distribute_help ())
+        continue;
+
+      g_mutex_lock (&gimp_parallel_run_async_mutex);
+
+      g_atomic_int_inc (&gimp_parallel_run_async_n_idle);
+
+      while (! g_atomic_int_get (&thread->quit) &&
+             g_atomic_int_get (&gimp_parallel_run_async_n_queued) == 0 &&
+             g_atomic_int_get (&gimp_parallel_distribute_n_jobs)  == 0)
+        {
+          g_cond_wait (&gimp_parallel_run_async_cond,
+                       &gimp_parallel_run_async_mutex);
+        }
+
+      g_atomic_int_dec_and_test (&gimp_parallel_run_async_n_idle);
+
+      g_mutex_unlock (&gimp_parallel_run_async_mutex);
     }
 
-  g_mutex_unlock (&gimp_parallel_run_async_mutex);
+  g_private_set (&gimp_parallel_run_async_current_thread, NULL);
 
   return NULL;
 }
 
+/* on machines with several memory nodes, an async task that moves
+ * between processors, such as loading or decoding an image, may end up
+ * working on buffers it allocated, and first touched, on a remote node.
+ * pinning each async thread to a processor of its own keeps that memory
+ * local to it.  the threads are spread over the processors the process
+ * is allowed to run on, in order, so that they fill one node before
+ * moving on to the next.
+ *
+ * note that only the async threads are pinned.  gimp_parallel_distribute()
+ * calls made outside of an async thread, which is where most rendering
+ * happens, run on GEGL's own thread pool, which we have no control over.
+ */
+static void
+gimp_parallel_run_async_pin_thread (GimpParallelRunAsyncThread *thread)
+{
+#ifdef HAVE_SCHED_SETAFFINITY
+  cpu_set_t allowed;
+  cpu_set_t cpus;
+  gint      n_cpus;
+  gint      target;
+  gint      cpu;
+
+  if (sched_getaffinity (0, sizeof (allowed), &allowed))
+    return;
+
+  n_cpus = CPU_COUNT (&allowed);
+
+  if (n_cpus <= 1)
+    return;
+
+  target = thread->index % n_cpus;
+
+  for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+      if (CPU_ISSET (cpu, &allowed) && target-- == 0)
+        break;
+    }
+
+  CPU_ZERO (&cpus);
+  CPU_SET (cpu, &cpus);
+
+  if (sched_setaffinity (0, sizeof (cpus), &cpus))
+    {
+      g_warning ("Failed to pin async thread %d to processor %d",
+                 thread->index, cpu);
+    }
+#endif
+}
+
 static void
-gimp_parallel_run_async_enqueue_task (GimpParallelRunAsyncTask *task)
+gimp_parallel_run_async_enqueue_task (GimpParallelRunAsyncTask *task,
+                                      gint                      queue_index)
 {
-  GList *link;
-  GList *iter;
+  GimpParallelRunAsyncQueue *queue;
+  GList                     *link;
+  GList                     *iter;
 
   if (gimp_async_is_canceled (task->async))
     {
@@ -397,13 +862,20 @@ gimp_parallel_run_async_enqueue_task (GimpParallelRunAsyncTask *task)
       return;
     }
 
-  link       = g_list_alloc ();
-  link->data = task;
+  queue = &gimp_parallel_run_async_queues[queue_index];
+  link  = &task->link;
+
+  task->enqueue_time = g_get_monotonic_time ();
+
+  g_mutex_lock (&queue->mutex);
 
   g_object_set_data (G_OBJECT (task->async),
-                     "gimp-parallel-run-async-link", link);
+                     "gimp-parallel-run-async-task", task);
+  g_object_set_data (G_OBJECT (task->async),
+                     "gimp-parallel-run-async-queue",
+                     GINT_TO_POINTER (queue_index + 1));
 
-  for (iter = g_queue_peek_tail_link (&gimp_parallel_run_async_queue);
+  for (iter = g_queue_peek_tail_link (&queue->tasks);
        iter;
        iter = g_list_previous (iter))
     {
@@ -424,33 +896,156 @@ gimp_parallel_run_async_enqueue_task (GimpParallelRunAsyncTask *task)
       if (link->next)
         link->next->prev = link;
       else
-        gimp_parallel_run_async_queue.tail = link;
+        queue->tasks.tail = link;
 
-      gimp_parallel_run_async_queue.length++;
+      queue->tasks.length++;
     }
   else
     {
-      g_queue_push_head_link (&gimp_parallel_run_async_queue, link);
+      g_queue_push_head_link (&queue->tasks, link);
+    }
+
+  gimp_parallel_run_async_update_queue (queue);
+
+  g_atomic_int_inc (&gimp_parallel_run_async_n_queued);
+
+  g_mutex_unlock (&queue->mutex);
+
+  /* wake up an idle thread, if there is one.  the thread doesn't have to be
+   * the queue's own thread, since idle threads steal tasks from other
+   * queues.
+   */
+  if (g_atomic_int_get (&gimp_parallel_run_async_n_idle) > 0)
+    {
+      g_mutex_lock (&gimp_parallel_run_async_mutex);
+
+      g_cond_signal (&gimp_parallel_run_async_cond);
+
+      g_mutex_unlock (&gimp_parallel_run_async_mutex);
     }
 }
 
 static GimpParallelRunAsyncTask *
-gimp_parallel_run_async_dequeue_task (void)
+gimp_parallel_run_async_dequeue_task (gint queue_index)
 {
-  GimpParallelRunAsyncTask *task;
+  GimpParallelRunAsyncQueue *queue = &gimp_parallel_run_async_queues[queue_index];
+  GimpParallelRunAsyncTask  *task  = NULL;
+  GList                     *link;
+
+  if (! g_atomic_int_get (&queue->n_tasks))
+    return NULL;
 
-  task = (GimpParallelRunAsyncTask *) g_queue_pop_head (
-                                        &gimp_parallel_run_async_queue);
+  g_mutex_lock (&queue->mutex);
 
-  if (task)
+  link = g_queue_pop_head_link (&queue->tasks);
+
+  if (link)
     {
+      task = (GimpParallelRunAsyncTask *) link->data;
+
+      g_object_set_data (G_OBJECT (task->async),
+                         "gimp-parallel-run-async-queue", NULL);
       g_object_set_data (G_OBJECT (task->async),
-                         "gimp-parallel-run-async-link", NULL);
+                         "gimp-parallel-run-async-task", NULL);
+
+      gimp_parallel_run_async_update_queue (queue);
+
+      g_atomic_int_dec_and_test (&gimp_parallel_run_async_n_queued);
     }
 
+  g_mutex_unlock (&queue->mutex);
+
   return task;
 }
 
+static GimpParallelRunAsyncTask *
+gimp_parallel_run_async_acquire_task (GimpParallelRunAsyncThread *thread)
+{
+  GimpParallelRunAsyncStats *stats = &gimp_parallel_run_async_stats[thread->index];
+
+  while (g_atomic_int_get (&gimp_parallel_run_async_n_queued) > 0)
+    {
+      GimpParallelRunAsyncTask *task;
+      gint                      n_threads;
+      gint                      best_index    = -1;
+      gint                      best_priority = G_MAXINT;
+      gint                      i;
+
+      n_threads = g_atomic_int_get (&gimp_parallel_run_async_n_threads);
+
+      if (thread->index >= n_threads)
+        break;
+
+      /* look for the queue whose head task has the highest priority
+       * (lowest value), preferring the thread's own queue when several
+       * queues have equal priority.
+       */
+      for (i = 0; i < n_threads; i++)
+        {
+          gint                       index = (thread->index + i) % n_threads;
+          GimpParallelRunAsyncQueue *queue = &gimp_parallel_run_async_queues[index];
+
+          if (g_atomic_int_get (&queue->n_tasks) > 0)
+            {
+              gint priority = g_atomic_int_get (&queue->head_priority);
+
+              if (best_index < 0 || priority < best_priority)
+                {
+                  best_index    = index;
+                  best_priority = priority;
+                }
+            }
+        }
+
+      if (best_index < 0)
+        break;
+
+      task = gimp_parallel_run_async_dequeue_task (best_index);
+
+      if (task)
+        {
+          if (best_index != thread->index)
+            g_atomic_int_inc (&stats->n_steals);
+
+          return task;
+        }
+
+      /* another thread got there first; try again */
+    }
+
+  return NULL;
+}
+
+static gint
+gimp_parallel_run_async_get_highest_priority (void)
+{
+  gint priority = G_MAXINT;
+  gint n_threads;
+  gint i;
+
+  n_threads = g_atomic_int_get (&gimp_parallel_run_async_n_threads);
+
+  for (i = 0; i < n_threads; i++)
+    {
+      priority = MIN (priority,
+                      g_atomic_int_get (
+                        &gimp_parallel_run_async_queues[i].head_priority));
+    }
+
+  return priority;
+}
+
+static void
+gimp_parallel_run_async_update_queue (GimpParallelRunAsyncQueue *queue)
+{
+  GimpParallelRunAsyncTask *task;
+
+  task = (GimpParallelRunAsyncTask *) g_queue_peek_head (&queue->tasks);
+
+  g_atomic_int_set (&queue->n_tasks, queue->tasks.length);
+  g_atomic_int_set (&queue->head_priority, task ? task->priority : G_MAXINT);
+}
+
 static gboolean
 gimp_parallel_run_async_execute_task (GimpParallelRunAsyncTask *task)
 {
@@ -488,66 +1083,149 @@ gimp_parallel_run_async_abort_task (GimpParallelRunAsyncTask *task)
   g_slice_free (GimpParallelRunAsyncTask, task);
 }
 
+/* looks up the queued task of 'async', and returns it, with its queue
+ * locked, or returns NULL if the task is not queued.  since tasks may move
+ * between queues, the queue is looked up again after locking it.
+ */
+static GimpParallelRunAsyncTask *
+gimp_parallel_run_async_lock_task (GimpAsync                  *async,
+                                   GimpParallelRunAsyncQueue **queue)
+{
+  gint queue_index;
+
+  while ((queue_index = GPOINTER_TO_INT (
+            g_object_get_data (G_OBJECT (async),
+                               "gimp-parallel-run-async-queue"))))
+    {
+      *queue = &gimp_parallel_run_async_queues[queue_index - 1];
+
+      g_mutex_lock (&(*queue)->mutex);
+
+      if (GPOINTER_TO_INT (g_object_get_data (
+            G_OBJECT (async), "gimp-parallel-run-async-queue")) == queue_index)
+        {
+          return (GimpParallelRunAsyncTask *) g_object_get_data (
+            G_OBJECT (async), "gimp-parallel-run-async-task");
+        }
+
+      g_mutex_unlock (&(*queue)->mutex);
+    }
+
+  return NULL;
+}
+
 static void
 gimp_parallel_run_async_cancel (GimpAsync *async)
 {
-  GList                    *link;
-  GimpParallelRunAsyncTask *task = NULL;
+  GimpParallelRunAsyncQueue *queue;
+  GimpParallelRunAsyncTask  *task;
 
-  link = (GList *) g_object_get_data (G_OBJECT (async),
-                                      "gimp-parallel-run-async-link");
+  task = gimp_parallel_run_async_lock_task (async, &queue);
 
-  if (! link)
+  if (! task)
     return;
 
-  g_mutex_lock (&gimp_parallel_run_async_mutex);
+  g_object_set_data (G_OBJECT (async),
+                     "gimp-parallel-run-async-queue", NULL);
+  g_object_set_data (G_OBJECT (async),
+                     "gimp-parallel-run-async-task", NULL);
 
-  link = (GList *) g_object_get_data (G_OBJECT (async),
-                                      "gimp-parallel-run-async-link");
+  g_queue_unlink (&queue->tasks, &task->link);
 
-  if (link)
-    {
-      g_object_set_data (G_OBJECT (async),
-                         "gimp-parallel-run-async-link", NULL);
-
-      task = (GimpParallelRunAsyncTask *) link->data;
+  gimp_parallel_run_async_update_queue (queue);
 
-      g_queue_delete_link (&gimp_parallel_run_async_queue, link);
-    }
+  g_atomic_int_dec_and_test (&gimp_parallel_run_async_n_queued);
 
-  g_mutex_unlock (&gimp_parallel_run_async_mutex);
+  g_mutex_unlock (&queue->mutex);
 
-  if (task)
-    gimp_parallel_run_async_abort_task (task);
+  gimp_parallel_run_async_abort_task (task);
 }
 
 static void
 gimp_parallel_run_async_waiting (GimpAsync *async)
 {
-  GList *link;
+  GimpParallelRunAsyncQueue *queue;
+  GimpParallelRunAsyncTask  *task;
 
-  link = (GList *) g_object_get_data (G_OBJECT (async),
-                                      "gimp-parallel-run-async-link");
+  task = gimp_parallel_run_async_lock_task (async, &queue);
 
-  if (! link)
+  if (! task)
     return;
 
-  g_mutex_lock (&gimp_parallel_run_async_mutex);
+  task->priority = G_MININT;
 
-  link = (GList *) g_object_get_data (G_OBJECT (async),
-                                      "gimp-parallel-run-async-link");
+  g_queue_unlink         (&queue->tasks, &task->link);
+  g_queue_push_head_link (&queue->tasks, &task->link);
 
-  if (link)
+  gimp_parallel_run_async_update_queue (queue);
+
+  g_mutex_unlock (&queue->mutex);
+}
+
+static void
+gimp_parallel_distribute_run_job (GimpParallelDistributeJob *job)
+{
+  gint i;
+
+  while ((i = g_atomic_int_add (&job->next_i, 1)) < job->n)
+    job->func (i, job->n, job->user_data);
+}
+
+static gboolean
+gimp_parallel_distribute_help (void)
+{
+  GimpParallelDistributeJob *job;
+
+  if (! g_atomic_int_get (&gimp_parallel_distribute_n_jobs))
+    return FALSE;
+
+  g_mutex_lock (&gimp_parallel_distribute_mutex);
+
+  job = (GimpParallelDistributeJob *) g_queue_peek_head (
+    &gimp_parallel_distribute_jobs);
+
+  if (! job)
+    {
+      g_mutex_unlock (&gimp_parallel_distribute_mutex);
+
+      return FALSE;
+    }
+
+  if (g_atomic_int_get (&job->next_i) >= job->n)
     {
-      GimpParallelRunAsyncTask *task = (GimpParallelRunAsyncTask *) link->data;
+      /* all of the job's work has already been claimed */
+      gimp_parallel_distribute_remove_job (job);
 
-      task->priority = G_MININT;
+      g_mutex_unlock (&gimp_parallel_distribute_mutex);
 
-      g_queue_unlink         (&gimp_parallel_run_async_queue, link);
-      g_queue_push_head_link (&gimp_parallel_run_async_queue, link);
+      return TRUE;
     }
 
-  g_mutex_unlock (&gimp_parallel_run_async_mutex);
+  job->n_active++;
+
+  g_mutex_unlock (&gimp_parallel_distribute_mutex);
+
+  gimp_parallel_distribute_run_job (job);
+
+  g_mutex_lock (&gimp_parallel_distribute_mutex);
+
+  gimp_parallel_distribute_remove_job (job);
+
+  if (--job->n_active == 0)
+    g_cond_broadcast (&gimp_parallel_distribute_cond);
+
+  g_mutex_unlock (&gimp_parallel_distribute_mutex);
+
+  return TRUE;
+}
+
+static void
+gimp_parallel_distribute_remove_job (GimpParallelDistributeJob *job)
+{
+  g_queue_remove (&gimp_parallel_distribute_jobs, job);
+
+  g_atomic_int_set (&gimp_parallel_distribute_n_jobs,
+                    gimp_parallel_distribute_jobs.length);
 }
 
 } /* extern "C" */
@@ -37,6 +37,22 @@ GimpAsync * gimp_parallel_run_async_independent_full (gint              priority
                                                       GimpRunAsyncFunc  func,
                                                       gpointer          user_data);
 
+void        gimp_parallel_distribute                 (gint                            max_n,
+                                                      GeglParallelDistributeFunc      func,
+                                                      gpointer                        user_data);
+void        gimp_parallel_distribute_range           (gsize                           size,
+                                                      gdouble                         thread_cost,
+                                                      GeglParallelDistributeRangeFunc func,
+                                                      gpointer                        user_data);
+void        gimp_parallel_distribute_area            (const GeglRectangle            *area,
+                                                      gdouble                         thread_cost,
+                                                      GeglSplitStrategy               split_strategy,
+                                                      GeglParallelDistributeAreaFunc  func,
+                                                      gpointer                        user_data);
+
+gint        gimp_parallel_run_async_get_n_steals        (void);
+gdouble     gimp_parallel_run_async_get_queue_wait_time (void);
+
 
 #ifdef __cplusplus
 
@@ -149,6 +165,72 @@ gimp_parallel_run_async_independent (RunAsyncFunc func)
   return gimp_parallel_run_async_independent_full (0, func);
 }
 
+template <class DistributeFunc>
+inline void
+gimp_parallel_distribute (gint           max_n,
+                          DistributeFunc func)
+{
+  gimp_parallel_distribute (max_n,
+                            [] (gint     i,
+                                gint     n,
+                                gpointer user_data)
+                            {
+                              DistributeFunc func_copy (
+                                *(const DistributeFunc *) user_data);
+
+                              func_copy (i, n);
+                            },
+                            &func);
+}
+
+template <class DistributeRangeFunc>
+inline void
+gimp_parallel_distribute_range (gsize               size,
+                                gdouble             thread_cost,
+                                DistributeRangeFunc func)
+{
+  gimp_parallel_distribute_range (size, thread_cost,
+                                  [] (gsize    offset,
+                                      gsize    size,
+                                      gpointer user_data)
+                                  {
+                                    DistributeRangeFunc func_copy (
+                                      *(const DistributeRangeFunc *) user_data);
+
+                                    func_copy (offset, size);
+                                  },
+                                  &func);
+}
+
+template <class DistributeAreaFunc>
+inline void
+gimp_parallel_distribute_area (const GeglRectangle *area,
+                               gdouble              thread_cost,
+                               GeglSplitStrategy    split_strategy,
+                               DistributeAreaFunc   func)
+{
+  gimp_parallel_distribute_area (area, thread_cost, split_strategy,
+                                 [] (const GeglRectangle *area,
+                                     gpointer             user_data)
+                                 {
+                                   DistributeAreaFunc func_copy (
+                                     *(const DistributeAreaFunc *) user_data);
+
+                                   func_copy (area);
+                                 },
+                                 &func);
+}
+
+template <class DistributeAreaFunc>
+inline void
+gimp_parallel_distribute_area (const GeglRectangle *area,
+                               gdouble              thread_cost,
+                               DistributeAreaFunc   func)
+{
+  gimp_parallel_distribute_area (area, thread_cost, GEGL_SPLIT_STRATEGY_AUTO,
+                                 func);
+}
+
 }
 
 #endif /* __cplusplus */
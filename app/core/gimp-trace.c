@@ -0,0 +1,387 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimp-trace.c
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <gio/gio.h>
+
+#include "core-types.h"
+
+#include "gimp-trace.h"
+
+
+/*  a minimal span recorder.  spans are nested with gimp_trace_begin() and
+ *  gimp_trace_end(), on any thread, and written out by gimp_trace_stop()
+ *  as "complete" events of the Trace Event Format, which can be loaded
+ *  into chrome://tracing, Perfetto, or speedscope.  each span records its
+ *  category, and the thread it ran on; the thread that called
+ *  gimp_trace_start() is thread 1.
+ *
+ *  each thread records its spans into a buffer of its own, which are only
+ *  merged by gimp_trace_stop(), so that tracing doesn't serialize the
+ *  threads it measures.  span names aren't copied, and must be static, or
+ *  interned using gimp_trace_begin_intern().
+ *
+ *  while no trace is running, gimp_trace_begin() and gimp_trace_end()
+ *  return after a single atomic read, so they can be used in hot paths.
+ */
+
+
+typedef struct
+{
+  const gchar *category;
+  const gchar *name;
+  gint64       start;
+  gint64       end;
+} GimpTraceSpan;
+
+typedef struct
+{
+  gint     ref_count;
+  gint     generation;
+  gint     tid;
+
+  /*  only contended while the trace is being stopped  */
+  GMutex   mutex;
+  gboolean closed;
+  GArray  *spans;
+  GArray  *stack;
+} GimpTraceThread;
+
+
+/*  local function prototypes  */
+
+static GimpTraceThread * gimp_trace_thread_new   (void);
+static GimpTraceThread * gimp_trace_thread_ref   (GimpTraceThread *thread);
+static void              gimp_trace_thread_unref (GimpTraceThread *thread);
+
+static GimpTraceThread * gimp_trace_get_thread   (void);
+
+
+/*  local variables  */
+
+static GMutex   trace_mutex;
+static gint     trace_active      = FALSE;
+static gint     trace_generation  = 0;
+static gint     trace_n_threads   = 0;
+static GSList  *trace_threads     = NULL;
+static gint64   trace_origin      = 0;
+
+static GPrivate trace_thread_private =
+  G_PRIVATE_INIT ((GDestroyNotify) gimp_trace_thread_unref);
+
+
+/*  private functions  */
+
+/*  must be called with trace_mutex held, while a trace is running.  the
+ *  new thread is added to the trace, and set as the current thread's.
+ */
+static GimpTraceThread *
+gimp_trace_thread_new (void)
+{
+  GimpTraceThread *thread = g_slice_new0 (GimpTraceThread);
+
+  thread->ref_count  = 1;
+  thread->generation = trace_generation;
+  thread->tid        = ++trace_n_threads;
+  thread->spans      = g_array_new (FALSE, FALSE, sizeof (GimpTraceSpan));
+  thread->stack      = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  g_mutex_init (&thread->mutex);
+
+  trace_threads = g_slist_prepend (trace_threads,
+                                   gimp_trace_thread_ref (thread));
+
+  g_private_replace (&trace_thread_private, thread);
+
+  return thread;
+}
+
+static GimpTraceThread *
+gimp_trace_thread_ref (GimpTraceThread *thread)
+{
+  g_atomic_int_inc (&thread->ref_count);
+
+  return thread;
+}
+
+static void
+gimp_trace_thread_unref (GimpTraceThread *thread)
+{
+  if (g_atomic_int_dec_and_test (&thread->ref_count))
+    {
+      g_array_unref (thread->spans);
+      g_array_unref (thread->stack);
+
+      g_mutex_clear (&thread->mutex);
+
+      g_slice_free (GimpTraceThread, thread);
+    }
+}
+
+/*  returns the current thread's buffer for the running trace, or NULL if
+ *  no trace is running
+ */
+static GimpTraceThread *
+gimp_trace_get_thread (void)
+{
+  GimpTraceThread *thread = g_private_get (&trace_thread_private);
+
+  if (G_LIKELY (thread &&
+                thread->generation == g_atomic_int_get (&trace_generation)))
+    {
+      return thread;
+    }
+
+  g_mutex_lock (&trace_mutex);
+
+  if (trace_active)
+    thread = gimp_trace_thread_new ();
+  else
+    thread = NULL;
+
+  g_mutex_unlock (&trace_mutex);
+
+  return thread;
+}
+
+
+/*  public functions  */
+
+void
+gimp_trace_start (void)
+{
+  g_return_if_fail (! gimp_trace_is_active ());
+
+  g_mutex_lock (&trace_mutex);
+
+  g_atomic_int_inc (&trace_generation);
+
+  trace_n_threads = 0;
+  trace_origin    = g_get_monotonic_time ();
+
+  g_atomic_int_set (&trace_active, TRUE);
+
+  /*  make the calling thread thread 1  */
+  gimp_trace_thread_new ();
+
+  g_mutex_unlock (&trace_mutex);
+}
+
+gboolean
+gimp_trace_stop (GFile   *file,
+                 GError **error)
+{
+  GOutputStream *output;
+  GString       *string;
+  GSList        *threads;
+  GSList        *iter;
+  gint64         now;
+  gboolean       first   = TRUE;
+  gboolean       success = TRUE;
+
+  g_return_val_if_fail (G_IS_FILE (file), FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+  g_return_val_if_fail (gimp_trace_is_active (), FALSE);
+
+  g_mutex_lock (&trace_mutex);
+
+  g_atomic_int_set (&trace_active, FALSE);
+
+  threads       = g_slist_reverse (trace_threads);
+  trace_threads = NULL;
+
+  g_mutex_unlock (&trace_mutex);
+
+  now = g_get_monotonic_time ();
+
+  string = g_string_new ("{\"traceEvents\":[");
+
+  for (iter = threads; iter; iter = g_slist_next (iter))
+    {
+      GimpTraceThread *thread = iter->data;
+      guint            i;
+
+      /*  once closed, the thread doesn't touch its buffer anymore  */
+      g_mutex_lock (&thread->mutex);
+      thread->closed = TRUE;
+      g_mutex_unlock (&thread->mutex);
+
+      for (i = 0; i < thread->spans->len; i++)
+        {
+          GimpTraceSpan *span = &g_array_index (thread->spans,
+                                                GimpTraceSpan, i);
+          const gchar   *p;
+
+          /*  close the spans that are still open  */
+          if (span->end < 0)
+            span->end = now;
+
+          g_string_append (string, first ? "\n" : ",\n");
+          first = FALSE;
+
+          g_string_append (string, "{\"name\":\"");
+
+          for (p = span->name; *p; p++)
+            {
+              if (*p == '"' || *p == '\\')
+                g_string_append_printf (string, "\\%c", *p);
+              else if ((guchar) *p < 0x20)
+                g_string_append_printf (string, "\\u%04x", (guchar) *p);
+              else
+                g_string_append_c (string, *p);
+            }
+
+          g_string_append_printf (string,
+                                  "\",\"cat\":\"%s\",\"ph\":\"X\","
+                                  "\"ts\":%" G_GINT64_FORMAT ","
+                                  "\"dur\":%" G_GINT64_FORMAT ","
+                                  "\"pid\":1,\"tid\":%d}",
+                                  span->category,
+                                  span->start - trace_origin,
+                                  span->end - span->start,
+                                  thread->tid);
+        }
+    }
+
+  g_slist_free_full (threads, (GDestroyNotify) gimp_trace_thread_unref);
+
+  g_string_append_printf (string,
+                          "\n],\"displayTimeUnit\":\"ms\","
+                          "\"otherData\":{\"total-us\":%" G_GINT64_FORMAT "}}\n",
+                          now - trace_origin);
+
+  output = G_OUTPUT_STREAM (g_file_replace (file,
+                                            NULL, FALSE, G_FILE_CREATE_NONE,
+                                            NULL, error));
+
+  if (! output)
+    {
+      success = FALSE;
+    }
+  else
+    {
+      if (! g_output_stream_write_all (output, string->str, string->len,
+                                       NULL, NULL, error) ||
+          ! g_output_stream_close (output, NULL, error))
+        {
+          success = FALSE;
+        }
+
+      g_object_unref (output);
+    }
+
+  g_string_free (string, TRUE);
+
+  return success;
+}
+
+gboolean
+gimp_trace_is_active (void)
+{
+  return g_atomic_int_get (&trace_active);
+}
+
+/*  category and name must be static strings, such as "paint" or
+ *  "decode-tiles", and category should not contain characters that need
+ *  escaping in JSON.
+ */
+void
+gimp_trace_begin (const gchar *category,
+                  const gchar *name)
+{
+  GimpTraceThread *thread;
+
+  if (G_LIKELY (! g_atomic_int_get (&trace_active)))
+    return;
+
+  g_return_if_fail (category != NULL);
+  g_return_if_fail (name != NULL);
+
+  thread = gimp_trace_get_thread ();
+
+  if (! thread)
+    return;
+
+  g_mutex_lock (&thread->mutex);
+
+  if (! thread->closed)
+    {
+      GimpTraceSpan span;
+      guint         index;
+
+      span.category = category;
+      span.name     = name;
+      span.start    = g_get_monotonic_time ();
+      span.end      = -1;
+
+      index = thread->spans->len;
+
+      g_array_append_val (thread->spans, span);
+      g_array_append_val (thread->stack, index);
+    }
+
+  g_mutex_unlock (&thread->mutex);
+}
+
+/*  like gimp_trace_begin(), for names that aren't static, such as object
+ *  names.  the name is interned, which takes a global lock, so this isn't
+ *  meant for hot paths.  a NULL name falls back to the category.
+ */
+void
+gimp_trace_begin_intern (const gchar *category,
+                         const gchar *name)
+{
+  if (G_LIKELY (! g_atomic_int_get (&trace_active)))
+    return;
+
+  gimp_trace_begin (category, name ? g_intern_string (name) : category);
+}
+
+void
+gimp_trace_end (void)
+{
+  GimpTraceThread *thread;
+
+  if (G_LIKELY (! g_atomic_int_get (&trace_active)))
+    return;
+
+  thread = gimp_trace_get_thread ();
+
+  if (! thread)
+    return;
+
+  g_mutex_lock (&thread->mutex);
+
+  /*  the matching gimp_trace_begin() may have been called before the
+   *  trace started, in which case there's nothing to end.
+   */
+  if (! thread->closed && thread->stack->len > 0)
+    {
+      guint index;
+
+      index = g_array_index (thread->stack, guint, thread->stack->len - 1);
+      g_array_set_size (thread->stack, thread->stack->len - 1);
+
+      g_array_index (thread->spans, GimpTraceSpan, index).end =
+        g_get_monotonic_time ();
+    }
+
+  g_mutex_unlock (&thread->mutex);
+}
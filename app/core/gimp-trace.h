@@ -0,0 +1,36 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimp-trace.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GIMP_TRACE_H__
+#define __GIMP_TRACE_H__
+
+
+void       gimp_trace_start        (void);
+gboolean   gimp_trace_stop         (GFile        *file,
+                                    GError      **error);
+gboolean   gimp_trace_is_active    (void);
+
+void       gimp_trace_begin        (const gchar  *category,
+                                    const gchar  *name);
+void       gimp_trace_begin_intern (const gchar  *category,
+                                    const gchar  *name);
+void       gimp_trace_end          (void);
+
+
+#endif /* __GIMP_TRACE_H__ */
@@ -50,8 +50,10 @@
 #include "gimp-filter-history.h"
 #include "gimp-memsize.h"
 #include "gimp-modules.h"
+#include "gimp-memory-pressure.h"
 #include "gimp-parasites.h"
 #include "gimp-templates.h"
+#include "gimp-trace.h"
 #include "gimp-units.h"
 #include "gimp-utils.h"
 #include "gimpbrush.h"
@@ -297,6 +299,8 @@ gimp_constructed (GObject *object)
 
   gimp_modules_init (gimp);
 
+  gimp_memory_pressure_init (gimp);
+
   gimp_paint_init (gimp);
 
   gimp->extension_manager = gimp_extension_manager_new (gimp);
@@ -436,6 +440,8 @@ gimp_finalize (GObject *object)
 
   gimp_paint_exit (gimp);
 
+  gimp_memory_pressure_exit (gimp);
+
   g_clear_object (&gimp->parasites);
   g_clear_object (&gimp->default_folder);
 
@@ -543,10 +549,14 @@ gimp_real_initialize (Gimp               *gimp,
 
   /*  register all internal procedures  */
   status_callback (NULL, _("Internal Procedures"), 0.2);
+  gimp_trace_begin ("startup", "internal-procedures");
   internal_procs_init (gimp->pdb);
   gimp_pdb_compat_procs_register (gimp->pdb, gimp->pdb_compat_mode);
+  gimp_trace_end ();
 
+  gimp_trace_begin ("startup", "plug-in-manager-initialize");
   gimp_plug_in_manager_initialize (gimp->plug_in_manager, status_callback);
+  gimp_trace_end ();
 
   status_callback (NULL, "", 1.0);
 }
@@ -558,12 +568,16 @@ gimp_real_restore (Gimp               *gimp,
   if (gimp->be_verbose)
     g_print ("INIT: %s\n", G_STRFUNC);
 
+  gimp_trace_begin ("startup", "plug-in-restore");
   gimp_plug_in_manager_restore (gimp->plug_in_manager,
                                 gimp_get_user_context (gimp), status_callback);
+  gimp_trace_end ();
 
   /*  initialize babl fishes  */
   status_callback (_("Initialization"), "Babl Fishes", 0.0);
+  gimp_trace_begin ("startup", "babl-fishes");
   gimp_babl_init_fishes (status_callback);
+  gimp_trace_end ();
 
   gimp->restored = TRUE;
 }
@@ -843,20 +857,30 @@ gimp_restore (Gimp                *gimp,
 
   /*  initialize  the global parasite table  */
   status_callback (_("Looking for data files"), _("Parasites"), 0.0);
+  gimp_trace_begin ("startup", "parasites");
   gimp_parasiterc_load (gimp);
+  gimp_trace_end ();
 
   /*  initialize the lists of gimp brushes, dynamics, patterns etc.  */
+  gimp_trace_begin ("startup", "data-factories");
   gimp_data_factories_load (gimp, status_callback);
+  gimp_trace_end ();
 
   /*  initialize the template list  */
   status_callback (NULL, _("Templates"), 0.8);
+  gimp_trace_begin ("startup", "templates");
   gimp_templates_load (gimp);
+  gimp_trace_end ();
 
   /*  initialize the module list  */
   status_callback (NULL, _("Modules"), 0.9);
+  gimp_trace_begin ("startup", "modules");
   gimp_modules_load (gimp);
+  gimp_trace_end ();
 
+  gimp_trace_begin ("startup", "restore-signal");
   g_signal_emit (gimp, gimp_signals[RESTORE], 0, status_callback);
+  gimp_trace_end ();
 
   /* when done, make sure everything is clean, to clean out dirty
    * states from data objects which reference each other and got
@@ -81,6 +81,9 @@ struct _Gimp
 
   GList                  *filter_history;
 
+  GMemoryMonitor         *memory_monitor;
+  GList                  *memory_reclaimers;
+
   GimpContainer          *images;
   guint32                 next_guide_id;
   guint32                 next_sample_point_id;
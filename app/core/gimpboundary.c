@@ -26,14 +26,21 @@
 
 #include "core-types.h"
 
+#include "gimp-parallel.h"
 #include "gimpboundary.h"
 
 
 /* GimpBoundSeg array growth parameter */
-#define MAX_SEGS_INC  2048
+#define MAX_SEGS_INC      2048
 
+/* the number of rows read from the buffer at once */
+#define ROWS_PER_FETCH    64
 
-typedef struct _GimpBoundary GimpBoundary;
+#define PIXELS_PER_THREAD (/* each thread costs as much as */ 64.0 * 64.0 /* pixels */)
+
+
+typedef struct _GimpBoundary    GimpBoundary;
+typedef struct _GimpBoundaryRow GimpBoundaryRow;
 
 struct _GimpBoundary
 {
@@ -44,14 +51,43 @@ struct _GimpBoundary
 
   /*  The array of vertical segments  */
   gint         *vert_segs;
+};
 
-  /*  The empty segment arrays */
-  gint         *empty_segs_n;
-  gint         *empty_segs_c;
-  gint         *empty_segs_l;
-  gint          max_empty_segs;
+struct _GimpBoundaryRow
+{
+  gint     *empty_segs;
+  gint      num_empty;
+  gboolean  dirty;
+};
+
+struct _GimpBoundaryCache
+{
+  GMutex            mutex;
+
+  /*  the parameters the rows were found with  */
+  GeglBuffer       *buffer;    /* only compared, not referenced */
+  GeglRectangle     region;
+  const Babl       *format;
+  GimpBoundaryType  type;
+  gint              x1, y1, x2, y2;
+  gfloat            threshold;
+
+  /*  the empty segments of the scanlines in [start, end)  */
+  GimpBoundaryRow  *rows;
+  gint              start;
+  gint              end;
+
+  /*  the columns the rows depend on  */
+  gint              scan_x1;
+  gint              scan_x2;
 };
 
+typedef struct
+{
+  GimpBoundaryCache *cache;
+  const gint        *dirty_rows;
+} FindRowsData;
+
 
 /*  local function prototypes  */
 
@@ -91,15 +127,13 @@ static void           make_horiz_segs          (GimpBoundary        *boundary,
                                                 gint                 empty[],
                                                 gint                 num_empty,
                                                 gint                 top);
-static GimpBoundary * generate_boundary        (GeglBuffer          *buffer,
-                                                const GeglRectangle *region,
-                                                const Babl          *format,
-                                                GimpBoundaryType     type,
-                                                gint                 x1,
-                                                gint                 y1,
-                                                gint                 x2,
-                                                gint                 y2,
-                                                gfloat               threshold);
+static void           find_rows_range          (gsize                offset,
+                                                gsize                size,
+                                                FindRowsData        *data);
+static void           find_rows                (GimpBoundaryCache   *cache);
+static GimpBoundary * generate_boundary        (GimpBoundaryCache   *cache);
+
+static void           gimp_boundary_cache_clear (GimpBoundaryCache *cache);
 
 static gint       cmp_segptr_xy1_addr     (const GimpBoundSeg **seg_ptr_a,
                                            const GimpBoundSeg **seg_ptr_b);
@@ -111,6 +145,9 @@ static gint       cmp_segptr_xy1          (const GimpBoundSeg **seg_ptr_a,
 static gint       cmp_segptr_xy2          (const GimpBoundSeg **seg_ptr_a,
                                            const GimpBoundSeg **seg_ptr_b);
 
+static gint       cmp_seg_line            (const GimpBoundSeg  *seg_a,
+                                           const GimpBoundSeg  *seg_b);
+
 static const GimpBoundSeg * find_segment  (const GimpBoundSeg **segs_by_xy1,
                                            const GimpBoundSeg **segs_by_xy2,
                                            gint                 num_segs,
@@ -163,10 +200,128 @@ gimp_boundary_find (GeglBuffer          *buffer,
                     int                  y2,
                     gfloat               threshold,
                     int                 *num_segs)
+{
+  GimpBoundaryCache *cache;
+  GimpBoundSeg      *segs;
+
+  g_return_val_if_fail (GEGL_IS_BUFFER (buffer), NULL);
+  g_return_val_if_fail (num_segs != NULL, NULL);
+  g_return_val_if_fail (format != NULL, NULL);
+  g_return_val_if_fail (babl_format_get_bytes_per_pixel (format) ==
+                        sizeof (gfloat), NULL);
+
+  cache = gimp_boundary_cache_new ();
+
+  segs = gimp_boundary_cache_find (cache, buffer, region, format, type,
+                                   x1, y1, x2, y2, threshold, num_segs);
+
+  gimp_boundary_cache_free (cache);
+
+  return segs;
+}
+
+/**
+ * gimp_boundary_cache_new:
+ *
+ * Creates a cache for gimp_boundary_cache_find(), which remembers the
+ * empty segments of each scanline, so that finding the boundary of the
+ * same buffer again only needs to look at the scanlines that were
+ * passed to gimp_boundary_cache_invalidate() in the meantime.
+ *
+ * Returns: the new #GimpBoundaryCache.
+ **/
+GimpBoundaryCache *
+gimp_boundary_cache_new (void)
+{
+  GimpBoundaryCache *cache = g_slice_new0 (GimpBoundaryCache);
+
+  g_mutex_init (&cache->mutex);
+
+  return cache;
+}
+
+void
+gimp_boundary_cache_free (GimpBoundaryCache *cache)
+{
+  g_return_if_fail (cache != NULL);
+
+  gimp_boundary_cache_clear (cache);
+
+  g_mutex_clear (&cache->mutex);
+
+  g_slice_free (GimpBoundaryCache, cache);
+}
+
+/**
+ * gimp_boundary_cache_invalidate:
+ * @cache: a #GimpBoundaryCache
+ * @rect:  the changed area of the buffer, or %NULL
+ *
+ * Marks the scanlines intersecting @rect as changed, or the whole cache
+ * if @rect is %NULL.  This may be called from any thread.
+ **/
+void
+gimp_boundary_cache_invalidate (GimpBoundaryCache   *cache,
+                                const GeglRectangle *rect)
+{
+  g_return_if_fail (cache != NULL);
+
+  g_mutex_lock (&cache->mutex);
+
+  if (! rect)
+    {
+      gimp_boundary_cache_clear (cache);
+    }
+  else if (cache->rows                       &&
+           rect->x < cache->scan_x2          &&
+           rect->x + rect->width > cache->scan_x1)
+    {
+      gint y1 = MAX (rect->y,                cache->start);
+      gint y2 = MIN (rect->y + rect->height, cache->end);
+      gint y;
+
+      for (y = y1; y < y2; y++)
+        cache->rows[y - cache->start].dirty = TRUE;
+    }
+
+  g_mutex_unlock (&cache->mutex);
+}
+
+/**
+ * gimp_boundary_cache_find:
+ * @cache:     a #GimpBoundaryCache
+ * @buffer:    a #GeglBuffer
+ * @format:    a #Babl float format representing the component to analyze
+ * @type:      type of bounds
+ * @x1:        left side of bounds
+ * @y1:        top side of bounds
+ * @x2:        right side of bounds
+ * @y2:        bottom side of bounds
+ * @threshold: pixel value of boundary line
+ * @num_segs:  number of returned #GimpBoundSeg's
+ *
+ * Like gimp_boundary_find(), but only looks again at the scanlines that
+ * changed since the last call with the same parameters.
+ *
+ * Returns: the boundary array.
+ **/
+GimpBoundSeg *
+gimp_boundary_cache_find (GimpBoundaryCache   *cache,
+                          GeglBuffer          *buffer,
+                          const GeglRectangle *region,
+                          const Babl          *format,
+                          GimpBoundaryType     type,
+                          gint                 x1,
+                          gint                 y1,
+                          gint                 x2,
+                          gint                 y2,
+                          gfloat               threshold,
+                          gint                *num_segs)
 {
   GimpBoundary  *boundary;
   GeglRectangle  rect = { 0, };
 
+  g_return_val_if_fail (cache != NULL, NULL);
   g_return_val_if_fail (GEGL_IS_BUFFER (buffer), NULL);
   g_return_val_if_fail (num_segs != NULL, NULL);
   g_return_val_if_fail (format != NULL, NULL);
@@ -183,8 +338,65 @@ gimp_boundary_find (GeglBuffer          *buffer,
       rect.height = gegl_buffer_get_height (buffer);
     }
 
-  boundary = generate_boundary (buffer, &rect, format, type,
-                                x1, y1, x2, y2, threshold);
+  g_mutex_lock (&cache->mutex);
+
+  if (cache->rows                                      &&
+      (cache->buffer    != buffer                      ||
+       ! gegl_rectangle_equal (&cache->region, &rect)  ||
+       cache->format    != format                      ||
+       cache->type      != type                        ||
+       cache->x1        != x1                          ||
+       cache->y1        != y1                          ||
+       cache->x2        != x2                          ||
+       cache->y2        != y2                          ||
+       cache->threshold != threshold))
+    {
+      gimp_boundary_cache_clear (cache);
+    }
+
+  if (! cache->rows)
+    {
+      gint i;
+
+      cache->buffer    = buffer;
+      cache->region    = rect;
+      cache->format    = format;
+      cache->type      = type;
+      cache->x1        = x1;
+      cache->y1        = y1;
+      cache->x2        = x2;
+      cache->y2        = y2;
+      cache->threshold = threshold;
+
+      if (type == GIMP_BOUNDARY_WITHIN_BOUNDS)
+        {
+          cache->start   = y1;
+          cache->end     = y2;
+          cache->scan_x1 = x1;
+          cache->scan_x2 = x2;
+        }
+      else
+        {
+          cache->start   = rect.y;
+          cache->end     = rect.y + rect.height;
+          cache->scan_x1 = rect.x;
+          cache->scan_x2 = rect.x + rect.width;
+        }
+
+      cache->end = MAX (cache->end, cache->start);
+
+      cache->rows = g_new0 (GimpBoundaryRow,
+                            MAX (cache->end - cache->start, 1));
+
+      for (i = 0; i < cache->end - cache->start; i++)
+        cache->rows[i].dirty = TRUE;
+    }
+
+  find_rows (cache);
+
+  boundary = generate_boundary (cache);
+
+  g_mutex_unlock (&cache->mutex);
 
   *num_segs = boundary->num_segs;
 
@@ -408,6 +620,118 @@ gimp_boundary_offset (GimpBoundSeg *segs,
     }
 }
 
+/**
+ * gimp_boundary_downscale:
+ * @segs:           unsorted input segs, as returned by gimp_boundary_find()
+ * @num_segs:       number of input segs
+ * @factor:         the grid size to snap to
+ * @num_downscaled: number of returned segs
+ *
+ * This function snaps the end points of @segs to the nearest multiple
+ * of @factor, drops the segments that become empty, and merges the
+ * ones that become collinear and touch.  This is meant for drawing a
+ * boundary at a scale where @factor pixels are at most a screen pixel,
+ * where a complex boundary is reduced to a fraction of its segments.
+ *
+ * The returned segments stay horizontal or vertical and keep their
+ * "open" flag, but are not in any particular order.
+ *
+ * Returns: the downscaled segs
+ **/
+GimpBoundSeg *
+gimp_boundary_downscale (const GimpBoundSeg *segs,
+                         gint                num_segs,
+                         gint                factor,
+                         gint               *num_downscaled)
+{
+  GimpBoundSeg *new_segs;
+  gint          n_new_segs = 0;
+  gint          i;
+
+  g_return_val_if_fail ((segs == NULL && num_segs == 0) ||
+                        (segs != NULL && num_segs >  0), NULL);
+  g_return_val_if_fail (factor > 0, NULL);
+  g_return_val_if_fail (num_downscaled != NULL, NULL);
+
+  *num_downscaled = 0;
+
+  if (num_segs == 0)
+    return NULL;
+
+  new_segs = g_new (GimpBoundSeg, num_segs);
+
+#define SNAP(v) (((v) + factor / 2 >= 0 ?                                   \
+                  ((v) + factor / 2) / factor :                             \
+                  -((factor - 1 - ((v) + factor / 2)) / factor)) * factor)
+
+  for (i = 0; i < num_segs; i++)
+    {
+      GimpBoundSeg seg;
+
+      seg.x1      = SNAP (MIN (segs[i].x1, segs[i].x2));
+      seg.y1      = SNAP (MIN (segs[i].y1, segs[i].y2));
+      seg.x2      = SNAP (MAX (segs[i].x1, segs[i].x2));
+      seg.y2      = SNAP (MAX (segs[i].y1, segs[i].y2));
+      seg.open    = segs[i].open;
+      seg.visited = FALSE;
+
+      if (seg.x1 != seg.x2 || seg.y1 != seg.y2)
+        new_segs[n_new_segs++] = seg;
+    }
+
+#undef SNAP
+
+  if (n_new_segs > 0)
+    {
+      gint n = 0;
+
+      /*  sort the segments along their lines, and merge the ones that
+       *  touch or overlap
+       */
+      qsort (new_segs, n_new_segs, sizeof (GimpBoundSeg),
+             (GCompareFunc) cmp_seg_line);
+
+      for (i = 1; i < n_new_segs; i++)
+        {
+          GimpBoundSeg *last = &new_segs[n];
+          GimpBoundSeg *seg  = &new_segs[i];
+
+          if (last->open == seg->open)
+            {
+              if (last->y1 == last->y2 && seg->y1 == seg->y2 &&
+                  last->y1 == seg->y1  && seg->x1 <= last->x2)
+                {
+                  last->x2 = MAX (last->x2, seg->x2);
+
+                  continue;
+                }
+              else if (last->x1 == last->x2 && seg->x1 == seg->x2 &&
+                       last->x1 == seg->x1  && seg->y1 <= last->y2)
+                {
+                  last->y2 = MAX (last->y2, seg->y2);
+
+                  continue;
+                }
+            }
+
+          new_segs[++n] = *seg;
+        }
+
+      n_new_segs = n + 1;
+    }
+
+  *num_downscaled = n_new_segs;
+
+  if (n_new_segs == 0)
+    {
+      g_free (new_segs);
+
+      return NULL;
+    }
+
+  return g_renew (GimpBoundSeg, new_segs, n_new_segs);
+}
+
 
 /*  private functions  */
 
@@ -427,15 +751,6 @@ gimp_boundary_new (const GeglRectangle *region)
 
       for (i = 0; i <= (region->width + region->x); i++)
         boundary->vert_segs[i] = -1;
-
-      /*  find the maximum possible number of empty segments
-       *  given the current mask
-       */
-      boundary->max_empty_segs = region->width + 3;
-
-      boundary->empty_segs_n = g_new (gint, boundary->max_empty_segs);
-      boundary->empty_segs_c = g_new (gint, boundary->max_empty_segs);
-      boundary->empty_segs_l = g_new (gint, boundary->max_empty_segs);
     }
 
   return boundary;
@@ -453,9 +768,6 @@ gimp_boundary_free (GimpBoundary *boundary,
     segs = boundary->segs;
 
   g_free (boundary->vert_segs);
-  g_free (boundary->empty_segs_n);
-  g_free (boundary->empty_segs_c);
-  g_free (boundary->empty_segs_l);
 
   g_slice_free (GimpBoundary, boundary);
 
@@ -663,112 +975,188 @@ make_horiz_segs (GimpBoundary *boundary,
     }
 }
 
-static GimpBoundary *
-generate_boundary (GeglBuffer          *buffer,
-                   const GeglRectangle *region,
-                   const Babl          *format,
-                   GimpBoundaryType     type,
-                   gint                 x1,
-                   gint                 y1,
-                   gint                 x2,
-                   gint                 y2,
-                   gfloat               threshold)
+static void
+find_rows_range (gsize         offset,
+                 gsize         size,
+                 FindRowsData *data)
 {
-  GimpBoundary  *boundary;
-  GeglRectangle  line_rect = { 0, };
-  gfloat        *line_data;
-  gint           scanline;
-  gint           i;
-  gint           start, end;
-  gint          *tmp_segs;
+  GimpBoundaryCache *cache = data->cache;
+  gint               width = gegl_buffer_get_width (cache->buffer);
+  gint               max_empty;
+  gfloat            *line_data;
+  gint              *empty_segs;
+  gsize              i;
+
+  /*  find the maximum possible number of empty segments
+   *  given the current mask
+   */
+  max_empty = cache->region.width + 3;
+
+  line_data  = g_new (gfloat, (gsize) width * ROWS_PER_FETCH);
+  empty_segs = g_new (gint, max_empty);
 
-  gint          num_empty_n = 0;
-  gint          num_empty_c = 0;
-  gint          num_empty_l = 0;
+  for (i = offset; i < offset + size;)
+    {
+      gint y = data->dirty_rows[i];
+      gint n;
+      gint j;
+
+      /*  read consecutive dirty rows at once  */
+      for (n = 1;
+           n < ROWS_PER_FETCH     &&
+           i + n < offset + size  &&
+           data->dirty_rows[i + n] == y + n;
+           n++);
+
+      gegl_buffer_get (cache->buffer, GEGL_RECTANGLE (0, y, width, n), 1.0,
+                       cache->format, line_data, GEGL_AUTO_ROWSTRIDE,
+                       GEGL_ABYSS_NONE);
+
+      for (j = 0; j < n; j++)
+        {
+          GimpBoundaryRow *row = &cache->rows[y + j - cache->start];
+
+          find_empty_segs (&cache->region, line_data + (gsize) j * width,
+                           y + j, empty_segs,
+                           max_empty, &row->num_empty,
+                           cache->type,
+                           cache->x1, cache->y1, cache->x2, cache->y2,
+                           cache->threshold);
+
+          g_free (row->empty_segs);
+          row->empty_segs = g_memdup2 (empty_segs,
+                                       row->num_empty * sizeof (gint));
+          row->dirty      = FALSE;
+        }
 
-  boundary = gimp_boundary_new (region);
+      i += n;
+    }
 
-  line_rect.width  = gegl_buffer_get_width (buffer);
-  line_rect.height = 1;
+  g_free (empty_segs);
+  g_free (line_data);
+}
 
-  line_data = g_alloca (sizeof (gfloat) * line_rect.width);
+static void
+find_rows (GimpBoundaryCache *cache)
+{
+  FindRowsData  data;
+  gint         *dirty_rows;
+  gint          n_dirty_rows = 0;
+  gint          width;
+  gint          i;
 
-  start = 0;
-  end   = 0;
+  dirty_rows = g_new (gint, MAX (cache->end - cache->start, 1));
 
-  if (type == GIMP_BOUNDARY_WITHIN_BOUNDS)
+  for (i = 0; i < cache->end - cache->start; i++)
     {
-      start = y1;
-      end   = y2;
+      if (cache->rows[i].dirty)
+        dirty_rows[n_dirty_rows++] = cache->start + i;
     }
-  else if (type == GIMP_BOUNDARY_IGNORE_BOUNDS)
+
+  /*  the rows are independent of each other, so the pixels, which are
+   *  the most expensive part, are looked at in parallel bands of rows.
+   *  the segments are then assembled serially by generate_boundary(),
+   *  stitching the rows together as before.
+   */
+  if (n_dirty_rows > 0)
     {
-      start = region->y;
-      end   = region->y + region->height;
+      width = MAX (cache->scan_x2 - cache->scan_x1, 1);
+
+      data.cache      = cache;
+      data.dirty_rows = dirty_rows;
+
+      gimp_parallel_distribute_range (
+        n_dirty_rows, PIXELS_PER_THREAD / width,
+        (GeglParallelDistributeRangeFunc) find_rows_range,
+        &data);
     }
 
-  /*  Find the empty segments for the previous and current scanlines  */
-  find_empty_segs (region, NULL,
-                   start - 1, boundary->empty_segs_l,
-                   boundary->max_empty_segs, &num_empty_l,
-                   type, x1, y1, x2, y2,
-                   threshold);
+  g_free (dirty_rows);
+}
+
+static GimpBoundary *
+generate_boundary (GimpBoundaryCache *cache)
+{
+  /*  the empty segments of the scanlines outside of [start, end)  */
+  static gint    outside_segs[] = { 0, G_MAXINT };
 
-  line_rect.y = start;
-  gegl_buffer_get (buffer, &line_rect, 1.0, format,
-                   line_data, GEGL_AUTO_ROWSTRIDE,
-                   GEGL_ABYSS_NONE);
+  GimpBoundary  *boundary;
+  gint           scanline;
+  gint           i;
+  gint           start, end;
+  gint          *empty_segs_l = outside_segs;
+  gint          *empty_segs_c = outside_segs;
+  gint          *empty_segs_n;
+  gint           num_empty_l  = G_N_ELEMENTS (outside_segs);
+  gint           num_empty_c  = G_N_ELEMENTS (outside_segs);
+  gint           num_empty_n;
 
-  find_empty_segs (region, line_data,
-                   start, boundary->empty_segs_c,
-                   boundary->max_empty_segs, &num_empty_c,
-                   type, x1, y1, x2, y2,
-                   threshold);
+  boundary = gimp_boundary_new (&cache->region);
+
+  start = cache->start;
+  end   = cache->end;
+
+  if (start < end)
+    {
+      empty_segs_c = cache->rows[0].empty_segs;
+      num_empty_c  = cache->rows[0].num_empty;
+    }
 
   for (scanline = start; scanline < end; scanline++)
     {
       /*  find the empty segment list for the next scanline  */
-      line_rect.y = scanline + 1;
       if (scanline + 1 == end)
-        line_data = NULL;
+        {
+          empty_segs_n = outside_segs;
+          num_empty_n  = G_N_ELEMENTS (outside_segs);
+        }
       else
-        gegl_buffer_get (buffer, &line_rect, 1.0, format,
-                         line_data, GEGL_AUTO_ROWSTRIDE,
-                         GEGL_ABYSS_NONE);
-
-      find_empty_segs (region, line_data,
-                       scanline + 1, boundary->empty_segs_n,
-                       boundary->max_empty_segs, &num_empty_n,
-                       type, x1, y1, x2, y2,
-                       threshold);
+        {
+          empty_segs_n = cache->rows[scanline + 1 - start].empty_segs;
+          num_empty_n  = cache->rows[scanline + 1 - start].num_empty;
+        }
 
       /*  process the segments on the current scanline  */
       for (i = 1; i < num_empty_c - 1; i += 2)
         {
           make_horiz_segs (boundary,
-                           boundary->empty_segs_c [i],
-                           boundary->empty_segs_c [i+1],
+                           empty_segs_c [i],
+                           empty_segs_c [i+1],
                            scanline,
-                           boundary->empty_segs_l, num_empty_l, 1);
+                           empty_segs_l, num_empty_l, 1);
           make_horiz_segs (boundary,
-                           boundary->empty_segs_c [i],
-                           boundary->empty_segs_c [i+1],
+                           empty_segs_c [i],
+                           empty_segs_c [i+1],
                            scanline + 1,
-                           boundary->empty_segs_n, num_empty_n, 0);
+                           empty_segs_n, num_empty_n, 0);
         }
 
-      /*  get the next scanline of empty segments, swap others  */
-      tmp_segs               = boundary->empty_segs_l;
-      boundary->empty_segs_l = boundary->empty_segs_c;
-      num_empty_l            = num_empty_c;
-      boundary->empty_segs_c = boundary->empty_segs_n;
-      num_empty_c            = num_empty_n;
-      boundary->empty_segs_n = tmp_segs;
+      /*  get the next scanline of empty segments  */
+      empty_segs_l = empty_segs_c;
+      num_empty_l  = num_empty_c;
+      empty_segs_c = empty_segs_n;
+      num_empty_c  = num_empty_n;
     }
 
   return boundary;
 }
 
+static void
+gimp_boundary_cache_clear (GimpBoundaryCache *cache)
+{
+  if (cache->rows)
+    {
+      gint i;
+
+      for (i = 0; i < cache->end - cache->start; i++)
+        g_free (cache->rows[i].empty_segs);
+
+      g_clear_pointer (&cache->rows, g_free);
+    }
+
+  cache->buffer = NULL;
+}
+
 /*  sorting utility functions  */
 
 static inline gint
@@ -875,6 +1263,40 @@ cmp_segptr_xy2 (const GimpBoundSeg **seg_ptr_a,
 }
 
 
+/*
+ * Compares segments by their orientation, the line they lie on, their
+ * "open" flag, and finally their start on that line.
+ */
+static gint
+cmp_seg_line (const GimpBoundSeg *seg_a,
+              const GimpBoundSeg *seg_b)
+{
+  gboolean vertical_a = (seg_a->x1 == seg_a->x2);
+  gboolean vertical_b = (seg_b->x1 == seg_b->x2);
+  gint     line_a, line_b;
+  gint     start_a, start_b;
+
+  if (vertical_a != vertical_b)
+    return vertical_a ? 1 : -1;
+
+  line_a  = vertical_a ? seg_a->x1 : seg_a->y1;
+  line_b  = vertical_b ? seg_b->x1 : seg_b->y1;
+
+  if (line_a != line_b)
+    return line_a < line_b ? -1 : 1;
+
+  if (seg_a->open != seg_b->open)
+    return seg_a->open ? 1 : -1;
+
+  start_a = vertical_a ? seg_a->y1 : seg_a->x1;
+  start_b = vertical_b ? seg_b->y1 : seg_b->x1;
+
+  if (start_a != start_b)
+    return start_a < start_b ? -1 : 1;
+
+  return 0;
+}
+
 static const GimpBoundSeg *
 find_segment (const GimpBoundSeg **segs_by_xy1,
               const GimpBoundSeg **segs_by_xy2,
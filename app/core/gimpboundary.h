@@ -51,6 +51,23 @@ GimpBoundSeg * gimp_boundary_find      (GeglBuffer          *buffer,
                                         gint                 y2,
                                         gfloat               threshold,
                                         gint                *num_segs);
+
+GimpBoundaryCache * gimp_boundary_cache_new        (void);
+void                gimp_boundary_cache_free       (GimpBoundaryCache   *cache);
+void                gimp_boundary_cache_invalidate (GimpBoundaryCache   *cache,
+                                                    const GeglRectangle *rect);
+GimpBoundSeg      * gimp_boundary_cache_find       (GimpBoundaryCache   *cache,
+                                                    GeglBuffer          *buffer,
+                                                    const GeglRectangle *region,
+                                                    const Babl          *format,
+                                                    GimpBoundaryType     type,
+                                                    gint                 x1,
+                                                    gint                 y1,
+                                                    gint                 x2,
+                                                    gint                 y2,
+                                                    gfloat               threshold,
+                                                    gint                *num_segs);
+
 GimpBoundSeg * gimp_boundary_sort      (const GimpBoundSeg  *segs,
                                         gint                 num_segs,
                                         gint                *num_groups);
@@ -64,5 +81,10 @@ void       gimp_boundary_offset        (GimpBoundSeg        *segs,
                                         gint                 off_x,
                                         gint                 off_y);
 
+GimpBoundSeg * gimp_boundary_downscale (const GimpBoundSeg  *segs,
+                                        gint                 num_segs,
+                                        gint                 factor,
+                                        gint                *num_downscaled);
+
 
 #endif  /*  __GIMP_BOUNDARY_H__  */
@@ -68,6 +68,16 @@ struct _AbrSampledBrushHeader
 
 /*  local function prototypes  */
 
+static gboolean    gimp_brush_load_header        (GFile             *file,
+                                                  GInputStream      *input,
+                                                  GimpBrushHeader   *header,
+                                                  gchar            **name,
+                                                  GError           **error);
+static gboolean    gimp_brush_load_find_pattern  (GInputStream      *input,
+                                                  GimpBrushHeader   *header,
+                                                  gboolean          *found,
+                                                  GError           **error);
+
 static GList     * gimp_brush_load_abr_v12       (GDataInputStream  *input,
                                                   AbrHeader         *abr_hdr,
                                                   GFile             *file,
@@ -136,7 +146,6 @@ gimp_brush_load_brush (GimpContext   *context,
                        GError       **error)
 {
   GimpBrush       *brush;
-  gsize            bn_size;
   GimpBrushHeader  header;
   gchar           *name = NULL;
   guchar          *mask;
@@ -148,135 +157,8 @@ gimp_brush_load_brush (GimpContext   *context,
   g_return_val_if_fail (G_IS_INPUT_STREAM (input), NULL);
   g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-  /*  read the header  */
-  if (! g_input_stream_read_all (input, &header, sizeof (header),
-                                 &bytes_read, NULL, error) ||
-      bytes_read != sizeof (header))
-    {
-      return NULL;
-    }
-
-  /*  rearrange the bytes in each unsigned int  */
-  header.header_size  = g_ntohl (header.header_size);
-  header.version      = g_ntohl (header.version);
-  header.width        = g_ntohl (header.width);
-  header.height       = g_ntohl (header.height);
-  header.bytes        = g_ntohl (header.bytes);
-  header.magic_number = g_ntohl (header.magic_number);
-  header.spacing      = g_ntohl (header.spacing);
-
-  /*  Check for correct file format */
-
-  if (header.width == 0)
-    {
-      g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
-                   _("Fatal parse error in brush file: Width = 0."));
-      return NULL;
-    }
-
-  if (header.height == 0)
-    {
-      g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
-                   _("Fatal parse error in brush file: Height = 0."));
-      return NULL;
-    }
-
-  if (header.bytes == 0)
-    {
-      g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
-                   _("Fatal parse error in brush file: Bytes = 0."));
-      return NULL;
-    }
-
-  if (header.width  > GIMP_BRUSH_MAX_SIZE ||
-      header.height > GIMP_BRUSH_MAX_SIZE ||
-      G_MAXSIZE / header.width / header.height / MAX (4, header.bytes) < 1)
-    {
-      g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
-                   _("Fatal parse error in brush file: %dx%d over max size."),
-                   header.width, header.height);
-      return NULL;
-    }
-
-  switch (header.version)
-    {
-    case 1:
-      /*  If this is a version 1 brush, set the fp back 8 bytes  */
-      if (! g_seekable_seek (G_SEEKABLE (input), -8, G_SEEK_CUR,
-                             NULL, error))
-        return NULL;
-
-      header.header_size += 8;
-      /*  spacing is not defined in version 1  */
-      header.spacing = 25;
-      break;
-
-    case 3:  /*  cinepaint brush  */
-      if (header.bytes == 18  /* FLOAT16_GRAY_GIMAGE */)
-        {
-          header.bytes = 2;
-        }
-      else
-        {
-          g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
-                       _("Fatal parse error in brush file: Unknown depth %d."),
-                       header.bytes);
-          return NULL;
-        }
-      /*  fallthrough  */
-
-    case 2:
-      if (header.magic_number == GIMP_BRUSH_MAGIC)
-        break;
-
-    default:
-      g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
-                   _("Fatal parse error in brush file: Unknown version %d."),
-                   header.version);
-      return NULL;
-    }
-
-  if (header.header_size < sizeof (GimpBrushHeader))
-    {
-      g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
-                   _("Unsupported brush format"));
-      return NULL;
-    }
-
-  /*  Read in the brush name  */
-  if ((bn_size = (header.header_size - sizeof (header))))
-    {
-      gchar *utf8;
-
-      if (bn_size > GIMP_BRUSH_MAX_NAME)
-        {
-          g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
-                       _("Invalid header data in '%s': "
-                         "Brush name is too long: %lu"),
-                       gimp_file_get_utf8_name (file),
-                       (gulong) bn_size);
-          return NULL;
-        }
-
-      name = g_new0 (gchar, bn_size + 1);
-
-      if (! g_input_stream_read_all (input, name, bn_size,
-                                     &bytes_read, NULL, error) ||
-          bytes_read != bn_size)
-        {
-          g_free (name);
-          return NULL;
-        }
-
-      utf8 = gimp_any_to_utf8 (name, bn_size - 1,
-                               _("Invalid UTF-8 string in brush file '%s'."),
-                               gimp_file_get_utf8_name (file));
-      g_free (name);
-      name = utf8;
-    }
-
-  if (! name)
-    name = g_strdup (_("Unnamed"));
+  if (! gimp_brush_load_header (file, input, &header, &name, error))
+    return NULL;
 
   brush = g_object_new (GIMP_TYPE_BRUSH,
                         "name",      name,
@@ -302,59 +184,29 @@ gimp_brush_load_brush (GimpContext   *context,
        */
       if (success)
         {
-          GimpPatternHeader ph;
-          goffset           rewind;
+          gboolean found;
 
-          rewind = g_seekable_tell (G_SEEKABLE (input));
+          success = gimp_brush_load_find_pattern (input, &header, &found,
+                                                  error);
 
-          if (g_input_stream_read_all (input, &ph, sizeof (GimpPatternHeader),
-                                       &bytes_read, NULL, NULL) &&
-              bytes_read == sizeof (GimpPatternHeader))
+          if (success && found)
             {
-              /*  rearrange the bytes in each unsigned int  */
-              ph.header_size  = g_ntohl (ph.header_size);
-              ph.version      = g_ntohl (ph.version);
-              ph.width        = g_ntohl (ph.width);
-              ph.height       = g_ntohl (ph.height);
-              ph.bytes        = g_ntohl (ph.bytes);
-              ph.magic_number = g_ntohl (ph.magic_number);
-
-              if (ph.magic_number == GIMP_PATTERN_MAGIC        &&
-                  ph.version      == 1                         &&
-                  ph.header_size  > sizeof (GimpPatternHeader) &&
-                  ph.bytes        == 3                         &&
-                  ph.width        == header.width              &&
-                  ph.height       == header.height             &&
-                  g_input_stream_skip (input,
-                                       ph.header_size -
-                                       sizeof (GimpPatternHeader),
-                                       NULL, NULL) ==
-                  ph.header_size - sizeof (GimpPatternHeader))
-                {
-                  guchar *pixmap;
-                  gssize  pixmap_size;
-
-                  brush->priv->pixmap =
-                    gimp_temp_buf_new (header.width, header.height,
-                                       babl_format ("R'G'B' u8"));
-
-                  pixmap = gimp_temp_buf_get_data (brush->priv->pixmap);
-
-                  pixmap_size = gimp_temp_buf_get_data_size (brush->priv->pixmap);
-
-                  success = (g_input_stream_read_all (input, pixmap,
-                                                      pixmap_size,
-                                                      &bytes_read, NULL,
-                                                      error) &&
-                             bytes_read == pixmap_size);
-                }
-              else
-                {
-                  /*  seek back if pattern wasn't found  */
-                  success = g_seekable_seek (G_SEEKABLE (input),
-                                             rewind, G_SEEK_SET,
-                                             NULL, error);
-                }
+              guchar *pixmap;
+              gssize  pixmap_size;
+
+              brush->priv->pixmap =
+                gimp_temp_buf_new (header.width, header.height,
+                                   babl_format ("R'G'B' u8"));
+
+              pixmap = gimp_temp_buf_get_data (brush->priv->pixmap);
+
+              pixmap_size = gimp_temp_buf_get_data_size (brush->priv->pixmap);
+
+              success = (g_input_stream_read_all (input, pixmap,
+                                                  pixmap_size,
+                                                  &bytes_read, NULL,
+                                                  error) &&
+                         bytes_read == pixmap_size);
             }
         }
       break;
@@ -461,6 +313,72 @@ gimp_brush_load_brush (GimpContext   *context,
   return brush;
 }
 
+
+/*  skips over a brush in @input, the way gimp_brush_load_brush() would
+ *  read it, without decoding its mask and pixmap
+ */
+gboolean
+gimp_brush_skip_brush (GFile         *file,
+                       GInputStream  *input,
+                       GError       **error)
+{
+  GimpBrushHeader header;
+  gssize          size;
+  gboolean        found;
+
+  g_return_val_if_fail (G_IS_FILE (file), FALSE);
+  g_return_val_if_fail (G_IS_INPUT_STREAM (input), FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  if (! gimp_brush_load_header (file, input, &header, NULL, error))
+    return FALSE;
+
+  if (header.bytes != 1 && header.bytes != 2 && header.bytes != 4)
+    {
+      g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
+                   _("Fatal parse error in brush file:\n"
+                     "Unsupported brush depth %d\n"
+                     "GIMP brushes must be GRAY or RGBA."),
+                   header.bytes);
+      return FALSE;
+    }
+
+  size = header.width * header.height * header.bytes;
+
+  if (g_input_stream_skip (input, size, NULL, error) != size)
+    {
+      if (error && ! *error)
+        g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
+                     _("Fatal parse error in brush file '%s': "
+                       "File is truncated."),
+                     gimp_file_get_utf8_name (file));
+      return FALSE;
+    }
+
+  if (header.bytes == 1)
+    {
+      if (! gimp_brush_load_find_pattern (input, &header, &found, error))
+        return FALSE;
+
+      if (found)
+        {
+          size = header.width * header.height * 3;
+
+          if (g_input_stream_skip (input, size, NULL, error) != size)
+            {
+              if (error && ! *error)
+                g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
+                             _("Fatal parse error in brush file '%s': "
+                               "File is truncated."),
+                             gimp_file_get_utf8_name (file));
+              return FALSE;
+            }
+        }
+    }
+
+  return TRUE;
+}
+
 GList *
 gimp_brush_load_abr (GimpContext   *context,
                      GFile         *file,
@@ -529,6 +447,212 @@ gimp_brush_load_abr (GimpContext   *context,
 
 /*  private functions  */
 
+static gboolean
+gimp_brush_load_header (GFile            *file,
+                        GInputStream     *input,
+                        GimpBrushHeader  *header_ptr,
+                        gchar           **name_ptr,
+                        GError          **error)
+{
+  GimpBrushHeader  header;
+  gsize            bn_size;
+  gchar           *name = NULL;
+  gsize            bytes_read;
+
+  /*  read the header  */
+  if (! g_input_stream_read_all (input, &header, sizeof (header),
+                                 &bytes_read, NULL, error) ||
+      bytes_read != sizeof (header))
+    {
+      return FALSE;
+    }
+
+  /*  rearrange the bytes in each unsigned int  */
+  header.header_size  = g_ntohl (header.header_size);
+  header.version      = g_ntohl (header.version);
+  header.width        = g_ntohl (header.width);
+  header.height       = g_ntohl (header.height);
+  header.bytes        = g_ntohl (header.bytes);
+  header.magic_number = g_ntohl (header.magic_number);
+  header.spacing      = g_ntohl (header.spacing);
+
+  /*  Check for correct file format */
+
+  if (header.width == 0)
+    {
+      g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
+                   _("Fatal parse error in brush file: Width = 0."));
+      return FALSE;
+    }
+
+  if (header.height == 0)
+    {
+      g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
+                   _("Fatal parse error in brush file: Height = 0."));
+      return FALSE;
+    }
+
+  if (header.bytes == 0)
+    {
+      g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
+                   _("Fatal parse error in brush file: Bytes = 0."));
+      return FALSE;
+    }
+
+  if (header.width  > GIMP_BRUSH_MAX_SIZE ||
+      header.height > GIMP_BRUSH_MAX_SIZE ||
+      G_MAXSIZE / header.width / header.height / MAX (4, header.bytes) < 1)
+    {
+      g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
+                   _("Fatal parse error in brush file: %dx%d over max size."),
+                   header.width, header.height);
+      return FALSE;
+    }
+
+  switch (header.version)
+    {
+    case 1:
+      /*  If this is a version 1 brush, set the fp back 8 bytes  */
+      if (! g_seekable_seek (G_SEEKABLE (input), -8, G_SEEK_CUR,
+                             NULL, error))
+        return FALSE;
+
+      header.header_size += 8;
+      /*  spacing is not defined in version 1  */
+      header.spacing = 25;
+      break;
+
+    case 3:  /*  cinepaint brush  */
+      if (header.bytes == 18  /* FLOAT16_GRAY_GIMAGE */)
+        {
+          header.bytes = 2;
+        }
+      else
+        {
+          g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
+                       _("Fatal parse error in brush file: Unknown depth %d."),
+                       header.bytes);
+          return FALSE;
+        }
+      /*  fallthrough  */
+
+    case 2:
+      if (header.magic_number == GIMP_BRUSH_MAGIC)
+        break;
+
+    default:
+      g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
+                   _("Fatal parse error in brush file: Unknown version %d."),
+                   header.version);
+      return FALSE;
+    }
+
+  if (header.header_size < sizeof (GimpBrushHeader))
+    {
+      g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
+                   _("Unsupported brush format"));
+      return FALSE;
+    }
+
+  /*  Read in the brush name  */
+  if ((bn_size = (header.header_size - sizeof (header))))
+    {
+      gchar *utf8;
+
+      if (bn_size > GIMP_BRUSH_MAX_NAME)
+        {
+          g_set_error (error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
+                       _("Invalid header data in '%s': "
+                         "Brush name is too long: %lu"),
+                       gimp_file_get_utf8_name (file),
+                       (gulong) bn_size);
+          return FALSE;
+        }
+
+      if (! name_ptr)
+        {
+          if (g_input_stream_skip (input, bn_size,
+                                    NULL, error) != (gssize) bn_size)
+            return FALSE;
+        }
+      else
+        {
+          name = g_new0 (gchar, bn_size + 1);
+
+          if (! g_input_stream_read_all (input, name, bn_size,
+                                         &bytes_read, NULL, error) ||
+              bytes_read != bn_size)
+            {
+              g_free (name);
+              return FALSE;
+            }
+
+          utf8 = gimp_any_to_utf8 (name, bn_size - 1,
+                                   _("Invalid UTF-8 string in brush file '%s'."),
+                                   gimp_file_get_utf8_name (file));
+          g_free (name);
+          name = utf8;
+        }
+    }
+
+  if (name_ptr)
+    *name_ptr = name ? name : g_strdup (_("Unnamed"));
+
+  *header_ptr = header;
+
+  return TRUE;
+}
+
+static gboolean
+gimp_brush_load_find_pattern (GInputStream    *input,
+                              GimpBrushHeader *header,
+                              gboolean        *found,
+                              GError         **error)
+{
+  GimpPatternHeader ph;
+  gsize             bytes_read;
+  goffset           rewind;
+
+  *found = FALSE;
+
+  rewind = g_seekable_tell (G_SEEKABLE (input));
+
+  if (g_input_stream_read_all (input, &ph, sizeof (GimpPatternHeader),
+                               &bytes_read, NULL, NULL) &&
+      bytes_read == sizeof (GimpPatternHeader))
+    {
+      /*  rearrange the bytes in each unsigned int  */
+      ph.header_size  = g_ntohl (ph.header_size);
+      ph.version      = g_ntohl (ph.version);
+      ph.width        = g_ntohl (ph.width);
+      ph.height       = g_ntohl (ph.height);
+      ph.bytes        = g_ntohl (ph.bytes);
+      ph.magic_number = g_ntohl (ph.magic_number);
+
+      if (ph.magic_number == GIMP_PATTERN_MAGIC        &&
+          ph.version      == 1                         &&
+          ph.header_size  > sizeof (GimpPatternHeader) &&
+          ph.bytes        == 3                         &&
+          ph.width        == header->width             &&
+          ph.height       == header->height            &&
+          g_input_stream_skip (input,
+                               ph.header_size -
+                               sizeof (GimpPatternHeader),
+                               NULL, NULL) ==
+          ph.header_size - sizeof (GimpPatternHeader))
+        {
+          *found = TRUE;
+
+          return TRUE;
+        }
+    }
+
+  /*  seek back if pattern wasn't found  */
+  return g_seekable_seek (G_SEEKABLE (input),
+                          rewind, G_SEEK_SET,
+                          NULL, error);
+}
+
 static GList *
 gimp_brush_load_abr_v12 (GDataInputStream  *input,
                          AbrHeader         *abr_hdr,
@@ -25,6 +25,7 @@
 #include <gdk-pixbuf/gdk-pixbuf.h>
 #include <gegl.h>
 
+#include "libgimpbase/gimpbase.h"
 #include "libgimpmath/gimpmath.h"
 
 extern "C"
@@ -32,6 +33,8 @@ extern "C"
 
 #include "core-types.h"
 
+#include "gimp-parallel.h"
+#include "gimpasync.h"
 #include "gimpbrush.h"
 #include "gimpbrush-mipmap.h"
 #include "gimpbrush-private.h"
@@ -46,6 +49,40 @@ extern "C"
 #define GIMP_BRUSH_MIPMAP(brush, mipmaps, x, y) \
   ((*(mipmaps))[(y) * (brush)->priv->n_horz_mipmaps + (x)])
 
+/*  the mipmaps of brushes at least this large are kept in the cache
+ *  directory, so that they don't have to be rebuilt in every session
+ */
+#define MIN_STORED_AREA (256 * 256)
+
+#define MIPMAP_FILE_MAGIC     "GIMPMIPM"
+#define MIPMAP_FILE_VERSION   1
+#define MIPMAP_FILE_ALIGNMENT 16
+
+
+/*  a mipmap file is a header, followed by the file offsets of all the
+ *  levels, row by row, and the level data.  absent levels, including
+ *  level 0, which is the brush itself, have an offset of 0.  all values
+ *  are in host byte order, since the files are never shared.
+ */
+typedef struct
+{
+  gchar   magic[8];
+  guint32 version;
+  guint32 bpp;
+  gint64  mtime;
+  gint32  width;
+  gint32  height;
+  gint32  n_horz_mipmaps;
+  gint32  n_vert_mipmaps;
+} MipmapFileHeader;
+
+typedef struct
+{
+  GFile             *file;
+  MipmapFileHeader   header;
+  GimpTempBuf      **mipmaps;
+} MipmapStoreData;
+
 
 /*  local function prototypes  */
 
@@ -58,6 +95,22 @@ static const GimpTempBuf * gimp_brush_mipmap_get            (GimpBrush
                                                              gdouble             *scale_x,
                                                              gdouble             *scale_y);
 
+static GFile             * gimp_brush_mipmap_get_file       (GimpBrush           *brush,
+                                                             const GimpTempBuf   *source,
+                                                             GimpTempBuf       ***mipmaps);
+static void                gimp_brush_mipmap_init_header    (GimpBrush           *brush,
+                                                             const GimpTempBuf   *source,
+                                                             MipmapFileHeader    *header);
+static void                gimp_brush_mipmap_load           (GimpBrush           *brush,
+                                                             const GimpTempBuf   *source,
+                                                             GimpTempBuf       ***mipmaps);
+static void                gimp_brush_mipmap_store          (GimpBrush           *brush,
+                                                             const GimpTempBuf   *source,
+                                                             GimpTempBuf       ***mipmaps);
+static void                gimp_brush_mipmap_store_func     (GimpAsync           *async,
+                                                             MipmapStoreData     *data);
+static void                mipmap_store_data_free           (MipmapStoreData     *data);
+
 static GimpTempBuf       * gimp_brush_mipmap_downscale      (const GimpTempBuf   *source);
 static GimpTempBuf       * gimp_brush_mipmap_downscale_horz (const GimpTempBuf   *source);
 static GimpTempBuf       * gimp_brush_mipmap_downscale_vert (const GimpTempBuf   *source);
@@ -110,6 +163,8 @@ gimp_brush_mipmap_get (GimpBrush           *brush,
                                         brush->priv->n_vert_mipmaps);
 
       GIMP_BRUSH_MIPMAP (brush, mipmaps, 0, 0) = gimp_temp_buf_ref (source);
+
+      gimp_brush_mipmap_load (brush, source, mipmaps);
     }
 
   x = floor (SAFE_CLAMP (log (1.0 / MAX (*scale_x, 0.0)) / M_LN2,
@@ -125,6 +180,11 @@ gimp_brush_mipmap_get (GimpBrush           *brush,
 
   g_return_val_if_fail (x >= 0 || y >= 0, NULL);
 
+  if (mipmaps == &brush->priv->mask_mipmaps)
+    brush->priv->mask_mipmaps_dirty = TRUE;
+  else
+    brush->priv->pixmap_mipmaps_dirty = TRUE;
+
   for (i = 1; i <= x + y; i++)
     {
       gint u = x - i;
@@ -172,6 +232,305 @@ gimp_brush_mipmap_get (GimpBrush           *brush,
   g_return_val_if_reached (NULL);
 }
 
+static GFile *
+gimp_brush_mipmap_get_file (GimpBrush           *brush,
+                            const GimpTempBuf   *source,
+                            GimpTempBuf       ***mipmaps)
+{
+  GimpData *data = GIMP_DATA (brush);
+  GFile    *file;
+  gchar    *uri;
+  gchar    *checksum;
+  gchar    *basename;
+  gchar    *path;
+
+  /*  only brushes that were loaded, and not changed since, match a file
+   *  whose modification time tells us whether the mipmaps are still valid
+   */
+  if (! source                           ||
+      ! gimp_data_get_file (data)        ||
+      gimp_data_get_mtime (data) == 0    ||
+      gimp_data_is_dirty (data)          ||
+      (gint64) gimp_temp_buf_get_width  (source) *
+               gimp_temp_buf_get_height (source) < MIN_STORED_AREA)
+    {
+      return NULL;
+    }
+
+  uri      = g_file_get_uri (gimp_data_get_file (data));
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, uri, -1);
+  basename = g_strdup_printf ("%s-%s.mipmap",
+                              checksum,
+                              mipmaps == &brush->priv->mask_mipmaps ?
+                                "mask" : "pixmap");
+  path     = g_build_filename (gimp_cache_directory (), "brush-mipmaps",
+                               basename, NULL);
+
+  file = g_file_new_for_path (path);
+
+  g_free (path);
+  g_free (basename);
+  g_free (checksum);
+  g_free (uri);
+
+  return file;
+}
+
+static void
+gimp_brush_mipmap_init_header (GimpBrush         *brush,
+                               const GimpTempBuf *source,
+                               MipmapFileHeader  *header)
+{
+  memset (header, 0, sizeof (MipmapFileHeader));
+
+  memcpy (header->magic, MIPMAP_FILE_MAGIC, sizeof (header->magic));
+  header->version        = MIPMAP_FILE_VERSION;
+  header->bpp            = babl_format_get_bytes_per_pixel (
+                             gimp_temp_buf_get_format (source));
+  header->mtime          = gimp_data_get_mtime (GIMP_DATA (brush));
+  header->width          = gimp_temp_buf_get_width  (source);
+  header->height         = gimp_temp_buf_get_height (source);
+  header->n_horz_mipmaps = brush->priv->n_horz_mipmaps;
+  header->n_vert_mipmaps = brush->priv->n_vert_mipmaps;
+}
+
+static void
+gimp_brush_mipmap_load (GimpBrush           *brush,
+                        const GimpTempBuf   *source,
+                        GimpTempBuf       ***mipmaps)
+{
+  GFile            *file;
+  GMappedFile      *mapped;
+  MipmapFileHeader  header;
+  const guchar     *contents;
+  gsize             length;
+  gsize             table_size;
+  guint64           offsets[2];
+  gint              x;
+  gint              y;
+
+  file = gimp_brush_mipmap_get_file (brush, source, mipmaps);
+
+  if (! file)
+    return;
+
+  /*  mapped privately, since temp bufs hand out writable data  */
+  mapped = g_mapped_file_new (g_file_peek_path (file), TRUE, NULL);
+
+  g_object_unref (file);
+
+  if (! mapped)
+    return;
+
+  contents   = (const guchar *) g_mapped_file_get_contents (mapped);
+  length     = g_mapped_file_get_length (mapped);
+  table_size = sizeof (guint64) * brush->priv->n_horz_mipmaps *
+                                  brush->priv->n_vert_mipmaps;
+
+  gimp_brush_mipmap_init_header (brush, source, &header);
+
+  if (length < sizeof (MipmapFileHeader) + table_size ||
+      memcmp (contents, &header, sizeof (MipmapFileHeader)))
+    {
+      g_mapped_file_unref (mapped);
+
+      return;
+    }
+
+  for (y = 0; y < brush->priv->n_vert_mipmaps; y++)
+    {
+      for (x = 0; x < brush->priv->n_horz_mipmaps; x++)
+        {
+          gint width  = header.width  >> x;
+          gint height = header.height >> y;
+
+          if (x == 0 && y == 0)
+            continue;
+
+          memcpy (offsets,
+                  contents + sizeof (MipmapFileHeader) +
+                  sizeof (guint64) * (y * brush->priv->n_horz_mipmaps + x),
+                  sizeof (guint64));
+
+          offsets[1] = offsets[0] + (guint64) width * height * header.bpp;
+
+          if (offsets[0] == 0                                     ||
+              offsets[0] % MIPMAP_FILE_ALIGNMENT                  ||
+              offsets[0] < sizeof (MipmapFileHeader) + table_size ||
+              offsets[0] > length                                 ||
+              offsets[1] > length)
+            {
+              continue;
+            }
+
+          GIMP_BRUSH_MIPMAP (brush, mipmaps, x, y) =
+            gimp_temp_buf_new_for_data (width, height,
+                                        gimp_temp_buf_get_format (source),
+                                        (gpointer) (contents + offsets[0]),
+                                        (GDestroyNotify) g_mapped_file_unref,
+                                        g_mapped_file_ref (mapped));
+        }
+    }
+
+  g_mapped_file_unref (mapped);
+}
+
+static void
+gimp_brush_mipmap_store (GimpBrush           *brush,
+                         const GimpTempBuf   *source,
+                         GimpTempBuf       ***mipmaps)
+{
+  MipmapStoreData *data;
+  GFile           *file;
+  gint             n_mipmaps;
+  gint             i;
+
+  if (! *mipmaps)
+    return;
+
+  file = gimp_brush_mipmap_get_file (brush, source, mipmaps);
+
+  if (! file)
+    return;
+
+  n_mipmaps = brush->priv->n_horz_mipmaps * brush->priv->n_vert_mipmaps;
+
+  data = g_slice_new (MipmapStoreData);
+
+  data->file    = file;
+  data->mipmaps = g_new0 (GimpTempBuf *, n_mipmaps);
+
+  gimp_brush_mipmap_init_header (brush, source, &data->header);
+
+  for (i = 1; i < n_mipmaps; i++)
+    {
+      if ((*mipmaps)[i])
+        data->mipmaps[i] = gimp_temp_buf_ref ((*mipmaps)[i]);
+    }
+
+  g_object_unref (gimp_parallel_run_async_full (
+    +1,
+    (GimpRunAsyncFunc) gimp_brush_mipmap_store_func,
+    data,
+    (GDestroyNotify) mipmap_store_data_free));
+}
+
+static void
+gimp_brush_mipmap_store_func (GimpAsync       *async,
+                              MipmapStoreData *data)
+{
+  GOutputStream *output;
+  GFile         *parent;
+  guint64       *offsets;
+  guint64        offset;
+  gint           n_mipmaps;
+  gboolean       success;
+  gint           i;
+
+  n_mipmaps = data->header.n_horz_mipmaps * data->header.n_vert_mipmaps;
+
+  offsets = g_new0 (guint64, n_mipmaps);
+  offset  = sizeof (MipmapFileHeader) + sizeof (guint64) * n_mipmaps;
+
+  for (i = 1; i < n_mipmaps; i++)
+    {
+      if (data->mipmaps[i])
+        {
+          offset = (offset + MIPMAP_FILE_ALIGNMENT - 1) &
+                   ~(guint64) (MIPMAP_FILE_ALIGNMENT - 1);
+
+          offsets[i] = offset;
+          offset    += gimp_temp_buf_get_data_size (data->mipmaps[i]);
+        }
+    }
+
+  parent = g_file_get_parent (data->file);
+
+  g_mkdir_with_parents (g_file_peek_path (parent), 0700);
+
+  g_object_unref (parent);
+
+  /*  failing to write the mipmaps only means rebuilding them next time  */
+  output = G_OUTPUT_STREAM (g_file_replace (data->file,
+                                            NULL, FALSE, G_FILE_CREATE_PRIVATE,
+                                            NULL, NULL));
+
+  if (output)
+    {
+      offset  = sizeof (MipmapFileHeader) + sizeof (guint64) * n_mipmaps;
+
+      success = g_output_stream_write_all (output,
+                                           &data->header,
+                                           sizeof (MipmapFileHeader),
+                                           NULL, NULL, NULL) &&
+                g_output_stream_write_all (output,
+                                           offsets,
+                                           sizeof (guint64) * n_mipmaps,
+                                           NULL, NULL, NULL);
+
+      for (i = 1; success && i < n_mipmaps; i++)
+        {
+          static const guchar padding[MIPMAP_FILE_ALIGNMENT] = {};
+
+          if (! data->mipmaps[i])
+            continue;
+
+          success = g_output_stream_write_all (output,
+                                               padding,
+                                               offsets[i] - offset,
+                                               NULL, NULL, NULL) &&
+                    g_output_stream_write_all (
+                      output,
+                      gimp_temp_buf_get_data (data->mipmaps[i]),
+                      gimp_temp_buf_get_data_size (data->mipmaps[i]),
+                      NULL, NULL, NULL);
+
+          offset = offsets[i] +
+                   gimp_temp_buf_get_data_size (data->mipmaps[i]);
+        }
+
+      if (success)
+        {
+          g_output_stream_close (output, NULL, NULL);
+        }
+      else
+        {
+          GCancellable *cancellable = g_cancellable_new ();
+
+          /*  don't replace the old file with a partial one  */
+          g_cancellable_cancel (cancellable);
+          g_output_stream_close (output, cancellable, NULL);
+
+          g_object_unref (cancellable);
+        }
+
+      g_object_unref (output);
+    }
+
+  g_free (offsets);
+
+  mipmap_store_data_free (data);
+
+  gimp_async_finish (async, NULL);
+}
+
+static void
+mipmap_store_data_free (MipmapStoreData *data)
+{
+  gint n_mipmaps;
+  gint i;
+
+  n_mipmaps = data->header.n_horz_mipmaps * data->header.n_vert_mipmaps;
+
+  for (i = 0; i < n_mipmaps; i++)
+    g_clear_pointer (&data->mipmaps[i], gimp_temp_buf_unref);
+
+  g_free (data->mipmaps);
+  g_object_unref (data->file);
+
+  g_slice_free (MipmapStoreData, data);
+}
+
 template <class T>
 struct MipmapTraits;
 
@@ -232,7 +591,7 @@ struct MipmapAlgorithms
     destination = gimp_temp_buf_new (width, height,
                                      gimp_temp_buf_get_format (source));
 
-    gegl_parallel_distribute_area (
+    gimp_parallel_distribute_area (
       GEGL_RECTANGLE (0, 0, width, height), PIXELS_PER_THREAD,
       [=] (const GeglRectangle *area)
       {
@@ -287,7 +646,7 @@ struct MipmapAlgorithms
     destination = gimp_temp_buf_new (width, height,
                                      gimp_temp_buf_get_format (source));
 
-    gegl_parallel_distribute_range (
+    gimp_parallel_distribute_range (
       height, PIXELS_PER_THREAD / width,
       [=] (gint offset,
            gint size)
@@ -338,7 +697,7 @@ struct MipmapAlgorithms
     destination = gimp_temp_buf_new (width, height,
                                      gimp_temp_buf_get_format (source));
 
-    gegl_parallel_distribute_range (
+    gimp_parallel_distribute_range (
       width, PIXELS_PER_THREAD / height,
       [=] (gint offset,
            gint size)
@@ -457,6 +816,31 @@ gimp_brush_mipmap_clear (GimpBrush *brush)
 {
   gimp_brush_mipmap_clear (brush, &brush->priv->mask_mipmaps);
   gimp_brush_mipmap_clear (brush, &brush->priv->pixmap_mipmaps);
+
+  brush->priv->mask_mipmaps_dirty   = FALSE;
+  brush->priv->pixmap_mipmaps_dirty = FALSE;
+}
+
+void
+gimp_brush_mipmap_store (GimpBrush *brush)
+{
+  if (brush->priv->mask_mipmaps_dirty)
+    {
+      gimp_brush_mipmap_store (brush,
+                               brush->priv->mask,
+                               &brush->priv->mask_mipmaps);
+
+      brush->priv->mask_mipmaps_dirty = FALSE;
+    }
+
+  if (brush->priv->pixmap_mipmaps_dirty)
+    {
+      gimp_brush_mipmap_store (brush,
+                               brush->priv->pixmap,
+                               &brush->priv->pixmap_mipmaps);
+
+      brush->priv->pixmap_mipmaps_dirty = FALSE;
+    }
 }
 
 const GimpTempBuf *
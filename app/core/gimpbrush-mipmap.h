@@ -23,6 +23,7 @@
 
 
 void                gimp_brush_mipmap_clear       (GimpBrush *brush);
+void                gimp_brush_mipmap_store       (GimpBrush *brush);
 
 const GimpTempBuf * gimp_brush_mipmap_get_mask    (GimpBrush *brush,
                                                    gdouble   *scale_x,
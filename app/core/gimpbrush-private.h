@@ -32,6 +32,8 @@ struct _GimpBrushPrivate
   gint             n_vert_mipmaps;
   GimpTempBuf    **mask_mipmaps;
   GimpTempBuf    **pixmap_mipmaps;
+  gboolean         mask_mipmaps_dirty;   /*  has levels not on disk  */
+  gboolean         pixmap_mipmaps_dirty;
 
   gint             spacing;    /*  brush's spacing                */
   GimpVector2      x_axis;     /*  for calculating brush spacing  */
@@ -0,0 +1,296 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimpbrush-transform-avx2.c
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include <glib.h>
+
+#include "gimpbrush-transform-avx2.h"
+
+
+#if COMPILE_AVX2_INTRINISICS
+
+/* AVX2 */
+#include <immintrin.h>
+
+
+/*  must match gimpbrush-transform.cc  */
+#define FRACTION_BITS 12
+#define INT_MULTIPLE  (1 << FRACTION_BITS)
+
+
+/*  local function prototypes  */
+
+static inline void      gimp_brush_transform_positions_avx2 (gint     x_i,
+                                                             gint     y_i,
+                                                             gint     walk_x_i,
+                                                             gint     walk_y_i,
+                                                             __m256i *x,
+                                                             __m256i *y);
+static inline gboolean  gimp_brush_transform_in_range_avx2  (__m256i  x,
+                                                             __m256i  y,
+                                                             gint     src_width,
+                                                             gint     src_height);
+static inline __m256i   gimp_brush_transform_lerp_avx2      (__m256i  top,
+                                                             __m256i  top_next,
+                                                             __m256i  below,
+                                                             __m256i  below_next,
+                                                             __m128i  shift,
+                                                             __m256i  x,
+                                                             __m256i  y);
+
+
+/*  private functions  */
+
+static inline void
+gimp_brush_transform_positions_avx2 (gint     x_i,
+                                     gint     y_i,
+                                     gint     walk_x_i,
+                                     gint     walk_y_i,
+                                     __m256i *x,
+                                     __m256i *y)
+{
+  const __m256i lanes = _mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7);
+
+  /*  the same values the scalar code reaches by repeated addition  */
+  *x = _mm256_add_epi32 (_mm256_set1_epi32 (x_i),
+                         _mm256_mullo_epi32 (lanes,
+                                             _mm256_set1_epi32 (walk_x_i)));
+  *y = _mm256_add_epi32 (_mm256_set1_epi32 (y_i),
+                         _mm256_mullo_epi32 (lanes,
+                                             _mm256_set1_epi32 (walk_y_i)));
+}
+
+/*  returns whether any of the positions hits the source  */
+static inline gboolean
+gimp_brush_transform_in_range_avx2 (__m256i x,
+                                    __m256i y,
+                                    gint    src_width,
+                                    gint    src_height)
+{
+  const gint x_min_i = -INT_MULTIPLE / 2;
+  const gint y_min_i = -INT_MULTIPLE / 2;
+  const gint x_max_i = src_width  * INT_MULTIPLE - INT_MULTIPLE / 2;
+  const gint y_max_i = src_height * INT_MULTIPLE - INT_MULTIPLE / 2;
+  __m256i    in_range;
+
+  in_range = _mm256_and_si256 (
+    _mm256_and_si256 (_mm256_cmpgt_epi32 (x, _mm256_set1_epi32 (x_min_i - 1)),
+                      _mm256_cmpgt_epi32 (_mm256_set1_epi32 (x_max_i), x)),
+    _mm256_and_si256 (_mm256_cmpgt_epi32 (y, _mm256_set1_epi32 (y_min_i - 1)),
+                      _mm256_cmpgt_epi32 (_mm256_set1_epi32 (y_max_i), y)));
+
+  return _mm256_movemask_epi8 (in_range) != 0;
+}
+
+/*  interpolates the byte at "shift" bits of each of the four gathered
+ *  neighbors.  like the scalar code, the products wrap around 32 bits,
+ *  of which the top 8 bits are the result.
+ */
+static inline __m256i
+gimp_brush_transform_lerp_avx2 (__m256i top,
+                                __m256i top_next,
+                                __m256i below,
+                                __m256i below_next,
+                                __m128i shift,
+                                __m256i x,
+                                __m256i y)
+{
+  const __m256i byte_mask     = _mm256_set1_epi32 (0xff);
+  const __m256i fraction_mask = _mm256_set1_epi32 (INT_MULTIPLE - 1);
+  const __m256i int_multiple  = _mm256_set1_epi32 (INT_MULTIPLE);
+  __m256i       distance_x;
+  __m256i       distance_y;
+  __m256i       opposite_x;
+  __m256i       opposite_y;
+  __m256i       upper;
+  __m256i       lower;
+
+  top        = _mm256_and_si256 (_mm256_srl_epi32 (top,        shift), byte_mask);
+  top_next   = _mm256_and_si256 (_mm256_srl_epi32 (top_next,   shift), byte_mask);
+  below      = _mm256_and_si256 (_mm256_srl_epi32 (below,      shift), byte_mask);
+  below_next = _mm256_and_si256 (_mm256_srl_epi32 (below_next, shift), byte_mask);
+
+  distance_x = _mm256_and_si256 (x, fraction_mask);
+  distance_y = _mm256_and_si256 (y, fraction_mask);
+  opposite_x = _mm256_sub_epi32 (int_multiple, distance_x);
+  opposite_y = _mm256_sub_epi32 (int_multiple, distance_y);
+
+  upper = _mm256_add_epi32 (_mm256_mullo_epi32 (top,      opposite_x),
+                            _mm256_mullo_epi32 (top_next, distance_x));
+  lower = _mm256_add_epi32 (_mm256_mullo_epi32 (below,      opposite_x),
+                            _mm256_mullo_epi32 (below_next, distance_x));
+
+  return _mm256_srli_epi32 (
+    _mm256_add_epi32 (_mm256_mullo_epi32 (upper, opposite_y),
+                      _mm256_mullo_epi32 (lower, distance_y)),
+    2 * FRACTION_BITS);
+}
+
+
+/*  public functions  */
+
+gboolean
+gimp_brush_transform_mask_sample_8_avx2 (const guchar *src,
+                                         gint          src_width,
+                                         gint          src_height,
+                                         gint          x_i,
+                                         gint          y_i,
+                                         gint          walk_x_i,
+                                         gint          walk_y_i,
+                                         guchar       *dest)
+{
+  __m256i x, y;
+  __m256i src_x, src_y;
+  __m256i safe;
+  __m256i offset;
+  __m256i top, below;
+  __m256i result;
+  __m128i result16;
+
+  gimp_brush_transform_positions_avx2 (x_i, y_i, walk_x_i, walk_y_i, &x, &y);
+
+  if (! gimp_brush_transform_in_range_avx2 (x, y, src_width, src_height))
+    {
+      memset (dest, 0, 8);
+
+      return TRUE;
+    }
+
+  src_x = _mm256_srai_epi32 (x, FRACTION_BITS);
+  src_y = _mm256_srai_epi32 (y, FRACTION_BITS);
+
+  /*  only take pixels whose four neighbors are all inside the source,
+   *  and whose 32-bit gathers don't read past its end
+   */
+  safe = _mm256_and_si256 (
+    _mm256_and_si256 (_mm256_cmpgt_epi32 (src_x, _mm256_set1_epi32 (-1)),
+                      _mm256_cmpgt_epi32 (src_y, _mm256_set1_epi32 (-1))),
+    _mm256_and_si256 (_mm256_cmpgt_epi32 (_mm256_set1_epi32 (src_width  - 1), src_x),
+                      _mm256_cmpgt_epi32 (_mm256_set1_epi32 (src_height - 1), src_y)));
+  safe = _mm256_and_si256 (
+    safe,
+    _mm256_or_si256 (_mm256_cmpgt_epi32 (_mm256_set1_epi32 (src_height - 2), src_y),
+                     _mm256_cmpgt_epi32 (_mm256_set1_epi32 (src_width  - 3), src_x)));
+
+  if (_mm256_movemask_epi8 (safe) != -1)
+    return FALSE;
+
+  offset = _mm256_add_epi32 (_mm256_mullo_epi32 (src_y,
+                                                 _mm256_set1_epi32 (src_width)),
+                             src_x);
+
+  top   = _mm256_i32gather_epi32 ((const gint *) src, offset, 1);
+  below = _mm256_i32gather_epi32 ((const gint *) (src + src_width), offset, 1);
+
+  result = gimp_brush_transform_lerp_avx2 (top,
+                                           _mm256_srli_epi32 (top, 8),
+                                           below,
+                                           _mm256_srli_epi32 (below, 8),
+                                           _mm_cvtsi32_si128 (0),
+                                           x, y);
+
+  result16 = _mm_packus_epi32 (_mm256_castsi256_si128 (result),
+                               _mm256_extracti128_si256 (result, 1));
+
+  _mm_storel_epi64 ((__m128i *) dest, _mm_packus_epi16 (result16, result16));
+
+  return TRUE;
+}
+
+gboolean
+gimp_brush_transform_pixmap_sample_8_avx2 (const guchar *src,
+                                           gint          src_width,
+                                           gint          src_height,
+                                           gint          x_i,
+                                           gint          y_i,
+                                           gint          walk_x_i,
+                                           gint          walk_y_i,
+                                           guchar       *dest)
+{
+  __m256i x, y;
+  __m256i src_x, src_y;
+  __m256i safe;
+  __m256i offset;
+  __m256i top, top_next, below, below_next;
+  gint32  result[3][8];
+  gint    c, i;
+
+  gimp_brush_transform_positions_avx2 (x_i, y_i, walk_x_i, walk_y_i, &x, &y);
+
+  if (! gimp_brush_transform_in_range_avx2 (x, y, src_width, src_height))
+    {
+      memset (dest, 0, 3 * 8);
+
+      return TRUE;
+    }
+
+  src_x = _mm256_srai_epi32 (x, FRACTION_BITS);
+  src_y = _mm256_srai_epi32 (y, FRACTION_BITS);
+
+  /*  see gimp_brush_transform_mask_sample_8_avx2(); the gathers of the
+   *  next pixels read 4 bytes starting at its second byte
+   */
+  safe = _mm256_and_si256 (
+    _mm256_and_si256 (_mm256_cmpgt_epi32 (src_x, _mm256_set1_epi32 (-1)),
+                      _mm256_cmpgt_epi32 (src_y, _mm256_set1_epi32 (-1))),
+    _mm256_and_si256 (_mm256_cmpgt_epi32 (_mm256_set1_epi32 (src_width  - 1), src_x),
+                      _mm256_cmpgt_epi32 (_mm256_set1_epi32 (src_height - 1), src_y)));
+  safe = _mm256_and_si256 (
+    safe,
+    _mm256_or_si256 (_mm256_cmpgt_epi32 (_mm256_set1_epi32 (src_height - 2), src_y),
+                     _mm256_cmpgt_epi32 (_mm256_set1_epi32 (src_width  - 2), src_x)));
+
+  if (_mm256_movemask_epi8 (safe) != -1)
+    return FALSE;
+
+  offset = _mm256_add_epi32 (_mm256_mullo_epi32 (src_y,
+                                                 _mm256_set1_epi32 (src_width)),
+                             src_x);
+  offset = _mm256_add_epi32 (offset, _mm256_add_epi32 (offset, offset));
+
+  top        = _mm256_i32gather_epi32 ((const gint *) src, offset, 1);
+  top_next   = _mm256_i32gather_epi32 ((const gint *) (src + 3), offset, 1);
+  below      = _mm256_i32gather_epi32 ((const gint *) (src + 3 * src_width),
+                                       offset, 1);
+  below_next = _mm256_i32gather_epi32 ((const gint *) (src + 3 * src_width + 3),
+                                       offset, 1);
+
+  for (c = 0; c < 3; c++)
+    {
+      _mm256_storeu_si256 ((__m256i *) result[c],
+                           gimp_brush_transform_lerp_avx2 (top, top_next,
+                                                           below, below_next,
+                                                           _mm_cvtsi32_si128 (8 * c),
+                                                           x, y));
+    }
+
+  for (i = 0; i < 8; i++)
+    {
+      dest[3 * i + 0] = result[0][i];
+      dest[3 * i + 1] = result[1][i];
+      dest[3 * i + 2] = result[2][i];
+    }
+
+  return TRUE;
+}
+
+#endif /* COMPILE_AVX2_INTRINISICS */
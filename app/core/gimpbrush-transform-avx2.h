@@ -0,0 +1,53 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimpbrush-transform-avx2.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GIMP_BRUSH_TRANSFORM_AVX2_H__
+#define __GIMP_BRUSH_TRANSFORM_AVX2_H__
+
+
+#if COMPILE_AVX2_INTRINISICS
+
+/*  sample 8 consecutive destination pixels of a transformed brush mask
+ *  or pixmap, walking from (x_i, y_i) by (walk_x_i, walk_y_i), with the
+ *  fixed-point bilinear interpolation of gimpbrush-transform.cc.
+ *
+ *  return FALSE, without writing anything, if some of the pixels need
+ *  the edge handling of the scalar code.
+ */
+gboolean   gimp_brush_transform_mask_sample_8_avx2   (const guchar *src,
+                                                      gint          src_width,
+                                                      gint          src_height,
+                                                      gint          x_i,
+                                                      gint          y_i,
+                                                      gint          walk_x_i,
+                                                      gint          walk_y_i,
+                                                      guchar       *dest);
+gboolean   gimp_brush_transform_pixmap_sample_8_avx2 (const guchar *src,
+                                                      gint          src_width,
+                                                      gint          src_height,
+                                                      gint          x_i,
+                                                      gint          y_i,
+                                                      gint          walk_x_i,
+                                                      gint          walk_y_i,
+                                                      guchar       *dest);
+
+#endif /* COMPILE_AVX2_INTRINISICS */
+
+
+#endif /* __GIMP_BRUSH_TRANSFORM_AVX2_H__ */
@@ -24,11 +24,12 @@
 #include <gdk-pixbuf/gdk-pixbuf.h>
 #include <gegl.h>
 
-#include "libgimpmath/gimpmath.h"
-
 extern "C"
 {
 
+#include "libgimpbase/gimpbase.h"
+#include "libgimpmath/gimpmath.h"
+
 #include "core-types.h"
 
 #include "gegl/gimp-gegl-loops.h"
@@ -36,6 +37,7 @@ extern "C"
 #include "gimpbrush.h"
 #include "gimpbrush-mipmap.h"
 #include "gimpbrush-transform.h"
+#include "gimpbrush-transform-avx2.h"
 #include "gimptempbuf.h"
 
 
@@ -43,6 +45,17 @@ extern "C"
   (/* each thread costs as much as */ 64.0 * 64.0 /* pixels */)
 
 
+/*  the source samples of each destination row or column, when the
+ *  transform is a pure scale, so that rows and columns are independent
+ */
+typedef struct
+{
+  gint *index;    /* first sample, or -1 when outside of the source */
+  gint *next;     /* second sample                                  */
+  gint *distance; /* distance from the first sample, fixed-point   */
+} AxisSamples;
+
+
 /*  local function prototypes  */
 
 static void    gimp_brush_transform_bounding_box           (const GimpTempBuf *temp_buf,
@@ -52,6 +65,13 @@ static void    gimp_brush_transform_bounding_box           (const GimpTempBuf *t
                                                             gint              *width,
                                                             gint              *height);
 
+static void    gimp_brush_transform_axis_init              (AxisSamples       *axis,
+                                                            gint               n,
+                                                            gint               start_i,
+                                                            gint               walk_i,
+                                                            gint               src_size);
+static void    gimp_brush_transform_axis_clear             (AxisSamples       *axis);
+
 static void    gimp_brush_transform_blur                   (GimpTempBuf       *buf,
                                                             gint               r);
 static gint    gimp_brush_transform_blur_radius            (gint               height,
@@ -113,6 +133,9 @@ gimp_brush_real_transform_size (GimpBrush *brush,
  * than the input brush size.
  *
  * There are no floating point calculations in the inner loop for speed.
+ * When the transform doesn't rotate, the source samples are computed
+ * once per destination row and column, and when the CPU supports AVX2,
+ * the remaining case samples 8 pixels at a time.
  *
  * Some variables end with the suffix _i to indicate they have been
  * premultiplied by int_multiple
@@ -152,6 +175,13 @@ gimp_brush_real_transform_mask (GimpBrush *brush,
   gint               src_y_min_i;
   gint               src_x_max_i;
   gint               src_y_max_i;
+  gboolean           separable;
+  AxisSamples        columns = {};
+  AxisSamples        rows    = {};
+#if COMPILE_AVX2_INTRINISICS
+  gboolean           avx2 = (gimp_cpu_accel_get_support () &
+                             GIMP_CPU_ACCEL_X86_AVX2);
+#endif
 
   /*
    * tl, tr etc are used because it is easier to visualize top left,
@@ -289,6 +319,18 @@ gimp_brush_real_transform_mask (GimpBrush *brush,
   src_x_max_i = src_width  * int_multiple - int_multiple / 2;
   src_y_max_i = src_height * int_multiple - int_multiple / 2;
 
+  separable = (src_walk_uy_i == 0 && src_walk_vx_i == 0);
+
+  if (separable)
+    {
+      gimp_brush_transform_axis_init (&columns, dest_width,
+                                      (gint) (t_lx * int_multiple),
+                                      src_walk_ux_i, src_width);
+      gimp_brush_transform_axis_init (&rows, dest_height,
+                                      (gint) (t_ly * int_multiple),
+                                      src_walk_vy_i, src_height);
+    }
+
   gegl_parallel_distribute_area (
     GEGL_RECTANGLE (0, 0, dest_width, dest_height), PIXELS_PER_THREAD,
     [=] (const GeglRectangle *area)
@@ -311,6 +353,55 @@ gimp_brush_real_transform_mask (GimpBrush *brush,
       dest = gimp_temp_buf_get_data (result) +
              dest_width * area->y + area->x;
 
+      if (separable)
+        {
+          for (v = 0; v < area->height; v++)
+            {
+              gint y = area->y + v;
+
+              if (rows.index[y] < 0)
+                {
+                  memset (dest, 0, area->width);
+                }
+              else
+                {
+                  const guchar *row       = src + rows.index[y] * src_width;
+                  const guchar *row_below = src + rows.next[y]  * src_width;
+
+                  distance_from_true_y = rows.distance[y];
+                  opposite_y           = int_multiple - distance_from_true_y;
+
+                  for (u = 0; u < area->width; u++)
+                    {
+                      gint x    = area->x + u;
+                      gint left = columns.index[x];
+
+                      if (left < 0)
+                        {
+                          dest[u] = 0;
+                        }
+                      else
+                        {
+                          gint right = columns.next[x];
+
+                          distance_from_true_x = columns.distance[x];
+                          opposite_x = int_multiple - distance_from_true_x;
+
+                          dest[u] = ((row[left] * opposite_x +
+                                      row[right] * distance_from_true_x) * opposite_y +
+                                     (row_below[left] * opposite_x +
+                                      row_below[right] * distance_from_true_x) * distance_from_true_y
+                                    ) >> recovery_bits;
+                        }
+                    }
+                }
+
+              dest += dest_width;
+            }
+
+          return;
+        }
+
       /* initialize current position in source space to the start position (tl)
        * speed optimized, note conversion to int precision
        */
@@ -328,6 +419,27 @@ gimp_brush_real_transform_mask (GimpBrush *brush,
 
           for (u = 0; u < area->width; u++)
             {
+#if COMPILE_AVX2_INTRINISICS
+              /*  after a group that needs edge handling, continue with
+               *  the scalar code up to the next group
+               */
+              if (avx2 && u % 8 == 0 && area->width - u >= 8 &&
+                  gimp_brush_transform_mask_sample_8_avx2 (
+                    src, src_width, src_height,
+                    src_space_cur_pos_x_i, src_space_cur_pos_y_i,
+                    src_walk_ux_i, src_walk_uy_i,
+                    dest))
+                {
+                  src_space_cur_pos_x_i += 8 * src_walk_ux_i;
+                  src_space_cur_pos_y_i += 8 * src_walk_uy_i;
+
+                  dest += 8;
+                  u    += 7;
+
+                  continue;
+                }
+#endif
+
               if (src_space_cur_pos_x_i <  src_x_min_i ||
                   src_space_cur_pos_x_i >= src_x_max_i ||
                   src_space_cur_pos_y_i <  src_y_min_i ||
@@ -396,6 +508,12 @@ gimp_brush_real_transform_mask (GimpBrush *brush,
         } /* end for y */
     });
 
+  if (separable)
+    {
+      gimp_brush_transform_axis_clear (&columns);
+      gimp_brush_transform_axis_clear (&rows);
+    }
+
   gimp_brush_transform_blur (result, blur_radius);
 
   return result;
@@ -466,6 +584,13 @@ gimp_brush_real_transform_pixmap (GimpBrush *brush,
   gint               src_y_min_i;
   gint               src_x_max_i;
   gint               src_y_max_i;
+  gboolean           separable;
+  AxisSamples        columns = {};
+  AxisSamples        rows    = {};
+#if COMPILE_AVX2_INTRINISICS
+  gboolean           avx2 = (gimp_cpu_accel_get_support () &
+                             GIMP_CPU_ACCEL_X86_AVX2);
+#endif
 
   /*
    * tl, tr etc are used because it is easier to visualize top left,
@@ -603,6 +728,18 @@ gimp_brush_real_transform_pixmap (GimpBrush *brush,
   src_x_max_i = src_width  * int_multiple - int_multiple / 2;
   src_y_max_i = src_height * int_multiple - int_multiple / 2;
 
+  separable = (src_walk_uy_i == 0 && src_walk_vx_i == 0);
+
+  if (separable)
+    {
+      gimp_brush_transform_axis_init (&columns, dest_width,
+                                      (gint) (t_lx * int_multiple),
+                                      src_walk_ux_i, src_width);
+      gimp_brush_transform_axis_init (&rows, dest_height,
+                                      (gint) (t_ly * int_multiple),
+                                      src_walk_vy_i, src_height);
+    }
+
   gegl_parallel_distribute_area (
     GEGL_RECTANGLE (0, 0, dest_width, dest_height), PIXELS_PER_THREAD,
     [=] (const GeglRectangle *area)
@@ -625,6 +762,64 @@ gimp_brush_real_transform_pixmap (GimpBrush *brush,
       dest = gimp_temp_buf_get_data (result) +
              3 * (dest_width * area->y + area->x);
 
+      if (separable)
+        {
+          for (v = 0; v < area->height; v++)
+            {
+              gint y = area->y + v;
+
+              if (rows.index[y] < 0)
+                {
+                  memset (dest, 0, 3 * area->width);
+                }
+              else
+                {
+                  const guchar *row       = src + 3 * rows.index[y] * src_width;
+                  const guchar *row_below = src + 3 * rows.next[y]  * src_width;
+
+                  distance_from_true_y = rows.distance[y];
+                  opposite_y           = int_multiple - distance_from_true_y;
+
+                  for (u = 0; u < area->width; u++)
+                    {
+                      gint x    = area->x + u;
+                      gint left = columns.index[x];
+                      gint c;
+
+                      if (left < 0)
+                        {
+                          dest[3 * u + 0] = 0;
+                          dest[3 * u + 1] = 0;
+                          dest[3 * u + 2] = 0;
+                        }
+                      else
+                        {
+                          gint right = 3 * columns.next[x];
+
+                          left *= 3;
+
+                          distance_from_true_x = columns.distance[x];
+                          opposite_x = int_multiple - distance_from_true_x;
+
+                          for (c = 0; c < 3; c++)
+                            {
+                              dest[3 * u + c] =
+                                ((row[left + c] * opposite_x +
+                                  row[right + c] * distance_from_true_x) * opposite_y +
+                                 (row_below[left + c] * opposite_x +
+                                  row_below[right + c] * distance_from_true_x) * distance_from_true_y
+                                ) >> recovery_bits;
+                            }
+                        }
+                    }
+                }
+
+              dest += 3 * dest_width;
+            }
+
+          return;
+        }
+
       /* initialize current position in source space to the start position (tl)
        * speed optimized, note conversion to int precision
        */
@@ -642,6 +837,24 @@ gimp_brush_real_transform_pixmap (GimpBrush *brush,
 
           for (u = 0; u < area->width; u++)
             {
+#if COMPILE_AVX2_INTRINISICS
+              if (avx2 && u % 8 == 0 && area->width - u >= 8 &&
+                  gimp_brush_transform_pixmap_sample_8_avx2 (
+                    src, src_width, src_height,
+                    src_space_cur_pos_x_i, src_space_cur_pos_y_i,
+                    src_walk_ux_i, src_walk_uy_i,
+                    dest))
+                {
+                  src_space_cur_pos_x_i += 8 * src_walk_ux_i;
+                  src_space_cur_pos_y_i += 8 * src_walk_uy_i;
+
+                  dest += 3 * 8;
+                  u    += 7;
+
+                  continue;
+                }
+#endif
+
               if (src_space_cur_pos_x_i <  src_x_min_i ||
                   src_space_cur_pos_x_i >= src_x_max_i ||
                   src_space_cur_pos_y_i <  src_y_min_i ||
@@ -724,6 +937,12 @@ gimp_brush_real_transform_pixmap (GimpBrush *brush,
         } /* end for y */
     });
 
+  if (separable)
+    {
+      gimp_brush_transform_axis_clear (&columns);
+      gimp_brush_transform_axis_clear (&rows);
+    }
+
   gimp_brush_transform_blur (result, blur_radius);
 
   return result;
@@ -770,6 +989,63 @@ gimp_brush_transform_matrix (gdouble      width,
 
 /*  private functions  */
 
+static void
+gimp_brush_transform_axis_init (AxisSamples *axis,
+                                gint         n,
+                                gint         start_i,
+                                gint         walk_i,
+                                gint         src_size)
+{
+  /*  the same fixed-point positions and edge handling as in
+   *  gimp_brush_real_transform_mask()
+   */
+  const gint fraction_bits    = 12;
+  const gint int_multiple     = 1 << fraction_bits;
+  const gint fraction_bitmask = int_multiple - 1;
+  const gint min_i            = -int_multiple / 2;
+  const gint max_i            = src_size * int_multiple - int_multiple / 2;
+  gint       pos_i            = start_i;
+  gint       i;
+
+  axis->index    = g_new (gint, n);
+  axis->next     = g_new (gint, n);
+  axis->distance = g_new (gint, n);
+
+  for (i = 0; i < n; i++)
+    {
+      if (pos_i < min_i || pos_i >= max_i)
+        {
+          axis->index[i]    = -1;
+          axis->next[i]     = -1;
+          axis->distance[i] = 0;
+        }
+      else
+        {
+          gint pos = pos_i >> fraction_bits;
+
+          axis->index[i] = pos;
+          axis->next[i]  = pos + 1;
+
+          if (pos < 0)
+            axis->index[i] = axis->next[i];
+          else if (pos >= src_size - 1)
+            axis->next[i] = axis->index[i];
+
+          axis->distance[i] = pos_i & fraction_bitmask;
+        }
+
+      pos_i += walk_i;
+    }
+}
+
+static void
+gimp_brush_transform_axis_clear (AxisSamples *axis)
+{
+  g_clear_pointer (&axis->index,    g_free);
+  g_clear_pointer (&axis->next,     g_free);
+  g_clear_pointer (&axis->distance, g_free);
+}
+
 static void
 gimp_brush_transform_bounding_box (const GimpTempBuf *temp_buf,
                                    const GimpMatrix3 *matrix,
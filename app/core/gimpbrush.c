@@ -453,18 +453,26 @@ static void
 gimp_brush_real_begin_use (GimpBrush *brush)
 {
   brush->priv->mask_cache =
-    gimp_brush_cache_new ((GDestroyNotify) gimp_temp_buf_unref, 'M', 'm');
+    gimp_brush_cache_new ((GDestroyNotify) gimp_temp_buf_unref,
+                          (GimpBrushCacheSizeFunc) gimp_temp_buf_get_memsize,
+                          'M', 'm');
 
   brush->priv->pixmap_cache =
-    gimp_brush_cache_new ((GDestroyNotify) gimp_temp_buf_unref, 'P', 'p');
+    gimp_brush_cache_new ((GDestroyNotify) gimp_temp_buf_unref,
+                          (GimpBrushCacheSizeFunc) gimp_temp_buf_get_memsize,
+                          'P', 'p');
 
   brush->priv->boundary_cache =
-    gimp_brush_cache_new ((GDestroyNotify) gimp_bezier_desc_free, 'B', 'b');
+    gimp_brush_cache_new ((GDestroyNotify) gimp_bezier_desc_free,
+                          (GimpBrushCacheSizeFunc) gimp_bezier_desc_get_memsize,
+                          'B', 'b');
 }
 
 static void
 gimp_brush_real_end_use (GimpBrush *brush)
 {
+  gimp_brush_mipmap_store (brush);
+
   g_clear_object (&brush->priv->mask_cache);
   g_clear_object (&brush->priv->pixmap_cache);
   g_clear_object (&brush->priv->boundary_cache);
@@ -621,6 +629,8 @@ gimp_brush_transform_size (GimpBrush     *brush,
   g_return_if_fail (width != NULL);
   g_return_if_fail (height != NULL);
 
+  gimp_brush_cache_quantize (&scale, &aspect_ratio, &angle, NULL);
+
   if (scale             == 1.0 &&
       aspect_ratio      == 0.0 &&
       fmod (angle, 0.5) == 0.0)
@@ -652,6 +662,9 @@ gimp_brush_transform_mask (GimpBrush *brush,
   g_return_val_if_fail (GIMP_IS_BRUSH (brush), NULL);
   g_return_val_if_fail (scale > 0.0, NULL);
 
+  gimp_brush_cache_quantize (&scale, &aspect_ratio, &angle, &hardness);
+  effective_hardness = hardness;
+
   gimp_brush_transform_size (brush,
                              scale, aspect_ratio, angle, reflect,
                              &width, &height);
@@ -720,6 +733,9 @@ gimp_brush_transform_pixmap (GimpBrush *brush,
   g_return_val_if_fail (brush->priv->pixmap != NULL, NULL);
   g_return_val_if_fail (scale > 0.0, NULL);
 
+  gimp_brush_cache_quantize (&scale, &aspect_ratio, &angle, &hardness);
+  effective_hardness = hardness;
+
   gimp_brush_transform_size (brush,
                              scale, aspect_ratio, angle, reflect,
                              &width, &height);
@@ -783,6 +799,8 @@ gimp_brush_transform_boundary (GimpBrush *brush,
   g_return_val_if_fail (width != NULL, NULL);
   g_return_val_if_fail (height != NULL, NULL);
 
+  gimp_brush_cache_quantize (&scale, &aspect_ratio, &angle, &hardness);
+
   gimp_brush_transform_size (brush,
                              scale, aspect_ratio, angle, reflect,
                              width, height);
@@ -862,6 +880,18 @@ gimp_brush_flush_blur_caches (GimpBrush *brush)
 #endif
 }
 
+/*  drops the mipmaps of a brush that isn't in use, they are rebuilt, or
+ *  reloaded, the next time it is.
+ */
+void
+gimp_brush_flush_mipmaps (GimpBrush *brush)
+{
+  g_return_if_fail (GIMP_IS_BRUSH (brush));
+
+  if (brush->priv->use_count == 0)
+    gimp_brush_mipmap_clear (brush);
+}
+
 gdouble
 gimp_brush_get_blur_hardness (GimpBrush *brush)
 {
@@ -147,6 +147,7 @@ GimpVector2            gimp_brush_get_x_axis         (GimpBrush        *brush);
 GimpVector2            gimp_brush_get_y_axis         (GimpBrush        *brush);
 
 void                   gimp_brush_flush_blur_caches  (GimpBrush        *brush);
+void                   gimp_brush_flush_mipmaps      (GimpBrush        *brush);
 gdouble                gimp_brush_get_blur_hardness  (GimpBrush        *brush);
 
 #endif /* __GIMP_BRUSH_H__ */
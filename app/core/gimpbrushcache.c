@@ -24,6 +24,7 @@
 #include <gegl.h>
 
 #include "libgimpbase/gimpbase.h"
+#include "libgimpmath/gimpmath.h"
 
 #include "core-types.h"
 
@@ -33,7 +34,16 @@
 #include "gimp-intl.h"
 
 
-#define MAX_CACHED_DATA 20
+/*  the caches are per brush, and only exist while the brush is in use.
+ *  units are looked up by their exact parameters, which the brush
+ *  quantizes first (see gimp_brush_cache_quantize()), so that dynamics
+ *  varying the parameters slightly from dab to dab still hit the cache.
+ *  each cache evicts its least recently used units once it holds too
+ *  many of them, or once all caches together use more memory than the
+ *  configured limit.
+ */
+
+#define MAX_CACHED_DATA 1024
 
 
 enum
@@ -47,7 +57,10 @@ typedef struct _GimpBrushCacheUnit GimpBrushCacheUnit;
 
 struct _GimpBrushCacheUnit
 {
+  GList    link;
+
   gpointer data;
+  gsize    memsize;
 
   gint     width;
   gint     height;
@@ -59,16 +72,22 @@ struct _GimpBrushCacheUnit
 };
 
 
-static void   gimp_brush_cache_constructed  (GObject      *object);
-static void   gimp_brush_cache_finalize     (GObject      *object);
-static void   gimp_brush_cache_set_property (GObject      *object,
-                                             guint         property_id,
-                                             const GValue *value,
-                                             GParamSpec   *pspec);
-static void   gimp_brush_cache_get_property (GObject      *object,
-                                             guint         property_id,
-                                             GValue       *value,
-                                             GParamSpec   *pspec);
+static void       gimp_brush_cache_constructed  (GObject            *object);
+static void       gimp_brush_cache_finalize     (GObject            *object);
+static void       gimp_brush_cache_set_property (GObject            *object,
+                                                 guint               property_id,
+                                                 const GValue       *value,
+                                                 GParamSpec         *pspec);
+static void       gimp_brush_cache_get_property (GObject            *object,
+                                                 guint               property_id,
+                                                 GValue             *value,
+                                                 GParamSpec         *pspec);
+
+static guint      gimp_brush_cache_unit_hash    (gconstpointer       key);
+static gboolean   gimp_brush_cache_unit_equal   (gconstpointer       a,
+                                                 gconstpointer       b);
+static void       gimp_brush_cache_remove_unit  (GimpBrushCache     *cache,
+                                                 GimpBrushCacheUnit *unit);
 
 
 G_DEFINE_TYPE (GimpBrushCache, gimp_brush_cache, GIMP_TYPE_OBJECT)
@@ -76,6 +95,13 @@ G_DEFINE_TYPE (GimpBrushCache, gimp_brush_cache, GIMP_TYPE_OBJECT)
 #define parent_class gimp_brush_cache_parent_class
 
 
+static guintptr brush_cache_total_memsize = 0;
+static guintptr brush_cache_max_memsize   = 1 << 26; /* 64MB */
+static gint     brush_cache_precision     = 64;
+static guint    brush_cache_hits          = 0;
+static guint    brush_cache_misses        = 0;
+
+
 static void
 gimp_brush_cache_class_init (GimpBrushCacheClass *klass)
 {
@@ -94,8 +120,12 @@ gimp_brush_cache_class_init (GimpBrushCacheClass *klass)
 }
 
 static void
-gimp_brush_cache_init (GimpBrushCache *brush)
+gimp_brush_cache_init (GimpBrushCache *cache)
 {
+  cache->units = g_hash_table_new (gimp_brush_cache_unit_hash,
+                                   gimp_brush_cache_unit_equal);
+
+  g_queue_init (&cache->lru);
 }
 
 static void
@@ -115,6 +145,8 @@ gimp_brush_cache_finalize (GObject *object)
 
   gimp_brush_cache_clear (cache);
 
+  g_clear_pointer (&cache->units, g_hash_table_unref);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -162,9 +194,10 @@ gimp_brush_cache_get_property (GObject    *object,
 /*  public functions  */
 
 GimpBrushCache *
-gimp_brush_cache_new (GDestroyNotify  data_destroy,
-                      gchar           debug_hit,
-                      gchar           debug_miss)
+gimp_brush_cache_new (GDestroyNotify          data_destroy,
+                      GimpBrushCacheSizeFunc  data_size,
+                      gchar                   debug_hit,
+                      gchar                   debug_miss)
 {
   GimpBrushCache *cache;
 
@@ -174,6 +207,7 @@ gimp_brush_cache_new (GDestroyNotify  data_destroy,
                          "data-destroy", data_destroy,
                          NULL);
 
+  cache->data_size  = data_size;
   cache->debug_hit  = debug_hit;
   cache->debug_miss = debug_miss;
 
@@ -185,20 +219,8 @@ gimp_brush_cache_clear (GimpBrushCache *cache)
 {
   g_return_if_fail (GIMP_IS_BRUSH_CACHE (cache));
 
-  if (cache->cached_units)
-    {
-      GList *iter;
-
-      for (iter = cache->cached_units; iter; iter = g_list_next (iter))
-        {
-          GimpBrushCacheUnit *unit = iter->data;
-
-          cache->data_destroy (unit->data);
-        }
-
-      g_list_free_full (cache->cached_units, g_free);
-      cache->cached_units = NULL;
-    }
+  while (cache->lru.head)
+    gimp_brush_cache_remove_unit (cache, cache->lru.head->data);
 }
 
 gconstpointer
@@ -211,40 +233,40 @@ gimp_brush_cache_get (GimpBrushCache *cache,
                       gboolean        reflect,
                       gdouble         hardness)
 {
-  GList *iter;
+  GimpBrushCacheUnit  key;
+  GimpBrushCacheUnit *unit;
 
   g_return_val_if_fail (GIMP_IS_BRUSH_CACHE (cache), NULL);
 
-  for (iter = cache->cached_units; iter; iter = g_list_next (iter))
+  key.width        = width;
+  key.height       = height;
+  key.scale        = scale;
+  key.aspect_ratio = aspect_ratio;
+  key.angle        = angle;
+  key.reflect      = reflect;
+  key.hardness     = hardness;
+
+  unit = g_hash_table_lookup (cache->units, &key);
+
+  if (unit)
     {
-      GimpBrushCacheUnit *unit = iter->data;
-
-      if (unit->data                         &&
-          unit->width        == width        &&
-          unit->height       == height       &&
-          unit->scale        == scale        &&
-          unit->aspect_ratio == aspect_ratio &&
-          unit->angle        == angle        &&
-          unit->reflect      == reflect      &&
-          unit->hardness     == hardness)
-        {
-          if (gimp_log_flags & GIMP_LOG_BRUSH_CACHE)
-            g_printerr ("%c", cache->debug_hit);
+      if (gimp_log_flags & GIMP_LOG_BRUSH_CACHE)
+        g_printerr ("%c", cache->debug_hit);
 
-          /* Make the returned cached brush first in the list. */
-          cache->cached_units = g_list_remove_link (cache->cached_units, iter);
-          iter->next = cache->cached_units;
-          if (cache->cached_units)
-            cache->cached_units->prev = iter;
-          cache->cached_units = iter;
+      g_atomic_int_inc ((gint *) &brush_cache_hits);
 
-          return (gconstpointer) unit->data;
-        }
+      /* Make the returned cached brush first in the list. */
+      g_queue_unlink (&cache->lru, &unit->link);
+      g_queue_push_head_link (&cache->lru, &unit->link);
+
+      return (gconstpointer) unit->data;
     }
 
   if (gimp_log_flags & GIMP_LOG_BRUSH_CACHE)
     g_printerr ("%c", cache->debug_miss);
 
+  g_atomic_int_inc ((gint *) &brush_cache_misses);
+
   return NULL;
 }
 
@@ -259,36 +281,15 @@ gimp_brush_cache_add (GimpBrushCache *cache,
                       gboolean        reflect,
                       gdouble         hardness)
 {
-  GList              *iter;
   GimpBrushCacheUnit *unit;
-  GList              *last   = NULL;
-  gint                length = 0;
+  GimpBrushCacheUnit *old;
 
   g_return_if_fail (GIMP_IS_BRUSH_CACHE (cache));
   g_return_if_fail (data != NULL);
 
-  for (iter = cache->cached_units; iter; iter = g_list_next (iter))
-    {
-      unit = iter->data;
-
-      if (data == unit->data)
-        return;
-
-      length++;
-      last = iter;
-    }
-
-  if (length > MAX_CACHED_DATA)
-    {
-      unit = last->data;
-
-      cache->data_destroy (unit->data);
-      cache->cached_units = g_list_delete_link (cache->cached_units, last);
-      g_free (unit);
-    }
-
-  unit = g_new0 (GimpBrushCacheUnit, 1);
+  unit = g_slice_new0 (GimpBrushCacheUnit);
 
+  unit->link.data    = unit;
   unit->data         = data;
   unit->width        = width;
   unit->height       = height;
@@ -298,5 +299,154 @@ gimp_brush_cache_add (GimpBrushCache *cache,
   unit->reflect      = reflect;
   unit->hardness     = hardness;
 
-  cache->cached_units = g_list_prepend (cache->cached_units, unit);
+  if (cache->data_size)
+    unit->memsize = cache->data_size (data);
+
+  /*  replace an existing unit with the same parameters  */
+  old = g_hash_table_lookup (cache->units, unit);
+
+  if (old)
+    {
+      if (old->data == data)
+        {
+          g_slice_free (GimpBrushCacheUnit, unit);
+
+          return;
+        }
+
+      gimp_brush_cache_remove_unit (cache, old);
+    }
+
+  g_hash_table_add (cache->units, unit);
+  g_queue_push_head_link (&cache->lru, &unit->link);
+
+  cache->memsize += unit->memsize;
+  g_atomic_pointer_add (&brush_cache_total_memsize, unit->memsize);
+
+  /*  evict the least recently used units, but always keep the new one  */
+  while (cache->lru.length > 1 &&
+         (cache->lru.length > MAX_CACHED_DATA ||
+          g_atomic_pointer_get (&brush_cache_total_memsize) >
+          g_atomic_pointer_get (&brush_cache_max_memsize)))
+    {
+      gimp_brush_cache_remove_unit (cache, cache->lru.tail->data);
+    }
+}
+
+void
+gimp_brush_cache_set_limits (guint64 max_memsize,
+                             gint    precision)
+{
+  g_atomic_pointer_set (&brush_cache_max_memsize,
+                        (guintptr) MIN (max_memsize, G_MAXSIZE));
+  g_atomic_int_set (&brush_cache_precision, MAX (precision, 0));
+}
+
+void
+gimp_brush_cache_quantize (gdouble *scale,
+                           gdouble *aspect_ratio,
+                           gdouble *angle,
+                           gdouble *hardness)
+{
+  gint precision = g_atomic_int_get (&brush_cache_precision);
+
+  if (precision == 0)
+    return;
+
+  /*  the scale is quantized logarithmically, and the angle in
+   *  8 * precision steps per turn.  identity values, and multiples
+   *  of half a turn, are kept exact, so that untransformed brushes
+   *  still take the fast paths.
+   */
+  if (scale && *scale > 0.0)
+    *scale = exp2 (RINT (log2 (*scale) * precision) / precision);
+
+  if (aspect_ratio)
+    *aspect_ratio = RINT (*aspect_ratio * precision) / precision;
+
+  if (angle)
+    *angle = RINT (*angle * 8 * precision) / (8 * precision);
+
+  if (hardness)
+    *hardness = RINT (*hardness * precision) / precision;
+}
+
+guint64
+gimp_brush_cache_get_total_memsize (void)
+{
+  return g_atomic_pointer_get (&brush_cache_total_memsize);
+}
+
+gdouble
+gimp_brush_cache_get_hit_rate (void)
+{
+  /*  the rate since the previous call, called periodically by the
+   *  dashboard
+   */
+  static guint   last_hits   = 0;
+  static guint   last_misses = 0;
+  static gdouble last_rate   = 0.0;
+  guint          hits;
+  guint          misses;
+
+  hits   = g_atomic_int_get ((gint *) &brush_cache_hits)   - last_hits;
+  misses = g_atomic_int_get ((gint *) &brush_cache_misses) - last_misses;
+
+  if (hits + misses > 0)
+    last_rate = (gdouble) hits / (hits + misses);
+
+  last_hits   += hits;
+  last_misses += misses;
+
+  return last_rate;
+}
+
+
+/*  private functions  */
+
+static guint
+gimp_brush_cache_unit_hash (gconstpointer key)
+{
+  const GimpBrushCacheUnit *unit = key;
+  guint                     hash;
+
+  hash = (guint) unit->width * 31 + (guint) unit->height;
+  hash = hash * 31 + g_double_hash (&unit->scale);
+  hash = hash * 31 + g_double_hash (&unit->aspect_ratio);
+  hash = hash * 31 + g_double_hash (&unit->angle);
+  hash = hash * 31 + g_double_hash (&unit->hardness);
+  hash = hash * 31 + (unit->reflect ? 1 : 0);
+
+  return hash;
+}
+
+static gboolean
+gimp_brush_cache_unit_equal (gconstpointer a,
+                             gconstpointer b)
+{
+  const GimpBrushCacheUnit *unit_a = a;
+  const GimpBrushCacheUnit *unit_b = b;
+
+  return (unit_a->width        == unit_b->width        &&
+          unit_a->height       == unit_b->height       &&
+          unit_a->scale        == unit_b->scale        &&
+          unit_a->aspect_ratio == unit_b->aspect_ratio &&
+          unit_a->angle        == unit_b->angle        &&
+          ! unit_a->reflect    == ! unit_b->reflect    &&
+          unit_a->hardness     == unit_b->hardness);
+}
+
+static void
+gimp_brush_cache_remove_unit (GimpBrushCache     *cache,
+                              GimpBrushCacheUnit *unit)
+{
+  g_hash_table_remove (cache->units, unit);
+  g_queue_unlink (&cache->lru, &unit->link);
+
+  cache->memsize -= unit->memsize;
+  g_atomic_pointer_add (&brush_cache_total_memsize, -(gssize) unit->memsize);
+
+  cache->data_destroy (unit->data);
+
+  g_slice_free (GimpBrushCacheUnit, unit);
 }
@@ -120,17 +120,42 @@ gimp_brush_pipe_load (GimpContext   *context,
 
   pipe->brushes = g_new0 (GimpBrush *, n_brushes);
 
-  while (pipe->n_brushes < n_brushes)
+  /*  only decode the first brush now, and remember where the others
+   *  are, gimp_brush_pipe_get_brush() loads them when they are needed
+   */
+  if (n_brushes > 1                &&
+      G_IS_SEEKABLE (input)        &&
+      g_seekable_can_seek (G_SEEKABLE (input)))
     {
-      pipe->brushes[pipe->n_brushes] = gimp_brush_load_brush (context,
-                                                              file, input,
-                                                              error);
+      pipe->file    = g_object_ref (file);
+      pipe->offsets = g_new0 (goffset, n_brushes);
+    }
 
-      if (! pipe->brushes[pipe->n_brushes])
+  while (pipe->n_brushes < n_brushes)
+    {
+      if (pipe->offsets && pipe->n_brushes > 0)
+        {
+          pipe->offsets[pipe->n_brushes] = g_seekable_tell (G_SEEKABLE (input));
+
+          if (! gimp_brush_skip_brush (file, input, error))
+            {
+              g_object_unref (pipe);
+              g_string_free (buffer, TRUE);
+              return NULL;
+            }
+        }
+      else
         {
-          g_object_unref (pipe);
-          g_string_free (buffer, TRUE);
-          return NULL;
+          pipe->brushes[pipe->n_brushes] = gimp_brush_load_brush (context,
+                                                                  file, input,
+                                                                  error);
+
+          if (! pipe->brushes[pipe->n_brushes])
+            {
+              g_object_unref (pipe);
+              g_string_free (buffer, TRUE);
+              return NULL;
+            }
         }
 
       pipe->n_brushes++;
@@ -45,7 +45,7 @@ gimp_brush_pipe_save (GimpData       *data,
 
   for (i = 0; i < pipe->n_brushes; i++)
     {
-      GimpBrush *brush = pipe->brushes[i];
+      GimpBrush *brush = gimp_brush_pipe_get_brush (pipe, i);
 
       if (brush &&
           ! GIMP_DATA_GET_CLASS (brush)->save (GIMP_DATA (brush),
@@ -21,11 +21,13 @@
 #include <gdk-pixbuf/gdk-pixbuf.h>
 #include <gegl.h>
 
+#include "libgimpbase/gimpbase.h"
 #include "libgimpbase/gimpparasiteio.h"
 #include "libgimpmath/gimpmath.h"
 
 #include "core-types.h"
 
+#include "gimpbrush-load.h"
 #include "gimpbrush-private.h"
 #include "gimpbrushpipe.h"
 #include "gimpbrushpipe-load.h"
@@ -58,6 +60,9 @@ static gboolean      gimp_brush_pipe_want_null_motion (GimpBrush        *brush,
                                                        const GimpCoords *last_coords,
                                                        const GimpCoords *current_coords);
 
+static GimpBrush   * gimp_brush_pipe_load_brush       (GimpBrushPipe    *pipe,
+                                                       gint              index);
+
 
 G_DEFINE_TYPE (GimpBrushPipe, gimp_brush_pipe, GIMP_TYPE_BRUSH);
 
@@ -100,6 +105,10 @@ gimp_brush_pipe_init (GimpBrushPipe *pipe)
   pipe->brushes   = NULL;
   pipe->select    = NULL;
   pipe->index     = NULL;
+  pipe->file      = NULL;
+  pipe->offsets   = NULL;
+
+  g_mutex_init (&pipe->load_mutex);
 }
 
 static void
@@ -112,6 +121,8 @@ gimp_brush_pipe_finalize (GObject *object)
   g_clear_pointer (&pipe->select, g_free);
   g_clear_pointer (&pipe->index,  g_free);
   g_clear_pointer (&pipe->params, g_free);
+  g_clear_pointer (&pipe->offsets, g_free);
+  g_clear_object (&pipe->file);
 
   if (pipe->brushes)
     {
@@ -127,6 +138,8 @@ gimp_brush_pipe_finalize (GObject *object)
   GIMP_BRUSH (pipe)->priv->mask   = NULL;
   GIMP_BRUSH (pipe)->priv->pixmap = NULL;
 
+  g_mutex_clear (&pipe->load_mutex);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -143,8 +156,9 @@ gimp_brush_pipe_get_memsize (GimpObject *object,
                                 sizeof (PipeSelectModes));
 
   for (i = 0; i < pipe->n_brushes; i++)
-    memsize += gimp_object_get_memsize (GIMP_OBJECT (pipe->brushes[i]),
-                                        gui_size);
+    if (pipe->brushes[i])
+      memsize += gimp_object_get_memsize (GIMP_OBJECT (pipe->brushes[i]),
+                                          gui_size);
 
   return memsize + GIMP_OBJECT_CLASS (parent_class)->get_memsize (object,
                                                                   gui_size);
@@ -198,17 +212,21 @@ gimp_brush_pipe_copy (GimpData *data,
       g_object_unref (pipe->brushes[i]);
   g_clear_pointer (&pipe->brushes, g_free);
 
+  g_clear_pointer (&pipe->offsets, g_free);
+  g_clear_object (&pipe->file);
+
   pipe->n_brushes = src_pipe->n_brushes;
 
   pipe->brushes = g_new0 (GimpBrush *, pipe->n_brushes);
   for (i = 0; i < pipe->n_brushes; i++)
-    if (src_pipe->brushes[i])
-      {
-        pipe->brushes[i] =
-          GIMP_BRUSH (gimp_data_duplicate (GIMP_DATA (src_pipe->brushes[i])));
-        gimp_object_set_name (GIMP_OBJECT (pipe->brushes[i]),
-                              gimp_object_get_name (src_pipe->brushes[i]));
-      }
+    {
+      GimpBrush *src_brush = gimp_brush_pipe_get_brush (src_pipe, i);
+
+      pipe->brushes[i] =
+        GIMP_BRUSH (gimp_data_duplicate (GIMP_DATA (src_brush)));
+      gimp_object_set_name (GIMP_OBJECT (pipe->brushes[i]),
+                            gimp_object_get_name (src_brush));
+    }
 
   g_clear_pointer (&pipe->params, g_free);
   pipe->params = g_strdup (src_pipe->params);
@@ -248,6 +266,17 @@ gimp_brush_pipe_end_use (GimpBrush *brush)
   for (i = 0; i < pipe->n_brushes; i++)
     if (pipe->brushes[i])
       gimp_brush_end_use (pipe->brushes[i]);
+
+  /*  drop the brushes that were loaded on demand, they are loaded
+   *  again from the file the next time the pipe is used
+   */
+  if (pipe->offsets)
+    {
+      pipe->current = pipe->brushes[0];
+
+      for (i = 1; i < pipe->n_brushes; i++)
+        g_clear_object (&pipe->brushes[i]);
+    }
 }
 
 static GimpBrush *
@@ -311,7 +340,7 @@ gimp_brush_pipe_select_brush (GimpBrush        *brush,
   /* Make sure is inside bounds */
   brushix = CLAMP (brushix, 0, pipe->n_brushes - 1);
 
-  pipe->current = pipe->brushes[brushix];
+  pipe->current = gimp_brush_pipe_get_brush (pipe, brushix);
 
   return GIMP_BRUSH (pipe->current);
 }
@@ -418,3 +447,104 @@ gimp_brush_pipe_set_params (GimpBrushPipe *pipe,
 
   return TRUE;
 }
+
+GimpBrush *
+gimp_brush_pipe_get_brush (GimpBrushPipe *pipe,
+                           gint           index)
+{
+  GimpBrush *brush;
+
+  g_return_val_if_fail (GIMP_IS_BRUSH_PIPE (pipe), NULL);
+  g_return_val_if_fail (index >= 0 && index < pipe->n_brushes, NULL);
+
+  brush = g_atomic_pointer_get (&pipe->brushes[index]);
+
+  if (! brush)
+    {
+      g_mutex_lock (&pipe->load_mutex);
+
+      brush = pipe->brushes[index];
+
+      if (! brush)
+        {
+          if (pipe->offsets)
+            brush = gimp_brush_pipe_load_brush (pipe, index);
+
+          /*  fall back to the first brush if the file can't be read  */
+          if (! brush)
+            brush = g_object_ref (pipe->brushes[0]);
+
+          if (GIMP_BRUSH (pipe)->priv->use_count > 0)
+            gimp_brush_begin_use (brush);
+
+          g_atomic_pointer_set (&pipe->brushes[index], brush);
+        }
+
+      g_mutex_unlock (&pipe->load_mutex);
+    }
+
+  return brush;
+}
+
+
+/*  private functions  */
+
+static GimpBrush *
+gimp_brush_pipe_load_brush (GimpBrushPipe *pipe,
+                            gint           index)
+{
+  GimpBrush    *brush = NULL;
+  GFileInfo    *info;
+  GInputStream *input;
+  GError       *error = NULL;
+
+  /*  don't read from a file that changed since the pipe was loaded  */
+  info = g_file_query_info (pipe->file,
+                            G_FILE_ATTRIBUTE_TIME_MODIFIED,
+                            G_FILE_QUERY_INFO_NONE,
+                            NULL, &error);
+
+  if (info)
+    {
+      guint64 mtime;
+
+      mtime = g_file_info_get_attribute_uint64 (info,
+                                                G_FILE_ATTRIBUTE_TIME_MODIFIED);
+      g_object_unref (info);
+
+      if (gimp_data_get_mtime (GIMP_DATA (pipe)) != 0 &&
+          gimp_data_get_mtime (GIMP_DATA (pipe)) != mtime)
+        {
+          g_set_error (&error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
+                       "file was modified");
+        }
+    }
+
+  input = error ? NULL : G_INPUT_STREAM (g_file_read (pipe->file,
+                                                      NULL, &error));
+
+  if (input)
+    {
+      if (g_seekable_seek (G_SEEKABLE (input), pipe->offsets[index],
+                           G_SEEK_SET, NULL, &error))
+        {
+          GInputStream *buffered = g_buffered_input_stream_new (input);
+
+          brush = gimp_brush_load_brush (NULL, pipe->file, buffered, &error);
+
+          g_object_unref (buffered);
+        }
+
+      g_object_unref (input);
+    }
+
+  if (! brush)
+    {
+      g_printerr ("Loading brush %d of '%s' failed: %s\n",
+                  index, gimp_file_get_utf8_name (pipe->file),
+                  error ? error->message : "unknown error");
+      g_clear_error (&error);
+    }
+
+  return brush;
+}
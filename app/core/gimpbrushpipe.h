@@ -63,6 +63,10 @@ struct _GimpBrushPipe
   GimpBrush        *current;    /* Currently selected brush */
 
   gchar            *params;     /* For pipe <-> image conversion */
+
+  GFile            *file;       /* Where brushes[] not yet loaded are  */
+  goffset          *offsets;    /* Offset of each brush in file        */
+  GMutex            load_mutex;
 };
 
 struct _GimpBrushPipeClass
@@ -71,10 +75,13 @@ struct _GimpBrushPipeClass
 };
 
 
-GType      gimp_brush_pipe_get_type   (void) G_GNUC_CONST;
+GType       gimp_brush_pipe_get_type   (void) G_GNUC_CONST;
+
+gboolean    gimp_brush_pipe_set_params (GimpBrushPipe *pipe,
+                                        const gchar   *paramstring);
 
-gboolean   gimp_brush_pipe_set_params (GimpBrushPipe *pipe,
-                                       const gchar   *paramstring);
+GimpBrush * gimp_brush_pipe_get_brush  (GimpBrushPipe *pipe,
+                                        gint           index);
 
 
 #endif  /* __GIMP_BRUSH_PIPE_H__ */
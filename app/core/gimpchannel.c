@@ -37,6 +37,7 @@
 #include "gegl/gimp-gegl-loops.h"
 #include "gegl/gimp-gegl-mask.h"
 #include "gegl/gimp-gegl-nodes.h"
+#include "gegl/gimp-gegl-tile-share.h"
 
 #include "gimp.h"
 #include "gimp-utils.h"
@@ -311,6 +312,10 @@ gimp_channel_init (GimpChannel *channel)
   channel->segs_out       = NULL;
   channel->num_segs_in    = 0;
   channel->num_segs_out   = 0;
+
+  channel->boundary_cache_in  = NULL;
+  channel->boundary_cache_out = NULL;
+
   channel->empty          = FALSE;
   channel->bounds_known   = FALSE;
   channel->x1             = 0;
@@ -333,6 +338,9 @@ gimp_channel_finalize (GObject *object)
   g_clear_pointer (&channel->segs_in,  g_free);
   g_clear_pointer (&channel->segs_out, g_free);
 
+  g_clear_pointer (&channel->boundary_cache_in,  gimp_boundary_cache_free);
+  g_clear_pointer (&channel->boundary_cache_out, gimp_boundary_cache_free);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -965,6 +973,12 @@ gimp_channel_set_buffer (GimpDrawable        *drawable,
                                                   push_undo, undo_desc,
                                                   buffer, bounds);
 
+  if (channel->boundary_cache_in)
+    gimp_boundary_cache_invalidate (channel->boundary_cache_in, NULL);
+
+  if (channel->boundary_cache_out)
+    gimp_boundary_cache_invalidate (channel->boundary_cache_out, NULL);
+
   gegl_buffer_signal_connect (buffer, "changed",
                               G_CALLBACK (gimp_channel_buffer_changed),
                               channel);
@@ -1039,12 +1053,22 @@ gimp_channel_real_boundary (GimpChannel         *channel,
 
           buffer = gimp_drawable_get_buffer (GIMP_DRAWABLE (channel));
 
-          channel->segs_out = gimp_boundary_find (buffer, &rect,
-                                                  babl_format ("Y float"),
-                                                  GIMP_BOUNDARY_IGNORE_BOUNDS,
-                                                  x1, y1, x2, y2,
-                                                  GIMP_BOUNDARY_HALF_WAY,
-                                                  &channel->num_segs_out);
+          if (! channel->boundary_cache_in)
+            {
+              channel->boundary_cache_in  = gimp_boundary_cache_new ();
+              channel->boundary_cache_out = gimp_boundary_cache_new ();
+            }
+
+          /*  the caches only look again at the scanlines that changed
+           *  since the last time, see gimp_channel_buffer_changed()
+           */
+          channel->segs_out = gimp_boundary_cache_find (channel->boundary_cache_out,
+                                                        buffer, &rect,
+                                                        babl_format ("Y float"),
+                                                        GIMP_BOUNDARY_IGNORE_BOUNDS,
+                                                        x1, y1, x2, y2,
+                                                        GIMP_BOUNDARY_HALF_WAY,
+                                                        &channel->num_segs_out);
           x1 = MAX (x1, x3);
           y1 = MAX (y1, y3);
           x2 = MIN (x2, x4);
@@ -1052,12 +1076,13 @@ gimp_channel_real_boundary (GimpChannel         *channel,
 
           if (x2 > x1 && y2 > y1)
             {
-              channel->segs_in = gimp_boundary_find (buffer, NULL,
-                                                     babl_format ("Y float"),
-                                                     GIMP_BOUNDARY_WITHIN_BOUNDS,
-                                                     x1, y1, x2, y2,
-                                                     GIMP_BOUNDARY_HALF_WAY,
-                                                     &channel->num_segs_in);
+              channel->segs_in = gimp_boundary_cache_find (channel->boundary_cache_in,
+                                                           buffer, NULL,
+                                                           babl_format ("Y float"),
+                                                           GIMP_BOUNDARY_WITHIN_BOUNDS,
+                                                           x1, y1, x2, y2,
+                                                           GIMP_BOUNDARY_HALF_WAY,
+                                                           &channel->num_segs_in);
             }
           else
             {
@@ -1240,8 +1265,8 @@ gimp_channel_real_all (GimpChannel *channel,
 
   /*  clear the channel  */
   color = gegl_color_new ("#fff");
-  gegl_buffer_set_color (gimp_drawable_get_buffer (GIMP_DRAWABLE (channel)),
-                         NULL, color);
+  gimp_gegl_buffer_set_constant_color (
+    gimp_drawable_get_buffer (GIMP_DRAWABLE (channel)), NULL, color);
   g_object_unref (color);
 
   /*  we know the bounds  */
@@ -1493,6 +1518,12 @@ gimp_channel_buffer_changed (GeglBuffer          *buffer,
                              const GeglRectangle *rect,
                              GimpChannel         *channel)
 {
+  if (channel->boundary_cache_in)
+    gimp_boundary_cache_invalidate (channel->boundary_cache_in, rect);
+
+  if (channel->boundary_cache_out)
+    gimp_boundary_cache_invalidate (channel->boundary_cache_out, rect);
+
   gimp_drawable_invalidate_boundary (GIMP_DRAWABLE (channel));
 }
 
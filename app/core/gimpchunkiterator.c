@@ -53,17 +53,52 @@
 /* the width of the target-area sliding window */
 #define TARGET_AREA_HISTORY_SIZE 3
 
+/* the size of the cost-model cells */
+#define COST_MODEL_CELL_SIZE     256
+
+/* the weight of new samples in the cost-model moving averages */
+#define COST_MODEL_ALPHA         0.25
+
+/* the range of the ratio between the throughput of a cost-model cell and the
+ * overall throughput, used to scale the target area
+ */
+#define COST_MODEL_MIN_RATIO     0.25
+#define COST_MODEL_MAX_RATIO     4.0
+
+/* the maximal number of region rectangles to consider, when picking the next
+ * rectangle to process according to the cost model
+ */
+#define MAX_RECT_CANDIDATES      16
+
+
+typedef struct
+{
+  gint64  index;
+  gdouble throughput;
+} GimpChunkCostCell;
+
+struct _GimpChunkCostModel
+{
+  /* throughput is measured in pixels per microsecond */
+  GHashTable *cells;
+  gdouble     throughput;
+};
+
 
 struct _GimpChunkIterator
 {
   cairo_region_t *region;
   cairo_region_t *priority_region;
+  cairo_region_t *prefetch_region;
 
   GeglRectangle   tile_rect;
   GeglRectangle   priority_rect;
+  GeglRectangle   prefetch_rect;
 
   gdouble         interval;
 
+  GimpChunkCostModel *cost_model;
+
   cairo_region_t *current_region;
   GeglRectangle   current_rect;
 
@@ -75,6 +110,7 @@ struct _GimpChunkIterator
 
   gint64          last_time;
   gint            last_area;
+  GeglRectangle   last_rect;
 
   gdouble         target_area;
   gdouble         target_area_min;
@@ -86,12 +122,23 @@ struct _GimpChunkIterator
 
 /*  local function prototypes  */
 
+static gint64     gimp_chunk_cost_model_get_cell_index   (gint                 x,
+                                                          gint                 y);
+static gdouble    gimp_chunk_cost_model_get_throughput   (GimpChunkCostModel  *model,
+                                                          gint                 x,
+                                                          gint                 y);
+static void       gimp_chunk_cost_model_add_sample       (GimpChunkCostModel  *model,
+                                                          const GeglRectangle *rect,
+                                                          gdouble              throughput);
+
 static void       gimp_chunk_iterator_set_current_rect   (GimpChunkIterator   *iter,
                                                           const GeglRectangle *rect);
 static void       gimp_chunk_iterator_merge_current_rect (GimpChunkIterator   *iter);
 
 static void       gimp_chunk_iterator_merge              (GimpChunkIterator   *iter);
 
+static void       gimp_chunk_iterator_pick_rect          (GimpChunkIterator   *iter,
+                                                          GeglRectangle       *rect);
 static gboolean   gimp_chunk_iterator_prepare            (GimpChunkIterator   *iter);
 
 static void       gimp_chunk_iterator_set_target_area    (GimpChunkIterator   *iter,
@@ -104,8 +151,105 @@ static void       gimp_chunk_iterator_calc_rect          (GimpChunkIterator   *i
                                                           gboolean             readjust_height);
 
 
+/*  local variables  */
+
+/* the upper bounds of the chunk-time histogram bins, in microseconds */
+static const gint64 time_histogram_bounds[GIMP_CHUNK_ITERATOR_N_TIME_BINS - 1] =
+{
+  4000, 16000, 64000
+};
+
+static gint         time_histogram[GIMP_CHUNK_ITERATOR_N_TIME_BINS];
+
+
 /*  private functions  */
 
+static gint64
+gimp_chunk_cost_model_get_cell_index (gint x,
+                                      gint y)
+{
+  gint cell_x = floor ((gdouble) x / COST_MODEL_CELL_SIZE);
+  gint cell_y = floor ((gdouble) y / COST_MODEL_CELL_SIZE);
+
+  return ((gint64) cell_y << 32) | (guint32) cell_x;
+}
+
+static gdouble
+gimp_chunk_cost_model_get_throughput (GimpChunkCostModel *model,
+                                      gint                x,
+                                      gint                y)
+{
+  GimpChunkCostCell *cell;
+  gint64             index;
+
+  index = gimp_chunk_cost_model_get_cell_index (x, y);
+
+  cell = g_hash_table_lookup (model->cells, &index);
+
+  if (cell)
+    return cell->throughput;
+  else
+    return model->throughput;
+}
+
+static void
+gimp_chunk_cost_model_add_sample (GimpChunkCostModel  *model,
+                                  const GeglRectangle *rect,
+                                  gdouble              throughput)
+{
+  gint x, y;
+
+  if (model->throughput)
+    {
+      model->throughput += COST_MODEL_ALPHA *
+                           (throughput - model->throughput);
+    }
+  else
+    {
+      model->throughput = throughput;
+    }
+
+  for (y = rect->y;
+       y < rect->y + rect->height;
+       y = (floor ((gdouble) y / COST_MODEL_CELL_SIZE) + 1) *
+           COST_MODEL_CELL_SIZE)
+    {
+      for (x = rect->x;
+           x < rect->x + rect->width;
+           x = (floor ((gdouble) x / COST_MODEL_CELL_SIZE) + 1) *
+               COST_MODEL_CELL_SIZE)
+        {
+          GimpChunkCostCell *cell;
+          gint64             index;
+
+          index = gimp_chunk_cost_model_get_cell_index (x, y);
+
+          cell = g_hash_table_lookup (model->cells, &index);
+
+          if (cell)
+            {
+              cell->throughput += COST_MODEL_ALPHA *
+                                  (throughput - cell->throughput);
+            }
+          else
+            {
+              cell = g_slice_new (GimpChunkCostCell);
+
+              cell->index      = index;
+              cell->throughput = throughput;
+
+              g_hash_table_add (model->cells, cell);
+            }
+        }
+    }
+}
+
+static void
+gimp_chunk_cost_cell_free (GimpChunkCostCell *cell)
+{
+  g_slice_free (GimpChunkCostCell, cell);
+}
+
 static void
 gimp_chunk_iterator_set_current_rect (GimpChunkIterator   *iter,
                                       const GeglRectangle *rect)
@@ -164,17 +308,63 @@ gimp_chunk_iterator_merge (GimpChunkIterator *iter)
   /* merge the current rect back to the current region */
   gimp_chunk_iterator_merge_current_rect (iter);
 
-  /* merge the priority region back to the global region */
+  /* merge the priority and prefetch regions back to the global region */
   if (iter->priority_region)
     {
       cairo_region_union (iter->region, iter->priority_region);
+      cairo_region_union (iter->region, iter->prefetch_region);
 
       g_clear_pointer (&iter->priority_region, cairo_region_destroy);
+      g_clear_pointer (&iter->prefetch_region, cairo_region_destroy);
 
       iter->current_region = iter->region;
     }
 }
 
+static void
+gimp_chunk_iterator_pick_rect (GimpChunkIterator *iter,
+                               GeglRectangle     *rect)
+{
+  cairo_region_get_rectangle (iter->current_region, 0,
+                              (cairo_rectangle_int_t *) rect);
+
+  /* when we have a cost model, prefer the cheapest rectangle out of the
+   * first few rectangles of the region, so that as much of the region as
+   * possible is rendered early.
+   */
+  if (iter->cost_model && iter->cost_model->throughput)
+    {
+      gdouble max_throughput;
+      gint    n_rects;
+      gint    i;
+
+      max_throughput = gimp_chunk_cost_model_get_throughput (iter->cost_model,
+                                                             rect->x, rect->y);
+
+      n_rects = cairo_region_num_rectangles (iter->current_region);
+      n_rects = MIN (n_rects, MAX_RECT_CANDIDATES);
+
+      for (i = 1; i < n_rects; i++)
+        {
+          GeglRectangle candidate;
+          gdouble       throughput;
+
+          cairo_region_get_rectangle (iter->current_region, i,
+                                      (cairo_rectangle_int_t *) &candidate);
+
+          throughput = gimp_chunk_cost_model_get_throughput (iter->cost_model,
+                                                             candidate.x,
+                                                             candidate.y);
+
+          if (throughput > max_throughput)
+            {
+              *rect          = candidate;
+              max_throughput = throughput;
+            }
+        }
+    }
+}
+
 static gboolean
 gimp_chunk_iterator_prepare (GimpChunkIterator *iter)
 {
@@ -189,7 +379,8 @@ gimp_chunk_iterator_prepare (GimpChunkIterator *iter)
           GeglRectangle rect;
 
           if (! iter->priority_region &&
-              ! gegl_rectangle_is_empty (&iter->priority_rect))
+              (! gegl_rectangle_is_empty (&iter->priority_rect) ||
+               ! gegl_rectangle_is_empty (&iter->prefetch_rect)))
             {
               iter->priority_region = cairo_region_copy (iter->region);
 
@@ -200,16 +391,31 @@ gimp_chunk_iterator_prepare (GimpChunkIterator *iter)
               cairo_region_subtract_rectangle (
                 iter->region,
                 (const cairo_rectangle_int_t *) &iter->priority_rect);
+
+              iter->prefetch_region = cairo_region_copy (iter->region);
+
+              cairo_region_intersect_rectangle (
+                iter->prefetch_region,
+                (const cairo_rectangle_int_t *) &iter->prefetch_rect);
+
+              cairo_region_subtract_rectangle (
+                iter->region,
+                (const cairo_rectangle_int_t *) &iter->prefetch_rect);
             }
 
-          if (! iter->priority_region ||
-              cairo_region_is_empty (iter->priority_region))
+          if (iter->priority_region &&
+              ! cairo_region_is_empty (iter->priority_region))
             {
-              iter->current_region = iter->region;
+              iter->current_region = iter->priority_region;
+            }
+          else if (iter->prefetch_region &&
+                   ! cairo_region_is_empty (iter->prefetch_region))
+            {
+              iter->current_region = iter->prefetch_region;
             }
           else
             {
-              iter->current_region = iter->priority_region;
+              iter->current_region = iter->region;
             }
 
           if (cairo_region_is_empty (iter->current_region))
@@ -226,8 +432,7 @@ gimp_chunk_iterator_prepare (GimpChunkIterator *iter)
               return FALSE;
             }
 
-          cairo_region_get_rectangle (iter->current_region, 0,
-                                      (cairo_rectangle_int_t *) &rect);
+          gimp_chunk_iterator_pick_rect (iter, &rect);
 
           gimp_chunk_iterator_set_current_rect (iter, &rect);
         }
@@ -269,8 +474,35 @@ gimp_chunk_iterator_set_target_area (GimpChunkIterator *iter,
 static gdouble
 gimp_chunk_iterator_get_target_area (GimpChunkIterator *iter)
 {
-  if (iter->target_area)
-    return iter->target_area;
+  gdouble target_area = iter->target_area;
+
+  if (iter->cost_model && iter->cost_model->throughput)
+    {
+      gdouble throughput;
+
+      throughput = gimp_chunk_cost_model_get_throughput (iter->cost_model,
+                                                         iter->current_x,
+                                                         iter->current_y);
+
+      if (target_area)
+        {
+          /* scale the measured target area according to the relative cost of
+           * the current area
+           */
+          target_area *= CLAMP (throughput / iter->cost_model->throughput,
+                                COST_MODEL_MIN_RATIO, COST_MODEL_MAX_RATIO);
+        }
+      else
+        {
+          /* we don't have any measurements yet; estimate the target area
+           * using the cost model
+           */
+          target_area = throughput * iter->interval * G_TIME_SPAN_SECOND;
+        }
+    }
+
+  if (target_area)
+    return target_area;
   else
     return iter->tile_rect.width * iter->tile_rect.height;
 }
@@ -349,6 +581,40 @@ gimp_chunk_iterator_calc_rect (GimpChunkIterator *iter,
 
 /*  public functions  */
 
+GimpChunkCostModel *
+gimp_chunk_cost_model_new (void)
+{
+  GimpChunkCostModel *model;
+
+  model = g_slice_new0 (GimpChunkCostModel);
+
+  model->cells = g_hash_table_new_full (g_int64_hash, g_int64_equal,
+                                        (GDestroyNotify) gimp_chunk_cost_cell_free,
+                                        NULL);
+
+  return model;
+}
+
+void
+gimp_chunk_cost_model_free (GimpChunkCostModel *model)
+{
+  g_return_if_fail (model != NULL);
+
+  g_hash_table_unref (model->cells);
+
+  g_slice_free (GimpChunkCostModel, model);
+}
+
+void
+gimp_chunk_cost_model_reset (GimpChunkCostModel *model)
+{
+  g_return_if_fail (model != NULL);
+
+  g_hash_table_remove_all (model->cells);
+
+  model->throughput = 0.0;
+}
+
 GimpChunkIterator *
 gimp_chunk_iterator_new (cairo_region_t *region)
 {
@@ -382,6 +648,15 @@ gimp_chunk_iterator_set_tile_rect (GimpChunkIterator   *iter,
   iter->tile_rect = *rect;
 }
 
+void
+gimp_chunk_iterator_set_cost_model (GimpChunkIterator  *iter,
+                                    GimpChunkCostModel *model)
+{
+  g_return_if_fail (iter != NULL);
+
+  iter->cost_model = model;
+}
+
 void
 gimp_chunk_iterator_set_priority_rect (GimpChunkIterator   *iter,
                                        const GeglRectangle *rect)
@@ -401,6 +676,28 @@ gimp_chunk_iterator_set_priority_rect (GimpChunkIterator   *iter,
     }
 }
 
+/*  the prefetch rect is processed after the priority rect, and before the
+ *  rest of the region.
+ */
+void
+gimp_chunk_iterator_set_prefetch_rect (GimpChunkIterator   *iter,
+                                       const GeglRectangle *rect)
+{
+  const GeglRectangle empty_rect = {};
+
+  g_return_if_fail (iter != NULL);
+
+  if (! rect)
+    rect = &empty_rect;
+
+  if (! gegl_rectangle_equal (rect, &iter->prefetch_rect))
+    {
+      iter->prefetch_rect = *rect;
+
+      gimp_chunk_iterator_merge (iter);
+    }
+}
+
 void
 gimp_chunk_iterator_set_interval (GimpChunkIterator *iter,
                                   gdouble            interval)
@@ -460,6 +757,28 @@ gimp_chunk_iterator_get_rect (GimpChunkIterator *iter,
 
   time = g_get_monotonic_time ();
 
+  if (iter->last_area > 0)
+    {
+      gint64 chunk_time = time - iter->last_time;
+      gint   bin;
+
+      for (bin = 0; bin < GIMP_CHUNK_ITERATOR_N_TIME_BINS - 1; bin++)
+        {
+          if (chunk_time < time_histogram_bounds[bin])
+            break;
+        }
+
+      g_atomic_int_inc (&time_histogram[bin]);
+
+      if (iter->cost_model && chunk_time > 0)
+        {
+          gimp_chunk_cost_model_add_sample (iter->cost_model,
+                                            &iter->last_rect,
+                                            (gdouble) iter->last_area /
+                                            chunk_time);
+        }
+    }
+
   if (iter->last_area >= MIN_AREA_PER_ITERATION)
     {
       gdouble interval;
@@ -524,6 +843,7 @@ gimp_chunk_iterator_get_rect (GimpChunkIterator *iter,
 
   iter->last_time = time;
   iter->last_area = rect->width * rect->height;
+  iter->last_rect = *rect;
 
   return TRUE;
 }
@@ -548,8 +868,17 @@ gimp_chunk_iterator_stop (GimpChunkIterator *iter,
     }
 
   g_clear_pointer (&iter->priority_region, cairo_region_destroy);
+  g_clear_pointer (&iter->prefetch_region, cairo_region_destroy);
 
   g_slice_free (GimpChunkIterator, iter);
 
   return result;
 }
+
+gint
+gimp_chunk_iterator_get_time_histogram (gint bin)
+{
+  g_return_val_if_fail (bin >= 0 && bin < GIMP_CHUNK_ITERATOR_N_TIME_BINS, 0);
+
+  return g_atomic_int_get (&time_histogram[bin]);
+}
@@ -22,13 +22,26 @@
 #define __GIMP_CHUNK_ITEARTOR_H__
 
 
+#define GIMP_CHUNK_ITERATOR_N_TIME_BINS 4
+
+
+GimpChunkCostModel * gimp_chunk_cost_model_new            (void);
+void                 gimp_chunk_cost_model_free           (GimpChunkCostModel  *model);
+void                 gimp_chunk_cost_model_reset          (GimpChunkCostModel  *model);
+
+
 GimpChunkIterator * gimp_chunk_iterator_new               (cairo_region_t      *region);
 
+void                gimp_chunk_iterator_set_cost_model    (GimpChunkIterator   *iter,
+                                                           GimpChunkCostModel  *model);
+
 void                gimp_chunk_iterator_set_tile_rect     (GimpChunkIterator   *iter,
                                                            const GeglRectangle *rect);
 
 void                gimp_chunk_iterator_set_priority_rect (GimpChunkIterator   *iter,
                                                            const GeglRectangle *rect);
+void                gimp_chunk_iterator_set_prefetch_rect (GimpChunkIterator   *iter,
+                                                           const GeglRectangle *rect);
 
 void                gimp_chunk_iterator_set_interval      (GimpChunkIterator   *iter,
                                                            gdouble              interval);
@@ -40,5 +53,7 @@ gboolean            gimp_chunk_iterator_get_rect          (GimpChunkIterator   *
 cairo_region_t    * gimp_chunk_iterator_stop              (GimpChunkIterator   *iter,
                                                            gboolean             free_region);
 
+gint                gimp_chunk_iterator_get_time_histogram (gint                bin);
+
 
 #endif  /*  __GIMP_CHUNK_ITEARTOR_H__  */
@@ -0,0 +1,265 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995-1999 Spencer Kimball and Peter Mattis
+ *
+ * gimpcolorindex.c
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <gio/gio.h>
+
+#include "core-types.h"
+
+#include "gimpcolorindex.h"
+
+
+/*  a k-d tree over the colors of a palette, answering nearest-color
+ *  queries under a weighted euclidean distance.  the tree is stored in an
+ *  array: the node of the range [start, end) is at its middle, and its
+ *  children are the ranges to either side of it.
+ *
+ *  lookups only read the index, so it can be shared among threads.
+ */
+
+
+typedef struct
+{
+  gint c[3];   /*  the color, multiplied by the weights  */
+  gint index;  /*  its index in the palette             */
+  gint axis;   /*  the axis its subtree is split along  */
+} Node;
+
+struct _GimpColorIndex
+{
+  gint  weights[3];
+  gint  n_nodes;
+  Node *nodes;
+};
+
+
+/*  local function prototypes  */
+
+static gint   node_compare (const Node *node1,
+                            const Node *node2,
+                            gpointer    axis);
+static void   build        (Node       *nodes,
+                            gint        n_nodes);
+static void   search       (const Node *nodes,
+                            gint        n_nodes,
+                            const gint *c,
+                            gint       *best_dist,
+                            gint       *best_index);
+
+
+/*  public functions  */
+
+/*  colors holds n_colors triples, and weights one weight per component.
+ *  the weighted components, and the squared distances between them, must
+ *  fit in a gint.
+ */
+GimpColorIndex *
+gimp_color_index_new (const gint *colors,
+                      gint        n_colors,
+                      const gint *weights)
+{
+  GimpColorIndex *index;
+  gint            i;
+
+  g_return_val_if_fail (colors != NULL || n_colors == 0, NULL);
+  g_return_val_if_fail (n_colors >= 0, NULL);
+  g_return_val_if_fail (weights != NULL, NULL);
+
+  index = g_slice_new (GimpColorIndex);
+
+  index->weights[0] = weights[0];
+  index->weights[1] = weights[1];
+  index->weights[2] = weights[2];
+
+  index->n_nodes = n_colors;
+  index->nodes   = g_new (Node, n_colors);
+
+  for (i = 0; i < n_colors; i++)
+    {
+      index->nodes[i].c[0]  = colors[3 * i + 0] * weights[0];
+      index->nodes[i].c[1]  = colors[3 * i + 1] * weights[1];
+      index->nodes[i].c[2]  = colors[3 * i + 2] * weights[2];
+      index->nodes[i].index = i;
+    }
+
+  build (index->nodes, index->n_nodes);
+
+  return index;
+}
+
+void
+gimp_color_index_free (GimpColorIndex *index)
+{
+  g_return_if_fail (index != NULL);
+
+  g_free (index->nodes);
+
+  g_slice_free (GimpColorIndex, index);
+}
+
+/*  returns the palette index of the color closest to (c0, c1, c2), and,
+ *  among several equally close ones, the lowest one.  returns 0 for an
+ *  empty palette.
+ */
+gint
+gimp_color_index_lookup (const GimpColorIndex *index,
+                         gint                  c0,
+                         gint                  c1,
+                         gint                  c2)
+{
+  gint c[3];
+  gint best_dist  = G_MAXINT;
+  gint best_index = 0;
+
+  g_return_val_if_fail (index != NULL, 0);
+
+  c[0] = c0 * index->weights[0];
+  c[1] = c1 * index->weights[1];
+  c[2] = c2 * index->weights[2];
+
+  search (index->nodes, index->n_nodes, c, &best_dist, &best_index);
+
+  return best_index;
+}
+
+
+/*  private functions  */
+
+static gint
+node_compare (const Node *node1,
+              const Node *node2,
+              gpointer    axis)
+{
+  gint a = GPOINTER_TO_INT (axis);
+
+  if (node1->c[a] != node2->c[a])
+    return node1->c[a] < node2->c[a] ? -1 : 1;
+
+  return node1->index - node2->index;
+}
+
+static void
+build (Node *nodes,
+       gint  n_nodes)
+{
+  gint min[3];
+  gint max[3];
+  gint axis;
+  gint mid;
+  gint i;
+
+  if (n_nodes == 0)
+    return;
+
+  /*  split along the axis of the largest spread  */
+  for (axis = 0; axis < 3; axis++)
+    {
+      min[axis] = G_MAXINT;
+      max[axis] = G_MININT;
+    }
+
+  for (i = 0; i < n_nodes; i++)
+    {
+      for (axis = 0; axis < 3; axis++)
+        {
+          min[axis] = MIN (min[axis], nodes[i].c[axis]);
+          max[axis] = MAX (max[axis], nodes[i].c[axis]);
+        }
+    }
+
+  axis = 0;
+
+  if (max[1] - min[1] > max[axis] - min[axis])
+    axis = 1;
+  if (max[2] - min[2] > max[axis] - min[axis])
+    axis = 2;
+
+  g_qsort_with_data (nodes, n_nodes, sizeof (Node),
+                     (GCompareDataFunc) node_compare,
+                     GINT_TO_POINTER (axis));
+
+  mid = n_nodes / 2;
+
+  nodes[mid].axis = axis;
+
+  build (nodes,           mid);
+  build (nodes + mid + 1, n_nodes - mid - 1);
+}
+
+static void
+search (const Node *nodes,
+        gint        n_nodes,
+        const gint *c,
+        gint       *best_dist,
+        gint       *best_index)
+{
+  const Node *node;
+  const Node *near_nodes;
+  const Node *far_nodes;
+  gint        n_near_nodes;
+  gint        n_far_nodes;
+  gint        mid;
+  gint        d0, d1, d2;
+  gint        dist;
+  gint        diff;
+
+  if (n_nodes == 0)
+    return;
+
+  mid  = n_nodes / 2;
+  node = &nodes[mid];
+
+  d0   = c[0] - node->c[0];
+  d1   = c[1] - node->c[1];
+  d2   = c[2] - node->c[2];
+  dist = d0 * d0 + d1 * d1 + d2 * d2;
+
+  if (dist < *best_dist ||
+      (dist == *best_dist && node->index < *best_index))
+    {
+      *best_dist  = dist;
+      *best_index = node->index;
+    }
+
+  diff = c[node->axis] - node->c[node->axis];
+
+  if (diff < 0)
+    {
+      near_nodes   = nodes;
+      n_near_nodes = mid;
+      far_nodes    = nodes + mid + 1;
+      n_far_nodes  = n_nodes - mid - 1;
+    }
+  else
+    {
+      near_nodes   = nodes + mid + 1;
+      n_near_nodes = n_nodes - mid - 1;
+      far_nodes    = nodes;
+      n_far_nodes  = mid;
+    }
+
+  search (near_nodes, n_near_nodes, c, best_dist, best_index);
+
+  /*  the far side can only hold a color at least as close as the best one
+   *  so far if the splitting plane is no farther away than it
+   */
+  if (diff * diff <= *best_dist)
+    search (far_nodes, n_far_nodes, c, best_dist, best_index);
+}
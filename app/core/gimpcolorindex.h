@@ -0,0 +1,35 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995-1999 Spencer Kimball and Peter Mattis
+ *
+ * gimpcolorindex.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GIMP_COLOR_INDEX_H__
+#define __GIMP_COLOR_INDEX_H__
+
+
+GimpColorIndex * gimp_color_index_new    (const gint           *colors,
+                                          gint                  n_colors,
+                                          const gint           *weights);
+void             gimp_color_index_free   (GimpColorIndex       *index);
+
+gint             gimp_color_index_lookup (const GimpColorIndex *index,
+                                          gint                  c0,
+                                          gint                  c1,
+                                          gint                  c2);
+
+
+#endif  /*  __GIMP_COLOR_INDEX_H__  */
@@ -31,6 +31,7 @@
 #include "core-types.h"
 
 #include "gimp.h"
+#include "gimp-trace.h"
 #include "gimp-utils.h"
 #include "gimpasyncset.h"
 #include "gimpcancelable.h"
@@ -493,6 +494,8 @@ gimp_data_factory_data_init (GimpDataFactory *factory,
    *  even if no_data, the thaw() will implicitly make GimpContext
    *  create the standard data that serves as fallback.
    */
+  gimp_trace_begin_intern ("startup", gimp_object_get_name (factory));
+
   gimp_container_freeze (priv->container);
 
   if (! no_data)
@@ -509,6 +512,8 @@ gimp_data_factory_data_init (GimpDataFactory *factory,
 
   gimp_container_thaw (priv->container);
 
+  gimp_trace_end ();
+
   signal_name = g_strdup_printf ("notify::%s", priv->path_property_name);
   g_signal_connect_object (priv->gimp->config, signal_name,
                            G_CALLBACK (gimp_data_factory_path_notify),
@@ -30,6 +30,7 @@
 #include "core-types.h"
 
 #include "gimp.h"
+#include "gimp-parallel.h"
 #include "gimp-utils.h"
 #include "gimpcontainer.h"
 #include "gimpdata.h"
@@ -55,10 +56,35 @@ struct _GimpDataLoader
 };
 
 
+/*  a file found in the data path: it is decoded by load_items(), possibly
+ *  on another thread, and its data objects are then added to the
+ *  factory by add_data(), on the main thread
+ */
+typedef struct
+{
+  GimpDataLoader *loader;
+  GFile          *file;
+  GFile          *top_directory;
+  guint64         mtime;
+  gboolean        dir_writable;
+  GList          *cached_data;
+  GList          *data_list;
+  GError         *error;
+} GimpDataLoaderItem;
+
+typedef struct
+{
+  GimpContext *context;
+  GArray      *items;
+  gint         next;
+} GimpDataLoaderLoad;
+
+
 struct _GimpDataLoaderFactoryPrivate
 {
   GList          *loaders;
   GimpDataLoader *fallback;
+  gboolean        parallel;
 };
 
 #define GET_PRIVATE(obj) (((GimpDataLoaderFactory *) (obj))->priv)
@@ -79,18 +105,23 @@ static void   gimp_data_loader_factory_load           (GimpDataFactory *factory,
                                                        GimpContext     *context,
                                                        GHashTable      *cache);
 static void   gimp_data_loader_factory_load_directory (GimpDataFactory *factory,
-                                                       GimpContext     *context,
                                                        GHashTable      *cache,
+                                                       GArray          *items,
                                                        gboolean         dir_writable,
                                                        GFile           *directory,
                                                        GFile           *top_directory);
-static void   gimp_data_loader_factory_load_data      (GimpDataFactory *factory,
-                                                       GimpContext     *context,
+static void   gimp_data_loader_factory_add_item       (GimpDataFactory *factory,
                                                        GHashTable      *cache,
+                                                       GArray          *items,
                                                        gboolean         dir_writable,
                                                        GFile           *file,
                                                        GFileInfo       *info,
                                                        GFile           *top_directory);
+static void   gimp_data_loader_factory_load_items     (gint             i,
+                                                       gint             n,
+                                                       gpointer         data);
+static void   gimp_data_loader_factory_add_data       (GimpDataFactory *factory,
+                                                       GimpDataLoaderItem *item);
 
 static GimpDataLoader * gimp_data_loader_new          (const gchar     *name,
                                                        GimpDataLoadFunc load_func,
@@ -289,6 +320,15 @@ gimp_data_loader_factory_add_fallback (GimpDataFactory  *factory,
   priv->fallback = gimp_data_loader_new (name, load_func, NULL, FALSE);
 }
 
+void
+gimp_data_loader_factory_set_parallel (GimpDataFactory *factory,
+                                       gboolean         parallel)
+{
+  g_return_if_fail (GIMP_IS_DATA_LOADER_FACTORY (factory));
+
+  GET_PRIVATE (factory)->parallel = parallel ? TRUE : FALSE;
+}
+
 
 /*  private functions  */
 
@@ -315,15 +355,22 @@ gimp_data_loader_factory_load (GimpDataFactory *factory,
                                GimpContext     *context,
                                GHashTable      *cache)
 {
-  const GList *ext_path;
-  GList       *path;
-  GList       *writable_path;
-  GList       *list;
+  GimpDataLoaderFactoryPrivate *priv = GET_PRIVATE (factory);
+  GimpDataLoaderLoad            load;
+  const GList                  *ext_path;
+  GList                        *path;
+  GList                        *writable_path;
+  GList                        *list;
+  guint                         i;
 
   path          = gimp_data_factory_get_data_path          (factory);
   writable_path = gimp_data_factory_get_data_path_writable (factory);
   ext_path      = gimp_data_factory_get_data_path_ext      (factory);
 
+  load.context = context;
+  load.items   = g_array_new (FALSE, TRUE, sizeof (GimpDataLoaderItem));
+  load.next    = 0;
+
   for (list = (GList *) ext_path; list; list = g_list_next (list))
     {
       /* Adding data from extensions.
@@ -331,7 +378,7 @@ gimp_data_loader_factory_load (GimpDataFactory *factory,
        * writable, since writability of extension is only taken into
        * account for extension update).
        */
-      gimp_data_loader_factory_load_directory (factory, context, cache,
+      gimp_data_loader_factory_load_directory (factory, cache, load.items,
                                                FALSE,
                                                list->data,
                                                list->data);
@@ -345,20 +392,47 @@ gimp_data_loader_factory_load (GimpDataFactory *factory,
                               (GCompareFunc) gimp_file_compare))
         dir_writable = TRUE;
 
-      gimp_data_loader_factory_load_directory (factory, context, cache,
+      gimp_data_loader_factory_load_directory (factory, cache, load.items,
                                                dir_writable,
                                                list->data,
                                                list->data);
     }
 
+  /*  decode the files, in parallel if the loaders allow it.  the data
+   *  objects are added to the containers afterwards, in the order the
+   *  files were found, so the result doesn't depend on the scheduling
+   */
+  if (priv->parallel && load.items->len > 1)
+    {
+      gimp_parallel_distribute (load.items->len,
+                                gimp_data_loader_factory_load_items,
+                                &load);
+    }
+  else
+    {
+      gimp_data_loader_factory_load_items (0, 1, &load);
+    }
+
+  for (i = 0; i < load.items->len; i++)
+    {
+      GimpDataLoaderItem *item = &g_array_index (load.items,
+                                                 GimpDataLoaderItem, i);
+
+      gimp_data_loader_factory_add_data (factory, item);
+
+      g_object_unref (item->file);
+    }
+
+  g_array_free (load.items, TRUE);
+
   g_list_free_full (path,          (GDestroyNotify) g_object_unref);
   g_list_free_full (writable_path, (GDestroyNotify) g_object_unref);
 }
 
 static void
 gimp_data_loader_factory_load_directory (GimpDataFactory *factory,
-                                         GimpContext     *context,
                                          GHashTable      *cache,
+                                         GArray          *items,
                                          gboolean         dir_writable,
                                          GFile           *directory,
                                          GFile           *top_directory)
@@ -393,17 +467,17 @@ gimp_data_loader_factory_load_directory (GimpDataFactory *factory,
 
           if (file_type == G_FILE_TYPE_DIRECTORY)
             {
-              gimp_data_loader_factory_load_directory (factory, context, cache,
+              gimp_data_loader_factory_load_directory (factory, cache, items,
                                                        dir_writable,
                                                        child,
                                                        top_directory);
             }
           else if (file_type == G_FILE_TYPE_REGULAR)
             {
-              gimp_data_loader_factory_load_data (factory, context, cache,
-                                                  dir_writable,
-                                                  child, info,
-                                                  top_directory);
+              gimp_data_loader_factory_add_item (factory, cache, items,
+                                                 dir_writable,
+                                                 child, info,
+                                                 top_directory);
             }
 
           g_object_unref (child);
@@ -415,35 +489,31 @@ gimp_data_loader_factory_load_directory (GimpDataFactory *factory,
 }
 
 static void
-gimp_data_loader_factory_load_data (GimpDataFactory *factory,
-                                    GimpContext     *context,
-                                    GHashTable      *cache,
-                                    gboolean         dir_writable,
-                                    GFile           *file,
-                                    GFileInfo       *info,
-                                    GFile           *top_directory)
+gimp_data_loader_factory_add_item (GimpDataFactory *factory,
+                                   GHashTable      *cache,
+                                   GArray          *items,
+                                   gboolean         dir_writable,
+                                   GFile           *file,
+                                   GFileInfo       *info,
+                                   GFile           *top_directory)
 {
-  GimpDataLoader *loader;
-  GimpContainer  *container;
-  GimpContainer  *container_obsolete;
-  GList          *data_list = NULL;
-  GInputStream   *input;
-  guint64         mtime;
-  GError         *error = NULL;
+  GimpDataLoader     *loader;
+  GimpDataLoaderItem  item = { 0, };
 
   loader = gimp_data_loader_factory_get_loader (factory, file);
 
   if (! loader)
     return;
 
-  container          = gimp_data_factory_get_container          (factory);
-  container_obsolete = gimp_data_factory_get_container_obsolete (factory);
-
   if (gimp_data_factory_get_gimp (factory)->be_verbose)
     g_print ("  Loading %s\n", gimp_file_get_utf8_name (file));
 
-  mtime = g_file_info_get_attribute_uint64 (info,
-                                            G_FILE_ATTRIBUTE_TIME_MODIFIED);
+  item.loader        = loader;
+  item.file          = g_object_ref (file);
+  item.top_directory = top_directory;
+  item.dir_writable  = dir_writable;
+  item.mtime         = g_file_info_get_attribute_uint64 (info,
+                                                         G_FILE_ATTRIBUTE_TIME_MODIFIED);
 
   if (cache)
     {
@@ -451,49 +521,90 @@ gimp_data_loader_factory_load_data (GimpDataFactory *factory,
 
       if (cached_data &&
           gimp_data_get_mtime (cached_data->data) != 0 &&
-          gimp_data_get_mtime (cached_data->data) == mtime)
+          gimp_data_get_mtime (cached_data->data) == item.mtime)
         {
-          GList *list;
-
-          for (list = cached_data; list; list = g_list_next (list))
-            gimp_container_add (container, list->data);
-
-          return;
+          item.cached_data = cached_data;
         }
     }
 
-  input = G_INPUT_STREAM (g_file_read (file, NULL, &error));
+  g_array_append_val (items, item);
+}
+
+static void
+gimp_data_loader_factory_load_items (gint     i,
+                                     gint     n,
+                                     gpointer data)
+{
+  GimpDataLoaderLoad *load    = data;
+  gint                n_items = load->items->len;
+  gint                index;
 
-  if (input)
+  /*  files differ a lot in size, so hand them out one at a time  */
+  while ((index = g_atomic_int_add (&load->next, 1)) < n_items)
     {
-      GInputStream *buffered = g_buffered_input_stream_new (input);
+      GimpDataLoaderItem *item = &g_array_index (load->items,
+                                                 GimpDataLoaderItem, index);
+      GInputStream       *input;
+
+      if (item->cached_data)
+        continue;
 
-      data_list = loader->load_func (context, file, buffered, &error);
+      input = G_INPUT_STREAM (g_file_read (item->file, NULL, &item->error));
 
-      if (error)
+      if (input)
         {
-          g_prefix_error (&error,
-                          _("Error loading '%s': "),
-                          gimp_file_get_utf8_name (file));
+          GInputStream *buffered = g_buffered_input_stream_new (input);
+
+          item->data_list = item->loader->load_func (load->context,
+                                                     item->file, buffered,
+                                                     &item->error);
+
+          if (item->error)
+            {
+              g_prefix_error (&item->error,
+                              _("Error loading '%s': "),
+                              gimp_file_get_utf8_name (item->file));
+            }
+          else if (! item->data_list)
+            {
+              g_set_error (&item->error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
+                           _("Error loading '%s'"),
+                           gimp_file_get_utf8_name (item->file));
+            }
+
+          g_object_unref (buffered);
+          g_object_unref (input);
         }
-      else if (! data_list)
+      else
         {
-          g_set_error (&error, GIMP_DATA_ERROR, GIMP_DATA_ERROR_READ,
-                       _("Error loading '%s'"),
-                       gimp_file_get_utf8_name (file));
+          g_prefix_error (&item->error,
+                          _("Could not open '%s' for reading: "),
+                          gimp_file_get_utf8_name (item->file));
         }
-
-      g_object_unref (buffered);
-      g_object_unref (input);
     }
-  else
+}
+
+static void
+gimp_data_loader_factory_add_data (GimpDataFactory    *factory,
+                                   GimpDataLoaderItem *item)
+{
+  GimpContainer *container;
+  GimpContainer *container_obsolete;
+
+  container          = gimp_data_factory_get_container          (factory);
+  container_obsolete = gimp_data_factory_get_container_obsolete (factory);
+
+  if (item->cached_data)
     {
-      g_prefix_error (&error,
-                      _("Could not open '%s' for reading: "),
-                      gimp_file_get_utf8_name (file));
+      GList *list;
+
+      for (list = item->cached_data; list; list = g_list_next (list))
+        gimp_container_add (container, list->data);
+
+      return;
     }
 
-  if (G_LIKELY (data_list))
+  if (G_LIKELY (item->data_list))
     {
       GList    *list;
       gchar    *uri;
@@ -501,7 +612,7 @@ gimp_data_loader_factory_load_data (GimpDataFactory *factory,
       gboolean  writable  = FALSE;
       gboolean  deletable = FALSE;
 
-      uri = g_file_get_uri (file);
+      uri = g_file_get_uri (item->file);
 
       obsolete = (strstr (uri, GIMP_OBSOLETE_DATA_DIR_NAME) != 0);
 
@@ -510,16 +621,17 @@ gimp_data_loader_factory_load_data (GimpDataFactory *factory,
       /* obsolete files are immutable, don't check their writability */
       if (! obsolete)
         {
-          deletable = (g_list_length (data_list) == 1 && dir_writable);
-          writable  = (deletable && loader->writable);
+          deletable = (g_list_length (item->data_list) == 1 &&
+                       item->dir_writable);
+          writable  = (deletable && item->loader->writable);
         }
 
-      for (list = data_list; list; list = g_list_next (list))
+      for (list = item->data_list; list; list = g_list_next (list))
         {
           GimpData *data = list->data;
 
-          gimp_data_set_file (data, file, writable, deletable);
-          gimp_data_set_mtime (data, mtime);
+          gimp_data_set_file (data, item->file, writable, deletable);
+          gimp_data_set_mtime (data, item->mtime);
           gimp_data_clean (data);
 
           if (obsolete)
@@ -529,7 +641,7 @@ gimp_data_loader_factory_load_data (GimpDataFactory *factory,
             }
           else
             {
-              gimp_data_set_folder_tags (data, top_directory);
+              gimp_data_set_folder_tags (data, item->top_directory);
 
               gimp_container_add (container,
                                   GIMP_OBJECT (data));
@@ -538,19 +650,19 @@ gimp_data_loader_factory_load_data (GimpDataFactory *factory,
           g_object_unref (data);
         }
 
-      g_list_free (data_list);
+      g_list_free (item->data_list);
     }
 
   /*  not else { ... } because loader->load_func() can return a list
    *  of data objects *and* an error message if loading failed after
    *  something was already loaded
    */
-  if (G_UNLIKELY (error))
+  if (G_UNLIKELY (item->error))
     {
       gimp_message (gimp_data_factory_get_gimp (factory), NULL,
                     GIMP_MESSAGE_ERROR,
-                    _("Failed to load data:\n\n%s"), error->message);
-      g_clear_error (&error);
+                    _("Failed to load data:\n\n%s"), item->error->message);
+      g_clear_error (&item->error);
     }
 }
 
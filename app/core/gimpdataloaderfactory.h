@@ -73,6 +73,8 @@ void              gimp_data_loader_factory_add_loader   (GimpDataFactory
 void              gimp_data_loader_factory_add_fallback (GimpDataFactory         *factory,
                                                          const gchar             *name,
                                                          GimpDataLoadFunc         load_func);
+void              gimp_data_loader_factory_set_parallel (GimpDataFactory         *factory,
+                                                         gboolean                 parallel);
 
 
 #endif  /*  __GIMP_DATA_LOADER_FACTORY_H__  */
@@ -28,6 +28,7 @@
 #include "gegl/gimp-babl.h"
 #include "gegl/gimp-gegl-apply-operation.h"
 #include "gegl/gimp-gegl-loops.h"
+#include "gegl/gimp-gegl-tile-share.h"
 #include "gegl/gimp-gegl-utils.h"
 
 #include "operations/layer-modes/gimp-layer-modes.h"
@@ -106,7 +107,22 @@ gimp_drawable_fill_buffer (GimpDrawable  *drawable,
 
       if (gimp_color_transform_can_gegl_copy (src_profile, dest_profile))
         {
-          dest_buffer = g_object_ref (src_buffer);
+          /*  convert the pattern to the buffer's format once, instead of
+           *  letting gegl_buffer_set_pattern() convert every repetition
+           */
+          if (gegl_buffer_get_format (src_buffer) !=
+              gegl_buffer_get_format (buffer))
+            {
+              dest_buffer = gegl_buffer_new (gegl_buffer_get_extent (src_buffer),
+                                             gegl_buffer_get_format (buffer));
+
+              gimp_gegl_buffer_copy (src_buffer,  NULL, GEGL_ABYSS_NONE,
+                                     dest_buffer, NULL);
+            }
+          else
+            {
+              dest_buffer = g_object_ref (src_buffer);
+            }
         }
       else
         {
@@ -142,7 +158,7 @@ gimp_drawable_fill_buffer (GimpDrawable  *drawable,
 
       gegl_color = gimp_gegl_color_new (&image_color,
                                         gimp_drawable_get_space (drawable));
-      gegl_buffer_set_color (buffer, NULL, gegl_color);
+      gimp_gegl_buffer_set_constant_color (buffer, NULL, gegl_color);
       g_object_unref (gegl_color);
     }
 }
@@ -28,6 +28,7 @@
 #include "gegl/gimpapplicator.h"
 #include "gegl/gimp-gegl-apply-operation.h"
 #include "gegl/gimp-gegl-loops.h"
+#include "gegl/gimp-gegl-tile-share.h"
 
 #include "gimp.h"
 #include "gimp-utils.h"
@@ -252,6 +253,13 @@ gimp_drawable_merge_filter (GimpDrawable *drawable,
             }
           else
             {
+              /*  the filter rewrote all of rect, let the tiles it left
+               *  unchanged share the undo buffer's again
+               */
+              gimp_gegl_buffer_share_unchanged_tiles (
+                gimp_drawable_get_buffer (drawable), &undo_rect,
+                undo_buffer, 0, 0);
+
               gimp_drawable_push_undo (drawable, undo_desc, undo_buffer,
                                        undo_rect.x, undo_rect.y,
                                        undo_rect.width, undo_rect.height);
@@ -17,6 +17,8 @@
 
 #include "config.h"
 
+#include <math.h>
+
 #include <gio/gio.h>
 #include <gegl.h>
 #include <gdk-pixbuf/gdk-pixbuf.h>
@@ -27,6 +29,8 @@
 
 #include "gegl/gimp-gegl-utils.h"
 
+#include "gimp-parallel.h"
+#include "gimpasync.h"
 #include "gimpchannel.h"
 #include "gimpdrawable.h"
 #include "gimpdrawable-foreground-extract.h"
@@ -36,8 +40,65 @@
 #include "gimp-intl.h"
 
 
+/*  the matting engines only look at the known pixels bordering the unknown
+ *  ones, and levin matting at some more on its coarser levels, so we only
+ *  feed them the bounding box of the unknown pixels, grown by this many
+ *  pixels, instead of the whole drawable.
+ */
+#define GLOBAL_MARGIN 2
+#define LEVIN_MARGIN  4
+
+
+typedef struct
+{
+  GeglBuffer        *buffer;
+  gint               off_x;
+  gint               off_y;
+  GimpMattingEngine  engine;
+  gint               global_iterations;
+  gint               levin_levels;
+  gint               levin_active_levels;
+  GeglBuffer        *trimap;
+  gdouble            scale;
+} ForegroundExtractData;
+
+
+/*  local function prototypes  */
+
+static ForegroundExtractData *
+                  foreground_extract_data_new       (GimpDrawable          *drawable,
+                                                     GimpMattingEngine      engine,
+                                                     gint                   global_iterations,
+                                                     gint                   levin_levels,
+                                                     gint                   levin_active_levels,
+                                                     GeglBuffer            *trimap,
+                                                     gdouble                scale,
+                                                     gboolean               dup);
+static void       foreground_extract_data_free      (ForegroundExtractData *data);
+
+static GeglBuffer * foreground_extract              (ForegroundExtractData *data,
+                                                     GimpProgress          *progress,
+                                                     GimpAsync             *async);
+static void       foreground_extract_async_func     (GimpAsync             *async,
+                                                     ForegroundExtractData *data);
+
+static gboolean   foreground_extract_unknown_bounds (GeglBuffer            *trimap,
+                                                     const GeglRectangle   *rect,
+                                                     GeglRectangle         *bounds);
+static void       foreground_extract_merge          (GeglBuffer            *buffer,
+                                                     GeglBuffer            *trimap,
+                                                     GeglBuffer            *matte,
+                                                     const GeglRectangle   *rect,
+                                                     gint                   off_x,
+                                                     gint                   off_y);
+
+
 /*  public functions  */
 
+/*  with a scale of less than 1.0, the matting is done on the drawable and
+ *  trimap scaled down by it, and the resulting alpha of the unknown pixels
+ *  is scaled back up, which is good enough for a preview.
+ */
 GeglBuffer *
 gimp_drawable_foreground_extract (GimpDrawable      *drawable,
                                   GimpMattingEngine  engine,
@@ -45,87 +106,265 @@ gimp_drawable_foreground_extract (GimpDrawable      *drawable,
                                   gint               levin_levels,
                                   gint               levin_active_levels,
                                   GeglBuffer        *trimap,
+                                  gdouble            scale,
                                   GimpProgress      *progress)
 {
-  GeglBuffer    *drawable_buffer;
+  ForegroundExtractData *data;
+  GeglBuffer            *buffer;
+
+  g_return_val_if_fail (GIMP_IS_DRAWABLE (drawable), NULL);
+  g_return_val_if_fail (GEGL_IS_BUFFER (trimap), NULL);
+  g_return_val_if_fail (scale > 0.0 && scale <= 1.0, NULL);
+  g_return_val_if_fail (progress == NULL || GIMP_IS_PROGRESS (progress), NULL);
+
+  data = foreground_extract_data_new (drawable, engine,
+                                      global_iterations,
+                                      levin_levels, levin_active_levels,
+                                      trimap, scale, FALSE);
+
+  buffer = foreground_extract (data, progress, NULL);
+
+  foreground_extract_data_free (data);
+
+  return buffer;
+}
+
+/*  like gimp_drawable_foreground_extract(), but works on copies of the
+ *  drawable's buffer and of the trimap in another thread, so both may be
+ *  changed while it runs.  the async's result is the mask.
+ */
+GimpAsync *
+gimp_drawable_foreground_extract_async (GimpDrawable      *drawable,
+                                        GimpMattingEngine  engine,
+                                        gint               global_iterations,
+                                        gint               levin_levels,
+                                        gint               levin_active_levels,
+                                        GeglBuffer        *trimap,
+                                        gdouble            scale)
+{
+  ForegroundExtractData *data;
+
+  g_return_val_if_fail (GIMP_IS_DRAWABLE (drawable), NULL);
+  g_return_val_if_fail (GEGL_IS_BUFFER (trimap), NULL);
+  g_return_val_if_fail (scale > 0.0 && scale <= 1.0, NULL);
+
+  data = foreground_extract_data_new (drawable, engine,
+                                      global_iterations,
+                                      levin_levels, levin_active_levels,
+                                      trimap, scale, TRUE);
+
+  return gimp_parallel_run_async_full (
+    +1,
+    (GimpRunAsyncFunc) foreground_extract_async_func,
+    data, (GDestroyNotify) foreground_extract_data_free);
+}
+
+
+/*  private functions  */
+
+static ForegroundExtractData *
+foreground_extract_data_new (GimpDrawable      *drawable,
+                             GimpMattingEngine  engine,
+                             gint               global_iterations,
+                             gint               levin_levels,
+                             gint               levin_active_levels,
+                             GeglBuffer        *trimap,
+                             gdouble            scale,
+                             gboolean           dup)
+{
+  ForegroundExtractData *data = g_slice_new0 (ForegroundExtractData);
+
+  if (dup)
+    {
+      data->buffer = gimp_gegl_buffer_dup (gimp_drawable_get_buffer (drawable));
+      data->trimap = gimp_gegl_buffer_dup (trimap);
+    }
+  else
+    {
+      data->buffer = g_object_ref (gimp_drawable_get_buffer (drawable));
+      data->trimap = g_object_ref (trimap);
+    }
+
+  gimp_item_get_offset (GIMP_ITEM (drawable), &data->off_x, &data->off_y);
+
+  data->engine              = engine;
+  data->global_iterations   = global_iterations;
+  data->levin_levels        = levin_levels;
+  data->levin_active_levels = levin_active_levels;
+  data->scale               = scale;
+
+  return data;
+}
+
+static void
+foreground_extract_data_free (ForegroundExtractData *data)
+{
+  g_object_unref (data->buffer);
+  g_object_unref (data->trimap);
+
+  g_slice_free (ForegroundExtractData, data);
+}
+
+static GeglBuffer *
+foreground_extract (ForegroundExtractData *data,
+                    GimpProgress          *progress,
+                    GimpAsync             *async)
+{
   GeglNode      *gegl;
   GeglNode      *input_node;
+  GeglNode      *input_crop;
   GeglNode      *trimap_node;
+  GeglNode      *trimap_crop;
   GeglNode      *matting_node;
   GeglNode      *output_node;
   GeglBuffer    *buffer;
+  GeglBuffer    *matte = NULL;
   GeglProcessor *processor;
+  GeglRectangle  rect;
+  GeglRectangle  unknown;
+  GeglRectangle  area;
   gdouble        value;
-  gint           off_x, off_y;
+  gint           margin;
+  gboolean       canceled = FALSE;
 
-  g_return_val_if_fail (GIMP_IS_DRAWABLE (drawable), NULL);
-  g_return_val_if_fail (GEGL_IS_BUFFER (trimap), NULL);
-  g_return_val_if_fail (progress == NULL || GIMP_IS_PROGRESS (progress), NULL);
+  rect = *gegl_buffer_get_extent (data->buffer);
+  rect.x += data->off_x;
+  rect.y += data->off_y;
 
-  progress = gimp_progress_start (progress, FALSE,
-                                  _("Computing alpha of unknown pixels"));
+  /*  the known pixels are taken from the trimap as they are  */
+  buffer = gegl_buffer_new (&rect, babl_format ("Y float"));
 
-  drawable_buffer = gimp_drawable_get_buffer (drawable);
+  gegl_buffer_copy (data->trimap, &rect, GEGL_ABYSS_NONE, buffer, &rect);
+
+  if (! foreground_extract_unknown_bounds (data->trimap, &rect, &unknown))
+    return buffer;
+
+  if (progress)
+    progress = gimp_progress_start (progress, FALSE,
+                                    _("Computing alpha of unknown pixels"));
+
+  if (data->engine == GIMP_MATTING_ENGINE_GLOBAL)
+    margin = GLOBAL_MARGIN;
+  else
+    margin = LEVIN_MARGIN << CLAMP (data->levin_levels, 0, 8);
+
+  margin = ceil (margin / data->scale);
+
+  /*  in drawable coordinates  */
+  gegl_rectangle_set (&area,
+                      unknown.x - data->off_x - margin,
+                      unknown.y - data->off_y - margin,
+                      unknown.width  + 2 * margin,
+                      unknown.height + 2 * margin);
+  gegl_rectangle_intersect (&area, &area,
+                            gegl_buffer_get_extent (data->buffer));
 
   gegl = gegl_node_new ();
 
   trimap_node = gegl_node_new_child (gegl,
                                      "operation", "gegl:buffer-source",
-                                     "buffer",    trimap,
+                                     "buffer",    data->trimap,
                                      NULL);
   input_node = gegl_node_new_child (gegl,
                                     "operation", "gegl:buffer-source",
-                                    "buffer",    drawable_buffer,
+                                    "buffer",    data->buffer,
                                     NULL);
   output_node = gegl_node_new_child (gegl,
                                      "operation", "gegl:buffer-sink",
-                                     "buffer",    &buffer,
+                                     "buffer",    &matte,
                                      "format",    NULL,
                                      NULL);
 
-  if (engine == GIMP_MATTING_ENGINE_GLOBAL)
+  input_crop = gegl_node_new_child (gegl,
+                                    "operation", "gegl:crop",
+                                    "x",         (gdouble) area.x,
+                                    "y",         (gdouble) area.y,
+                                    "width",     (gdouble) area.width,
+                                    "height",    (gdouble) area.height,
+                                    NULL);
+  trimap_crop = gegl_node_new_child (gegl,
+                                     "operation", "gegl:crop",
+                                     "x",         (gdouble) area.x,
+                                     "y",         (gdouble) area.y,
+                                     "width",     (gdouble) area.width,
+                                     "height",    (gdouble) area.height,
+                                     NULL);
+
+  if (data->engine == GIMP_MATTING_ENGINE_GLOBAL)
     {
       matting_node = gegl_node_new_child (gegl,
                                           "operation",  "gegl:matting-global",
-                                          "iterations", global_iterations,
+                                          "iterations", data->global_iterations,
                                           NULL);
     }
   else
     {
       matting_node = gegl_node_new_child (gegl,
                                           "operation",     "gegl:matting-levin",
-                                          "levels",        levin_levels,
-                                          "active_levels", levin_active_levels,
+                                          "levels",        data->levin_levels,
+                                          "active_levels", data->levin_active_levels,
                                           NULL);
     }
 
-  gimp_item_get_offset (GIMP_ITEM (drawable), &off_x, &off_y);
+  gegl_node_link (input_node, input_crop);
 
-  if (off_x || off_y)
+  if (data->off_x || data->off_y)
     {
       GeglNode *pre;
-      GeglNode *post;
 
       pre = gegl_node_new_child (gegl,
                                  "operation", "gegl:translate",
-                                 "x", -1.0 * off_x,
-                                 "y", -1.0 * off_y,
+                                 "x", -1.0 * data->off_x,
+                                 "y", -1.0 * data->off_y,
                                  NULL);
-      post = gegl_node_new_child (gegl,
-                                  "operation", "gegl:translate",
-                                  "x", 1.0 * off_x,
-                                  "y", 1.0 * off_y,
-                                  NULL);
-
-      gegl_node_connect_to (trimap_node,   "output", pre, "input");
-      gegl_node_connect_to (pre,  "output", matting_node, "aux");
-      gegl_node_link_many (input_node, matting_node, post, output_node, NULL);
+
+      gegl_node_link_many (trimap_node, pre, trimap_crop, NULL);
     }
   else
     {
-      gegl_node_connect_to (input_node,   "output",
+      gegl_node_link (trimap_node, trimap_crop);
+    }
+
+  if (data->scale < 1.0)
+    {
+      GeglNode *input_scale;
+      GeglNode *trimap_scale;
+      GeglNode *matte_scale;
+
+      input_scale = gegl_node_new_child (gegl,
+                                         "operation", "gegl:scale-ratio",
+                                         "x",         data->scale,
+                                         "y",         data->scale,
+                                         "sampler",   GEGL_SAMPLER_LINEAR,
+                                         NULL);
+      /*  keep the trimap's values as they are  */
+      trimap_scale = gegl_node_new_child (gegl,
+                                          "operation", "gegl:scale-ratio",
+                                          "x",         data->scale,
+                                          "y",         data->scale,
+                                          "sampler",   GEGL_SAMPLER_NEAREST,
+                                          NULL);
+      matte_scale = gegl_node_new_child (gegl,
+                                         "operation", "gegl:scale-ratio",
+                                         "x",         1.0 / data->scale,
+                                         "y",         1.0 / data->scale,
+                                         "sampler",   GEGL_SAMPLER_LINEAR,
+                                         NULL);
+
+      gegl_node_link (input_crop, input_scale);
+      gegl_node_link (trimap_crop, trimap_scale);
+
+      gegl_node_connect_to (input_scale,  "output",
                             matting_node, "input");
-      gegl_node_connect_to (trimap_node,  "output",
+      gegl_node_connect_to (trimap_scale, "output",
+                            matting_node, "aux");
+      gegl_node_link_many (matting_node, matte_scale, output_node, NULL);
+    }
+  else
+    {
+      gegl_node_connect_to (input_crop,   "output",
+                            matting_node, "input");
+      gegl_node_connect_to (trimap_crop,  "output",
                             matting_node, "aux");
       gegl_node_connect_to (matting_node, "output",
                             output_node,  "input");
@@ -135,6 +374,12 @@ gimp_drawable_foreground_extract (GimpDrawable      *drawable,
 
   while (gegl_processor_work (processor, &value))
     {
+      if (async && gimp_async_is_canceled (async))
+        {
+          canceled = TRUE;
+          break;
+        }
+
       if (progress)
         gimp_progress_set_value (progress, value);
     }
@@ -146,5 +391,125 @@ gimp_drawable_foreground_extract (GimpDrawable      *drawable,
 
   g_object_unref (gegl);
 
+  if (canceled)
+    {
+      g_clear_object (&matte);
+      g_object_unref (buffer);
+
+      return NULL;
+    }
+
+  foreground_extract_merge (buffer, data->trimap, matte, &unknown,
+                            data->off_x, data->off_y);
+
+  g_object_unref (matte);
+
   return buffer;
 }
+
+static void
+foreground_extract_async_func (GimpAsync             *async,
+                               ForegroundExtractData *data)
+{
+  GeglBuffer *buffer = foreground_extract (data, NULL, async);
+
+  if (buffer)
+    gimp_async_finish_full (async, buffer, g_object_unref);
+  else
+    gimp_async_abort (async);
+}
+
+/*  finds the bounds, within rect, of the trimap's unknown pixels, that is
+ *  the pixels that are neither fully foreground nor fully background.
+ */
+static gboolean
+foreground_extract_unknown_bounds (GeglBuffer          *trimap,
+                                   const GeglRectangle *rect,
+                                   GeglRectangle       *bounds)
+{
+  GeglBufferIterator *iter;
+  gint                x1, y1;
+  gint                x2, y2;
+
+  x1 = rect->x + rect->width;
+  y1 = rect->y + rect->height;
+  x2 = rect->x;
+  y2 = rect->y;
+
+  iter = gegl_buffer_iterator_new (trimap, rect, 0, babl_format ("Y float"),
+                                   GEGL_ACCESS_READ, GEGL_ABYSS_NONE, 1);
+
+  while (gegl_buffer_iterator_next (iter))
+    {
+      const GeglRectangle *roi  = &iter->items[0].roi;
+      const gfloat        *data = iter->items[0].data;
+      gint                 x, y;
+
+      for (y = roi->y; y < roi->y + roi->height; y++)
+        {
+          for (x = roi->x; x < roi->x + roi->width; x++, data++)
+            {
+              if (*data > 0.0f && *data < 1.0f)
+                {
+                  x1 = MIN (x1, x);
+                  y1 = MIN (y1, y);
+                  x2 = MAX (x2, x + 1);
+                  y2 = MAX (y2, y + 1);
+                }
+            }
+        }
+    }
+
+  if (x1 >= x2 || y1 >= y2)
+    return FALSE;
+
+  gegl_rectangle_set (bounds, x1, y1, x2 - x1, y2 - y1);
+
+  return TRUE;
+}
+
+/*  takes the alpha of the unknown pixels within rect from the matte, which
+ *  is in drawable coordinates.
+ */
+static void
+foreground_extract_merge (GeglBuffer          *buffer,
+                          GeglBuffer          *trimap,
+                          GeglBuffer          *matte,
+                          const GeglRectangle *rect,
+                          gint                 off_x,
+                          gint                 off_y)
+{
+  GeglBufferIterator *iter;
+  const Babl         *format = babl_format ("Y float");
+
+  iter = gegl_buffer_iterator_new (buffer, rect, 0, format,
+                                   GEGL_ACCESS_READWRITE, GEGL_ABYSS_NONE, 3);
+
+  gegl_buffer_iterator_add (iter, trimap, rect, 0, format,
+                            GEGL_ACCESS_READ, GEGL_ABYSS_NONE);
+
+  gegl_buffer_iterator_add (iter, matte,
+                            GEGL_RECTANGLE (rect->x - off_x,
+                                            rect->y - off_y,
+                                            rect->width,
+                                            rect->height), 0, format,
+                            GEGL_ACCESS_READ, GEGL_ABYSS_CLAMP);
+
+  while (gegl_buffer_iterator_next (iter))
+    {
+      gfloat       *dest   = iter->items[0].data;
+      const gfloat *known  = iter->items[1].data;
+      const gfloat *alpha  = iter->items[2].data;
+      gint          length = iter->length;
+
+      while (length--)
+        {
+          if (*known > 0.0f && *known < 1.0f)
+            *dest = CLAMP (*alpha, 0.0f, 1.0f);
+
+          dest++;
+          known++;
+          alpha++;
+        }
+    }
+}
@@ -179,6 +179,10 @@ gimp_drawable_get_preview_format (GimpDrawable *drawable)
   g_return_val_if_reached (NULL);
 }
 
+/*  scaled-down previews are sampled from the nearest level of the buffer's
+ *  mipmap pyramid, which gegl keeps box-filtered and regenerates lazily,
+ *  only for the tiles that changed since the last read.
+ */
 GimpTempBuf *
 gimp_drawable_get_sub_preview (GimpDrawable *drawable,
                                gint          src_x,
@@ -354,7 +358,7 @@ gimp_drawable_get_sub_preview_async_func (GimpAsync      *async,
           rect.y      = floor (data->rect.y / data->scale);
           rect.width  = ceil ((data->rect.x + data->rect.width)  /
                               data->scale) - rect.x;
-          rect.height = ceil ((data->rect.x + data->rect.height) /
+          rect.height = ceil ((data->rect.y + data->rect.height) /
                               data->scale) - rect.y;
 
           region = cairo_region_copy (validate->dirty_region);
@@ -51,6 +51,21 @@
 #include "gimp-intl.h"
 
 
+#define ROTATE_PIXELS_PER_THREAD (64 * 64)
+
+
+typedef struct
+{
+  GeglBuffer       *orig_buffer;
+  GeglBuffer       *new_buffer;
+  const Babl       *format;
+  gint              bpp;
+  GimpRotationType  rotate_type;
+  GeglRectangle     src_rect;
+  GeglRectangle     dest_rect;
+} RotateData;
+
+
 /*  public functions  */
 
 GeglBuffer *
@@ -377,6 +392,100 @@ gimp_drawable_transform_rotate_point (gint              x,
     }
 }
 
+/*  rotates the source block of each destination tile in memory, instead of
+ *  moving the pixels one row or column at a time, which touches all the
+ *  tiles of a column for every single pixel column written.
+ */
+static void
+gimp_drawable_transform_rotate_area (const GeglRectangle *area,
+                                     const RotateData    *data)
+{
+  GeglBufferIterator *iter;
+  const gint          bpp    = data->bpp;
+  const gint          orig_w = data->src_rect.width;
+  const gint          orig_h = data->src_rect.height;
+
+  iter = gegl_buffer_iterator_new (data->new_buffer, area, 0, data->format,
+                                   GEGL_ACCESS_WRITE, GEGL_ABYSS_NONE, 1);
+
+  while (gegl_buffer_iterator_next (iter))
+    {
+      const GeglRectangle *roi  = &iter->items[0].roi;
+      guchar              *dest = iter->items[0].data;
+      guchar              *block;
+      GeglRectangle        block_rect;
+      gint                 dx     = roi->x - data->dest_rect.x;
+      gint                 dy     = roi->y - data->dest_rect.y;
+      gint                 w      = roi->width;
+      gint                 h      = roi->height;
+      gint                 stride;
+      gint                 u, v;
+
+      /*  the source block that ends up in roi  */
+      switch (data->rotate_type)
+        {
+        case GIMP_ROTATE_90:
+          gegl_rectangle_set (&block_rect,
+                              data->src_rect.x + dy,
+                              data->src_rect.y + orig_h - dx - w,
+                              h, w);
+          break;
+
+        case GIMP_ROTATE_180:
+          gegl_rectangle_set (&block_rect,
+                              data->src_rect.x + orig_w - dx - w,
+                              data->src_rect.y + orig_h - dy - h,
+                              w, h);
+          break;
+
+        case GIMP_ROTATE_270:
+          gegl_rectangle_set (&block_rect,
+                              data->src_rect.x + orig_w - dy - h,
+                              data->src_rect.y + dx,
+                              h, w);
+          break;
+
+        default:
+          g_return_if_reached ();
+        }
+
+      stride = block_rect.width * bpp;
+      block  = gegl_scratch_alloc (stride * block_rect.height);
+
+      gegl_buffer_get (data->orig_buffer, &block_rect, 1.0, data->format,
+                       block, stride, GEGL_ABYSS_NONE);
+
+      for (v = 0; v < h; v++)
+        {
+          for (u = 0; u < w; u++)
+            {
+              const guchar *src;
+
+              switch (data->rotate_type)
+                {
+                case GIMP_ROTATE_90:
+                  src = block + (w - 1 - u) * stride + v * bpp;
+                  break;
+
+                case GIMP_ROTATE_180:
+                  src = block + (h - 1 - v) * stride + (w - 1 - u) * bpp;
+                  break;
+
+                default:
+                  src = block + u * stride + (h - 1 - v) * bpp;
+                  break;
+                }
+
+              memcpy (dest, src, bpp);
+
+              dest += bpp;
+            }
+        }
+
+      gegl_scratch_free (block);
+    }
+}
+
 GeglBuffer *
 gimp_drawable_transform_buffer_rotate (GimpDrawable      *drawable,
                                        GimpContext       *context,
@@ -395,6 +504,7 @@ gimp_drawable_transform_buffer_rotate (GimpDrawable      *drawable,
   GeglBuffer    *new_buffer;
   GeglRectangle  src_rect;
   GeglRectangle  dest_rect;
+  RotateData     data;
   gint           orig_x, orig_y;
   gint           orig_width, orig_height;
   gint           orig_bpp;
@@ -574,118 +684,32 @@ gimp_drawable_transform_buffer_rotate (GimpDrawable      *drawable,
   dest_rect.width  = new_width;
   dest_rect.height = new_height;
 
-  switch (rotate_type)
+  /* Not cool, we leak memory if we return, but anyway that is never
+   * supposed to happen. If we see this warning, a bug has to be fixed!
+   */
+  if (rotate_type == GIMP_ROTATE_180)
     {
-    case GIMP_ROTATE_90:
-      {
-        guchar *buf = g_new (guchar, new_height * orig_bpp);
-        gint    i;
-
-        /* Not cool, we leak memory if we return, but anyway that is
-         * never supposed to happen. If we see this warning, a bug has
-         * to be fixed!
-         */
-        g_return_val_if_fail (new_height == orig_width, NULL);
-
-        src_rect.y      = orig_y + orig_height - 1;
-        src_rect.height = 1;
-
-        dest_rect.x     = new_x;
-        dest_rect.width = 1;
-
-        for (i = 0; i < orig_height; i++)
-          {
-            src_rect.y  = orig_y + orig_height - 1 - i;
-            dest_rect.x = new_x + i;
-
-            gegl_buffer_get (orig_buffer, &src_rect, 1.0, NULL, buf,
-                             GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
-            gegl_buffer_set (new_buffer, &dest_rect, 0, NULL, buf,
-                             GEGL_AUTO_ROWSTRIDE);
-          }
-
-        g_free (buf);
-      }
-      break;
-
-    case GIMP_ROTATE_180:
-      {
-        guchar *buf = g_new (guchar, new_width * orig_bpp);
-        gint    i, j, k;
-
-        /* Not cool, we leak memory if we return, but anyway that is
-         * never supposed to happen. If we see this warning, a bug has
-         * to be fixed!
-         */
-        g_return_val_if_fail (new_width == orig_width, NULL);
-
-        src_rect.y      = orig_y + orig_height - 1;
-        src_rect.height = 1;
-
-        dest_rect.y      = new_y;
-        dest_rect.height = 1;
-
-        for (i = 0; i < orig_height; i++)
-          {
-            src_rect.y  = orig_y + orig_height - 1 - i;
-            dest_rect.y = new_y + i;
-
-            gegl_buffer_get (orig_buffer, &src_rect, 1.0, NULL, buf,
-                             GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
-
-            for (j = 0; j < orig_width / 2; j++)
-              {
-                guchar *left  = buf + j * orig_bpp;
-                guchar *right = buf + (orig_width - 1 - j) * orig_bpp;
-
-                for (k = 0; k < orig_bpp; k++)
-                  {
-                    guchar tmp = left[k];
-                    left[k]    = right[k];
-                    right[k]   = tmp;
-                  }
-              }
-
-            gegl_buffer_set (new_buffer, &dest_rect, 0, NULL, buf,
-                             GEGL_AUTO_ROWSTRIDE);
-          }
-
-        g_free (buf);
-      }
-      break;
-
-    case GIMP_ROTATE_270:
-      {
-        guchar *buf = g_new (guchar, new_width * orig_bpp);
-        gint    i;
-
-        /* Not cool, we leak memory if we return, but anyway that is
-         * never supposed to happen. If we see this warning, a bug has
-         * to be fixed!
-         */
-        g_return_val_if_fail (new_width == orig_height, NULL);
-
-        src_rect.x     = orig_x + orig_width - 1;
-        src_rect.width = 1;
-
-        dest_rect.y      = new_y;
-        dest_rect.height = 1;
-
-        for (i = 0; i < orig_width; i++)
-          {
-            src_rect.x  = orig_x + orig_width - 1 - i;
-            dest_rect.y = new_y + i;
-
-            gegl_buffer_get (orig_buffer, &src_rect, 1.0, NULL, buf,
-                             GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
-            gegl_buffer_set (new_buffer, &dest_rect, 0, NULL, buf,
-                             GEGL_AUTO_ROWSTRIDE);
-          }
-
-        g_free (buf);
-      }
-      break;
+      g_return_val_if_fail (new_width  == orig_width,  NULL);
+      g_return_val_if_fail (new_height == orig_height, NULL);
     }
+  else
+    {
+      g_return_val_if_fail (new_width  == orig_height, NULL);
+      g_return_val_if_fail (new_height == orig_width,  NULL);
+    }
+
+  data.orig_buffer = orig_buffer;
+  data.new_buffer  = new_buffer;
+  data.format      = format;
+  data.bpp         = orig_bpp;
+  data.rotate_type = rotate_type;
+  data.src_rect    = src_rect;
+  data.dest_rect   = dest_rect;
+
+  gegl_parallel_distribute_area (
+    &dest_rect, ROTATE_PIXELS_PER_THREAD, GEGL_SPLIT_STRATEGY_AUTO,
+    (GeglParallelDistributeAreaFunc) gimp_drawable_transform_rotate_area,
+    &data);
 
   return new_buffer;
 }
@@ -40,6 +40,7 @@
 #include "gegl/gimpapplicator.h"
 #include "gegl/gimp-gegl-utils.h"
 
+#include "gimp-trace.h"
 #include "gimpchannel.h"
 #include "gimpdrawable-filters.h"
 #include "gimpdrawablefilter.h"
@@ -590,6 +591,8 @@ gimp_drawable_filter_commit (GimpDrawableFilter *filter,
                                               filter->preview_split_position);
       gimp_drawable_filter_set_preview (filter, TRUE);
 
+      gimp_trace_begin_intern ("filter", gimp_object_get_name (filter));
+
       success = gimp_drawable_merge_filter (filter->drawable,
                                             GIMP_FILTER (filter),
                                             progress,
@@ -599,6 +602,8 @@ gimp_drawable_filter_commit (GimpDrawableFilter *filter,
                                             cancellable,
                                             FALSE);
 
+      gimp_trace_end ();
+
       gimp_drawable_filter_remove_filter (filter);
 
       if (! success)
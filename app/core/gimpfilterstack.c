@@ -47,6 +47,8 @@ static void   gimp_filter_stack_add_node         (GimpFilterStack *stack,
 static void   gimp_filter_stack_remove_node      (GimpFilterStack *stack,
                                                   GimpFilter      *filter);
 static void   gimp_filter_stack_update_last_node (GimpFilterStack *stack);
+static void   gimp_filter_stack_remove_backdrop_cache
+                                                 (GimpFilterStack *stack);
 
 static void   gimp_filter_stack_filter_active    (GimpFilter      *filter,
                                                   GimpFilterStack *stack);
@@ -96,6 +98,8 @@ gimp_filter_stack_finalize (GObject *object)
 {
   GimpFilterStack *stack = GIMP_FILTER_STACK (object);
 
+  gimp_filter_stack_remove_backdrop_cache (stack);
+
   g_clear_object (&stack->graph);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -108,6 +112,8 @@ gimp_filter_stack_add (GimpContainer *container,
   GimpFilterStack *stack  = GIMP_FILTER_STACK (container);
   GimpFilter      *filter = GIMP_FILTER (object);
 
+  gimp_filter_stack_remove_backdrop_cache (stack);
+
   GIMP_CONTAINER_CLASS (parent_class)->add (container, object);
 
   if (gimp_filter_get_active (filter))
@@ -129,6 +135,8 @@ gimp_filter_stack_remove (GimpContainer *container,
   GimpFilterStack *stack  = GIMP_FILTER_STACK (container);
   GimpFilter      *filter = GIMP_FILTER (object);
 
+  gimp_filter_stack_remove_backdrop_cache (stack);
+
   if (stack->graph && gimp_filter_get_active (filter))
     {
       gimp_filter_stack_remove_node (stack, filter);
@@ -152,6 +160,8 @@ gimp_filter_stack_reorder (GimpContainer *container,
   GimpFilterStack *stack  = GIMP_FILTER_STACK (container);
   GimpFilter      *filter = GIMP_FILTER (object);
 
+  gimp_filter_stack_remove_backdrop_cache (stack);
+
   if (stack->graph && gimp_filter_get_active (filter))
     gimp_filter_stack_remove_node (stack, filter);
 
@@ -225,6 +235,62 @@ gimp_filter_stack_get_graph (GimpFilterStack *stack)
   return stack->graph;
 }
 
+/*  gimp_filter_stack_set_backdrop_cache:
+ *
+ *  caches the composited result of all the active filters below @filter,
+ *  so that updates to @filter itself, or to the filters above it, don't
+ *  need to re-render the bottom part of the stack.  the cache is
+ *  invalidated by GEGL whenever any of the filters below @filter is
+ *  updated, and is dropped altogether whenever the structure of the
+ *  stack changes.  only a single filter can have its backdrop cached
+ *  at a time; pass NULL to remove the cache.
+ */
+void
+gimp_filter_stack_set_backdrop_cache (GimpFilterStack *stack,
+                                      GimpFilter      *filter)
+{
+  GeglNode *node;
+  GeglNode *node_below;
+
+  g_return_if_fail (GIMP_IS_FILTER_STACK (stack));
+  g_return_if_fail (filter == NULL || GIMP_IS_FILTER (filter));
+  g_return_if_fail (filter == NULL ||
+                    gimp_container_have (GIMP_CONTAINER (stack),
+                                         GIMP_OBJECT (filter)));
+
+  if (filter == stack->backdrop_cache_filter)
+    return;
+
+  gimp_filter_stack_remove_backdrop_cache (stack);
+
+  if (! filter || ! stack->graph || ! gimp_filter_get_active (filter))
+    return;
+
+  node       = gimp_filter_get_node (filter);
+  node_below = gegl_node_get_producer (node, "input", NULL);
+
+  if (! node_below)
+    return;
+
+  stack->backdrop_cache_filter = filter;
+  stack->backdrop_cache_node   = gegl_node_new_child (stack->graph,
+                                                      "operation", "gegl:cache",
+                                                      NULL);
+
+  gegl_node_connect_to (node_below,                 "output",
+                        stack->backdrop_cache_node, "input");
+  gegl_node_connect_to (stack->backdrop_cache_node, "output",
+                        node,                       "input");
+}
+
+GimpFilter *
+gimp_filter_stack_get_backdrop_cache (GimpFilterStack *stack)
+{
+  g_return_val_if_fail (GIMP_IS_FILTER_STACK (stack), NULL);
+
+  return stack->backdrop_cache_filter;
+}
+
 
 /*  private functions  */
 
@@ -325,10 +391,36 @@ gimp_filter_stack_update_last_node (GimpFilterStack *stack)
     }
 }
 
+static void
+gimp_filter_stack_remove_backdrop_cache (GimpFilterStack *stack)
+{
+  GeglNode *node_below;
+
+  if (! stack->backdrop_cache_node)
+    return;
+
+  node_below = gegl_node_get_producer (stack->backdrop_cache_node, "input",
+                                       NULL);
+
+  gegl_node_disconnect (stack->backdrop_cache_node, "input");
+
+  gegl_node_connect_to (node_below,
+                        "output",
+                        gimp_filter_get_node (stack->backdrop_cache_filter),
+                        "input");
+
+  gegl_node_remove_child (stack->graph, stack->backdrop_cache_node);
+
+  stack->backdrop_cache_filter = NULL;
+  stack->backdrop_cache_node   = NULL;
+}
+
 static void
 gimp_filter_stack_filter_active (GimpFilter      *filter,
                                  GimpFilterStack *stack)
 {
+  gimp_filter_stack_remove_backdrop_cache (stack);
+
   if (stack->graph)
     {
       if (gimp_filter_get_active (filter))
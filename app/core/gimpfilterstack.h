@@ -37,7 +37,10 @@ struct _GimpFilterStack
 {
   GimpList  parent_instance;
 
-  GeglNode *graph;
+  GeglNode   *graph;
+
+  GimpFilter *backdrop_cache_filter;
+  GeglNode   *backdrop_cache_node;
 };
 
 struct _GimpFilterStackClass
@@ -51,5 +54,11 @@ GimpContainer * gimp_filter_stack_new       (GType            filter_type);
 
 GeglNode *      gimp_filter_stack_get_graph (GimpFilterStack *stack);
 
+void            gimp_filter_stack_set_backdrop_cache
+                                            (GimpFilterStack *stack,
+                                             GimpFilter      *filter);
+GimpFilter *    gimp_filter_stack_get_backdrop_cache
+                                            (GimpFilterStack *stack);
+
 
 #endif  /*  __GIMP_FILTER_STACK_H__  */
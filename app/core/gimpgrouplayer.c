@@ -69,6 +69,10 @@ struct _GimpGroupLayerPrivate
   gboolean        expanded;
   gboolean        pass_through;
 
+  /*  the child receiving consecutive updates, whose backdrop is cached  */
+  GimpLayer      *update_child;
+  gint            n_update_child_updates;
+
   /*  hackish temp states to make the projection/tiles stuff work  */
   const Babl     *convert_format;
   gboolean        reallocate_projection;
@@ -76,6 +80,11 @@ struct _GimpGroupLayerPrivate
 
 #define GET_PRIVATE(item) ((GimpGroupLayerPrivate *) gimp_group_layer_get_instance_private ((GimpGroupLayer *) (item)))
 
+/*  number of consecutive updates of the same child, after which its
+ *  backdrop is cached
+ */
+#define BACKDROP_CACHE_MIN_UPDATES 2
+
 
 static void            gimp_projectable_iface_init   (GimpProjectableInterface  *iface);
 static void            gimp_pickable_iface_init      (GimpPickableInterface     *iface);
@@ -214,6 +223,12 @@ static void
 static void
     gimp_group_layer_child_excludes_backdrop_changed (GimpLayer       *child,
                                                       GimpGroupLayer  *group);
+static void            gimp_group_layer_child_update (GimpLayer       *child,
+                                                      gint             x,
+                                                      gint             y,
+                                                      gint             width,
+                                                      gint             height,
+                                                      GimpGroupLayer  *group);
 
 static void            gimp_group_layer_flush        (GimpGroupLayer  *group);
 static void            gimp_group_layer_update       (GimpGroupLayer  *group);
@@ -371,6 +386,9 @@ gimp_group_layer_init (GimpGroupLayer *group)
   gimp_container_add_handler (private->children, "excludes-backdrop-changed",
                               G_CALLBACK (gimp_group_layer_child_excludes_backdrop_changed),
                               group);
+  gimp_container_add_handler (private->children, "update",
+                              G_CALLBACK (gimp_group_layer_child_update),
+                              group);
 
   g_signal_connect (private->children, "update",
                     G_CALLBACK (gimp_group_layer_stack_update),
@@ -1825,6 +1843,14 @@ gimp_group_layer_child_remove (GimpContainer  *container,
                                GimpLayer      *child,
                                GimpGroupLayer *group)
 {
+  GimpGroupLayerPrivate *private = GET_PRIVATE (group);
+
+  if (child == private->update_child)
+    {
+      private->update_child           = NULL;
+      private->n_update_child_updates = 0;
+    }
+
   gimp_group_layer_update (group);
 
   if (gimp_filter_get_active (GIMP_FILTER (child)))
@@ -1877,6 +1903,50 @@ gimp_group_layer_child_excludes_backdrop_changed (GimpLayer      *child,
     gimp_layer_update_excludes_backdrop (GIMP_LAYER (group));
 }
 
+static void
+gimp_group_layer_child_update (GimpLayer      *child,
+                               gint            x,
+                               gint            y,
+                               gint            width,
+                               gint            height,
+                               GimpGroupLayer *group)
+{
+  GimpGroupLayerPrivate *private = GET_PRIVATE (group);
+  GimpFilterStack       *stack   = GIMP_FILTER_STACK (private->children);
+  GList                 *list;
+
+  if (child != private->update_child)
+    {
+      private->update_child           = child;
+      private->n_update_child_updates = 0;
+    }
+
+  if (++private->n_update_child_updates < BACKDROP_CACHE_MIN_UPDATES ||
+      gimp_filter_stack_get_backdrop_cache (stack) == GIMP_FILTER (child)  ||
+      ! gimp_filter_get_active (GIMP_FILTER (child)))
+    {
+      return;
+    }
+
+  /*  a child receiving consecutive updates, such as a layer being painted
+   *  on, only needs the part of the group above it to be recomposited.
+   *  cache the composited result of the children below it, as long as
+   *  there are any, so that the rest of the group doesn't have to be
+   *  re-rendered on each update.
+   */
+  list = g_list_find (GIMP_LIST (stack)->queue->head, child);
+
+  for (list = g_list_next (list); list; list = g_list_next (list))
+    {
+      if (gimp_filter_get_active (list->data))
+        {
+          gimp_filter_stack_set_backdrop_cache (stack, GIMP_FILTER (child));
+
+          return;
+        }
+    }
+}
+
 static void
 gimp_group_layer_flush (GimpGroupLayer *group)
 {
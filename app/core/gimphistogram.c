@@ -1043,6 +1043,9 @@ gimp_histogram_calculate_area (const GeglRectangle *area,
 
       CHECK_CANCELED (0);
 
+      /*  pixels outside the mask add nothing, but binning them would
+       *  still touch several bins each, so they are skipped instead
+       */
       if (context->mask)
         {
           const gfloat *mask_data = iter->items[1].data;
@@ -1054,6 +1057,15 @@ gimp_histogram_calculate_area (const GeglRectangle *area,
                 {
                   const gdouble masked = *mask_data;
 
+                  if (masked == 0.0)
+                    {
+                      data += n_components;
+                      mask_data += 1;
+
+                      CHECK_CANCELED (length);
+                      continue;
+                    }
+
                   VALUE (0, data[0]) += masked;
 
                   data += n_components;
@@ -1067,6 +1079,15 @@ gimp_histogram_calculate_area (const GeglRectangle *area,
               while (length--)
                 {
                   const gdouble masked = *mask_data;
+
+                  if (masked == 0.0)
+                    {
+                      data += n_components;
+                      mask_data += 1;
+
+                      CHECK_CANCELED (length);
+                      continue;
+                    }
                   const gdouble weight = data[1];
 
                   VALUE (0, data[0]) += weight * masked;
@@ -1084,6 +1105,15 @@ gimp_histogram_calculate_area (const GeglRectangle *area,
                 {
                   const gdouble masked = *mask_data;
 
+                  if (masked == 0.0)
+                    {
+                      data += n_components;
+                      mask_data += 1;
+
+                      CHECK_CANCELED (length);
+                      continue;
+                    }
+
                   VALUE (1, data[0]) += masked;
                   VALUE (2, data[1]) += masked;
                   VALUE (3, data[2]) += masked;
@@ -1106,6 +1136,15 @@ gimp_histogram_calculate_area (const GeglRectangle *area,
               while (length--)
                 {
                   const gdouble masked = *mask_data;
+
+                  if (masked == 0.0)
+                    {
+                      data += n_components;
+                      mask_data += 1;
+
+                      CHECK_CANCELED (length);
+                      continue;
+                    }
                   const gdouble weight = data[3];
 
                   VALUE (1, data[0]) += weight * masked;
@@ -35,6 +35,7 @@
 #include "config/gimpdialogconfig.h"
 
 #include "gegl/gimp-babl.h"
+#include "gegl/gimp-gegl-color-transform.h"
 #include "gegl/gimp-gegl-loops.h"
 
 #include "gimp.h"
@@ -923,9 +924,9 @@ gimp_image_convert_profile_colormap (GimpImage                *image,
                                                GIMP_COLOR_RENDERING_INTENT_RELATIVE_COLORIMETRIC,
                                                NULL);
 
-  transform = gimp_color_transform_new (src_profile,  src_format,
-                                        dest_profile, dest_format,
-                                        intent, flags);
+  transform = gimp_gegl_color_transform_get (src_profile,  src_format,
+                                             dest_profile, dest_format,
+                                             intent, flags);
 
   if (transform)
     {
@@ -939,7 +940,7 @@ gimp_image_convert_profile_colormap (GimpImage                *image,
     }
   else
     {
-      g_warning ("gimp_color_transform_new() failed!");
+      g_warning ("gimp_gegl_color_transform_get() failed!");
     }
 
   g_free (cmap);
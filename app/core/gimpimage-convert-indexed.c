@@ -147,6 +147,8 @@
 #include "gegl/gimp-gegl-utils.h"
 
 #include "gimp.h"
+#include "gimp-atomic.h"
+#include "gimpcolorindex.h"
 #include "gimpcontainer.h"
 #include "gimpdrawable.h"
 #include "gimperror.h"
@@ -184,6 +186,14 @@
 #define G_SHIFT  (BITS_IN_SAMPLE-PRECISION_G)
 #define B_SHIFT  (BITS_IN_SAMPLE-PRECISION_B)
 
+/*  per-thread histograms are large, so make each thread go through at
+ *  least as many pixels as there are histogram cells
+ */
+#define HISTOGRAM_PIXELS_PER_THREAD (HIST_R_ELEMS * HIST_G_ELEMS * HIST_B_ELEMS)
+
+#define REMAP_PIXELS_PER_THREAD \
+  (/* each thread costs as much as */ 64.0 * 64.0 * 4.0 /* pixels */)
+
 /* we've stretched our non-cubic L*a*b* volume to touch the
  * faces of the logical cube we've allocated for it, so re-scale
  * again in inverse proportion to get back to linear proportions.
@@ -483,6 +493,7 @@ struct _QuantizeObj
   Color         clin[256];                /* .. converted back to linear space */
   gulong        index_used_count[256];    /* how many times an index was used  */
   CFHistogram   histogram;                /* holds the histogram               */
+  GimpColorIndex *color_index;            /* finds the closest clin[] entry    */
 
   gboolean      want_dither_alpha;
   gint          error_freedom;            /* 0=much bleed, 1=controlled bleed */
@@ -515,6 +526,44 @@ typedef struct
 
 } box, *boxptr;
 
+typedef struct
+{
+  GeglBuffer        *buffer;
+  const Babl        *format;
+  gint               bpp;
+  gboolean           has_alpha;
+  gboolean           dither_alpha;
+  gint               offsetx;
+  gint               offsety;
+  GSList * volatile  histograms;
+  gint               had_white;
+  gint               had_black;
+} HistogramRGBData;
+
+typedef struct
+{
+  QuantizeObj       *quantobj;
+  GeglBuffer        *src_buffer;
+  GeglBuffer        *dest_buffer;
+  gint               src_bpp;
+  gint               dest_bpp;
+  gboolean           has_alpha;
+  gboolean           dither_alpha;
+  gint               red_pix;
+  gint               green_pix;
+  gint               blue_pix;
+  gint               alpha_pix;
+  gint               offsetx;
+  gint               offsety;
+  GSList * volatile  results;
+} RemapRGBData;
+
+typedef struct
+{
+  gulong             index_used_count[256];
+  GHashTable        *found;   /* histogram index + 1 -> colormap index + 1 */
+} RemapRGBResult;
+
 
 static void          zero_histogram_gray     (CFHistogram   histogram);
 static void          zero_histogram_rgb      (CFHistogram   histogram);
@@ -1169,16 +1218,127 @@ generate_histogram_gray (CFHistogram  histogram,
 }
 
 static void
-check_white_or_black (const guchar *data)
+check_white_or_black (const guchar *data,
+                      gboolean     *white,
+                      gboolean     *black)
 {
   if (data[RED]   == 255 &&
       data[GREEN] == 255 &&
       data[BLUE]  == 255)
-    had_white = TRUE;
+    *white = TRUE;
   if (data[RED]  ==0 &&
       data[GREEN]==0 &&
       data[BLUE] ==0)
-    had_black = TRUE;
+    *black = TRUE;
+}
+
+/*  adds the pixels of one iterator tile to the histogram, once we know
+ *  the image needs to be quantized.
+ */
+static void
+histogram_rgb_add_pixels (CFHistogram          histogram,
+                          const guchar        *data,
+                          gint                 length,
+                          const GeglRectangle *roi,
+                          gint                 bpp,
+                          gboolean             has_alpha,
+                          gboolean             dither_alpha,
+                          gint                 offsetx,
+                          gint                 offsety,
+                          gboolean            *white,
+                          gboolean            *black)
+{
+  ColorFreq *colfreq;
+  gint       row, col, coledge;
+
+  if (dither_alpha)
+    {
+      /* if alpha-dithering,
+         we need to be deterministic w.r.t. offsets */
+
+      col = roi->x + offsetx;
+      coledge = col + roi->width;
+      row = roi->y + offsety;
+
+      while (length--)
+        {
+          gboolean transparent = FALSE;
+
+          if (has_alpha &&
+              data[ALPHA] <
+              DM[col & DM_WIDTHMASK][row & DM_HEIGHTMASK])
+            transparent = TRUE;
+
+          if (! transparent)
+            {
+              colfreq = HIST_RGB (histogram,
+                                  data[RED],
+                                  data[GREEN],
+                                  data[BLUE]);
+              check_white_or_black (data, white, black);
+              (*colfreq)++;
+            }
+
+          col++;
+          if (col == coledge)
+            {
+              col = roi->x + offsetx;
+              row++;
+            }
+
+          data += bpp;
+        }
+    }
+  else
+    {
+      while (length--)
+        {
+          if ((has_alpha && ((data[ALPHA] > 127)))
+              || (!has_alpha))
+            {
+              colfreq = HIST_RGB (histogram,
+                                  data[RED],
+                                  data[GREEN],
+                                  data[BLUE]);
+              check_white_or_black (data, white, black);
+              (*colfreq)++;
+            }
+
+          data += bpp;
+        }
+    }
+}
+
+static void
+generate_histogram_rgb_area (const GeglRectangle *area,
+                             HistogramRGBData    *data)
+{
+  GeglBufferIterator *iter;
+  CFHistogram         histogram;
+  gboolean            white = FALSE;
+  gboolean            black = FALSE;
+
+  histogram = g_new0 (ColorFreq, HIST_R_ELEMS * HIST_G_ELEMS * HIST_B_ELEMS);
+  gimp_atomic_slist_push_head (&data->histograms, histogram);
+
+  iter = gegl_buffer_iterator_new (data->buffer, area, 0, data->format,
+                                   GEGL_ACCESS_READ, GEGL_ABYSS_NONE, 1);
+
+  while (gegl_buffer_iterator_next (iter))
+    {
+      histogram_rgb_add_pixels (histogram,
+                                iter->items[0].data, iter->length,
+                                &iter->items[0].roi,
+                                data->bpp, data->has_alpha, data->dither_alpha,
+                                data->offsetx, data->offsety,
+                                &white, &black);
+    }
+
+  if (white)
+    g_atomic_int_set (&data->had_white, TRUE);
+
+  if (black)
+    g_atomic_int_set (&data->had_black, TRUE);
 }
 
 static void
@@ -1216,6 +1376,58 @@ generate_histogram_rgb (CFHistogram   histogram,
 
   /*  g_printerr ("col_limit = %d, nfc = %d\n", col_limit, num_found_cols); */
 
+  /*  once we know the image needs to be quantized, large layers are split
+   *  among threads, each with a histogram of its own, which are summed up
+   *  afterwards.
+   */
+  if (needs_quantize && layer_size >= 2 * HISTOGRAM_PIXELS_PER_THREAD)
+    {
+      HistogramRGBData  data;
+      GSList           *list;
+
+      data.buffer       = gimp_drawable_get_buffer (GIMP_DRAWABLE (layer));
+      data.format       = format;
+      data.bpp          = bpp;
+      data.has_alpha    = has_alpha;
+      data.dither_alpha = dither_alpha;
+      data.offsetx      = offsetx;
+      data.offsety      = offsety;
+      data.histograms   = NULL;
+      data.had_white    = FALSE;
+      data.had_black    = FALSE;
+
+      if (progress)
+        gimp_progress_set_value (progress, 0.0);
+
+      gegl_parallel_distribute_area (
+        gegl_buffer_get_extent (data.buffer), HISTOGRAM_PIXELS_PER_THREAD,
+        GEGL_SPLIT_STRATEGY_AUTO,
+        (GeglParallelDistributeAreaFunc) generate_histogram_rgb_area,
+        &data);
+
+      for (list = data.histograms; list; list = g_slist_next (list))
+        {
+          const ColorFreq *values = list->data;
+          gint             i;
+
+          for (i = 0; i < HIST_R_ELEMS * HIST_G_ELEMS * HIST_B_ELEMS; i++)
+            histogram[i] += values[i];
+        }
+
+      g_slist_free_full (data.histograms, g_free);
+
+      if (data.had_white)
+        had_white = TRUE;
+
+      if (data.had_black)
+        had_black = TRUE;
+
+      if (progress)
+        gimp_progress_set_value (progress, 1.0);
+
+      return;
+    }
+
   iter = gegl_buffer_iterator_new (gimp_drawable_get_buffer (GIMP_DRAWABLE (layer)),
                                    NULL, 0, format,
                                    GEGL_ACCESS_READ, GEGL_ABYSS_NONE, 1);
@@ -1235,62 +1447,10 @@ generate_histogram_rgb (CFHistogram   histogram,
 
       if (needs_quantize)
         {
-          if (dither_alpha)
-            {
-              /* if alpha-dithering,
-                 we need to be deterministic w.r.t. offsets */
-
-              col = roi->x + offsetx;
-              coledge = col + roi->width;
-              row = roi->y + offsety;
-
-              while (length--)
-                {
-                  gboolean transparent = FALSE;
-
-                  if (has_alpha &&
-                      data[ALPHA] <
-                      DM[col & DM_WIDTHMASK][row & DM_HEIGHTMASK])
-                    transparent = TRUE;
-
-                  if (! transparent)
-                    {
-                      colfreq = HIST_RGB (histogram,
-                                          data[RED],
-                                          data[GREEN],
-                                          data[BLUE]);
-                      check_white_or_black (data);
-                      (*colfreq)++;
-                    }
-
-                  col++;
-                  if (col == coledge)
-                    {
-                      col = roi->x + offsetx;
-                      row++;
-                    }
-
-                  data += bpp;
-                }
-            }
-          else
-            {
-              while (length--)
-                {
-                  if ((has_alpha && ((data[ALPHA] > 127)))
-                      || (!has_alpha))
-                    {
-                      colfreq = HIST_RGB (histogram,
-                                          data[RED],
-                                          data[GREEN],
-                                          data[BLUE]);
-                      check_white_or_black (data);
-                      (*colfreq)++;
-                    }
-
-                  data += bpp;
-                }
-            }
+          histogram_rgb_add_pixels (histogram, data, length, roi,
+                                    bpp, has_alpha, dither_alpha,
+                                    offsetx, offsety,
+                                    &had_white, &had_black);
         }
       else
         {
@@ -1363,7 +1523,7 @@ generate_histogram_rgb (CFHistogram   histogram,
                           found_cols[num_found_cols-1][1] = data[GREEN];
                           found_cols[num_found_cols-1][2] = data[BLUE];
 
-                          check_white_or_black (data);
+                          check_white_or_black (data, &had_white, &had_black);
                         }
                     }
                 }
@@ -2720,20 +2880,16 @@ fill_inverse_cmap_gray (QuantizeObj *quantobj,
  * can fill as many others as we wish.)
  */
 static void
-fill_inverse_cmap_rgb (QuantizeObj *quantobj,
-                       CFHistogram  histogram,
+find_inverse_cmap_rgb (QuantizeObj *quantobj,
                        gint         R,
                        gint         G,
-                       gint         B)
+                       gint         B,
+                       gint         bestcolor[])
 {
   gint  minR, minG, minB; /* lower left corner of update box */
-  gint  iR, iG, iB;
-  gint *cptr;           /* pointer into bestcolor[] array */
   /* This array lists the candidate colormap indexes. */
   gint  colorlist[MAXNUMCOLORS];
   gint  numcolors;                /* number of candidate colors */
-  /* This array holds the actually closest colormap index for each cell. */
-  gint  bestcolor[BOX_R_ELEMS * BOX_G_ELEMS * BOX_B_ELEMS] = { 0, };
 
   /* Convert cell coordinates to update box id */
   R >>= BOX_R_LOG;
@@ -2748,6 +2904,19 @@ fill_inverse_cmap_rgb (QuantizeObj *quantobj,
   minG = (G << BOX_G_SHIFT) + ((1 << G_SHIFT) >> 1);
   minB = (B << BOX_B_SHIFT) + ((1 << B_SHIFT) >> 1);
 
+#if BOX_R_ELEMS * BOX_G_ELEMS * BOX_B_ELEMS == 1
+  /* With single-cell update boxes, a nearest-color search of the colormap's
+   * k-d tree is much faster than going through all of it.  It finds the
+   * same color, the lowest index among equally close ones.
+   */
+  if (quantobj->color_index)
+    {
+      bestcolor[0] = gimp_color_index_lookup (quantobj->color_index,
+                                              minR, minG, minB);
+      return;
+    }
+#endif
+
   /* Determine which colormap entries are close enough to be candidates
    * for the nearest entry to some cell in the update box.
    */
@@ -2756,11 +2925,26 @@ fill_inverse_cmap_rgb (QuantizeObj *quantobj,
   /* Determine the actually nearest colors. */
   find_best_colors (quantobj, minR, minG, minB, numcolors, colorlist,
                     bestcolor);
+}
+
+static void
+fill_inverse_cmap_rgb (QuantizeObj *quantobj,
+                       CFHistogram  histogram,
+                       gint         R,
+                       gint         G,
+                       gint         B)
+{
+  gint  iR, iG, iB;
+  gint *cptr;           /* pointer into bestcolor[] array */
+  /* This array holds the actually closest colormap index for each cell. */
+  gint  bestcolor[BOX_R_ELEMS * BOX_G_ELEMS * BOX_B_ELEMS] = { 0, };
+
+  find_inverse_cmap_rgb (quantobj, R, G, B, bestcolor);
 
   /* Save the best color numbers (plus 1) in the main cache array */
-  R <<= BOX_R_LOG;              /* convert id back to base cell indexes */
-  G <<= BOX_G_LOG;
-  B <<= BOX_B_LOG;
+  R = (R >> BOX_R_LOG) << BOX_R_LOG; /* convert id back to base cell indexes */
+  G = (G >> BOX_G_LOG) << BOX_G_LOG;
+  B = (B >> BOX_B_LOG) << BOX_B_LOG;
   cptr = bestcolor;
   for (iR = 0; iR < BOX_R_ELEMS; iR++)
     {
@@ -2774,6 +2958,24 @@ fill_inverse_cmap_rgb (QuantizeObj *quantobj,
     }
 }
 
+/* Like fill_inverse_cmap_rgb(), but only returns the closest colormap
+ * index of the given cell, without touching the cache.
+ */
+static gint
+lookup_inverse_cmap_rgb (QuantizeObj *quantobj,
+                         gint         R,
+                         gint         G,
+                         gint         B)
+{
+  gint bestcolor[BOX_R_ELEMS * BOX_G_ELEMS * BOX_B_ELEMS] = { 0, };
+
+  find_inverse_cmap_rgb (quantobj, R, G, B, bestcolor);
+
+  return bestcolor[(((R & (BOX_R_ELEMS - 1))  * BOX_G_ELEMS +
+                     (G & (BOX_G_ELEMS - 1))) * BOX_B_ELEMS +
+                     (B & (BOX_B_ELEMS - 1)))];
+}
+
 
 /*  This is pass 1  */
 
@@ -3176,92 +3378,64 @@ median_cut_pass2_fixed_dither_gray (QuantizeObj *quantobj,
     }
 }
 
+/*  the cache is only read while the threads are running; each thread
+ *  keeps the colors it had to look up itself in a table of its own, which
+ *  are added to the cache afterwards.
+ */
 static void
-median_cut_pass2_no_dither_rgb (QuantizeObj *quantobj,
-                                GimpLayer   *layer,
-                                GeglBuffer  *new_buffer)
+median_cut_pass2_no_dither_rgb_area (const GeglRectangle *area,
+                                     RemapRGBData        *data)
 {
-  GeglBufferIterator *iter;
+  QuantizeObj        *quantobj  = data->quantobj;
   CFHistogram         histogram = quantobj->histogram;
-  ColorFreq          *cachep;
-  const Babl         *src_format;
-  const Babl         *dest_format;
+  GeglBufferIterator *iter;
   GeglRectangle      *src_roi;
-  gint                src_bpp;
-  gint                dest_bpp;
-  gint                has_alpha;
+  RemapRGBResult     *result;
+  ColorFreq          *cachep;
   gint                R, G, B;
-  gint                red_pix          = RED;
-  gint                green_pix        = GREEN;
-  gint                blue_pix         = BLUE;
-  gint                alpha_pix        = ALPHA;
-  gboolean            dither_alpha     = quantobj->want_dither_alpha;
-  gint                offsetx, offsety;
-  gulong             *index_used_count = quantobj->index_used_count;
-  glong               total_size       = 0;
-  glong               layer_size;
-  gint                count            = 0;
 
-  gimp_item_get_offset (GIMP_ITEM (layer), &offsetx, &offsety);
+  result = g_slice_new0 (RemapRGBResult);
+  result->found = g_hash_table_new (g_direct_hash, g_direct_equal);
+  gimp_atomic_slist_push_head (&data->results, result);
 
-  src_format  = gimp_drawable_get_format (GIMP_DRAWABLE (layer));
-  dest_format = gegl_buffer_get_format (new_buffer);
-
-  src_bpp  = babl_format_get_bytes_per_pixel (src_format);
-  dest_bpp = babl_format_get_bytes_per_pixel (dest_format);
-
-  has_alpha = babl_format_has_alpha (src_format);
-
-  /*  In the case of web/mono palettes, we actually force
-   *   grayscale drawables through the rgb pass2 functions
-   */
-  if (gimp_drawable_is_gray (GIMP_DRAWABLE (layer)))
-    {
-      red_pix = green_pix = blue_pix = GRAY;
-      alpha_pix = ALPHA_G;
-    }
-
-  iter = gegl_buffer_iterator_new (gimp_drawable_get_buffer (GIMP_DRAWABLE (layer)),
-                                   NULL, 0, NULL,
+  iter = gegl_buffer_iterator_new (data->src_buffer,
+                                   area, 0, NULL,
                                    GEGL_ACCESS_READ, GEGL_ABYSS_NONE, 2);
   src_roi = &iter->items[0].roi;
 
-  gegl_buffer_iterator_add (iter, new_buffer,
-                            NULL, 0, NULL,
+  gegl_buffer_iterator_add (iter, data->dest_buffer,
+                            area, 0, NULL,
                             GEGL_ACCESS_WRITE, GEGL_ABYSS_NONE);
 
-  layer_size = (gimp_item_get_width  (GIMP_ITEM (layer)) *
-                gimp_item_get_height (GIMP_ITEM (layer)));
-
   while (gegl_buffer_iterator_next (iter))
     {
       const guchar *src  = iter->items[0].data;
       guchar       *dest = iter->items[1].data;
       gint          row;
 
-      total_size += src_roi->height * src_roi->width;
-
       for (row = 0; row < src_roi->height; row++)
         {
           gint col;
 
           for (col = 0; col < src_roi->width; col++)
             {
-              if (has_alpha)
+              gint index;
+
+              if (data->has_alpha)
                 {
                   gboolean transparent = FALSE;
 
-                  if (dither_alpha)
+                  if (data->dither_alpha)
                     {
-                      gint dither_x = (col + offsetx + src_roi->x) & DM_WIDTHMASK;
-                      gint dither_y = (row + offsety + src_roi->y) & DM_HEIGHTMASK;
+                      gint dither_x = (col + data->offsetx + src_roi->x) & DM_WIDTHMASK;
+                      gint dither_y = (row + data->offsety + src_roi->y) & DM_HEIGHTMASK;
 
-                      if ((src[alpha_pix]) < DM[dither_x][dither_y])
+                      if ((src[data->alpha_pix]) < DM[dither_x][dither_y])
                         transparent = TRUE;
                     }
                   else
                     {
-                      if (src[alpha_pix] <= 127)
+                      if (src[data->alpha_pix] <= 127)
                         transparent = TRUE;
                     }
 
@@ -3277,30 +3451,127 @@ median_cut_pass2_no_dither_rgb (QuantizeObj *quantobj,
                 }
 
               /* get pixel value and index into the cache */
-              rgb_to_lin (src[red_pix], src[green_pix], src[blue_pix],
+              rgb_to_lin (src[data->red_pix],
+                          src[data->green_pix],
+                          src[data->blue_pix],
                           &R, &G, &B);
 
               cachep = HIST_LIN (histogram, R, G, B);
-              /* If we have not seen this color before, find nearest
-               * colormap entry and update the cache
-               */
-              if (*cachep == 0)
-                fill_inverse_cmap_rgb (quantobj, histogram, R, G, B);
+
+              if (*cachep)
+                {
+                  index = *cachep - 1;
+                }
+              else
+                {
+                  gpointer key = GSIZE_TO_POINTER (cachep - histogram + 1);
+                  gpointer value;
+
+                  /* If we have not seen this color before, find nearest
+                   * colormap entry and remember it
+                   */
+                  value = g_hash_table_lookup (result->found, key);
+
+                  if (value)
+                    {
+                      index = GPOINTER_TO_INT (value) - 1;
+                    }
+                  else
+                    {
+                      index = lookup_inverse_cmap_rgb (quantobj, R, G, B);
+
+                      g_hash_table_insert (result->found,
+                                           key, GINT_TO_POINTER (index + 1));
+                    }
+                }
 
               /* Now emit the colormap index for this cell, barfbarf */
-              index_used_count[dest[INDEXED] = *cachep - 1]++;
+              result->index_used_count[dest[INDEXED] = index]++;
 
             next_pixel:
 
-              src  += src_bpp;
-              dest += dest_bpp;
+              src  += data->src_bpp;
+              dest += data->dest_bpp;
             }
         }
+    }
+}
 
-      if (quantobj->progress && (count % 16 == 0))
-         gimp_progress_set_value (quantobj->progress,
-                                  (gdouble) total_size / (gdouble) layer_size);
+static void
+median_cut_pass2_no_dither_rgb (QuantizeObj *quantobj,
+                                GimpLayer   *layer,
+                                GeglBuffer  *new_buffer)
+{
+  RemapRGBData  data;
+  GSList       *list;
+
+  gimp_item_get_offset (GIMP_ITEM (layer), &data.offsetx, &data.offsety);
+
+  data.quantobj    = quantobj;
+  data.src_buffer  = gimp_drawable_get_buffer (GIMP_DRAWABLE (layer));
+  data.dest_buffer = new_buffer;
+
+  data.src_bpp  = babl_format_get_bytes_per_pixel (
+                    gegl_buffer_get_format (data.src_buffer));
+  data.dest_bpp = babl_format_get_bytes_per_pixel (
+                    gegl_buffer_get_format (new_buffer));
+
+  data.has_alpha    = babl_format_has_alpha (
+                        gegl_buffer_get_format (data.src_buffer));
+  data.dither_alpha = quantobj->want_dither_alpha;
+
+  data.red_pix   = RED;
+  data.green_pix = GREEN;
+  data.blue_pix  = BLUE;
+  data.alpha_pix = ALPHA;
+
+  data.results = NULL;
+
+  /*  In the case of web/mono palettes, we actually force
+   *   grayscale drawables through the rgb pass2 functions
+   */
+  if (gimp_drawable_is_gray (GIMP_DRAWABLE (layer)))
+    {
+      data.red_pix = data.green_pix = data.blue_pix = GRAY;
+      data.alpha_pix = ALPHA_G;
+    }
+
+  if (quantobj->progress)
+    gimp_progress_set_value (quantobj->progress, 0.0);
+
+  gegl_parallel_distribute_area (
+    gegl_buffer_get_extent (new_buffer), REMAP_PIXELS_PER_THREAD,
+    GEGL_SPLIT_STRATEGY_AUTO,
+    (GeglParallelDistributeAreaFunc) median_cut_pass2_no_dither_rgb_area,
+    &data);
+
+  for (list = data.results; list; list = g_slist_next (list))
+    {
+      RemapRGBResult *result = list->data;
+      GHashTableIter  iter;
+      gpointer        key;
+      gpointer        value;
+      gint            i;
+
+      for (i = 0; i < 256; i++)
+        quantobj->index_used_count[i] += result->index_used_count[i];
+
+      g_hash_table_iter_init (&iter, result->found);
+
+      while (g_hash_table_iter_next (&iter, &key, &value))
+        {
+          quantobj->histogram[GPOINTER_TO_SIZE (key) - 1] =
+            GPOINTER_TO_INT (value);
+        }
+
+      g_hash_table_unref (result->found);
+      g_slice_free (RemapRGBResult, result);
     }
+
+  g_slist_free (data.results);
+
+  if (quantobj->progress)
+    gimp_progress_set_value (quantobj->progress, 1.0);
 }
 
 static void
@@ -3973,7 +4244,9 @@ median_cut_pass2_fs_dither_gray (QuantizeObj *quantobj,
 static void
 median_cut_pass2_rgb_init (QuantizeObj *quantobj)
 {
-  int i;
+  const gint weights[3] = { R_SCALE, G_SCALE, B_SCALE };
+  gint       colors[256 * 3];
+  int        i;
 
   zero_histogram_rgb (quantobj->histogram);
 
@@ -3990,6 +4263,19 @@ median_cut_pass2_rgb_init (QuantizeObj *quantobj)
                             &quantobj->clin[i].green,
                             &quantobj->clin[i].blue);
     }
+
+  /* ... and index it for nearest-color searches */
+  for (i = 0; i < quantobj->actual_number_of_colors; i++)
+    {
+      colors[3 * i + 0] = quantobj->clin[i].red;
+      colors[3 * i + 1] = quantobj->clin[i].green;
+      colors[3 * i + 2] = quantobj->clin[i].blue;
+    }
+
+  g_clear_pointer (&quantobj->color_index, gimp_color_index_free);
+
+  quantobj->color_index =
+    gimp_color_index_new (colors, quantobj->actual_number_of_colors, weights);
 }
 
 static void
@@ -4378,6 +4664,7 @@ median_cut_pass2_fs_dither_rgb (QuantizeObj *quantobj,
 static void
 delete_median_cut (QuantizeObj *quantobj)
 {
+  g_clear_pointer (&quantobj->color_index, gimp_color_index_free);
   g_free (quantobj->histogram);
   g_free (quantobj);
 }
@@ -4433,6 +4720,8 @@ initialize_median_cut (GimpImageBaseType       type,
     quantobj->histogram = g_new (ColorFreq,
                                  HIST_R_ELEMS * HIST_G_ELEMS * HIST_B_ELEMS);
 
+  quantobj->color_index              = NULL;
+
   quantobj->custom_palette           = custom_palette;
   quantobj->desired_number_of_colors = num_colors;
   quantobj->want_dither_alpha        = want_dither_alpha;
@@ -85,7 +85,11 @@ gimp_image_convert_precision (GimpImage        *image,
   queue        = gimp_object_queue_new (progress);
   sub_progress = GIMP_PROGRESS (queue);
 
-  layers = gimp_image_get_layer_list (image);
+  /*  convert each group's children before the group itself, so the
+   *  group's projection, which gets rendered when the group is converted,
+   *  is rendered only once, from the converted children
+   */
+  layers = g_list_reverse (gimp_image_get_layer_list (image));
   gimp_object_queue_push_list (queue, layers);
   g_list_free (layers);
 
@@ -24,7 +24,7 @@
 
 #include "core-types.h"
 
-#include "gegl/gimp-gegl-loops.h"
+#include "gegl/gimp-gegl-utils.h"
 
 #include "vectors/gimpvectors.h"
 
@@ -420,12 +420,18 @@ gimp_image_duplicate_mask (GimpImage *image,
 {
   GimpDrawable *mask;
   GimpDrawable *new_mask;
+  GeglBuffer   *new_buffer;
 
   mask     = GIMP_DRAWABLE (gimp_image_get_mask (image));
   new_mask = GIMP_DRAWABLE (gimp_image_get_mask (new_image));
 
-  gimp_gegl_buffer_copy (gimp_drawable_get_buffer (mask), NULL, GEGL_ABYSS_NONE,
-                         gimp_drawable_get_buffer (new_mask), NULL);
+  /*  like all other drawables, share the mask's tiles copy-on-write,
+   *  instead of copying its pixels into the new mask's own buffer
+   */
+  new_buffer = gimp_gegl_buffer_dup (gimp_drawable_get_buffer (mask));
+
+  gimp_drawable_set_buffer (new_mask, FALSE, NULL, new_buffer);
+  g_object_unref (new_buffer);
 
   GIMP_CHANNEL (new_mask)->bounds_known   = FALSE;
   GIMP_CHANNEL (new_mask)->boundary_known = FALSE;
@@ -36,6 +36,8 @@
 
 #include "gimp.h"
 #include "gimpcontext.h"
+#include "gimpdrawable-filters.h"
+#include "gimpdrawable-floating-selection.h"
 #include "gimperror.h"
 #include "gimpgrouplayer.h"
 #include "gimpimage.h"
@@ -54,13 +56,18 @@
 #include "gimp-intl.h"
 
 
-static GimpLayer * gimp_image_merge_layers (GimpImage     *image,
-                                            GimpContainer *container,
-                                            GSList        *merge_list,
-                                            GimpContext   *context,
-                                            GimpMergeType  merge_type,
-                                            const gchar   *undo_desc,
-                                            GimpProgress  *progress);
+static GimpLayer * gimp_image_merge_layers       (GimpImage     *image,
+                                                  GimpContainer *container,
+                                                  GSList        *merge_list,
+                                                  GimpContext   *context,
+                                                  GimpMergeType  merge_type,
+                                                  const gchar   *undo_desc,
+                                                  GimpProgress  *progress);
+static gboolean    gimp_image_merge_layer_covers (GimpLayer     *layer,
+                                                  gint           x1,
+                                                  gint           y1,
+                                                  gint           x2,
+                                                  gint           y2);
 
 
 /*  public functions  */
@@ -749,8 +756,21 @@ gimp_image_merge_layers (GimpImage     *image,
       gegl_node_link_many (source_node, offset_node, NULL);
     }
 
-  /*  Disconnect the bottom-layer node's input  */
-  last_node        = gimp_filter_get_node (GIMP_FILTER (bottom_layer));
+  /*  Find the topmost layer that fully covers the merged area, since
+   *  nothing below it can show through, and there is no need to render
+   *  the layers underneath it
+   */
+  for (layers = merge_list; layers; layers = g_slist_next (layers))
+    {
+      layer = layers->data;
+
+      if (layer == bottom_layer ||
+          gimp_image_merge_layer_covers (layer, x1, y1, x2, y2))
+        break;
+    }
+
+  /*  Disconnect that layer's node's input  */
+  last_node        = gimp_filter_get_node (GIMP_FILTER (layer));
   last_node_source = gegl_node_get_producer (last_node, "input", NULL);
 
   gegl_node_disconnect (last_node, "input");
@@ -761,7 +781,7 @@ gimp_image_merge_layers (GimpImage     *image,
                                GIMP_DRAWABLE (merge_layer)),
                              NULL, FALSE);
 
-  /*  Reconnect the bottom-layer node's input  */
+  /*  Reconnect the node's input  */
   if (last_node_source)
     gegl_node_link (last_node_source, last_node);
 
@@ -815,3 +835,43 @@ gimp_image_merge_layers (GimpImage     *image,
 
   return merge_layer;
 }
+
+static gboolean
+gimp_image_merge_layer_covers (GimpLayer *layer,
+                               gint       x1,
+                               gint       y1,
+                               gint       x2,
+                               gint       y2)
+{
+  GimpItem     *item     = GIMP_ITEM (layer);
+  GimpDrawable *drawable = GIMP_DRAWABLE (layer);
+  gint          off_x, off_y;
+
+  if (! gimp_item_get_visible (item)                      ||
+      gimp_drawable_has_alpha (drawable)                  ||
+      gimp_layer_get_mask (layer)                         ||
+      gimp_drawable_has_filters (drawable)                ||
+      gimp_drawable_get_floating_sel (drawable)           ||
+      gimp_layer_get_opacity (layer) != GIMP_OPACITY_OPAQUE ||
+      gimp_layer_get_real_composite_mode (layer) != GIMP_LAYER_COMPOSITE_UNION)
+    {
+      return FALSE;
+    }
+
+  switch (gimp_layer_get_mode (layer))
+    {
+    case GIMP_LAYER_MODE_NORMAL_LEGACY:
+    case GIMP_LAYER_MODE_NORMAL:
+      break;
+
+    default:
+      return FALSE;
+    }
+
+  gimp_item_get_offset (item, &off_x, &off_y);
+
+  return (off_x <= x1 &&
+          off_y <= y1 &&
+          off_x + gimp_item_get_width  (item) >= x2 &&
+          off_y + gimp_item_get_height (item) >= y2);
+}
@@ -22,12 +22,17 @@
 #include <gegl.h>
 
 #include "libgimpcolor/gimpcolor.h"
+#include "libgimpmath/gimpmath.h"
 
 #include "core-types.h"
 
 #include "gegl/gimp-babl.h"
 #include "gegl/gimp-gegl-loops.h"
+#include "gegl/gimptilehandlervalidate.h"
 
+#include "gimp-utils.h"
+#include "gimpasync.h"
+#include "gimpchunkiterator.h"
 #include "gimpimage.h"
 #include "gimpimage-color-profile.h"
 #include "gimpimage-preview.h"
@@ -36,6 +41,138 @@
 #include "gimpprojection.h"
 #include "gimptempbuf.h"
 
+#include "gimp-priorities.h"
+
+
+typedef struct
+{
+  const Babl        *format;
+  GeglBuffer        *buffer;
+  GeglRectangle      rect;
+  gdouble            scale;
+
+  GimpChunkIterator *iter;
+} PreviewData;
+
+
+/*  local function prototypes  */
+
+static PreviewData * preview_data_new          (const Babl   *format,
+                                                GeglBuffer   *buffer,
+                                                gint          width,
+                                                gint          height,
+                                                gdouble       scale);
+static void          preview_data_free         (PreviewData  *data);
+
+static void          gimp_image_preview_async_func (GimpAsync   *async,
+                                                    PreviewData *data);
+
+
+/*  private functions  */
+
+static PreviewData *
+preview_data_new (const Babl *format,
+                  GeglBuffer *buffer,
+                  gint        width,
+                  gint        height,
+                  gdouble     scale)
+{
+  PreviewData *data = g_slice_new (PreviewData);
+
+  data->format = format;
+  data->buffer = g_object_ref (buffer);
+  data->rect   = *GEGL_RECTANGLE (0, 0, width, height);
+  data->scale  = scale;
+
+  data->iter   = NULL;
+
+  return data;
+}
+
+static void
+preview_data_free (PreviewData *data)
+{
+  g_object_unref (data->buffer);
+
+  if (data->iter)
+    gimp_chunk_iterator_stop (data->iter, TRUE);
+
+  g_slice_free (PreviewData, data);
+}
+
+/*  renders the still-invalid parts of the projection in chunks, so that
+ *  the main loop can run in between, and only then samples the preview
+ *  from the buffer's mipmaps, which gegl regenerates only where the
+ *  projection changed.
+ */
+static void
+gimp_image_preview_async_func (GimpAsync   *async,
+                               PreviewData *data)
+{
+  GimpTileHandlerValidate *validate;
+  GimpTempBuf             *preview;
+
+  validate = gimp_tile_handler_validate_get_assigned (data->buffer);
+
+  if (validate)
+    {
+      if (! data->iter)
+        {
+          cairo_region_t        *region;
+          cairo_rectangle_int_t  rect;
+
+          rect.x      = floor (data->rect.x / data->scale);
+          rect.y      = floor (data->rect.y / data->scale);
+          rect.width  = ceil ((data->rect.x + data->rect.width)  /
+                              data->scale) - rect.x;
+          rect.height = ceil ((data->rect.y + data->rect.height) /
+                              data->scale) - rect.y;
+
+          region = cairo_region_copy (validate->dirty_region);
+
+          cairo_region_intersect_rectangle (region, &rect);
+
+          data->iter = gimp_chunk_iterator_new (region);
+        }
+
+      if (gimp_chunk_iterator_next (data->iter))
+        {
+          GeglRectangle rect;
+
+          gimp_tile_handler_validate_begin_validate (validate);
+
+          while (gimp_chunk_iterator_get_rect (data->iter, &rect))
+            {
+              gimp_tile_handler_validate_validate (validate,
+                                                   data->buffer, &rect,
+                                                   FALSE, FALSE);
+            }
+
+          gimp_tile_handler_validate_end_validate (validate);
+
+          return;
+        }
+
+      data->iter = NULL;
+    }
+
+  preview = gimp_temp_buf_new (data->rect.width, data->rect.height,
+                               data->format);
+
+  gegl_buffer_get (data->buffer, &data->rect, data->scale,
+                   gimp_temp_buf_get_format (preview),
+                   gimp_temp_buf_get_data (preview),
+                   GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_CLAMP);
+
+  preview_data_free (data);
+
+  gimp_async_finish_full (async,
+                          preview,
+                          (GDestroyNotify) gimp_temp_buf_unref);
+}
+
+
+/*  public functions  */
 
 const Babl *
 gimp_image_get_preview_format (GimpImage *image)
@@ -148,6 +285,34 @@ gimp_image_get_new_preview (GimpViewable *viewable,
   return buf;
 }
 
+GimpAsync *
+gimp_image_get_new_preview_async (GimpImage *image,
+                                  gint       width,
+                                  gint       height)
+{
+  PreviewData *data;
+  gdouble      scale_x;
+  gdouble      scale_y;
+
+  g_return_val_if_fail (GIMP_IS_IMAGE (image), NULL);
+  g_return_val_if_fail (width  > 0, NULL);
+  g_return_val_if_fail (height > 0, NULL);
+
+  scale_x = (gdouble) width  / (gdouble) gimp_image_get_width  (image);
+  scale_y = (gdouble) height / (gdouble) gimp_image_get_height (image);
+
+  data = preview_data_new (gimp_image_get_preview_format (image),
+                           gimp_pickable_get_buffer (GIMP_PICKABLE (image)),
+                           width, height,
+                           MIN (scale_x, scale_y));
+
+  return gimp_idle_run_async_full (
+    GIMP_PRIORITY_VIEWABLE_IDLE,
+    (GimpRunAsyncFunc) gimp_image_preview_async_func,
+    data,
+    (GDestroyNotify) preview_data_free);
+}
+
 GdkPixbuf *
 gimp_image_get_new_pixbuf (GimpViewable *viewable,
                            GimpContext  *context,
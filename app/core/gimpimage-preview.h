@@ -19,7 +19,11 @@
 #define __GIMP_IMAGE_PREVIEW_H__
 
 
-const Babl  * gimp_image_get_preview_format (GimpImage    *image);
+const Babl  * gimp_image_get_preview_format    (GimpImage    *image);
+
+GimpAsync   * gimp_image_get_new_preview_async (GimpImage    *image,
+                                                gint          width,
+                                                gint          height);
 
 
 /*
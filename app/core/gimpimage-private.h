@@ -82,6 +82,7 @@ struct _GimpImagePrivate
   GFile             *untitled_file;         /*  a file saying "Untitled"     */
 
   gboolean           xcf_compression;       /*  XCF compression enabled?     */
+  gboolean           xcf_zstd_compression;  /*  ... with zstd, not zlib?     */
 
   gint               dirty;                 /*  dirty flag -- # of ops       */
   gint64             dirty_time;            /*  time when image became dirty */
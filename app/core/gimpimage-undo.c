@@ -25,6 +25,7 @@
 #include "config/gimpcoreconfig.h"
 
 #include "gimp.h"
+#include "gimp-trace.h"
 #include "gimp-utils.h"
 #include "gimpimage.h"
 #include "gimpimage-private.h"
@@ -342,6 +343,10 @@ gimp_image_undo_group_end (GimpImage *image)
       /* Do it here, since undo_push doesn't emit this event while in
        * the middle of a group
        */
+      /*  the group's undos were added after it was pushed  */
+      gimp_undo_stack_undo_changed (private->undo_stack,
+                                    gimp_undo_stack_peek (private->undo_stack));
+
       gimp_image_undo_event (image, GIMP_UNDO_EVENT_UNDO_PUSHED,
                              gimp_undo_stack_peek (private->undo_stack));
 
@@ -398,11 +403,16 @@ gimp_image_undo_push (GimpImage     *image,
                                          args);
   va_end (args);
 
+  /*  constructing the undo is what copies the undone state  */
+  gimp_trace_begin ("undo", gimp_undo_type_to_name (undo_type));
+
   undo = (GimpUndo *) g_object_new_with_properties (object_type,
                                                     n_properties,
                                                     (const gchar **) names,
                                                     (const GValue *) values);
 
+  gimp_trace_end ();
+
   gimp_properties_free (n_properties, names, values);
 
   /*  nuke the redo stack  */
@@ -537,7 +547,8 @@ gimp_image_undo_free_space (GimpImage *image)
   if (gimp_container_get_n_children (container) <= min_undo_levels)
     return;
 
-  while ((gimp_object_get_memsize (GIMP_OBJECT (container), NULL) > undo_size) ||
+  while ((gimp_undo_stack_get_undos_memsize (private->undo_stack) >
+          undo_size) ||
          (gimp_container_get_n_children (container) > max_undo_levels))
     {
       GimpUndo *freed = gimp_undo_stack_free_bottom (private->undo_stack,
@@ -2667,6 +2667,7 @@ gimp_image_get_export_proc (GimpImage *image)
 gint
 gimp_image_get_xcf_version (GimpImage    *image,
                             gboolean      zlib_compression,
+                            gboolean      zstd_compression,
                             gint         *gimp_version,
                             const gchar **version_string,
                             gchar       **version_reason)
@@ -2843,6 +2844,14 @@ gimp_image_get_xcf_version (GimpImage    *image,
       version = MAX (8, version);
     }
 
+  /* need version 16 for zstd compression */
+  if (zstd_compression)
+    {
+      ADD_REASON (g_strdup_printf (_("Internal zstd compression was "
+                                     "added in %s"), "GIMP 3.0.0"));
+      version = MAX (16, version);
+    }
+
   /* if version is 10 (lots of new layer modes), go to version 11 with
    * 64 bit offsets right away
    */
@@ -2918,6 +2927,7 @@ gimp_image_get_xcf_version (GimpImage    *image,
       break;
     case 14:
     case 15:
+    case 16:
       if (gimp_version)   *gimp_version   = 300;
       if (version_string) *version_string = "GIMP 3.0";
       break;
@@ -2961,6 +2971,27 @@ gimp_image_get_xcf_compression (GimpImage *image)
   return GIMP_IMAGE_GET_PRIVATE (image)->xcf_compression;
 }
 
+/* whether XCF compression, when enabled, uses zstd instead of zlib.
+ * zstd-compressed files save and load considerably faster, but can only
+ * be read by GIMP versions built with zstd support.
+ */
+void
+gimp_image_set_xcf_zstd_compression (GimpImage *image,
+                                     gboolean   zstd_compression)
+{
+  g_return_if_fail (GIMP_IS_IMAGE (image));
+
+  GIMP_IMAGE_GET_PRIVATE (image)->xcf_zstd_compression = zstd_compression;
+}
+
+gboolean
+gimp_image_get_xcf_zstd_compression (GimpImage *image)
+{
+  g_return_val_if_fail (GIMP_IS_IMAGE (image), FALSE);
+
+  return GIMP_IMAGE_GET_PRIVATE (image)->xcf_zstd_compression;
+}
+
 void
 gimp_image_set_resolution (GimpImage *image,
                            gdouble    xresolution,
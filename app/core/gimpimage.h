@@ -182,6 +182,7 @@ void            gimp_image_exported              (GimpImage          *image,
 
 gint            gimp_image_get_xcf_version       (GimpImage          *image,
                                                   gboolean            zlib_compression,
+                                                  gboolean            zstd_compression,
                                                   gint               *gimp_version,
                                                   const gchar       **version_string,
                                                   gchar             **version_reason);
@@ -189,6 +190,11 @@ gint            gimp_image_get_xcf_version       (GimpImage          *image,
 void            gimp_image_set_xcf_compression   (GimpImage          *image,
                                                   gboolean            compression);
 gboolean        gimp_image_get_xcf_compression   (GimpImage          *image);
+void            gimp_image_set_xcf_zstd_compression
+                                                 (GimpImage          *image,
+                                                  gboolean            zstd_compression);
+gboolean        gimp_image_get_xcf_zstd_compression
+                                                 (GimpImage          *image);
 
 void            gimp_image_set_resolution        (GimpImage          *image,
                                                   gdouble             xres,
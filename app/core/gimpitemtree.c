@@ -60,6 +60,11 @@ struct _GimpItemTreePrivate
   GList      *selected_items;
 
   GHashTable *name_hash;
+
+  /*  maps base names to the highest number n, such that all of
+   *  "name #1" ... "name #n" are taken
+   */
+  GHashTable *number_hash;
 };
 
 #define GIMP_ITEM_TREE_GET_PRIVATE(object) \
@@ -86,6 +91,11 @@ static gint64   gimp_item_tree_get_memsize   (GimpObject   *object,
 static void     gimp_item_tree_uniquefy_name (GimpItemTree *tree,
                                               GimpItem     *item,
                                               const gchar  *new_name);
+static void     gimp_item_tree_remove_name   (GimpItemTree *tree,
+                                              const gchar  *name);
+static gchar  * gimp_item_tree_split_name    (const gchar  *name,
+                                              gint         *number,
+                                              gint         *precision);
 
 
 G_DEFINE_TYPE_WITH_PRIVATE (GimpItemTree, gimp_item_tree, GIMP_TYPE_OBJECT)
@@ -146,6 +156,8 @@ gimp_item_tree_init (GimpItemTree *tree)
   GimpItemTreePrivate *private = GIMP_ITEM_TREE_GET_PRIVATE (tree);
 
   private->name_hash      = g_hash_table_new (g_str_hash, g_str_equal);
+  private->number_hash    = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                   g_free, NULL);
   private->selected_items = NULL;
 }
 
@@ -182,6 +194,7 @@ gimp_item_tree_dispose (GObject *object)
 
   gimp_container_clear (tree->container);
   g_hash_table_remove_all (private->name_hash);
+  g_hash_table_remove_all (private->number_hash);
 
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
@@ -192,7 +205,8 @@ gimp_item_tree_finalize (GObject *object)
   GimpItemTree        *tree    = GIMP_ITEM_TREE (object);
   GimpItemTreePrivate *private = GIMP_ITEM_TREE_GET_PRIVATE (tree);
 
-  g_clear_pointer (&private->name_hash, g_hash_table_unref);
+  g_clear_pointer (&private->name_hash,   g_hash_table_unref);
+  g_clear_pointer (&private->number_hash, g_hash_table_unref);
   g_clear_object (&tree->container);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -590,8 +604,7 @@ gimp_item_tree_remove_item (GimpItemTree *tree,
 
   g_object_ref (item);
 
-  g_hash_table_remove (private->name_hash,
-                       gimp_object_get_name (item));
+  gimp_item_tree_remove_name (tree, gimp_object_get_name (item));
 
   children = gimp_viewable_get_children (GIMP_VIEWABLE (item));
 
@@ -601,8 +614,8 @@ gimp_item_tree_remove_item (GimpItemTree *tree,
 
       while (list)
         {
-          g_hash_table_remove (private->name_hash,
-                               gimp_object_get_name (list->data));
+          gimp_item_tree_remove_name (tree,
+                                      gimp_object_get_name (list->data));
 
           list = g_list_remove (list, list->data);
         }
@@ -766,8 +779,7 @@ gimp_item_tree_uniquefy_name (GimpItemTree *tree,
 
   if (new_name)
     {
-      g_hash_table_remove (private->name_hash,
-                           gimp_object_get_name (item));
+      gimp_item_tree_remove_name (tree, gimp_object_get_name (item));
 
       gimp_object_set_name (GIMP_OBJECT (item), new_name);
     }
@@ -783,32 +795,25 @@ gimp_item_tree_uniquefy_name (GimpItemTree *tree,
   if (g_hash_table_lookup (private->name_hash,
                            gimp_object_get_name (item)))
     {
-      gchar      *name        = g_strdup (gimp_object_get_name (item));
-      gchar      *new_name    = NULL;
-      gint        number      = 0;
-      gint        precision   = 1;
-      GRegex     *end_numbers = g_regex_new (" ?#([0-9]+)\\s*$", 0, 0, NULL);
-      GMatchInfo *match_info  = NULL;
-
-      if (g_regex_match (end_numbers, name, 0, &match_info))
-        {
-          gchar *match;
-          gint   start_pos;
-
-          match  = g_match_info_fetch (match_info, 1);
-          if (match && match[0] == '0')
-            {
-              precision = strlen (match);
-            }
-          number = atoi (match);
-          g_free (match);
+      gchar    *name;
+      gchar    *new_name = NULL;
+      gint      number;
+      gint      precision;
+      gint      taken    = 0;
+      gboolean  contiguous;
+
+      name = gimp_item_tree_split_name (gimp_object_get_name (item),
+                                        &number, &precision);
+
+      /*  skip the numbers we know are taken, instead of trying them all
+       *  again each time an item with the same name is added
+       */
+      if (precision == 1)
+        taken = GPOINTER_TO_INT (g_hash_table_lookup (private->number_hash,
+                                                      name));
 
-          g_match_info_fetch_pos (match_info, 0,
-                                  &start_pos, NULL);
-          name[start_pos] = '\0';
-        }
-      g_match_info_free (match_info);
-      g_regex_unref (end_numbers);
+      contiguous = number <= taken;
+      number     = MAX (number, taken);
 
       do
         {
@@ -823,7 +828,11 @@ gimp_item_tree_uniquefy_name (GimpItemTree *tree,
         }
       while (g_hash_table_lookup (private->name_hash, new_name));
 
-      g_free (name);
+      if (precision == 1 && contiguous)
+        g_hash_table_replace (private->number_hash,
+                              name, GINT_TO_POINTER (number));
+      else
+        g_free (name);
 
       gimp_object_take_name (GIMP_OBJECT (item), new_name);
     }
@@ -832,3 +841,76 @@ gimp_item_tree_uniquefy_name (GimpItemTree *tree,
                        (gpointer) gimp_object_get_name (item),
                        item);
 }
+
+static void
+gimp_item_tree_remove_name (GimpItemTree *tree,
+                            const gchar  *name)
+{
+  GimpItemTreePrivate *private = GIMP_ITEM_TREE_GET_PRIVATE (tree);
+  gchar               *base;
+  gint                 number;
+  gint                 precision;
+
+  g_hash_table_remove (private->name_hash, name);
+
+  if (! name || g_hash_table_size (private->number_hash) == 0)
+    return;
+
+  base = gimp_item_tree_split_name (name, &number, &precision);
+
+  if (number > 0 && precision == 1)
+    {
+      gint taken = GPOINTER_TO_INT (g_hash_table_lookup (private->number_hash,
+                                                         base));
+
+      if (number <= taken)
+        {
+          if (number > 1)
+            g_hash_table_replace (private->number_hash,
+                                  g_strdup (base),
+                                  GINT_TO_POINTER (number - 1));
+          else
+            g_hash_table_remove (private->number_hash, base);
+        }
+    }
+
+  g_free (base);
+}
+
+/*  splits "name #42" into "name", 42 and a precision of 2 digits, returns
+ *  a newly allocated copy of name and a number of 0 if there is no number
+ */
+static gchar *
+gimp_item_tree_split_name (const gchar *name,
+                           gint        *number,
+                           gint        *precision)
+{
+  gchar      *base        = g_strdup (name);
+  GRegex     *end_numbers = g_regex_new (" ?#([0-9]+)\\s*$", 0, 0, NULL);
+  GMatchInfo *match_info  = NULL;
+
+  *number    = 0;
+  *precision = 1;
+
+  if (g_regex_match (end_numbers, base, 0, &match_info))
+    {
+      gchar *match;
+      gint   start_pos;
+
+      match  = g_match_info_fetch (match_info, 1);
+      if (match && match[0] == '0')
+        {
+          *precision = strlen (match);
+        }
+      *number = atoi (match);
+      g_free (match);
+
+      g_match_info_fetch_pos (match_info, 0,
+                              &start_pos, NULL);
+      base[start_pos] = '\0';
+    }
+  g_match_info_free (match_info);
+  g_regex_unref (end_numbers);
+
+  return base;
+}
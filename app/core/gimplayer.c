@@ -280,6 +280,8 @@ static void       gimp_layer_layer_mask_update  (GimpDrawable       *layer_mask,
                                                  gint                width,
                                                  gint                height,
                                                  GimpLayer          *layer);
+static void       gimp_layer_apply_mask_buffer  (GeglBuffer         *mask_buffer,
+                                                 GeglBuffer         *dest_buffer);
 
 
 G_DEFINE_TYPE_WITH_CODE (GimpLayer, gimp_layer, GIMP_TYPE_DRAWABLE,
@@ -1738,6 +1740,12 @@ gimp_layer_real_convert_type (GimpLayer        *layer,
   GeglBuffer   *src_buffer;
   GeglBuffer   *dest_buffer;
 
+  dest_buffer =
+    gegl_buffer_new (GEGL_RECTANGLE (0, 0,
+                                     gimp_item_get_width  (GIMP_ITEM (layer)),
+                                     gimp_item_get_height (GIMP_ITEM (layer))),
+                     new_format);
+
   if (layer_dither_type == GEGL_DITHER_NONE)
     {
       src_buffer = g_object_ref (gimp_drawable_get_buffer (drawable));
@@ -1746,26 +1754,35 @@ gimp_layer_real_convert_type (GimpLayer        *layer,
     {
       gint bits;
 
+      bits = (babl_format_get_bytes_per_pixel (new_format) * 8 /
+              babl_format_get_n_components (new_format));
+
+      /*  without a profile conversion, dither straight into the new
+       *  buffer, instead of into a whole dithered copy in the old format
+       */
+      if (! dest_profile)
+        {
+          gimp_gegl_apply_dither (gimp_drawable_get_buffer (drawable),
+                                  NULL, NULL,
+                                  dest_buffer, 1 << bits, layer_dither_type);
+
+          gimp_drawable_set_buffer (drawable, push_undo, NULL, dest_buffer);
+          g_object_unref (dest_buffer);
+
+          return;
+        }
+
       src_buffer =
         gegl_buffer_new (GEGL_RECTANGLE (0, 0,
                                          gimp_item_get_width  (GIMP_ITEM (layer)),
                                          gimp_item_get_height (GIMP_ITEM (layer))),
                          gimp_drawable_get_format (drawable));
 
-      bits = (babl_format_get_bytes_per_pixel (new_format) * 8 /
-              babl_format_get_n_components (new_format));
-
       gimp_gegl_apply_dither (gimp_drawable_get_buffer (drawable),
                               NULL, NULL,
                               src_buffer, 1 << bits, layer_dither_type);
     }
 
-  dest_buffer =
-    gegl_buffer_new (GEGL_RECTANGLE (0, 0,
-                                     gimp_item_get_width  (GIMP_ITEM (layer)),
-                                     gimp_item_get_height (GIMP_ITEM (layer))),
-                     new_format);
-
   if (dest_profile)
     {
       if (! src_profile)
@@ -1783,9 +1800,11 @@ gimp_layer_real_convert_type (GimpLayer        *layer,
                              dest_buffer, NULL);
     }
 
+  /*  drop the dithered copy before the old buffer moves to the undo  */
+  g_object_unref (src_buffer);
+
   gimp_drawable_set_buffer (drawable, push_undo, NULL, dest_buffer);
 
-  g_object_unref (src_buffer);
   g_object_unref (dest_buffer);
 }
 
@@ -1837,6 +1856,63 @@ gimp_layer_layer_mask_update (GimpDrawable *drawable,
 }
 
 
+/*  multiplies the alpha of dest_buffer by mask_buffer, in place, leaving
+ *  the tiles under fully opaque mask tiles alone, so that they are neither
+ *  converted nor written, and stay shared with the undo copy
+ */
+static void
+gimp_layer_apply_mask_buffer (GeglBuffer *mask_buffer,
+                              GeglBuffer *dest_buffer)
+{
+  GeglBufferIterator *iter;
+  const Babl         *format;
+  cairo_region_t     *region;
+  guint8              opaque[MAX_CHANNELS * sizeof (gdouble)];
+  const gfloat        one = 1.0;
+  gint                bpp;
+  gint                n_rects;
+  gint                i;
+
+  format = gegl_buffer_get_format (mask_buffer);
+  bpp    = babl_format_get_bytes_per_pixel (format);
+
+  babl_process (babl_fish (babl_format ("Y float"), format), &one, opaque, 1);
+
+  region = cairo_region_create ();
+
+  iter = gegl_buffer_iterator_new (mask_buffer, NULL, 0, format,
+                                   GEGL_ACCESS_READ, GEGL_ABYSS_NONE, 1);
+
+  while (gegl_buffer_iterator_next (iter))
+    {
+      const guint8 *data = iter->items[0].data;
+
+      /*  the mask is uniform iff it's equal to itself, shifted by a pixel  */
+      if (! memcmp (data, opaque, bpp) &&
+          ! memcmp (data, data + bpp, (iter->length - 1) * bpp))
+        continue;
+
+      cairo_region_union_rectangle (
+        region, (const cairo_rectangle_int_t *) &iter->items[0].roi);
+    }
+
+  n_rects = cairo_region_num_rectangles (region);
+
+  for (i = 0; i < n_rects; i++)
+    {
+      cairo_rectangle_int_t rect;
+
+      cairo_region_get_rectangle (region, i, &rect);
+
+      gimp_gegl_apply_mask (mask_buffer, (const GeglRectangle *) &rect,
+                            dest_buffer, (const GeglRectangle *) &rect,
+                            1.0);
+    }
+
+  cairo_region_destroy (region);
+}
+
+
 /*  public functions  */
 
 void
@@ -2240,9 +2316,7 @@ gimp_layer_apply_mask (GimpLayer         *layer,
       mask_buffer = gimp_drawable_get_buffer (GIMP_DRAWABLE (mask));
       dest_buffer = gimp_drawable_get_buffer (GIMP_DRAWABLE (layer));
 
-      gimp_gegl_apply_opacity (gimp_drawable_get_buffer (GIMP_DRAWABLE (layer)),
-                               NULL, NULL, dest_buffer,
-                               mask_buffer, 0, 0, 1.0);
+      gimp_layer_apply_mask_buffer (mask_buffer, dest_buffer);
     }
 
   g_signal_handlers_disconnect_by_func (mask,
@@ -20,6 +20,8 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include <gdk-pixbuf/gdk-pixbuf.h>
 #include <gegl.h>
 
@@ -46,6 +48,17 @@
 
 #include "gimp-intl.h"
 
+#define PIXELS_PER_THREAD \
+  (/* each thread costs as much as */ 64.0 * 64.0 /* pixels */)
+
+#define EDGELS_PER_THREAD \
+  (/* each thread costs as much as */ 4096.0 /* edgels */)
+
+/* The context kept around a changed area, beyond the closing lengths,
+ * when the line art is only recomputed around it.
+ */
+#define INCREMENTAL_PADDING 32
+
 enum
 {
   COMPUTING_START,
@@ -78,6 +91,13 @@ struct _GimpLineArtPrivate
   GeglBuffer   *closed;
   gfloat       *distmap;
 
+  /* The parameters the closure was actually computed with. */
+  gboolean      closed_select_transparent;
+  guchar        closed_max_value;
+
+  /* The area of the input changed since the closure was computed. */
+  GeglRectangle dirty;
+
   /* Used in the closing step. */
   gboolean      select_transparent;
   gdouble       threshold;
@@ -91,18 +111,28 @@ struct _GimpLineArtPrivate
 
 typedef struct
 {
-  GeglBuffer  *buffer;
+  GeglBuffer    *buffer;
+
+  gboolean       select_transparent;
+  gdouble        threshold;
+  gint           spline_max_len;
+  gint           segment_max_len;
 
-  gboolean     select_transparent;
-  gdouble      threshold;
-  gint         spline_max_len;
-  gint         segment_max_len;
+  /* The previous closure, to only recompute it around the dirty area. */
+  GeglBuffer    *closed;
+  gfloat        *distmap;
+  gboolean       closed_select_transparent;
+  guchar         closed_max_value;
+  GeglRectangle  dirty;
 } LineArtData;
 
 typedef struct
 {
   GeglBuffer *closed;
   gfloat     *distmap;
+
+  gboolean    select_transparent;
+  guchar      max_value;
 } LineArtResult;
 
 static int DeltaX[4] = {+1, -1, 0, 0};
@@ -144,6 +174,50 @@ typedef struct _Edgel
   guint     next, previous;
 } Edgel;
 
+/* Data of the parallel parts of the closure. */
+
+typedef struct
+{
+  GeglBuffer *buffer;
+  GimpAsync  *async;
+
+  GMutex      mutex;
+  GSList     *bands;
+} EdgelExtractData;
+
+typedef struct
+{
+  gint    y;
+  GArray *edgels;
+} EdgelBand;
+
+typedef struct
+{
+  GArray       *set;
+  GeglBuffer   *buffer;
+  GHashTable   *edgel2index;
+  const gfloat *weights;
+  gint          mask_size;
+  gfloat       *smoothed_curvatures;
+  GimpAsync    *async;
+} EdgelSetData;
+
+typedef struct
+{
+  GeglBuffer   *mask;
+  gfloat       *normals;
+  gfloat       *curvatures;
+  const gfloat *smoothed_curvatures;
+  const gfloat *radii;
+  const gfloat *dist;
+  gfloat       *thickness;
+  gfloat        threshold;
+  gfloat        clamped_threshold;
+  gint          width;
+  gint          height;
+  GimpAsync    *async;
+} LineArtPixelsData;
+
 
 static void            gimp_line_art_finalize                  (GObject               *object);
 static void            gimp_line_art_set_property              (GObject                *object,
@@ -158,13 +232,29 @@ static void            gimp_line_art_get_property              (GObject
 /* Functions for asynchronous computation. */
 
 static void            gimp_line_art_compute                   (GimpLineArt            *line_art);
+static void            gimp_line_art_compute_area              (GimpLineArt            *line_art,
+                                                                const GeglRectangle    *dirty);
 static void            gimp_line_art_compute_cb                (GimpAsync              *async,
                                                                 GimpLineArt            *line_art);
 
 static GimpAsync     * gimp_line_art_prepare_async             (GimpLineArt            *line_art,
-                                                                gint                    priority);
+                                                                gint                    priority,
+                                                                GeglBuffer             *closed,
+                                                                gfloat                 *distmap,
+                                                                const GeglRectangle    *dirty);
 static void            gimp_line_art_prepare_async_func        (GimpAsync              *async,
                                                                 LineArtData            *data);
+static GeglBuffer    * gimp_line_art_close_data                (LineArtData            *data,
+                                                                GeglBuffer             *buffer,
+                                                                gboolean                select_transparent,
+                                                                guchar                  max_value,
+                                                                gfloat                **distmap,
+                                                                GimpAsync              *async);
+static GeglBuffer    * gimp_line_art_close_area                (LineArtData            *data,
+                                                                GeglBuffer             *buffer,
+                                                                gboolean                select_transparent,
+                                                                guchar                  max_value,
+                                                                GimpAsync              *async);
 static LineArtData   * line_art_data_new                       (GeglBuffer             *buffer,
                                                                 GimpLineArt            *line_art);
 static void            line_art_data_free                      (LineArtData            *data);
@@ -175,12 +265,21 @@ static void            line_art_result_free                    (LineArtResult
 static gboolean        gimp_line_art_idle                      (GimpLineArt            *line_art);
 static void            gimp_line_art_input_invalidate_preview  (GimpViewable           *viewable,
                                                                 GimpLineArt            *line_art);
+static void            gimp_line_art_input_update              (GimpDrawable           *drawable,
+                                                                gint                    x,
+                                                                gint                    y,
+                                                                gint                    width,
+                                                                gint                    height,
+                                                                GimpLineArt            *line_art);
 
 
 /* All actual computation functions. */
 
+static guchar          gimp_line_art_max_value                 (GeglBuffer             *buffer,
+                                                                GimpAsync              *async);
 static GeglBuffer    * gimp_line_art_close                     (GeglBuffer             *buffer,
                                                                 gboolean                select_transparent,
+                                                                guchar                  max_value,
                                                                 gdouble                 stroke_threshold,
                                                                 gint                    spline_max_length,
                                                                 gint                    segment_max_length,
@@ -200,14 +299,22 @@ static GeglBuffer    * gimp_line_art_close                     (GeglBuffer
 static void            gimp_lineart_denoise                    (GeglBuffer             *buffer,
                                                                 int                     size,
                                                                 GimpAsync              *async);
+static void            gimp_lineart_threshold_curvatures_area  (const GeglRectangle    *area,
+                                                                LineArtPixelsData      *data);
 static void            gimp_lineart_compute_normals_curvatures (GeglBuffer             *mask,
                                                                 gfloat                 *normals,
                                                                 gfloat                 *curvatures,
                                                                 gfloat                 *smoothed_curvatures,
                                                                 int                     normal_estimate_mask_size,
                                                                 GimpAsync              *async);
+static void            gimp_lineart_normalize_normals_area     (const GeglRectangle    *area,
+                                                                LineArtPixelsData      *data);
 static gfloat        * gimp_lineart_get_smooth_curvatures      (GArray                 *edgelset,
                                                                 GimpAsync              *async);
+static void            gimp_lineart_get_smooth_curvatures_range
+                                                               (gsize                   offset,
+                                                                gsize                   size,
+                                                                EdgelSetData           *data);
 static GArray        * gimp_lineart_curvature_extremums        (gfloat                 *curvatures,
                                                                 gfloat                 *smoothed_curvatures,
                                                                 gint                    curvatures_width,
@@ -241,6 +348,8 @@ static GArray        * gimp_lineart_line_segment_until_hit      (const GeglBuffe
                                                                  int                     size);
 static gfloat        * gimp_lineart_estimate_strokes_radii      (GeglBuffer             *mask,
                                                                  GimpAsync              *async);
+static void            gimp_lineart_estimate_strokes_radii_area (const GeglRectangle    *area,
+                                                                 LineArtPixelsData      *data);
 static void            gimp_line_art_simple_fill                (GeglBuffer             *buffer,
                                                                  gint                    x,
                                                                  gint                    y,
@@ -282,22 +391,39 @@ static glong      gimp_edgel_region_area          (const GeglBuffer   *mask,
 
 static GArray   * gimp_edgelset_new               (GeglBuffer         *buffer,
                                                    GimpAsync          *async);
-static void       gimp_edgelset_add               (GArray             *set,
+static void       gimp_edgelset_extract_area      (const GeglRectangle *area,
+                                                   EdgelExtractData   *data);
+static void       gimp_edgel_band_add             (EdgelBand          *band,
                                                    int                 x,
                                                    int                 y,
-                                                   Direction           direction,
+                                                   Direction           direction);
+static gint       gimp_edgel_band_cmp             (const EdgelBand    *band1,
+                                                   const EdgelBand    *band2);
+static void       gimp_edgelset_add               (GArray             *set,
+                                                   Edgel              *edgel,
                                                    GHashTable         *edgel2index);
 static void       gimp_edgelset_init_normals      (GArray             *set);
 static void       gimp_edgelset_smooth_normals    (GArray             *set,
                                                    int                 mask_size,
                                                    GimpAsync          *async);
+static void       gimp_edgelset_smooth_normals_range
+                                                  (gsize               offset,
+                                                   gsize               size,
+                                                   EdgelSetData       *data);
 static void       gimp_edgelset_compute_curvature (GArray             *set,
                                                    GimpAsync          *async);
+static void       gimp_edgelset_compute_curvature_range
+                                                  (gsize               offset,
+                                                   gsize               size,
+                                                   EdgelSetData       *data);
 
 static void       gimp_edgelset_build_graph       (GArray            *set,
                                                    GeglBuffer        *buffer,
                                                    GHashTable        *edgel2index,
                                                    GimpAsync         *async);
+static void       gimp_edgelset_build_graph_range (gsize              offset,
+                                                   gsize              size,
+                                                   EdgelSetData      *data);
 static void       gimp_edgelset_next8             (const GeglBuffer  *buffer,
                                                    Edgel             *it,
                                                    Edgel             *n);
@@ -507,6 +633,12 @@ gimp_line_art_set_input (GimpLineArt  *line_art,
           g_signal_connect (pickable, "invalidate-preview",
                             G_CALLBACK (gimp_line_art_input_invalidate_preview),
                             line_art);
+
+          /* only drawables tell us which area changed */
+          if (GIMP_IS_DRAWABLE (pickable))
+            g_signal_connect (pickable, "update",
+                              G_CALLBACK (gimp_line_art_input_update),
+                              line_art);
         }
     }
 }
@@ -575,6 +707,21 @@ gimp_line_art_get (GimpLineArt  *line_art,
 static void
 gimp_line_art_compute (GimpLineArt *line_art)
 {
+  gimp_line_art_compute_area (line_art, NULL);
+}
+
+/* Recomputes the closure, only around @dirty if it is not %NULL and we
+ * have a closure to update.
+ */
+static void
+gimp_line_art_compute_area (GimpLineArt         *line_art,
+                            const GeglRectangle *dirty)
+{
+  GeglBuffer *closed  = NULL;
+  gfloat     *distmap = NULL;
+
+  line_art->priv->dirty = *GEGL_RECTANGLE (0, 0, 0, 0);
+
   if (line_art->priv->frozen)
     {
       line_art->priv->compute_after_thaw = TRUE;
@@ -598,6 +745,12 @@ gimp_line_art_compute (GimpLineArt *line_art)
       line_art->priv->idle_id = 0;
     }
 
+  if (dirty && line_art->priv->closed)
+    {
+      closed  = g_steal_pointer (&line_art->priv->closed);
+      distmap = g_steal_pointer (&line_art->priv->distmap);
+    }
+
   g_clear_object (&line_art->priv->closed);
   g_clear_pointer (&line_art->priv->distmap, g_free);
 
@@ -611,8 +764,20 @@ gimp_line_art_compute (GimpLineArt *line_art)
         line_art->priv->input,
         G_CALLBACK (gimp_line_art_input_invalidate_preview),
         line_art);
-      line_art->priv->async = gimp_line_art_prepare_async (line_art, +1);
+      g_signal_handlers_block_by_func (
+        line_art->priv->input,
+        G_CALLBACK (gimp_line_art_input_update),
+        line_art);
+      line_art->priv->async = gimp_line_art_prepare_async (line_art, +1,
+                                                           closed, distmap,
+                                                           dirty);
+      closed  = NULL;
+      distmap = NULL;
       g_signal_emit (line_art, gimp_line_art_signals[COMPUTING_START], 0);
+      g_signal_handlers_unblock_by_func (
+        line_art->priv->input,
+        G_CALLBACK (gimp_line_art_input_update),
+        line_art);
       g_signal_handlers_unblock_by_func (
         line_art->priv->input,
         G_CALLBACK (gimp_line_art_input_invalidate_preview),
@@ -622,6 +787,9 @@ gimp_line_art_compute (GimpLineArt *line_art)
                                           (GimpAsyncCallback) gimp_line_art_compute_cb,
                                           line_art, line_art);
     }
+
+  g_clear_object (&closed);
+  g_free (distmap);
 }
 
 static void
@@ -640,6 +808,9 @@ gimp_line_art_compute_cb (GimpAsync   *async,
       line_art->priv->closed  = g_object_ref (result->closed);
       line_art->priv->distmap = result->distmap;
       result->distmap  = NULL;
+
+      line_art->priv->closed_select_transparent = result->select_transparent;
+      line_art->priv->closed_max_value          = result->max_value;
       g_signal_emit (line_art, gimp_line_art_signals[COMPUTING_END], 0);
     }
 
@@ -647,8 +818,11 @@ gimp_line_art_compute_cb (GimpAsync   *async,
 }
 
 static GimpAsync *
-gimp_line_art_prepare_async (GimpLineArt *line_art,
-                             gint         priority)
+gimp_line_art_prepare_async (GimpLineArt         *line_art,
+                             gint                 priority,
+                             GeglBuffer          *closed,
+                             gfloat              *distmap,
+                             const GeglRectangle *dirty)
 {
   GeglBuffer  *buffer;
   GimpAsync   *async;
@@ -665,6 +839,21 @@ gimp_line_art_prepare_async (GimpLineArt *line_art,
 
   g_object_unref (buffer);
 
+  /* the data takes ownership of the previous closure */
+  if (closed && dirty)
+    {
+      data->closed                    = closed;
+      data->distmap                   = distmap;
+      data->closed_select_transparent = line_art->priv->closed_select_transparent;
+      data->closed_max_value          = line_art->priv->closed_max_value;
+      data->dirty                     = *dirty;
+    }
+  else
+    {
+      g_clear_object (&closed);
+      g_free (distmap);
+    }
+
   async = gimp_parallel_run_async_full (
     priority,
     (GimpRunAsyncFunc) gimp_line_art_prepare_async_func,
@@ -677,13 +866,15 @@ static void
 gimp_line_art_prepare_async_func (GimpAsync   *async,
                                   LineArtData *data)
 {
-  GeglBuffer *buffer;
-  GeglBuffer *closed  = NULL;
-  gfloat     *distmap = NULL;
-  gint        buffer_x;
-  gint        buffer_y;
-  gboolean    has_alpha;
-  gboolean    select_transparent = FALSE;
+  GeglBuffer    *buffer;
+  GeglBuffer    *closed  = NULL;
+  gfloat        *distmap = NULL;
+  LineArtResult *result;
+  gint           buffer_x;
+  gint           buffer_y;
+  gboolean       has_alpha;
+  gboolean       select_transparent = FALSE;
+  guchar         max_value          = 0;
 
   has_alpha = babl_format_has_alpha (gegl_buffer_get_format (data->buffer));
 
@@ -745,42 +936,49 @@ gimp_line_art_prepare_async_func (GimpAsync   *async,
                              NULL);
     }
 
+  if (! select_transparent)
+    {
+      max_value = gimp_line_art_max_value (buffer, async);
+      if (gimp_async_is_stopped (async))
+        goto end;
+    }
+
   /* For smart selection, we generate a binarized image with close
    * regions, then run a composite selection with no threshold on
    * this intermediate buffer.
    */
   GIMP_TIMER_START();
 
-  closed = gimp_line_art_close (buffer,
-                                select_transparent,
-                                data->threshold,
-                                data->spline_max_len,
-                                data->segment_max_len,
-                                /*minimal_lineart_area,*/
-                                5,
-                                /*normal_estimate_mask_size,*/
-                                5,
-                                /*end_point_rate,*/
-                                0.85,
-                                /*spline_max_angle,*/
-                                90.0,
-                                /*end_point_connectivity,*/
-                                2,
-                                /*spline_roundness,*/
-                                1.0,
-                                /*allow_self_intersections,*/
-                                TRUE,
-                                /*created_regions_significant_area,*/
-                                4,
-                                /*created_regions_minimum_area,*/
-                                100,
-                                /*small_segments_from_spline_sources,*/
-                                TRUE,
-                                &distmap,
-                                async);
+  /* If only part of the input changed since the last closure, and the
+   * closure was computed the same way, only recompute it around the
+   * changed area.
+   */
+  if (data->closed                                          &&
+      data->distmap                                         &&
+      buffer             == data->buffer                    &&
+      select_transparent == data->closed_select_transparent &&
+      max_value          == data->closed_max_value          &&
+      gegl_rectangle_equal (gegl_buffer_get_extent (data->closed),
+                            gegl_buffer_get_extent (buffer)))
+    {
+      closed = gimp_line_art_close_area (data, buffer,
+                                         select_transparent, max_value,
+                                         async);
+
+      if (closed)
+        distmap = g_steal_pointer (&data->distmap);
+    }
+
+  if (! closed && ! gimp_async_is_stopped (async))
+    {
+      closed = gimp_line_art_close_data (data, buffer,
+                                         select_transparent, max_value,
+                                         &distmap, async);
+    }
 
   GIMP_TIMER_END("close line-art");
 
+ end:
   if (buffer != data->buffer)
     g_object_unref (buffer);
 
@@ -799,14 +997,143 @@ gimp_line_art_prepare_async_func (GimpAsync   *async,
           closed = buffer;
         }
 
+      result = line_art_result_new (closed, distmap);
+
+      result->select_transparent = select_transparent;
+      result->max_value          = max_value;
+
       gimp_async_finish_full (async,
-                              line_art_result_new (closed, distmap),
+                              result,
                               (GDestroyNotify) line_art_result_free);
     }
 
   line_art_data_free (data);
 }
 
+static GeglBuffer *
+gimp_line_art_close_data (LineArtData  *data,
+                          GeglBuffer   *buffer,
+                          gboolean      select_transparent,
+                          guchar        max_value,
+                          gfloat      **distmap,
+                          GimpAsync    *async)
+{
+  return gimp_line_art_close (buffer,
+                              select_transparent,
+                              max_value,
+                              data->threshold,
+                              data->spline_max_len,
+                              data->segment_max_len,
+                              /*minimal_lineart_area,*/
+                              5,
+                              /*normal_estimate_mask_size,*/
+                              5,
+                              /*end_point_rate,*/
+                              0.85,
+                              /*spline_max_angle,*/
+                              90.0,
+                              /*end_point_connectivity,*/
+                              2,
+                              /*spline_roundness,*/
+                              1.0,
+                              /*allow_self_intersections,*/
+                              TRUE,
+                              /*created_regions_significant_area,*/
+                              4,
+                              /*created_regions_minimum_area,*/
+                              100,
+                              /*small_segments_from_spline_sources,*/
+                              TRUE,
+                              distmap,
+                              async);
+}
+
+/* Updates the previous closure of @data around its dirty area.  The
+ * closure of the area, padded by the closing lengths, is computed with
+ * as much context around it, and pasted into a copy of the previous
+ * closure.  Returns %NULL if the area is too large to bother, or if
+ * @async was canceled.
+ */
+static GeglBuffer *
+gimp_line_art_close_area (LineArtData *data,
+                          GeglBuffer  *buffer,
+                          gboolean     select_transparent,
+                          guchar       max_value,
+                          GimpAsync   *async)
+{
+  const GeglRectangle *extent = gegl_buffer_get_extent (buffer);
+  GeglBuffer          *local;
+  GeglBuffer          *local_closed;
+  GeglBuffer          *closed;
+  gfloat              *local_distmap = NULL;
+  GeglRectangle        area;
+  GeglRectangle        context;
+  gint                 padding;
+  gint                 y;
+
+  padding = MAX (data->spline_max_len, data->segment_max_len) +
+            INCREMENTAL_PADDING;
+
+  gegl_rectangle_set (&area,
+                      data->dirty.x - padding,
+                      data->dirty.y - padding,
+                      data->dirty.width  + 2 * padding,
+                      data->dirty.height + 2 * padding);
+  if (! gegl_rectangle_intersect (&area, &area, extent))
+    return gimp_gegl_buffer_dup (data->closed);
+
+  gegl_rectangle_set (&context,
+                      area.x - padding,
+                      area.y - padding,
+                      area.width  + 2 * padding,
+                      area.height + 2 * padding);
+  gegl_rectangle_intersect (&context, &context, extent);
+
+  /* past a point, a full computation is just as fast */
+  if ((gdouble) context.width * context.height >
+      (gdouble) extent->width * extent->height / 2.0)
+    {
+      return NULL;
+    }
+
+  local = gegl_buffer_new (GEGL_RECTANGLE (0, 0,
+                                           context.width, context.height),
+                           gegl_buffer_get_format (buffer));
+  gimp_gegl_buffer_copy (buffer, &context, GEGL_ABYSS_NONE,
+                         local, GEGL_RECTANGLE (0, 0, 0, 0));
+
+  local_closed = gimp_line_art_close_data (data, local,
+                                           select_transparent, max_value,
+                                           &local_distmap, async);
+
+  g_object_unref (local);
+
+  if (gimp_async_is_stopped (async))
+    return NULL;
+
+  closed = gimp_gegl_buffer_dup (data->closed);
+
+  gimp_gegl_buffer_copy (local_closed,
+                         GEGL_RECTANGLE (area.x - context.x,
+                                         area.y - context.y,
+                                         area.width, area.height),
+                         GEGL_ABYSS_NONE,
+                         closed, &area);
+
+  for (y = area.y; y < area.y + area.height; y++)
+    {
+      memcpy (data->distmap + y * extent->width + area.x,
+              local_distmap +
+              (y - context.y) * context.width + (area.x - context.x),
+              area.width * sizeof (gfloat));
+    }
+
+  g_object_unref (local_closed);
+  g_free (local_distmap);
+
+  return closed;
+}
+
 static LineArtData *
 line_art_data_new (GeglBuffer  *buffer,
                    GimpLineArt *line_art)
@@ -819,6 +1146,12 @@ line_art_data_new (GeglBuffer  *buffer,
   data->spline_max_len     = line_art->priv->spline_max_len;
   data->segment_max_len    = line_art->priv->segment_max_len;
 
+  data->closed                    = NULL;
+  data->distmap                   = NULL;
+  data->closed_select_transparent = FALSE;
+  data->closed_max_value          = 0;
+  data->dirty                     = *GEGL_RECTANGLE (0, 0, 0, 0);
+
   return data;
 }
 
@@ -826,6 +1159,8 @@ static void
 line_art_data_free (LineArtData *data)
 {
   g_object_unref (data->buffer);
+  g_clear_object (&data->closed);
+  g_free (data->distmap);
 
   g_slice_free (LineArtData, data);
 }
@@ -836,7 +1171,7 @@ line_art_result_new (GeglBuffer *closed,
 {
   LineArtResult *data;
 
-  data = g_slice_new (LineArtResult);
+  data = g_slice_new0 (LineArtResult);
   data->closed  = closed;
   data->distmap = distmap;
 
@@ -857,7 +1192,17 @@ gimp_line_art_idle (GimpLineArt *line_art)
 {
   line_art->priv->idle_id = 0;
 
-  gimp_line_art_compute (line_art);
+  /* if we know which area changed, only recompute around it */
+  if (! gegl_rectangle_is_empty (&line_art->priv->dirty))
+    {
+      GeglRectangle dirty = line_art->priv->dirty;
+
+      gimp_line_art_compute_area (line_art, &dirty);
+    }
+  else
+    {
+      gimp_line_art_compute (line_art);
+    }
 
   return G_SOURCE_REMOVE;
 }
@@ -875,13 +1220,71 @@ gimp_line_art_input_invalidate_preview (GimpViewable *viewable,
     }
 }
 
+static void
+gimp_line_art_input_update (GimpDrawable *drawable,
+                            gint          x,
+                            gint          y,
+                            gint          width,
+                            gint          height,
+                            GimpLineArt  *line_art)
+{
+  GeglRectangle *dirty = &line_art->priv->dirty;
+
+  if (gegl_rectangle_is_empty (dirty))
+    gegl_rectangle_set (dirty, x, y, width, height);
+  else
+    gegl_rectangle_bounding_box (dirty, dirty,
+                                 GEGL_RECTANGLE (x, y, width, height));
+
+  gimp_line_art_input_invalidate_preview (GIMP_VIEWABLE (drawable), line_art);
+}
+
 /* All actual computation functions. */
 
+/* Returns the largest luminosity of @buffer, which gimp_line_art_close()
+ * needs before it can binarize any part of it.
+ */
+static guchar
+gimp_line_art_max_value (GeglBuffer *buffer,
+                         GimpAsync  *async)
+{
+  GeglBufferIterator *gi;
+  guchar              max_value = 0;
+
+  gi = gegl_buffer_iterator_new (buffer, NULL, 0, babl_format ("Y' u8"),
+                                 GEGL_ACCESS_READ, GEGL_ABYSS_NONE, 1);
+  while (gegl_buffer_iterator_next (gi))
+    {
+      guchar *data = (guchar*) gi->items[0].data;
+      gint    k;
+
+      if (gimp_async_is_canceled (async))
+        {
+          gegl_buffer_iterator_stop (gi);
+
+          gimp_async_abort (async);
+
+          return 0;
+        }
+
+      for (k = 0; k < gi->length; k++)
+        {
+          if (*data > max_value)
+            max_value = *data;
+          data++;
+        }
+    }
+
+  return max_value;
+}
+
 /**
  * gimp_line_art_close:
  * @buffer: the input #GeglBuffer.
  * @select_transparent: whether we binarize the alpha channel or the
  *                      luminosity.
+ * @max_value: the largest luminosity of the whole input, when
+ *             binarizing the luminosity.
  * @stroke_threshold: [0-1] threshold value for detecting stroke pixels
  *                    (higher values will detect more stroke pixels).
  * @spline_max_length: the maximum length for creating splines between
@@ -927,6 +1330,7 @@ gimp_line_art_input_invalidate_preview (GimpViewable *viewable,
 static GeglBuffer *
 gimp_line_art_close (GeglBuffer  *buffer,
                      gboolean     select_transparent,
+                     guchar       max_value,
                      gdouble      stroke_threshold,
                      gint         spline_max_length,
                      gint         segment_max_length,
@@ -947,7 +1351,6 @@ gimp_line_art_close (GeglBuffer  *buffer,
   GeglBufferIterator *gi;
   GeglBuffer         *closed  = NULL;
   GeglBuffer         *strokes = NULL;
-  guchar              max_value = 0;
   gint                width  = gegl_buffer_get_width (buffer);
   gint                height = gegl_buffer_get_height (buffer);
   gint                i;
@@ -965,34 +1368,6 @@ gimp_line_art_close (GeglBuffer  *buffer,
   gimp_gegl_buffer_copy (buffer, NULL, GEGL_ABYSS_NONE, strokes, NULL);
   gegl_buffer_set_format (strokes, babl_format ("Y' u8"));
 
-  if (! select_transparent)
-    {
-      /* Compute the biggest value */
-      gi = gegl_buffer_iterator_new (strokes, NULL, 0, NULL,
-                                     GEGL_ACCESS_READ, GEGL_ABYSS_NONE, 1);
-      while (gegl_buffer_iterator_next (gi))
-        {
-          guchar *data = (guchar*) gi->items[0].data;
-          gint    k;
-
-          if (gimp_async_is_canceled (async))
-            {
-              gegl_buffer_iterator_stop (gi);
-
-              gimp_async_abort (async);
-
-              goto end1;
-            }
-
-          for (k = 0; k < gi->length; k++)
-            {
-              if (*data > max_value)
-                max_value = *data;
-              data++;
-            }
-        }
-    }
-
   /* Make the image binary: 1 is stroke, 0 background */
   gi = gegl_buffer_iterator_new (strokes, NULL, 0, NULL,
                                  GEGL_ACCESS_READWRITE, GEGL_ABYSS_NONE, 1);
@@ -1043,6 +1418,7 @@ gimp_line_art_close (GeglBuffer  *buffer,
       gfloat      clamped_threshold;
       GList      *fill_pixels         = NULL;
       GList      *iter;
+      LineArtPixelsData pixels_data = { 0, };
 
       normals             = g_new0 (gfloat, width * height * 2);
       curvatures          = g_new0 (gfloat, width * height);
@@ -1061,25 +1437,26 @@ gimp_line_art_close (GeglBuffer  *buffer,
         goto end2;
       threshold = 1.0f - end_point_rate;
       clamped_threshold = MAX (0.25f, threshold);
-      for (i = 0; i < width; i++)
-        {
-          gint j;
 
-          if (gimp_async_is_canceled (async))
-            {
-              gimp_async_abort (async);
+      pixels_data.curvatures          = curvatures;
+      pixels_data.smoothed_curvatures = smoothed_curvatures;
+      pixels_data.radii               = radii;
+      pixels_data.threshold           = threshold;
+      pixels_data.clamped_threshold   = clamped_threshold;
+      pixels_data.width               = width;
+      pixels_data.async               = async;
 
-              goto end2;
-            }
+      gimp_parallel_distribute_area (
+        GEGL_RECTANGLE (0, 0, width, height), PIXELS_PER_THREAD,
+        GEGL_SPLIT_STRATEGY_AUTO,
+        (GeglParallelDistributeAreaFunc) gimp_lineart_threshold_curvatures_area,
+        &pixels_data);
 
-          for (j = 0; j < height; j++)
-            {
-              if (smoothed_curvatures[i + j * width] >= (threshold / MAX (1.0f, radii[i + j * width])) ||
-                  curvatures[i + j * width] >= clamped_threshold)
-                curvatures[i + j * width] = 1.0;
-              else
-                curvatures[i + j * width] = 0.0;
-            }
+      if (gimp_async_is_canceled (async))
+        {
+          gimp_async_abort (async);
+
+          goto end2;
         }
       g_clear_pointer (&radii, g_free);
 
@@ -1330,6 +1707,30 @@ gimp_line_art_close (GeglBuffer  *buffer,
   return closed;
 }
 
+static void
+gimp_lineart_threshold_curvatures_area (const GeglRectangle *area,
+                                        LineArtPixelsData   *data)
+{
+  gint width = data->width;
+  gint x;
+  gint y;
+
+  for (y = area->y; y < area->y + area->height; y++)
+    {
+      if (gimp_async_is_canceled (data->async))
+        return;
+
+      for (x = area->x; x < area->x + area->width; x++)
+        {
+          if (data->smoothed_curvatures[x + y * width] >= (data->threshold / MAX (1.0f, data->radii[x + y * width])) ||
+              data->curvatures[x + y * width] >= data->clamped_threshold)
+            data->curvatures[x + y * width] = 1.0;
+          else
+            data->curvatures[x + y * width] = 0.0;
+        }
+    }
+}
+
 static void
 gimp_lineart_denoise (GeglBuffer *buffer,
                       int         minimum_area,
@@ -1550,11 +1951,12 @@ gimp_lineart_compute_normals_curvatures (GeglBuffer *mask,
                                          int         normal_estimate_mask_size,
                                          GimpAsync  *async)
 {
-  gfloat  *edgels_curvatures  = NULL;
-  gfloat  *smoothed_curvature;
-  GArray  *es                 = NULL;
-  Edgel  **e;
-  gint     width              = gegl_buffer_get_width (mask);
+  gfloat            *edgels_curvatures  = NULL;
+  gfloat            *smoothed_curvature;
+  GArray            *es                 = NULL;
+  Edgel            **e;
+  gint               width              = gegl_buffer_get_width (mask);
+  LineArtPixelsData  pixels_data        = { 0, };
 
   es = gimp_edgelset_new (mask, async);
   if (gimp_async_is_stopped (async))
@@ -1588,22 +1990,22 @@ gimp_lineart_compute_normals_curvatures (GeglBuffer *mask,
                                                    curvatures[(*e)->x + (*e)->y * width]);
       e++;
     }
-  for (int y = 0; y < gegl_buffer_get_height (mask); ++y)
-    {
-      if (gimp_async_is_canceled (async))
-        {
-          gimp_async_abort (async);
 
-          goto end;
-        }
+  pixels_data.normals = normals;
+  pixels_data.width   = width;
+  pixels_data.async   = async;
 
-      for (int x = 0; x < gegl_buffer_get_width (mask); ++x)
-        {
-          const float _angle = atan2f (normals[(x + y * width) * 2 + 1],
-                                       normals[(x + y * width) * 2]);
-          normals[(x + y * width) * 2] = cosf (_angle);
-          normals[(x + y * width) * 2 + 1] = sinf (_angle);
-        }
+  gimp_parallel_distribute_area (
+    GEGL_RECTANGLE (0, 0, width, gegl_buffer_get_height (mask)),
+    PIXELS_PER_THREAD, GEGL_SPLIT_STRATEGY_AUTO,
+    (GeglParallelDistributeAreaFunc) gimp_lineart_normalize_normals_area,
+    &pixels_data);
+
+  if (gimp_async_is_canceled (async))
+    {
+      gimp_async_abort (async);
+
+      goto end;
     }
 
   /* Smooth curvatures on edgels, then take maximum on each pixel. */
@@ -1632,39 +2034,87 @@ gimp_lineart_compute_normals_curvatures (GeglBuffer *mask,
     g_array_free (es, TRUE);
 }
 
+static void
+gimp_lineart_normalize_normals_area (const GeglRectangle *area,
+                                     LineArtPixelsData   *data)
+{
+  gfloat *normals = data->normals;
+  gint    width   = data->width;
+  gint    x;
+  gint    y;
+
+  for (y = area->y; y < area->y + area->height; y++)
+    {
+      if (gimp_async_is_canceled (data->async))
+        return;
+
+      for (x = area->x; x < area->x + area->width; x++)
+        {
+          const float _angle = atan2f (normals[(x + y * width) * 2 + 1],
+                                       normals[(x + y * width) * 2]);
+          normals[(x + y * width) * 2] = cosf (_angle);
+          normals[(x + y * width) * 2 + 1] = sinf (_angle);
+        }
+    }
+}
+
 static gfloat *
 gimp_lineart_get_smooth_curvatures (GArray    *edgelset,
                                     GimpAsync *async)
 {
-  Edgel  **e;
-  gfloat  *smoothed_curvatures = g_new0 (gfloat, edgelset->len);
-  gfloat   weights[9];
-  gfloat   smoothed_curvature;
-  gfloat   weights_sum;
-  gint     idx = 0;
+  EdgelSetData  data  = { 0, };
+  gfloat       *smoothed_curvatures = g_new0 (gfloat, edgelset->len);
+  gfloat        weights[9];
 
   weights[0] = 1.0f;
   for (int i = 1; i <= 8; ++i)
     weights[i] = expf (-(i * i) / 30.0f);
 
-  e = (Edgel **) edgelset->data;
-  while (*e)
+  data.set                 = edgelset;
+  data.weights             = weights;
+  data.smoothed_curvatures = smoothed_curvatures;
+  data.async               = async;
+
+  gimp_parallel_distribute_range (
+    edgelset->len, EDGELS_PER_THREAD,
+    (GeglParallelDistributeRangeFunc) gimp_lineart_get_smooth_curvatures_range,
+    &data);
+
+  if (gimp_async_is_canceled (async))
     {
-      Edgel *edgel_before = g_array_index (edgelset, Edgel*, (*e)->previous);
-      Edgel *edgel_after  = g_array_index (edgelset, Edgel*, (*e)->next);
-      int    n = 5;
-      int    i = 1;
+      gimp_async_abort (async);
 
-      if (gimp_async_is_canceled (async))
-        {
-          gimp_async_abort (async);
+      g_free (smoothed_curvatures);
 
-          g_free (smoothed_curvatures);
+      return NULL;
+    }
 
-          return NULL;
-        }
+  return smoothed_curvatures;
+}
 
-      smoothed_curvature = (*e)->curvature;
+static void
+gimp_lineart_get_smooth_curvatures_range (gsize         offset,
+                                          gsize         size,
+                                          EdgelSetData *data)
+{
+  GArray       *edgelset = data->set;
+  const gfloat *weights  = data->weights;
+  gfloat        smoothed_curvature;
+  gfloat        weights_sum;
+  gsize         idx;
+
+  for (idx = offset; idx < offset + size; idx++)
+    {
+      Edgel *e            = g_array_index (edgelset, Edgel*, idx);
+      Edgel *edgel_before = g_array_index (edgelset, Edgel*, e->previous);
+      Edgel *edgel_after  = g_array_index (edgelset, Edgel*, e->next);
+      int    n = 5;
+      int    i = 1;
+
+      if (gimp_async_is_canceled (data->async))
+        return;
+
+      smoothed_curvature = e->curvature;
       weights_sum = weights[0];
       while (n-- && (edgel_after != edgel_before))
         {
@@ -1676,12 +2126,8 @@ gimp_lineart_get_smooth_curvatures (GArray    *edgelset,
           i++;
         }
       smoothed_curvature /= weights_sum;
-      smoothed_curvatures[idx++] = smoothed_curvature;
-
-      e++;
+      data->smoothed_curvatures[idx] = smoothed_curvature;
     }
-
-  return smoothed_curvatures;
 }
 
 /**
@@ -2293,7 +2739,7 @@ static gfloat *
 gimp_lineart_estimate_strokes_radii (GeglBuffer *mask,
                                      GimpAsync  *async)
 {
-  GeglBufferIterator *gi;
+  LineArtPixelsData   data;
   gfloat             *dist;
   gfloat             *thickness;
   GeglNode           *graph;
@@ -2321,7 +2767,43 @@ gimp_lineart_estimate_strokes_radii (GeglBuffer *mask,
   g_object_unref (graph);
 
   thickness = g_new0 (gfloat, width * height);
-  gi = gegl_buffer_iterator_new (mask, NULL, 0, NULL,
+
+  data.mask      = mask;
+  data.dist      = dist;
+  data.thickness = thickness;
+  data.width     = width;
+  data.height    = height;
+  data.async     = async;
+
+  /* Each stroke pixel only writes its own thickness, so the pixels can be
+   * processed in parallel.
+   */
+  gimp_parallel_distribute_area (
+    gegl_buffer_get_extent (mask), PIXELS_PER_THREAD,
+    GEGL_SPLIT_STRATEGY_AUTO,
+    (GeglParallelDistributeAreaFunc) gimp_lineart_estimate_strokes_radii_area,
+    &data);
+
+  if (gimp_async_is_canceled (async))
+    gimp_async_abort (async);
+
+  g_free (dist);
+
+  if (gimp_async_is_stopped (async))
+    g_clear_pointer (&thickness, g_free);
+
+  return thickness;
+}
+
+static void
+gimp_lineart_estimate_strokes_radii_area (const GeglRectangle *area,
+                                          LineArtPixelsData   *data)
+{
+  GeglBufferIterator *gi;
+  gint                width  = data->width;
+  gint                height = data->height;
+
+  gi = gegl_buffer_iterator_new (data->mask, area, 0, NULL,
                                  GEGL_ACCESS_READ, GEGL_ABYSS_NONE, 1);
   while (gegl_buffer_iterator_next (gi))
     {
@@ -2333,19 +2815,17 @@ gimp_lineart_estimate_strokes_radii (GeglBuffer *mask,
       gint    x;
       gint    y;
 
-      if (gimp_async_is_canceled (async))
+      if (gimp_async_is_canceled (data->async))
         {
           gegl_buffer_iterator_stop (gi);
 
-          gimp_async_abort (async);
-
-          goto end;
+          return;
         }
 
       for (y = starty; y < endy; y++)
         for (x = startx; x < endx; x++)
           {
-            if (*m && dist[x + y * width] == 1.0)
+            if (*m && data->dist[x + y * width] == 1.0)
               {
                 gint     dx = x;
                 gint     dy = y;
@@ -2363,14 +2843,14 @@ gimp_lineart_estimate_strokes_radii (GeglBuffer *mask,
                     neighbour_thicker = FALSE;
                     if (px >= 0)
                       {
-                        if ((nd = dist[px + dy * width]) > d)
+                        if ((nd = data->dist[px + dy * width]) > d)
                           {
                             d = nd;
                             dx = px;
                             neighbour_thicker = TRUE;
                             continue;
                           }
-                        if (py >= 0 && (nd = dist[px + py * width]) > d)
+                        if (py >= 0 && (nd = data->dist[px + py * width]) > d)
                           {
                             d = nd;
                             dx = px;
@@ -2378,7 +2858,7 @@ gimp_lineart_estimate_strokes_radii (GeglBuffer *mask,
                             neighbour_thicker = TRUE;
                             continue;
                           }
-                        if (ny < height && (nd = dist[px + ny * width]) > d)
+                        if (ny < height && (nd = data->dist[px + ny * width]) > d)
                           {
                             d = nd;
                             dx = px;
@@ -2389,14 +2869,14 @@ gimp_lineart_estimate_strokes_radii (GeglBuffer *mask,
                       }
                     if (nx < width)
                       {
-                        if ((nd = dist[nx + dy * width]) > d)
+                        if ((nd = data->dist[nx + dy * width]) > d)
                           {
                             d = nd;
                             dx = nx;
                             neighbour_thicker = TRUE;
                             continue;
                           }
-                        if (py >= 0 && (nd = dist[nx + py * width]) > d)
+                        if (py >= 0 && (nd = data->dist[nx + py * width]) > d)
                           {
                             d = nd;
                             dx = nx;
@@ -2404,7 +2884,7 @@ gimp_lineart_estimate_strokes_radii (GeglBuffer *mask,
                             neighbour_thicker = TRUE;
                             continue;
                           }
-                        if (ny < height && (nd = dist[nx + ny * width]) > d)
+                        if (ny < height && (nd = data->dist[nx + ny * width]) > d)
                           {
                             d = nd;
                             dx = nx;
@@ -2413,14 +2893,14 @@ gimp_lineart_estimate_strokes_radii (GeglBuffer *mask,
                             continue;
                           }
                       }
-                    if (py > 0 && (nd = dist[dx + py * width]) > d)
+                    if (py > 0 && (nd = data->dist[dx + py * width]) > d)
                       {
                         d = nd;
                         dy = py;
                         neighbour_thicker = TRUE;
                         continue;
                       }
-                    if (ny < height && (nd = dist[dx + ny * width]) > d)
+                    if (ny < height && (nd = data->dist[dx + ny * width]) > d)
                       {
                         d = nd;
                         dy = ny;
@@ -2428,19 +2908,11 @@ gimp_lineart_estimate_strokes_radii (GeglBuffer *mask,
                         continue;
                       }
                   }
-                thickness[(gint) x + (gint) y * width] = d;
+                data->thickness[(gint) x + (gint) y * width] = d;
               }
             m++;
           }
     }
-
- end:
-  g_free (dist);
-
-  if (gimp_async_is_stopped (async))
-    g_clear_pointer (&thickness, g_free);
-
-  return thickness;
 }
 
 static void
@@ -2667,11 +3139,12 @@ static GArray *
 gimp_edgelset_new (GeglBuffer *buffer,
                    GimpAsync  *async)
 {
-  GeglBufferIterator *gi;
-  GArray             *set;
-  GHashTable         *edgel2index;
-  gint                width  = gegl_buffer_get_width (buffer);
-  gint                height = gegl_buffer_get_height (buffer);
+  EdgelExtractData  data;
+  GArray           *set;
+  GHashTable       *edgel2index;
+  GSList           *list;
+  gint              width  = gegl_buffer_get_width (buffer);
+  gint              height = gegl_buffer_get_height (buffer);
 
   set = g_array_new (TRUE, TRUE, sizeof (Edgel *));
   g_array_set_clear_func (set, (GDestroyNotify) gimp_edgel_clear);
@@ -2682,15 +3155,97 @@ gimp_edgelset_new (GeglBuffer *buffer,
   edgel2index = g_hash_table_new ((GHashFunc) edgel2index_hash_fun,
                                   (GEqualFunc) edgel2index_equal_fun);
 
-  gi = gegl_buffer_iterator_new (buffer, GEGL_RECTANGLE (0, 0, width, height),
+  data.buffer = buffer;
+  data.async  = async;
+  data.bands  = NULL;
+  g_mutex_init (&data.mutex);
+
+  /* Extract the edgels of horizontal bands in parallel. */
+  gimp_parallel_distribute_area (
+    GEGL_RECTANGLE (0, 0, width, height), PIXELS_PER_THREAD,
+    GEGL_SPLIT_STRATEGY_HORIZONTAL,
+    (GeglParallelDistributeAreaFunc) gimp_edgelset_extract_area,
+    &data);
+
+  g_mutex_clear (&data.mutex);
+
+  /* The edgels of a pixel are always consecutive, so nothing computed
+   * from the set depends on the order of the bands.  Still, keep them
+   * from top to bottom so that the set is the same from run to run.
+   */
+  data.bands = g_slist_sort (data.bands, (GCompareFunc) gimp_edgel_band_cmp);
+
+  for (list = data.bands; list; list = g_slist_next (list))
+    {
+      EdgelBand *band = list->data;
+      gint       i;
+
+      for (i = 0; i < band->edgels->len; i++)
+        {
+          gimp_edgelset_add (set, g_array_index (band->edgels, Edgel *, i),
+                             edgel2index);
+        }
+
+      g_array_free (band->edgels, TRUE);
+      g_slice_free (EdgelBand, band);
+    }
+
+  g_slist_free (data.bands);
+
+  if (gimp_async_is_canceled (async))
+    {
+      gimp_async_abort (async);
+
+      goto end;
+    }
+
+  gimp_edgelset_build_graph (set, buffer, edgel2index, async);
+  if (gimp_async_is_stopped (async))
+    goto end;
+
+  gimp_edgelset_init_normals (set);
+
+ end:
+  g_hash_table_destroy (edgel2index);
+
+  if (gimp_async_is_stopped (async))
+    {
+      g_array_free (set, TRUE);
+      set = NULL;
+    }
+
+  return set;
+}
+
+static void
+gimp_edgelset_extract_area (const GeglRectangle *area,
+                            EdgelExtractData    *data)
+{
+  GeglBufferIterator *gi;
+  EdgelBand          *band;
+
+  band = g_slice_new (EdgelBand);
+
+  band->y      = area->y;
+  band->edgels = g_array_new (FALSE, FALSE, sizeof (Edgel *));
+
+  gi = gegl_buffer_iterator_new (data->buffer, area,
                                  0, NULL, GEGL_ACCESS_READ, GEGL_ABYSS_NONE, 5);
-  gegl_buffer_iterator_add (gi, buffer, GEGL_RECTANGLE (0, -1, width, height),
+  gegl_buffer_iterator_add (gi, data->buffer,
+                            GEGL_RECTANGLE (area->x, area->y - 1,
+                                            area->width, area->height),
                             0, NULL, GEGL_ACCESS_READ, GEGL_ABYSS_NONE);
-  gegl_buffer_iterator_add (gi, buffer, GEGL_RECTANGLE (0, 1, width, height),
+  gegl_buffer_iterator_add (gi, data->buffer,
+                            GEGL_RECTANGLE (area->x, area->y + 1,
+                                            area->width, area->height),
                             0, NULL, GEGL_ACCESS_READ, GEGL_ABYSS_NONE);
-  gegl_buffer_iterator_add (gi, buffer, GEGL_RECTANGLE (-1, 0, width, height),
+  gegl_buffer_iterator_add (gi, data->buffer,
+                            GEGL_RECTANGLE (area->x - 1, area->y,
+                                            area->width, area->height),
                             0, NULL, GEGL_ACCESS_READ, GEGL_ABYSS_NONE);
-  gegl_buffer_iterator_add (gi, buffer, GEGL_RECTANGLE (1, 0, width, height),
+  gegl_buffer_iterator_add (gi, data->buffer,
+                            GEGL_RECTANGLE (area->x + 1, area->y,
+                                            area->width, area->height),
                             0, NULL, GEGL_ACCESS_READ, GEGL_ABYSS_NONE);
   while (gegl_buffer_iterator_next (gi))
     {
@@ -2706,13 +3261,11 @@ gimp_edgelset_new (GeglBuffer *buffer,
       gint    x;
       gint    y;
 
-      if (gimp_async_is_canceled (async))
+      if (gimp_async_is_canceled (data->async))
         {
           gegl_buffer_iterator_stop (gi);
 
-          gimp_async_abort (async);
-
-          goto end;
+          break;
         }
 
       for (y = starty; y < endy; y++)
@@ -2721,13 +3274,13 @@ gimp_edgelset_new (GeglBuffer *buffer,
             if (*(p++))
               {
                 if (! *prevy)
-                  gimp_edgelset_add (set, x, y, YMinusDirection, edgel2index);
+                  gimp_edgel_band_add (band, x, y, YMinusDirection);
                 if (! *nexty)
-                  gimp_edgelset_add (set, x, y, YPlusDirection, edgel2index);
+                  gimp_edgel_band_add (band, x, y, YPlusDirection);
                 if (! *prevx)
-                  gimp_edgelset_add (set, x, y, XMinusDirection, edgel2index);
+                  gimp_edgel_band_add (band, x, y, XMinusDirection);
                 if (! *nextx)
-                  gimp_edgelset_add (set, x, y, XPlusDirection, edgel2index);
+                  gimp_edgel_band_add (band, x, y, XPlusDirection);
               }
             prevy++;
             nexty++;
@@ -2736,33 +3289,35 @@ gimp_edgelset_new (GeglBuffer *buffer,
           }
     }
 
-  gimp_edgelset_build_graph (set, buffer, edgel2index, async);
-  if (gimp_async_is_stopped (async))
-    goto end;
-
-  gimp_edgelset_init_normals (set);
+  g_mutex_lock (&data->mutex);
+  data->bands = g_slist_prepend (data->bands, band);
+  g_mutex_unlock (&data->mutex);
+}
 
- end:
-  g_hash_table_destroy (edgel2index);
+static void
+gimp_edgel_band_add (EdgelBand *band,
+                     int        x,
+                     int        y,
+                     Direction  direction)
+{
+  Edgel *edgel = gimp_edgel_new (x, y, direction);
 
-  if (gimp_async_is_stopped (async))
-    {
-      g_array_free (set, TRUE);
-      set = NULL;
-    }
+  g_array_append_val (band->edgels, edgel);
+}
 
-  return set;
+static gint
+gimp_edgel_band_cmp (const EdgelBand *band1,
+                     const EdgelBand *band2)
+{
+  return band1->y - band2->y;
 }
 
 static void
 gimp_edgelset_add (GArray     *set,
-                   int         x,
-                   int         y,
-                   Direction   direction,
+                   Edgel      *edgel,
                    GHashTable *edgel2index)
 {
-  Edgel         *edgel    = gimp_edgel_new (x, y, direction);
-  unsigned long  position = set->len;
+  unsigned long position = set->len;
 
   g_array_append_val (set, edgel);
   g_hash_table_insert (edgel2index, edgel, GUINT_TO_POINTER (position));
@@ -2790,9 +3345,8 @@ gimp_edgelset_smooth_normals (GArray    *set,
 {
   const gfloat sigma = mask_size * 0.775;
   const gfloat den   = 2 * sigma * sigma;
+  EdgelSetData data  = { 0, };
   gfloat       weights[65];
-  GimpVector2  smoothed_normal;
-  gint         i;
 
   gimp_assert (mask_size <= 65);
 
@@ -2800,20 +3354,43 @@ gimp_edgelset_smooth_normals (GArray    *set,
   for (int i = 1; i <= mask_size; ++i)
     weights[i] = expf (-(i * i) / den);
 
-  for (i = 0; i < set->len; i++)
+  data.set       = set;
+  data.weights   = weights;
+  data.mask_size = mask_size;
+  data.async     = async;
+
+  /* The smoothed normals only depend on the directions of the edgels, so
+   * the edgels can be processed in parallel.
+   */
+  gimp_parallel_distribute_range (
+    set->len, EDGELS_PER_THREAD,
+    (GeglParallelDistributeRangeFunc) gimp_edgelset_smooth_normals_range,
+    &data);
+
+  if (gimp_async_is_canceled (async))
+    gimp_async_abort (async);
+}
+
+static void
+gimp_edgelset_smooth_normals_range (gsize         offset,
+                                    gsize         size,
+                                    EdgelSetData *data)
+{
+  GArray       *set     = data->set;
+  const gfloat *weights = data->weights;
+  GimpVector2   smoothed_normal;
+  gsize         j;
+
+  for (j = offset; j < offset + size; j++)
     {
-      Edgel *it           = g_array_index (set, Edgel*, i);
+      Edgel *it           = g_array_index (set, Edgel*, j);
       Edgel *edgel_before = g_array_index (set, Edgel*, it->previous);
       Edgel *edgel_after  = g_array_index (set, Edgel*, it->next);
-      int    n = mask_size;
+      int    n = data->mask_size;
       int    i = 1;
 
-      if (gimp_async_is_canceled (async))
-        {
-          gimp_async_abort (async);
-
-          return;
-        }
+      if (gimp_async_is_canceled (data->async))
+        return;
 
       smoothed_normal = Direction2Normal[it->direction];
       while (n-- && (edgel_after != edgel_before))
@@ -2836,9 +3413,29 @@ static void
 gimp_edgelset_compute_curvature (GArray    *set,
                                  GimpAsync *async)
 {
-  gint i;
+  EdgelSetData data = { 0, };
+
+  data.set   = set;
+  data.async = async;
+
+  gimp_parallel_distribute_range (
+    set->len, EDGELS_PER_THREAD,
+    (GeglParallelDistributeRangeFunc) gimp_edgelset_compute_curvature_range,
+    &data);
+
+  if (gimp_async_is_canceled (async))
+    gimp_async_abort (async);
+}
+
+static void
+gimp_edgelset_compute_curvature_range (gsize         offset,
+                                       gsize         size,
+                                       EdgelSetData *data)
+{
+  GArray *set = data->set;
+  gsize   i;
 
-  for (i = 0; i < set->len; i++)
+  for (i = offset; i < offset + size; i++)
     {
       Edgel       *it       = g_array_index (set, Edgel*, i);
       Edgel       *previous = g_array_index (set, Edgel *, it->previous);
@@ -2852,12 +3449,8 @@ gimp_edgelset_compute_curvature (GArray    *set,
 
       it->curvature = (crossp > 0.0f) ? c : -c;
 
-      if (gimp_async_is_canceled (async))
-        {
-          gimp_async_abort (async);
-
-          return;
-        }
+      if (gimp_async_is_canceled (data->async))
+        return;
     }
 }
 
@@ -2867,26 +3460,48 @@ gimp_edgelset_build_graph (GArray     *set,
                            GHashTable *edgel2index,
                            GimpAsync  *async)
 {
-  Edgel edgel;
-  gint  i;
+  EdgelSetData data = { 0, };
+
+  data.set         = set;
+  data.buffer      = buffer;
+  data.edgel2index = edgel2index;
+  data.async       = async;
+
+  /* Each edgel is the next one of exactly one edgel, so no two threads
+   * write the same link.
+   */
+  gimp_parallel_distribute_range (
+    set->len, EDGELS_PER_THREAD,
+    (GeglParallelDistributeRangeFunc) gimp_edgelset_build_graph_range,
+    &data);
+
+  if (gimp_async_is_canceled (async))
+    gimp_async_abort (async);
+}
+
+static void
+gimp_edgelset_build_graph_range (gsize         offset,
+                                 gsize         size,
+                                 EdgelSetData *data)
+{
+  GArray *set = data->set;
+  Edgel   edgel;
+  gsize   i;
 
-  for (i = 0; i < set->len; i++)
+  for (i = offset; i < offset + size; i++)
     {
       Edgel *neighbor;
       Edgel *it = g_array_index (set, Edgel *, i);
       guint  neighbor_pos;
 
-      if (gimp_async_is_canceled (async))
-        {
-          gimp_async_abort (async);
-
-          return;
-        }
+      if (gimp_async_is_canceled (data->async))
+        return;
 
-      gimp_edgelset_next8 (buffer, it, &edgel);
+      gimp_edgelset_next8 (data->buffer, it, &edgel);
 
-      gimp_assert (g_hash_table_contains (edgel2index, &edgel));
-      neighbor_pos = GPOINTER_TO_UINT (g_hash_table_lookup (edgel2index, &edgel));
+      gimp_assert (g_hash_table_contains (data->edgel2index, &edgel));
+      neighbor_pos = GPOINTER_TO_UINT (g_hash_table_lookup (data->edgel2index,
+                                                            &edgel));
       it->next = neighbor_pos;
       neighbor = g_array_index (set, Edgel *, neighbor_pos);
       neighbor->previous = i;
@@ -70,14 +70,16 @@ gimp_pickable_auto_shrink (GimpPickable *pickable,
                            gint         *shrunk_height)
 {
   GeglBuffer      *buffer;
-  GeglRectangle    rect;
+  GeglRectangle    area;
+  GeglRectangle    tiles;
   ColorsEqualFunc  colors_equal_func;
   guchar           bgcolor[MAX_CHANNELS] = { 0, 0, 0, 0 };
   guchar          *buf = NULL;
   gint             x1, y1, x2, y2;
-  gint             width, height;
+  gint             bx1, by1, bx2, by2;
+  gint             tile_width, tile_height;
   const Babl      *format;
-  gint             x, y, abort;
+  gint             x, y, tx, ty;
   GimpAutoShrink   retval = GIMP_AUTO_SHRINK_UNSHRINKABLE;
 
   g_return_val_if_fail (GIMP_IS_PICKABLE (pickable), FALSE);
@@ -109,6 +111,12 @@ gimp_pickable_auto_shrink (GimpPickable *pickable,
   *shrunk_width  = x2 - x1;
   *shrunk_height = y2 - y1;
 
+  /* The content bounds start out empty */
+  bx1 = x2;
+  by1 = y2;
+  bx2 = x1;
+  by2 = y1;
+
   format = babl_format ("R'G'B'A u8");
 
   switch (gimp_pickable_guess_bgcolor (pickable, bgcolor,
@@ -125,90 +133,91 @@ gimp_pickable_auto_shrink (GimpPickable *pickable,
       break;
     }
 
-  width  = x2 - x1;
-  height = y2 - y1;
-
-  /* The following could be optimized further by processing
-   * the smaller side first instead of defaulting to width    --Sven
-   */
+  g_object_get (buffer,
+                "tile-width",  &tile_width,
+                "tile-height", &tile_height,
+                NULL);
 
-  buf = g_malloc (MAX (width, height) * 4);
+  gegl_rectangle_set (&area, x1, y1, x2 - x1, y2 - y1);
+  gegl_rectangle_align_to_buffer (&tiles, &area, buffer,
+                                  GEGL_RECTANGLE_ALIGNMENT_SUPERSET);
 
-  /* Check how many of the top lines are uniform/transparent. */
-  rect.x      = x1;
-  rect.y      = 0;
-  rect.width  = width;
-  rect.height = 1;
+  buf = g_malloc (tile_width * tile_height * 4);
 
-  abort = FALSE;
-  for (y = y1; y < y2 && !abort; y++)
+  /* Grow the bounds of the non-uniform/non-transparent content tile by
+   * tile. Tiles which are uniform are handled at once, tiles which lie
+   * within the content found so far are not read at all, and of the
+   * other tiles, only the pixels outside the content are checked.
+   */
+  for (ty = tiles.y; ty < tiles.y + tiles.height; ty += tile_height)
     {
-      rect.y = y;
-      gegl_buffer_get (buffer, &rect, 1.0, format, buf,
-                       GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
-      for (x = 0; x < width && !abort; x++)
-        abort = ! colors_equal_func (bgcolor, buf + x * 4);
+      for (tx = tiles.x; tx < tiles.x + tiles.width; tx += tile_width)
+        {
+          GeglRectangle tile;
+
+          if (! gegl_rectangle_intersect (&tile,
+                                          GEGL_RECTANGLE (tx, ty,
+                                                          tile_width,
+                                                          tile_height),
+                                          &area))
+            continue;
+
+          if (tile.x >= bx1 && tile.x + tile.width  <= bx2 &&
+              tile.y >= by1 && tile.y + tile.height <= by2)
+            continue;
+
+          gegl_buffer_get (buffer, &tile, 1.0, format, buf,
+                           GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
+
+          /* the tile is uniform iff it's equal to itself, shifted by a pixel */
+          if (! memcmp (buf, buf + 4, (tile.width * tile.height - 1) * 4))
+            {
+              if (! colors_equal_func (bgcolor, buf))
+                {
+                  bx1 = MIN (bx1, tile.x);
+                  by1 = MIN (by1, tile.y);
+                  bx2 = MAX (bx2, tile.x + tile.width);
+                  by2 = MAX (by2, tile.y + tile.height);
+                }
+
+              continue;
+            }
+
+          for (y = tile.y; y < tile.y + tile.height; y++)
+            {
+              guchar *row = buf + (y - tile.y) * tile.width * 4;
+
+              for (x = tile.x; x < tile.x + tile.width; x++)
+                {
+                  if (y >= by1 && y < by2 && x >= bx1 && x < bx2)
+                    {
+                      /* skip the content found so far */
+                      x = bx2 - 1;
+                      continue;
+                    }
+
+                  if (! colors_equal_func (bgcolor, row + (x - tile.x) * 4))
+                    {
+                      bx1 = MIN (bx1, x);
+                      by1 = MIN (by1, y);
+                      bx2 = MAX (bx2, x + 1);
+                      by2 = MAX (by2, y + 1);
+                    }
+                }
+            }
+        }
     }
-  if (y == y2 && !abort)
+
+  if (bx1 >= bx2 || by1 >= by2)
     {
       retval = GIMP_AUTO_SHRINK_EMPTY;
       goto FINISH;
     }
-  y1 = y - 1;
-
-  /* Check how many of the bottom lines are uniform/transparent. */
-  rect.x      = x1;
-  rect.y      = 0;
-  rect.width  = width;
-  rect.height = 1;
-
-  abort = FALSE;
-  for (y = y2; y > y1 && !abort; y--)
-    {
-      rect.y = y - 1;
-      gegl_buffer_get (buffer, &rect, 1.0, format, buf,
-                       GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
-      for (x = 0; x < width && !abort; x++)
-        abort = ! colors_equal_func  (bgcolor, buf + x * 4);
-    }
-  y2 = y + 1;
 
-  /* compute a new height for the next operations */
-  height = y2 - y1;
-
-  /* Check how many of the left lines are uniform/transparent. */
-  rect.x      = 0;
-  rect.y      = y1;
-  rect.width  = 1;
-  rect.height = height;
-
-  abort = FALSE;
-  for (x = x1; x < x2 && !abort; x++)
-    {
-      rect.x = x;
-      gegl_buffer_get (buffer, &rect, 1.0, format, buf,
-                       GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
-      for (y = 0; y < height && !abort; y++)
-        abort = ! colors_equal_func (bgcolor, buf + y * 4);
-    }
-  x1 = x - 1;
-
-  /* Check how many of the right lines are uniform/transparent. */
-  rect.x      = 0;
-  rect.y      = y1;
-  rect.width  = 1;
-  rect.height = height;
-
-  abort = FALSE;
-  for (x = x2; x > x1 && !abort; x--)
-    {
-      rect.x = x - 1;
-      gegl_buffer_get (buffer, &rect, 1.0, format, buf,
-                       GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
-      for (y = 0; y < height && !abort; y++)
-        abort = ! colors_equal_func (bgcolor, buf + y * 4);
-    }
-  x2 = x + 1;
+  x1 = bx1;
+  y1 = by1;
+  x2 = bx2;
+  y2 = by2;
 
   if (x1      != start_x     ||
       y1      != start_y     ||
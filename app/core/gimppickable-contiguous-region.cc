@@ -18,6 +18,7 @@
 #include "config.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include <cairo.h>
 #include <gegl.h>
@@ -32,6 +33,7 @@ extern "C"
 #include "core-types.h"
 
 #include "gegl/gimp-babl.h"
+#include "gegl/gimp-gegl-utils.h"
 
 #include "gimp-parallel.h"
 #include "gimp-utils.h" /* GIMP_TIMER */
@@ -39,6 +41,7 @@ extern "C"
 #include "gimplineart.h"
 #include "gimppickable.h"
 #include "gimppickable-contiguous-region.h"
+#include "gimpviewable.h"
 
 
 #define EPSILON 1e-6
@@ -46,6 +49,14 @@ extern "C"
 #define PIXELS_PER_THREAD \
   (/* each thread costs as much as */ 64.0 * 64.0 /* pixels */)
 
+/*  the number of rows the flood fill classifies at once  */
+#define CONTIGUOUS_BAND_HEIGHT 64
+
+/*  the number of regions remembered per pickable  */
+#define CONTIGUOUS_CACHE_SIZE  4
+
+#define CONTIGUOUS_CACHE_KEY   "gimp-pickable-contiguous-region-cache"
+
 
 typedef struct
 {
@@ -54,6 +65,60 @@ typedef struct
   gint   level;
 } BorderPixel;
 
+typedef struct
+{
+  gint y;
+  gint x1;
+  gint x2;
+} ContiguousSegment;
+
+typedef struct
+{
+  guint32 *candidates; /* pixels within threshold, not yet visited   */
+  guint32 *selected;   /* pixels of the region                        */
+  gint     x1;         /* the columns of the region, x2 < x1 if none  */
+  gint     x2;
+} ContiguousBand;
+
+typedef struct
+{
+  GeglBuffer          *src_buffer;
+  const Babl          *format;
+  const GeglRectangle *extent;
+  const gfloat        *col;
+  gint                 n_components;
+  gboolean             has_alpha;
+  gboolean             select_transparent;
+  GimpSelectCriterion  select_criterion;
+  gboolean             antialias;
+  gfloat               threshold;
+
+  gint                 stride;
+  gint                 n_bands;
+  ContiguousBand      *bands;
+} ContiguousMap;
+
+typedef struct
+{
+  GeglRectangle        extent;
+  const Babl          *format;
+  gboolean             antialias;
+  gfloat               threshold;
+  gboolean             select_transparent;
+  GimpSelectCriterion  select_criterion;
+  gboolean             diagonal_neighbors;
+  gfloat               col[MAX_CHANNELS];
+  gint                 n_components;
+
+  GeglBuffer          *mask_buffer;
+} ContiguousRegion;
+
+typedef struct
+{
+  GimpPickable        *pickable;
+  GQueue               regions; /* most recently used first */
+} ContiguousCache;
+
 
 /*  local function prototypes  */
 
@@ -69,37 +134,43 @@ static gfloat   pixel_difference          (const gfloat        *col1,
                                            gboolean             has_alpha,
                                            gboolean             select_transparent,
                                            GimpSelectCriterion  select_criterion);
-static void     push_segment              (GQueue              *segment_queue,
+static ContiguousCache *
+                contiguous_cache_get      (GimpPickable        *pickable);
+static void     contiguous_cache_free     (ContiguousCache     *cache);
+static void     contiguous_cache_clear    (ContiguousCache     *cache);
+static void     contiguous_cache_invalidate_preview
+                                          (GimpViewable        *viewable,
+                                           ContiguousCache     *cache);
+static GeglBuffer *
+                contiguous_cache_lookup   (ContiguousCache     *cache,
+                                           const ContiguousRegion *key,
+                                           gint                 x,
+                                           gint                 y);
+static void     contiguous_cache_insert   (ContiguousCache     *cache,
+                                           const ContiguousRegion *key,
+                                           GeglBuffer          *mask_buffer);
+
+static inline gboolean
+                bitmap_test               (const guint32       *row,
+                                           gint                 x);
+static void     bitmap_set_range          (guint32             *row,
+                                           gint                 x1,
+                                           gint                 x2,
+                                           gboolean             value);
+static void     contiguous_map_classify_band
+                                          (ContiguousMap       *map,
+                                           gint                 band);
+static ContiguousBand *
+                contiguous_map_get_band   (ContiguousMap       *map,
                                            gint                 y,
-                                           gint                 old_y,
-                                           gint                 start,
-                                           gint                 end,
-                                           gint                 new_y,
-                                           gint                 new_start,
-                                           gint                 new_end);
-static void     pop_segment               (GQueue              *segment_queue,
-                                           gint                *y,
-                                           gint                *old_y,
-                                           gint                *start,
-                                           gint                *end);
-static gboolean find_contiguous_segment   (const gfloat        *col,
-                                           GeglBuffer          *src_buffer,
-                                           GeglSampler         *src_sampler,
-                                           const GeglRectangle *src_extent,
-                                           GeglBuffer          *mask_buffer,
-                                           const Babl          *src_format,
-                                           const Babl          *mask_format,
-                                           gint                 n_components,
-                                           gboolean             has_alpha,
-                                           gboolean             select_transparent,
-                                           GimpSelectCriterion  select_criterion,
-                                           gboolean             antialias,
-                                           gfloat               threshold,
-                                           gint                 initial_x,
-                                           gint                 initial_y,
-                                           gint                *start,
-                                           gint                *end,
-                                           gfloat              *row);
+                                           gint                *row);
+static void     contiguous_map_write_band (ContiguousMap       *map,
+                                           gint                 band,
+                                           GeglBuffer          *mask_buffer);
+static void     push_segment              (GArray              *segment_stack,
+                                           gint                 y,
+                                           gint                 x1,
+                                           gint                 x2);
 static void     find_contiguous_region    (GeglBuffer          *src_buffer,
                                            GeglBuffer          *mask_buffer,
                                            const Babl          *format,
@@ -168,11 +239,33 @@ gimp_pickable_contiguous_region_by_seed (GimpPickable        *pickable,
 
   extent = *gegl_buffer_get_extent (src_buffer);
 
-  mask_buffer = gegl_buffer_new (&extent, babl_format ("Y float"));
-
   if (x >= extent.x && x < (extent.x + extent.width) &&
       y >= extent.y && y < (extent.y + extent.height))
     {
+      ContiguousCache  *cache = contiguous_cache_get (pickable);
+      ContiguousRegion  key   = {};
+
+      key.extent             = extent;
+      key.format             = format;
+      key.antialias          = antialias;
+      key.threshold          = threshold;
+      key.select_transparent = select_transparent;
+      key.select_criterion   = select_criterion;
+      key.diagonal_neighbors = diagonal_neighbors;
+      key.n_components       = n_components;
+
+      memcpy (key.col, start_col, n_components * sizeof (gfloat));
+
+      if (cache)
+        {
+          mask_buffer = contiguous_cache_lookup (cache, &key, x, y);
+
+          if (mask_buffer)
+            return mask_buffer;
+        }
+
+      mask_buffer = gegl_buffer_new (&extent, babl_format ("Y float"));
+
       GIMP_TIMER_START();
 
       find_contiguous_region (src_buffer, mask_buffer,
@@ -182,6 +275,13 @@ gimp_pickable_contiguous_region_by_seed (GimpPickable        *pickable,
                               x, y, start_col);
 
       GIMP_TIMER_END("foo");
+
+      if (cache)
+        contiguous_cache_insert (cache, &key, mask_buffer);
+    }
+  else
+    {
+      mask_buffer = gegl_buffer_new (&extent, babl_format ("Y float"));
     }
 
   return mask_buffer;
@@ -825,178 +925,344 @@ pixel_difference (const gfloat        *col1,
     }
 }
 
-static void
-push_segment (GQueue *segment_queue,
-              gint    y,
-              gint    old_y,
-              gint    start,
-              gint    end,
-              gint    new_y,
-              gint    new_start,
-              gint    new_end)
+static ContiguousCache *
+contiguous_cache_get (GimpPickable *pickable)
 {
-  /* To avoid excessive memory allocation (y, old_y, start, end) tuples are
-   * stored in interleaved format:
-   *
-   * [y1] [old_y1] [start1] [end1] [y2] [old_y2] [start2] [end2]
+  ContiguousCache *cache;
+
+  /*  the cache is dropped whenever the pickable changes, which we can
+   *  only tell for viewables
    */
+  if (! GIMP_IS_VIEWABLE (pickable))
+    return NULL;
+
+  cache = (ContiguousCache *) g_object_get_data (G_OBJECT (pickable),
+                                                 CONTIGUOUS_CACHE_KEY);
 
-  if (new_y != old_y)
+  if (! cache)
     {
-      /* If the new segment's y-coordinate is different than the old (source)
-       * segment's y-coordinate, push the entire segment.
-       */
-      g_queue_push_tail (segment_queue, GINT_TO_POINTER (new_y));
-      g_queue_push_tail (segment_queue, GINT_TO_POINTER (y));
-      g_queue_push_tail (segment_queue, GINT_TO_POINTER (new_start));
-      g_queue_push_tail (segment_queue, GINT_TO_POINTER (new_end));
+      cache = g_slice_new0 (ContiguousCache);
+
+      cache->pickable = pickable;
+      g_queue_init (&cache->regions);
+
+      g_signal_connect (pickable, "invalidate-preview",
+                        G_CALLBACK (contiguous_cache_invalidate_preview),
+                        cache);
+
+      g_object_set_data_full (G_OBJECT (pickable), CONTIGUOUS_CACHE_KEY,
+                              cache, (GDestroyNotify) contiguous_cache_free);
     }
-  else
+
+  return cache;
+}
+
+static void
+contiguous_cache_free (ContiguousCache *cache)
+{
+  g_signal_handlers_disconnect_by_func (
+    cache->pickable,
+    (gpointer) contiguous_cache_invalidate_preview,
+    cache);
+
+  contiguous_cache_clear (cache);
+
+  g_slice_free (ContiguousCache, cache);
+}
+
+static void
+contiguous_cache_clear (ContiguousCache *cache)
+{
+  ContiguousRegion *region;
+
+  while ((region = (ContiguousRegion *) g_queue_pop_head (&cache->regions)))
     {
-      /* Otherwise, only push the set-difference between the new segment and
-       * the source segment (since we've already scanned the source segment.)
-       * Note that the `+ 1` and `- 1` terms of the end/start coordinates below
-       * are only necessary when `diagonal_neighbors` is on (and otherwise make
-       * the segments slightly larger than necessary), but, meh...
-       */
-      if (new_start < start)
-        {
-          g_queue_push_tail (segment_queue, GINT_TO_POINTER (new_y));
-          g_queue_push_tail (segment_queue, GINT_TO_POINTER (y));
-          g_queue_push_tail (segment_queue, GINT_TO_POINTER (new_start));
-          g_queue_push_tail (segment_queue, GINT_TO_POINTER (start + 1));
-        }
+      g_object_unref (region->mask_buffer);
+
+      g_slice_free (ContiguousRegion, region);
+    }
+}
+
+static void
+contiguous_cache_invalidate_preview (GimpViewable    *viewable,
+                                     ContiguousCache *cache)
+{
+  contiguous_cache_clear (cache);
+}
 
-      if (new_end > end)
+static GeglBuffer *
+contiguous_cache_lookup (ContiguousCache        *cache,
+                         const ContiguousRegion *key,
+                         gint                    x,
+                         gint                    y)
+{
+  GList *list;
+
+  for (list = cache->regions.head; list; list = g_list_next (list))
+    {
+      ContiguousRegion *region = (ContiguousRegion *) list->data;
+      gfloat            value;
+
+      if (! gegl_rectangle_equal (&region->extent, &key->extent) ||
+          region->format             != key->format             ||
+          region->antialias          != key->antialias          ||
+          region->threshold          != key->threshold          ||
+          region->select_transparent != key->select_transparent ||
+          region->select_criterion   != key->select_criterion   ||
+          region->diagonal_neighbors != key->diagonal_neighbors ||
+          memcmp (region->col, key->col,
+                  key->n_components * sizeof (gfloat)))
         {
-          g_queue_push_tail (segment_queue, GINT_TO_POINTER (new_y));
-          g_queue_push_tail (segment_queue, GINT_TO_POINTER (y));
-          g_queue_push_tail (segment_queue, GINT_TO_POINTER (end - 1));
-          g_queue_push_tail (segment_queue, GINT_TO_POINTER (new_end));
+          continue;
         }
+
+      /*  a seed of the same color inside a region we already have belongs
+       *  to the very same region
+       */
+      gegl_buffer_get (region->mask_buffer, GEGL_RECTANGLE (x, y, 1, 1), 1.0,
+                       babl_format ("Y float"), &value,
+                       GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
+
+      if (value == 0.0)
+        continue;
+
+      g_queue_unlink (&cache->regions, list);
+      g_queue_push_head_link (&cache->regions, list);
+
+      return gimp_gegl_buffer_dup (region->mask_buffer);
     }
+
+  return NULL;
 }
 
 static void
-pop_segment (GQueue *segment_queue,
-             gint   *y,
-             gint   *old_y,
-             gint   *start,
-             gint   *end)
+contiguous_cache_insert (ContiguousCache        *cache,
+                         const ContiguousRegion *key,
+                         GeglBuffer             *mask_buffer)
 {
-  *y     = GPOINTER_TO_INT (g_queue_pop_head (segment_queue));
-  *old_y = GPOINTER_TO_INT (g_queue_pop_head (segment_queue));
-  *start = GPOINTER_TO_INT (g_queue_pop_head (segment_queue));
-  *end   = GPOINTER_TO_INT (g_queue_pop_head (segment_queue));
+  ContiguousRegion *region;
+
+  if (g_queue_get_length (&cache->regions) == CONTIGUOUS_CACHE_SIZE)
+    {
+      region = (ContiguousRegion *) g_queue_pop_tail (&cache->regions);
+
+      g_object_unref (region->mask_buffer);
+
+      g_slice_free (ContiguousRegion, region);
+    }
+
+  region = g_slice_new (ContiguousRegion);
+
+  *region = *key;
+
+  /*  the caller owns the mask it gets, so keep a copy of our own  */
+  region->mask_buffer = gimp_gegl_buffer_dup (mask_buffer);
+
+  g_queue_push_head (&cache->regions, region);
 }
 
-/* #define FETCH_ROW 1 */
-
-static gboolean
-find_contiguous_segment (const gfloat        *col,
-                         GeglBuffer          *src_buffer,
-                         GeglSampler         *src_sampler,
-                         const GeglRectangle *src_extent,
-                         GeglBuffer          *mask_buffer,
-                         const Babl          *src_format,
-                         const Babl          *mask_format,
-                         gint                 n_components,
-                         gboolean             has_alpha,
-                         gboolean             select_transparent,
-                         GimpSelectCriterion  select_criterion,
-                         gboolean             antialias,
-                         gfloat               threshold,
-                         gint                 initial_x,
-                         gint                 initial_y,
-                         gint                *start,
-                         gint                *end,
-                         gfloat              *row)
+static inline gboolean
+bitmap_test (const guint32 *row,
+             gint           x)
 {
-  gfloat *s;
-  gfloat  mask_row_buf[src_extent->width];
-  gfloat *mask_row = mask_row_buf - src_extent->x;
-  gfloat  diff;
-
-#ifdef FETCH_ROW
-  gegl_buffer_get (src_buffer, GEGL_RECTANGLE (0, initial_y, width, 1), 1.0,
-                   src_format,
-                   row, GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
-  s = row + initial_x * n_components;
-#else
-  s = (gfloat *) g_alloca (n_components * sizeof (gfloat));
-
-  gegl_sampler_get (src_sampler,
-                    initial_x, initial_y, NULL, s, GEGL_ABYSS_NONE);
-#endif
-
-  diff = pixel_difference (col, s, antialias, threshold,
-                           n_components, has_alpha, select_transparent,
-                           select_criterion);
-
-  /* check the starting pixel */
-  if (! diff)
-    return FALSE;
-
-  mask_row[initial_x] = diff;
-
-  *start = initial_x - 1;
-#ifdef FETCH_ROW
-  s = row + *start * n_components;
-#endif
-
-  while (*start >= src_extent->x)
+  return (row[x >> 5] >> (x & 31)) & 1;
+}
+
+static void
+bitmap_set_range (guint32  *row,
+                  gint      x1,
+                  gint      x2,
+                  gboolean  value)
+{
+  gint i;
+
+  /*  x1 and x2 are inclusive  */
+  for (i = x1 >> 5; i <= x2 >> 5; i++)
     {
-#ifndef FETCH_ROW
-      gegl_sampler_get (src_sampler,
-                        *start, initial_y, NULL, s, GEGL_ABYSS_NONE);
-#endif
-
-      diff = pixel_difference (col, s, antialias, threshold,
-                               n_components, has_alpha, select_transparent,
-                               select_criterion);
-      if (diff == 0.0)
-        break;
-
-      mask_row[*start] = diff;
-
-      (*start)--;
-#ifdef FETCH_ROW
-      s -= n_components;
-#endif
+      guint32 mask = 0xffffffff;
+
+      if (i == x1 >> 5)
+        mask &= 0xffffffff << (x1 & 31);
+
+      if (i == x2 >> 5)
+        mask &= 0xffffffff >> (31 - (x2 & 31));
+
+      if (value)
+        row[i] |= mask;
+      else
+        row[i] &= ~mask;
     }
+}
+
+static void
+contiguous_map_classify_band (ContiguousMap *map,
+                              gint           band)
+{
+  ContiguousBand *b = &map->bands[band];
+  GeglRectangle   area;
+  gint            stride;
+
+  area.x      = map->extent->x;
+  area.y      = map->extent->y + band * CONTIGUOUS_BAND_HEIGHT;
+  area.width  = map->extent->width;
+  area.height = MIN (CONTIGUOUS_BAND_HEIGHT,
+                     map->extent->y + map->extent->height - area.y);
 
-  *end = initial_x + 1;
-#ifdef FETCH_ROW
-  s = row + *end * n_components;
-#endif
+  stride = map->stride;
 
-  while (*end < src_extent->x + src_extent->width)
+  b->candidates = g_new0 (guint32, stride * area.height);
+  b->selected   = g_new0 (guint32, stride * area.height);
+  b->x1         = area.width;
+  b->x2         = -1;
+
+  /*  each thread gets whole rows, so that no two threads write to the
+   *  same word
+   */
+  gegl_parallel_distribute_area (
+    &area, PIXELS_PER_THREAD, GEGL_SPLIT_STRATEGY_HORIZONTAL,
+    [=] (const GeglRectangle *area)
     {
-#ifndef FETCH_ROW
-      gegl_sampler_get (src_sampler,
-                        *end, initial_y, NULL, s, GEGL_ABYSS_NONE);
-#endif
-
-      diff = pixel_difference (col, s, antialias, threshold,
-                               n_components, has_alpha, select_transparent,
-                               select_criterion);
-      if (diff == 0.0)
-        break;
-
-      mask_row[*end] = diff;
-
-      (*end)++;
-#ifdef FETCH_ROW
-      s += n_components;
-#endif
-    }
+      GeglBufferIterator *iter;
+
+      iter = gegl_buffer_iterator_new (map->src_buffer,
+                                       area, 0, map->format,
+                                       GEGL_ACCESS_READ, GEGL_ABYSS_NONE, 1);
+
+      while (gegl_buffer_iterator_next (iter))
+        {
+          const GeglRectangle *roi = &iter->items[0].roi;
+          const gfloat        *src = (const gfloat *) iter->items[0].data;
+          gint                 x0  = roi->x - map->extent->x;
+          gint                 x;
+          gint                 y;
+
+          for (y = 0; y < roi->height; y++)
+            {
+              guint32 *candidates;
+
+              candidates = b->candidates +
+                           (roi->y + y - map->extent->y -
+                            band * CONTIGUOUS_BAND_HEIGHT) * stride;
+
+              for (x = x0; x < x0 + roi->width; x++)
+                {
+                  if (pixel_difference (map->col, src,
+                                        map->antialias,
+                                        map->threshold,
+                                        map->n_components,
+                                        map->has_alpha,
+                                        map->select_transparent,
+                                        map->select_criterion))
+                    {
+                      candidates[x >> 5] |= (guint32) 1 << (x & 31);
+                    }
+
+                  src += map->n_components;
+                }
+            }
+        }
+    });
+}
+
+static ContiguousBand *
+contiguous_map_get_band (ContiguousMap *map,
+                         gint           y,
+                         gint          *row)
+{
+  gint band = y / CONTIGUOUS_BAND_HEIGHT;
+
+  if (! map->bands[band].candidates)
+    contiguous_map_classify_band (map, band);
+
+  *row = (y - band * CONTIGUOUS_BAND_HEIGHT) * map->stride;
+
+  return &map->bands[band];
+}
+
+static void
+contiguous_map_write_band (ContiguousMap *map,
+                           gint           band,
+                           GeglBuffer    *mask_buffer)
+{
+  const ContiguousBand *b = &map->bands[band];
+  GeglRectangle         area;
+  gint                  stride;
+
+  if (! b->candidates || b->x2 < b->x1)
+    return;
+
+  area.x      = map->extent->x + b->x1;
+  area.y      = map->extent->y + band * CONTIGUOUS_BAND_HEIGHT;
+  area.width  = b->x2 - b->x1 + 1;
+  area.height = MIN (CONTIGUOUS_BAND_HEIGHT,
+                     map->extent->y + map->extent->height - area.y);
+
+  stride = map->stride;
+
+  /*  the mask is only written where the region is, since it may already
+   *  contain other regions
+   */
+  gegl_parallel_distribute_area (
+    &area, PIXELS_PER_THREAD, GEGL_SPLIT_STRATEGY_HORIZONTAL,
+    [=] (const GeglRectangle *area)
+    {
+      GeglBufferIterator *iter;
+
+      iter = gegl_buffer_iterator_new (map->src_buffer,
+                                       area, 0, map->format,
+                                       GEGL_ACCESS_READ, GEGL_ABYSS_NONE, 2);
+
+      gegl_buffer_iterator_add (iter, mask_buffer,
+                                area, 0, babl_format ("Y float"),
+                                GEGL_ACCESS_READWRITE, GEGL_ABYSS_NONE);
+
+      while (gegl_buffer_iterator_next (iter))
+        {
+          const GeglRectangle *roi  = &iter->items[0].roi;
+          const gfloat        *src  = (const gfloat *) iter->items[0].data;
+          gfloat              *dest = (      gfloat *) iter->items[1].data;
+          gint                 x0   = roi->x - map->extent->x;
+          gint                 x;
+          gint                 y;
+
+          for (y = 0; y < roi->height; y++)
+            {
+              const guint32 *selected;
 
-  gegl_buffer_set (mask_buffer, GEGL_RECTANGLE (*start + 1, initial_y,
-                                                *end - *start - 1, 1),
-                   0, mask_format, &mask_row[*start + 1],
-                   GEGL_AUTO_ROWSTRIDE);
+              selected = b->selected +
+                         (roi->y + y - map->extent->y -
+                          band * CONTIGUOUS_BAND_HEIGHT) * stride;
 
-  return TRUE;
+              for (x = x0; x < x0 + roi->width; x++)
+                {
+                  if (bitmap_test (selected, x))
+                    {
+                      *dest = pixel_difference (map->col, src,
+                                                map->antialias,
+                                                map->threshold,
+                                                map->n_components,
+                                                map->has_alpha,
+                                                map->select_transparent,
+                                                map->select_criterion);
+                    }
+
+                  src += map->n_components;
+                  dest++;
+                }
+            }
+        }
+    });
+}
+
+static void
+push_segment (GArray *segment_stack,
+              gint    y,
+              gint    x1,
+              gint    x2)
+{
+  ContiguousSegment segment = { y, x1, x2 };
+
+  g_array_append_val (segment_stack, segment);
 }
 
 static void
@@ -1014,107 +1280,140 @@ find_contiguous_region (GeglBuffer          *src_buffer,
                         gint                 y,
                         const gfloat        *col)
 {
-  const Babl          *mask_format = babl_format ("Y float");
-  GeglSampler         *src_sampler;
-  const GeglRectangle *src_extent;
-  gint                 old_y;
-  gint                 start, end;
-  gint                 new_start, new_end;
-  GQueue              *segment_queue;
-  gfloat              *row = NULL;
+  ContiguousMap  map;
+  GArray        *segment_stack;
+  gint           width;
+  gint           height;
+  gint           band;
+
+  /*  the fill runs in three steps: the pixels of each band of rows are
+   *  classified in parallel, into a bitmap of pixels within threshold,
+   *  the first time the fill reaches the band; the fill itself then only
+   *  walks the bitmap; and finally, the mask is written in parallel for
+   *  the pixels the fill reached.  the result is the same as that of
+   *  sampling each pixel from the fill.
+   */
 
-  src_extent = gegl_buffer_get_extent (src_buffer);
+  map.src_buffer         = src_buffer;
+  map.format             = format;
+  map.extent             = gegl_buffer_get_extent (src_buffer);
+  map.col                = col;
+  map.n_components       = n_components;
+  map.has_alpha          = has_alpha;
+  map.select_transparent = select_transparent;
+  map.select_criterion   = select_criterion;
+  map.antialias          = antialias;
+  map.threshold          = threshold;
 
-#ifdef FETCH_ROW
-  row = g_new (gfloat, src_extent->width * n_components);
-#endif
+  width  = map.extent->width;
+  height = map.extent->height;
 
-  src_sampler = gegl_buffer_sampler_new (src_buffer,
-                                         format, GEGL_SAMPLER_NEAREST);
+  map.stride  = (width + 31) / 32;
+  map.n_bands = (height + CONTIGUOUS_BAND_HEIGHT - 1) / CONTIGUOUS_BAND_HEIGHT;
+  map.bands   = g_new0 (ContiguousBand, map.n_bands);
 
-  segment_queue = g_queue_new ();
+  segment_stack = g_array_new (FALSE, FALSE, sizeof (ContiguousSegment));
 
-  push_segment (segment_queue,
-                y, /* dummy values: */ -1, 0, 0,
-                y, x - 1, x + 1);
+  push_segment (segment_stack,
+                y - map.extent->y,
+                x - map.extent->x, x - map.extent->x);
 
-  do
+  while (segment_stack->len > 0)
     {
-      pop_segment (segment_queue,
-                   &y, &old_y, &start, &end);
+      ContiguousSegment  segment;
+      ContiguousBand    *b;
+      guint32           *candidates;
+      guint32           *selected;
+      gint               row;
 
-      for (x = start + 1; x < end; x++)
-        {
-          gfloat val;
+      segment = g_array_index (segment_stack, ContiguousSegment,
+                               segment_stack->len - 1);
+      g_array_set_size (segment_stack, segment_stack->len - 1);
+
+      b = contiguous_map_get_band (&map, segment.y, &row);
+
+      candidates = b->candidates + row;
+      selected   = b->selected   + row;
 
-          gegl_buffer_get (mask_buffer, GEGL_RECTANGLE (x, y, 1, 1), 1.0,
-                           mask_format, &val, GEGL_AUTO_ROWSTRIDE,
-                           GEGL_ABYSS_NONE);
+      for (x = segment.x1; x <= segment.x2; x++)
+        {
+          gint start;
+          gint end;
 
-          if (val != 0.0)
+          if (! candidates[x >> 5])
             {
-              /* If the current pixel is selected, then we've already visited
-               * the next pixel.  (Note that we assume that the maximal image
-               * width is sufficiently low that `x` won't overflow.)
-               */
-              x++;
+              /*  skip to the next word  */
+              x |= 31;
               continue;
             }
 
-          if (! find_contiguous_segment (col,
-                                         src_buffer, src_sampler, src_extent,
-                                         mask_buffer,
-                                         format, mask_format,
-                                         n_components,
-                                         has_alpha,
-                                         select_transparent, select_criterion,
-                                         antialias, threshold, x, y,
-                                         &new_start, &new_end,
-                                         row))
+          if (! bitmap_test (candidates, x))
             continue;
 
-          /* We can skip directly to `new_end + 1` on the next iteration, since
-           * we've just selected all pixels in the range `[x, new_end)`, and
-           * the pixel at `new_end` is above threshold.  (Note that we assume
-           * that the maximal image width is sufficiently low that `x` won't
-           * overflow.)
-           */
-          x = new_end;
+          start = x;
 
-          if (diagonal_neighbors)
+          while (start > 0)
             {
-              if (new_start >= src_extent->x)
-                new_start--;
-
-              if (new_end < src_extent->x + src_extent->width)
-                new_end++;
+              if (! (start & 31) && candidates[(start >> 5) - 1] == 0xffffffff)
+                start -= 32;
+              else if (bitmap_test (candidates, start - 1))
+                start--;
+              else
+                break;
             }
 
-          if (y + 1 < src_extent->y + src_extent->height)
+          /*  the bits past the end of each row are never set, so whole
+           *  words are always within the row
+           */
+          end = x;
+
+          while (end + 1 < width)
             {
-              push_segment (segment_queue,
-                            y, old_y, start, end,
-                            y + 1, new_start, new_end);
+              if (! ((end + 1) & 31) && candidates[(end + 1) >> 5] == 0xffffffff)
+                end += 32;
+              else if (bitmap_test (candidates, end + 1))
+                end++;
+              else
+                break;
             }
 
-          if (y - 1 >= src_extent->y)
+          /*  clearing the candidates marks the segment as visited  */
+          bitmap_set_range (candidates, start, end, FALSE);
+          bitmap_set_range (selected,   start, end, TRUE);
+
+          b->x1 = MIN (b->x1, start);
+          b->x2 = MAX (b->x2, end);
+
+          /*  the pixel at `end + 1` is not a candidate, so we can skip
+           *  directly to `end + 2` on the next iteration
+           */
+          x = end + 1;
+
+          if (diagonal_neighbors)
             {
-              push_segment (segment_queue,
-                            y, old_y, start, end,
-                            y - 1, new_start, new_end);
+              start = MAX (start - 1, 0);
+              end   = MIN (end + 1, width - 1);
             }
 
+          if (segment.y + 1 < height)
+            push_segment (segment_stack, segment.y + 1, start, end);
+
+          if (segment.y - 1 >= 0)
+            push_segment (segment_stack, segment.y - 1, start, end);
         }
     }
-  while (! g_queue_is_empty (segment_queue));
 
-  g_queue_free (segment_queue);
+  g_array_free (segment_stack, TRUE);
 
-  g_object_unref (src_sampler);
+  for (band = 0; band < map.n_bands; band++)
+    {
+      contiguous_map_write_band (&map, band, mask_buffer);
+
+      g_free (map.bands[band].candidates);
+      g_free (map.bands[band].selected);
+    }
 
-#ifdef FETCH_ROW
-  g_free (row);
-#endif
+  g_free (map.bands);
 }
 
 static void
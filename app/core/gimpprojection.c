@@ -35,6 +35,7 @@
 
 #include "gimp.h"
 #include "gimp-memsize.h"
+#include "gimp-trace.h"
 #include "gimpchunkiterator.h"
 #include "gimpimage.h"
 #include "gimpmarshal.h"
@@ -76,13 +77,21 @@ struct _GimpProjectionPrivate
 
   cairo_region_t            *update_region;
   GeglRectangle              priority_rect;
+  GeglRectangle              prefetch_rect;
   GimpChunkIterator         *iter;
+  GimpChunkCostModel        *cost_model;
+  gdouble                    frame_budget;
   guint                      idle_id;
 
   gboolean                   invalidate_preview;
 };
 
 
+/*  local variables  */
+
+static gint n_dropped_frames = 0;
+
+
 /*  local function prototypes  */
 
 static void   gimp_projection_pickable_iface_init (GimpPickableInterface  *iface);
@@ -209,6 +218,8 @@ static void
 gimp_projection_init (GimpProjection *proj)
 {
   proj->priv = gimp_projection_get_instance_private (proj);
+
+  proj->priv->cost_model = gimp_chunk_cost_model_new ();
 }
 
 static void
@@ -233,6 +244,8 @@ gimp_projection_finalize (GObject *object)
 
   gimp_projection_free_buffer (proj);
 
+  g_clear_pointer (&proj->priv->cost_model, gimp_chunk_cost_model_free);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -519,6 +532,67 @@ gimp_projection_set_priority_rect (GimpProjection *proj,
   gimp_projection_update_priority_rect (proj);
 }
 
+/*  the prefetch rect is rendered after the priority rect, and before
+ *  everything else.
+ */
+void
+gimp_projection_set_prefetch_rect (GimpProjection *proj,
+                                   gint            x,
+                                   gint            y,
+                                   gint            w,
+                                   gint            h)
+{
+  g_return_if_fail (GIMP_IS_PROJECTION (proj));
+
+  proj->priv->prefetch_rect = *GEGL_RECTANGLE (x, y, w, h);
+
+  gimp_projection_update_priority_rect (proj);
+}
+
+/*  sets the time each rendering iteration should take, normally what's
+ *  left of a display frame after drawing it.  0.0 uses the default.
+ */
+void
+gimp_projection_set_frame_budget (GimpProjection *proj,
+                                  gdouble         budget)
+{
+  g_return_if_fail (GIMP_IS_PROJECTION (proj));
+
+  budget = MAX (budget, 0.0);
+
+  if (budget != proj->priv->frame_budget)
+    {
+      proj->priv->frame_budget = budget;
+
+      if (proj->priv->iter && budget > 0.0)
+        gimp_chunk_iterator_set_interval (proj->priv->iter, budget);
+    }
+}
+
+gboolean
+gimp_projection_is_rendering (GimpProjection *proj)
+{
+  g_return_val_if_fail (GIMP_IS_PROJECTION (proj), FALSE);
+
+  return proj->priv->iter != NULL;
+}
+
+void
+gimp_projection_add_dropped_frames (GimpProjection *proj,
+                                    gint            n_frames)
+{
+  g_return_if_fail (GIMP_IS_PROJECTION (proj));
+  g_return_if_fail (n_frames >= 0);
+
+  g_atomic_int_add (&n_dropped_frames, n_frames);
+}
+
+gint
+gimp_projection_get_n_dropped_frames (void)
+{
+  return g_atomic_int_get (&n_dropped_frames);
+}
+
 void
 gimp_projection_stop_rendering (GimpProjection *proj)
 {
@@ -554,6 +628,7 @@ gimp_projection_finish_draw (GimpProjection *proj)
   if (proj->priv->iter)
     {
       gimp_chunk_iterator_set_priority_rect (proj->priv->iter, NULL);
+      gimp_chunk_iterator_set_prefetch_rect (proj->priv->iter, NULL);
 
       gimp_tile_handler_validate_begin_validate (proj->priv->validate_handler);
 
@@ -565,6 +640,76 @@ gimp_projection_finish_draw (GimpProjection *proj)
     }
 }
 
+/*  renders the pending updates intersecting 'area', given in image
+ *  coordinates, right away, and leaves the rest of them to the chunk
+ *  renderer.  unlike gimp_pickable_flush(), this doesn't force the
+ *  entire dirty region to be constructed, so it's cheap enough for
+ *  reading back a few pixels, e.g. when picking colors.
+ */
+void
+gimp_projection_finish_area (GimpProjection      *proj,
+                             const GeglRectangle *area)
+{
+  g_return_if_fail (GIMP_IS_PROJECTION (proj));
+  g_return_if_fail (area != NULL);
+
+  /* create the buffer if it doesn't exist */
+  gimp_projection_get_buffer (GIMP_PICKABLE (proj));
+
+  gimp_projection_chunk_render_stop (proj, TRUE);
+
+  if (proj->priv->update_region)
+    {
+      cairo_region_t        *region;
+      cairo_rectangle_int_t  rect;
+      gint                   off_x, off_y;
+      gint                   n_rects;
+      gint                   i;
+
+      gimp_projectable_get_offset (proj->priv->projectable, &off_x, &off_y);
+
+      /*  subtract the projectable's offsets because the list of update
+       *  areas is in tile-pyramid coordinates, but our external API is
+       *  always in terms of image coordinates.
+       */
+      rect.x      = area->x - off_x;
+      rect.y      = area->y - off_y;
+      rect.width  = area->width;
+      rect.height = area->height;
+
+      region = cairo_region_copy (proj->priv->update_region);
+      cairo_region_intersect_rectangle (region, &rect);
+
+      n_rects = cairo_region_num_rectangles (region);
+
+      if (n_rects > 0)
+        {
+          gimp_tile_handler_validate_begin_validate (proj->priv->validate_handler);
+
+          for (i = 0; i < n_rects; i++)
+            {
+              cairo_region_get_rectangle (region, i, &rect);
+
+              gimp_projection_paint_area (proj, TRUE,
+                                          rect.x, rect.y,
+                                          rect.width, rect.height);
+            }
+
+          gimp_tile_handler_validate_end_validate (proj->priv->validate_handler);
+
+          cairo_region_subtract (proj->priv->update_region, region);
+        }
+
+      cairo_region_destroy (region);
+
+      if (cairo_region_is_empty (proj->priv->update_region))
+        g_clear_pointer (&proj->priv->update_region, cairo_region_destroy);
+    }
+
+  /*  restart the chunk renderer on what's left  */
+  gimp_projection_flush (proj);
+}
+
 
 /*  private functions  */
 
@@ -701,10 +846,12 @@ gimp_projection_update_priority_rect (GimpProjection *proj)
   if (proj->priv->iter)
     {
       GeglRectangle rect;
+      GeglRectangle prefetch_rect;
       GeglRectangle bounding_box;
       gint          off_x, off_y;
 
-      rect = proj->priv->priority_rect;
+      rect          = proj->priv->priority_rect;
+      prefetch_rect = proj->priv->prefetch_rect;
 
       gimp_projectable_get_offset (proj->priv->projectable, &off_x, &off_y);
       bounding_box = gimp_projectable_get_bounding_box (proj->priv->projectable);
@@ -716,9 +863,14 @@ gimp_projection_update_priority_rect (GimpProjection *proj)
       rect.x -= off_x;
       rect.y -= off_y;
 
+      prefetch_rect.x -= off_x;
+      prefetch_rect.y -= off_y;
+
       gegl_rectangle_intersect (&rect, &rect, &bounding_box);
+      gegl_rectangle_intersect (&prefetch_rect, &prefetch_rect, &bounding_box);
 
       gimp_chunk_iterator_set_priority_rect (proj->priv->iter, &rect);
+      gimp_chunk_iterator_set_prefetch_rect (proj->priv->iter, &prefetch_rect);
     }
 }
 
@@ -751,6 +903,15 @@ gimp_projection_chunk_render_start (GimpProjection *proj)
     {
       proj->priv->iter = gimp_chunk_iterator_new (region);
 
+      gimp_chunk_iterator_set_cost_model (proj->priv->iter,
+                                          proj->priv->cost_model);
+
+      if (proj->priv->frame_budget > 0.0)
+        {
+          gimp_chunk_iterator_set_interval (proj->priv->iter,
+                                            proj->priv->frame_budget);
+        }
+
       gimp_projection_update_priority_rect (proj);
 
       if (! proj->priv->idle_id)
@@ -844,6 +1005,8 @@ gimp_projection_chunk_render_iteration (GimpProjection *proj)
     {
       GeglRectangle rect;
 
+      gimp_trace_begin ("projection", "chunk-render");
+
       gimp_tile_handler_validate_begin_validate (proj->priv->validate_handler);
 
       while (gimp_chunk_iterator_get_rect (proj->priv->iter, &rect))
@@ -854,6 +1017,8 @@ gimp_projection_chunk_render_iteration (GimpProjection *proj)
 
       gimp_tile_handler_validate_end_validate (proj->priv->validate_handler);
 
+      gimp_trace_end ();
+
       /* Still work to do. */
       return TRUE;
     }
@@ -966,6 +1131,8 @@ gimp_projection_projectable_structure_changed (GimpProjectable *projectable,
 
   gimp_projection_free_buffer (proj);
 
+  gimp_chunk_cost_model_reset (proj->priv->cost_model);
+
   bounding_box = gimp_projectable_get_bounding_box (projectable);
 
   gimp_projection_add_update_area (proj,
@@ -53,31 +53,46 @@ struct _GimpProjectionClass
 };
 
 
-GType            gimp_projection_get_type          (void) G_GNUC_CONST;
-
-GimpProjection * gimp_projection_new               (GimpProjectable   *projectable);
-
-void             gimp_projection_set_priority      (GimpProjection    *projection,
-                                                    gint               priority);
-gint             gimp_projection_get_priority      (GimpProjection    *projection);
-
-void             gimp_projection_set_priority_rect (GimpProjection    *proj,
-                                                    gint               x,
-                                                    gint               y,
-                                                    gint               width,
-                                                    gint               height);
-
-void             gimp_projection_stop_rendering    (GimpProjection    *proj);
-
-void             gimp_projection_flush             (GimpProjection    *proj);
-void             gimp_projection_flush_now         (GimpProjection    *proj,
-                                                    gboolean           direct);
-void             gimp_projection_finish_draw       (GimpProjection    *proj);
-
-gint64           gimp_projection_estimate_memsize  (GimpImageBaseType  type,
-                                                    GimpComponentType  component_type,
-                                                    gint               width,
-                                                    gint               height);
+GType            gimp_projection_get_type             (void) G_GNUC_CONST;
+
+GimpProjection * gimp_projection_new                  (GimpProjectable   *projectable);
+
+void             gimp_projection_set_priority         (GimpProjection    *projection,
+                                                       gint               priority);
+gint             gimp_projection_get_priority         (GimpProjection    *projection);
+
+void             gimp_projection_set_priority_rect    (GimpProjection    *proj,
+                                                       gint               x,
+                                                       gint               y,
+                                                       gint               width,
+                                                       gint               height);
+void             gimp_projection_set_prefetch_rect    (GimpProjection    *proj,
+                                                       gint               x,
+                                                       gint               y,
+                                                       gint               width,
+                                                       gint               height);
+
+void             gimp_projection_set_frame_budget     (GimpProjection    *proj,
+                                                       gdouble            budget);
+gboolean         gimp_projection_is_rendering         (GimpProjection    *proj);
+
+void             gimp_projection_add_dropped_frames   (GimpProjection    *proj,
+                                                       gint               n_frames);
+gint             gimp_projection_get_n_dropped_frames (void);
+
+void             gimp_projection_stop_rendering       (GimpProjection    *proj);
+
+void             gimp_projection_flush                (GimpProjection    *proj);
+void             gimp_projection_flush_now            (GimpProjection    *proj,
+                                                       gboolean           direct);
+void             gimp_projection_finish_draw          (GimpProjection    *proj);
+void             gimp_projection_finish_area          (GimpProjection    *proj,
+                                                       const GeglRectangle *area);
+
+gint64           gimp_projection_estimate_memsize     (GimpImageBaseType  type,
+                                                       GimpComponentType  component_type,
+                                                       gint               width,
+                                                       gint               height);
 
 
 #endif /*  __GIMP_PROJECTION_H__  */
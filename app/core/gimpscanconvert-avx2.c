@@ -0,0 +1,112 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimpscanconvert-avx2.c
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <glib.h>
+
+#include "gimpscanconvert-avx2.h"
+
+
+#if COMPILE_AVX2_INTRINISICS
+
+/* AVX2 */
+#include <immintrin.h>
+
+
+/*  local function prototypes  */
+
+static inline __m256   gimp_scan_convert_prefix_sum_avx2 (__m256 x);
+
+
+/*  private functions  */
+
+/*  returns the inclusive prefix sums of the 8 lanes of x  */
+static inline __m256
+gimp_scan_convert_prefix_sum_avx2 (__m256 x)
+{
+  __m256 t;
+
+  /*  within each 128-bit lane  */
+  x = _mm256_add_ps (x, _mm256_castsi256_ps (
+                          _mm256_slli_si256 (_mm256_castps_si256 (x), 4)));
+  x = _mm256_add_ps (x, _mm256_castsi256_ps (
+                          _mm256_slli_si256 (_mm256_castps_si256 (x), 8)));
+
+  /*  add the total of the lower lane to the upper lane  */
+  t = _mm256_permute_ps (x, _MM_SHUFFLE (3, 3, 3, 3));
+  t = _mm256_permute2f128_ps (t, t, 0x08);
+
+  return _mm256_add_ps (x, t);
+}
+
+
+/*  public functions  */
+
+gfloat
+gimp_scan_convert_accumulate_avx2 (const gfloat *cells,
+                                   guchar       *dest,
+                                   gint          width,
+                                   gfloat        sum,
+                                   gfloat        scale)
+{
+  const __m256 half      = _mm256_set1_ps (0.5f);
+  const __m256 two       = _mm256_set1_ps (2.0f);
+  const __m256 sign_mask = _mm256_set1_ps (-0.0f);
+  const __m256 scale_v   = _mm256_set1_ps (scale);
+  __m256       carry     = _mm256_set1_ps (sum);
+  gint         x;
+
+  for (x = 0; x < width; x += 8)
+    {
+      __m256  acc;
+      __m256  coverage;
+      __m128i result16;
+      __m256i result;
+
+      acc = _mm256_add_ps (gimp_scan_convert_prefix_sum_avx2 (
+                             _mm256_loadu_ps (cells + x)),
+                           carry);
+
+      /*  broadcast the last sum for the next 8 cells  */
+      carry = _mm256_permute_ps (acc, _MM_SHUFFLE (3, 3, 3, 3));
+      carry = _mm256_permute2f128_ps (carry, carry, 0x11);
+
+      /*  fold the winding into [0, 1] for the even-odd rule  */
+      coverage = _mm256_sub_ps (
+        acc,
+        _mm256_mul_ps (two,
+                       _mm256_floor_ps (_mm256_add_ps (_mm256_mul_ps (acc, half),
+                                                       half))));
+      coverage = _mm256_andnot_ps (sign_mask, coverage);
+
+      result = _mm256_cvttps_epi32 (
+        _mm256_add_ps (_mm256_mul_ps (coverage, scale_v), half));
+
+      result16 = _mm_packus_epi32 (_mm256_castsi256_si128 (result),
+                                   _mm256_extracti128_si256 (result, 1));
+
+      _mm_storel_epi64 ((__m128i *) (dest + x),
+                        _mm_packus_epi16 (result16, result16));
+    }
+
+  return _mm_cvtss_f32 (_mm256_castps256_ps128 (carry));
+}
+
+#endif /* COMPILE_AVX2_INTRINISICS */
@@ -0,0 +1,41 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimpscanconvert-avx2.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GIMP_SCAN_CONVERT_AVX2_H__
+#define __GIMP_SCAN_CONVERT_AVX2_H__
+
+
+#if COMPILE_AVX2_INTRINISICS
+
+/*  accumulate the first @width coverage cells of a row, @width being a
+ *  multiple of 8, starting from @sum, and write the even-odd coverage
+ *  times @scale to @dest, like the scalar loop of gimpscanconvert.c.
+ *
+ *  returns the accumulated sum.
+ */
+gfloat   gimp_scan_convert_accumulate_avx2 (const gfloat *cells,
+                                            guchar       *dest,
+                                            gint          width,
+                                            gfloat        sum,
+                                            gfloat        scale);
+
+#endif /* COMPILE_AVX2_INTRINISICS */
+
+
+#endif /* __GIMP_SCAN_CONVERT_AVX2_H__ */
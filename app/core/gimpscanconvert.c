@@ -32,8 +32,40 @@
 #include "gimpboundary.h"
 #include "gimpbezierdesc.h"
 #include "gimpscanconvert.h"
+#include "gimpscanconvert-avx2.h"
 
 
+/*  the number of rows the fill rasterizer works on at once  */
+#define BAND_HEIGHT    64
+
+/*  the maximal distance of flattened curves from the real curves,
+ *  like cairo's default tolerance
+ */
+#define CURVE_TOLERANCE 0.1
+
+
+typedef struct
+{
+  gdouble x0, y0;  /*  the upper end point               */
+  gdouble x1, y1;  /*  the lower end point               */
+  gdouble dxdy;
+  gdouble dir;     /*  1.0 if the edge goes down, -1.0 if it goes up  */
+} ScanEdge;
+
+typedef struct
+{
+  gdouble x;
+  gdouble dir;
+} ScanCrossing;
+
+typedef struct
+{
+  GArray  *edges;
+  gint     width;    /*  the edges lie within [0, width]  */
+  gdouble  x1, y1;   /*  their extents                    */
+  gdouble  x2, y2;
+} ScanEdges;
+
 struct _GimpScanConvert
 {
   gdouble         ratio_xy;
@@ -57,6 +89,52 @@ struct _GimpScanConvert
 };
 
 
+/*  local function prototypes  */
+
+static void   gimp_scan_convert_add_edge      (ScanEdges           *edges,
+                                               gdouble              x0,
+                                               gdouble              y0,
+                                               gdouble              x1,
+                                               gdouble              y1);
+static void   gimp_scan_convert_add_curve     (ScanEdges           *edges,
+                                               const GimpVector2   *p0,
+                                               const GimpVector2   *p1,
+                                               const GimpVector2   *p2,
+                                               const GimpVector2   *p3);
+static void   gimp_scan_convert_get_edges     (GimpScanConvert     *sc,
+                                               ScanEdges           *edges,
+                                               gdouble              off_x,
+                                               gdouble              off_y);
+static void   gimp_scan_convert_draw_edge     (const ScanEdge      *edge,
+                                               gfloat              *cells,
+                                               gint                 stride,
+                                               gint                 x_offset,
+                                               gint                 n_cells,
+                                               gint                 band_y,
+                                               gint                 band_height);
+static void   gimp_scan_convert_render_fill   (GimpScanConvert     *sc,
+                                               GeglBuffer          *buffer,
+                                               const GeglRectangle *area,
+                                               gint                 off_x,
+                                               gint                 off_y,
+                                               gboolean             replace,
+                                               gboolean             antialias,
+                                               gdouble              value);
+static void   gimp_scan_convert_render_stroke (GimpScanConvert     *sc,
+                                               GeglBuffer          *buffer,
+                                               const GeglRectangle *area,
+                                               gint                 off_x,
+                                               gint                 off_y,
+                                               gboolean             replace,
+                                               gboolean             antialias,
+                                               gdouble              value);
+
+static gint   scan_edge_cmp                   (const ScanEdge      *edge_a,
+                                               const ScanEdge      *edge_b);
+static gint   scan_crossing_cmp               (const ScanCrossing  *crossing_a,
+                                               const ScanCrossing  *crossing_b);
+
+
 /*  public functions  */
 
 /**
@@ -496,17 +574,9 @@ gimp_scan_convert_render_full (GimpScanConvert *sc,
                                gboolean         antialias,
                                gdouble          value)
 {
-  const Babl         *format;
-  guchar             *shared_buf      = NULL;
-  gsize               shared_buf_size = 0;
-  GeglBufferIterator *iter;
-  GeglRectangle      *roi;
-  cairo_t            *cr;
-  cairo_surface_t    *surface;
-  cairo_path_t        path;
-  gint                bpp;
-  gint                x, y;
-  gint                width, height;
+  GeglRectangle area;
+  gint          x, y;
+  gint          width, height;
 
   g_return_if_fail (sc != NULL);
   g_return_if_fail (GEGL_IS_BUFFER (buffer));
@@ -519,17 +589,599 @@ gimp_scan_convert_render_full (GimpScanConvert *sc,
   if (sc->clip && ! gimp_rectangle_intersect (x, y, width, height,
                                               sc->clip_x, sc->clip_y,
                                               sc->clip_w, sc->clip_h,
-                                              &x, &y, &width, &height))
+                                              NULL, NULL, NULL, NULL))
+    return;
+
+  area = *gegl_buffer_get_extent (buffer);
+
+  if (sc->do_stroke)
+    {
+      gimp_scan_convert_render_stroke (sc, buffer, &area, off_x, off_y,
+                                       replace, antialias, value);
+    }
+  else
+    {
+      gimp_scan_convert_render_fill (sc, buffer, &area, off_x, off_y,
+                                     replace, antialias, value);
+    }
+}
+
+
+/*  private functions  */
+
+static void
+gimp_scan_convert_add_edge (ScanEdges *edges,
+                            gdouble    x0,
+                            gdouble    y0,
+                            gdouble    x1,
+                            gdouble    y1)
+{
+  ScanEdge edge;
+
+  if (y0 == y1)
     return;
 
+  /*  split the edge at the left and right borders, and move the parts
+   *  outside onto them, which keeps the coverage inside unchanged
+   */
+  if ((x0 < 0.0) != (x1 < 0.0) && x0 != 0.0 && x1 != 0.0)
+    {
+      gdouble y = y0 + (0.0 - x0) * (y1 - y0) / (x1 - x0);
+
+      gimp_scan_convert_add_edge (edges, x0, y0, 0.0, y);
+      gimp_scan_convert_add_edge (edges, 0.0, y, x1, y1);
+
+      return;
+    }
+
+  if ((x0 > edges->width) != (x1 > edges->width) &&
+      x0 != edges->width && x1 != edges->width)
+    {
+      gdouble y = y0 + (edges->width - x0) * (y1 - y0) / (x1 - x0);
+
+      gimp_scan_convert_add_edge (edges, x0, y0, edges->width, y);
+      gimp_scan_convert_add_edge (edges, edges->width, y, x1, y1);
+
+      return;
+    }
+
+  x0 = CLAMP (x0, 0.0, edges->width);
+  x1 = CLAMP (x1, 0.0, edges->width);
+
+  if (y0 < y1)
+    {
+      edge.x0  = x0;
+      edge.y0  = y0;
+      edge.x1  = x1;
+      edge.y1  = y1;
+      edge.dir = 1.0;
+    }
+  else
+    {
+      edge.x0  = x1;
+      edge.y0  = y1;
+      edge.x1  = x0;
+      edge.y1  = y0;
+      edge.dir = -1.0;
+    }
+
+  edge.dxdy = (edge.x1 - edge.x0) / (edge.y1 - edge.y0);
+
+  if (edges->edges->len == 0)
+    {
+      edges->x1 = MIN (edge.x0, edge.x1);
+      edges->y1 = edge.y0;
+      edges->x2 = MAX (edge.x0, edge.x1);
+      edges->y2 = edge.y1;
+    }
+  else
+    {
+      edges->x1 = MIN (edges->x1, MIN (edge.x0, edge.x1));
+      edges->y1 = MIN (edges->y1, edge.y0);
+      edges->x2 = MAX (edges->x2, MAX (edge.x0, edge.x1));
+      edges->y2 = MAX (edges->y2, edge.y1);
+    }
+
+  g_array_append_val (edges->edges, edge);
+}
+
+static void
+gimp_scan_convert_add_curve (ScanEdges         *edges,
+                             const GimpVector2 *p0,
+                             const GimpVector2 *p1,
+                             const GimpVector2 *p2,
+                             const GimpVector2 *p3)
+{
+  GimpVector2 prev = *p0;
+  gdouble     dd;
+  gint        n;
+  gint        i;
+
+  /*  the flattening error of n uniform steps is at most 3/4 of the
+   *  largest second difference of the control points over n^2
+   */
+  dd = MAX (hypot (p0->x - 2.0 * p1->x + p2->x, p0->y - 2.0 * p1->y + p2->y),
+            hypot (p1->x - 2.0 * p2->x + p3->x, p1->y - 2.0 * p2->y + p3->y));
+
+  n = CLAMP ((gint) ceil (sqrt (0.75 * dd / CURVE_TOLERANCE)), 1, 1000);
+
+  for (i = 1; i <= n; i++)
+    {
+      gdouble     t = (gdouble) i / n;
+      gdouble     u = 1.0 - t;
+      GimpVector2 p;
+
+      p.x = (u * u * u         * p0->x + 3.0 * u * u * t * p1->x +
+             3.0 * u * t * t   * p2->x + t * t * t       * p3->x);
+      p.y = (u * u * u         * p0->y + 3.0 * u * u * t * p1->y +
+             3.0 * u * t * t   * p2->y + t * t * t       * p3->y);
+
+      gimp_scan_convert_add_edge (edges, prev.x, prev.y, p.x, p.y);
+
+      prev = p;
+    }
+}
+
+/*  flattens the path into edges, in the coordinates of the area, and
+ *  closes all subpaths, like cairo_fill() does
+ */
+static void
+gimp_scan_convert_get_edges (GimpScanConvert *sc,
+                             ScanEdges       *edges,
+                             gdouble          off_x,
+                             gdouble          off_y)
+{
+  const cairo_path_data_t *data  = (cairo_path_data_t *) sc->path_data->data;
+  GimpVector2              start = { 0.0, 0.0 };
+  GimpVector2              cur   = { 0.0, 0.0 };
+  gint                     i;
+
+  for (i = 0; i < sc->path_data->len; i += data[i].header.length)
+    {
+      GimpVector2 p[3];
+      gint        j;
+
+      for (j = 0; j < MIN (data[i].header.length - 1, 3); j++)
+        {
+          p[j].x = data[i + 1 + j].point.x - off_x;
+          p[j].y = data[i + 1 + j].point.y - off_y;
+        }
+
+      switch (data[i].header.type)
+        {
+        case CAIRO_PATH_MOVE_TO:
+          gimp_scan_convert_add_edge (edges, cur.x, cur.y, start.x, start.y);
+
+          start = cur = p[0];
+          break;
+
+        case CAIRO_PATH_LINE_TO:
+          gimp_scan_convert_add_edge (edges, cur.x, cur.y, p[0].x, p[0].y);
+
+          cur = p[0];
+          break;
+
+        case CAIRO_PATH_CURVE_TO:
+          gimp_scan_convert_add_curve (edges, &cur, &p[0], &p[1], &p[2]);
+
+          cur = p[2];
+          break;
+
+        case CAIRO_PATH_CLOSE_PATH:
+          gimp_scan_convert_add_edge (edges, cur.x, cur.y, start.x, start.y);
+
+          cur = start;
+          break;
+        }
+    }
+
+  gimp_scan_convert_add_edge (edges, cur.x, cur.y, start.x, start.y);
+}
+
+/*  accumulates the signed area an edge covers in each cell of the rows
+ *  of a band, so that the running sum of a row's cells is the winding
+ *  coverage of its pixels
+ */
+static void
+gimp_scan_convert_draw_edge (const ScanEdge *edge,
+                             gfloat         *cells,
+                             gint            stride,
+                             gint            x_offset,
+                             gint            n_cells,
+                             gint            band_y,
+                             gint            band_height)
+{
+  gdouble y_start = MAX (edge->y0, band_y);
+  gdouble y_end   = MIN (edge->y1, band_y + band_height);
+  gdouble x;
+  gint    y;
+
+  x = edge->x0 + (y_start - edge->y0) * edge->dxdy - x_offset;
+  x = CLAMP (x, 0.0, n_cells - 2);
+
+  for (y = floor (y_start); y < y_end; y++)
+    {
+      gfloat  *row = cells + (y - band_y) * stride;
+      gdouble  dy;
+      gdouble  x_next;
+      gdouble  d;
+      gdouble  x0, x1;
+      gdouble  x0_floor;
+      gdouble  x1_ceil;
+      gint     x0_i;
+      gint     x1_i;
+
+      dy     = MIN (y + 1, y_end) - MAX (y, y_start);
+      x_next = x + edge->dxdy * dy;
+      x_next = CLAMP (x_next, 0.0, n_cells - 2);
+      d      = dy * edge->dir;
+
+      x0 = MIN (x, x_next);
+      x1 = MAX (x, x_next);
+
+      x0_floor = floor (x0);
+      x1_ceil  = ceil (x1);
+      x0_i     = x0_floor;
+      x1_i     = x1_ceil;
+
+      if (x1_i <= x0_i + 1)
+        {
+          /*  the edge stays within a pixel  */
+          gdouble x_mid = 0.5 * (x + x_next) - x0_floor;
+
+          row[x0_i]     += d - d * x_mid;
+          row[x0_i + 1] += d * x_mid;
+        }
+      else
+        {
+          gdouble s    = 1.0 / (x1 - x0);
+          gdouble x0_f = x0 - x0_floor;
+          gdouble x1_f = x1 - x1_ceil + 1.0;
+          gdouble a0   = 0.5 * s * (1.0 - x0_f) * (1.0 - x0_f);
+          gdouble am   = 0.5 * s * x1_f * x1_f;
+
+          row[x0_i] += d * a0;
+
+          if (x1_i == x0_i + 2)
+            {
+              row[x0_i + 1] += d * (1.0 - a0 - am);
+            }
+          else
+            {
+              gdouble a1 = s * (1.5 - x0_f);
+              gdouble a2 = a1 + (x1_i - x0_i - 3) * s;
+              gint    i;
+
+              row[x0_i + 1] += d * (a1 - a0);
+
+              for (i = x0_i + 2; i < x1_i - 1; i++)
+                row[i] += d * s;
+
+              row[x1_i - 1] += d * (1.0 - a2 - am);
+            }
+
+          row[x1_i] += d * am;
+        }
+
+      x = x_next;
+    }
+}
+
+/*  fills the path with the even-odd rule, band by band, accumulating
+ *  the exact area coverage of the edges when antialiasing, or sampling
+ *  the pixel centers otherwise, and writes each band straight into the
+ *  buffer.  only the extents of the path are rasterized.
+ */
+static void
+gimp_scan_convert_render_fill (GimpScanConvert     *sc,
+                               GeglBuffer          *buffer,
+                               const GeglRectangle *area,
+                               gint                 off_x,
+                               gint                 off_y,
+                               gboolean             replace,
+                               gboolean             antialias,
+                               gdouble              value)
+{
+  const Babl *format = babl_format ("Y u8");
+  ScanEdges   edges  = { 0, };
+  GArray     *active;
+  GArray     *crossings;
+  gfloat     *cells  = NULL;
+  guchar     *dest;
+  guchar     *src    = NULL;
+  gfloat      scale;
+  gint        x1, y1, x2, y2;
+  gint        width;
+  gint        stride;
+  gint        next_edge = 0;
+  gint        band_y;
+#if COMPILE_AVX2_INTRINISICS
+  gboolean    avx2 = (gimp_cpu_accel_get_support () &
+                      GIMP_CPU_ACCEL_X86_AVX2);
+#endif
+
+  if (replace)
+    gegl_buffer_clear (buffer, area);
+
+  edges.edges = g_array_new (FALSE, FALSE, sizeof (ScanEdge));
+  edges.width = area->width;
+
+  gimp_scan_convert_get_edges (sc, &edges,
+                               off_x + area->x, off_y + area->y);
+
+  if (edges.edges->len == 0)
+    {
+      g_array_free (edges.edges, TRUE);
+
+      return;
+    }
+
+  x1 = CLAMP (floor (edges.x1), 0, area->width);
+  y1 = CLAMP (floor (edges.y1), 0, area->height);
+  x2 = CLAMP (ceil  (edges.x2), 0, area->width);
+  y2 = CLAMP (ceil  (edges.y2), 0, area->height);
+
+  if (x1 >= x2 || y1 >= y2)
+    {
+      g_array_free (edges.edges, TRUE);
+
+      return;
+    }
+
+  g_array_sort (edges.edges, (GCompareFunc) scan_edge_cmp);
+
+  width  = x2 - x1;
+  stride = width + 2;
+
+  if (antialias)
+    cells = g_new (gfloat, (gsize) stride * BAND_HEIGHT);
+
+  dest = g_new (guchar, (gsize) width * BAND_HEIGHT);
+
+  if (! replace)
+    src = g_new (guchar, (gsize) width * BAND_HEIGHT);
+
+  /*  when composing, the coverage is blended with the content below  */
+  scale = replace ? value * 255.0 : 255.0;
+
+  active    = g_array_new (FALSE, FALSE, sizeof (const ScanEdge *));
+  crossings = g_array_new (FALSE, FALSE, sizeof (ScanCrossing));
+
+  for (band_y = y1; band_y < y2; band_y += BAND_HEIGHT)
+    {
+      GeglRectangle rect;
+      gint          band_height = MIN (BAND_HEIGHT, y2 - band_y);
+      gint          i;
+      gint          r;
+
+      /*  update the edges touching the band  */
+      for (i = 0; i < active->len;)
+        {
+          const ScanEdge *edge = g_array_index (active, const ScanEdge *, i);
+
+          if (edge->y1 <= band_y)
+            g_array_remove_index_fast (active, i);
+          else
+            i++;
+        }
+
+      while (next_edge < edges.edges->len)
+        {
+          const ScanEdge *edge = &g_array_index (edges.edges, ScanEdge,
+                                                 next_edge);
+
+          if (edge->y0 >= band_y + band_height)
+            break;
+
+          if (edge->y1 > band_y)
+            g_array_append_val (active, edge);
+
+          next_edge++;
+        }
+
+      if (antialias)
+        {
+          memset (cells, 0, sizeof (gfloat) * stride * band_height);
+
+          for (i = 0; i < active->len; i++)
+            {
+              gimp_scan_convert_draw_edge (g_array_index (active,
+                                                          const ScanEdge *, i),
+                                           cells, stride, x1, stride,
+                                           band_y, band_height);
+            }
+
+          for (r = 0; r < band_height; r++)
+            {
+              const gfloat *row = cells + r * stride;
+              guchar       *d   = dest  + r * width;
+              gfloat        sum = 0.0f;
+              gint          x   = 0;
+
+#if COMPILE_AVX2_INTRINISICS
+              if (avx2)
+                {
+                  x   = width - width % 8;
+                  sum = gimp_scan_convert_accumulate_avx2 (row, d, x,
+                                                           sum, scale);
+                }
+#endif
+
+              for (; x < width; x++)
+                {
+                  gfloat coverage;
+
+                  sum += row[x];
+
+                  /*  fold the winding into [0, 1] for the even-odd rule  */
+                  coverage = fabsf (sum - 2.0f * floorf (sum * 0.5f + 0.5f));
+
+                  d[x] = coverage * scale + 0.5f;
+                }
+            }
+        }
+      else
+        {
+          const guchar fill = scale + 0.5;
+
+          memset (dest, 0, width * band_height);
+
+          for (r = 0; r < band_height; r++)
+            {
+              gdouble  y = band_y + r + 0.5;
+              guchar  *d = dest + r * width;
+              gint     inside = 0;
+              gdouble  span_start = 0.0;
+
+              g_array_set_size (crossings, 0);
+
+              for (i = 0; i < active->len; i++)
+                {
+                  const ScanEdge *edge = g_array_index (active,
+                                                        const ScanEdge *, i);
+
+                  if (edge->y0 <= y && y < edge->y1)
+                    {
+                      ScanCrossing crossing;
+
+                      crossing.x   = edge->x0 + (y - edge->y0) * edge->dxdy - x1;
+                      crossing.dir = edge->dir;
+
+                      g_array_append_val (crossings, crossing);
+                    }
+                }
+
+              g_array_sort (crossings, (GCompareFunc) scan_crossing_cmp);
+
+              /*  fill the pixels whose centers are inside  */
+              for (i = 0; i < crossings->len; i++)
+                {
+                  gdouble x = g_array_index (crossings, ScanCrossing, i).x;
+
+                  inside = ! inside;
+
+                  if (inside)
+                    {
+                      span_start = x;
+                    }
+                  else
+                    {
+                      gint start = CLAMP (ceil (span_start - 0.5), 0, width);
+                      gint end   = CLAMP (ceil (x - 0.5),          0, width);
+
+                      if (start < end)
+                        memset (d + start, fill, end - start);
+                    }
+                }
+            }
+        }
+
+      rect.x      = area->x + x1;
+      rect.y      = area->y + band_y;
+      rect.width  = width;
+      rect.height = band_height;
+
+      if (! replace)
+        {
+          const guchar v = value * 255.0 + 0.5;
+
+          gegl_buffer_get (buffer, &rect, 1.0, format, src,
+                           GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
+
+          for (i = 0; i < width * band_height; i++)
+            dest[i] = (src[i] * (255 - dest[i]) + v * dest[i] + 127) / 255;
+        }
+
+      gegl_buffer_set (buffer, &rect, 0, format, dest, GEGL_AUTO_ROWSTRIDE);
+    }
+
+  g_array_free (crossings, TRUE);
+  g_array_free (active, TRUE);
+  g_array_free (edges.edges, TRUE);
+
+  g_free (src);
+  g_free (dest);
+  g_free (cells);
+}
+
+/*  strokes the path with cairo, one tile after the other, but only in the
+ *  extents of the stroke
+ */
+static void
+gimp_scan_convert_render_stroke (GimpScanConvert     *sc,
+                                 GeglBuffer          *buffer,
+                                 const GeglRectangle *area,
+                                 gint                 off_x,
+                                 gint                 off_y,
+                                 gboolean             replace,
+                                 gboolean             antialias,
+                                 gdouble              value)
+{
+  const Babl         *format;
+  guchar             *shared_buf      = NULL;
+  gsize               shared_buf_size = 0;
+  GeglBufferIterator *iter;
+  GeglRectangle      *roi;
+  GeglRectangle       extents;
+  cairo_t            *cr;
+  cairo_surface_t    *surface;
+  cairo_path_t        path;
+  gdouble             x1 = 0.0, y1 = 0.0;
+  gdouble             x2 = 0.0, y2 = 0.0;
+  gdouble             margin;
+  gint                bpp;
+  gint                i;
+
   path.status   = CAIRO_STATUS_SUCCESS;
   path.data     = (cairo_path_data_t *) sc->path_data->data;
   path.num_data = sc->path_data->len;
 
+  /*  the control points of the path contain it, and a stroke reaches at
+   *  most half its width, times the miter limit or the diagonal of a
+   *  square cap, around it
+   */
+  for (i = 0; i < path.num_data; i += path.data[i].header.length)
+    {
+      gint j;
+
+      for (j = 1; j < path.data[i].header.length; j++)
+        {
+          gdouble x = path.data[i + j].point.x - off_x;
+          gdouble y = path.data[i + j].point.y - off_y;
+
+          if (i == 0 && j == 1)
+            {
+              x1 = x2 = x;
+              y1 = y2 = y;
+            }
+          else
+            {
+              x1 = MIN (x1, x);
+              y1 = MIN (y1, y);
+              x2 = MAX (x2, x);
+              y2 = MAX (y2, y);
+            }
+        }
+    }
+
+  margin = sc->width / 2.0 * MAX (sc->join == GIMP_JOIN_MITER ? sc->miter : 1.0,
+                                  G_SQRT2);
+
+  extents.x      = floor (x1 - margin) - 1;
+  extents.y      = floor (y1 - margin * sc->ratio_xy) - 1;
+  extents.width  = ceil (x2 + margin) + 1 - extents.x;
+  extents.height = ceil (y2 + margin * sc->ratio_xy) + 1 - extents.y;
+
+  if (replace)
+    gegl_buffer_clear (buffer, area);
+
+  if (! gegl_rectangle_intersect (&extents, &extents, area))
+    return;
+
   format = babl_format ("Y u8");
   bpp    = babl_format_get_bytes_per_pixel (format);
 
-  iter = gegl_buffer_iterator_new (buffer, NULL, 0, format,
+  iter = gegl_buffer_iterator_new (buffer, &extents, 0, format,
                                    GEGL_ACCESS_READWRITE, GEGL_ABYSS_NONE, 1);
   roi = &iter->items[0].roi;
 
@@ -559,7 +1211,6 @@ gimp_scan_convert_render_full (GimpScanConvert *sc,
             {
               const guchar *src  = data;
               guchar       *dest = tmp_buf;
-              gint          i;
 
               for (i = 0; i < roi->height; i++)
                 {
@@ -596,33 +1247,25 @@ gimp_scan_convert_render_full (GimpScanConvert *sc,
                            CAIRO_ANTIALIAS_GRAY : CAIRO_ANTIALIAS_NONE);
       cairo_set_miter_limit (cr, sc->miter);
 
-      if (sc->do_stroke)
-        {
-          cairo_set_line_cap (cr,
-                              sc->cap == GIMP_CAP_BUTT ? CAIRO_LINE_CAP_BUTT :
-                              sc->cap == GIMP_CAP_ROUND ? CAIRO_LINE_CAP_ROUND :
-                              CAIRO_LINE_CAP_SQUARE);
-          cairo_set_line_join (cr,
-                               sc->join == GIMP_JOIN_MITER ? CAIRO_LINE_JOIN_MITER :
-                               sc->join == GIMP_JOIN_ROUND ? CAIRO_LINE_JOIN_ROUND :
-                               CAIRO_LINE_JOIN_BEVEL);
-
-          cairo_set_line_width (cr, sc->width);
-
-          if (sc->dash_info)
-            cairo_set_dash (cr,
-                            (double *) sc->dash_info->data,
-                            sc->dash_info->len,
-                            sc->dash_offset);
-
-          cairo_scale (cr, 1.0, sc->ratio_xy);
-          cairo_stroke (cr);
-        }
-      else
-        {
-          cairo_set_fill_rule (cr, CAIRO_FILL_RULE_EVEN_ODD);
-          cairo_fill (cr);
-        }
+      cairo_set_line_cap (cr,
+                          sc->cap == GIMP_CAP_BUTT ? CAIRO_LINE_CAP_BUTT :
+                          sc->cap == GIMP_CAP_ROUND ? CAIRO_LINE_CAP_ROUND :
+                          CAIRO_LINE_CAP_SQUARE);
+      cairo_set_line_join (cr,
+                           sc->join == GIMP_JOIN_MITER ? CAIRO_LINE_JOIN_MITER :
+                           sc->join == GIMP_JOIN_ROUND ? CAIRO_LINE_JOIN_ROUND :
+                           CAIRO_LINE_JOIN_BEVEL);
+
+      cairo_set_line_width (cr, sc->width);
+
+      if (sc->dash_info)
+        cairo_set_dash (cr,
+                        (double *) sc->dash_info->data,
+                        sc->dash_info->len,
+                        sc->dash_offset);
+
+      cairo_scale (cr, 1.0, sc->ratio_xy);
+      cairo_stroke (cr);
 
       cairo_destroy (cr);
       cairo_surface_destroy (surface);
@@ -631,7 +1274,6 @@ gimp_scan_convert_render_full (GimpScanConvert *sc,
         {
           const guchar *src  = tmp_buf;
           guchar       *dest = data;
-          gint          i;
 
           for (i = 0; i < roi->height; i++)
             {
@@ -645,3 +1287,27 @@ gimp_scan_convert_render_full (GimpScanConvert *sc,
 
   g_free (shared_buf);
 }
+
+static gint
+scan_edge_cmp (const ScanEdge *edge_a,
+               const ScanEdge *edge_b)
+{
+  if (edge_a->y0 < edge_b->y0)
+    return -1;
+  else if (edge_a->y0 > edge_b->y0)
+    return 1;
+
+  return 0;
+}
+
+static gint
+scan_crossing_cmp (const ScanCrossing *crossing_a,
+                   const ScanCrossing *crossing_b)
+{
+  if (crossing_a->x < crossing_b->x)
+    return -1;
+  else if (crossing_a->x > crossing_b->x)
+    return 1;
+
+  return 0;
+}
@@ -70,8 +70,14 @@ typedef struct
 
 struct _GimpTagCachePrivate
 {
-  GArray *records;
-  GList  *containers;
+  GArray     *records;
+  GList      *containers;
+
+  /*  map identifier and checksum quarks to 1 + the index of the first
+   *  record that has them
+   */
+  GHashTable *identifier_index;
+  GHashTable *checksum_index;
 };
 
 
@@ -83,6 +89,13 @@ static void          gimp_tag_cache_object_initialize  (GimpTagged             *
                                                         GimpTagCache           *cache);
 static void          gimp_tag_cache_add_object         (GimpTagCache           *cache,
                                                         GimpTagged             *tagged);
+static void          gimp_tag_cache_index_record       (GHashTable             *index,
+                                                        GQuark                  quark,
+                                                        gint                    i);
+static GimpTagCacheRecord *
+                     gimp_tag_cache_lookup_record      (GimpTagCache           *cache,
+                                                        GHashTable             *index,
+                                                        GQuark                  quark);
 
 static void          gimp_tag_cache_load_start_element (GMarkupParseContext    *context,
                                                         const gchar            *element_name,
@@ -134,6 +147,9 @@ gimp_tag_cache_init (GimpTagCache *cache)
   cache->priv->records    = g_array_new (FALSE, FALSE,
                                          sizeof (GimpTagCacheRecord));
   cache->priv->containers = NULL;
+
+  cache->priv->identifier_index = g_hash_table_new (NULL, NULL);
+  cache->priv->checksum_index   = g_hash_table_new (NULL, NULL);
 }
 
 static void
@@ -163,6 +179,9 @@ gimp_tag_cache_finalize (GObject *object)
       cache->priv->containers = NULL;
     }
 
+  g_clear_pointer (&cache->priv->identifier_index, g_hash_table_unref);
+  g_clear_pointer (&cache->priv->checksum_index,   g_hash_table_unref);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -228,12 +247,12 @@ static void
 gimp_tag_cache_add_object (GimpTagCache *cache,
                            GimpTagged   *tagged)
 {
-  gchar  *identifier;
-  GQuark  identifier_quark = 0;
-  gchar  *checksum;
-  GQuark  checksum_quark = 0;
-  GList  *list;
-  gint    i;
+  GimpTagCacheRecord *rec;
+  gchar              *identifier;
+  GQuark              identifier_quark = 0;
+  gchar              *checksum;
+  GQuark              checksum_quark = 0;
+  GList              *list;
 
   identifier = gimp_tagged_get_identifier (tagged);
 
@@ -245,21 +264,19 @@ gimp_tag_cache_add_object (GimpTagCache *cache,
 
   if (identifier_quark)
     {
-      for (i = 0; i < cache->priv->records->len; i++)
-        {
-          GimpTagCacheRecord *rec = &g_array_index (cache->priv->records,
-                                                    GimpTagCacheRecord, i);
+      rec = gimp_tag_cache_lookup_record (cache,
+                                          cache->priv->identifier_index,
+                                          identifier_quark);
 
-          if (rec->identifier == identifier_quark)
+      if (rec)
+        {
+          for (list = rec->tags; list; list = g_list_next (list))
             {
-              for (list = rec->tags; list; list = g_list_next (list))
-                {
-                  gimp_tagged_add_tag (tagged, GIMP_TAG (list->data));
-                }
-
-              rec->referenced = TRUE;
-              return;
+              gimp_tagged_add_tag (tagged, GIMP_TAG (list->data));
             }
+
+          rec->referenced = TRUE;
+          return;
         }
     }
 
@@ -273,32 +290,72 @@ gimp_tag_cache_add_object (GimpTagCache *cache,
 
   if (checksum_quark)
     {
-      for (i = 0; i < cache->priv->records->len; i++)
-        {
-          GimpTagCacheRecord *rec = &g_array_index (cache->priv->records,
-                                                    GimpTagCacheRecord, i);
+      rec = gimp_tag_cache_lookup_record (cache,
+                                          cache->priv->checksum_index,
+                                          checksum_quark);
 
-          if (rec->checksum == checksum_quark)
-            {
+      if (rec)
+        {
 #if DEBUG_GIMP_TAG_CACHE
-              g_printerr ("remapping identifier: %s ==> %s\n",
-                          rec->identifier ? g_quark_to_string (rec->identifier) : "(NULL)",
-                          identifier_quark ? g_quark_to_string (identifier_quark) : "(NULL)");
+          g_printerr ("remapping identifier: %s ==> %s\n",
+                      rec->identifier ? g_quark_to_string (rec->identifier) : "(NULL)",
+                      identifier_quark ? g_quark_to_string (identifier_quark) : "(NULL)");
 #endif
 
-              rec->identifier = identifier_quark;
+          if (rec->identifier &&
+              gimp_tag_cache_lookup_record (cache,
+                                            cache->priv->identifier_index,
+                                            rec->identifier) == rec)
+            {
+              g_hash_table_remove (cache->priv->identifier_index,
+                                   GUINT_TO_POINTER (rec->identifier));
+            }
+
+          rec->identifier = identifier_quark;
 
-              for (list = rec->tags; list; list = g_list_next (list))
-                {
-                  gimp_tagged_add_tag (tagged, GIMP_TAG (list->data));
-                }
+          if (identifier_quark)
+            gimp_tag_cache_index_record (cache->priv->identifier_index,
+                                         identifier_quark,
+                                         rec - (GimpTagCacheRecord *)
+                                         cache->priv->records->data);
 
-              rec->referenced = TRUE;
-              return;
+          for (list = rec->tags; list; list = g_list_next (list))
+            {
+              gimp_tagged_add_tag (tagged, GIMP_TAG (list->data));
             }
+
+          rec->referenced = TRUE;
+          return;
         }
     }
+}
+
+static void
+gimp_tag_cache_index_record (GHashTable *index,
+                             GQuark      quark,
+                             gint        i)
+{
+  gint prev = GPOINTER_TO_INT (g_hash_table_lookup (index,
+                                                    GUINT_TO_POINTER (quark)));
 
+  /*  the first record with a quark wins, like the linear search did  */
+  if (! prev || prev > i + 1)
+    g_hash_table_insert (index, GUINT_TO_POINTER (quark),
+                         GINT_TO_POINTER (i + 1));
+}
+
+static GimpTagCacheRecord *
+gimp_tag_cache_lookup_record (GimpTagCache *cache,
+                              GHashTable   *index,
+                              GQuark        quark)
+{
+  gint i = GPOINTER_TO_INT (g_hash_table_lookup (index,
+                                                 GUINT_TO_POINTER (quark)));
+
+  if (i)
+    return &g_array_index (cache->priv->records, GimpTagCacheRecord, i - 1);
+
+  return NULL;
 }
 
 static void
@@ -487,6 +544,8 @@ gimp_tag_cache_load (GimpTagCache *cache)
 
   /* clear any previous priv->records */
   cache->priv->records = g_array_set_size (cache->priv->records, 0);
+  g_hash_table_remove_all (cache->priv->identifier_index);
+  g_hash_table_remove_all (cache->priv->checksum_index);
 
   parse_data.records = g_array_new (FALSE, FALSE, sizeof (GimpTagCacheRecord));
   memset (&parse_data.current_record, 0, sizeof (GimpTagCacheRecord));
@@ -503,9 +562,25 @@ gimp_tag_cache_load (GimpTagCache *cache)
 
   if (gimp_xml_parser_parse_gfile (xml_parser, file, &error))
     {
+      gint i;
+
       cache->priv->records = g_array_append_vals (cache->priv->records,
                                                   parse_data.records->data,
                                                   parse_data.records->len);
+
+      for (i = 0; i < cache->priv->records->len; i++)
+        {
+          GimpTagCacheRecord *rec = &g_array_index (cache->priv->records,
+                                                    GimpTagCacheRecord, i);
+
+          if (rec->identifier)
+            gimp_tag_cache_index_record (cache->priv->identifier_index,
+                                         rec->identifier, i);
+
+          if (rec->checksum)
+            gimp_tag_cache_index_record (cache->priv->checksum_index,
+                                         rec->checksum, i);
+        }
     }
   else
     {
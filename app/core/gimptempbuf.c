@@ -37,11 +37,13 @@
 
 struct _GimpTempBuf
 {
-  gint        ref_count;
-  gint        width;
-  gint        height;
-  const Babl *format;
-  guchar     *data;
+  gint            ref_count;
+  gint            width;
+  gint            height;
+  const Babl     *format;
+  guchar         *data;
+  GDestroyNotify  data_destroy;
+  gpointer        destroy_data;
 };
 
 typedef struct
@@ -77,11 +79,47 @@ gimp_temp_buf_new (gint        width,
 
   temp = g_slice_new (GimpTempBuf);
 
-  temp->ref_count = 1;
-  temp->width     = width;
-  temp->height    = height;
-  temp->format    = format;
-  temp->data      = gegl_malloc ((gsize) width * height * bpp);
+  temp->ref_count    = 1;
+  temp->width        = width;
+  temp->height       = height;
+  temp->format       = format;
+  temp->data         = gegl_malloc ((gsize) width * height * bpp);
+  temp->data_destroy = NULL;
+  temp->destroy_data = NULL;
+
+  g_atomic_pointer_add (&gimp_temp_buf_total_memsize,
+                        +gimp_temp_buf_get_memsize (temp));
+
+  return temp;
+}
+
+/*  wraps "data", which must stay valid, and isn't modified, until
+ *  "data_destroy" is called with "destroy_data" when the buffer is
+ *  freed.
+ */
+GimpTempBuf *
+gimp_temp_buf_new_for_data (gint            width,
+                            gint            height,
+                            const Babl     *format,
+                            gpointer        data,
+                            GDestroyNotify  data_destroy,
+                            gpointer        destroy_data)
+{
+  GimpTempBuf *temp;
+
+  g_return_val_if_fail (format != NULL, NULL);
+  g_return_val_if_fail (width > 0 && height > 0, NULL);
+  g_return_val_if_fail (data != NULL, NULL);
+
+  temp = g_slice_new (GimpTempBuf);
+
+  temp->ref_count    = 1;
+  temp->width        = width;
+  temp->height       = height;
+  temp->format       = format;
+  temp->data         = data;
+  temp->data_destroy = data_destroy;
+  temp->destroy_data = destroy_data;
 
   g_atomic_pointer_add (&gimp_temp_buf_total_memsize,
                         +gimp_temp_buf_get_memsize (temp));
@@ -173,8 +211,9 @@ gimp_temp_buf_unref (const GimpTempBuf *buf)
       g_atomic_pointer_add (&gimp_temp_buf_total_memsize,
                             -gimp_temp_buf_get_memsize (buf));
 
-
-      if (buf->data)
+      if (buf->data_destroy)
+        buf->data_destroy (buf->destroy_data);
+      else if (buf->data)
         gegl_free (buf->data);
 
       g_slice_free (GimpTempBuf, (GimpTempBuf *) buf);
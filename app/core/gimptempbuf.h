@@ -22,6 +22,12 @@
 GimpTempBuf * gimp_temp_buf_new               (gint               width,
                                                gint               height,
                                                const Babl        *format) G_GNUC_WARN_UNUSED_RESULT;
+GimpTempBuf * gimp_temp_buf_new_for_data      (gint               width,
+                                               gint               height,
+                                               const Babl        *format,
+                                               gpointer           data,
+                                               GDestroyNotify     data_destroy,
+                                               gpointer           destroy_data) G_GNUC_WARN_UNUSED_RESULT;
 GimpTempBuf * gimp_temp_buf_new_from_pixbuf   (GdkPixbuf         *pixbuf,
                                                const Babl        *f_or_null) G_GNUC_WARN_UNUSED_RESULT;
 GimpTempBuf * gimp_temp_buf_copy              (const GimpTempBuf *src) G_GNUC_WARN_UNUSED_RESULT;
@@ -61,6 +61,8 @@ struct _GimpUndo
 
   GimpTempBuf      *preview;
   guint             preview_idle_id;
+
+  gint64            stack_memsize;  /* memsize when added to its stack   */
 };
 
 struct _GimpUndoClass
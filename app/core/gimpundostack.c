@@ -125,6 +125,8 @@ gimp_undo_stack_free (GimpUndo     *undo,
     }
 
   gimp_container_clear (stack->undos);
+
+  stack->undos_memsize = 0;
 }
 
 GimpUndoStack *
@@ -144,6 +146,9 @@ gimp_undo_stack_push_undo (GimpUndoStack *stack,
   g_return_if_fail (GIMP_IS_UNDO_STACK (stack));
   g_return_if_fail (GIMP_IS_UNDO (undo));
 
+  undo->stack_memsize = gimp_object_get_memsize (GIMP_OBJECT (undo), NULL);
+  stack->undos_memsize += undo->stack_memsize;
+
   gimp_container_add (stack->undos, GIMP_OBJECT (undo));
 }
 
@@ -161,6 +166,8 @@ gimp_undo_stack_pop_undo (GimpUndoStack       *stack,
 
   if (undo)
     {
+      stack->undos_memsize -= undo->stack_memsize;
+
       gimp_container_remove (stack->undos, GIMP_OBJECT (undo));
       gimp_undo_pop (undo, undo_mode, accum);
 
@@ -182,6 +189,8 @@ gimp_undo_stack_free_bottom (GimpUndoStack *stack,
 
   if (undo)
     {
+      stack->undos_memsize -= undo->stack_memsize;
+
       gimp_container_remove (stack->undos, GIMP_OBJECT (undo));
       gimp_undo_free (undo, undo_mode);
 
@@ -206,3 +215,30 @@ gimp_undo_stack_get_depth (GimpUndoStack *stack)
 
   return gimp_container_get_n_children (stack->undos);
 }
+
+/*  re-measures an undo of the stack whose size changed since it was
+ *  pushed, such as an undo group that got more undos added to it.
+ */
+void
+gimp_undo_stack_undo_changed (GimpUndoStack *stack,
+                              GimpUndo      *undo)
+{
+  g_return_if_fail (GIMP_IS_UNDO_STACK (stack));
+  g_return_if_fail (GIMP_IS_UNDO (undo));
+
+  stack->undos_memsize -= undo->stack_memsize;
+
+  undo->stack_memsize = gimp_object_get_memsize (GIMP_OBJECT (undo), NULL);
+  stack->undos_memsize += undo->stack_memsize;
+}
+
+/*  the total size of the stack's undos, as they were when pushed, without
+ *  walking them.
+ */
+gint64
+gimp_undo_stack_get_undos_memsize (GimpUndoStack *stack)
+{
+  g_return_val_if_fail (GIMP_IS_UNDO_STACK (stack), 0);
+
+  return stack->undos_memsize;
+}
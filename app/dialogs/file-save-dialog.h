@@ -35,6 +35,7 @@ gboolean    file_save_dialog_save_image (GimpProgress        *progress_and_handl
                                          gboolean             export_backward,
                                          gboolean             export_forward,
                                          gboolean             xcf_compression,
+                                         gboolean             xcf_zstd,
                                          gboolean             verbose_cancel);
 
 
@@ -45,6 +45,7 @@ typedef struct _GimpToolGui              GimpToolGui;
 typedef struct _GimpToolWidget           GimpToolWidget;
 typedef struct _GimpToolWidgetGroup      GimpToolWidgetGroup;
 
+typedef struct _GimpDisplayLut           GimpDisplayLut;
 typedef struct _GimpDisplayXfer          GimpDisplayXfer;
 typedef struct _Selection                Selection;
 
@@ -47,12 +47,19 @@ enum
 };
 
 
+/*  the number of zoom octaves below 100% which get their own outline  */
+#define N_LEVELS 8
+
+
 typedef struct _GimpCanvasBoundaryPrivate GimpCanvasBoundaryPrivate;
 
 struct _GimpCanvasBoundaryPrivate
 {
   GimpBoundSeg *segs;
   gint          n_segs;
+  GimpBoundSeg *level_segs[N_LEVELS];
+  gint          n_level_segs[N_LEVELS];
+  gboolean      level_known[N_LEVELS];
   GimpMatrix3  *transform;
   gdouble       offset_x;
   gdouble       offset_y;
@@ -129,10 +136,14 @@ static void
 gimp_canvas_boundary_finalize (GObject *object)
 {
   GimpCanvasBoundaryPrivate *private = GET_PRIVATE (object);
+  gint                       i;
 
   g_clear_pointer (&private->segs, g_free);
   private->n_segs = 0;
 
+  for (i = 0; i < N_LEVELS; i++)
+    g_clear_pointer (&private->level_segs[i], g_free);
+
   g_clear_pointer (&private->transform, g_free);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -206,12 +217,66 @@ gimp_canvas_boundary_get_property (GObject    *object,
     }
 }
 
+/*  returns the segments snapped to the coarsest grid that still fits
+ *  into a display pixel, so that zoomed-out complex boundaries don't
+ *  draw many segments onto the same pixels
+ */
+static const GimpBoundSeg *
+gimp_canvas_boundary_get_segs (GimpCanvasItem *item,
+                               gint           *n_segs)
+{
+  GimpCanvasBoundaryPrivate *private = GET_PRIVATE (item);
+  GimpDisplayShell          *shell   = gimp_canvas_item_get_shell (item);
+  gdouble                    scale;
+  gint                       level   = 0;
+  gint                       i;
+
+  scale = MAX (shell->scale_x, shell->scale_y);
+
+  while (level + 1 < N_LEVELS && scale * (1 << (level + 1)) <= 1.0)
+    level++;
+
+  for (i = 1; i <= level; i++)
+    {
+      if (! private->level_known[i])
+        {
+          const GimpBoundSeg *src_segs   = private->segs;
+          gint                n_src_segs = private->n_segs;
+
+          if (i > 1)
+            {
+              src_segs   = private->level_segs[i - 1];
+              n_src_segs = private->n_level_segs[i - 1];
+            }
+
+          private->level_segs[i]  = gimp_boundary_downscale (src_segs,
+                                                             n_src_segs,
+                                                             1 << i,
+                                                             &private->n_level_segs[i]);
+          private->level_known[i] = TRUE;
+        }
+    }
+
+  if (level == 0)
+    {
+      *n_segs = private->n_segs;
+
+      return private->segs;
+    }
+
+  *n_segs = private->n_level_segs[level];
+
+  return private->level_segs[level];
+}
+
 static void
 gimp_canvas_boundary_transform (GimpCanvasItem *item,
                                 GimpSegment    *segs,
                                 gint           *n_segs)
 {
   GimpCanvasBoundaryPrivate *private = GET_PRIVATE (item);
+  const GimpBoundSeg        *src_segs;
+  gint                       n_src_segs;
   gint                       i;
 
   if (private->transform)
@@ -249,16 +314,21 @@ gimp_canvas_boundary_transform (GimpCanvasItem *item,
     }
   else
     {
-      for (i = 0; i < private->n_segs; i++)
+      /*  only here the segments' display scale is known, so only
+       *  here they can be drawn at a coarser level
+       */
+      src_segs = gimp_canvas_boundary_get_segs (item, &n_src_segs);
+
+      for (i = 0; i < n_src_segs; i++)
         {
           gimp_canvas_item_transform_xy (item,
-                                         private->segs[i].x1 + private->offset_x,
-                                         private->segs[i].y1 + private->offset_y,
+                                         src_segs[i].x1 + private->offset_x,
+                                         src_segs[i].y1 + private->offset_y,
                                          &segs[i].x1,
                                          &segs[i].y1);
           gimp_canvas_item_transform_xy (item,
-                                         private->segs[i].x2 + private->offset_x,
-                                         private->segs[i].y2 + private->offset_y,
+                                         src_segs[i].x2 + private->offset_x,
+                                         src_segs[i].y2 + private->offset_y,
                                          &segs[i].x2,
                                          &segs[i].y2);
 
@@ -267,7 +337,7 @@ gimp_canvas_boundary_transform (GimpCanvasItem *item,
            *  lie outside the region...
            *  we need to transform it by one display pixel
            */
-          if (! private->segs[i].open)
+          if (! src_segs[i].open)
             {
               /*  If it is vertical  */
               if (segs[i].x1 == segs[i].x2)
@@ -283,7 +353,7 @@ gimp_canvas_boundary_transform (GimpCanvasItem *item,
             }
         }
 
-      *n_segs = private->n_segs;
+      *n_segs = n_src_segs;
     }
 }
 
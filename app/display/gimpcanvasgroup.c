@@ -40,16 +40,29 @@ enum
 };
 
 
+typedef struct _GimpCanvasGroupChild GimpCanvasGroupChild;
+
+struct _GimpCanvasGroupChild
+{
+  GList                 *link;
+  guint                  extents_serial;
+  gboolean               has_extents;
+  cairo_rectangle_int_t  extents;
+};
+
 struct _GimpCanvasGroupPrivate
 {
-  GQueue   *items;
-  gboolean  group_stroking;
-  gboolean  group_filling;
+  GQueue     *items;
+  GHashTable *children;
+  guint       extents_serial;
+  gboolean    group_stroking;
+  gboolean    group_filling;
 };
 
 
 /*  local function prototypes  */
 
+static void             gimp_canvas_group_constructed  (GObject         *object);
 static void             gimp_canvas_group_finalize     (GObject         *object);
 static void             gimp_canvas_group_set_property (GObject         *object,
                                                         guint            property_id,
@@ -69,6 +82,14 @@ static gboolean         gimp_canvas_group_hit          (GimpCanvasItem  *item,
 static void             gimp_canvas_group_child_update (GimpCanvasItem  *item,
                                                         cairo_region_t  *region,
                                                         GimpCanvasGroup *group);
+static void             gimp_canvas_group_transformed  (GimpCanvasGroup *group);
+
+static GimpCanvasGroupChild *
+                 gimp_canvas_group_child_new     (GList                       *link);
+static void      gimp_canvas_group_child_free    (GimpCanvasGroupChild        *child);
+static gboolean  gimp_canvas_group_child_visible (GimpCanvasGroup             *group,
+                                                  GimpCanvasItem              *item,
+                                                  const cairo_rectangle_int_t *clip);
 
 
 G_DEFINE_TYPE_WITH_PRIVATE (GimpCanvasGroup, gimp_canvas_group,
@@ -83,6 +104,7 @@ gimp_canvas_group_class_init (GimpCanvasGroupClass *klass)
   GObjectClass        *object_class = G_OBJECT_CLASS (klass);
   GimpCanvasItemClass *item_class   = GIMP_CANVAS_ITEM_CLASS (klass);
 
+  object_class->constructed  = gimp_canvas_group_constructed;
   object_class->finalize     = gimp_canvas_group_finalize;
   object_class->set_property = gimp_canvas_group_set_property;
   object_class->get_property = gimp_canvas_group_get_property;
@@ -109,7 +131,35 @@ gimp_canvas_group_init (GimpCanvasGroup *group)
 {
   group->priv = gimp_canvas_group_get_instance_private (group);
 
-  group->priv->items = g_queue_new ();
+  group->priv->items    = g_queue_new ();
+  group->priv->children = g_hash_table_new_full (g_direct_hash,
+                                                 g_direct_equal,
+                                                 NULL,
+                                                 (GDestroyNotify) gimp_canvas_group_child_free);
+
+  /*  serial 0 marks cached child extents as invalid  */
+  group->priv->extents_serial = 1;
+}
+
+static void
+gimp_canvas_group_constructed (GObject *object)
+{
+  GimpCanvasGroup  *group = GIMP_CANVAS_GROUP (object);
+  GimpDisplayShell *shell;
+
+  G_OBJECT_CLASS (parent_class)->constructed (object);
+
+  shell = gimp_canvas_item_get_shell (GIMP_CANVAS_ITEM (group));
+
+  /*  the children's extents are in unrotated display coordinates, so
+   *  only scaling and scrolling invalidate them all at once
+   */
+  g_signal_connect_object (shell, "scaled",
+                           G_CALLBACK (gimp_canvas_group_transformed),
+                           group, G_CONNECT_SWAPPED);
+  g_signal_connect_object (shell, "scrolled",
+                           G_CALLBACK (gimp_canvas_group_transformed),
+                           group, G_CONNECT_SWAPPED);
 }
 
 static void
@@ -124,6 +174,8 @@ gimp_canvas_group_finalize (GObject *object)
   g_queue_free (group->priv->items);
   group->priv->items = NULL;
 
+  g_clear_pointer (&group->priv->children, g_hash_table_unref);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -177,14 +229,27 @@ static void
 gimp_canvas_group_draw (GimpCanvasItem *item,
                         cairo_t        *cr)
 {
-  GimpCanvasGroup *group = GIMP_CANVAS_GROUP (item);
-  GList           *list;
+  GimpCanvasGroup       *group = GIMP_CANVAS_GROUP (item);
+  cairo_rectangle_int_t  clip;
+  gdouble                x1, y1, x2, y2;
+  GList                 *list;
+
+  /*  skip the children that lie entirely outside of the clip, so that
+   *  exposing a small area doesn't draw all of a large group
+   */
+  cairo_clip_extents (cr, &x1, &y1, &x2, &y2);
+
+  clip.x      = floor (x1);
+  clip.y      = floor (y1);
+  clip.width  = ceil (x2) - clip.x;
+  clip.height = ceil (y2) - clip.y;
 
   for (list = group->priv->items->head; list; list = g_list_next (list))
     {
       GimpCanvasItem *sub_item = list->data;
 
-      gimp_canvas_item_draw (sub_item, cr);
+      if (gimp_canvas_group_child_visible (group, sub_item, &clip))
+        gimp_canvas_item_draw (sub_item, cr);
     }
 
   if (group->priv->group_stroking)
@@ -242,10 +307,77 @@ gimp_canvas_group_child_update (GimpCanvasItem  *item,
                                 cairo_region_t  *region,
                                 GimpCanvasGroup *group)
 {
+  GimpCanvasGroupChild *child = g_hash_table_lookup (group->priv->children,
+                                                     item);
+
+  if (child)
+    child->extents_serial = 0;
+
   if (_gimp_canvas_item_needs_update (GIMP_CANVAS_ITEM (group)))
     _gimp_canvas_item_update (GIMP_CANVAS_ITEM (group), region);
 }
 
+static void
+gimp_canvas_group_transformed (GimpCanvasGroup *group)
+{
+  group->priv->extents_serial++;
+
+  if (group->priv->extents_serial == 0)
+    group->priv->extents_serial = 1;
+}
+
+static GimpCanvasGroupChild *
+gimp_canvas_group_child_new (GList *link)
+{
+  GimpCanvasGroupChild *child = g_slice_new0 (GimpCanvasGroupChild);
+
+  child->link = link;
+
+  return child;
+}
+
+static void
+gimp_canvas_group_child_free (GimpCanvasGroupChild *child)
+{
+  g_slice_free (GimpCanvasGroupChild, child);
+}
+
+static gboolean
+gimp_canvas_group_child_visible (GimpCanvasGroup             *group,
+                                 GimpCanvasItem              *item,
+                                 const cairo_rectangle_int_t *clip)
+{
+  GimpCanvasGroupChild *child = g_hash_table_lookup (group->priv->children,
+                                                     item);
+
+  if (! gimp_canvas_item_get_visible (item))
+    return FALSE;
+
+  if (child->extents_serial != group->priv->extents_serial)
+    {
+      cairo_region_t *region = gimp_canvas_item_get_extents (item);
+
+      child->has_extents = region != NULL;
+
+      if (region)
+        {
+          cairo_region_get_extents (region, &child->extents);
+          cairo_region_destroy (region);
+        }
+
+      child->extents_serial = group->priv->extents_serial;
+    }
+
+  /*  items without extents might still draw something  */
+  if (! child->has_extents)
+    return TRUE;
+
+  return (child->extents.x < clip->x + clip->width  &&
+          child->extents.y < clip->y + clip->height &&
+          child->extents.x + child->extents.width  > clip->x &&
+          child->extents.y + child->extents.height > clip->y);
+}
+
 
 /*  public functions  */
 
@@ -266,6 +398,7 @@ gimp_canvas_group_add_item (GimpCanvasGroup *group,
   g_return_if_fail (GIMP_IS_CANVAS_GROUP (group));
   g_return_if_fail (GIMP_IS_CANVAS_ITEM (item));
   g_return_if_fail (GIMP_CANVAS_ITEM (group) != item);
+  g_return_if_fail (! g_hash_table_contains (group->priv->children, item));
 
   if (group->priv->group_stroking)
     gimp_canvas_item_suspend_stroking (item);
@@ -275,6 +408,9 @@ gimp_canvas_group_add_item (GimpCanvasGroup *group,
 
   g_queue_push_tail (group->priv->items, g_object_ref (item));
 
+  g_hash_table_insert (group->priv->children, item,
+                       gimp_canvas_group_child_new (group->priv->items->tail));
+
   if (_gimp_canvas_item_needs_update (GIMP_CANVAS_ITEM (group)))
     {
       cairo_region_t *region = gimp_canvas_item_get_extents (item);
@@ -295,16 +431,17 @@ void
 gimp_canvas_group_remove_item (GimpCanvasGroup *group,
                                GimpCanvasItem  *item)
 {
-  GList *list;
+  GimpCanvasGroupChild *child;
 
   g_return_if_fail (GIMP_IS_CANVAS_GROUP (group));
   g_return_if_fail (GIMP_IS_CANVAS_ITEM (item));
 
-  list = g_queue_find (group->priv->items, item);
+  child = g_hash_table_lookup (group->priv->children, item);
 
-  g_return_if_fail (list != NULL);
+  g_return_if_fail (child != NULL);
 
-  g_queue_delete_link (group->priv->items, list);
+  g_queue_delete_link (group->priv->items, child->link);
+  g_hash_table_remove (group->priv->children, item);
 
   if (group->priv->group_stroking)
     gimp_canvas_item_resume_stroking (item);
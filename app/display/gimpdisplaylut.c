@@ -0,0 +1,250 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimpdisplaylut.c
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <gegl.h>
+#include <gtk/gtk.h>
+
+#include "libgimpcolor/gimpcolor.h"
+
+#include "display-types.h"
+
+#include "gimpdisplaylut.h"
+
+
+#define LUT_SIZE 33
+
+
+struct _GimpDisplayLut
+{
+  const Babl *src_format;
+  const Babl *dest_format;
+
+  gfloat      table[LUT_SIZE * LUT_SIZE * LUT_SIZE][3];
+};
+
+
+/*  local function prototypes  */
+
+static inline void   gimp_display_lut_lookup (const GimpDisplayLut *lut,
+                                              const gfloat         *src,
+                                              gfloat               *dest);
+
+
+/*  public functions  */
+
+/*  @src_format and @dest_format are the formats of the buffers the table
+ *  is going to be applied to, which are read and written as R'G'B'A float
+ *  in their own color spaces, so @dest_format should be an R'G'B'A float
+ *  format.  source values out of the [0, 1] range are clipped.
+ */
+GimpDisplayLut *
+gimp_display_lut_new (GimpColorTransform *transform,
+                      const Babl         *src_format,
+                      const Babl         *dest_format)
+{
+  GimpDisplayLut *lut;
+  gfloat         *grid;
+  gint            r, g, b;
+  gint            i;
+
+  g_return_val_if_fail (GIMP_IS_COLOR_TRANSFORM (transform), NULL);
+  g_return_val_if_fail (src_format != NULL, NULL);
+  g_return_val_if_fail (dest_format != NULL, NULL);
+
+  lut = g_slice_new (GimpDisplayLut);
+
+  lut->src_format  = babl_format_with_space ("R'G'B'A float", src_format);
+  lut->dest_format = babl_format_with_space ("R'G'B'A float", dest_format);
+
+  grid = g_new (gfloat, G_N_ELEMENTS (lut->table) * 3);
+
+  for (r = 0, i = 0; r < LUT_SIZE; r++)
+    {
+      for (g = 0; g < LUT_SIZE; g++)
+        {
+          for (b = 0; b < LUT_SIZE; b++, i += 3)
+            {
+              grid[i + 0] = (gfloat) r / (LUT_SIZE - 1);
+              grid[i + 1] = (gfloat) g / (LUT_SIZE - 1);
+              grid[i + 2] = (gfloat) b / (LUT_SIZE - 1);
+            }
+        }
+    }
+
+  gimp_color_transform_process_pixels (transform,
+                                       babl_format ("R'G'B' float"), grid,
+                                       babl_format ("R'G'B' float"), lut->table,
+                                       G_N_ELEMENTS (lut->table));
+
+  g_free (grid);
+
+  return lut;
+}
+
+void
+gimp_display_lut_free (GimpDisplayLut *lut)
+{
+  g_return_if_fail (lut != NULL);
+
+  g_slice_free (GimpDisplayLut, lut);
+}
+
+/*  @src_buffer and @dest_buffer may be the same buffer.  */
+void
+gimp_display_lut_process_buffer (GimpDisplayLut      *lut,
+                                 GeglBuffer          *src_buffer,
+                                 const GeglRectangle *src_rect,
+                                 GeglBuffer          *dest_buffer,
+                                 const GeglRectangle *dest_rect)
+{
+  GeglBufferIterator *iter;
+  gboolean            in_place;
+
+  g_return_if_fail (lut != NULL);
+  g_return_if_fail (GEGL_IS_BUFFER (src_buffer));
+  g_return_if_fail (GEGL_IS_BUFFER (dest_buffer));
+
+  if (! src_rect)
+    src_rect = gegl_buffer_get_extent (src_buffer);
+
+  if (! dest_rect)
+    dest_rect = gegl_buffer_get_extent (dest_buffer);
+
+  in_place = src_buffer == dest_buffer &&
+             gegl_rectangle_equal (src_rect, dest_rect);
+
+  if (in_place)
+    {
+      iter = gegl_buffer_iterator_new (src_buffer, src_rect, 0,
+                                       lut->src_format,
+                                       GEGL_ACCESS_READWRITE,
+                                       GEGL_ABYSS_NONE, 1);
+    }
+  else
+    {
+      iter = gegl_buffer_iterator_new (src_buffer, src_rect, 0,
+                                       lut->src_format,
+                                       GEGL_ACCESS_READ,
+                                       GEGL_ABYSS_NONE, 2);
+
+      gegl_buffer_iterator_add (iter, dest_buffer, dest_rect, 0,
+                                lut->dest_format,
+                                GEGL_ACCESS_WRITE, GEGL_ABYSS_NONE);
+    }
+
+  while (gegl_buffer_iterator_next (iter))
+    {
+      const gfloat *src   = iter->items[0].data;
+      gfloat       *dest  = in_place ? iter->items[0].data :
+                                       iter->items[1].data;
+      gint          count = iter->length;
+
+      while (count--)
+        {
+          gimp_display_lut_lookup (lut, src, dest);
+
+          dest[3] = src[3];
+
+          src  += 4;
+          dest += 4;
+        }
+    }
+}
+
+
+/*  private functions  */
+
+/*  tetrahedral interpolation: the cell around the pixel is split into six
+ *  tetrahedra along its black-white diagonal, and the pixel is interpolated
+ *  from the four corners of the one it falls into.
+ */
+static inline void
+gimp_display_lut_lookup (const GimpDisplayLut *lut,
+                         const gfloat         *src,
+                         gfloat               *dest)
+{
+  const gint s[3] = { LUT_SIZE * LUT_SIZE * 3, LUT_SIZE * 3, 3 };
+  gfloat     f[3];
+  gint       offset = 0;
+  gint       d1, d2, d3;
+  gfloat     w1, w2, w3;
+  gint       i;
+
+  for (i = 0; i < 3; i++)
+    {
+      gfloat v = CLAMP (src[i], 0.0f, 1.0f) * (LUT_SIZE - 1);
+      gint   n = MIN ((gint) v, LUT_SIZE - 2);
+
+      f[i]    = v - n;
+      offset += n * s[i];
+    }
+
+  /*  d1, d2 and d3 are the steps from the black corner, along the
+   *  channels in decreasing fraction order, and w1, w2, w3 their weights
+   */
+  if (f[0] >= f[1])
+    {
+      if (f[1] >= f[2])
+        {
+          d1 = s[0]; d2 = s[0] + s[1]; w1 = f[0]; w2 = f[1]; w3 = f[2];
+        }
+      else if (f[0] >= f[2])
+        {
+          d1 = s[0]; d2 = s[0] + s[2]; w1 = f[0]; w2 = f[2]; w3 = f[1];
+        }
+      else
+        {
+          d1 = s[2]; d2 = s[2] + s[0]; w1 = f[2]; w2 = f[0]; w3 = f[1];
+        }
+    }
+  else
+    {
+      if (f[0] >= f[2])
+        {
+          d1 = s[1]; d2 = s[1] + s[0]; w1 = f[1]; w2 = f[0]; w3 = f[2];
+        }
+      else if (f[1] >= f[2])
+        {
+          d1 = s[1]; d2 = s[1] + s[2]; w1 = f[1]; w2 = f[2]; w3 = f[0];
+        }
+      else
+        {
+          d1 = s[2]; d2 = s[2] + s[1]; w1 = f[2]; w2 = f[1]; w3 = f[0];
+        }
+    }
+
+  d3 = s[0] + s[1] + s[2];
+
+  {
+    const gfloat *c0 = &lut->table[0][0] + offset;
+    const gfloat *c1 = c0 + d1;
+    const gfloat *c2 = c0 + d2;
+    const gfloat *c3 = c0 + d3;
+
+    for (i = 0; i < 3; i++)
+      {
+        dest[i] = c0[i]                +
+                  w1 * (c1[i] - c0[i]) +
+                  w2 * (c2[i] - c1[i]) +
+                  w3 * (c3[i] - c2[i]);
+      }
+  }
+}
@@ -28,6 +28,7 @@
 #include "core/gimp.h"
 #include "core/gimpimage.h"
 #include "core/gimpimage-quick-mask.h"
+#include "core/gimpprojection.h"
 
 #include "widgets/gimpcairo-wilber.h"
 #include "widgets/gimpuimanager.h"
@@ -69,6 +70,9 @@ static gboolean   gimp_display_shell_hscrollbar_change_value  (GtkRange
                                                                gdouble           value,
                                                                GimpDisplayShell *shell);
 
+static void       gimp_display_shell_canvas_after_paint       (GdkFrameClock    *frame_clock,
+                                                              GimpDisplayShell *shell);
+
 static void       gimp_display_shell_canvas_draw_image        (GimpDisplayShell *shell,
                                                                cairo_t          *cr);
 static void       gimp_display_shell_canvas_draw_drop_zone    (GimpDisplayShell *shell,
@@ -118,6 +122,31 @@ gimp_display_shell_canvas_realize (GtkWidget        *canvas,
                     G_CALLBACK (gimp_display_shell_vscrollbar_change_value),
                     shell);
 
+  /*  split each frame between drawing the canvas and rendering the
+   *  projection
+   */
+  if (shell->frame_clock)
+    {
+      g_signal_handler_disconnect (shell->frame_clock, shell->frame_handler);
+      g_object_remove_weak_pointer (G_OBJECT (shell->frame_clock),
+                                    (gpointer) &shell->frame_clock);
+    }
+
+  shell->frame_clock   = gtk_widget_get_frame_clock (canvas);
+  shell->frame_handler = 0;
+  shell->frame_time    = 0;
+
+  if (shell->frame_clock)
+    {
+      g_object_add_weak_pointer (G_OBJECT (shell->frame_clock),
+                                 (gpointer) &shell->frame_clock);
+
+      shell->frame_handler =
+        g_signal_connect (shell->frame_clock, "after-paint",
+                          G_CALLBACK (gimp_display_shell_canvas_after_paint),
+                          shell);
+    }
+
   /*  allow shrinking  */
   gtk_widget_set_size_request (GTK_WIDGET (shell), 0, 0);
 }
@@ -296,6 +325,8 @@ gimp_display_shell_canvas_draw (GtkWidget        *widget,
   /*  ignore events on overlays  */
   if (gtk_cairo_should_draw_window (cr, gtk_widget_get_window (widget)))
     {
+      gint64 start_time = g_get_monotonic_time ();
+
       if (gimp_display_get_image (shell->display))
         {
           gimp_display_shell_canvas_draw_image (shell, cr);
@@ -304,6 +335,8 @@ gimp_display_shell_canvas_draw (GtkWidget        *widget,
         {
           gimp_display_shell_canvas_draw_drop_zone (shell, cr);
         }
+
+      shell->frame_draw_time = g_get_monotonic_time () - start_time;
     }
 
   return FALSE;
@@ -404,6 +437,68 @@ gimp_display_shell_navigation_button_press (GtkWidget        *widget,
 
 /*  private functions  */
 
+static void
+gimp_display_shell_canvas_after_paint (GdkFrameClock    *frame_clock,
+                                       GimpDisplayShell *shell)
+{
+  GimpImage      *image = NULL;
+  GimpProjection *projection;
+  gint64          frame_time;
+  gint64          refresh_interval;
+  gint64          budget;
+
+  if (shell->display)
+    image = gimp_display_get_image (shell->display);
+
+  if (! image)
+    {
+      shell->frame_time = 0;
+
+      return;
+    }
+
+  projection = gimp_image_get_projection (image);
+
+  frame_time = gdk_frame_clock_get_frame_time (frame_clock);
+
+  gdk_frame_clock_get_refresh_info (frame_clock, frame_time,
+                                    &refresh_interval, NULL);
+
+  if (refresh_interval <= 0)
+    refresh_interval = G_TIME_SPAN_SECOND / 60;
+
+  /*  render the projection in what's left of the frame after drawing the
+   *  canvas, but always make some progress
+   */
+  budget = MAX (refresh_interval - shell->frame_draw_time,
+                refresh_interval / 4);
+
+  gimp_projection_set_frame_budget (projection,
+                                    (gdouble) budget / G_TIME_SPAN_SECOND);
+
+  /*  while the projection is rendering, its updates keep the frame clock
+   *  running, so a gap of more than a refresh interval between two frames
+   *  means frames were dropped
+   */
+  if (gimp_projection_is_rendering (projection))
+    {
+      if (shell->frame_time)
+        {
+          gint64 n_frames = (frame_time - shell->frame_time +
+                             refresh_interval / 2) / refresh_interval;
+
+          if (n_frames > 1)
+            gimp_projection_add_dropped_frames (projection, n_frames - 1);
+        }
+
+      shell->frame_time = frame_time;
+    }
+  else
+    {
+      shell->frame_time = 0;
+    }
+}
+
 static void
 gimp_display_shell_vadjustment_changed (GtkAdjustment    *adjustment,
                                         GimpDisplayShell *shell)
@@ -40,17 +40,21 @@
 #include "gimpdisplayshell-actions.h"
 #include "gimpdisplayshell-filter.h"
 #include "gimpdisplayshell-profile.h"
+#include "gimpdisplaylut.h"
 
 #include "gimp-intl.h"
 
 
 /*  local function prototypes  */
 
-static void   gimp_display_shell_profile_free        (GimpDisplayShell *shell);
+static void     gimp_display_shell_profile_free        (GimpDisplayShell *shell);
+static gboolean gimp_display_shell_profile_can_bake    (GimpDisplayShell *shell,
+                                                        GimpColorProfile *src_profile,
+                                                        const Babl       *src_format);
 
-static void   gimp_display_shell_color_config_notify (GimpColorConfig  *config,
-                                                      const GParamSpec *pspec,
-                                                      GimpDisplayShell *shell);
+static void     gimp_display_shell_color_config_notify (GimpColorConfig  *config,
+                                                        const GParamSpec *pspec,
+                                                        GimpDisplayShell *shell);
 
 
 /*  public functions  */
@@ -156,6 +160,20 @@ gimp_display_shell_profile_update (GimpDisplayShell *shell)
                                      filter_format,
                                      dest_format);
 
+  /*  the table is only used for converting to filter_buffer, see
+   *  gimp_display_shell_profile_convert_buffer()
+   */
+  if (shell->profile_transform                                &&
+      (gimp_display_shell_has_filter (shell) ||
+       ! gimp_display_shell_profile_can_convert_to_u8 (shell)) &&
+      gimp_display_shell_profile_can_bake (shell,
+                                           filter_profile, filter_format))
+    {
+      shell->profile_lut = gimp_display_lut_new (shell->profile_transform,
+                                                 filter_format,
+                                                 shell->filter_format);
+    }
+
   if (shell->filter_transform || shell->profile_transform)
     {
       gint w = shell->render_buf_width;
@@ -211,12 +229,40 @@ gimp_display_shell_profile_can_convert_to_u8 (GimpDisplayShell *shell)
   return FALSE;
 }
 
+/*  converts the pixels of src_buffer to dest_buffer, which must have
+ *  the format of shell->filter_buffer, using the profile transform.
+ */
+void
+gimp_display_shell_profile_convert_buffer (GimpDisplayShell    *shell,
+                                           GeglBuffer          *src_buffer,
+                                           const GeglRectangle *src_rect,
+                                           GeglBuffer          *dest_buffer,
+                                           const GeglRectangle *dest_rect)
+{
+  g_return_if_fail (GIMP_IS_DISPLAY_SHELL (shell));
+  g_return_if_fail (shell->profile_transform != NULL);
+
+  if (shell->profile_lut)
+    {
+      gimp_display_lut_process_buffer (shell->profile_lut,
+                                       src_buffer,  src_rect,
+                                       dest_buffer, dest_rect);
+    }
+  else
+    {
+      gimp_color_transform_process_buffer (shell->profile_transform,
+                                           src_buffer,  src_rect,
+                                           dest_buffer, dest_rect);
+    }
+}
+
 
 /*  private functions  */
 
 static void
 gimp_display_shell_profile_free (GimpDisplayShell *shell)
 {
+  g_clear_pointer (&shell->profile_lut, gimp_display_lut_free);
   g_clear_object (&shell->profile_transform);
   g_clear_object (&shell->filter_transform);
   g_clear_object (&shell->profile_buffer);
@@ -224,6 +270,66 @@ gimp_display_shell_profile_free (GimpDisplayShell *shell)
   shell->profile_stride = 0;
 }
 
+/*  whether to bake the profile transform into a lookup table, which is
+ *  worth it when the transform goes through lcms, that is when
+ *  soft-proofing, or when one of the profiles has no babl space.  the
+ *  "optimize" options let the user prefer quality over speed.
+ */
+static gboolean
+gimp_display_shell_profile_can_bake (GimpDisplayShell *shell,
+                                     GimpColorProfile *src_profile,
+                                     const Babl       *src_format)
+{
+  GimpColorConfig  *config       = gimp_display_shell_get_color_config (shell);
+  GimpColorProfile *dest_profile = NULL;
+  gboolean          bake         = FALSE;
+
+  if (gimp_babl_format_get_base_type (src_format) != GIMP_RGB)
+    return FALSE;
+
+  if (gimp_color_config_get_mode (config) == GIMP_COLOR_MANAGEMENT_SOFTPROOF)
+    {
+      GimpColorProfile *proof_profile;
+
+      proof_profile =
+        gimp_color_config_get_simulation_color_profile (config, NULL);
+
+      if (proof_profile)
+        {
+          g_object_unref (proof_profile);
+
+          return gimp_color_config_get_simulation_optimize (config);
+        }
+    }
+
+  if (! gimp_color_config_get_display_optimize (config))
+    return FALSE;
+
+  /*  the same display profile as gimp_widget_get_color_transform() uses  */
+  if (gimp_color_config_get_display_profile_from_gdk (config))
+    {
+      dest_profile =
+        gimp_widget_get_color_profile (gtk_widget_get_toplevel (GTK_WIDGET (shell)));
+    }
+
+  if (! dest_profile)
+    dest_profile = gimp_color_config_get_display_color_profile (config, NULL);
+
+  if (dest_profile)
+    {
+      bake = ! gimp_color_profile_get_space (src_profile,
+                                             GIMP_COLOR_RENDERING_INTENT_RELATIVE_COLORIMETRIC,
+                                             NULL) ||
+             ! gimp_color_profile_get_space (dest_profile,
+                                             gimp_color_config_get_display_intent (config),
+                                             NULL);
+
+      g_object_unref (dest_profile);
+    }
+
+  return bake;
+}
+
 static void
 gimp_display_shell_color_config_notify (GimpColorConfig  *config,
                                         const GParamSpec *pspec,
@@ -19,12 +19,18 @@
 #define __GIMP_DISPLAY_SHELL_PROFILE_H__
 
 
-void     gimp_display_shell_profile_init              (GimpDisplayShell *shell);
-void     gimp_display_shell_profile_finalize          (GimpDisplayShell *shell);
+void     gimp_display_shell_profile_init              (GimpDisplayShell    *shell);
+void     gimp_display_shell_profile_finalize          (GimpDisplayShell    *shell);
 
-void     gimp_display_shell_profile_update            (GimpDisplayShell *shell);
+void     gimp_display_shell_profile_update            (GimpDisplayShell    *shell);
 
-gboolean gimp_display_shell_profile_can_convert_to_u8 (GimpDisplayShell *shell);
+gboolean gimp_display_shell_profile_can_convert_to_u8 (GimpDisplayShell    *shell);
+
+void     gimp_display_shell_profile_convert_buffer    (GimpDisplayShell    *shell,
+                                                       GeglBuffer          *src_buffer,
+                                                       const GeglRectangle *src_rect,
+                                                       GeglBuffer          *dest_buffer,
+                                                       const GeglRectangle *dest_rect);
 
 
 #endif /*  __GIMP_DISPLAY_SHELL_PROFILE_H__  */
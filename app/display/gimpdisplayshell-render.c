@@ -17,6 +17,9 @@
 
 #include "config.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 #include <gegl.h>
 #include <gtk/gtk.h>
 
@@ -42,6 +45,29 @@
 
 #define GIMP_DISPLAY_RENDER_ENABLE_SCALING 1
 #define GIMP_DISPLAY_RENDER_MAX_SCALE      4
+#define GIMP_DISPLAY_RENDER_MAX_LEVELS     2
+
+
+/*  the render cache of a previous scale, kept around so that zooming back
+ *  to that scale doesn't need to render anything that is still valid
+ */
+typedef struct
+{
+  cairo_surface_t *surface;
+  cairo_region_t  *valid;
+  gdouble          scale_x;
+  gdouble          scale_y;
+  gint             offset_x;
+  gint             offset_y;
+} RenderLevel;
+
+
+/*  local function prototypes  */
+
+static void   render_level_free (RenderLevel *level);
+
+
+/*  public functions  */
 
 
 void
@@ -68,6 +94,124 @@ gimp_display_shell_render_invalidate_full (GimpDisplayShell *shell)
   g_return_if_fail (GIMP_IS_DISPLAY_SHELL (shell));
 
   g_clear_pointer (&shell->render_cache_valid, cairo_region_destroy);
+
+  gimp_display_shell_render_clear_levels (shell);
+}
+
+/*  like gimp_display_shell_render_invalidate_full(), for when only the
+ *  shell's scale changed.  the current cache is kept as one of the recent
+ *  levels, and the level of the new scale, if any, becomes the cache.
+ */
+void
+gimp_display_shell_render_invalidate_scale (GimpDisplayShell *shell)
+{
+  RenderLevel *level = NULL;
+  gint         width;
+  gint         height;
+  GList       *list;
+
+  g_return_if_fail (GIMP_IS_DISPLAY_SHELL (shell));
+
+  /*  the cache is moved by screen offsets only, which is fine when
+   *  scrolling, but we don't track a rotated view across scales
+   */
+  if (shell->rotate_transform ||
+      (shell->render_cache_valid                    &&
+       shell->render_cache_scale_x == shell->scale_x &&
+       shell->render_cache_scale_y == shell->scale_y))
+    {
+      gimp_display_shell_render_invalidate_full (shell);
+
+      return;
+    }
+
+  width  = shell->disp_width  * shell->render_scale;
+  height = shell->disp_height * shell->render_scale;
+
+  for (list = shell->render_cache_levels; list; list = g_list_next (list))
+    {
+      RenderLevel *l = list->data;
+
+      if (l->scale_x == shell->scale_x                        &&
+          l->scale_y == shell->scale_y                        &&
+          cairo_image_surface_get_width  (l->surface) == width &&
+          cairo_image_surface_get_height (l->surface) == height)
+        {
+          level = l;
+
+          shell->render_cache_levels =
+            g_list_delete_link (shell->render_cache_levels, list);
+
+          break;
+        }
+    }
+
+  if (shell->render_cache && shell->render_cache_valid &&
+      ! cairo_region_is_empty (shell->render_cache_valid))
+    {
+      RenderLevel *current = g_slice_new (RenderLevel);
+
+      current->surface  = shell->render_cache;
+      current->valid    = shell->render_cache_valid;
+      current->scale_x  = shell->render_cache_scale_x;
+      current->scale_y  = shell->render_cache_scale_y;
+      current->offset_x = shell->render_cache_offset_x;
+      current->offset_y = shell->render_cache_offset_y;
+
+      shell->render_cache       = NULL;
+      shell->render_cache_valid = NULL;
+
+      shell->render_cache_levels = g_list_prepend (shell->render_cache_levels,
+                                                   current);
+
+      while (g_list_length (shell->render_cache_levels) >
+             GIMP_DISPLAY_RENDER_MAX_LEVELS)
+        {
+          GList *last = g_list_last (shell->render_cache_levels);
+
+          render_level_free (last->data);
+
+          shell->render_cache_levels =
+            g_list_delete_link (shell->render_cache_levels, last);
+        }
+    }
+  else
+    {
+      g_clear_pointer (&shell->render_cache_valid, cairo_region_destroy);
+    }
+
+  if (level)
+    {
+      g_clear_pointer (&shell->render_cache, cairo_surface_destroy);
+
+      shell->render_cache          = level->surface;
+      shell->render_cache_valid    = level->valid;
+      shell->render_cache_scale_x  = level->scale_x;
+      shell->render_cache_scale_y  = level->scale_y;
+      shell->render_cache_offset_x = level->offset_x;
+      shell->render_cache_offset_y = level->offset_y;
+
+      g_slice_free (RenderLevel, level);
+
+      /*  the view may have been scrolled since  */
+      gimp_display_shell_render_scroll (
+        shell,
+        shell->offset_x - shell->render_cache_offset_x,
+        shell->offset_y - shell->render_cache_offset_y);
+    }
+}
+
+/*  drops the caches of recent scales, which are only kept to make zooming
+ *  back faster.
+ */
+void
+gimp_display_shell_render_clear_levels (GimpDisplayShell *shell)
+{
+  g_return_if_fail (GIMP_IS_DISPLAY_SHELL (shell));
+
+  g_list_free_full (shell->render_cache_levels,
+                    (GDestroyNotify) render_level_free);
+  shell->render_cache_levels = NULL;
 }
 
 void
@@ -90,6 +234,9 @@ gimp_display_shell_render_invalidate_area (GimpDisplayShell *shell,
 
       cairo_region_subtract_rectangle (shell->render_cache_valid, &rect);
     }
+
+  /*  we don't know where the area is at other scales  */
+  gimp_display_shell_render_clear_levels (shell);
 }
 
 void
@@ -114,6 +261,76 @@ gimp_display_shell_render_validate_area (GimpDisplayShell *shell,
     }
 }
 
+/*  moves the render cache's pixels by (-x_offset, -y_offset), along with
+ *  its valid area, after the shell scrolled by (x_offset, y_offset).  the
+ *  pixels are moved within the cache surface, so that the still-visible
+ *  part is copied only once, and no temporary surface is needed.
+ */
+void
+gimp_display_shell_render_scroll (GimpDisplayShell *shell,
+                                  gint              x_offset,
+                                  gint              y_offset)
+{
+  cairo_rectangle_int_t rect;
+
+  g_return_if_fail (GIMP_IS_DISPLAY_SHELL (shell));
+
+  if (! shell->render_cache_valid)
+    return;
+
+  shell->render_cache_offset_x += x_offset;
+  shell->render_cache_offset_y += y_offset;
+
+  cairo_region_translate (shell->render_cache_valid, -x_offset, -y_offset);
+
+  rect.x      = 0;
+  rect.y      = 0;
+  rect.width  = shell->disp_width;
+  rect.height = shell->disp_height;
+
+  cairo_region_intersect_rectangle (shell->render_cache_valid, &rect);
+
+  if (shell->render_cache &&
+      ! cairo_region_is_empty (shell->render_cache_valid))
+    {
+      guchar *data;
+      gint    stride;
+      gint    width;
+      gint    height;
+      gint    dx;
+      gint    dy;
+      gint    y;
+
+      cairo_surface_flush (shell->render_cache);
+
+      data   = cairo_image_surface_get_data   (shell->render_cache);
+      stride = cairo_image_surface_get_stride (shell->render_cache);
+      width  = cairo_image_surface_get_width  (shell->render_cache);
+      height = cairo_image_surface_get_height (shell->render_cache);
+
+      dx = -x_offset * shell->render_scale;
+      dy = -y_offset * shell->render_scale;
+
+      width  -= abs (dx);
+      height -= abs (dy);
+
+      /*  when moving down, start from the bottom row, so that rows are
+       *  moved before they are overwritten
+       */
+      for (y = 0; y < height; y++)
+        {
+          gint dest_y = dy > 0 ? height - 1 - y + dy : y;
+          gint src_y  = dest_y - dy;
+
+          memmove (data + dest_y * stride + MAX (dx, 0) * 4,
+                   data + src_y  * stride + MAX (-dx, 0) * 4,
+                   width * 4);
+        }
+
+      cairo_surface_mark_dirty (shell->render_cache);
+    }
+}
+
 gboolean
 gimp_display_shell_render_is_valid (GimpDisplayShell *shell,
                                     gint              x,
@@ -236,6 +453,11 @@ gimp_display_shell_render (GimpDisplayShell *shell,
   if (! shell->render_cache_valid)
     {
       shell->render_cache_valid = cairo_region_create ();
+
+      shell->render_cache_scale_x  = shell->scale_x;
+      shell->render_cache_scale_y  = shell->scale_y;
+      shell->render_cache_offset_x = shell->offset_x;
+      shell->render_cache_offset_y = shell->offset_y;
     }
 
   my_cr = cairo_create (shell->render_cache);
@@ -377,26 +599,26 @@ gimp_display_shell_render (GimpDisplayShell *shell,
               /*  if we have filters, convert the pixels in the filter_buffer
                *  in-place
                */
-              gimp_color_transform_process_buffer (shell->profile_transform,
-                                                   shell->filter_buffer,
-                                                   GEGL_RECTANGLE (0, 0,
-                                                                   width, height),
-                                                   shell->filter_buffer,
-                                                   GEGL_RECTANGLE (0, 0,
-                                                                   width, height));
+              gimp_display_shell_profile_convert_buffer (shell,
+                                                         shell->filter_buffer,
+                                                         GEGL_RECTANGLE (0, 0,
+                                                                         width, height),
+                                                         shell->filter_buffer,
+                                                         GEGL_RECTANGLE (0, 0,
+                                                                         width, height));
             }
           else if (! can_convert_to_u8)
             {
               /*  otherwise, if we can't convert to u8 directly, convert
                *  the pixels from the profile_buffer to the filter_buffer
                */
-              gimp_color_transform_process_buffer (shell->profile_transform,
-                                                   shell->profile_buffer,
-                                                   GEGL_RECTANGLE (0, 0,
-                                                                   width, height),
-                                                   shell->filter_buffer,
-                                                   GEGL_RECTANGLE (0, 0,
-                                                                   width, height));
+              gimp_display_shell_profile_convert_buffer (shell,
+                                                         shell->profile_buffer,
+                                                         GEGL_RECTANGLE (0, 0,
+                                                                         width, height),
+                                                         shell->filter_buffer,
+                                                         GEGL_RECTANGLE (0, 0,
+                                                                         width, height));
             }
           else
             {
@@ -520,3 +742,15 @@ gimp_display_shell_render (GimpDisplayShell *shell,
 
   cairo_destroy (my_cr);
 }
+
+
+/*  private functions  */
+
+static void
+render_level_free (RenderLevel *level)
+{
+  cairo_surface_destroy (level->surface);
+  cairo_region_destroy (level->valid);
+
+  g_slice_free (RenderLevel, level);
+}
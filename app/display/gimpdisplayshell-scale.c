@@ -890,7 +890,7 @@ gimp_display_shell_scale_resize (GimpDisplayShell *shell,
   gimp_display_shell_scaled (shell);
 
   gimp_display_shell_expose_full (shell);
-  gimp_display_shell_render_invalidate_full (shell);
+  gimp_display_shell_render_invalidate_scale (shell);
 
   /* re-enable the active tool */
   gimp_display_shell_resume (shell);
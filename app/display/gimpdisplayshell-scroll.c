@@ -47,6 +47,9 @@
 
 #define OVERPAN_FACTOR 0.5
 
+/*  scrolls further apart than this don't belong to the same motion  */
+#define VELOCITY_TIMEOUT 0.1 /* seconds */
+
 
 /**
  * gimp_display_shell_scroll:
@@ -90,59 +93,77 @@ gimp_display_shell_scroll (GimpDisplayShell *shell,
 
   if (x_offset || y_offset)
     {
-      gimp_display_shell_scrolled (shell);
-
-      gimp_overlay_box_scroll (GIMP_OVERLAY_BOX (shell->canvas),
-                               -x_offset, -y_offset);
+      gint64  time = g_get_monotonic_time ();
+      gdouble dt   = (time - shell->scroll_time) / (gdouble) G_TIME_SPAN_SECOND;
 
-      if (shell->render_cache)
+      /*  smooth the velocity over the last few scrolls  */
+      if (dt > 0.0 && dt < VELOCITY_TIMEOUT)
         {
-          cairo_surface_t       *surface;
-          cairo_t               *cr;
-
-          surface = cairo_surface_create_similar_image (
-            shell->render_cache,
-            CAIRO_FORMAT_ARGB32,
-            shell->disp_width  * shell->render_scale,
-            shell->disp_height * shell->render_scale);
-
-          cr = cairo_create (surface);
-          cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
-          cairo_set_source_surface (cr, shell->render_cache, 0, 0);
-          cairo_paint (cr);
-          cairo_destroy (cr);
-
-          cr = cairo_create (shell->render_cache);
-          cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
-          cairo_set_source_surface (cr, surface,
-                                    -x_offset * shell->render_scale,
-                                    -y_offset * shell->render_scale);
-          cairo_paint (cr);
-          cairo_destroy (cr);
-
-          cairo_surface_destroy (surface);
+          shell->scroll_velocity_x = (shell->scroll_velocity_x +
+                                      x_offset / dt) / 2.0;
+          shell->scroll_velocity_y = (shell->scroll_velocity_y +
+                                      y_offset / dt) / 2.0;
         }
-
-      if (shell->render_cache_valid)
+      else
         {
-          cairo_rectangle_int_t rect;
+          shell->scroll_velocity_x = 0.0;
+          shell->scroll_velocity_y = 0.0;
+        }
 
-          cairo_region_translate (shell->render_cache_valid,
-                                  -x_offset, -y_offset);
+      shell->scroll_time = time;
 
-          rect.x      = 0;
-          rect.y      = 0;
-          rect.width  = shell->disp_width;
-          rect.height = shell->disp_height;
+      gimp_display_shell_scrolled (shell);
 
-          cairo_region_intersect_rectangle (shell->render_cache_valid, &rect);
-        }
+      gimp_overlay_box_scroll (GIMP_OVERLAY_BOX (shell->canvas),
+                               -x_offset, -y_offset);
+
+      gimp_display_shell_render_scroll (shell, x_offset, y_offset);
     }
 
   /* re-enable the active tool */
   gimp_display_shell_resume (shell);
 }
 
+/**
+ * gimp_display_shell_scroll_get_velocity:
+ * @shell:
+ * @velocity_x: return location for the horizontal velocity
+ * @velocity_y: return location for the vertical velocity
+ *
+ * Returns the velocity of the ongoing incremental panning, in screen
+ * pixels per second.
+ *
+ * Returns: %FALSE if there is no ongoing panning.
+ **/
+gboolean
+gimp_display_shell_scroll_get_velocity (GimpDisplayShell *shell,
+                                        gdouble          *velocity_x,
+                                        gdouble          *velocity_y)
+{
+  gdouble dt;
+
+  g_return_val_if_fail (GIMP_IS_DISPLAY_SHELL (shell), FALSE);
+  g_return_val_if_fail (velocity_x != NULL, FALSE);
+  g_return_val_if_fail (velocity_y != NULL, FALSE);
+
+  dt = (g_get_monotonic_time () - shell->scroll_time) /
+       (gdouble) G_TIME_SPAN_SECOND;
+
+  if (dt >= VELOCITY_TIMEOUT ||
+      (shell->scroll_velocity_x == 0.0 && shell->scroll_velocity_y == 0.0))
+    {
+      *velocity_x = 0.0;
+      *velocity_y = 0.0;
+
+      return FALSE;
+    }
+
+  *velocity_x = shell->scroll_velocity_x;
+  *velocity_y = shell->scroll_velocity_y;
+
+  return TRUE;
+}
+
 /**
  * gimp_display_shell_scroll_set_offsets:
  * @shell:
@@ -39,6 +39,18 @@
 #include "gimpdisplayshell-transform.h"
 
 
+/*  the number of zoom octaves below 100% which get their own outline  */
+#define N_LEVELS 8
+
+
+typedef struct
+{
+  const GimpBoundSeg *src_segs;       /*  level 0 this level was made from  */
+  gint                n_src_segs;
+  GimpBoundSeg       *segs;           /*  outline snapped to the level      */
+  gint                n_segs;
+} SelectionLevel;
+
 struct _Selection
 {
   GimpDisplayShell *shell;            /*  shell that owns the selection     */
@@ -55,6 +67,9 @@ struct _Selection
   gboolean          show_selection;   /*  is the selection visible?         */
   guint             timeout;          /*  timer for successive draws        */
   cairo_pattern_t  *segs_in_mask;     /*  cache for rendered segments       */
+
+  SelectionLevel    levels_in[N_LEVELS];  /*  segs_in per zoom octave     */
+  SelectionLevel    levels_out[N_LEVELS]; /*  segs_out per zoom octave    */
 };
 
 
@@ -73,8 +88,15 @@ static void      selection_zoom_segs      (Selection          *selection,
                                            gint                n_segs,
                                            gint                canvas_offset_x,
                                            gint                canvas_offset_y);
+static const GimpBoundSeg *
+                 selection_get_level      (SelectionLevel     *levels,
+                                           const GimpBoundSeg *segs,
+                                           gint                n_segs,
+                                           gint                level,
+                                           gint               *n_level_segs);
 static void      selection_generate_segs  (Selection          *selection);
 static void      selection_free_segs      (Selection          *selection);
+static void      selection_free_levels    (Selection          *selection);
 
 static gboolean  selection_timeout        (Selection          *selection);
 
@@ -133,6 +155,7 @@ gimp_display_shell_selection_free (GimpDisplayShell *shell)
                                         selection);
 
   selection_free_segs (selection);
+  selection_free_levels (selection);
 
   g_slice_free (Selection, selection);
 
@@ -145,6 +168,9 @@ gimp_display_shell_selection_undraw (GimpDisplayShell *shell)
   g_return_if_fail (GIMP_IS_DISPLAY_SHELL (shell));
   g_return_if_fail (shell->selection != NULL);
 
+  /*  the boundary is about to change  */
+  selection_free_levels (shell->selection);
+
   if (gimp_display_get_image (shell->display))
     {
       selection_undraw (shell->selection);
@@ -393,12 +419,55 @@ selection_zoom_segs (Selection          *selection,
     }
 }
 
+/*  returns the boundary snapped to a grid of 2^level pixels, which is
+ *  made from the next finer level the first time it is asked for
+ */
+static const GimpBoundSeg *
+selection_get_level (SelectionLevel     *levels,
+                     const GimpBoundSeg *segs,
+                     gint                n_segs,
+                     gint                level,
+                     gint               *n_level_segs)
+{
+  SelectionLevel     *l = &levels[level];
+  const GimpBoundSeg *src_segs;
+  gint                n_src_segs;
+
+  if (level == 0 || n_segs == 0)
+    {
+      *n_level_segs = n_segs;
+
+      return segs;
+    }
+
+  if (l->src_segs != segs || l->n_src_segs != n_segs)
+    {
+      g_clear_pointer (&l->segs, g_free);
+
+      src_segs = selection_get_level (levels, segs, n_segs, level - 1,
+                                      &n_src_segs);
+
+      l->segs       = gimp_boundary_downscale (src_segs, n_src_segs,
+                                               1 << level, &l->n_segs);
+      l->src_segs   = segs;
+      l->n_src_segs = n_segs;
+    }
+
+  *n_level_segs = l->n_segs;
+
+  return l->segs;
+}
+
 static void
 selection_generate_segs (Selection *selection)
 {
   GimpImage          *image = gimp_display_get_image (selection->shell->display);
   const GimpBoundSeg *segs_in;
   const GimpBoundSeg *segs_out;
+  gint                n_segs_in;
+  gint                n_segs_out;
+  gdouble             scale;
+  gint                level           = 0;
   gint                canvas_offset_x = 0;
   gint                canvas_offset_y = 0;
 
@@ -409,9 +478,25 @@ selection_generate_segs (Selection *selection)
    */
   gimp_channel_boundary (gimp_image_get_mask (image),
                          &segs_in, &segs_out,
-                         &selection->n_segs_in, &selection->n_segs_out,
+                         &n_segs_in, &n_segs_out,
                          0, 0, 0, 0);
 
+  /*  when zoomed out, a lot of segments land on the same display
+   *  pixels, so use the coarsest outline whose grid still fits
+   *  into a display pixel
+   */
+  scale = MAX (selection->shell->scale_x, selection->shell->scale_y);
+
+  while (level + 1 < N_LEVELS && scale * (1 << (level + 1)) <= 1.0)
+    level++;
+
+  segs_in  = selection_get_level (selection->levels_in,
+                                  segs_in, n_segs_in, level,
+                                  &selection->n_segs_in);
+  segs_out = selection_get_level (selection->levels_out,
+                                  segs_out, n_segs_out, level,
+                                  &selection->n_segs_out);
+
   if (selection->n_segs_in || selection->n_segs_out)
     gtk_widget_translate_coordinates (GTK_WIDGET (selection->shell->canvas),
                                       GTK_WIDGET (selection->shell),
@@ -450,6 +535,21 @@ selection_free_segs (Selection *selection)
   g_clear_pointer (&selection->segs_in_mask, cairo_pattern_destroy);
 }
 
+static void
+selection_free_levels (Selection *selection)
+{
+  gint i;
+
+  for (i = 0; i < N_LEVELS; i++)
+    {
+      g_clear_pointer (&selection->levels_in[i].segs,  g_free);
+      g_clear_pointer (&selection->levels_out[i].segs, g_free);
+
+      selection->levels_in[i]  = (SelectionLevel) {};
+      selection->levels_out[i] = (SelectionLevel) {};
+    }
+}
+
 static gboolean
 selection_timeout (Selection *selection)
 {
@@ -39,6 +39,7 @@
 #include "gegl/gimp-babl.h"
 
 #include "core/gimp.h"
+#include "core/gimp-memory-pressure.h"
 #include "core/gimp-utils.h"
 #include "core/gimpchannel.h"
 #include "core/gimpcontext.h"
@@ -94,6 +95,10 @@
 #include "gimp-intl.h"
 
 
+/*  how far ahead of the panning viewport to prefetch  */
+#define PREFETCH_TIME 0.25 /* seconds */
+
+
 enum
 {
   PROP_0,
@@ -182,6 +187,9 @@ static void   gimp_display_shell_transform_overlay (GimpDisplayShell *shell,
                                                     gdouble          *x,
                                                     gdouble          *y);
 
+static void      gimp_display_shell_reclaim        (Gimp             *gimp,
+                                                    GimpDisplayShell *shell);
+
 
 G_DEFINE_TYPE_WITH_CODE (GimpDisplayShell, gimp_display_shell,
                          GTK_TYPE_EVENT_BOX,
@@ -429,6 +437,13 @@ gimp_display_shell_constructed (GObject *object)
 
   gimp_display_shell_profile_init (shell);
 
+  shell->reclaim_id =
+    gimp_memory_pressure_add_reclaimer (shell->display->gimp,
+                                        GIMP_RECLAIM_PRIORITY_CHEAP,
+                                        (GimpReclaimFunc)
+                                        gimp_display_shell_reclaim,
+                                        shell);
+
   if (image)
     {
       image_width  = gimp_image_get_width  (image);
@@ -763,8 +778,24 @@ gimp_display_shell_dispose (GObject *object)
 
   g_clear_object (&shell->zoom_gesture);
 
-  g_clear_pointer (&shell->render_cache,       cairo_surface_destroy);
-  g_clear_pointer (&shell->render_cache_valid, cairo_region_destroy);
+  if (shell->reclaim_id)
+    {
+      gimp_memory_pressure_remove_reclaimer (shell->display->gimp,
+                                             shell->reclaim_id);
+      shell->reclaim_id = 0;
+    }
+
+  if (shell->frame_clock)
+    {
+      g_signal_handler_disconnect (shell->frame_clock, shell->frame_handler);
+      g_object_remove_weak_pointer (G_OBJECT (shell->frame_clock),
+                                    (gpointer) &shell->frame_clock);
+      shell->frame_clock = NULL;
+    }
+
+  gimp_display_shell_render_invalidate_full (shell);
+
+  g_clear_pointer (&shell->render_cache, cairo_surface_destroy);
 
   g_clear_pointer (&shell->render_surface, cairo_surface_destroy);
   g_clear_pointer (&shell->mask_surface,   cairo_surface_destroy);
@@ -1136,6 +1167,13 @@ gimp_display_shell_remove_overlay (GtkWidget        *canvas,
   shell->children = g_list_remove (shell->children, child);
 }
 
+static void
+gimp_display_shell_reclaim (Gimp             *gimp,
+                            GimpDisplayShell *shell)
+{
+  gimp_display_shell_render_clear_levels (shell);
+}
+
 static void
 gimp_display_shell_transform_overlay (GimpDisplayShell *shell,
                                       GtkWidget        *child,
@@ -1914,9 +1952,46 @@ gimp_display_shell_update_priority_rect (GimpDisplayShell *shell)
       gint            x, y;
       gint            width, height;
 
+      gdouble         velocity_x;
+      gdouble         velocity_y;
+
       gimp_display_shell_untransform_viewport (shell, ! shell->show_all,
                                                &x, &y, &width, &height);
       gimp_projection_set_priority_rect (projection, x, y, width, height);
+
+      /*  while panning, render the area the viewport is heading to next,
+       *  right after the visible area
+       */
+      if (gimp_display_shell_scroll_get_velocity (shell,
+                                                  &velocity_x, &velocity_y))
+        {
+          gdouble dx = CLAMP (velocity_x * PREFETCH_TIME,
+                              -shell->disp_width,  shell->disp_width);
+          gdouble dy = CLAMP (velocity_y * PREFETCH_TIME,
+                              -shell->disp_height, shell->disp_height);
+          gdouble x1, y1;
+          gdouble x2, y2;
+
+          gimp_display_shell_untransform_bounds (shell,
+                                                 MIN (dx, 0.0),
+                                                 MIN (dy, 0.0),
+                                                 shell->disp_width  + MAX (dx, 0.0),
+                                                 shell->disp_height + MAX (dy, 0.0),
+                                                 &x1, &y1,
+                                                 &x2, &y2);
+
+          x      = floor (x1);
+          y      = floor (y1);
+          width  = ceil (x2) - x;
+          height = ceil (y2) - y;
+        }
+      else
+        {
+          width  = 0;
+          height = 0;
+        }
+
+      gimp_projection_set_prefetch_rect (projection, x, y, width, height);
     }
 }
 
@@ -157,6 +157,7 @@ struct _GimpDisplayShell
   GeglBuffer         *profile_buffer;  /*  buffer for profile transform       */
   guchar             *profile_data;    /*  profile_buffer's pixels            */
   gint                profile_stride;  /*  profile_buffer's stride            */
+  GimpDisplayLut     *profile_lut;     /*  profile_transform, baked           */
 
   GimpColorDisplayStack *filter_stack; /*  color display conversion stuff     */
   guint                  filter_idle_id;
@@ -172,6 +173,11 @@ struct _GimpDisplayShell
 
   cairo_surface_t   *render_cache;
   cairo_region_t    *render_cache_valid;
+  gdouble            render_cache_scale_x;  /*  scale the cache was rendered at */
+  gdouble            render_cache_scale_y;
+  gint               render_cache_offset_x; /*  offset of the cache's origin    */
+  gint               render_cache_offset_y;
+  GList             *render_cache_levels;   /*  caches of recent scales         */
 
   gint               render_buf_width;
   gint               render_buf_height;
@@ -180,6 +186,13 @@ struct _GimpDisplayShell
   cairo_surface_t   *mask_surface;     /*  buffer for rendering the mask      */
   cairo_pattern_t   *checkerboard;     /*  checkerboard pattern               */
 
+  GdkFrameClock     *frame_clock;      /*  the canvas' frame clock            */
+  gulong             frame_handler;
+  gint64             frame_draw_time;  /*  time it took to draw the canvas    */
+  gint64             frame_time;       /*  last frame painted while rendering */
+
+  guint              reclaim_id;       /*  memory pressure reclaimer          */
+
   gint               paused_count;
 
   GimpTreeHandler   *vectors_freeze_handler;
@@ -217,6 +230,9 @@ struct _GimpDisplayShell
   gint               scroll_start_y;
   gint               scroll_last_x;
   gint               scroll_last_y;
+  gint64             scroll_time;      /*  time of the last incremental scroll */
+  gdouble            scroll_velocity_x;/*  in screen pixels per second         */
+  gdouble            scroll_velocity_y;
   gboolean           rotating;
   gdouble            rotate_drag_angle;
   gboolean           scaling;
@@ -392,6 +392,9 @@ gimp_tool_path_changed (GimpToolWidget *widget)
   GimpToolPathPrivate *private = path->private;
   GimpVectors         *vectors = private->vectors;
 
+  /*  rebuilding the handles shouldn't emit an update for each of them  */
+  gimp_canvas_item_begin_change (gimp_tool_widget_get_item (widget));
+
   if (private->items)
     {
       g_list_foreach (private->items, (GFunc) item_remove_func, widget);
@@ -533,6 +536,8 @@ gimp_tool_path_changed (GimpToolWidget *widget)
     {
       gimp_canvas_path_set (private->path, NULL);
     }
+
+  gimp_canvas_item_end_change (gimp_tool_widget_get_item (widget));
 }
 
 static gboolean
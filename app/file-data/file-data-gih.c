@@ -198,7 +198,7 @@ file_gih_pipe_to_image (Gimp          *gimp,
     {
       GimpLayer *layer;
 
-      layer = file_gbr_brush_to_layer (image, pipe->brushes[i]);
+      layer = file_gbr_brush_to_layer (image, gimp_brush_pipe_get_brush (pipe, i));
       gimp_image_add_layer (image, layer, NULL, i, FALSE);
     }
 
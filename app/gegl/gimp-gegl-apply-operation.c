@@ -49,6 +49,11 @@
  */
 #define APPLY_OPERATION_NON_INTERACTIVE_INTERVAL 1.0 /* seconds */
 
+/* the smallest feather standard deviation, for which the box-cascade
+ * approximation is used
+ */
+#define FEATHER_MIN_STD_DEV 2.0
+
 
 void
 gimp_gegl_apply_operation (GeglBuffer          *src_buffer,
@@ -438,25 +443,50 @@ gimp_gegl_apply_feather (GeglBuffer          *src_buffer,
                          gdouble              radius_y,
                          gboolean             edge_lock)
 {
-  GaussianBlurAbyssPolicy abyss_policy;
+  GaussianBlurAbyssPolicy  abyss_policy;
+  const Babl              *src_format;
+  const Babl              *dest_format;
+  gdouble                  std_dev_x;
+  gdouble                  std_dev_y;
 
   g_return_if_fail (GEGL_IS_BUFFER (src_buffer));
   g_return_if_fail (progress == NULL || GIMP_IS_PROGRESS (progress));
   g_return_if_fail (GEGL_IS_BUFFER (dest_buffer));
 
+  /* 3.5 is completely magic and picked to visually match the old
+   * gaussian_blur_region() on a crappy laptop display
+   */
+  std_dev_x = radius_x / 3.5;
+  std_dev_y = radius_y / 3.5;
+
+  src_format  = gegl_buffer_get_format (src_buffer);
+  dest_format = gegl_buffer_get_format (dest_buffer);
+
+  /* big feathers of masks use a box-cascade approximation, which only
+   * blurs the parts of the mask where the result isn't uniform
+   */
+  if (! progress                                         &&
+      MAX (std_dev_x, std_dev_y) >= FEATHER_MIN_STD_DEV  &&
+      babl_format_get_n_components (src_format)  == 1    &&
+      babl_format_get_n_components (dest_format) == 1)
+    {
+      gimp_gegl_feather (src_buffer, dest_buffer, dest_rect,
+                         std_dev_x, std_dev_y,
+                         edge_lock ? GEGL_ABYSS_CLAMP : GEGL_ABYSS_NONE);
+
+      return;
+    }
+
   if (edge_lock)
     abyss_policy = GAUSSIAN_BLUR_ABYSS_CLAMP;
   else
     abyss_policy = GAUSSIAN_BLUR_ABYSS_NONE;
 
-  /* 3.5 is completely magic and picked to visually match the old
-   * gaussian_blur_region() on a crappy laptop display
-   */
   gimp_gegl_apply_gaussian_blur (src_buffer,
                                  progress, undo_desc,
                                  dest_buffer, dest_rect,
-                                 radius_x / 3.5,
-                                 radius_y / 3.5,
+                                 std_dev_x,
+                                 std_dev_y,
                                  abyss_policy);
 }
 
@@ -0,0 +1,172 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimp-gegl-color-transform.c
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <cairo.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <gegl.h>
+
+#include "libgimpcolor/gimpcolor.h"
+
+#include "gimp-gegl-types.h"
+
+#include "gimp-gegl-color-transform.h"
+
+
+/*  creating a color transform means building, and possibly optimizing,
+ *  an lcms pipeline, which can take longer than converting a small buffer
+ *  with it.  converting all the layers of an image, or the same image
+ *  over and over, asks for the same transform each time, so we keep the
+ *  most recently used ones around.
+ *
+ *  transforms don't keep any state between process calls, so a cached
+ *  transform can be used by several callers, and threads, at once.
+ */
+
+
+#define MAX_CACHED_TRANSFORMS 16
+
+
+typedef struct
+{
+  GimpColorProfile         *src_profile;
+  const Babl               *src_format;
+  GimpColorProfile         *dest_profile;
+  const Babl               *dest_format;
+  GimpColorRenderingIntent  rendering_intent;
+  GimpColorTransformFlags   flags;
+
+  GimpColorTransform       *transform;
+} CachedTransform;
+
+
+/*  local function prototypes  */
+
+static void   cached_transform_free (CachedTransform *cached);
+
+
+/*  local variables  */
+
+static GMutex  transform_mutex;
+static GQueue  transforms = G_QUEUE_INIT;
+
+
+/*  public functions  */
+
+void
+gimp_gegl_color_transform_exit (void)
+{
+  g_mutex_lock (&transform_mutex);
+
+  g_queue_clear_full (&transforms, (GDestroyNotify) cached_transform_free);
+
+  g_mutex_unlock (&transform_mutex);
+}
+
+/*  like gimp_color_transform_new(), but returns a new reference to a
+ *  shared transform, created on the first request.  callers must not
+ *  connect to the transform's signals.
+ */
+GimpColorTransform *
+gimp_gegl_color_transform_get (GimpColorProfile         *src_profile,
+                               const Babl               *src_format,
+                               GimpColorProfile         *dest_profile,
+                               const Babl               *dest_format,
+                               GimpColorRenderingIntent  rendering_intent,
+                               GimpColorTransformFlags   flags)
+{
+  CachedTransform    *cached = NULL;
+  GimpColorTransform *transform;
+  GList              *list;
+
+  g_return_val_if_fail (GIMP_IS_COLOR_PROFILE (src_profile), NULL);
+  g_return_val_if_fail (src_format != NULL, NULL);
+  g_return_val_if_fail (GIMP_IS_COLOR_PROFILE (dest_profile), NULL);
+  g_return_val_if_fail (dest_format != NULL, NULL);
+
+  g_mutex_lock (&transform_mutex);
+
+  for (list = transforms.head; list; list = g_list_next (list))
+    {
+      CachedTransform *c = list->data;
+
+      if (c->src_format       == src_format       &&
+          c->dest_format      == dest_format      &&
+          c->rendering_intent == rendering_intent &&
+          c->flags            == flags            &&
+          gimp_color_profile_is_equal (c->src_profile,  src_profile) &&
+          gimp_color_profile_is_equal (c->dest_profile, dest_profile))
+        {
+          cached = c;
+
+          g_queue_unlink (&transforms, list);
+          g_queue_push_head_link (&transforms, list);
+
+          break;
+        }
+    }
+
+  if (! cached)
+    {
+      transform = gimp_color_transform_new (src_profile,  src_format,
+                                            dest_profile, dest_format,
+                                            rendering_intent, flags);
+
+      /*  a NULL transform means there is nothing to do, which is just as
+       *  well worth remembering
+       */
+      cached = g_slice_new (CachedTransform);
+
+      cached->src_profile      = g_object_ref (src_profile);
+      cached->src_format       = src_format;
+      cached->dest_profile     = g_object_ref (dest_profile);
+      cached->dest_format      = dest_format;
+      cached->rendering_intent = rendering_intent;
+      cached->flags            = flags;
+      cached->transform        = transform;
+
+      g_queue_push_head (&transforms, cached);
+
+      if (g_queue_get_length (&transforms) > MAX_CACHED_TRANSFORMS)
+        cached_transform_free (g_queue_pop_tail (&transforms));
+    }
+
+  transform = cached->transform;
+
+  if (transform)
+    g_object_ref (transform);
+
+  g_mutex_unlock (&transform_mutex);
+
+  return transform;
+}
+
+
+/*  private functions  */
+
+static void
+cached_transform_free (CachedTransform *cached)
+{
+  g_object_unref (cached->src_profile);
+  g_object_unref (cached->dest_profile);
+  g_clear_object (&cached->transform);
+
+  g_slice_free (CachedTransform, cached);
+}
@@ -37,10 +37,12 @@ extern "C"
 #include "gimp-gegl-types.h"
 
 #include "gimp-babl.h"
+#include "gimp-gegl-color-transform.h"
 #include "gimp-gegl-loops.h"
 #include "gimp-gegl-loops-sse2.h"
 
 #include "core/gimp-atomic.h"
+#include "core/gimp-parallel.h"
 #include "core/gimp-utils.h"
 #include "core/gimpprogress.h"
 
@@ -48,6 +50,14 @@ extern "C"
 #define PIXELS_PER_THREAD \
   (/* each thread costs as much as */ 64.0 * 64.0 /* pixels */)
 
+#define FEATHER_N_BOXES        3
+#define FEATHER_MIN_BLOCK_SIZE 256
+#define FEATHER_MAX_BLOCK_SIZE 2048
+
+#define CONVERT_PROGRESS_ROWS  64
+
+#define CONVERT_BLOCK_SIZE     256
+
 #define SHIFTED_AREA(dest, src)                                                \
   const GeglRectangle dest##_area_ = {                                         \
     src##_area->x + (dest##_rect->x - src##_rect->x),                          \
@@ -126,16 +136,71 @@ gimp_gegl_buffer_copy (GeglBuffer          *src_buffer,
           gegl_tile_handler_unlock (GEGL_TILE_HANDLER (dest_buffer));
         }
     }
+  else if ((gdouble) dest_rect->width * dest_rect->height <=
+           2.0 * PIXELS_PER_THREAD)
+    {
+      gegl_buffer_copy (src_buffer, src_rect, abyss_policy,
+                        dest_buffer, dest_rect);
+    }
   else
     {
-      gegl_parallel_distribute_area (
-        src_rect, PIXELS_PER_THREAD,
-        [=] (const GeglRectangle *src_area)
+      GeglRectangle tiles;
+      gint          tile_width;
+      gint          tile_height;
+      gint          block_width;
+      gint          block_height;
+      gint          n_blocks_x;
+      gint          n_blocks;
+      gint          next_block = 0;
+
+      /*  convert whole blocks of destination tiles in each thread, so that
+       *  no tile is written, and converted into, by more than one thread.
+       *  the blocks are claimed dynamically, to balance the threads.
+       */
+      g_object_get (dest_buffer,
+                    "tile-width",  &tile_width,
+                    "tile-height", &tile_height,
+                    NULL);
+
+      gegl_rectangle_align_to_buffer (&tiles, dest_rect, dest_buffer,
+                                      GEGL_RECTANGLE_ALIGNMENT_SUPERSET);
+
+      block_width  = tile_width  * MAX (1, CONVERT_BLOCK_SIZE / tile_width);
+      block_height = tile_height * MAX (1, CONVERT_BLOCK_SIZE / tile_height);
+
+      n_blocks_x = (tiles.width  + block_width  - 1) / block_width;
+      n_blocks   = (tiles.height + block_height - 1) / block_height *
+                   n_blocks_x;
+
+      gimp_parallel_distribute (
+        n_blocks,
+        [&] (gint i,
+             gint n)
         {
-          SHIFTED_AREA (dest, src);
+          gint block;
+
+          while ((block = g_atomic_int_add (&next_block, 1)) < n_blocks)
+            {
+              GeglRectangle dest_area;
+              GeglRectangle src_area;
+
+              dest_area.x      = tiles.x + block % n_blocks_x * block_width;
+              dest_area.y      = tiles.y + block / n_blocks_x * block_height;
+              dest_area.width  = block_width;
+              dest_area.height = block_height;
+
+              if (! gegl_rectangle_intersect (&dest_area,
+                                              &dest_area, dest_rect))
+                continue;
 
-          gegl_buffer_copy (src_buffer, src_area, abyss_policy,
-                            dest_buffer, dest_area);
+              src_area.x      = dest_area.x + (src_rect->x - dest_rect->x);
+              src_area.y      = dest_area.y + (src_rect->y - dest_rect->y);
+              src_area.width  = dest_area.width;
+              src_area.height = dest_area.height;
+
+              gegl_buffer_copy (src_buffer, &src_area, abyss_policy,
+                                dest_buffer, &dest_area);
+            }
         });
     }
 }
@@ -165,7 +230,7 @@ gimp_gegl_clear (GeglBuffer          *buffer,
   bpc          = bpp / n_components;
   alpha_offset = (n_components - 1) * bpc;
 
-  gegl_parallel_distribute_area (
+  gimp_parallel_distribute_area (
     rect, PIXELS_PER_THREAD,
     [=] (const GeglRectangle *area)
     {
@@ -264,7 +329,7 @@ gimp_gegl_convolve (GeglBuffer          *src_buffer,
       offset = 0.0;
     }
 
-  gegl_parallel_distribute_area (
+  gimp_parallel_distribute_area (
     dest_rect, PIXELS_PER_THREAD,
     [=] (const GeglRectangle *dest_area)
     {
@@ -291,29 +356,47 @@ gimp_gegl_convolve (GeglBuffer          *src_buffer,
           const gint  dest_y1 = dest_iter->items[0].roi.y;
           const gint  dest_x2 = dest_iter->items[0].roi.x + dest_iter->items[0].roi.width;
           const gint  dest_y2 = dest_iter->items[0].roi.y + dest_iter->items[0].roi.height;
+          const gint  n_cols  = dest_iter->items[0].roi.width + 2 * margin;
           gint        x, y;
 
+          gint          *cols;
+          const gfloat **rows;
+
+          /*  clamp the source columns and rows once, instead of for every
+           *  kernel tap of every pixel
+           */
+          cols = gegl_scratch_new (gint, n_cols);
+          rows = gegl_scratch_new (const gfloat *, kernel_size);
+
+          for (x = 0; x < n_cols; x++)
+            cols[x] = CLAMP (dest_x1 - margin + x, x1, x2) * components;
+
           for (y = dest_y1; y < dest_y2; y++)
             {
               gfloat *d = dest;
+              gint    j;
+
+              for (j = 0; j < kernel_size; j++)
+                rows[j] = src + CLAMP (y - margin + j, y1, y2) * src_rowstride;
 
               if (alpha_weighting)
                 {
                   for (x = dest_x1; x < dest_x2; x++)
                     {
                       const gfloat *m                = kernel;
+                      const gint   *c                = cols + (x - dest_x1);
                       gdouble       total[4]         = { 0.0, 0.0, 0.0, 0.0 };
                       gdouble       weighted_divisor = 0.0;
-                      gint          i, j, b;
+                      gint          i, b;
 
-                      for (j = y - margin; j <= y + margin; j++)
+                      for (j = 0; j < kernel_size; j++)
                         {
-                          for (i = x - margin; i <= x + margin; i++, m++)
+                          const gfloat *row = rows[j];
+
+                          for (i = 0; i < kernel_size; i++, m++)
                             {
-                              gint          xx = CLAMP (i, x1, x2);
-                              gint          yy = CLAMP (j, y1, y2);
-                              const gfloat *s  = src + yy * src_rowstride + xx * components;
-                              const gfloat  a  = s[a_component];
+                              const gfloat *s = row + c[i];
+                              const gfloat  a = s[a_component];
 
                               if (a)
                                 {
@@ -353,16 +436,17 @@ gimp_gegl_convolve (GeglBuffer          *src_buffer,
                   for (x = dest_x1; x < dest_x2; x++)
                     {
                       const gfloat *m        = kernel;
+                      const gint   *c        = cols + (x - dest_x1);
                       gdouble       total[4] = { 0.0, 0.0, 0.0, 0.0 };
-                      gint          i, j, b;
+                      gint          i, b;
 
-                      for (j = y - margin; j <= y + margin; j++)
+                      for (j = 0; j < kernel_size; j++)
                         {
-                          for (i = x - margin; i <= x + margin; i++, m++)
+                          const gfloat *row = rows[j];
+
+                          for (i = 0; i < kernel_size; i++, m++)
                             {
-                              gint          xx = CLAMP (i, x1, x2);
-                              gint          yy = CLAMP (j, y1, y2);
-                              const gfloat *s  = src + yy * src_rowstride + xx * components;
+                              const gfloat *s = row + c[i];
 
                               for (b = 0; b < components; b++)
                                 total[b] += *m * s[b];
@@ -383,6 +467,9 @@ gimp_gegl_convolve (GeglBuffer          *src_buffer,
 
               dest += dest_iter->items[0].roi.width * dest_components;
             }
+
+          gegl_scratch_free (rows);
+          gegl_scratch_free (cols);
         }
     });
 
@@ -417,7 +504,7 @@ gimp_gegl_dodgeburn (GeglBuffer          *src_buffer,
   if (! dest_rect)
     dest_rect = gegl_buffer_get_extent (dest_buffer);
 
-  gegl_parallel_distribute_area (
+  gimp_parallel_distribute_area (
     src_rect, PIXELS_PER_THREAD,
     [=] (const GeglRectangle *src_area)
     {
@@ -655,7 +742,7 @@ gimp_gegl_smudge_with_paint (GeglBuffer          *accum_buffer,
       brush_a *= brush_color_ptr[3];
     }
 
-  gegl_parallel_distribute_area (
+  gimp_parallel_distribute_area (
     accum_rect, PIXELS_PER_THREAD,
     [=] (const GeglRectangle *accum_area)
     {
@@ -724,7 +811,7 @@ gimp_gegl_apply_mask (GeglBuffer          *mask_buffer,
   if (! dest_rect)
     dest_rect = gegl_buffer_get_extent (dest_buffer);
 
-  gegl_parallel_distribute_area (
+  gimp_parallel_distribute_area (
     mask_rect, PIXELS_PER_THREAD,
     [=] (const GeglRectangle *mask_area)
     {
@@ -770,7 +857,7 @@ gimp_gegl_combine_mask (GeglBuffer          *mask_buffer,
   if (! dest_rect)
     dest_rect = gegl_buffer_get_extent (dest_buffer);
 
-  gegl_parallel_distribute_area (
+  gimp_parallel_distribute_area (
     mask_rect, PIXELS_PER_THREAD,
     [=] (const GeglRectangle *mask_area)
     {
@@ -817,7 +904,7 @@ gimp_gegl_combine_mask_weird (GeglBuffer          *mask_buffer,
   if (! dest_rect)
     dest_rect = gegl_buffer_get_extent (dest_buffer);
 
-  gegl_parallel_distribute_area (
+  gimp_parallel_distribute_area (
     mask_rect, PIXELS_PER_THREAD,
     [=] (const GeglRectangle *mask_area)
     {
@@ -878,7 +965,7 @@ gimp_gegl_index_to_mask (GeglBuffer          *indexed_buffer,
   if (! mask_rect)
     mask_rect = gegl_buffer_get_extent (mask_buffer);
 
-  gegl_parallel_distribute_area (
+  gimp_parallel_distribute_area (
     indexed_rect, PIXELS_PER_THREAD,
     [=] (const GeglRectangle *indexed_area)
     {
@@ -914,12 +1001,522 @@ gimp_gegl_index_to_mask (GeglBuffer          *indexed_buffer,
     });
 }
 
+/*  a separable box-cascade approximation of a gaussian blur, for masks.
+ *  the mask is divided into tiles, and only the tiles whose blur support
+ *  isn't uniform are actually blurred:  the rest keep (or take) the
+ *  uniform value, which is what a normalized blur gives there anyway.
+ */
+
 static void
-gimp_gegl_convert_color_profile_progress (GimpProgress *progress,
-                                          gdouble       value)
+gimp_gegl_feather_box_radii (gdouble std_dev,
+                             gint    radii[FEATHER_N_BOXES])
+{
+  const gint n = FEATHER_N_BOXES;
+  gdouble    var;
+  gint       wl;
+  gint       m;
+  gint       i;
+
+  /*  the widths of n box filters, whose cascade has the given variance.
+   *  see "Fast Almost-Gaussian Filtering", Peter Kovesi, 2010.
+   */
+  var = SQR (MAX (std_dev, 0.0));
+  wl  = floor (sqrt (12.0 * var / n + 1.0));
+
+  if (wl % 2 == 0)
+    wl--;
+
+  m = RINT ((12.0 * var - n * SQR (wl) - 4.0 * n * wl - 3.0 * n) /
+            (-4.0 * wl - 4.0));
+  m = CLAMP (m, 0, n);
+
+  for (i = 0; i < n; i++)
+    radii[i] = ((i < m ? wl : wl + 2) - 1) / 2;
+}
+
+/*  in-place box filters along rows, each of which shrinks the valid width
+ *  by twice its radius
+ */
+static void
+gimp_gegl_feather_boxes_x (gfloat     *data,
+                           gint        stride,
+                           gint        width,
+                           gint        height,
+                           const gint *radii)
+{
+  gint i;
+
+  for (i = 0; i < FEATHER_N_BOXES; i++)
+    {
+      const gint    r    = radii[i];
+      const gdouble norm = 1.0 / (2 * r + 1);
+      gint          y;
+
+      if (r == 0)
+        continue;
+
+      width -= 2 * r;
+
+      for (y = 0; y < height; y++)
+        {
+          gfloat  *row = data + y * stride;
+          gdouble  sum = 0.0;
+          gint     x;
+
+          for (x = 0; x < 2 * r; x++)
+            sum += row[x];
+
+          for (x = 0; x < width; x++)
+            {
+              gfloat first = row[x];
+
+              sum += row[x + 2 * r];
+
+              row[x] = sum * norm;
+
+              sum -= first;
+            }
+        }
+    }
+}
+
+/*  likewise, along columns  */
+static void
+gimp_gegl_feather_boxes_y (gfloat     *data,
+                           gint        stride,
+                           gint        width,
+                           gint        height,
+                           const gint *radii)
+{
+  gdouble *sums = g_new (gdouble, width);
+  gint     i;
+
+  for (i = 0; i < FEATHER_N_BOXES; i++)
+    {
+      const gint    r    = radii[i];
+      const gdouble norm = 1.0 / (2 * r + 1);
+      gint          x;
+      gint          y;
+
+      if (r == 0)
+        continue;
+
+      height -= 2 * r;
+
+      memset (sums, 0, width * sizeof (gdouble));
+
+      for (y = 0; y < 2 * r; y++)
+        {
+          const gfloat *row = data + y * stride;
+
+          for (x = 0; x < width; x++)
+            sums[x] += row[x];
+        }
+
+      for (y = 0; y < height; y++)
+        {
+          gfloat       *row  = data + y * stride;
+          const gfloat *next = row + 2 * r * stride;
+
+          for (x = 0; x < width; x++)
+            {
+              gfloat first = row[x];
+
+              sums[x] += next[x];
+
+              row[x] = sums[x] * norm;
+
+              sums[x] -= first;
+            }
+        }
+    }
+
+  g_free (sums);
+}
+
+void
+gimp_gegl_feather (GeglBuffer          *src_buffer,
+                   GeglBuffer          *dest_buffer,
+                   const GeglRectangle *dest_rect,
+                   gdouble              std_dev_x,
+                   gdouble              std_dev_y,
+                   GeglAbyssPolicy      abyss_policy)
 {
-  if (gegl_is_main_thread ())
-    gimp_progress_set_value (progress, value);
+  const GeglRectangle *src_extent;
+  const Babl          *format;
+  GeglBuffer          *result_buffer;
+  GeglRectangle        area;
+  gint                 radii_x[FEATHER_N_BOXES];
+  gint                 radii_y[FEATHER_N_BOXES];
+  gint                 support_x = 0;
+  gint                 support_y = 0;
+  gint                 tile_width;
+  gint                 tile_height;
+  gint                 n_cols;
+  gint                 n_rows;
+  gint                 block_cols;
+  gint                 block_rows;
+  gfloat              *cells;
+  guint8              *known;
+  guint8              *dirty;
+  GArray              *blocks;
+  gint                 col;
+  gint                 row;
+  gint                 i;
+
+  g_return_if_fail (GEGL_IS_BUFFER (src_buffer));
+  g_return_if_fail (GEGL_IS_BUFFER (dest_buffer));
+  g_return_if_fail (abyss_policy == GEGL_ABYSS_NONE ||
+                    abyss_policy == GEGL_ABYSS_CLAMP);
+
+  if (! dest_rect)
+    dest_rect = gegl_buffer_get_extent (dest_buffer);
+
+  if (gegl_rectangle_is_empty (dest_rect))
+    return;
+
+  src_extent = gegl_buffer_get_extent (src_buffer);
+
+  format = babl_format_with_space ("Y float",
+                                   gegl_buffer_get_format (dest_buffer));
+
+  gimp_gegl_feather_box_radii (std_dev_x, radii_x);
+  gimp_gegl_feather_box_radii (std_dev_y, radii_y);
+
+  for (i = 0; i < FEATHER_N_BOXES; i++)
+    {
+      support_x += radii_x[i];
+      support_y += radii_y[i];
+    }
+
+  g_object_get (dest_buffer,
+                "tile-width",  &tile_width,
+                "tile-height", &tile_height,
+                NULL);
+
+  /*  the tile grid of dest_buffer, over dest_rect and the blur support
+   *  around it
+   */
+  gegl_rectangle_align_to_buffer (
+    &area,
+    GEGL_RECTANGLE (dest_rect->x - support_x,
+                    dest_rect->y - support_y,
+                    dest_rect->width  + 2 * support_x,
+                    dest_rect->height + 2 * support_y),
+    dest_buffer,
+    GEGL_RECTANGLE_ALIGNMENT_SUPERSET);
+
+  n_cols = area.width  / tile_width;
+  n_rows = area.height / tile_height;
+
+  /*  find the uniform value of each cell of the grid, or NaN if it isn't
+   *  uniform.  outside of the source, the abyss is uniformly 0, or, when
+   *  clamping, has the value of the nearest cell.
+   */
+  cells = g_new0 (gfloat, n_cols * n_rows);
+  known = g_new0 (guint8, n_cols * n_rows);
+
+  if (abyss_policy == GEGL_ABYSS_NONE)
+    {
+      for (row = 0; row < n_rows; row++)
+        {
+          for (col = 0; col < n_cols; col++)
+            {
+              GeglRectangle cell = {area.x + col * tile_width,
+                                    area.y + row * tile_height,
+                                    tile_width, tile_height};
+              GeglRectangle inside;
+
+              gegl_rectangle_intersect (&inside, &cell, src_extent);
+
+              if (! gegl_rectangle_equal (&inside, &cell))
+                known[row * n_cols + col] = TRUE;
+            }
+        }
+    }
+
+  gimp_parallel_distribute_range (
+    n_rows, PIXELS_PER_THREAD / ((gdouble) area.width * tile_height),
+    [=] (gint offset, gint size)
+    {
+      GeglRectangle       rows;
+      GeglRectangle       src_area;
+      GeglBufferIterator *iter;
+
+      rows.x      = area.x;
+      rows.y      = area.y + offset * tile_height;
+      rows.width  = area.width;
+      rows.height = size * tile_height;
+
+      if (! gegl_rectangle_intersect (&src_area, &rows, src_extent))
+        return;
+
+      iter = gegl_buffer_iterator_new (src_buffer, &src_area, 0, format,
+                                       GEGL_ACCESS_READ, GEGL_ABYSS_NONE, 1);
+
+      while (gegl_buffer_iterator_next (iter))
+        {
+          const GeglRectangle *roi  = &iter->items[0].roi;
+          const gfloat        *data = (const gfloat *) iter->items[0].data;
+          gint                 y;
+
+          for (y = roi->y; y < roi->y + roi->height; y++)
+            {
+              gint r = (y - area.y) / tile_height;
+              gint x;
+
+              for (x = roi->x; x < roi->x + roi->width;)
+                {
+                  gint    c     = (x - area.x) / tile_width;
+                  gint    end   = MIN (area.x + (c + 1) * tile_width,
+                                       roi->x + roi->width);
+                  gfloat *cell  = &cells[r * n_cols + c];
+                  gfloat  value = *data;
+                  gint    n     = end - x;
+
+                  if (memcmp (data, data + 1, (n - 1) * sizeof (gfloat)))
+                    {
+                      *cell = NAN;
+                    }
+                  else if (! known[r * n_cols + c])
+                    {
+                      *cell = value;
+                    }
+                  else if (*cell != value)
+                    {
+                      *cell = NAN;
+                    }
+
+                  known[r * n_cols + c] = TRUE;
+
+                  data += n;
+                  x     = end;
+                }
+            }
+        }
+    });
+
+  if (abyss_policy == GEGL_ABYSS_CLAMP)
+    {
+      gint col1 = (src_extent->x - area.x) / tile_width;
+      gint row1 = (src_extent->y - area.y) / tile_height;
+      gint col2 = (src_extent->x + src_extent->width  - 1 - area.x) / tile_width;
+      gint row2 = (src_extent->y + src_extent->height - 1 - area.y) / tile_height;
+
+      for (row = 0; row < n_rows; row++)
+        {
+          for (col = 0; col < n_cols; col++)
+            {
+              gint c = CLAMP (col, col1, col2);
+              gint r = CLAMP (row, row1, row2);
+
+              if (c != col || r != row)
+                {
+                  cells[row * n_cols + col] = cells[r * n_cols + c];
+                  known[row * n_cols + col] = known[r * n_cols + c];
+                }
+            }
+        }
+    }
+
+  /*  a cell of dest_rect needs to be blurred, unless all the cells within
+   *  the blur support of it have the same uniform value
+   */
+  dirty = g_new0 (guint8, n_cols * n_rows);
+
+  for (row = 0; row < n_rows; row++)
+    {
+      for (col = 0; col < n_cols; col++)
+        {
+          GeglRectangle cell = {area.x + col * tile_width,
+                                area.y + row * tile_height,
+                                tile_width, tile_height};
+          gfloat        value;
+          gint          c1, c2;
+          gint          r1, r2;
+          gint          c, r;
+
+          if (! gegl_rectangle_intersect (&cell, &cell, dest_rect))
+            continue;
+
+          c1 = (cell.x - support_x - area.x) / tile_width;
+          r1 = (cell.y - support_y - area.y) / tile_height;
+          c2 = (cell.x + cell.width  - 1 + support_x - area.x) / tile_width;
+          r2 = (cell.y + cell.height - 1 + support_y - area.y) / tile_height;
+
+          value = cells[r1 * n_cols + c1];
+
+          for (r = r1; r <= r2 && ! isnan (value); r++)
+            {
+              for (c = c1; c <= c2; c++)
+                {
+                  if (! known[r * n_cols + c] || cells[r * n_cols + c] != value)
+                    {
+                      value = NAN;
+
+                      break;
+                    }
+                }
+            }
+
+          if (isnan (value))
+            dirty[row * n_cols + col] = TRUE;
+        }
+    }
+
+  /*  blur the dirty cells in blocks, so that the support around each block
+   *  is small relative to it
+   */
+  block_cols = CLAMP (MAX (FEATHER_MIN_BLOCK_SIZE, 2 * support_x), 1,
+                      FEATHER_MAX_BLOCK_SIZE) / tile_width;
+  block_rows = CLAMP (MAX (FEATHER_MIN_BLOCK_SIZE, 2 * support_y), 1,
+                      FEATHER_MAX_BLOCK_SIZE) / tile_height;
+
+  block_cols = MAX (block_cols, 1);
+  block_rows = MAX (block_rows, 1);
+
+  blocks = g_array_new (FALSE, FALSE, sizeof (GeglRectangle));
+
+  for (row = 0; row < n_rows; row += block_rows)
+    {
+      for (col = 0; col < n_cols; col += block_cols)
+        {
+          gint r, c;
+
+          for (r = row; r < MIN (row + block_rows, n_rows); r++)
+            {
+              for (c = col; c < MIN (col + block_cols, n_cols); c++)
+                {
+                  if (dirty[r * n_cols + c])
+                    break;
+                }
+
+              if (c < MIN (col + block_cols, n_cols))
+                break;
+            }
+
+          if (r < MIN (row + block_rows, n_rows))
+            {
+              GeglRectangle block = {area.x + col * tile_width,
+                                     area.y + row * tile_height,
+                                     block_cols * tile_width,
+                                     block_rows * tile_height};
+
+              gegl_rectangle_intersect (&block, &block, dest_rect);
+
+              g_array_append_val (blocks, block);
+            }
+        }
+    }
+
+  /*  when blurring in place, the blocks can't be written back before all
+   *  of them have been read
+   */
+  if (src_buffer == dest_buffer && blocks->len > 0)
+    result_buffer = gegl_buffer_new (dest_rect, format);
+  else
+    result_buffer = g_object_ref (dest_buffer);
+
+  gimp_parallel_distribute_range (
+    blocks->len, 0.0,
+    [=] (gint offset, gint size)
+    {
+      gint b;
+
+      for (b = offset; b < offset + size; b++)
+        {
+          const GeglRectangle *block = &g_array_index (blocks, GeglRectangle,
+                                                       b);
+          GeglRectangle        src_area;
+          gfloat              *data;
+          gint                 stride;
+          gint                 r1, r2;
+          gint                 c1, c2;
+          gint                 r, c;
+
+          src_area.x      = block->x - support_x;
+          src_area.y      = block->y - support_y;
+          src_area.width  = block->width  + 2 * support_x;
+          src_area.height = block->height + 2 * support_y;
+
+          stride = src_area.width;
+
+          data = g_new (gfloat, (gsize) src_area.width * src_area.height);
+
+          gegl_buffer_get (src_buffer, &src_area, 1.0, format, data,
+                           stride * sizeof (gfloat), abyss_policy);
+
+          gimp_gegl_feather_boxes_x (data, stride,
+                                     src_area.width, src_area.height,
+                                     radii_x);
+          gimp_gegl_feather_boxes_y (data, stride,
+                                     block->width, src_area.height,
+                                     radii_y);
+
+          r1 = (block->y - area.y) / tile_height;
+          c1 = (block->x - area.x) / tile_width;
+          r2 = (block->y + block->height - 1 - area.y) / tile_height;
+          c2 = (block->x + block->width  - 1 - area.x) / tile_width;
+
+          for (r = r1; r <= r2; r++)
+            {
+              for (c = c1; c <= c2; c++)
+                {
+                  GeglRectangle cell = {area.x + c * tile_width,
+                                        area.y + r * tile_height,
+                                        tile_width, tile_height};
+
+                  if (! dirty[r * n_cols + c])
+                    continue;
+
+                  gegl_rectangle_intersect (&cell, &cell, block);
+
+                  gegl_buffer_set (result_buffer, &cell, 0, format,
+                                   data + (cell.y - block->y) * stride +
+                                          (cell.x - block->x),
+                                   stride * sizeof (gfloat));
+                }
+            }
+
+          g_free (data);
+        }
+    });
+
+  /*  write back the blurred cells, and fill the uniform ones  */
+  for (row = 0; row < n_rows; row++)
+    {
+      for (col = 0; col < n_cols; col++)
+        {
+          GeglRectangle cell = {area.x + col * tile_width,
+                                area.y + row * tile_height,
+                                tile_width, tile_height};
+
+          if (! gegl_rectangle_intersect (&cell, &cell, dest_rect))
+            continue;
+
+          if (dirty[row * n_cols + col])
+            {
+              if (result_buffer != dest_buffer)
+                {
+                  gimp_gegl_buffer_copy (result_buffer, &cell, GEGL_ABYSS_NONE,
+                                         dest_buffer, &cell);
+                }
+            }
+          else if (src_buffer != dest_buffer)
+            {
+              gimp_gegl_buffer_set_constant (dest_buffer, &cell,
+                                             &cells[row * n_cols + col],
+                                             format);
+            }
+        }
+    }
+
+  g_object_unref (result_buffer);
+
+  g_array_free (blocks, TRUE);
+  g_free (dirty);
+  g_free (known);
+  g_free (cells);
 }
 
 void
@@ -952,10 +1549,10 @@ gimp_gegl_convert_color_profile (GeglBuffer               *src_buffer,
 
   flags |= GIMP_COLOR_TRANSFORM_FLAGS_NOOPTIMIZE;
 
-  transform = gimp_color_transform_new (src_profile,  src_format,
-                                        dest_profile, dest_format,
-                                        intent,
-                                        (GimpColorTransformFlags) flags);
+  transform = gimp_gegl_color_transform_get (src_profile,  src_format,
+                                             dest_profile, dest_format,
+                                             intent,
+                                             (GimpColorTransformFlags) flags);
 
   if (! src_rect)
     src_rect = gegl_buffer_get_extent (src_buffer);
@@ -965,25 +1562,44 @@ gimp_gegl_convert_color_profile (GeglBuffer               *src_buffer,
 
   if (transform)
     {
-      if (progress)
-        {
-          g_signal_connect_swapped (
-            transform, "progress",
-            G_CALLBACK (gimp_gegl_convert_color_profile_progress),
-            progress);
-        }
-
       GIMP_TIMER_START ();
 
-      gegl_parallel_distribute_area (
+      gimp_parallel_distribute_area (
         src_rect, PIXELS_PER_THREAD,
         [=] (const GeglRectangle *src_area)
         {
           SHIFTED_AREA (dest, src);
+          gint y;
 
-          gimp_color_transform_process_buffer (transform,
-                                               src_buffer,  src_area,
-                                               dest_buffer, dest_area);
+          /*  the transform is shared, so we report progress ourselves,
+           *  instead of connecting to its "progress" signal
+           */
+          if (! progress || ! gegl_is_main_thread ())
+            {
+              gimp_color_transform_process_buffer (transform,
+                                                   src_buffer,  src_area,
+                                                   dest_buffer, dest_area);
+
+              return;
+            }
+
+          for (y = 0; y < src_area->height; y += CONVERT_PROGRESS_ROWS)
+            {
+              gint height = MIN (CONVERT_PROGRESS_ROWS, src_area->height - y);
+
+              gimp_color_transform_process_buffer (
+                transform,
+                src_buffer,
+                GEGL_RECTANGLE (src_area->x, src_area->y + y,
+                                src_area->width, height),
+                dest_buffer,
+                GEGL_RECTANGLE (dest_area->x, dest_area->y + y,
+                                dest_area->width, height));
+
+              gimp_progress_set_value (progress,
+                                       (gdouble) (y + height) /
+                                       src_area->height);
+            }
         });
 
       GIMP_TIMER_END ("converting buffer");
@@ -1038,7 +1654,7 @@ gimp_gegl_average_color (GeglBuffer          *buffer,
   else
     roi = *rect;
 
-  gegl_parallel_distribute_area (
+  gimp_parallel_distribute_area (
     &roi, PIXELS_PER_THREAD,
     [&] (const GeglRectangle *area)
     {
@@ -88,6 +88,13 @@ void   gimp_gegl_index_to_mask         (GeglBuffer               *indexed_buffer
                                         const GeglRectangle      *mask_rect,
                                         gint                      index);
 
+void   gimp_gegl_feather               (GeglBuffer               *src_buffer,
+                                        GeglBuffer               *dest_buffer,
+                                        const GeglRectangle      *dest_rect,
+                                        gdouble                   std_dev_x,
+                                        gdouble                   std_dev_y,
+                                        GeglAbyssPolicy           abyss_policy);
+
 void   gimp_gegl_convert_color_profile (GeglBuffer               *src_buffer,
                                         const GeglRectangle      *src_rect,
                                         GimpColorProfile         *src_profile,
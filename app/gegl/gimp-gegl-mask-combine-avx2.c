@@ -0,0 +1,207 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimp-gegl-mask-combine-avx2.c
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <math.h>
+
+#include <glib.h>
+
+#include "gimp-gegl-mask-combine-avx2.h"
+
+
+#if COMPILE_AVX2_INTRINISICS
+
+/* AVX2 */
+#include <immintrin.h>
+
+
+/*  must match gimp-gegl-mask-combine.cc  */
+#define EPSILON 1e-6
+
+
+/*  like the scalar code's MIN(), MAX() and CLAMP(), including for NaNs  */
+#define MIN_PD(a, b)        _mm256_min_pd (a, b)
+#define MAX_PD(a, b)        _mm256_max_pd (a, b)
+#define SELECT_PD(c, a, b)  _mm256_blendv_pd (b, a, c)
+#define GT_PD(a, b)         _mm256_cmp_pd (a, b, _CMP_GT_OQ)
+#define LT_PD(a, b)         _mm256_cmp_pd (a, b, _CMP_LT_OQ)
+#define SQR_PD(a)           _mm256_mul_pd (a, a)
+#define NEG_PD(a)           _mm256_xor_pd (a, _mm256_set1_pd (-0.0))
+
+
+void
+gimp_gegl_mask_combine_ellipse_values_avx2 (gint     left,
+                                            gint     right,
+                                            gint     top,
+                                            gint     bottom,
+                                            gdouble  rx,
+                                            gdouble  ry,
+                                            gint     x,
+                                            gint     y,
+                                            gint     n,
+                                            gfloat  *values)
+{
+  const gdouble cx = (left + right)  / 2.0;
+  const gdouble cy = (top  + bottom) / 2.0;
+  const __m256d zero = _mm256_setzero_pd ();
+  const __m256d half = _mm256_set1_pd (0.5);
+  const __m256d one  = _mm256_set1_pd (1.0);
+  const __m256d lanes = _mm256_setr_pd (0.0, 1.0, 2.0, 3.0);
+  gdouble       v;
+  gdouble       vc;
+  gdouble       vu;
+  gdouble       vs;
+  gboolean      v_edge;
+  gboolean      y_opposite;
+  gboolean      x_opposite;
+  gdouble       x_opposite_x;
+  gint          i;
+
+  /*  everything that only depends on the row  */
+  if (y + 0.5 < cy)
+    v = (top + ry) - (y + 0.5);
+  else
+    v = (y + 0.5) - (bottom - ry);
+
+  vc = MAX (v, 0.0);
+
+  if (vc > 0.0)
+    vu = sqrt (MAX (rx * rx - (rx * vc / ry) * (rx * vc / ry), 0.0));
+  else
+    vu = rx;
+
+  vs = vc * (rx / ry);
+
+  v_edge     = v < 0.5;
+  y_opposite = y == (bottom - 1) - (y - top);
+
+  x_opposite   = ((right - 1 + left) & 1) == 0;
+  x_opposite_x = (right - 1 + left) / 2;
+
+  for (i = 0; i < n; i += 4)
+    {
+      __m256d px;
+      __m256d u;
+      __m256d uc;
+      __m256d uv;
+      __m256d du, dv;
+      __m256d t;
+      __m256d a, b, c;
+      __m256d disc;
+      __m256d d;
+      __m256d q1, q2;
+      __m256d mask;
+
+      px = _mm256_add_pd (_mm256_set1_pd (x + i), lanes);
+
+      /*  x_to_u ()  */
+      u = _mm256_add_pd (px, half);
+      u = SELECT_PD (LT_PD (u, _mm256_set1_pd (cx)),
+                     _mm256_sub_pd (_mm256_set1_pd (left + rx), u),
+                     _mm256_sub_pd (u, _mm256_set1_pd (right - rx)));
+
+      /*  ellipse_distance ()  */
+      uc = MAX_PD (u, zero);
+
+      du = _mm256_sub_pd (_mm256_set1_pd (vu), uc);
+
+      uv = _mm256_div_pd (_mm256_mul_pd (_mm256_set1_pd (ry), uc),
+                          _mm256_set1_pd (rx));
+      uv = _mm256_sqrt_pd (MAX_PD (_mm256_sub_pd (_mm256_set1_pd (ry * ry),
+                                                  SQR_PD (uv)),
+                                   zero));
+      uv = SELECT_PD (GT_PD (uc, zero), uv, _mm256_set1_pd (ry));
+
+      dv = _mm256_sub_pd (uv, _mm256_set1_pd (vc));
+
+      t = _mm256_div_pd (SQR_PD (du), _mm256_add_pd (SQR_PD (du), SQR_PD (dv)));
+
+      du = _mm256_mul_pd (du, _mm256_sub_pd (one, t));
+      dv = _mm256_mul_pd (dv, t);
+
+      dv = _mm256_mul_pd (dv, _mm256_set1_pd (rx / ry));
+
+      a = _mm256_add_pd (SQR_PD (du), SQR_PD (dv));
+      b = _mm256_add_pd (_mm256_mul_pd (uc, du),
+                         _mm256_mul_pd (_mm256_set1_pd (vs), dv));
+      c = _mm256_sub_pd (_mm256_add_pd (SQR_PD (uc),
+                                        _mm256_set1_pd (vs * vs)),
+                         _mm256_set1_pd (rx * rx));
+
+      disc = _mm256_sqrt_pd (MAX_PD (_mm256_sub_pd (SQR_PD (b),
+                                                    _mm256_mul_pd (a, c)),
+                                     zero));
+
+      t = _mm256_div_pd (SELECT_PD (LT_PD (c, zero),
+                                    _mm256_sub_pd (disc, b),
+                                    _mm256_sub_pd (NEG_PD (b), disc)),
+                         a);
+
+      dv = _mm256_mul_pd (dv, _mm256_set1_pd (ry / rx));
+
+      d = _mm256_sqrt_pd (_mm256_add_pd (SQR_PD (_mm256_mul_pd (du, t)),
+                                         SQR_PD (_mm256_mul_pd (dv, t))));
+
+      d = SELECT_PD (GT_PD (c, zero), NEG_PD (d), d);
+
+      q1 = _mm256_div_pd (du, dv);
+      q2 = _mm256_div_pd (dv, du);
+
+      d = _mm256_div_pd (d, _mm256_sqrt_pd (_mm256_add_pd (SQR_PD (MIN_PD (q1,
+                                                                           q2)),
+                                                           one)));
+
+      d = SELECT_PD (_mm256_cmp_pd (a, _mm256_set1_pd (EPSILON), _CMP_LE_OQ),
+                     zero, d);
+
+      /*  pixel_value ()  */
+      d = _mm256_add_pd (half, d);
+      d = SELECT_PD (GT_PD (d, one), one, SELECT_PD (LT_PD (d, zero), zero, d));
+
+      mask = LT_PD (u, half);
+      d    = SELECT_PD (mask,
+                        _mm256_add_pd (_mm256_mul_pd (d,
+                                                      _mm256_add_pd (half, u)),
+                                       _mm256_sub_pd (half, u)),
+                        d);
+
+      if (v_edge)
+        {
+          d = _mm256_add_pd (_mm256_mul_pd (d, _mm256_set1_pd (0.5 + v)),
+                             _mm256_set1_pd (0.5 - v));
+        }
+
+      if (x_opposite)
+        {
+          mask = _mm256_cmp_pd (px, _mm256_set1_pd (x_opposite_x),
+                                _CMP_EQ_OQ);
+          d    = SELECT_PD (mask,
+                            _mm256_sub_pd (_mm256_add_pd (d, d), one),
+                            d);
+        }
+
+      if (y_opposite)
+        d = _mm256_sub_pd (_mm256_add_pd (d, d), one);
+
+      _mm_storeu_ps (values + i, _mm256_cvtpd_ps (d));
+    }
+}
+
+#endif /* COMPILE_AVX2_INTRINISICS */
@@ -0,0 +1,45 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimp-gegl-mask-combine-avx2.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GIMP_GEGL_MASK_COMBINE_AVX2_H__
+#define __GIMP_GEGL_MASK_COMBINE_AVX2_H__
+
+
+#if COMPILE_AVX2_INTRINISICS
+
+/*  computes the anti-aliased values of the n (a multiple of 4) pixels
+ *  starting at (x, y), of a rounded rectangle with the given bounds and
+ *  elliptic corner radii, exactly as gimp_gegl_mask_combine_ellipse_rect()
+ *  does.
+ */
+void   gimp_gegl_mask_combine_ellipse_values_avx2 (gint     left,
+                                                   gint     right,
+                                                   gint     top,
+                                                   gint     bottom,
+                                                   gdouble  rx,
+                                                   gdouble  ry,
+                                                   gint     x,
+                                                   gint     y,
+                                                   gint     n,
+                                                   gfloat  *values);
+
+#endif /* COMPILE_AVX2_INTRINISICS */
+
+
+#endif /* __GIMP_GEGL_MASK_COMBINE_AVX2_H__ */
@@ -33,6 +33,8 @@ extern "C"
 #include "gimp-babl.h"
 #include "gimp-gegl-loops.h"
 #include "gimp-gegl-mask-combine.h"
+#include "gimp-gegl-mask-combine-avx2.h"
+#include "gimp-gegl-tile-share.h"
 
 
 #define EPSILON 1e-6
@@ -76,8 +78,9 @@ gimp_gegl_mask_combine_rect (GeglBuffer     *mask,
       return TRUE;
     }
 
-  gegl_buffer_set_color_from_pixel (mask, &rect, &value,
-                                    babl_format ("Y float"));
+  /* the whole tiles of the rectangle share a single constant tile */
+  gimp_gegl_buffer_set_constant (mask, &rect, &value,
+                                 babl_format ("Y float"));
 
   return TRUE;
 }
@@ -117,6 +120,16 @@ gimp_gegl_mask_combine_ellipse_rect (GeglBuffer     *mask,
   gint           right;
   gint           top;
   gint           bottom;
+  gint           tile_width;
+  gint           tile_height;
+  GeglRectangle  aligned;
+  GArray        *tiles;
+  gint           tx;
+  gint           ty;
+#if COMPILE_AVX2_INTRINISICS
+  gboolean       avx2 = (gimp_cpu_accel_get_support () &
+                         GIMP_CPU_ACCEL_X86_AVX2);
+#endif
 
   g_return_val_if_fail (GEGL_IS_BUFFER (mask), FALSE);
 
@@ -298,6 +311,28 @@ gimp_gegl_mask_combine_ellipse_rect (GeglBuffer     *mask,
     return d;
   };
 
+  /* anti-aliased values of a run of pixels */
+  auto pixel_values = [=] (gint    x,
+                           gint    y,
+                           gint    n,
+                           gfloat *values)
+  {
+    gint i = 0;
+
+#if COMPILE_AVX2_INTRINISICS
+    if (avx2)
+      {
+        i = n & ~3;
+
+        gimp_gegl_mask_combine_ellipse_values_avx2 (left, right, top, bottom,
+                                                    rx, ry, x, y, i, values);
+      }
+#endif /* COMPILE_AVX2_INTRINISICS */
+
+    for (; i < n; i++)
+      values[i] = pixel_value (x + i, y);
+  };
+
   auto ellipse_range = [=] (gdouble  y,
                             gdouble *x0,
                             gdouble *x1)
@@ -374,128 +409,227 @@ gimp_gegl_mask_combine_ellipse_rect (GeglBuffer     *mask,
     return (gpointer) (p + 1);
   };
 
-  gegl_parallel_distribute_area (
-    &rect, PIXELS_PER_THREAD,
-    [=] (const GeglRectangle *area)
-    {
-      GeglBufferIterator *iter;
+  /* classify a tile as being fully inside (1) or outside (-1) the ellipse, or
+   * intersecting its circumference (0).
+   */
+  auto classify = [=] (const GeglRectangle *roi)
+  {
+    gdouble tx0, ty0;
+    gdouble tx1, ty1;
+    gdouble x0;
+    gdouble x1;
+
+    /* tile bounds */
+    tx0 = roi->x;
+    ty0 = roi->y;
+
+    tx1 = roi->x + roi->width;
+    ty1 = roi->y + roi->height;
+
+    if (! antialias)
+      {
+        tx0 += 0.5;
+        ty0 += 0.5;
+
+        tx1 -= 0.5;
+        ty1 -= 0.5;
+      }
+
+    ellipse_range (ty0, &x0, &x1);
+
+    if (tx0 >= x0 && tx1 <= x1)
+      {
+        ellipse_range (ty1, &x0, &x1);
+
+        if (tx0 >= x0 && tx1 <= x1)
+          return 1;
+      }
+    else if (tx1 < x0 || tx0 > x1)
+      {
+        ellipse_range (ty1, &x0, &x1);
+
+        if (tx1 < x0 || tx0 > x1)
+          {
+            if ((ty0 - cy) * (ty1 - cy) >= 0.0)
+              return -1;
+          }
+      }
+
+    return 0;
+  };
+
+  /* fill a run of tiles that are fully inside/outside the ellipse.  going
+   * through gimp_gegl_buffer_set_constant() and gegl_buffer_clear(), rather
+   * than an iterator, lets all the whole tiles of the run share a single
+   * constant tile, or drop their storage, respectively, so that the interior
+   * of a large ellipse doesn't cost any memory beyond that of its outline.
+   */
+  auto fill_run = [=] (const GeglRectangle *run,
+                       gint                 inside)
+  {
+    switch (op)
+      {
+      case GIMP_CHANNEL_OP_REPLACE:
+      case GIMP_CHANNEL_OP_ADD:
+        if (inside > 0)
+          {
+            gimp_gegl_buffer_set_constant (mask, run, &one_f,
+                                           babl_format ("Y float"));
+          }
+        else if (op == GIMP_CHANNEL_OP_REPLACE)
+          {
+            gegl_buffer_clear (mask, run);
+          }
+        break;
 
-      iter = gegl_buffer_iterator_new (
-        mask, area, 0, format,
-        op == GIMP_CHANNEL_OP_REPLACE ? GEGL_ACCESS_WRITE :
-                                        GEGL_ACCESS_READWRITE,
-        GEGL_ABYSS_NONE, 1);
+      case GIMP_CHANNEL_OP_SUBTRACT:
+        if (inside > 0)
+          gegl_buffer_clear (mask, run);
+        break;
+
+      case GIMP_CHANNEL_OP_INTERSECT:
+        if (inside < 0)
+          gegl_buffer_clear (mask, run);
+        break;
+      }
+  };
+
+  g_object_get (mask,
+                "tile-width",  &tile_width,
+                "tile-height", &tile_height,
+                NULL);
+
+  gegl_rectangle_align_to_buffer (&aligned, &rect, mask,
+                                  GEGL_RECTANGLE_ALIGNMENT_SUPERSET);
+
+  tiles = g_array_new (FALSE, FALSE, sizeof (GeglRectangle));
+
+  for (ty = aligned.y; ty < aligned.y + aligned.height; ty += tile_height)
+    {
+      GeglRectangle run    = {};
+      gint          inside = 0;
 
-      while (gegl_buffer_iterator_next (iter))
+      for (tx = aligned.x; tx < aligned.x + aligned.width; tx += tile_width)
         {
-          const GeglRectangle *roi = &iter->items[0].roi;
-          gpointer             d   = iter->items[0].data;
-          gdouble              tx0, ty0;
-          gdouble              tx1, ty1;
-          gdouble              x0;
-          gdouble              x1;
-          gint                 y;
-
-          /* tile bounds */
-          tx0 = roi->x;
-          ty0 = roi->y;
-
-          tx1 = roi->x + roi->width;
-          ty1 = roi->y + roi->height;
-
-          if (! antialias)
+          GeglRectangle roi;
+          gint          tile_inside;
+
+          gegl_rectangle_intersect (&roi,
+                                    GEGL_RECTANGLE (tx, ty,
+                                                    tile_width, tile_height),
+                                    &rect);
+
+          tile_inside = classify (&roi);
+
+          if (inside && tile_inside == inside)
             {
-              tx0 += 0.5;
-              ty0 += 0.5;
+              run.width = roi.x + roi.width - run.x;
 
-              tx1 -= 0.5;
-              ty1 -= 0.5;
+              continue;
             }
 
-          /* if the tile is fully inside/outside the ellipse, fill it with 1/0,
-           * respectively, and skip the rest.
-           */
-          ellipse_range (ty0, &x0, &x1);
+          if (inside)
+            fill_run (&run, inside);
 
-          if (tx0 >= x0 && tx1 <= x1)
-            {
-              ellipse_range (ty1, &x0, &x1);
+          run    = roi;
+          inside = tile_inside;
 
-              if (tx0 >= x0 && tx1 <= x1)
-                {
-                  fill1 (d, iter->length);
+          if (! inside)
+            g_array_append_val (tiles, roi);
+        }
 
-                  continue;
-                }
-            }
-          else if (tx1 < x0 || tx0 > x1)
-            {
-              ellipse_range (ty1, &x0, &x1);
+      if (inside)
+        fill_run (&run, inside);
+    }
 
-              if (tx1 < x0 || tx0 > x1)
-                {
-                  if ((ty0 - cy) * (ty1 - cy) >= 0.0)
-                    {
-                      fill0 (d, iter->length);
+  gegl_parallel_distribute_range (
+    tiles->len, PIXELS_PER_THREAD / (tile_width * tile_height),
+    [=] (gint offset, gint size)
+    {
+      gfloat *values = g_new (gfloat, tile_width);
+      gint    i;
 
-                      continue;
-                    }
-                }
-            }
+      for (i = offset; i < offset + size; i++)
+        {
+          const GeglRectangle *area = &g_array_index (tiles, GeglRectangle, i);
+          GeglBufferIterator  *iter;
+
+          iter = gegl_buffer_iterator_new (
+            mask, area, 0, format,
+            op == GIMP_CHANNEL_OP_REPLACE ? GEGL_ACCESS_WRITE :
+                                            GEGL_ACCESS_READWRITE,
+            GEGL_ABYSS_NONE, 1);
 
-          for (y = roi->y; y < roi->y + roi->height; y++)
+          while (gegl_buffer_iterator_next (iter))
             {
-              gint a, b;
+              const GeglRectangle *roi = &iter->items[0].roi;
+              gpointer             d   = iter->items[0].data;
+              gdouble              x0;
+              gdouble              x1;
+              gint                 y;
 
-              if (antialias)
+              for (y = roi->y; y < roi->y + roi->height; y++)
                 {
-                  gdouble v  = y_to_v (y + 0.5);
-                  gdouble u0 = v_to_u (v - 0.5);
-                  gdouble u1 = v_to_u (v + 0.5);
-                  gint    x;
+                  gint a, b;
 
-                  a = floor (u_to_x_left (u0)) - roi->x;
-                  a = CLAMP (a, 0, roi->width);
+                  if (antialias)
+                    {
+                      gdouble v  = y_to_v (y + 0.5);
+                      gdouble u0 = v_to_u (v - 0.5);
+                      gdouble u1 = v_to_u (v + 0.5);
+                      gint    x;
 
-                  b = ceil  (u_to_x_left (u1)) - roi->x;
-                  b = CLAMP (b, a, roi->width);
+                      a = floor (u_to_x_left (u0)) - roi->x;
+                      a = CLAMP (a, 0, roi->width);
 
-                  d = fill0 (d, a);
+                      b = ceil  (u_to_x_left (u1)) - roi->x;
+                      b = CLAMP (b, a, roi->width);
 
-                  for (x = roi->x + a; x < roi->x + b; x++)
-                    d = set (d, pixel_value (x, y));
+                      d = fill0 (d, a);
 
-                  a = floor (u_to_x_right (u1)) - roi->x;
-                  a = CLAMP (a, b, roi->width);
+                      pixel_values (roi->x + a, y, b - a, values);
 
-                  d = fill1 (d, a - b);
+                      for (x = 0; x < b - a; x++)
+                        d = set (d, values[x]);
 
-                  b = ceil  (u_to_x_right (u0)) - roi->x;
-                  b = CLAMP (b, a, roi->width);
+                      a = floor (u_to_x_right (u1)) - roi->x;
+                      a = CLAMP (a, b, roi->width);
 
-                  for (x = roi->x + a; x < roi->x + b; x++)
-                    d = set (d, pixel_value (x, y));
+                      d = fill1 (d, a - b);
 
-                  d = fill0 (d, roi->width - b);
-                }
-              else
-                {
-                  ellipse_range (y + 0.5, &x0, &x1);
+                      b = ceil  (u_to_x_right (u0)) - roi->x;
+                      b = CLAMP (b, a, roi->width);
 
-                  a = ceil  (x0 - 0.5) - roi->x;
-                  a = CLAMP (a, 0, roi->width);
+                      pixel_values (roi->x + a, y, b - a, values);
 
-                  b = floor (x1 + 0.5) - roi->x;
-                  b = CLAMP (b, 0, roi->width);
+                      for (x = 0; x < b - a; x++)
+                        d = set (d, values[x]);
 
-                  d = fill0 (d, a);
-                  d = fill1 (d, b - a);
-                  d = fill0 (d, roi->width - b);
+                      d = fill0 (d, roi->width - b);
+                    }
+                  else
+                    {
+                      ellipse_range (y + 0.5, &x0, &x1);
+
+                      a = ceil  (x0 - 0.5) - roi->x;
+                      a = CLAMP (a, 0, roi->width);
+
+                      b = floor (x1 + 0.5) - roi->x;
+                      b = CLAMP (b, 0, roi->width);
+
+                      d = fill0 (d, a);
+                      d = fill1 (d, b - a);
+                      d = fill0 (d, roi->width - b);
+                    }
                 }
             }
         }
+
+      g_free (values);
     });
 
+  g_array_free (tiles, TRUE);
+
   return TRUE;
 }
 
@@ -647,6 +781,12 @@ gimp_gegl_mask_combine_buffer (GeglBuffer     *mask,
         }
     });
 
+  /*  combining selections mostly leaves tiles that are all selected or
+   *  all unselected behind, let them share storage like the rect and
+   *  ellipse ops' constant tiles do
+   */
+  gimp_gegl_buffer_share_constant_tiles (mask, &mask_rect);
+
   return TRUE;
 }
 
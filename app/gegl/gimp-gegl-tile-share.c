@@ -0,0 +1,509 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimp-gegl-tile-share.c
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include <gegl.h>
+
+#include "gimp-gegl-types.h"
+
+#include "gimp-gegl-loops.h"
+#include "gimp-gegl-tile-share.h"
+
+
+/*  uniform tiles are shared among all buffers, and all positions, that hold
+ *  the same pixel.  for each such pixel we keep a small source buffer, all of
+ *  whose tiles are copy-on-write duplicates of a single tile, and fill whole
+ *  tiles by gegl_buffer_copy()ing from it, which duplicates the tile again
+ *  instead of copying its data.  writing to a shared tile later on un-shares
+ *  only that tile.
+ *
+ *  all-zero pixels are left to gegl_buffer_clear(), whose empty tiles don't
+ *  take any storage to begin with.
+ */
+
+
+#define MAX_BPP              64
+#define MAX_CONSTANT_SOURCES 64
+#define SOURCE_TILES         16
+
+
+typedef struct
+{
+  const Babl *format;
+  gint        tile_width;
+  gint        tile_height;
+  gint        bpp;
+  guint8      pixel[MAX_BPP];
+} ConstantKey;
+
+typedef struct
+{
+  GeglRectangle rect;
+  guint8        pixel[MAX_BPP];
+} ConstantTile;
+
+
+/*  local function prototypes  */
+
+static guint        constant_key_hash     (gconstpointer        key);
+static gboolean     constant_key_equal    (gconstpointer        key1,
+                                           gconstpointer        key2);
+static void         constant_key_free     (gpointer             key);
+
+static gboolean     constant_key_init     (ConstantKey         *key,
+                                           GeglBuffer          *buffer);
+static GeglBuffer * constant_source_get   (const ConstantKey   *key);
+
+static void         buffer_set_constant   (GeglBuffer          *buffer,
+                                           const GeglRectangle *rect,
+                                           const ConstantKey   *key);
+
+
+/*  local variables  */
+
+static GMutex      constant_mutex;
+static GHashTable *constant_sources = NULL;
+
+
+/*  public functions  */
+
+void
+gimp_gegl_tile_share_exit (void)
+{
+  g_mutex_lock (&constant_mutex);
+
+  g_clear_pointer (&constant_sources, g_hash_table_unref);
+
+  g_mutex_unlock (&constant_mutex);
+}
+
+void
+gimp_gegl_buffer_set_constant (GeglBuffer          *buffer,
+                               const GeglRectangle *rect,
+                               gconstpointer        pixel,
+                               const Babl          *pixel_format)
+{
+  ConstantKey key;
+
+  g_return_if_fail (GEGL_IS_BUFFER (buffer));
+  g_return_if_fail (pixel != NULL);
+
+  if (! rect)
+    rect = gegl_buffer_get_extent (buffer);
+
+  if (! pixel_format)
+    pixel_format = gegl_buffer_get_format (buffer);
+
+  if (! constant_key_init (&key, buffer))
+    {
+      gegl_buffer_set_color_from_pixel (buffer, rect, pixel, pixel_format);
+
+      return;
+    }
+
+  babl_process (babl_fish (pixel_format, key.format), pixel, key.pixel, 1);
+
+  buffer_set_constant (buffer, rect, &key);
+}
+
+void
+gimp_gegl_buffer_set_constant_color (GeglBuffer          *buffer,
+                                     const GeglRectangle *rect,
+                                     GeglColor           *color)
+{
+  const Babl *format;
+  gpointer    pixel;
+
+  g_return_if_fail (GEGL_IS_BUFFER (buffer));
+  g_return_if_fail (GEGL_IS_COLOR (color));
+
+  format = gegl_buffer_get_format (buffer);
+  pixel  = g_alloca (babl_format_get_bytes_per_pixel (format));
+
+  gegl_color_get_pixel (color, format, pixel);
+
+  gimp_gegl_buffer_set_constant (buffer, rect, pixel, format);
+}
+
+/*  replaces the uniform whole tiles of rect by shared ones.  meant to follow
+ *  operations that are likely to leave large uniform areas behind, but that
+ *  don't know so in advance.
+ */
+void
+gimp_gegl_buffer_share_constant_tiles (GeglBuffer          *buffer,
+                                       const GeglRectangle *rect)
+{
+  GeglBufferIterator *iter;
+  GeglRectangle       area;
+  ConstantKey         key;
+  GArray             *tiles;
+  guint               i;
+
+  g_return_if_fail (GEGL_IS_BUFFER (buffer));
+
+  if (! rect)
+    rect = gegl_buffer_get_extent (buffer);
+
+  if (! constant_key_init (&key, buffer))
+    return;
+
+  gegl_rectangle_align_to_buffer (&area, rect, buffer,
+                                  GEGL_RECTANGLE_ALIGNMENT_SUBSET);
+
+  if (gegl_rectangle_is_empty (&area))
+    return;
+
+  tiles = g_array_new (FALSE, FALSE, sizeof (ConstantTile));
+
+  iter = gegl_buffer_iterator_new (buffer, &area, 0, key.format,
+                                   GEGL_ACCESS_READ, GEGL_ABYSS_NONE, 1);
+
+  while (gegl_buffer_iterator_next (iter))
+    {
+      const guint8 *data = iter->items[0].data;
+      ConstantTile  tile;
+
+      /*  the data is uniform iff it's equal to itself, shifted by a pixel  */
+      if (memcmp (data, data + key.bpp, (iter->length - 1) * key.bpp))
+        continue;
+
+      tile.rect = iter->items[0].roi;
+      memcpy (tile.pixel, data, key.bpp);
+
+      g_array_append_val (tiles, tile);
+    }
+
+  gegl_buffer_freeze_changed (buffer);
+
+  for (i = 0; i < tiles->len; i++)
+    {
+      ConstantTile *tile = &g_array_index (tiles, ConstantTile, i);
+
+      memcpy (key.pixel, tile->pixel, key.bpp);
+
+      buffer_set_constant (buffer, &tile->rect, &key);
+    }
+
+  gegl_buffer_thaw_changed (buffer);
+
+  g_array_free (tiles, TRUE);
+}
+
+/*  replaces the whole tiles of rect that are equal to the corresponding
+ *  tiles of orig_buffer, starting at (orig_x, orig_y), by shared
+ *  duplicates of the latter.  meant to follow operations that wrote to
+ *  all of rect while keeping orig_buffer as a copy of its previous
+ *  contents, such as an undo buffer, so that the tiles which didn't
+ *  actually change don't take storage twice.
+ */
+void
+gimp_gegl_buffer_share_unchanged_tiles (GeglBuffer          *buffer,
+                                        const GeglRectangle *rect,
+                                        GeglBuffer          *orig_buffer,
+                                        gint                 orig_x,
+                                        gint                 orig_y)
+{
+  GeglBufferIterator *iter;
+  const Babl         *format;
+  GeglRectangle       area;
+  GeglRectangle       orig_area;
+  GeglRectangle       orig_tiles;
+  GArray             *tiles;
+  gint                bpp;
+  gint                dx;
+  gint                dy;
+  gint                tile_width;
+  gint                tile_height;
+  gint                orig_tile_width;
+  gint                orig_tile_height;
+  guint               i;
+
+  g_return_if_fail (GEGL_IS_BUFFER (buffer));
+  g_return_if_fail (GEGL_IS_BUFFER (orig_buffer));
+
+  if (! rect)
+    rect = gegl_buffer_get_extent (buffer);
+
+  format = gegl_buffer_get_format (buffer);
+
+  if (gegl_buffer_get_format (orig_buffer) != format)
+    return;
+
+  g_object_get (buffer,
+                "tile-width",  &tile_width,
+                "tile-height", &tile_height,
+                NULL);
+  g_object_get (orig_buffer,
+                "tile-width",  &orig_tile_width,
+                "tile-height", &orig_tile_height,
+                NULL);
+
+  if (tile_width != orig_tile_width || tile_height != orig_tile_height)
+    return;
+
+  gegl_rectangle_align_to_buffer (&area, rect, buffer,
+                                  GEGL_RECTANGLE_ALIGNMENT_SUBSET);
+
+  if (gegl_rectangle_is_empty (&area))
+    return;
+
+  dx = orig_x - rect->x;
+  dy = orig_y - rect->y;
+
+  gegl_rectangle_set (&orig_area,
+                      area.x + dx, area.y + dy,
+                      area.width, area.height);
+
+  /*  tiles are only shared between aligned tile grids  */
+  gegl_rectangle_align_to_buffer (&orig_tiles, &orig_area, orig_buffer,
+                                  GEGL_RECTANGLE_ALIGNMENT_SUBSET);
+
+  if (! gegl_rectangle_equal (&orig_tiles, &orig_area))
+    return;
+
+  bpp   = babl_format_get_bytes_per_pixel (format);
+  tiles = g_array_new (FALSE, FALSE, sizeof (GeglRectangle));
+
+  iter = gegl_buffer_iterator_new (buffer, &area, 0, format,
+                                   GEGL_ACCESS_READ, GEGL_ABYSS_NONE, 2);
+
+  gegl_buffer_iterator_add (iter, orig_buffer, &orig_area, 0, format,
+                            GEGL_ACCESS_READ, GEGL_ABYSS_NONE);
+
+  while (gegl_buffer_iterator_next (iter))
+    {
+      if (! memcmp (iter->items[0].data, iter->items[1].data,
+                    iter->length * bpp))
+        {
+          g_array_append_val (tiles, iter->items[0].roi);
+        }
+    }
+
+  gegl_buffer_freeze_changed (buffer);
+
+  for (i = 0; i < tiles->len; i++)
+    {
+      const GeglRectangle *tile = &g_array_index (tiles, GeglRectangle, i);
+
+      gimp_gegl_buffer_copy (orig_buffer,
+                             GEGL_RECTANGLE (tile->x + dx, tile->y + dy,
+                                             tile->width, tile->height),
+                             GEGL_ABYSS_NONE,
+                             buffer,
+                             tile);
+    }
+
+  gegl_buffer_thaw_changed (buffer);
+
+  g_array_free (tiles, TRUE);
+}
+
+
+/*  private functions  */
+
+static guint
+constant_key_hash (gconstpointer key)
+{
+  const ConstantKey *k    = key;
+  guint              hash = g_direct_hash (k->format);
+  gint               i;
+
+  hash = hash * 31 + k->tile_width;
+  hash = hash * 31 + k->tile_height;
+
+  for (i = 0; i < k->bpp; i++)
+    hash = hash * 31 + k->pixel[i];
+
+  return hash;
+}
+
+static gboolean
+constant_key_equal (gconstpointer key1,
+                    gconstpointer key2)
+{
+  const ConstantKey *k1 = key1;
+  const ConstantKey *k2 = key2;
+
+  return k1->format      == k2->format      &&
+         k1->tile_width  == k2->tile_width  &&
+         k1->tile_height == k2->tile_height &&
+         ! memcmp (k1->pixel, k2->pixel, k1->bpp);
+}
+
+static void
+constant_key_free (gpointer key)
+{
+  g_slice_free (ConstantKey, key);
+}
+
+static gboolean
+constant_key_init (ConstantKey *key,
+                   GeglBuffer  *buffer)
+{
+  memset (key, 0, sizeof (ConstantKey));
+
+  key->format = gegl_buffer_get_format (buffer);
+  key->bpp    = babl_format_get_bytes_per_pixel (key->format);
+
+  if (key->bpp > MAX_BPP)
+    return FALSE;
+
+  g_object_get (buffer,
+                "tile-width",  &key->tile_width,
+                "tile-height", &key->tile_height,
+                NULL);
+
+  return TRUE;
+}
+
+static GeglBuffer *
+constant_source_get (const ConstantKey *key)
+{
+  GeglBuffer *source;
+
+  g_mutex_lock (&constant_mutex);
+
+  if (! constant_sources)
+    {
+      constant_sources = g_hash_table_new_full (constant_key_hash,
+                                                constant_key_equal,
+                                                constant_key_free,
+                                                g_object_unref);
+    }
+
+  source = g_hash_table_lookup (constant_sources, key);
+
+  if (! source)
+    {
+      /*  buffers holding the dropped tiles keep them alive  */
+      if (g_hash_table_size (constant_sources) >= MAX_CONSTANT_SOURCES)
+        g_hash_table_remove_all (constant_sources);
+
+      source = g_object_new (GEGL_TYPE_BUFFER,
+                             "format",      key->format,
+                             "x",           0,
+                             "y",           0,
+                             "width",       SOURCE_TILES * key->tile_width,
+                             "height",      key->tile_height,
+                             "tile-width",  key->tile_width,
+                             "tile-height", key->tile_height,
+                             NULL);
+
+      gegl_buffer_set_color_from_pixel (source, NULL, key->pixel, key->format);
+
+      g_hash_table_insert (constant_sources,
+                           g_slice_dup (ConstantKey, key), source);
+    }
+
+  g_object_ref (source);
+
+  g_mutex_unlock (&constant_mutex);
+
+  return source;
+}
+
+static void
+buffer_set_constant (GeglBuffer          *buffer,
+                     const GeglRectangle *rect,
+                     const ConstantKey   *key)
+{
+  GeglBuffer    *source;
+  GeglRectangle  area;
+  GeglRectangle  edges[4];
+  gint           i;
+  gint           x;
+  gint           y;
+
+  for (i = 0; i < key->bpp; i++)
+    {
+      if (key->pixel[i])
+        break;
+    }
+
+  if (i == key->bpp)
+    {
+      gegl_buffer_clear (buffer, rect);
+
+      return;
+    }
+
+  gegl_rectangle_align_to_buffer (&area, rect, buffer,
+                                  GEGL_RECTANGLE_ALIGNMENT_SUBSET);
+
+  if (gegl_rectangle_is_empty (&area))
+    {
+      gegl_buffer_set_color_from_pixel (buffer, rect, key->pixel, key->format);
+
+      return;
+    }
+
+  gegl_buffer_freeze_changed (buffer);
+
+  /*  the partial tiles along the edges  */
+  gegl_rectangle_set (&edges[0],
+                      rect->x, rect->y,
+                      rect->width, area.y - rect->y);
+  gegl_rectangle_set (&edges[1],
+                      rect->x, area.y + area.height,
+                      rect->width,
+                      rect->y + rect->height - (area.y + area.height));
+  gegl_rectangle_set (&edges[2],
+                      rect->x, area.y,
+                      area.x - rect->x, area.height);
+  gegl_rectangle_set (&edges[3],
+                      area.x + area.width, area.y,
+                      rect->x + rect->width - (area.x + area.width),
+                      area.height);
+
+  for (i = 0; i < G_N_ELEMENTS (edges); i++)
+    {
+      if (! gegl_rectangle_is_empty (&edges[i]))
+        {
+          gegl_buffer_set_color_from_pixel (buffer, &edges[i],
+                                            key->pixel, key->format);
+        }
+    }
+
+  /*  the whole tiles  */
+  source = constant_source_get (key);
+
+  for (y = area.y; y < area.y + area.height; y += key->tile_height)
+    {
+      for (x = area.x;
+           x < area.x + area.width;
+           x += SOURCE_TILES * key->tile_width)
+        {
+          gint width = MIN (SOURCE_TILES * key->tile_width,
+                            area.x + area.width - x);
+
+          gegl_buffer_copy (source,
+                            GEGL_RECTANGLE (0, 0, width, key->tile_height),
+                            GEGL_ABYSS_NONE,
+                            buffer,
+                            GEGL_RECTANGLE (x, y, width, key->tile_height));
+        }
+    }
+
+  g_object_unref (source);
+
+  gegl_buffer_thaw_changed (buffer);
+}
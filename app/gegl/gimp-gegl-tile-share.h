@@ -0,0 +1,44 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimp-gegl-tile-share.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GIMP_GEGL_TILE_SHARE_H__
+#define __GIMP_GEGL_TILE_SHARE_H__
+
+
+void   gimp_gegl_tile_share_exit             (void);
+
+void   gimp_gegl_buffer_set_constant         (GeglBuffer          *buffer,
+                                              const GeglRectangle *rect,
+                                              gconstpointer        pixel,
+                                              const Babl          *pixel_format);
+void   gimp_gegl_buffer_set_constant_color   (GeglBuffer          *buffer,
+                                              const GeglRectangle *rect,
+                                              GeglColor           *color);
+
+void   gimp_gegl_buffer_share_constant_tiles (GeglBuffer          *buffer,
+                                              const GeglRectangle *rect);
+void   gimp_gegl_buffer_share_unchanged_tiles
+                                             (GeglBuffer          *buffer,
+                                              const GeglRectangle *rect,
+                                              GeglBuffer          *orig_buffer,
+                                              gint                 orig_x,
+                                              gint                 orig_y);
+
+
+#endif /* __GIMP_GEGL_TILE_SHARE_H__ */
@@ -307,6 +307,45 @@ gimp_gegl_buffer_dup (GeglBuffer *buffer)
   return new_buffer;
 }
 
+/*  returns a new buffer of rect's size, with its origin at (0, 0), whose
+ *  tile grid is aligned with the part of buffer covered by rect, so that
+ *  copying rect of buffer to it can share the tiles copy-on-write, as long
+ *  as format matches buffer's format.
+ */
+GeglBuffer *
+gimp_gegl_buffer_new_aligned (GeglBuffer          *buffer,
+                              const GeglRectangle *rect,
+                              const Babl          *format)
+{
+  gint shift_x;
+  gint shift_y;
+  gint tile_width;
+  gint tile_height;
+
+  g_return_val_if_fail (GEGL_IS_BUFFER (buffer), NULL);
+  g_return_val_if_fail (rect != NULL, NULL);
+  g_return_val_if_fail (format != NULL, NULL);
+
+  g_object_get (buffer,
+                "shift-x",     &shift_x,
+                "shift-y",     &shift_y,
+                "tile-width",  &tile_width,
+                "tile-height", &tile_height,
+                NULL);
+
+  return g_object_new (GEGL_TYPE_BUFFER,
+                       "format",      format,
+                       "x",           0,
+                       "y",           0,
+                       "width",       rect->width,
+                       "height",      rect->height,
+                       "shift-x",     shift_x + rect->x,
+                       "shift-y",     shift_y + rect->y,
+                       "tile-width",  tile_width,
+                       "tile-height", tile_height,
+                       NULL);
+}
+
 gboolean
 gimp_gegl_buffer_set_extent (GeglBuffer          *buffer,
                              const GeglRectangle *extent)
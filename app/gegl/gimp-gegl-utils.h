@@ -53,6 +53,9 @@ gboolean      gimp_gegl_param_spec_has_key            (GParamSpec          *pspe
                                                        const gchar         *value);
 
 GeglBuffer  * gimp_gegl_buffer_dup                    (GeglBuffer          *buffer);
+GeglBuffer  * gimp_gegl_buffer_new_aligned            (GeglBuffer          *buffer,
+                                                       const GeglRectangle *rect,
+                                                       const Babl          *format);
 
 gboolean      gimp_gegl_buffer_set_extent             (GeglBuffer          *buffer,
                                                        const GeglRectangle *extent);
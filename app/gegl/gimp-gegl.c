@@ -21,8 +21,11 @@
 #include "config.h"
 
 #include <gio/gio.h>
+#include <cairo.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
 #include <gegl.h>
 
+#include "libgimpcolor/gimpcolor.h"
 #include "libgimpconfig/gimpconfig.h"
 
 #include "gimp-gegl-types.h"
@@ -36,6 +39,8 @@
 
 #include "gimp-babl.h"
 #include "gimp-gegl.h"
+#include "gimp-gegl-color-transform.h"
+#include "gimp-gegl-tile-share.h"
 
 #include <operation/gegl-operation.h>
 
@@ -106,6 +111,9 @@ gimp_gegl_exit (Gimp *gimp)
 
   gimp_operations_exit (gimp);
   gimp_parallel_exit (gimp);
+
+  gimp_gegl_tile_share_exit ();
+  gimp_gegl_color_transform_exit ();
 }
 
 
@@ -39,11 +39,19 @@ static void   gimp_applicator_get_property (GObject      *object,
                                             GParamSpec   *pspec);
 
 
+static gint64 gimp_applicator_reconfigure_begin (void);
+static void   gimp_applicator_reconfigure_end   (gint64        start);
+
+
 G_DEFINE_TYPE (GimpApplicator, gimp_applicator, G_TYPE_OBJECT)
 
 #define parent_class gimp_applicator_parent_class
 
 
+static GMutex gimp_applicator_reconfigure_mutex;
+static gint64 gimp_applicator_reconfigure_time = 0;
+
+
 static void
 gimp_applicator_class_init (GimpApplicatorClass *klass)
 {
@@ -211,12 +219,16 @@ gimp_applicator_set_active (GimpApplicator *applicator,
 
   if (active != applicator->active)
     {
+      gint64 start = gimp_applicator_reconfigure_begin ();
+
       applicator->active = active;
 
       if (active)
         gegl_node_link (applicator->crop_node, applicator->output_node);
       else
         gegl_node_link (applicator->input_node, applicator->output_node);
+
+      gimp_applicator_reconfigure_end (start);
     }
 }
 
@@ -224,12 +236,16 @@ void
 gimp_applicator_set_src_buffer (GimpApplicator *applicator,
                                 GeglBuffer     *src_buffer)
 {
+  gint64 start;
+
   g_return_if_fail (GIMP_IS_APPLICATOR (applicator));
   g_return_if_fail (src_buffer == NULL || GEGL_IS_BUFFER (src_buffer));
 
   if (src_buffer == applicator->src_buffer)
     return;
 
+  start = gimp_applicator_reconfigure_begin ();
+
   if (src_buffer)
     {
       if (! applicator->src_node)
@@ -260,18 +276,24 @@ gimp_applicator_set_src_buffer (GimpApplicator *applicator,
     }
 
   applicator->src_buffer = src_buffer;
+
+  gimp_applicator_reconfigure_end (start);
 }
 
 void
 gimp_applicator_set_dest_buffer (GimpApplicator *applicator,
                                  GeglBuffer     *dest_buffer)
 {
+  gint64 start;
+
   g_return_if_fail (GIMP_IS_APPLICATOR (applicator));
   g_return_if_fail (dest_buffer == NULL || GEGL_IS_BUFFER (dest_buffer));
 
   if (dest_buffer == applicator->dest_buffer)
     return;
 
+  start = gimp_applicator_reconfigure_begin ();
+
   if (dest_buffer)
     {
       if (! applicator->dest_node)
@@ -302,18 +324,24 @@ gimp_applicator_set_dest_buffer (GimpApplicator *applicator,
     }
 
   applicator->dest_buffer = dest_buffer;
+
+  gimp_applicator_reconfigure_end (start);
 }
 
 void
 gimp_applicator_set_mask_buffer (GimpApplicator *applicator,
                                  GeglBuffer     *mask_buffer)
 {
+  gint64 start;
+
   g_return_if_fail (GIMP_IS_APPLICATOR (applicator));
   g_return_if_fail (mask_buffer == NULL || GEGL_IS_BUFFER (mask_buffer));
 
   if (applicator->mask_buffer == mask_buffer)
     return;
 
+  start = gimp_applicator_reconfigure_begin ();
+
   gegl_node_set (applicator->mask_node,
                  "buffer", mask_buffer,
                  NULL);
@@ -329,6 +357,8 @@ gimp_applicator_set_mask_buffer (GimpApplicator *applicator,
     }
 
   applicator->mask_buffer = mask_buffer;
+
+  gimp_applicator_reconfigure_end (start);
 }
 
 void
@@ -341,6 +371,8 @@ gimp_applicator_set_mask_offset (GimpApplicator *applicator,
   if (applicator->mask_offset_x != mask_offset_x ||
       applicator->mask_offset_y != mask_offset_y)
     {
+      gint64 start = gimp_applicator_reconfigure_begin ();
+
       applicator->mask_offset_x = mask_offset_x;
       applicator->mask_offset_y = mask_offset_y;
 
@@ -348,6 +380,8 @@ gimp_applicator_set_mask_offset (GimpApplicator *applicator,
                      "x", (gdouble) mask_offset_x,
                      "y", (gdouble) mask_offset_y,
                      NULL);
+
+      gimp_applicator_reconfigure_end (start);
     }
 }
 
@@ -355,12 +389,16 @@ void
 gimp_applicator_set_apply_buffer (GimpApplicator *applicator,
                                   GeglBuffer     *apply_buffer)
 {
+  gint64 start;
+
   g_return_if_fail (GIMP_IS_APPLICATOR (applicator));
   g_return_if_fail (apply_buffer == NULL || GEGL_IS_BUFFER (apply_buffer));
 
   if (apply_buffer == applicator->apply_buffer)
     return;
 
+  start = gimp_applicator_reconfigure_begin ();
+
   if (apply_buffer)
     {
       if (! applicator->apply_src_node)
@@ -391,6 +429,8 @@ gimp_applicator_set_apply_buffer (GimpApplicator *applicator,
     }
 
   applicator->apply_buffer = apply_buffer;
+
+  gimp_applicator_reconfigure_end (start);
 }
 
 void
@@ -403,6 +443,8 @@ gimp_applicator_set_apply_offset (GimpApplicator *applicator,
   if (applicator->apply_offset_x != apply_offset_x ||
       applicator->apply_offset_y != apply_offset_y)
     {
+      gint64 start = gimp_applicator_reconfigure_begin ();
+
       applicator->apply_offset_x = apply_offset_x;
       applicator->apply_offset_y = apply_offset_y;
 
@@ -410,6 +452,8 @@ gimp_applicator_set_apply_offset (GimpApplicator *applicator,
                      "x", (gdouble) apply_offset_x,
                      "y", (gdouble) apply_offset_y,
                      NULL);
+
+      gimp_applicator_reconfigure_end (start);
     }
 }
 
@@ -421,10 +465,14 @@ gimp_applicator_set_opacity (GimpApplicator *applicator,
 
   if (applicator->opacity != opacity)
     {
+      gint64 start = gimp_applicator_reconfigure_begin ();
+
       applicator->opacity = opacity;
 
       gimp_gegl_mode_node_set_opacity (applicator->mode_node,
                                        opacity);
+
+      gimp_applicator_reconfigure_end (start);
     }
 }
 
@@ -442,6 +490,8 @@ gimp_applicator_set_mode (GimpApplicator         *applicator,
       applicator->composite_space != composite_space ||
       applicator->composite_mode  != composite_mode)
     {
+      gint64 start = gimp_applicator_reconfigure_begin ();
+
       applicator->paint_mode      = paint_mode;
       applicator->blend_space     = blend_space;
       applicator->composite_space = composite_space;
@@ -450,6 +500,8 @@ gimp_applicator_set_mode (GimpApplicator         *applicator,
       gimp_gegl_mode_node_set_mode (applicator->mode_node,
                                     paint_mode, blend_space,
                                     composite_space, composite_mode);
+
+      gimp_applicator_reconfigure_end (start);
     }
 }
 
@@ -461,11 +513,15 @@ gimp_applicator_set_affect (GimpApplicator    *applicator,
 
   if (applicator->affect != affect)
     {
+      gint64 start = gimp_applicator_reconfigure_begin ();
+
       applicator->affect = affect;
 
       gegl_node_set (applicator->affect_node,
                      "mask", affect,
                      NULL);
+
+      gimp_applicator_reconfigure_end (start);
     }
 }
 
@@ -477,6 +533,8 @@ gimp_applicator_set_output_format (GimpApplicator *applicator,
 
   if (applicator->output_format != format)
     {
+      gint64 start = gimp_applicator_reconfigure_begin ();
+
       if (format)
         {
           if (! applicator->output_format)
@@ -501,6 +559,8 @@ gimp_applicator_set_output_format (GimpApplicator *applicator,
         }
 
       applicator->output_format = format;
+
+      gimp_applicator_reconfigure_end (start);
     }
 }
 
@@ -520,6 +580,8 @@ gimp_applicator_set_cache (GimpApplicator *applicator,
 
   if (applicator->cache_enabled != enable)
     {
+      gint64 start = gimp_applicator_reconfigure_begin ();
+
       if (enable)
         {
           gegl_node_set (applicator->cache_node,
@@ -534,6 +596,8 @@ gimp_applicator_set_cache (GimpApplicator *applicator,
         }
 
       applicator->cache_enabled = enable;
+
+      gimp_applicator_reconfigure_end (start);
     }
 }
 
@@ -590,6 +654,8 @@ gimp_applicator_set_crop (GimpApplicator      *applicator,
   if (applicator->crop_enabled != (rect != NULL) ||
       (rect && ! gegl_rectangle_equal (&applicator->crop_rect, rect)))
     {
+      gint64 start = gimp_applicator_reconfigure_begin ();
+
       if (rect)
         {
           if (! applicator->crop_enabled)
@@ -627,6 +693,8 @@ gimp_applicator_set_crop (GimpApplicator      *applicator,
 
           applicator->crop_enabled = FALSE;
         }
+
+      gimp_applicator_reconfigure_end (start);
     }
 }
 
@@ -650,3 +718,42 @@ gimp_applicator_blit (GimpApplicator      *applicator,
   gegl_node_blit (applicator->dest_node, 1.0, rect,
                   NULL, NULL, 0, GEGL_BLIT_DEFAULT);
 }
+
+gdouble
+gimp_applicator_get_reconfigure_time (void)
+{
+  gint64 reconfigure_time;
+
+  g_mutex_lock (&gimp_applicator_reconfigure_mutex);
+
+  reconfigure_time = gimp_applicator_reconfigure_time;
+
+  g_mutex_unlock (&gimp_applicator_reconfigure_mutex);
+
+  return reconfigure_time / (gdouble) G_TIME_SPAN_SECOND;
+}
+
+
+/*  private functions  */
+
+/*  the setters only touch the graph when their parameters actually
+ *  change, and keep the nodes they create for later reuse.  the time they
+ *  do spend reconfiguring the graph is accumulated for the dashboard.
+ */
+static gint64
+gimp_applicator_reconfigure_begin (void)
+{
+  return g_get_monotonic_time ();
+}
+
+static void
+gimp_applicator_reconfigure_end (gint64 start)
+{
+  gint64 elapsed = g_get_monotonic_time () - start;
+
+  g_mutex_lock (&gimp_applicator_reconfigure_mutex);
+
+  gimp_applicator_reconfigure_time += elapsed;
+
+  g_mutex_unlock (&gimp_applicator_reconfigure_mutex);
+}
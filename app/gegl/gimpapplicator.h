@@ -142,5 +142,7 @@ const GeglRectangle * gimp_applicator_get_crop (GimpApplicator       *applicator
 void         gimp_applicator_blit              (GimpApplicator       *applicator,
                                                 const GeglRectangle  *rect);
 
+gdouble      gimp_applicator_get_reconfigure_time (void);
+
 
 #endif  /*  __GIMP_APPLICATOR_H__  */
@@ -25,6 +25,7 @@
 
 #include "gimp-gegl-types.h"
 
+#include "core/gimp-parallel.h"
 #include "core/gimpchunkiterator.h"
 
 #include "gimp-gegl-loops.h"
@@ -32,6 +33,12 @@
 #include "gimptilehandlervalidate.h"
 
 
+/* the minimal size of the blocks validated by each thread in
+ * gimp_tile_handler_validate_validate_parallel()
+ */
+#define PARALLEL_BLOCK_SIZE 256
+
+
 enum
 {
   INVALIDATED,
@@ -48,6 +55,22 @@ enum
 };
 
 
+typedef struct
+{
+  GimpTileHandlerValidate *validate;
+  GeglBuffer              *buffer;
+  GeglRectangle            rect;
+  cairo_region_t          *region;
+  gint                     block_width;
+  gint                     block_height;
+  gint                     block_x;
+  gint                     block_y;
+  gint                     n_blocks_x;
+  gint                     n_blocks;
+  gint                     next_block;
+} ValidateParallelData;
+
+
 static void     gimp_tile_handler_validate_finalize             (GObject         *object);
 static void     gimp_tile_handler_validate_set_property         (GObject         *object,
                                                                  guint            property_id,
@@ -76,6 +99,11 @@ static gpointer gimp_tile_handler_validate_command              (GeglTileSource
                                                                  gint             z,
                                                                  gpointer         data);
 
+static void     gimp_tile_handler_validate_validate_parallel_func
+                                                                (gint                     i,
+                                                                 gint                     n,
+                                                                 ValidateParallelData    *data);
+
 
 G_DEFINE_TYPE (GimpTileHandlerValidate, gimp_tile_handler_validate,
                GEGL_TYPE_TILE_HANDLER)
@@ -84,6 +112,12 @@ G_DEFINE_TYPE (GimpTileHandlerValidate, gimp_tile_handler_validate,
 
 static guint gimp_tile_handler_validate_signals[LAST_SIGNAL];
 
+/*  tiles validated on demand are validated while their buffer's tile
+ *  storage is locked, blocking all other threads reading the buffer
+ */
+static GMutex gimp_tile_handler_validate_on_demand_mutex;
+static gint64 gimp_tile_handler_validate_on_demand_time = 0;
+
 
 static void
 gimp_tile_handler_validate_class_init (GimpTileHandlerValidateClass *klass)
@@ -280,6 +314,7 @@ gimp_tile_handler_validate_validate_tile (GeglTileSource *source,
   GeglTile                *tile;
   cairo_rectangle_int_t    tile_rect;
   cairo_region_overlap_t   overlap;
+  gint64                   start_time;
 
   if (validate->suspend_validate ||
       cairo_region_is_empty (validate->dirty_region))
@@ -302,6 +337,8 @@ gimp_tile_handler_validate_validate_tile (GeglTileSource *source,
                                                GEGL_TILE_GET, x, y, 0, NULL);
     }
 
+  start_time = g_get_monotonic_time ();
+
   if (overlap == CAIRO_REGION_OVERLAP_IN || validate->whole_tile)
     {
       gint tile_bpp;
@@ -405,6 +442,13 @@ gimp_tile_handler_validate_validate_tile (GeglTileSource *source,
       cairo_region_destroy (tile_region);
     }
 
+  g_mutex_lock (&gimp_tile_handler_validate_on_demand_mutex);
+
+  gimp_tile_handler_validate_on_demand_time += g_get_monotonic_time () -
+                                               start_time;
+
+  g_mutex_unlock (&gimp_tile_handler_validate_on_demand_mutex);
+
   return tile;
 }
 
@@ -423,6 +467,74 @@ gimp_tile_handler_validate_command (GeglTileSource  *source,
 }
 
 
+static void
+gimp_tile_handler_validate_validate_parallel_func (gint                  i,
+                                                   gint                  n,
+                                                   ValidateParallelData *data)
+{
+  GimpTileHandlerValidateClass *klass;
+  gint                          block;
+
+  klass = GIMP_TILE_HANDLER_VALIDATE_GET_CLASS (data->validate);
+
+  while ((block = g_atomic_int_add (&data->next_block, 1)) < data->n_blocks)
+    {
+      GeglRectangle block_rect;
+
+      block_rect.x      = (data->block_x + block % data->n_blocks_x) *
+                          data->block_width;
+      block_rect.y      = (data->block_y + block / data->n_blocks_x) *
+                          data->block_height;
+      block_rect.width  = data->block_width;
+      block_rect.height = data->block_height;
+
+      if (! gegl_rectangle_intersect (&block_rect, &block_rect, &data->rect))
+        continue;
+
+      if (data->region)
+        {
+          cairo_region_overlap_t overlap;
+
+          overlap = cairo_region_contains_rectangle (
+            data->region, (const cairo_rectangle_int_t *) &block_rect);
+
+          if (overlap == CAIRO_REGION_OVERLAP_OUT)
+            continue;
+
+          if (overlap == CAIRO_REGION_OVERLAP_PART)
+            {
+              cairo_region_t *block_region;
+              gint            n_rects;
+              gint            j;
+
+              block_region = cairo_region_copy (data->region);
+              cairo_region_intersect_rectangle (
+                block_region, (const cairo_rectangle_int_t *) &block_rect);
+
+              n_rects = cairo_region_num_rectangles (block_region);
+
+              for (j = 0; j < n_rects; j++)
+                {
+                  cairo_rectangle_int_t blit_rect;
+
+                  cairo_region_get_rectangle (block_region, j, &blit_rect);
+
+                  klass->validate_buffer (data->validate,
+                                          (const GeglRectangle *) &blit_rect,
+                                          data->buffer);
+                }
+
+              cairo_region_destroy (block_region);
+
+              continue;
+            }
+        }
+
+      klass->validate_buffer (data->validate, &block_rect, data->buffer);
+    }
+}
+
+
 /*  public functions  */
 
 GeglTileHandler *
@@ -623,6 +735,100 @@ gimp_tile_handler_validate_validate (GimpTileHandlerValidate *validate,
     }
 }
 
+/* like gimp_tile_handler_validate_validate(), but splits 'rect' into
+ * tile-aligned blocks, which are validated in parallel.  the blocks are
+ * claimed dynamically by the participating threads, so that cheap and
+ * expensive areas are balanced between them.
+ *
+ * this may only be used with handlers whose validate_buffer() can run
+ * concurrently on disjoint areas, such as ones decoding tiles from a
+ * file.  it must not be used with handlers rendering a graph: gegl
+ * already parallelizes each blit internally, and a graph mustn't be
+ * evaluated, or reconfigured, by several threads at once.  the dirty
+ * region, and the begin/end-validate count, are only accessed by the
+ * calling thread, before and after the blocks are validated.
+ *
+ * if 'intersect' is TRUE, only the invalid parts of 'rect' are validated,
+ * and blocks without any are skipped.
+ */
+void
+gimp_tile_handler_validate_validate_parallel (GimpTileHandlerValidate *validate,
+                                              GeglBuffer              *buffer,
+                                              const GeglRectangle     *rect,
+                                              gboolean                 intersect)
+{
+  ValidateParallelData data;
+  gint                 block_x1, block_y1;
+  gint                 block_x2, block_y2;
+
+  g_return_if_fail (GIMP_IS_TILE_HANDLER_VALIDATE (validate));
+  g_return_if_fail (gimp_tile_handler_validate_get_assigned (buffer) ==
+                    validate);
+
+  if (! rect)
+    rect = gegl_buffer_get_extent (buffer);
+
+  if (gegl_rectangle_is_empty (rect))
+    return;
+
+  data.region = NULL;
+
+  if (intersect)
+    {
+      data.region = cairo_region_copy (validate->dirty_region);
+
+      cairo_region_intersect_rectangle (data.region,
+                                        (const cairo_rectangle_int_t *) rect);
+
+      if (cairo_region_is_empty (data.region))
+        {
+          cairo_region_destroy (data.region);
+
+          return;
+        }
+    }
+
+  data.validate     = validate;
+  data.buffer       = buffer;
+  data.rect         = *rect;
+  data.block_width  = validate->tile_width *
+                      MAX (1, PARALLEL_BLOCK_SIZE / validate->tile_width);
+  data.block_height = validate->tile_height *
+                      MAX (1, PARALLEL_BLOCK_SIZE / validate->tile_height);
+
+  block_x1 = floor ((gdouble) rect->x / data.block_width);
+  block_y1 = floor ((gdouble) rect->y / data.block_height);
+  block_x2 = ceil  ((gdouble) (rect->x + rect->width)  / data.block_width);
+  block_y2 = ceil  ((gdouble) (rect->y + rect->height) / data.block_height);
+
+  data.block_x    = block_x1;
+  data.block_y    = block_y1;
+  data.n_blocks_x = block_x2 - block_x1;
+  data.n_blocks   = data.n_blocks_x * (block_y2 - block_y1);
+  data.next_block = 0;
+
+  gimp_tile_handler_validate_begin_validate (validate);
+
+  if (data.n_blocks > 1)
+    {
+      gimp_parallel_distribute (
+        data.n_blocks,
+        (GeglParallelDistributeFunc) gimp_tile_handler_validate_validate_parallel_func,
+        &data);
+    }
+  else
+    {
+      gimp_tile_handler_validate_validate_parallel_func (0, 1, &data);
+    }
+
+  gimp_tile_handler_validate_end_validate (validate);
+
+  cairo_region_subtract_rectangle (validate->dirty_region,
+                                   (const cairo_rectangle_int_t *) rect);
+
+  g_clear_pointer (&data.region, cairo_region_destroy);
+}
+
 gboolean
 gimp_tile_handler_validate_buffer_set_extent (GeglBuffer          *buffer,
                                               const GeglRectangle *extent)
@@ -766,3 +972,20 @@ gimp_tile_handler_validate_buffer_copy (GeglBuffer          *src_buffer,
         }
     }
 }
+
+/*  the total time spent validating tiles on demand, that is, while
+ *  holding their buffer's tile storage lock
+ */
+gdouble
+gimp_tile_handler_validate_get_on_demand_time (void)
+{
+  gint64 on_demand_time;
+
+  g_mutex_lock (&gimp_tile_handler_validate_on_demand_mutex);
+
+  on_demand_time = gimp_tile_handler_validate_on_demand_time;
+
+  g_mutex_unlock (&gimp_tile_handler_validate_on_demand_mutex);
+
+  return on_demand_time / (gdouble) G_TIME_SPAN_SECOND;
+}
@@ -97,6 +97,10 @@ void                      gimp_tile_handler_validate_validate          (GimpTile
                                                                         const GeglRectangle     *rect,
                                                                         gboolean                 intersect,
                                                                         gboolean                 chunked);
+void                      gimp_tile_handler_validate_validate_parallel (GimpTileHandlerValidate *validate,
+                                                                        GeglBuffer              *buffer,
+                                                                        const GeglRectangle     *rect,
+                                                                        gboolean                 intersect);
 
 gboolean                  gimp_tile_handler_validate_buffer_set_extent (GeglBuffer              *buffer,
                                                                         const GeglRectangle     *extent);
@@ -106,6 +110,8 @@ void                      gimp_tile_handler_validate_buffer_copy       (GeglBuff
                                                                         GeglBuffer              *dst_buffer,
                                                                         const GeglRectangle     *dst_rect);
 
+gdouble                   gimp_tile_handler_validate_get_on_demand_time (void);
+
 
 G_END_DECLS
 
@@ -31,6 +31,7 @@
 #include "config/gimpguiconfig.h"
 
 #include "core/gimp.h"
+#include "core/gimp-trace.h"
 #include "core/gimpcontainer.h"
 #include "core/gimpcontext.h"
 #include "core/gimpimage.h"
@@ -515,11 +516,13 @@ gui_restore_callback (Gimp               *gimp,
                     NULL);
     }
 
+  gimp_trace_begin ("startup", "actions-menus-dialogs");
   actions_init (gimp);
   menus_init (gimp, global_action_factory);
   gimp_render_init (gimp);
 
   dialogs_init (gimp, global_menu_factory);
+  gimp_trace_end ();
 
   gimp_clipboard_init (gimp);
   if (gimp_get_clipboard_image (gimp))
@@ -602,10 +605,12 @@ gui_restore_after_callback (Gimp               *gimp,
                                 "gimp", gimp,
                                 NULL);
 
+  gimp_trace_begin ("startup", "image-ui-manager");
   image_ui_manager = gimp_menu_factory_manager_new (global_menu_factory,
                                                     "<Image>",
                                                     gimp);
   gimp_ui_manager_update (image_ui_manager, gimp);
+  gimp_trace_end ();
 
   /* Check that every accelerator is unique. */
   gtk_accel_map_foreach_unfiltered (NULL,
@@ -642,7 +647,11 @@ gui_restore_after_callback (Gimp               *gimp,
       shell = gimp_display_get_shell (display);
 
       if (gui_config->restore_session)
-        session_restore (gimp, initial_monitor);
+        {
+          gimp_trace_begin ("startup", "session-restore");
+          session_restore (gimp, initial_monitor);
+          gimp_trace_end ();
+        }
 
       toplevel = gtk_widget_get_toplevel (GTK_WIDGET (shell));
 
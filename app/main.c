@@ -126,6 +126,7 @@ static void      gimp_open_console_window     (void);
 static const gchar        *system_gimprc     = NULL;
 static const gchar        *user_gimprc       = NULL;
 static const gchar        *session_name      = NULL;
+static const gchar        *profile_startup   = NULL;
 static const gchar        *batch_interpreter = NULL;
 static const gchar       **batch_commands    = NULL;
 static const gchar       **filenames         = NULL;
@@ -287,6 +288,11 @@ static const GOptionEntry main_entries[] =
     G_OPTION_ARG_CALLBACK, gimp_option_dump_pdb_procedures_deprecated,
     N_("Output a sorted list of deprecated procedures in the PDB"), NULL
   },
+  {
+    "profile-startup", 0, 0,
+    G_OPTION_ARG_FILENAME, &profile_startup,
+    N_("Write a trace of the startup steps to <filename>"), "<filename>"
+  },
   {
     "show-playground", 0, 0,
     G_OPTION_ARG_NONE, &show_playground,
@@ -506,6 +512,7 @@ main (int    argc,
   gchar          *basename;
   GFile          *system_gimprc_file = NULL;
   GFile          *user_gimprc_file   = NULL;
+  GFile          *profile_file       = NULL;
   GOptionGroup   *gimp_group         = NULL;
   gchar          *backtrace_file     = NULL;
   gint            i;
@@ -756,6 +763,9 @@ main (int    argc,
   if (user_gimprc)
     user_gimprc_file = g_file_new_for_commandline_arg (user_gimprc);
 
+  if (profile_startup)
+    profile_file = g_file_new_for_commandline_arg (profile_startup);
+
   app_run (argv[0],
            filenames,
            system_gimprc_file,
@@ -777,7 +787,8 @@ main (int    argc,
            show_debug_menu,
            stack_trace_mode,
            pdb_compat_mode,
-           backtrace_file);
+           backtrace_file,
+           profile_file);
 
   if (backtrace_file)
     g_free (backtrace_file);
@@ -788,6 +799,9 @@ main (int    argc,
   if (user_gimprc_file)
     g_object_unref (user_gimprc_file);
 
+  if (profile_file)
+    g_object_unref (profile_file);
+
   g_strfreev (argv);
 
   g_option_context_free (context);
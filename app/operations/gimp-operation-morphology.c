@@ -0,0 +1,561 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimp-operation-morphology.c
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <gegl.h>
+
+#include "libgimpmath/gimpmath.h"
+
+#include "operations-types.h"
+
+#include "gimp-operation-morphology.h"
+
+
+/*  the grow, shrink and border operations look for selected (or, for
+ *  shrink, unselected) pixels within an elliptic neighborhood.  instead of
+ *  scanning the neighborhood of each pixel, which costs time in proportion
+ *  to the radius, we keep track of the vertical distance to the nearest
+ *  such pixel in each column, updated in constant amortized time per row,
+ *  and derive each output row from those distances alone.
+ *
+ *  grayscale masks are decomposed into the nested "at least this
+ *  selected" sets of their distinct values, each of which is binary, and
+ *  each of which costs a pass.
+ */
+
+
+#define UNKNOWN    G_MAXUINT16
+#define MAX_LEVELS 256
+
+
+struct _GimpMorphologyColumns
+{
+  gint     width;
+  gint     radius;
+  gint     n_levels;
+
+  guint16 *above;
+  guint16 *below;
+  guint16 *distances;
+};
+
+
+/*  local function prototypes  */
+
+static gboolean   gimp_operation_morphology_collect_levels (GeglBuffer          *input,
+                                                            const GeglRectangle *roi,
+                                                            const Babl          *format,
+                                                            gboolean             erode,
+                                                            gint                 max_levels,
+                                                            GHashTable          *ranks);
+static gint       gimp_operation_morphology_compare_levels (gconstpointer        a,
+                                                            gconstpointer        b);
+static void       gimp_operation_morphology_load_row       (GeglBuffer          *input,
+                                                            const GeglRectangle *roi,
+                                                            const Babl          *format,
+                                                            gint                 y,
+                                                            GHashTable          *ranks,
+                                                            gint                 outside_rank,
+                                                            gfloat              *line,
+                                                            guint16             *row);
+
+
+/*  public functions  */
+
+GimpMorphologyColumns *
+gimp_morphology_columns_new (gint width,
+                             gint radius,
+                             gint n_levels,
+                             gint outside_rank)
+{
+  GimpMorphologyColumns *columns;
+  gint                   l;
+
+  g_return_val_if_fail (width > 0, NULL);
+  g_return_val_if_fail (radius > 0 && radius < UNKNOWN - 1, NULL);
+  g_return_val_if_fail (n_levels > 0, NULL);
+
+  columns = g_slice_new (GimpMorphologyColumns);
+
+  columns->width     = width;
+  columns->radius    = radius;
+  columns->n_levels  = n_levels;
+
+  columns->above     = g_new (guint16, n_levels * width);
+  columns->below     = g_new (guint16, n_levels * width);
+  columns->distances = g_new (guint16, n_levels * width);
+
+  /*  the state before the first row, where the row above is outside  */
+  for (l = 1; l <= n_levels; l++)
+    {
+      guint16 *above = columns->above + (l - 1) * width;
+      guint16 *below = columns->below + (l - 1) * width;
+      gint     x;
+
+      for (x = 0; x < width; x++)
+        {
+          above[x] = l <= outside_rank ? 0 : radius + 1;
+          below[x] = UNKNOWN;
+        }
+    }
+
+  return columns;
+}
+
+void
+gimp_morphology_columns_free (GimpMorphologyColumns *columns)
+{
+  g_return_if_fail (columns != NULL);
+
+  g_free (columns->above);
+  g_free (columns->below);
+  g_free (columns->distances);
+
+  g_slice_free (GimpMorphologyColumns, columns);
+}
+
+/*  advances to the next row.  rows[k] holds the ranks of the row k rows
+ *  below it, for k in [0, radius].
+ */
+void
+gimp_morphology_columns_step (GimpMorphologyColumns *columns,
+                              guint16 * const       *rows)
+{
+  const gint none = columns->radius + 1;
+  gint       l;
+
+  g_return_if_fail (columns != NULL);
+  g_return_if_fail (rows != NULL);
+
+  for (l = 1; l <= columns->n_levels; l++)
+    {
+      guint16 *above     = columns->above     + (l - 1) * columns->width;
+      guint16 *below     = columns->below     + (l - 1) * columns->width;
+      guint16 *distances = columns->distances + (l - 1) * columns->width;
+      gint     x;
+
+      for (x = 0; x < columns->width; x++)
+        {
+          gint a = above[x];
+          gint b = below[x];
+
+          if (rows[0][x] >= l)
+            a = 0;
+          else if (a < none)
+            a++;
+
+          if (b == UNKNOWN || b == 0)
+            {
+              /*  the hit we were heading for, if any, is behind us now.
+               *  the rows scanned here are skipped by the following steps,
+               *  which keeps this constant time per row, amortized.
+               */
+              b = 0;
+
+              while (b < none && rows[b][x] < l)
+                b++;
+            }
+          else if (b < none)
+            {
+              b--;
+            }
+          else if (rows[columns->radius][x] >= l)
+            {
+              b = columns->radius;
+            }
+
+          above[x]     = a;
+          below[x]     = b;
+          distances[x] = MIN (a, b);
+        }
+    }
+}
+
+const guint16 *
+gimp_morphology_columns_get_distances (GimpMorphologyColumns *columns,
+                                       gint                   level)
+{
+  g_return_val_if_fail (columns != NULL, NULL);
+  g_return_val_if_fail (level > 0 && level <= columns->n_levels, NULL);
+
+  return columns->distances + (level - 1) * columns->width;
+}
+
+/*  computes what the grow operation (or, with erode, the shrink
+ *  operation) computes, using the same elliptic neighborhood, in time
+ *  independent of the radius.  returns FALSE, without touching output, if
+ *  input has too many distinct values for that to pay off.
+ *
+ *  if outside_selected, the pixels outside of roi are considered 0 when
+ *  eroding, otherwise they are ignored, which for growing and shrinking is
+ *  the same as repeating the edge pixels.
+ */
+gboolean
+gimp_operation_morphology_dilate (GeglBuffer          *input,
+                                  GeglBuffer          *output,
+                                  const GeglRectangle *roi,
+                                  const Babl          *format,
+                                  gint                 radius_x,
+                                  gint                 radius_y,
+                                  gboolean             erode,
+                                  gboolean             outside_selected)
+{
+  GimpMorphologyColumns  *columns;
+  GHashTable             *ranks;
+  GList                  *keys;
+  GList                  *list;
+  gfloat                 *levels;
+  gfloat                 *values;
+  gint                    n_levels;
+  gint                    max_levels;
+  gint                    outside_rank = 0;
+  gint16                 *circ;
+  gint                   *widths;
+  gint                   *coverage;
+  guint16               **rows;
+  gfloat                 *line;
+  gfloat                 *out;
+  guint8                 *done;
+  gint                    i, l, x, y;
+
+  g_return_val_if_fail (GEGL_IS_BUFFER (input), FALSE);
+  g_return_val_if_fail (GEGL_IS_BUFFER (output), FALSE);
+  g_return_val_if_fail (roi != NULL, FALSE);
+
+  /*  each level costs about as much as the old way's scan of a few
+   *  neighborhood rows and columns
+   */
+  max_levels = MIN ((radius_x + radius_y) / 4, MAX_LEVELS);
+
+  if (max_levels < 1 || gegl_rectangle_is_empty (roi))
+    return FALSE;
+
+  ranks = g_hash_table_new (NULL, NULL);
+
+  if (! gimp_operation_morphology_collect_levels (input, roi, format,
+                                                  erode, max_levels, ranks))
+    {
+      g_hash_table_unref (ranks);
+
+      return FALSE;
+    }
+
+  if (erode && outside_selected)
+    g_hash_table_insert (ranks, GUINT_TO_POINTER (0), GINT_TO_POINTER (1));
+
+  n_levels = g_hash_table_size (ranks);
+
+  if (n_levels == 0)
+    {
+      gfloat value = erode ? 1.0 : 0.0;
+
+      g_hash_table_unref (ranks);
+
+      gegl_buffer_set_color_from_pixel (output, roi, &value, format);
+
+      return TRUE;
+    }
+
+  /*  rank the levels so that the pixels of level l, and all more selected
+   *  (or, when eroding, less selected) ones, have a rank of at least l
+   */
+  levels = g_new (gfloat, n_levels);
+  values = g_new (gfloat, n_levels + 1);
+
+  keys = g_hash_table_get_keys (ranks);
+
+  for (list = keys, i = 0; list; list = g_list_next (list), i++)
+    {
+      guint32 bits = GPOINTER_TO_UINT (list->data);
+
+      memcpy (&levels[i], &bits, sizeof (gfloat));
+    }
+
+  g_list_free (keys);
+
+  qsort (levels, n_levels, sizeof (gfloat),
+         gimp_operation_morphology_compare_levels);
+
+  for (i = 0; i < n_levels; i++)
+    {
+      gint    rank = erode ? n_levels - i : i + 1;
+      guint32 bits;
+
+      memcpy (&bits, &levels[i], sizeof (gfloat));
+
+      g_hash_table_insert (ranks,
+                           GUINT_TO_POINTER (bits), GINT_TO_POINTER (rank));
+
+      values[rank] = levels[i];
+    }
+
+  g_free (levels);
+
+  if (erode && outside_selected)
+    outside_rank = GPOINTER_TO_INT (g_hash_table_lookup (ranks,
+                                                         GUINT_TO_POINTER (0)));
+
+  /*  the same neighborhood as the old way's, for each vertical distance
+   *  the farthest horizontal one
+   */
+  circ = g_new (gint16, radius_x + 1);
+
+  for (x = 0; x <= radius_x; x++)
+    {
+      gdouble tmp = x > 0 ? x - 0.5 : 0.0;
+
+      circ[x] = RINT (radius_y /
+                      (gdouble) radius_x * sqrt (SQR (radius_x) - SQR (tmp)));
+    }
+
+  widths = g_new (gint, radius_y + 1);
+
+  for (y = 0, x = radius_x; y <= radius_y; y++)
+    {
+      while (circ[x] < y)
+        x--;
+
+      widths[y] = x;
+    }
+
+  g_free (circ);
+
+  coverage = g_new (gint, roi->width + 1);
+  line     = g_new (gfloat, roi->width);
+  out      = g_new (gfloat, roi->width);
+  done     = g_new (guint8, roi->width);
+
+  rows = g_new (guint16 *, radius_y + 1);
+
+  for (i = 0; i < radius_y + 1; i++)
+    {
+      rows[i] = g_new (guint16, roi->width);
+
+      gimp_operation_morphology_load_row (input, roi, format, i,
+                                          ranks, outside_rank,
+                                          line, rows[i]);
+    }
+
+  columns = gimp_morphology_columns_new (roi->width, radius_y,
+                                         n_levels, outside_rank);
+
+  for (y = 0; y < roi->height; y++)
+    {
+      gint     n_done = 0;
+      guint16 *tmp;
+
+      gimp_morphology_columns_step (columns, rows);
+
+      memset (done, 0, roi->width);
+
+      for (x = 0; x < roi->width; x++)
+        out[x] = erode ? 1.0 : 0.0;
+
+      /*  the first, that is most extreme, level whose pixels are within
+       *  reach of a pixel is its value
+       */
+      for (l = n_levels; l > 0 && n_done < roi->width; l--)
+        {
+          const guint16 *distances;
+          gint           sum = 0;
+
+          distances = gimp_morphology_columns_get_distances (columns, l);
+
+          memset (coverage, 0, (roi->width + 1) * sizeof (gint));
+
+          for (x = 0; x < roi->width; x++)
+            {
+              if (distances[x] <= radius_y)
+                {
+                  gint w = widths[distances[x]];
+
+                  coverage[MAX (x - w, 0)]++;
+                  coverage[MIN (x + w, roi->width - 1) + 1]--;
+                }
+            }
+
+          if (l <= outside_rank)
+            {
+              coverage[0]++;
+              coverage[MIN (widths[0], roi->width)]--;
+
+              coverage[MAX (roi->width - widths[0], 0)]++;
+              coverage[roi->width]--;
+            }
+
+          for (x = 0; x < roi->width; x++)
+            {
+              sum += coverage[x];
+
+              if (sum > 0 && ! done[x])
+                {
+                  out[x]  = values[l];
+                  done[x] = TRUE;
+                  n_done++;
+                }
+            }
+        }
+
+      gegl_buffer_set (output,
+                       GEGL_RECTANGLE (roi->x, roi->y + y,
+                                       roi->width, 1),
+                       0, format, out,
+                       GEGL_AUTO_ROWSTRIDE);
+
+      tmp = rows[0];
+
+      for (i = 0; i < radius_y; i++)
+        rows[i] = rows[i + 1];
+
+      rows[radius_y] = tmp;
+
+      gimp_operation_morphology_load_row (input, roi, format,
+                                          y + radius_y + 1,
+                                          ranks, outside_rank,
+                                          line, rows[radius_y]);
+    }
+
+  gimp_morphology_columns_free (columns);
+
+  for (i = 0; i < radius_y + 1; i++)
+    g_free (rows[i]);
+
+  g_free (rows);
+  g_free (done);
+  g_free (out);
+  g_free (line);
+  g_free (coverage);
+  g_free (widths);
+  g_free (values);
+
+  g_hash_table_unref (ranks);
+
+  return TRUE;
+}
+
+
+/*  private functions  */
+
+static gboolean
+gimp_operation_morphology_collect_levels (GeglBuffer          *input,
+                                          const GeglRectangle *roi,
+                                          const Babl          *format,
+                                          gboolean             erode,
+                                          gint                 max_levels,
+                                          GHashTable          *ranks)
+{
+  GeglBufferIterator *iter;
+  gboolean            have_last = FALSE;
+  guint32             last      = 0;
+
+  iter = gegl_buffer_iterator_new (input, roi, 0, format,
+                                   GEGL_ACCESS_READ, GEGL_ABYSS_NONE, 1);
+
+  while (gegl_buffer_iterator_next (iter))
+    {
+      const gfloat *data = iter->items[0].data;
+      gint          i;
+
+      for (i = 0; i < iter->length; i++)
+        {
+          guint32 bits;
+
+          if (erode ? ! (data[i] < 1.0) : ! (data[i] > 0.0))
+            continue;
+
+          memcpy (&bits, &data[i], sizeof (gfloat));
+
+          if (have_last && bits == last)
+            continue;
+
+          g_hash_table_add (ranks, GUINT_TO_POINTER (bits));
+
+          if (g_hash_table_size (ranks) > max_levels)
+            {
+              gegl_buffer_iterator_stop (iter);
+
+              return FALSE;
+            }
+
+          have_last = TRUE;
+          last      = bits;
+        }
+    }
+
+  return TRUE;
+}
+
+static gint
+gimp_operation_morphology_compare_levels (gconstpointer a,
+                                          gconstpointer b)
+{
+  gfloat level_a = *(const gfloat *) a;
+  gfloat level_b = *(const gfloat *) b;
+
+  return level_a < level_b ? -1 : level_a > level_b ? 1 : 0;
+}
+
+static void
+gimp_operation_morphology_load_row (GeglBuffer          *input,
+                                    const GeglRectangle *roi,
+                                    const Babl          *format,
+                                    gint                 y,
+                                    GHashTable          *ranks,
+                                    gint                 outside_rank,
+                                    gfloat              *line,
+                                    guint16             *row)
+{
+  guint32 last      = 0;
+  gint    last_rank = -1;
+  gint    x;
+
+  if (y >= roi->height)
+    {
+      for (x = 0; x < roi->width; x++)
+        row[x] = outside_rank;
+
+      return;
+    }
+
+  gegl_buffer_get (input,
+                   GEGL_RECTANGLE (roi->x, roi->y + y,
+                                   roi->width, 1),
+                   1.0, format, line,
+                   GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
+
+  for (x = 0; x < roi->width; x++)
+    {
+      guint32 bits;
+
+      memcpy (&bits, &line[x], sizeof (gfloat));
+
+      if (last_rank < 0 || bits != last)
+        {
+          last      = bits;
+          last_rank = GPOINTER_TO_INT (g_hash_table_lookup (ranks,
+                                                            GUINT_TO_POINTER (bits)));
+        }
+
+      row[x] = last_rank;
+    }
+}
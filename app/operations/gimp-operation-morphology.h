@@ -0,0 +1,54 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimp-operation-morphology.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GIMP_OPERATION_MORPHOLOGY_H__
+#define __GIMP_OPERATION_MORPHOLOGY_H__
+
+
+typedef struct _GimpMorphologyColumns GimpMorphologyColumns;
+
+
+/*  tracks, for each column and level, the vertical distance from the
+ *  current row to the nearest "hit" pixel, that is a pixel whose rank is
+ *  at least the level, within radius rows.  distances of more than radius
+ *  are reported as radius + 1.
+ */
+GimpMorphologyColumns *
+               gimp_morphology_columns_new           (gint                   width,
+                                                      gint                   radius,
+                                                      gint                   n_levels,
+                                                      gint                   outside_rank);
+void           gimp_morphology_columns_free          (GimpMorphologyColumns *columns);
+
+void           gimp_morphology_columns_step          (GimpMorphologyColumns *columns,
+                                                      guint16 * const       *rows);
+const guint16 * gimp_morphology_columns_get_distances (GimpMorphologyColumns *columns,
+                                                      gint                   level);
+
+gboolean       gimp_operation_morphology_dilate      (GeglBuffer            *input,
+                                                      GeglBuffer            *output,
+                                                      const GeglRectangle   *roi,
+                                                      const Babl            *format,
+                                                      gint                   radius_x,
+                                                      gint                   radius_y,
+                                                      gboolean               erode,
+                                                      gboolean               outside_selected);
+
+
+#endif /* __GIMP_OPERATION_MORPHOLOGY_H__ */
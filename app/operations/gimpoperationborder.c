@@ -29,6 +29,7 @@
 
 #include "operations-types.h"
 
+#include "gimp-operation-morphology.h"
 #include "gimpoperationborder.h"
 
 
@@ -235,6 +236,21 @@ rotate_pointers (gfloat  **p,
   p[i] = tmp;
 }
 
+static inline void
+rotate_transitions (guint16 **p,
+                    guint32   n)
+{
+  guint32  i;
+  guint16 *tmp;
+
+  tmp = p[0];
+
+  for (i = 0; i < n - 1; i++)
+    p[i] = p[i + 1];
+
+  p[i] = tmp;
+}
+
 /* Computes whether pixels in `buf[1]', if they are selected, have neighbouring
    pixels that are unselected. Put result in `transition'. */
 static void
@@ -328,6 +344,96 @@ compute_transition (gfloat    *transition,
     }
 }
 
+/* Computes the transitional pixels of the `y'th row, which must be in
+   `buf[1]', as the ranks of `row', and moves `buf' on to the next row. */
+static void
+next_transition (gfloat              *transition,
+                 guint16             *row,
+                 gfloat             **buf,
+                 GeglBuffer          *input,
+                 const GeglRectangle *roi,
+                 const Babl          *format,
+                 gint32               y,
+                 gboolean             edge_lock)
+{
+  gint32 x;
+
+  if (y >= roi->height)
+    {
+      memset (row, 0, roi->width * sizeof (guint16));
+
+      return;
+    }
+
+  compute_transition (transition, buf, roi->width, edge_lock);
+
+  for (x = 0; x < roi->width; x++)
+    row[x] = transition[x] != 0.0;
+
+  rotate_pointers (buf, 3);
+
+  if (y + 2 < roi->height)
+    {
+      gegl_buffer_get (input,
+                       GEGL_RECTANGLE (roi->x, roi->y + y + 2,
+                                       roi->width, 1),
+                       1.0, format, buf[2],
+                       GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
+    }
+  else if (edge_lock)
+    {
+      for (x = 0; x < roi->width; x++)
+        buf[2][x] = 1.0;
+    }
+  else
+    {
+      memset (buf[2], 0, roi->width * sizeof (gfloat));
+    }
+}
+
+/* The distance of a pixel `dx' columns away, in the units of the ellipse,
+   as measured from the pixel's nearest edge. */
+static inline gdouble
+distance_x (gint32 dx,
+            gint32 radius_x)
+{
+  gdouble tmpx = dx != 0 ? ABS (dx) - 0.5 : 0.0;
+
+  return (tmpx * tmpx) / (radius_x * radius_x);
+}
+
+/* Finds the first column in [`lo', `hi') at which the transitional pixel
+   in column `q', which is `dist_q' away vertically, is at least as close as
+   the one in column `p' < `q', or returns `hi'. Since the distances are
+   convex in the column, the difference of the two can only decrease.
+   Farther than `radius_x' from `q', both are out of reach, and the search
+   doesn't look there. */
+static gint32
+find_crossing (gint32  p,
+               gdouble dist_p,
+               gint32  q,
+               gdouble dist_q,
+               gint32  lo,
+               gint32  hi,
+               gint32  radius_x)
+{
+  lo = MAX (lo, q - radius_x - 1);
+  hi = MIN (hi, q + radius_x + 1);
+
+  while (lo < hi)
+    {
+      gint32 mid = lo + (hi - lo) / 2;
+
+      if (dist_q + distance_x (mid - q, radius_x) <=
+          dist_p + distance_x (mid - p, radius_x))
+        hi = mid;
+      else
+        lo = mid + 1;
+    }
+
+  return lo;
+}
+
 static gboolean
 gimp_operation_border_process (GeglOperation       *operation,
                                GeglBuffer          *input,
@@ -342,7 +448,7 @@ gimp_operation_border_process (GeglOperation       *operation,
   const Babl          *input_format  = gegl_operation_get_format (operation, "input");
   const Babl          *output_format = gegl_operation_get_format (operation, "output");
 
-  gint32 i, j, x, y;
+  gint32 i, x, y;
 
   /* A cache used in the algorithm as it works its way down. `buf[1]' is the
      current row. Thus, at algorithm initialization, `buf[0]' represents the
@@ -354,16 +460,24 @@ gimp_operation_border_process (GeglOperation       *operation,
   gfloat  *out;
 
   /* Keeps track of transitional pixels (pixels that are selected and have
-     unselected neighbouring pixels). */
-  gfloat **transition;
-
-  /* TODO: Figure out role clearly in algorithm. */
-  gint16  *max;
-
-  /* TODO: Figure out role clearly in algorithm. */
-  gfloat **density;
-
-  gint16   last_index;
+     unselected neighbouring pixels), from the current row on down. */
+  gfloat  *row;
+  guint16 **transitions;
+
+  /* The vertical distance from the current row to the nearest transitional
+     pixel of each column, and what it contributes to the distance in the
+     units of the ellipse. */
+  GimpMorphologyColumns *columns;
+  gdouble               *distances_y;
+
+  /* The columns whose transitional pixel is the nearest one for some part
+     of the row, that part's start, and their vertical distance. Each pixel's
+     output only depends on its nearest transitional pixel, which makes the
+     cost of a row independent of the radius. */
+  gint32  *nearest;
+  gint32  *nearest_start;
+  gdouble *nearest_dist;
+  gint32   n_nearest;
 
   /* optimize this case specifically */
   if (self->radius_x == 1 && self->radius_y == 1)
@@ -456,81 +570,23 @@ gimp_operation_border_process (GeglOperation       *operation,
       return TRUE;
     }
 
-  max = g_new (gint16, roi->width + 2 * self->radius_x);
-
-  for (i = 0; i < (roi->width + 2 * self->radius_x); i++)
-    max[i] = self->radius_y + 2;
-
-  max += self->radius_x;
-
   for (i = 0; i < 3; i++)
     buf[i] = g_new (gfloat, roi->width);
 
-  transition = g_new (gfloat *, self->radius_y + 1);
-
-  for (i = 0; i < self->radius_y + 1; i++)
-    {
-      transition[i] = g_new (gfloat, roi->width + 2 * self->radius_x);
-      memset (transition[i], 0,
-              (roi->width + 2 * self->radius_x) * sizeof (gfloat));
-      transition[i] += self->radius_x;
-    }
-
+  row = g_new (gfloat, roi->width);
   out = g_new (gfloat, roi->width);
 
-  density = g_new (gfloat *, 2 * self->radius_x + 1);
-  density += self->radius_x;
+  nearest       = g_new (gint32,  roi->width);
+  nearest_start = g_new (gint32,  roi->width);
+  nearest_dist  = g_new (gdouble, roi->width);
 
-  /* allocate density[][] */
-  for (x = 0; x < (self->radius_x + 1); x++)
-    {
-      density[ x]  = g_new (gfloat, 2 * self->radius_y + 1);
-      density[ x] += self->radius_y;
-      density[-x]  = density[x];
-    }
+  distances_y = g_new (gdouble, self->radius_y + 1);
 
-  /* compute density[][] */
-  for (x = 0; x < (self->radius_x + 1); x++)
+  for (y = 0; y < self->radius_y + 1; y++)
     {
-      gdouble tmpx, tmpy, dist;
-      gfloat  a;
-
-      if (x > 0)
-        tmpx = x - 0.5;
-      else if (x < 0)
-        tmpx = x + 0.5;
-      else
-        tmpx = 0.0;
-
-      for (y = 0; y < (self->radius_y + 1); y++)
-        {
-          if (y > 0)
-            tmpy = y - 0.5;
-          else if (y < 0)
-            tmpy = y + 0.5;
-          else
-            tmpy = 0.0;
-
-          dist = ((tmpy * tmpy) / (self->radius_y * self->radius_y) +
-                  (tmpx * tmpx) / (self->radius_x * self->radius_x));
+      gdouble tmpy = y > 0 ? y - 0.5 : 0.0;
 
-          if (dist < 1.0)
-            {
-              if (self->feather)
-                a = 1.0 - sqrt (dist);
-              else
-                a = 1.0;
-            }
-          else
-            {
-              a = 0.0;
-            }
-
-          density[ x][ y] = a;
-          density[ x][-y] = a;
-          density[-x][ y] = a;
-          density[-x][-y] = a;
-        }
+      distances_y[y] = (tmpy * tmpy) / (self->radius_y * self->radius_y);
     }
 
   /* Since the algorithm considerers `buf[0]' to be 'over' the row
@@ -562,153 +618,95 @@ gimp_operation_border_process (GeglOperation       *operation,
                      1.0, input_format, buf[2],
                      GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
   else
-    memcpy (buf[2], buf[1], roi->width * sizeof (gfloat));
+    memcpy (buf[2], buf[0], roi->width * sizeof (gfloat));
 
-  compute_transition (transition[1], buf, roi->width, self->edge_lock);
+  /* set up the transitional pixels of the top of image */
+  transitions = g_new (guint16 *, self->radius_y + 1);
 
-   /* set up top of image */
-  for (y = 1; y < self->radius_y && y + 1 < roi->height; y++)
+  for (i = 0; i < self->radius_y + 1; i++)
     {
-      rotate_pointers (buf, 3);
-      gegl_buffer_get (input,
-                       GEGL_RECTANGLE (roi->x, roi->y + y + 1,
-                                       roi->width, 1),
-                       1.0, input_format, buf[2],
-                       GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
-      compute_transition (transition[y + 1], buf, roi->width, self->edge_lock);
-    }
+      transitions[i] = g_new (guint16, roi->width);
 
-  /* set up max[] for top of image */
-  for (x = 0; x < roi->width; x++)
-    {
-      max[x] = -(self->radius_y + 7);
-
-      for (j = 1; j < self->radius_y + 1; j++)
-        if (transition[j][x])
-          {
-            max[x] = j;
-            break;
-          }
+      next_transition (row, transitions[i], buf,
+                       input, roi, input_format, i, self->edge_lock);
     }
 
+  columns = gimp_morphology_columns_new (roi->width, self->radius_y, 1, 0);
+
   /* main calculation loop */
   for (y = 0; y < roi->height; y++)
     {
-      rotate_pointers (buf, 3);
-      rotate_pointers (transition, self->radius_y + 1);
-
-      if (y < roi->height - (self->radius_y + 1))
-        {
-          gegl_buffer_get (input,
-                           GEGL_RECTANGLE (roi->x,
-                                           roi->y + y + self->radius_y + 1,
-                                           roi->width, 1),
-                           1.0, input_format, buf[2],
-                           GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
-          compute_transition (transition[self->radius_y], buf, roi->width, self->edge_lock);
-        }
-      else
-        {
-          if (self->edge_lock)
-            {
-              memcpy (transition[self->radius_y], transition[self->radius_y - 1], roi->width * sizeof (gfloat));
-            }
-          else
-            {
-              /* No edge lock, set everything 'below canvas' as seen
-               * from the algorithm as unselected.
-               */
-              memset (buf[2], 0, roi->width * sizeof (gfloat));
-              compute_transition (transition[self->radius_y], buf, roi->width, self->edge_lock);
-            }
-        }
+      const guint16 *distances;
 
-      /* update max array */
-      for (x = 0; x < roi->width; x++)
-        {
-          if (max[x] < 1)
-            {
-              if (max[x] <= -self->radius_y)
-                {
-                  if (transition[self->radius_y][x])
-                    max[x] = self->radius_y;
-                  else
-                    max[x]--;
-                }
-              else
-                {
-                  if (transition[-max[x]][x])
-                    max[x] = -max[x];
-                  else if (transition[-max[x] + 1][x])
-                    max[x] = -max[x] + 1;
-                  else
-                    max[x]--;
-                }
-            }
-          else
-            {
-              max[x]--;
-            }
+      gimp_morphology_columns_step (columns, transitions);
 
-          if (max[x] < -self->radius_y - 1)
-            max[x] = -self->radius_y - 1;
-        }
+      distances = gimp_morphology_columns_get_distances (columns, 1);
 
-      last_index = 1;
+      /* find the nearest transitional pixels along the row */
+      n_nearest = 0;
 
-       /* render scan line */
-      for (x = 0 ; x < roi->width; x++)
+      for (x = 0; x < roi->width; x++)
         {
-          gfloat last_max;
+          gdouble dist;
+          gint32  start = 0;
 
-          last_index--;
+          if (distances[x] > self->radius_y)
+            continue;
 
-          if (last_index >= 0)
+          dist = distances_y[distances[x]];
+
+          while (n_nearest > 0)
             {
-              last_max = 0.0;
+              start = find_crossing (nearest[n_nearest - 1],
+                                     nearest_dist[n_nearest - 1],
+                                     x, dist,
+                                     nearest_start[n_nearest - 1],
+                                     roi->width, self->radius_x);
 
-              for (i = self->radius_x; i >= 0; i--)
-                if (max[x + i] <= self->radius_y && max[x + i] >= -self->radius_y &&
-                    density[i][max[x+i]] > last_max)
-                  {
-                    last_max = density[i][max[x + i]];
-                    last_index = i;
-                  }
+              if (start > nearest_start[n_nearest - 1])
+                break;
 
-              out[x] = last_max;
+              n_nearest--;
             }
-          else
-            {
-              last_max = 0.0;
 
-              for (i = self->radius_x; i >= -self->radius_x; i--)
-                if (max[x + i] <= self->radius_y && max[x + i] >= -self->radius_y &&
-                    density[i][max[x + i]] > last_max)
-                  {
-                    last_max = density[i][max[x + i]];
-                    last_index = i;
-                  }
+          if (n_nearest == 0)
+            start = 0;
 
-              out[x] = last_max;
+          if (start < MIN (x + self->radius_x + 1, roi->width))
+            {
+              nearest[n_nearest]       = x;
+              nearest_start[n_nearest] = start;
+              nearest_dist[n_nearest]  = dist;
+              n_nearest++;
             }
+        }
+
+      /* render scan line */
+      for (x = 0, i = 0; x < roi->width; x++)
+        {
+          gdouble dist;
 
-          if (last_max <= 0.0)
+          if (n_nearest == 0)
             {
-              for (i = x + 1; i < roi->width; i++)
-                {
-                  if (max[i] >= -self->radius_y)
-                    break;
-                }
+              out[x] = 0.0;
+              continue;
+            }
 
-              if (i - x > self->radius_x)
-                {
-                  for (; x < i - self->radius_x; x++)
-                    out[x] = 0;
+          while (i + 1 < n_nearest && nearest_start[i + 1] <= x)
+            i++;
 
-                  x--;
-                }
+          dist = nearest_dist[i] + distance_x (x - nearest[i], self->radius_x);
 
-              last_index = self->radius_x;
+          if (dist < 1.0)
+            {
+              if (self->feather)
+                out[x] = 1.0 - sqrt (dist);
+              else
+                out[x] = 1.0;
+            }
+          else
+            {
+              out[x] = 0.0;
             }
         }
 
@@ -717,32 +715,30 @@ gimp_operation_border_process (GeglOperation       *operation,
                                        roi->width, 1),
                        0, output_format, out,
                        GEGL_AUTO_ROWSTRIDE);
-    }
 
-  g_free (out);
+      rotate_transitions (transitions, self->radius_y + 1);
 
-  for (i = 0; i < 3; i++)
-    g_free (buf[i]);
+      next_transition (row, transitions[self->radius_y], buf,
+                       input, roi, input_format, y + self->radius_y + 1,
+                       self->edge_lock);
+    }
 
-  max -= self->radius_x;
-  g_free (max);
+  gimp_morphology_columns_free (columns);
 
   for (i = 0; i < self->radius_y + 1; i++)
-    {
-      transition[i] -= self->radius_x;
-      g_free (transition[i]);
-    }
+    g_free (transitions[i]);
 
-  g_free (transition);
+  g_free (transitions);
 
-  for (i = 0; i < self->radius_x + 1 ; i++)
-    {
-      density[i] -= self->radius_y;
-      g_free (density[i]);
-    }
+  for (i = 0; i < 3; i++)
+    g_free (buf[i]);
 
-  density -= self->radius_x;
-  g_free (density);
+  g_free (distances_y);
+  g_free (nearest_dist);
+  g_free (nearest_start);
+  g_free (nearest);
+  g_free (out);
+  g_free (row);
 
   return TRUE;
 }
@@ -50,6 +50,17 @@ static gboolean       gimp_operation_cage_coef_calc_process          (GeglOperat
                                                                       gint                  level);
 
 
+/*  the per-pixel independent parts of a cage edge  */
+typedef struct
+{
+  GimpVector2 v1;
+  GimpVector2 a;
+  GimpVector2 dir;
+  gdouble     absa;
+  gdouble     Q;
+} CageEdge;
+
+
 G_DEFINE_TYPE (GimpOperationCageCoefCalc, gimp_operation_cage_coef_calc,
                GEGL_TYPE_OPERATION_SOURCE)
 
@@ -148,22 +159,19 @@ gimp_operation_cage_coef_calc_set_property (GObject      *object,
 }
 
 static gboolean
-gimp_operation_cage_coef_calc_is_on_straight (GimpVector2 *d1,
-                                              GimpVector2 *d2,
-                                              GimpVector2 *p)
+gimp_operation_cage_coef_calc_is_on_straight (const GimpVector2 *d1,
+                                              const GimpVector2 *dir,
+                                              const GimpVector2 *p)
 {
-  GimpVector2 v1, v2;
+  GimpVector2 v1;
   gfloat      deter;
 
   v1.x = p->x - d1->x;
   v1.y = p->y - d1->y;
-  v2.x = d2->x - d1->x;
-  v2.y = d2->y - d1->y;
 
   gimp_vector2_normalize (&v1);
-  gimp_vector2_normalize (&v2);
 
-  deter = v1.x * v2.y - v2.x * v1.y;
+  deter = v1.x * dir->y - dir->x * v1.y;
 
   return (deter < 0.000000001) && (deter > -0.000000001);
 }
@@ -202,7 +210,8 @@ gimp_operation_cage_coef_calc_process (GeglOperation       *operation,
 
   GeglBufferIterator *it;
   guint               n_cage_vertices;
-  GimpCagePoint      *current, *last;
+  CageEdge           *edges;
+  gint                j;
 
   if (! config)
     return FALSE;
@@ -211,6 +220,31 @@ gimp_operation_cage_coef_calc_process (GeglOperation       *operation,
 
   n_cage_vertices   = gimp_cage_config_get_n_points (config);
 
+  /*  precompute everything that only depends on the cage, instead of
+   *  doing it again for every pixel
+   */
+  edges = g_new (CageEdge, n_cage_vertices);
+
+  for (j = 0; j < n_cage_vertices; j++)
+    {
+      GimpCagePoint *last;
+      GimpCagePoint *current;
+      CageEdge      *edge = &edges[j];
+
+      last    = &g_array_index (config->cage_points, GimpCagePoint, j);
+      current = &g_array_index (config->cage_points, GimpCagePoint,
+                                (j + 1) % n_cage_vertices);
+
+      edge->v1   = last->src_point;
+      edge->a.x  = current->src_point.x - last->src_point.x;
+      edge->a.y  = current->src_point.y - last->src_point.y;
+      edge->dir  = edge->a;
+      edge->absa = gimp_vector2_length (&edge->a);
+      edge->Q    = edge->a.x * edge->a.x + edge->a.y * edge->a.y;
+
+      gimp_vector2_normalize (&edge->dir);
+    }
+
   it = gegl_buffer_iterator_new (output, roi, 0, format,
                                  GEGL_ACCESS_WRITE, GEGL_ABYSS_NONE, 1);
 
@@ -221,35 +255,27 @@ gimp_operation_cage_coef_calc_process (GeglOperation       *operation,
       gint    n_pixels = it->length;
       gint    x        = it->items[0].roi.x; /* initial x         */
       gint    y        = it->items[0].roi.y; /* and y coordinates */
-      gint    j;
 
       memset (coef, 0, sizeof * coef * n_pixels * 2 * n_cage_vertices);
       while(n_pixels--)
         {
           if (gimp_cage_config_point_inside(config, x, y))
             {
-              last = &(g_array_index (config->cage_points, GimpCagePoint, 0));
-
-              for( j = 0; j < n_cage_vertices; j++)
+              for (j = 0; j < n_cage_vertices; j++)
                 {
-                  GimpVector2 v1,v2,a,b,p;
-                  gdouble BA,SRT,L0,L1,A0,A1,A10,L10, Q,S,R, absa;
+                  const CageEdge *edge = &edges[j];
+                  GimpVector2     b, p;
+                  gdouble         BA, SRT, L0, L1, A0, A1, A10, L10, Q, S, R;
 
-                  current = &(g_array_index (config->cage_points, GimpCagePoint, (j+1) % n_cage_vertices));
-                  v1 = last->src_point;
-                  v2 = current->src_point;
                   p.x = x;
                   p.y = y;
-                  a.x = v2.x - v1.x;
-                  a.y = v2.y - v1.y;
-                  absa = gimp_vector2_length (&a);
 
-                  b.x = v1.x - x;
-                  b.y = v1.y - y;
-                  Q = a.x * a.x + a.y * a.y;
+                  b.x = edge->v1.x - x;
+                  b.y = edge->v1.y - y;
+                  Q = edge->Q;
                   S = b.x * b.x + b.y * b.y;
-                  R = 2.0 * (a.x * b.x + a.y * b.y);
-                  BA = b.x * a.y - b.y * a.x;
+                  R = 2.0 * (edge->a.x * b.x + edge->a.y * b.y);
+                  BA = b.x * edge->a.y - b.y * edge->a.x;
                   SRT = sqrt(4.0 * S * Q - R * R);
 
                   L0 = log(S);
@@ -260,7 +286,7 @@ gimp_operation_cage_coef_calc_process (GeglOperation       *operation,
                   L10 = L1 - L0;
 
                   /* edge coef */
-                  coef[j + n_cage_vertices] = (-absa / (4.0 * G_PI)) * ((4.0*S-(R*R)/Q) * A10 + (R / (2.0 * Q)) * L10 + L1 - 2.0);
+                  coef[j + n_cage_vertices] = (-edge->absa / (4.0 * G_PI)) * ((4.0*S-(R*R)/Q) * A10 + (R / (2.0 * Q)) * L10 + L1 - 2.0);
 
                   if (isnan(coef[j + n_cage_vertices]))
                     {
@@ -268,13 +294,11 @@ gimp_operation_cage_coef_calc_process (GeglOperation       *operation,
                     }
 
                   /* vertice coef */
-                  if (!gimp_operation_cage_coef_calc_is_on_straight (&v1, &v2, &p))
+                  if (!gimp_operation_cage_coef_calc_is_on_straight (&edge->v1, &edge->dir, &p))
                     {
                       coef[j] += (BA / (2.0 * G_PI)) * (L10 /(2.0*Q) - A10 * (2.0 + R / Q));
                       coef[(j+1)%n_cage_vertices] -= (BA / (2.0 * G_PI)) * (L10 / (2.0 * Q) - A10 * (R / Q));
                     }
-
-                  last = current;
                 }
             }
 
@@ -290,5 +314,7 @@ gimp_operation_cage_coef_calc_process (GeglOperation       *operation,
         }
     }
 
+  g_free (edges);
+
   return TRUE;
 }
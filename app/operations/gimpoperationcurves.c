@@ -37,6 +37,7 @@
 #include "gimp-intl.h"
 
 
+static void     gimp_operation_curves_prepare (GeglOperation       *operation);
 static gboolean gimp_operation_curves_process (GeglOperation       *operation,
                                                void                *in_buf,
                                                void                *out_buf,
@@ -67,7 +68,9 @@ gimp_operation_curves_class_init (GimpOperationCurvesClass *klass)
                                  "description", _("Adjust color curves"),
                                  NULL);
 
-  point_class->process = gimp_operation_curves_process;
+  operation_class->prepare = gimp_operation_curves_prepare;
+
+  point_class->process     = gimp_operation_curves_process;
 
   g_object_class_install_property (object_class,
                                    GIMP_OPERATION_POINT_FILTER_PROP_TRC,
@@ -93,6 +96,62 @@ gimp_operation_curves_init (GimpOperationCurves *self)
 {
 }
 
+static void
+gimp_operation_curves_prepare (GeglOperation *operation)
+{
+  GEGL_OPERATION_CLASS (parent_class)->prepare (operation);
+
+  gimp_operation_point_filter_prepare_u8 (operation);
+}
+
+/*  8-bit input is mapped through a per-channel lookup table, see
+ *  gimp_operation_point_filter_prepare_u8()
+ */
+static void
+gimp_operation_curves_process_u8 (GimpCurvesConfig *config,
+                                  const guint8     *src,
+                                  guint8           *dest,
+                                  glong             samples)
+{
+  guint8 lut[4][256];
+  gint   i;
+
+  /*  the config can change between calls, so the table is built here,
+   *  which is still much cheaper than mapping every pixel
+   */
+  for (i = 0; i < 256; i++)
+    {
+      gdouble value = i / 255.0;
+      gint    c;
+
+      for (c = 0; c < 3; c++)
+        {
+          gdouble v;
+
+          v = gimp_curve_map_value (config->curve[GIMP_HISTOGRAM_VALUE],
+                                    gimp_curve_map_value (config->curve[c + 1],
+                                                          value));
+
+          lut[c][i] = ROUND (CLAMP (v, 0.0, 1.0) * 255.0);
+        }
+
+      lut[3][i] = ROUND (CLAMP (gimp_curve_map_value (
+                                  config->curve[GIMP_HISTOGRAM_ALPHA], value),
+                                0.0, 1.0) * 255.0);
+    }
+
+  while (samples--)
+    {
+      dest[0] = lut[0][src[0]];
+      dest[1] = lut[1][src[1]];
+      dest[2] = lut[2][src[2]];
+      dest[3] = lut[3][src[3]];
+
+      src  += 4;
+      dest += 4;
+    }
+}
+
 static gboolean
 gimp_operation_curves_process (GeglOperation       *operation,
                                void                *in_buf,
@@ -109,6 +168,14 @@ gimp_operation_curves_process (GeglOperation       *operation,
   if (! config)
     return FALSE;
 
+  if (babl_format_get_type (gegl_operation_get_format (operation, "input"),
+                            0) == babl_type ("u8"))
+    {
+      gimp_operation_curves_process_u8 (config, in_buf, out_buf, samples);
+
+      return TRUE;
+    }
+
   gimp_curve_map_pixels (config->curve[0],
                          config->curve[1],
                          config->curve[2],
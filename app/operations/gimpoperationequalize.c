@@ -51,6 +51,7 @@ static void     gimp_operation_equalize_set_property (GObject             *objec
                                                       const GValue        *value,
                                                       GParamSpec          *pspec);
 
+static void     gimp_operation_equalize_prepare      (GeglOperation       *operation);
 static gboolean gimp_operation_equalize_process      (GeglOperation       *operation,
                                                       void                *in_buf,
                                                       void                *out_buf,
@@ -82,7 +83,9 @@ gimp_operation_equalize_class_init (GimpOperationEqualizeClass *klass)
                                  "description", "GIMP Equalize operation",
                                  NULL);
 
-  point_class->process = gimp_operation_equalize_process;
+  operation_class->prepare = gimp_operation_equalize_prepare;
+
+  point_class->process     = gimp_operation_equalize_process;
 
   g_object_class_install_property (object_class, PROP_HISTOGRAM,
                                    g_param_spec_object ("histogram",
@@ -221,6 +224,48 @@ gimp_operation_equalize_map (GimpOperationEqualize *self,
   return self->values[index];
 }
 
+static void
+gimp_operation_equalize_prepare (GeglOperation *operation)
+{
+  GEGL_OPERATION_CLASS (parent_class)->prepare (operation);
+
+  gimp_operation_point_filter_prepare_u8 (operation);
+}
+
+static void
+gimp_operation_equalize_process_u8 (GimpOperationEqualize *self,
+                                    const guint8          *src,
+                                    guint8                *dest,
+                                    glong                  samples)
+{
+  guint8 lut[3][256];
+  gint   i;
+
+  for (i = 0; i < 256; i++)
+    {
+      gfloat value = i / 255.0f;
+      gint   c;
+
+      for (c = 0; c < 3; c++)
+        {
+          gfloat v = gimp_operation_equalize_map (self, c, value);
+
+          lut[c][i] = ROUND (CLAMP (v, 0.0f, 1.0f) * 255.0f);
+        }
+    }
+
+  while (samples--)
+    {
+      dest[RED]   = lut[RED][src[RED]];
+      dest[GREEN] = lut[GREEN][src[GREEN]];
+      dest[BLUE]  = lut[BLUE][src[BLUE]];
+      dest[ALPHA] = src[ALPHA];
+
+      src  += 4;
+      dest += 4;
+    }
+}
+
 static gboolean
 gimp_operation_equalize_process (GeglOperation       *operation,
                                  void                *in_buf,
@@ -233,6 +278,14 @@ gimp_operation_equalize_process (GeglOperation       *operation,
   gfloat                *src  = in_buf;
   gfloat                *dest = out_buf;
 
+  if (babl_format_get_type (gegl_operation_get_format (operation, "input"),
+                            0) == babl_type ("u8"))
+    {
+      gimp_operation_equalize_process_u8 (self, in_buf, out_buf, samples);
+
+      return TRUE;
+    }
+
   while (samples--)
     {
       dest[RED]   = gimp_operation_equalize_map (self, RED,   src[RED]);
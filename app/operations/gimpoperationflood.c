@@ -21,6 +21,19 @@
 
 /* Implementation of the Flood algorithm.
  * See https://wiki.gimp.org/wiki/Algorithms:Flood for details.
+ *
+ * The water level of each pixel is the highest ground level along the lowest
+ * path from the pixel to the edge of the ROI.  Rather than following the water
+ * segment by segment, we split the ROI into tiles, and let the water settle in
+ * each tile by alternating forward and backward raster scans, until they no
+ * longer change anything.  When the water level along one of the tile's edges
+ * changes, the tile on the other side of the edge is marked for another visit.
+ * Tiles are visited in two phases, checkerboard-style, so that the tiles
+ * processed in parallel never share an edge.
+ *
+ * The scans only ever lower the water level, towards the same limit, no matter
+ * in what order they visit the pixels, so the result doesn't depend on the
+ * tiling, or on the number of threads.
  */
 
 
@@ -39,161 +52,73 @@
 #include "gimpoperationflood.h"
 
 
-/* Maximal gap, in pixels, between consecutive dirty ranges, below (and
- * including) which they are coalesced, at the beginning of the distribution
- * step.
- */
-#define GIMP_OPERATION_FLOOD_COALESCE_MAX_GAP 32
-
+/* The width and height of the tiles, in pixels. */
+#define GIMP_OPERATION_FLOOD_TILE_SIZE 64
 
-typedef struct _GimpOperationFloodSegment    GimpOperationFloodSegment;
-typedef struct _GimpOperationFloodDirtyRange GimpOperationFloodDirtyRange;
-typedef struct _GimpOperationFloodContext    GimpOperationFloodContext;
+/* The minimal number of tiles per thread. */
+#define GIMP_OPERATION_FLOOD_TILES_PER_THREAD 4
 
 
-/* A segment. */
-struct _GimpOperationFloodSegment
-{
-  /* A boolean flag indicating whether the image- and ROI-virtual coordinate
-   * systems should be transposed when processing this segment.  TRUE iff the
-   * segment is vertical.
-   */
-  guint  transpose      : 1;
-
-  /* The y-coordinate of the segment, in the ROI-virtual coordinate system. */
-  guint  y              : 8 * sizeof (guint) - 3;
-  /* The difference between the y-coordinates of the source segment and this
-   * segment, in the ROI-virtual coordinate system.  Either -1 or +1 for
-   * ordinary segments, and 0 for seed segments, as a special case.
-   *
-   * Note the use of `signed` as the type specifier.  The C standard doesn't
-   * specify the signedness of bit-fields whose type specifier is `int`, or a
-   * typedef-name defined as `int`, such as `gint`.
-   */
-  signed source_y_delta : 2;
+typedef struct _GimpOperationFloodContext GimpOperationFloodContext;
 
-  /* The x-coordinates of the first and last pixels of the segment, in the ROI-
-   * virtual coordinate system.  Note that this is a closed range:
-   * [x[0], x[1]].
-   */
-  gint   x[2];
-};
-/* Make sure the maximal image dimension fits in
- * `GimpOperationFloodSegment::y`.
- */
-G_STATIC_ASSERT (GIMP_MAX_IMAGE_SIZE <= (1 << (8 * sizeof (guint) - 3)));
-
-/* A dirty range of the current segment. */
-struct _GimpOperationFloodDirtyRange
-{
-  /* A boolean flag indicating whether the range was extended, or its existing
-   * pixels were modified, during the horizontal propagation step.
-   */
-  gboolean modified;
-
-  /* The x-coordinates of the first and last pixels of the range, in the ROI-
-   * virtual coordinate system.  Note that this is a closed range:
-   * [x[0], x[1]].
-   */
-  gint     x[2];
-};
 
 /* Common parameters for the various parts of the algorithm. */
 struct _GimpOperationFloodContext
 {
   /* Input image. */
-  GeglBuffer                *input;
+  GeglBuffer          *input;
   /* Input image format. */
-  const Babl                *input_format;
+  const Babl          *input_format;
   /* Output image. */
-  GeglBuffer                *output;
+  GeglBuffer          *output;
   /* Output image format. */
-  const Babl                *output_format;
+  const Babl          *output_format;
 
   /* Region of interset. */
-  GeglRectangle  roi;
+  GeglRectangle        roi;
 
-  /* Current segment. */
-  GimpOperationFloodSegment  segment;
+  /* The number of tile columns and rows covering the ROI. */
+  gint                 n_columns;
+  gint                 n_rows;
 
-  /* The following arrays hold the ground- and water-level of the current- and
-   * source-segments.  The vertical- and horizontal-propagation steps don't
-   * generally access the input and output GEGL buffers directly, but rather
-   * read from, and write to, these arrays, for efficiency.  These arrays are
-   * read-from, and written-to, the corresponding GEGL buffers before and after
-   * these steps.
+  /* A flag for each tile, in row-major order, indicating whether the tile
+   * needs to be processed (again.)  Set by the neighboring tiles, using atomic
+   * operations, while processing them in parallel.
    */
+  gint                *dirty;
 
-  /* Ground level of the current segment, indexed by x-coordinate in the ROI-
-   * virtual coordinate system.  Only valid inside the range
-   * `[segment.x[0], segment.x[1]]`.
-   */
-  gfloat                    *ground;
-  /* Water level of the current segment, indexed by x-coordinate in the ROI-
-   * virtual coordinate system.  Initially only valid inside the range
-   * `[segment.x[0], segment.x[1]]`, but may be written-to outside this range
-   * during horizontal propagation, if the dirty ranges are extended past the
-   * bounds of the segment.
-   */
-  gfloat                    *water;
-  /* Water level of the source segment, indexed by x-coordinate in the ROI-
-   * virtual coordinate system.  Only valid inside the range
-   * `[segment.x[0], segment.x[1]]`.
-   */
-  gfloat                    *source_water;
-
-  /* A common buffer for the water level of the current- and source-segments.
-   * `water` and `source_water` are pointers into this buffer.  This buffer is
-   * used as an optimization, in order to read the water level of both segments
-   * from the output GEGL buffer in a single call, and is otherwise not used
-   * directly (`water` and `source_water` are used to access the water level
-   * instead.)
-   */
-  gfloat                    *water_buffer;
+  /* The indices of the tiles processed in the current phase. */
+  const gint          *tiles;
 };
 
 
-static void          gimp_operation_flood_prepare                      (GeglOperation                     *operation);
-static GeglRectangle gimp_operation_flood_get_required_for_output      (GeglOperation                     *self,
-                                                                        const gchar                       *input_pad,
-                                                                        const GeglRectangle               *roi);
-static GeglRectangle gimp_operation_flood_get_cached_region            (GeglOperation                     *self,
-                                                                        const GeglRectangle               *roi);
-
-static void          gimp_operation_flood_process_push                 (GQueue                            *queue,
-                                                                        gboolean                           transpose,
-                                                                        gint                               y,
-                                                                        gint                               source_y_delta,
-                                                                        gint                               x0,
-                                                                        gint                               x1);
-static void          gimp_operation_flood_process_seed                 (GQueue                            *queue,
-                                                                        const GeglRectangle               *roi);
-static void          gimp_operation_flood_process_transform_rect       (const GimpOperationFloodContext    *ctx,
-                                                                        GeglRectangle                      *dest,
-                                                                        const GeglRectangle                *src);
-static void          gimp_operation_flood_process_fetch                (GimpOperationFloodContext          *ctx);
-static gint          gimp_operation_flood_process_propagate_vertical   (GimpOperationFloodContext          *ctx,
-                                                                        GimpOperationFloodDirtyRange       *dirty_ranges);
-static void          gimp_operation_flood_process_propagate_horizontal (GimpOperationFloodContext          *ctx,
-                                                                        gint                                dir,
-                                                                        GimpOperationFloodDirtyRange       *dirty_ranges,
-                                                                        gint                                range_count);
-static gint         gimp_operation_flood_process_coalesce              (const GimpOperationFloodContext    *ctx,
-                                                                        GimpOperationFloodDirtyRange       *dirty_ranges,
-                                                                        gint                                range_count,
-                                                                        gint                                gap);
-static void          gimp_operation_flood_process_commit               (const GimpOperationFloodContext    *ctx,
-                                                                        const GimpOperationFloodDirtyRange *dirty_ranges,
-                                                                        gint                                range_count);
-static void          gimp_operation_flood_process_distribute           (const GimpOperationFloodContext    *ctx,
-                                                                        GQueue                             *queue,
-                                                                        const GimpOperationFloodDirtyRange *dirty_ranges,
-                                                                        gint                                range_count);
-static gboolean      gimp_operation_flood_process                      (GeglOperation                      *operation,
-                                                                        GeglBuffer                         *input,
-                                                                        GeglBuffer                         *output,
-                                                                        const GeglRectangle                *roi,
-                                                                        gint                                level);
+static void          gimp_operation_flood_prepare                 (GeglOperation                   *operation);
+static GeglRectangle gimp_operation_flood_get_required_for_output (GeglOperation                   *self,
+                                                                   const gchar                     *input_pad,
+                                                                   const GeglRectangle             *roi);
+static GeglRectangle gimp_operation_flood_get_cached_region       (GeglOperation                   *self,
+                                                                   const GeglRectangle             *roi);
+
+static void          gimp_operation_flood_process_scan            (const gfloat                    *ground,
+                                                                   gfloat                          *water,
+                                                                   gint                             width,
+                                                                   gint                             height,
+                                                                   gint                             dir);
+static void          gimp_operation_flood_process_edges           (const GimpOperationFloodContext *ctx,
+                                                                   gint                             column,
+                                                                   gint                             row,
+                                                                   const gfloat                    *before,
+                                                                   const gfloat                    *after,
+                                                                   gint                             width,
+                                                                   gint                             height);
+static void          gimp_operation_flood_process_tiles           (gsize                            offset,
+                                                                   gsize                            size,
+                                                                   const GimpOperationFloodContext *ctx);
+static gboolean      gimp_operation_flood_process                 (GeglOperation                   *operation,
+                                                                   GeglBuffer                      *input,
+                                                                   GeglBuffer                      *output,
+                                                                   const GeglRectangle             *roi,
+                                                                   gint                             level);
 
 
 G_DEFINE_TYPE (GimpOperationFlood, gimp_operation_flood,
@@ -227,7 +152,7 @@ gimp_operation_flood_class_init (GimpOperationFloodClass *klass)
   operation_class->want_in_place = FALSE;
   /* We don't want `GeglOperationFilter` to split the image across multiple
    * threads, since this operation depends on, and affects, the image as a
-   * whole.
+   * whole.  We distribute the tiles across threads ourselves instead.
    */
   operation_class->threaded      = FALSE;
   /* Note that both of these options are the default; we set them here for
@@ -279,714 +204,208 @@ gimp_operation_flood_get_cached_region (GeglOperation       *self,
 }
 
 
-/* Pushes a single segment into the queue. */
-static void
-gimp_operation_flood_process_push (GQueue   *queue,
-                                   gboolean  transpose,
-                                   gint      y,
-                                   gint      source_y_delta,
-                                   gint      x0,
-                                   gint      x1)
-{
-  GimpOperationFloodSegment *segment;
-
-  segment                 = g_slice_new (GimpOperationFloodSegment);
-
-  segment->transpose      = transpose;
-  segment->y              = y;
-  segment->source_y_delta = source_y_delta;
-  segment->x[0]           = x0;
-  segment->x[1]           = x1;
-
-  g_queue_push_tail (queue, segment);
-}
-
-/* Pushes the seed segments into the queue.  Recall that the seed segments are
- * indicated by having their `source_y_delta` field equal 0.
- *
- * `roi` is given in the image-physical coordinate system.
- */
-static void
-gimp_operation_flood_process_seed (GQueue              *queue,
-                                   const GeglRectangle *roi)
-{
-  if (roi->width == 0 || roi->height == 0)
-    return;
-
-  /* Top edge. */
-  gimp_operation_flood_process_push (queue,
-                                     /* transpose      = */ FALSE,
-                                     /* y              = */ 0,
-                                     /* source_y_delta = */ 0,
-                                     /* x0             = */ 0,
-                                     /* x1             = */ roi->width - 1);
-
-  if (roi->height == 1)
-    return;
-
-  /* Bottom edge. */
-  gimp_operation_flood_process_push (queue,
-                                     /* transpose      = */ FALSE,
-                                     /* y              = */ roi->height - 1,
-                                     /* source_y_delta = */ 0,
-                                     /* x0             = */ 0,
-                                     /* x1             = */ roi->width - 1);
-
-  if (roi->height == 2)
-    return;
-
-  /* Left edge. */
-  gimp_operation_flood_process_push (queue,
-                                     /* transpose      = */ TRUE,
-                                     /* y              = */ 0,
-                                     /* source_y_delta = */ 0,
-                                     /* x0             = */ 1,
-                                     /* x1             = */ roi->height - 2);
-
-  if (roi->width == 1)
-    return;
-
-  /* Right edge. */
-  gimp_operation_flood_process_push (queue,
-                                     /* transpose      = */ TRUE,
-                                     /* y              = */ roi->width - 1,
-                                     /* source_y_delta = */ 0,
-                                     /* x0             = */ 1,
-                                     /* x1             = */ roi->height - 2);
-}
-
-/* Transforms a `GeglRectangle` between the image-physical and image-virtual
- * coordinate systems, in either direction, based on the attributes of the
- * current segment (namely, its `transpose` flag.)
- *
- * Takes the input rectangle through `src`, and stores the result in `dest`.
- * Both parameters may refer to the same object.
+/* The stride of the water-level arrays.  These hold the water level of a tile,
+ * surrounded by a one-pixel border holding the water level of the neighboring
+ * pixels, which is 0 outside the ROI.  The ground-level arrays hold the tile
+ * alone, with a stride of `GIMP_OPERATION_FLOOD_TILE_SIZE`.
  */
-static void
-gimp_operation_flood_process_transform_rect (const GimpOperationFloodContext *ctx,
-                                             GeglRectangle                   *dest,
-                                             const GeglRectangle             *src)
-{
-  if (! ctx->segment.transpose)
-    *dest = *src;
-  else
-    {
-      gint temp;
+#define WATER_STRIDE (GIMP_OPERATION_FLOOD_TILE_SIZE + 2)
 
-      temp         = src->x;
-      dest->x      = src->y;
-      dest->y      = temp;
 
-      temp         = src->width;
-      dest->width  = src->height;
-      dest->height = temp;
-    }
-}
-
-/* Reads the ground- and water-level for the current- and source-segments from
- * the GEGL buffers into the corresponding arrays.  Sets up the `water` and
- * `source_water` pointers of `ctx` to point to the right location in
- * `water_buffer`.
+/* Performs a single raster scan of a tile, forward (`dir` == +1) or backward
+ * (`dir` == -1), lowering the water level of each pixel to that of its
+ * previously-scanned vertical and horizontal neighbors, but not below its
+ * ground level.
+ *
+ * The vertical step doesn't depend on the other pixels of the row, and is
+ * done for the whole row at once, branch-free, which the compiler vectorizes.
+ * Only the horizontal step has to run pixel by pixel.
  */
 static void
-gimp_operation_flood_process_fetch (GimpOperationFloodContext *ctx)
+gimp_operation_flood_process_scan (const gfloat *ground,
+                                   gfloat       *water,
+                                   gint          width,
+                                   gint          height,
+                                   gint          dir)
 {
-  /* Image-virtual and image-physical rectangles, respectively. */
-  GeglRectangle iv_rect, ip_rect;
+  gint y;
 
-  /* Set the horizontal extent of the rectangle to span the entire segment. */
-  iv_rect.x     = ctx->roi.x + ctx->segment.x[0];
-  iv_rect.width = ctx->segment.x[1] - ctx->segment.x[0] + 1;
-
-  /* For reading the water level, we treat ordinary (non-seed) and seed
-   * segments differently.
-   */
-  if (ctx->segment.source_y_delta != 0)
+  for (y = 0; y < height; y++)
     {
-      /* Ordinary segment. */
-
-      /* We set the vertical extent of the rectangle to span both the current-
-       * and the source-segments, and set the `water` and `source_water`
-       * pointers to point to two consecutive rows of the `water_buffer` array
-       * (the y-coordinate of the rectangle, and which row is above which,
-       * depends on whether the source segment is above, or below, the current
-       * one.)
-       */
-      if (ctx->segment.source_y_delta < 0)
+      gint          row    = dir > 0 ? y : height - 1 - y;
+      const gfloat *g      = ground + row * GIMP_OPERATION_FLOOD_TILE_SIZE;
+      gfloat       *w      = water + (row + 1) * WATER_STRIDE + 1;
+      const gfloat *source = w - dir * WATER_STRIDE;
+      gfloat        level;
+      gint          x;
+
+      /* Vertical step. */
+      for (x = 0; x < width; x++)
+        w[x] = MIN (w[x], MAX (source[x], g[x]));
+
+      /* Horizontal step. */
+      if (dir > 0)
         {
-          iv_rect.y         = ctx->roi.y + ctx->segment.y - 1;
-          ctx->water        = ctx->water_buffer + ctx->roi.width;
-          ctx->source_water = ctx->water_buffer;
+          level = w[-1];
+
+          for (x = 0; x < width; x++)
+            w[x] = level = MIN (w[x], MAX (level, g[x]));
         }
       else
         {
-          iv_rect.y         = ctx->roi.y + ctx->segment.y;
-          ctx->water        = ctx->water_buffer;
-          ctx->source_water = ctx->water_buffer + ctx->roi.width;
-        }
-      iv_rect.height        = 2;
-
-      /* Transform `iv_rect` to the image-physical coordinate system, and store
-       * the result in `ip_rect`.
-       */
-      gimp_operation_flood_process_transform_rect (ctx, &ip_rect, &iv_rect);
-
-      /* Read the water level from the output GEGL buffer into `water_buffer`.
-       *
-       * Notice the stride:  If the current segment is horizontal, then we're
-       * reading a pair of rows directly into the correct locations inside
-       * `water_buffer` (i.e., `water` and `source_water`).  On the other hand,
-       * if the current segment is vertical, then we're reading a pair of
-       * *columns*; we set the stride to 2-pixels so that the current- and
-       * source-water levels are interleaved in `water_buffer`, and reorder
-       * them below.
-       */
-      gegl_buffer_get (ctx->output, &ip_rect, 1.0, ctx->output_format,
-                       ctx->water_buffer + ctx->segment.x[0],
-                       sizeof (gfloat) *
-                       (ctx->segment.transpose ? 2 : ctx->roi.width),
-                       GEGL_ABYSS_NONE);
-
-      /* As mentioned above, if the current segment is vertical, then the
-       * water levels of the current- and source-segments are interleaved in
-       * `water_buffer`.  We deinterleave the water levels into `water` and
-       * `source_water`, using the yet-to-be-written-to `ground` array as a
-       * temporary buffer, as necessary.
-       */
-      if (ctx->segment.transpose)
-        {
-          const gfloat *src;
-          gfloat       *dest1, *dest2, *temp;
-          gint          size, temp_size;
-          gint          i;
-
-          src       = ctx->water_buffer + ctx->segment.x[0];
+          level = w[width];
 
-          dest1     = ctx->water_buffer + ctx->segment.x[0];
-          dest2     = ctx->water_buffer + ctx->roi.width + ctx->segment.x[0];
-          temp      = ctx->ground;
-
-          size      = ctx->segment.x[1] - ctx->segment.x[0] + 1;
-          temp_size = MAX (0, 2 * size - ctx->roi.width);
-
-          for (i = 0; i < temp_size; i++)
-            {
-              dest1[i] = src[2 * i];
-              temp[i]  = src[2 * i + 1];
-            }
-          for (; i < size; i++)
-            {
-              dest1[i] = src[2 * i];
-              dest2[i] = src[2 * i + 1];
-            }
-
-          memcpy (dest2, temp, sizeof (gfloat) * temp_size);
+          for (x = width - 1; x >= 0; x--)
+            w[x] = level = MIN (w[x], MAX (level, g[x]));
         }
     }
-  else
-    {
-      /* Seed segment. */
-
-      gint x;
-
-      /* Set the `water` and `source_water` pointers to point to consecutive
-       * rows of the `water_buffer` array.
-       */
-      ctx->water        = ctx->water_buffer;
-      ctx->source_water = ctx->water_buffer + ctx->roi.width;
-
-      /* Set the vertical extent of the rectangle to span a the current
-       * segment's row.
-       */
-      iv_rect.y      = ctx->roi.y + ctx->segment.y;
-      iv_rect.height = 1;
-
-      /* Transform `iv_rect` to the image-physical coordinate system, and store
-       * the result in `ip_rect`.
-       */
-      gimp_operation_flood_process_transform_rect (ctx, &ip_rect, &iv_rect);
-
-      /* Read the water level of the current segment from the output GEGL
-       * buffer into `water`.
-       */
-      gegl_buffer_get (ctx->output, &ip_rect, 1.0, ctx->output_format,
-                       ctx->water + ctx->segment.x[0],
-                       GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
-
-      /* Initialize `source_water` to 0, as this is a seed segment. */
-      for (x = ctx->segment.x[0]; x <= ctx->segment.x[1]; x++)
-        ctx->source_water[x] = 0.0;
-    }
-
-  /* Set the vertical extent of the rectangle to span a the current segment's
-   * row.
-   */
-  iv_rect.y      = ctx->roi.y + ctx->segment.y;
-  iv_rect.height = 1;
-
-  /* Transform `iv_rect` to the image-physical coordinate system, and store the
-   * result in `ip_rect`.
-   */
-  gimp_operation_flood_process_transform_rect (ctx, &ip_rect, &iv_rect);
-
-  /* Read the ground level of the current segment from the input GEGL buffer
-   * into `ground`.
-   */
-  gegl_buffer_get (ctx->input, &ip_rect, 1.0, ctx->input_format,
-                   ctx->ground + ctx->segment.x[0],
-                   GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
 }
 
-/* Performs the vertical propagation step of the algorithm.  Writes the dirty
- * ranges to the `dirty_ranges` parameter, and returns the number of dirty
- * ranges as the function's result.
+/* Marks the neighbors of the tile at (`column`, `row`) as dirty, if the water
+ * level along the corresponding edge of the tile has changed.
  */
-static gint
-gimp_operation_flood_process_propagate_vertical (GimpOperationFloodContext    *ctx,
-                                                 GimpOperationFloodDirtyRange *dirty_ranges)
+static void
+gimp_operation_flood_process_edges (const GimpOperationFloodContext *ctx,
+                                    gint                             column,
+                                    gint                             row,
+                                    const gfloat                    *before,
+                                    const gfloat                    *after,
+                                    gint                             width,
+                                    gint                             height)
 {
-  GimpOperationFloodDirtyRange *range = dirty_ranges;
-  gint                          x;
+  const gint top    = 1 * WATER_STRIDE + 1;
+  const gint bottom = height * WATER_STRIDE + 1;
+  gint       tile   = row * ctx->n_columns + column;
+  gint       y;
 
-  for (x = ctx->segment.x[0]; x <= ctx->segment.x[1]; x++)
+  if (row > 0 &&
+      memcmp (before + top, after + top, width * sizeof (gfloat)))
     {
-      /* Scan the segment until we find a pixel whose water level needs to be
-       * updated.
-       */
-      if (ctx->source_water[x] < ctx->water[x] &&
-          ctx->ground[x]       < ctx->water[x])
-        {
-          /* Compute and update the water level. */
-          gfloat level = MAX (ctx->source_water[x], ctx->ground[x]);
-
-          ctx->water[x] = level;
-
-          /* Start a new dirty range at the current pixel. */
-          range->x[0]     = x;
-          range->modified = FALSE;
-
-          for (x++; x <= ctx->segment.x[1]; x++)
-            {
-              /* Keep scanning the segment while the water level of consecutive
-               * pixels needs to be updated.
-               */
-              if (ctx->source_water[x] < ctx->water[x] &&
-                  ctx->ground[x]       < ctx->water[x])
-                {
-                  /* Compute and update the water level. */
-                  gfloat other_level = MAX (ctx->source_water[x],
-                                            ctx->ground[x]);
-
-                  ctx->water[x] = other_level;
-
-                  /* If the water level of the current pixel, `other_level`,
-                   * equals the water level of the current dirty range,
-                   * `level`, we keep scanning, making the current pixel part
-                   * of the current range.  On the other hand, if the current
-                   * pixel's water level is different than the that of the
-                   * current range, we finalize the range, and start a new one
-                   * at the current pixel.
-                   */
-                  if (other_level != level)
-                    {
-                      range->x[1]     = x - 1;
-                      range++;
-
-                      range->x[0]     = x;
-                      range->modified = FALSE;
-                      level           = other_level;
-                    }
-                }
-              else
-                break;
-            }
-
-          /* Finalize the current dirty range. */
-          range->x[1] = x - 1;
-          range++;
-
-          /* Make sure we don't over-increment `x` on the continuation of the
-           * loop.
-           */
-          if (x > ctx->segment.x[1])
-            break;
-        }
+      g_atomic_int_set (&ctx->dirty[tile - ctx->n_columns], TRUE);
     }
 
-  /* Return the number of dirty ranges. */
-  return range - dirty_ranges;
-}
-
-/* Performs a single pass of the horizontal propagation step of the algorithm.
- * `dir` controls the direction of the pass: either +1 for a left-to-right
- * pass, or -1 for a right-to-left pass.  The dirty ranges are passed through
- * the `dirty_ranges` array (and their number in `range_count`), and are
- * modified in-place.
- */
-static void
-gimp_operation_flood_process_propagate_horizontal (GimpOperationFloodContext    *ctx,
-                                                   gint                          dir,
-                                                   GimpOperationFloodDirtyRange *dirty_ranges,
-                                                   gint                          range_count)
-{
-  /* The index of the terminal (i.e., "`dir`-most") component of the `x[]`
-   * array of `GimpOperationFloodSegment` and `GimpOperationFloodDirtyRange`,
-   * based on the scan direction.  Equals 1 (i.e., the right component) when
-   * `dir` is +1 (i.e., left-to-right), and equals 0 (i.e., the left component)
-   * when `dir` is -1 (i.e., right-to-left).
-   */
-  gint          x_component;
-  /* One-past the final x-coordinate of the ROI, in the ROI-virtual coordinate
-   * system, based on the scan direction.  That is, the x-coordinate of the
-   * pixel to the right of the rightmost pixel, for a left-to-right scan, and
-   * of the pixel to the left of the leftmost pixel, for a right-to-left scan.
-   */
-  gint          roi_lim;
-  /* One-past the final x-coordinate of the segment, in the ROI-virtual
-   * coordinate system, based on the scan direction, in a similar fashion to
-   * `roi_lim`.
-   */
-  gint          segment_lim;
-  /* The indices of the first, and one-past-the-last dirty ranges, based on the
-   * direction of the scan.  Recall that when scanning right-to-left, we
-   * iterate over the ranges in reverse.
-   */
-  gint          first_range, last_range;
-  /* Index of the current dirty range. */
-  gint          range_index;
-  /* Image-virtual and image-physical rectangles, respectively. */
-  GeglRectangle iv_rect, ip_rect;
-
-  /* Initialize the above variables based on the scan direction. */
-  if (dir > 0)
-    {
-      /* Left-to-right. */
-      x_component = 1;
-      roi_lim     = ctx->roi.width;
-      first_range = 0;
-      last_range  = range_count;
-    }
-  else
+  if (row < ctx->n_rows - 1 &&
+      memcmp (before + bottom, after + bottom, width * sizeof (gfloat)))
     {
-      /* Right-to-left. */
-      x_component = 0;
-      roi_lim     = -1;
-      first_range = range_count - 1;
-      last_range  = -1;
+      g_atomic_int_set (&ctx->dirty[tile + ctx->n_columns], TRUE);
     }
-  segment_lim     = ctx->segment.x[x_component] + dir;
-
-  /* We loop over the dirty ranges, in the direction of the scan.  For each
-   * range, we iterate over the pixels, in the scan direction, starting at the
-   * outer edge of the range, and update the water level, considering only the
-   * water level of the previous and current pixels, until we arrive at a pixel
-   * whose water level remains the same, at which point we move to the next
-   * range, as described in the algorithm overview.
-   */
-  for (range_index  = first_range;
-       range_index != last_range;
-       range_index += dir)
-    {
-      /* Current dirty range. */
-      GimpOperationFloodDirtyRange *range;
-      /* Current pixel, in the ROI-virtual coordinate system. */
-      gint                          x;
-      /* We use `level` to compute the water level of the current pixel.  At
-       * the beginning of each iteration, it holds the water level of the
-       * previous pixel.
-       */
-      gfloat                        level;
-      /* The `inside` flag indicates whether `x` is inside the current segment.
-       * Recall that we may iterate past the bounds of the current segment, in
-       * which case we need to read the ground- and water-levels from the GEGL
-       * buffers directly, instead of the corresponding arrays.
-       */
-      gboolean                      inside;
-      /* Loop limit. */
-      gint                          lim;
-
-      range  = &dirty_ranges[range_index];
-      /* Last x-coordinate of the range, in the direction of the scan. */
-      x      = range->x[x_component];
-      /* We start iterating on the pixel after `x`; initialize `level` to the
-       * water level of the previous pixel.
-       */
-      level  = ctx->water[x];
-      /* The ranges produced by the vertical propagation step are all within
-       * the bounds of the segment; the horizontal propagation step may only
-       * extend them in the direction of the scan.  Therefore, on both passes
-       * of the horizontal propagation step, the last pixel of each range, in
-       * the direction of the scan, is initially inside the segment.
-       */
-      inside = TRUE;
-      /* If this isn't the last range, break the loop at the beginning of the
-       * next range.  Otherwise, break the loop at the edge of the ROI.
-       */
-      if (range_index + dir != last_range)
-        lim  = (range + dir)->x[1 - x_component];
-      else
-        lim  = roi_lim;
 
-      /* Loop over the pixels between the edge of the current range, and the
-       * beginning of the next range (or the edge of the ROI).
-       */
-      for (x += dir; x != lim; x += dir)
+  if (column > 0)
+    {
+      for (y = 0; y < height; y++)
         {
-          gfloat ground_level, water_level;
-
-          /* Recall that `segment_lim` is one-past the last pixel of the
-           * segment.  If we hit it, we've gone outside the segment bounds.
-           */
-          if (x == segment_lim)
-            {
-              inside         = FALSE;
-              /* Initialize the rectangle to sample pixels directly from the
-               * GEGL buffers.
-               */
-              iv_rect.y      = ctx->roi.y + ctx->segment.y;
-              iv_rect.width  = 1;
-              iv_rect.height = 1;
-            }
-
-          /* If we're inside the segment, read the ground- and water-levels
-           * from the corresponding arrays; otherwise, read them from the GEGL
-           * buffers directly.  Note that, on each pass, we may only write to
-           * pixels outside the segment *in direction of the scan* (in which
-           * case, the new values are written to the `water` array, but not
-           * directly to the output GEGL buffer), hence, when reading from the
-           * GEGL buffers, there's no danger of reading stale values, that were
-           * changed on the previous pass.
-           */
-          if (inside)
-            {
-              ground_level = ctx->ground[x];
-              water_level  = ctx->water[x];
-            }
-          else
+          if (before[top + y * WATER_STRIDE] != after[top + y * WATER_STRIDE])
             {
-              iv_rect.x = ctx->roi.x + x;
-
-              /* Transform `iv_rect` to the image-physical coordinate system,
-               * and store the result in `ip_rect`.
-               */
-              gimp_operation_flood_process_transform_rect (ctx,
-                                                           &ip_rect, &iv_rect);
-
-              /* Read the current pixel's ground level. */
-              gegl_buffer_get (ctx->input, &ip_rect, 1.0, ctx->input_format,
-                               &ground_level,
-                               GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
-              /* Read the current pixel's water level. */
-              gegl_buffer_get (ctx->output, &ip_rect, 1.0, ctx->output_format,
-                               &water_level,
-                               GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
-            }
+              g_atomic_int_set (&ctx->dirty[tile - 1], TRUE);
 
-          /* The new water level is the maximum of the current ground level,
-           * and the minimum of the current and previous water levels.  Recall
-           * that `level` holds the previous water level, and that the current
-           * water level is never less than the ground level.
-           */
-          if (level < ground_level)
-            level             = ground_level;
-          if (level < water_level)
-            {
-              /* The water level changed.  Update the current pixel, and set
-               * the `modified` flag of the current range, since it will be
-               * extended to include the current pixel.
-               */
-              ctx->water[x]   = level;
-              range->modified = TRUE;
+              break;
             }
-          else
-            /* The water level stayed the same.  Break the loop. */
-            break;
         }
+    }
 
-      /* Extend the current dirty range to include the last modified pixel, if
-       * any.
-       */
-      range->x[x_component] = x - dir;
-
-      /* If we stopped the loop before hitting the edge of the next range, or
-       * if we're at the last range, continue to the next range (or quit).
-       */
-      if (x != lim || range_index + dir == last_range)
-        continue;
-
-      /* If we hit the edge of the next range, we keep propagating the changes
-       * *inside* the next range, until we hit its other edge, or until the
-       * water level stays the same.
-       */
-      range += dir;
-      lim    = range->x[x_component] + dir;
-
-      for (; x != lim; x += dir)
+  if (column < ctx->n_columns - 1)
+    {
+      for (y = 0; y < height; y++)
         {
-          /* Note that we're necessarily inside the segment right now, since
-           * the only range that could have been extended past the edge of the
-           * segment by the previous pass, is the first range of the current
-           * pass, while the range we're currently inside is at least the
-           * second.
-           */
-          if (level < ctx->ground[x])
-            level             = ctx->ground[x];
-          if (level < ctx->water[x])
+          if (before[top + y * WATER_STRIDE + width - 1] !=
+              after[top + y * WATER_STRIDE + width - 1])
             {
-              ctx->water[x]   = level;
-              /* Set the `modified` flag of the range, since the water level of
-               * its existing pixels changed.
-               */
-              range->modified = TRUE;
+              g_atomic_int_set (&ctx->dirty[tile + 1], TRUE);
+
+              break;
             }
-          else
-            break;
         }
     }
 }
 
-/* Coalesces consecutive dirty ranges that are separated by a gap less-than or
- * equal-to `max_gap`, in-place, and returns the new number of ranges.
- */
-static gint
-gimp_operation_flood_process_coalesce (const GimpOperationFloodContext *ctx,
-                                       GimpOperationFloodDirtyRange    *dirty_ranges,
-                                       gint                             range_count,
-                                       gint                             max_gap)
+/* Lets the water settle in the tiles `ctx->tiles[offset, offset + size)`. */
+static void
+gimp_operation_flood_process_tiles (gsize                            offset,
+                                    gsize                            size,
+                                    const GimpOperationFloodContext *ctx)
 {
-  /* First and last ranges to coalesce, respectively. */
-  const GimpOperationFloodDirtyRange *first_range, *last_range;
-  /* Destination range. */
-  GimpOperationFloodDirtyRange       *range = dirty_ranges;
-
-  for (first_range  = dirty_ranges;
-       first_range != dirty_ranges + range_count;
-       first_range++)
+  const gint  water_size = WATER_STRIDE * WATER_STRIDE;
+  gfloat     *ground;
+  gfloat     *water;
+  gfloat     *initial;
+  gfloat     *previous;
+  gsize       i;
+
+  ground   = g_new  (gfloat, GIMP_OPERATION_FLOOD_TILE_SIZE *
+                             GIMP_OPERATION_FLOOD_TILE_SIZE);
+  water    = g_new  (gfloat, water_size);
+  initial  = g_new  (gfloat, water_size);
+  previous = g_new  (gfloat, water_size);
+
+  for (i = offset; i < offset + size; i++)
     {
-      /* The `modified` flag of the coalesced range -- the logical-OR of the
-       * `modified` flags of the individual ranges.
+      gint          tile   = ctx->tiles[i];
+      gint          column = tile % ctx->n_columns;
+      gint          row    = tile / ctx->n_columns;
+      GeglRectangle rect;
+      GeglRectangle border;
+      gint          width;
+      gint          height;
+
+      rect.x      = ctx->roi.x + column * GIMP_OPERATION_FLOOD_TILE_SIZE;
+      rect.y      = ctx->roi.y + row    * GIMP_OPERATION_FLOOD_TILE_SIZE;
+      rect.width  = MIN (GIMP_OPERATION_FLOOD_TILE_SIZE,
+                         ctx->roi.x + ctx->roi.width - rect.x);
+      rect.height = MIN (GIMP_OPERATION_FLOOD_TILE_SIZE,
+                         ctx->roi.y + ctx->roi.height - rect.y);
+
+      width  = rect.width;
+      height = rect.height;
+
+      /* Read the water level of the tile and its neighbors, leaving the
+       * neighbors outside the ROI at 0.
        */
-      gboolean modified = first_range->modified;
+      memset (water, 0, water_size * sizeof (gfloat));
 
-      /* Find all consecutive ranges with a small-enough gap. */
-      for (last_range      = first_range;
-           last_range + 1 != dirty_ranges + range_count;
-           last_range++)
-        {
-          if ((last_range + 1)->x[0] - last_range->x[1] > max_gap)
-            break;
-
-          modified |= (last_range + 1)->modified;
-        }
+      gegl_rectangle_intersect (&border,
+                                GEGL_RECTANGLE (rect.x - 1, rect.y - 1,
+                                                width + 2, height + 2),
+                                &ctx->roi);
 
-      /* Write the coalesced range, or copy the current range, to the
-       * destination range.
-       */
-      if (first_range != last_range || first_range != range)
-        {
-          range->x[0]     = first_range->x[0];
-          range->x[1]     = last_range->x[1];
-          range->modified = modified;
-        }
+      gegl_buffer_get (ctx->output, &border, 1.0, ctx->output_format,
+                       water + (border.y - (rect.y - 1)) * WATER_STRIDE +
+                               (border.x - (rect.x - 1)),
+                       WATER_STRIDE * sizeof (gfloat), GEGL_ABYSS_NONE);
 
-      first_range = last_range;
-      range++;
-    }
+      gegl_buffer_get (ctx->input, &rect, 1.0, ctx->input_format,
+                       ground,
+                       GIMP_OPERATION_FLOOD_TILE_SIZE * sizeof (gfloat),
+                       GEGL_ABYSS_NONE);
 
-  /* Return the new range count. */
-  return range - dirty_ranges;
-}
+      memcpy (initial, water, water_size * sizeof (gfloat));
 
-/* Writes the updated water level of the dirty ranges back to the output GEGL
- * buffer.
- */
-static void
-gimp_operation_flood_process_commit (const GimpOperationFloodContext    *ctx,
-                                     const GimpOperationFloodDirtyRange *dirty_ranges,
-                                     gint                                range_count)
-{
-  const GimpOperationFloodDirtyRange *range;
-  /* Image-virtual and image-physical rectangles, respectively. */
-  GeglRectangle                       iv_rect, ip_rect;
+      /* Scan the tile back and forth, until the water settles. */
+      do
+        {
+          memcpy (previous, water, water_size * sizeof (gfloat));
 
-  /* Set the vertical extent of the rectangle to span a the current segment's
-   * row.
-   */
-  iv_rect.y      = ctx->roi.y + ctx->segment.y;
-  iv_rect.height = 1;
+          gimp_operation_flood_process_scan (ground, water, width, height, +1);
+          gimp_operation_flood_process_scan (ground, water, width, height, -1);
+        }
+      while (memcmp (previous, water, water_size * sizeof (gfloat)));
 
-  for (range = dirty_ranges; range != dirty_ranges + range_count; range++)
-    {
-      /* Set the horizontal extent of the rectangle to span the dirty range. */
-      iv_rect.x     = ctx->roi.x + range->x[0];
-      iv_rect.width = range->x[1] - range->x[0] + 1;
+      if (! memcmp (initial, water, water_size * sizeof (gfloat)))
+        continue;
 
-      /* Transform `iv_rect` to the image-physical coordinate system, and store
-       * the result in `ip_rect`.
-       */
-      gimp_operation_flood_process_transform_rect (ctx, &ip_rect, &iv_rect);
+      gimp_operation_flood_process_edges (ctx, column, row, initial, water,
+                                          width, height);
 
-      /* Write the updated water level to the output GEGL buffer. */
-      gegl_buffer_set (ctx->output, &ip_rect, 0, ctx->output_format,
-                       ctx->water + range->x[0],
-                       GEGL_AUTO_ROWSTRIDE);
+      gegl_buffer_set (ctx->output, &rect, 0, ctx->output_format,
+                       water + WATER_STRIDE + 1,
+                       WATER_STRIDE * sizeof (gfloat));
     }
-}
 
-/* Pushes the new segments, corresponding to the dirty ranges of the current
- * segment, into the queue.
- */
-static void
-gimp_operation_flood_process_distribute (const GimpOperationFloodContext    *ctx,
-                                         GQueue                             *queue,
-                                         const GimpOperationFloodDirtyRange *dirty_ranges,
-                                         gint                                range_count)
-{
-  const GimpOperationFloodDirtyRange *range;
-  static const gint                   y_deltas[] = {-1, +1};
-  gint                                i;
-
-  /* For each neighboring row... */
-  for (i = 0; i < G_N_ELEMENTS (y_deltas); i++)
-    {
-      /* The difference between the negihboring row's y-coordinate and the
-       * current row's y-corindate, in the ROI-virtual coordinate system.
-       */
-      gint y_delta = y_deltas[i];
-      /* The negihboring row's y-coordinate in the ROI-virtual coordinate
-       * system.
-       */
-      gint y = ctx->segment.y + y_delta;
-
-      /* If the neighboring row is outside the ROI, skip it. */
-      if (y < 0 || y >= ctx->roi.height)
-        continue;
-
-      /* For each dirty range... */
-      for (range = dirty_ranges; range != dirty_ranges + range_count; range++)
-        {
-          /* If the range was modified during horizontal propagation, or if the
-           * neighboring row is not the source segment's row... (note that the
-           * latter is always true for seed segments.)
-           */
-          if (range->modified || y_delta != ctx->segment.source_y_delta)
-            {
-              /* Push a new segment into the queue, spanning the same pixels as
-               * the dirty range on the neighboring row, using the current row
-               * as its source segment.
-               */
-              gimp_operation_flood_process_push (queue,
-                                                 ctx->segment.transpose,
-                                                 y,
-                                                 -y_delta,
-                                                 range->x[0],
-                                                 range->x[1]);
-            }
-        }
-    }
+  g_free (previous);
+  g_free (initial);
+  g_free (water);
+  g_free (ground);
 }
 
-/* Main algorithm. */
 static gboolean
 gimp_operation_flood_process (GeglOperation       *operation,
                               GeglBuffer          *input,
@@ -994,111 +413,97 @@ gimp_operation_flood_process (GeglOperation       *operation,
                               const GeglRectangle *roi,
                               gint                 level)
 {
-  const Babl                   *input_format  = gegl_operation_get_format (operation, "input");
-  const Babl                   *output_format = gegl_operation_get_format (operation, "output");
-  GeglColor                    *color;
-  gint                          max_size;
-  GimpOperationFloodContext     ctx;
-  GimpOperationFloodDirtyRange *dirty_ranges;
-  GQueue                       *queue;
-
-  /* Make sure the input- and output-buffers are different. */
+  const Babl                *input_format  = gegl_operation_get_format (operation, "input");
+  const Babl                *output_format = gegl_operation_get_format (operation, "output");
+  GeglColor                 *color;
+  GimpOperationFloodContext  ctx;
+  gint                      *tiles;
+  gint                       n_tiles;
+  gint                       tile;
+  gboolean                   done;
+
   g_return_val_if_fail (input != output, FALSE);
 
-  /* Make sure the ROI is small enough for the `GimpOperationFloodSegment::y`
-   * field.
-   */
-  g_return_val_if_fail (roi->width  <= GIMP_MAX_IMAGE_SIZE &&
-                        roi->height <= GIMP_MAX_IMAGE_SIZE, FALSE);
+  if (roi->width <= 0 || roi->height <= 0)
+    return TRUE;
 
   ctx.input         = input;
   ctx.input_format  = input_format;
   ctx.output        = output;
   ctx.output_format = output_format;
+  ctx.roi           = *roi;
 
-  /* All buffers need to have enough capacity to process a full row, or a full
-   * column, since, when processing vertical segments, we treat the image as
-   * transposed.
-   */
-  max_size          = MAX (roi->width, roi->height);
-  ctx.ground        = g_new (gfloat, max_size);
-  /* The `water_buffer` array needs to be able to hold two rows (or columns). */
-  ctx.water_buffer  = g_new (gfloat, 2 * max_size);
-  dirty_ranges      = g_new (GimpOperationFloodDirtyRange, max_size);
+  ctx.n_columns     = (roi->width  + GIMP_OPERATION_FLOOD_TILE_SIZE - 1) /
+                      GIMP_OPERATION_FLOOD_TILE_SIZE;
+  ctx.n_rows        = (roi->height + GIMP_OPERATION_FLOOD_TILE_SIZE - 1) /
+                      GIMP_OPERATION_FLOOD_TILE_SIZE;
+  n_tiles           = ctx.n_columns * ctx.n_rows;
+
+  ctx.dirty         = g_new0 (gint, n_tiles);
+  tiles             = g_new  (gint, n_tiles);
+  ctx.tiles         = tiles;
 
-  /* Initialize the water level to 1 everywhere. */
+  /* Initialize the water level to 1 everywhere, and let it drain from the
+   * edges of the ROI, which are the only tiles that can initially change.
+   */
   color = gegl_color_new ("#fff");
   gegl_buffer_set_color (output, roi, color);
   g_object_unref (color);
 
-  /* Create the queue and push the seed segments. */
-  queue  = g_queue_new ();
-  gimp_operation_flood_process_seed (queue, roi);
+  for (tile = 0; tile < n_tiles; tile++)
+    {
+      gint column = tile % ctx.n_columns;
+      gint row    = tile / ctx.n_columns;
+
+      if (row    == 0 || row    == ctx.n_rows    - 1 ||
+          column == 0 || column == ctx.n_columns - 1)
+        {
+          ctx.dirty[tile] = TRUE;
+        }
+    }
 
-  /* While there are segments to process in the queue... */
-  while (! g_queue_is_empty (queue))
+  do
     {
-      GimpOperationFloodSegment *segment;
-      gint                       range_count;
+      gint phase;
 
-      /* Pop a segment off the top of the queue, copy it to `ctx.segment`, and
-       * free its memory.
-       */
-      segment     = (GimpOperationFloodSegment *) g_queue_pop_head (queue);
-      ctx.segment = *segment;
-      g_slice_free (GimpOperationFloodSegment, segment);
+      done = TRUE;
 
-      /* Transform the ROI from the image-physical coordinate system to the
-       * image-virtual coordinate system, and store the result in `ctx.roi`.
-       */
-      gimp_operation_flood_process_transform_rect (&ctx, &ctx.roi, roi);
+      for (phase = 0; phase < 2; phase++)
+        {
+          gint count = 0;
 
-      /* Read the ground- and water-levels of the current- and source-segments
-       * from the corresponding GEGL buffers to the corresponding arrays.
-       */
-      gimp_operation_flood_process_fetch (&ctx);
-
-      /* Perform the vertical propagation step. */
-      range_count = gimp_operation_flood_process_propagate_vertical (&ctx,
-                                                                     dirty_ranges);
-      /* If no dirty ranges were produced during vertical propagation, then the
-       * water level of the current segment didn't change, and we can short-
-       * circuit early.
-       */
-      if (range_count == 0)
-        continue;
+          /* Collect the dirty tiles of the current phase.  Their neighbors
+           * all belong to the other phase, so only the other phase's flags
+           * are set while processing them.
+           */
+          for (tile = 0; tile < n_tiles; tile++)
+            {
+              gint column = tile % ctx.n_columns;
+              gint row    = tile / ctx.n_columns;
 
-      /* Perform both passes of the horizontal propagation step. */
-      gimp_operation_flood_process_propagate_horizontal (&ctx,
-                                                         /* Left-to-right */ +1,
-                                                         dirty_ranges,
-                                                         range_count);
-      gimp_operation_flood_process_propagate_horizontal (&ctx,
-                                                         /* Right-to-left */ -1,
-                                                         dirty_ranges,
-                                                         range_count);
-
-      /* Coalesce consecutive dirty ranges separated by a gap less-than or
-       * equal-to `GIMP_OPERATION_FLOOD_COALESCE_MAX_GAP`.
-       */
-      range_count = gimp_operation_flood_process_coalesce (&ctx,
-                                                           dirty_ranges,
-                                                           range_count,
-                                                           GIMP_OPERATION_FLOOD_COALESCE_MAX_GAP);
+              if (ctx.dirty[tile] && ((column + row) & 1) == phase)
+                {
+                  ctx.dirty[tile] = FALSE;
 
-      /* Write the updated water level back to the output GEGL buffer. */
-      gimp_operation_flood_process_commit (&ctx, dirty_ranges, range_count);
+                  tiles[count++] = tile;
+                }
+            }
 
-      /* Push the new segments into the queue. */
-      gimp_operation_flood_process_distribute (&ctx, queue,
-                                               dirty_ranges, range_count);
-    }
+          if (count == 0)
+            continue;
 
-  g_queue_free (queue);
+          done = FALSE;
+
+          gegl_parallel_distribute_range (
+            count, GIMP_OPERATION_FLOOD_TILES_PER_THREAD,
+            (GeglParallelDistributeRangeFunc) gimp_operation_flood_process_tiles,
+            &ctx);
+        }
+    }
+  while (! done);
 
-  g_free (dirty_ranges);
-  g_free (ctx.water_buffer);
-  g_free (ctx.ground);
+  g_free (tiles);
+  g_free (ctx.dirty);
 
   return TRUE;
 }
@@ -75,6 +75,7 @@ typedef struct
   gdouble                      vec[2];
   GimpRepeatMode               repeat;
   GeglSampler                 *dist_sampler;
+  const gfloat                *dist_data;
 } RenderBlendData;
 
 
@@ -138,15 +139,15 @@ static gdouble         gradient_calc_spiral_factor               (gdouble
                                                                   gdouble                y,
                                                                   gboolean               clockwise);
 
-static gdouble         gradient_calc_shapeburst_angular_factor   (GeglSampler           *dist_sampler,
+static gdouble         gradient_calc_shapeburst_angular_factor   (RenderBlendData       *rbd,
                                                                   gdouble                offset,
                                                                   gdouble                x,
                                                                   gdouble                y);
-static gdouble         gradient_calc_shapeburst_spherical_factor (GeglSampler           *dist_sampler,
+static gdouble         gradient_calc_shapeburst_spherical_factor (RenderBlendData       *rbd,
                                                                   gdouble                offset,
                                                                   gdouble                x,
                                                                   gdouble                y);
-static gdouble         gradient_calc_shapeburst_dimpled_factor   (GeglSampler           *dist_sampler,
+static gdouble         gradient_calc_shapeburst_dimpled_factor   (RenderBlendData       *rbd,
                                                                   gdouble                offset,
                                                                   gdouble                x,
                                                                   gdouble                y);
@@ -800,17 +801,35 @@ gradient_calc_spiral_factor (gdouble   dist,
     }
 }
 
+/*  when rendering without supersampling, the distances are read along with
+ *  the output, instead of through the sampler
+ */
+static inline gfloat
+gradient_get_shapeburst_dist (RenderBlendData *rbd,
+                              gdouble          x,
+                              gdouble          y)
+{
+  gfloat value;
+
+  if (rbd->dist_data)
+    return *rbd->dist_data;
+
+  gegl_sampler_get (rbd->dist_sampler, x, y, NULL, &value, GEGL_ABYSS_NONE);
+
+  return value;
+}
+
 static gdouble
-gradient_calc_shapeburst_angular_factor (GeglSampler *dist_sampler,
-                                         gdouble      offset,
-                                         gdouble      x,
-                                         gdouble      y)
+gradient_calc_shapeburst_angular_factor (RenderBlendData *rbd,
+                                         gdouble          offset,
+                                         gdouble          x,
+                                         gdouble          y)
 {
   gfloat value;
 
   offset = offset / 100.0;
 
-  gegl_sampler_get (dist_sampler, x, y, NULL, &value, GEGL_ABYSS_NONE);
+  value = gradient_get_shapeburst_dist (rbd, x, y);
 
   value = 1.0 - value;
 
@@ -826,16 +845,16 @@ gradient_calc_shapeburst_angular_factor (GeglSampler *dist_sampler,
 
 
 static gdouble
-gradient_calc_shapeburst_spherical_factor (GeglSampler *dist_sampler,
-                                           gdouble      offset,
-                                           gdouble      x,
-                                           gdouble      y)
+gradient_calc_shapeburst_spherical_factor (RenderBlendData *rbd,
+                                           gdouble          offset,
+                                           gdouble          x,
+                                           gdouble          y)
 {
   gfloat value;
 
   offset = 1.0 - offset / 100.0;
 
-  gegl_sampler_get (dist_sampler, x, y, NULL, &value, GEGL_ABYSS_NONE);
+  value = gradient_get_shapeburst_dist (rbd, x, y);
 
   if (value > offset)
     value = 1.0;
@@ -851,16 +870,16 @@ gradient_calc_shapeburst_spherical_factor (GeglSampler *dist_sampler,
 
 
 static gdouble
-gradient_calc_shapeburst_dimpled_factor (GeglSampler *dist_sampler,
-                                         gdouble      offset,
-                                         gdouble      x,
-                                         gdouble      y)
+gradient_calc_shapeburst_dimpled_factor (RenderBlendData *rbd,
+                                         gdouble          offset,
+                                         gdouble          x,
+                                         gdouble          y)
 {
   gfloat value;
 
   offset = 1.0 - offset / 100.0;
 
-  gegl_sampler_get (dist_sampler, x, y, NULL, &value, GEGL_ABYSS_NONE);
+  value = gradient_get_shapeburst_dist (rbd, x, y);
 
   if (value > offset)
     value = 1.0;
@@ -927,19 +946,19 @@ gradient_render_pixel (gdouble   x,
       break;
 
     case GIMP_GRADIENT_SHAPEBURST_ANGULAR:
-      factor = gradient_calc_shapeburst_angular_factor (rbd->dist_sampler,
+      factor = gradient_calc_shapeburst_angular_factor (rbd,
                                                         rbd->offset,
                                                         x, y);
       break;
 
     case GIMP_GRADIENT_SHAPEBURST_SPHERICAL:
-      factor = gradient_calc_shapeburst_spherical_factor (rbd->dist_sampler,
+      factor = gradient_calc_shapeburst_spherical_factor (rbd,
                                                           rbd->offset,
                                                           x, y);
       break;
 
     case GIMP_GRADIENT_SHAPEBURST_DIMPLED:
-      factor = gradient_calc_shapeburst_dimpled_factor (rbd->dist_sampler,
+      factor = gradient_calc_shapeburst_dimpled_factor (rbd,
                                                         rbd->offset,
                                                         x, y);
       break;
@@ -1149,9 +1168,16 @@ gimp_operation_gradient_process (GeglOperation       *operation,
 
   iter = gegl_buffer_iterator_new (output, result, 0,
                                    babl_format ("R'G'B'A float"),
-                                   GEGL_ACCESS_WRITE, GEGL_ABYSS_NONE, 1);
+                                   GEGL_ACCESS_WRITE, GEGL_ABYSS_NONE, 2);
   roi = &iter->items[0].roi;
 
+  if (rbd.dist_sampler && ! self->supersample)
+    {
+      gegl_buffer_iterator_add (iter, input, result, level,
+                                babl_format ("Y float"),
+                                GEGL_ACCESS_READ, GEGL_ABYSS_NONE);
+    }
+
   if (self->dither)
     dither_rand = g_rand_new ();
 
@@ -1186,6 +1212,9 @@ gimp_operation_gradient_process (GeglOperation       *operation,
           gint    endy = roi->y + roi->height;
           gint    x, y;
 
+          if (rbd.dist_sampler)
+            rbd.dist_data = iter->items[1].data;
+
           if (dither_rand)
             {
               for (y = roi->y; y < endy; y++)
@@ -1197,6 +1226,9 @@ gimp_operation_gradient_process (GeglOperation       *operation,
                     gradient_dither_pixel (&color, dither_rand, dest);
 
                     dest += 4;
+
+                    if (rbd.dist_data)
+                      rbd.dist_data++;
                   }
             }
           else
@@ -1212,6 +1244,9 @@ gimp_operation_gradient_process (GeglOperation       *operation,
                     *dest++ = color.g;
                     *dest++ = color.b;
                     *dest++ = color.a;
+
+                    if (rbd.dist_data)
+                      rbd.dist_data++;
                   }
             }
         }
@@ -29,6 +29,7 @@
 
 #include "operations-types.h"
 
+#include "gimp-operation-morphology.h"
 #include "gimpoperationgrow.h"
 
 
@@ -247,6 +248,11 @@ gimp_operation_grow_process (GeglOperation       *operation,
   gint16             last_index;
   gfloat            *buffer;
 
+  if (gimp_operation_morphology_dilate (input, output, roi, output_format,
+                                        self->radius_x, self->radius_y,
+                                        FALSE, FALSE))
+    return TRUE;
+
   max = g_new (gfloat *, roi->width + 2 * self->radius_x);
   buf = g_new (gfloat *, self->radius_y + 1);
 
@@ -332,6 +332,49 @@ gimp_operation_offset_parent_process (GeglOperation        *operation,
 
       return TRUE;
     }
+  else if (offset->type == GIMP_OFFSET_WRAP_AROUND && input)
+    {
+      GeglBuffer *output;
+      gint        shift_x;
+      gint        shift_y;
+      gint        tile_width;
+      gint        tile_height;
+
+      /*  align the output's tile grid with the input's, moved by the
+       *  offset, so that the bulk of the input is shared copy-on-write,
+       *  tile by tile, instead of copied pixel by pixel.  the parts that
+       *  wrap around are only aligned if the bounds are tile-aligned as
+       *  well.
+       */
+      g_object_get (input,
+                    "shift-x",     &shift_x,
+                    "shift-y",     &shift_y,
+                    "tile-width",  &tile_width,
+                    "tile-height", &tile_height,
+                    NULL);
+
+      output = g_object_new (GEGL_TYPE_BUFFER,
+                             "format",      gegl_buffer_get_format (
+                                              GEGL_BUFFER (input)),
+                             "x",           result->x,
+                             "y",           result->y,
+                             "width",       result->width,
+                             "height",      result->height,
+                             "shift-x",     shift_x - x,
+                             "shift-y",     shift_y - y,
+                             "tile-width",  tile_width,
+                             "tile-height", tile_height,
+                             NULL);
+
+      gimp_operation_offset_process (operation,
+                                     GEGL_BUFFER (input), output,
+                                     result, level);
+
+      gegl_operation_context_take_object (context, "output",
+                                          G_OBJECT (output));
+
+      return TRUE;
+    }
 
   return GEGL_OPERATION_CLASS (parent_class)->process (operation, context,
                                                        output_pad, result,
@@ -20,6 +20,8 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include <gegl.h>
 
 #include "operations-types.h"
@@ -140,3 +142,65 @@ gimp_operation_point_filter_prepare (GeglOperation *operation)
   gegl_operation_set_format (operation, "input",  format);
   gegl_operation_set_format (operation, "output", format);
 }
+
+
+/*  public functions  */
+
+/*  to be called by subclasses' prepare(), after chaining up.  if the
+ *  input is 8-bit and already in the TRC the filter operates on, it is
+ *  processed in that format, as RGBA u8, instead of being converted to
+ *  float and back.  returns whether this is the case, and process()
+ *  can then check the input format to pick its 8-bit path.
+ */
+gboolean
+gimp_operation_point_filter_prepare_u8 (GeglOperation *operation)
+{
+  static const gchar *models[][4] =
+  {
+    [GIMP_TRC_LINEAR]     = { "RGBA",    "RGB",    "YA",  "Y"  },
+    [GIMP_TRC_NON_LINEAR] = { "R'G'B'A", "R'G'B'", "Y'A", "Y'" },
+    [GIMP_TRC_PERCEPTUAL] = { "R~G~B~A", "R~G~B~", "Y~A", "Y~" }
+  };
+  static const gchar *u8_formats[] =
+  {
+    [GIMP_TRC_LINEAR]     = "RGBA u8",
+    [GIMP_TRC_NON_LINEAR] = "R'G'B'A u8",
+    [GIMP_TRC_PERCEPTUAL] = "R~G~B~A u8"
+  };
+  GimpOperationPointFilter *self;
+  const Babl               *source_format;
+  const gchar              *name;
+  gint                      i;
+
+  g_return_val_if_fail (GIMP_IS_OPERATION_POINT_FILTER (operation), FALSE);
+
+  self          = GIMP_OPERATION_POINT_FILTER (operation);
+  source_format = gegl_operation_get_source_format (operation, "input");
+
+  if (! source_format                                           ||
+      babl_format_get_type (source_format, 0) != babl_type ("u8") ||
+      (guint) self->trc >= G_N_ELEMENTS (models))
+    {
+      return FALSE;
+    }
+
+  name = babl_get_name (babl_format_get_model (source_format));
+
+  for (i = 0; i < G_N_ELEMENTS (models[self->trc]); i++)
+    {
+      if (! strcmp (name, models[self->trc][i]))
+        {
+          const Babl *space  = gegl_operation_get_source_space (operation,
+                                                                "input");
+          const Babl *format = babl_format_with_space (u8_formats[self->trc],
+                                                       space);
+
+          gegl_operation_set_format (operation, "input",  format);
+          gegl_operation_set_format (operation, "output", format);
+
+          return TRUE;
+        }
+    }
+
+  return FALSE;
+}
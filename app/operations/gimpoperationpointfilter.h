@@ -69,5 +69,7 @@ void    gimp_operation_point_filter_set_property (GObject      *object,
                                                   const GValue *value,
                                                   GParamSpec   *pspec);
 
+gboolean gimp_operation_point_filter_prepare_u8  (GeglOperation *operation);
+
 
 #endif /* __GIMP_OPERATION_POINT_FILTER_H__ */
@@ -29,6 +29,7 @@
 
 #include "operations-types.h"
 
+#include "gimp-operation-morphology.h"
 #include "gimpoperationshrink.h"
 
 
@@ -269,6 +270,11 @@ gimp_operation_shrink_process (GeglOperation       *operation,
   gfloat              *buffer;
   gint                 buffer_size;
 
+  if (gimp_operation_morphology_dilate (input, output, roi, output_format,
+                                        self->radius_x, self->radius_y,
+                                        TRUE, ! self->edge_lock))
+    return TRUE;
+
   max = g_new (gfloat *, roi->width + 2 * self->radius_x);
   buf = g_new (gfloat *, self->radius_y + 1);
 
@@ -24,12 +24,15 @@
 #include <glib-object.h>
 #include <gegl.h>
 
+#include "libgimpbase/gimpbase.h"
+
 #include "../operations-types.h"
 
 #include "gegl/gimp-babl.h"
 
 #include "gimpoperationlayermode.h"
 #include "gimpoperationlayermode-blend.h"
+#include "gimpoperationlayermode-fused.h"
 
 #include "gimp-layer-modes.h"
 
@@ -1110,6 +1113,58 @@ static const GimpLayerMode layer_mode_groups[][2] =
   }
 };
 
+#if COMPILE_AVX2_INTRINISICS
+static const struct
+{
+  GimpLayerModeBlendFunc blend_function;
+  GimpLayerModeBlendFunc blend_function_avx2;
+} layer_mode_blend_functions_avx2[] =
+{
+  { gimp_operation_layer_mode_blend_addition,
+    gimp_operation_layer_mode_blend_addition_avx2 },
+  { gimp_operation_layer_mode_blend_burn,
+    gimp_operation_layer_mode_blend_burn_avx2 },
+  { gimp_operation_layer_mode_blend_darken_only,
+    gimp_operation_layer_mode_blend_darken_only_avx2 },
+  { gimp_operation_layer_mode_blend_difference,
+    gimp_operation_layer_mode_blend_difference_avx2 },
+  { gimp_operation_layer_mode_blend_divide,
+    gimp_operation_layer_mode_blend_divide_avx2 },
+  { gimp_operation_layer_mode_blend_dodge,
+    gimp_operation_layer_mode_blend_dodge_avx2 },
+  { gimp_operation_layer_mode_blend_exclusion,
+    gimp_operation_layer_mode_blend_exclusion_avx2 },
+  { gimp_operation_layer_mode_blend_grain_extract,
+    gimp_operation_layer_mode_blend_grain_extract_avx2 },
+  { gimp_operation_layer_mode_blend_grain_merge,
+    gimp_operation_layer_mode_blend_grain_merge_avx2 },
+  { gimp_operation_layer_mode_blend_hard_mix,
+    gimp_operation_layer_mode_blend_hard_mix_avx2 },
+  { gimp_operation_layer_mode_blend_hardlight,
+    gimp_operation_layer_mode_blend_hardlight_avx2 },
+  { gimp_operation_layer_mode_blend_lighten_only,
+    gimp_operation_layer_mode_blend_lighten_only_avx2 },
+  { gimp_operation_layer_mode_blend_linear_burn,
+    gimp_operation_layer_mode_blend_linear_burn_avx2 },
+  { gimp_operation_layer_mode_blend_linear_light,
+    gimp_operation_layer_mode_blend_linear_light_avx2 },
+  { gimp_operation_layer_mode_blend_multiply,
+    gimp_operation_layer_mode_blend_multiply_avx2 },
+  { gimp_operation_layer_mode_blend_overlay,
+    gimp_operation_layer_mode_blend_overlay_avx2 },
+  { gimp_operation_layer_mode_blend_pin_light,
+    gimp_operation_layer_mode_blend_pin_light_avx2 },
+  { gimp_operation_layer_mode_blend_screen,
+    gimp_operation_layer_mode_blend_screen_avx2 },
+  { gimp_operation_layer_mode_blend_softlight,
+    gimp_operation_layer_mode_blend_softlight_avx2 },
+  { gimp_operation_layer_mode_blend_subtract,
+    gimp_operation_layer_mode_blend_subtract_avx2 },
+  { gimp_operation_layer_mode_blend_vivid_light,
+    gimp_operation_layer_mode_blend_vivid_light_avx2 }
+};
+#endif /* COMPILE_AVX2_INTRINISICS */
+
 static GeglOperation *ops[G_N_ELEMENTS (layer_mode_infos)] = { 0 };
 
 /*  public functions  */
@@ -1326,6 +1381,8 @@ gimp_layer_mode_get_operation (GimpLayerMode mode)
           layer_mode->blend_space     = gimp_layer_mode_get_blend_space (mode);
           layer_mode->composite_space = gimp_layer_mode_get_composite_space (mode);
           layer_mode->composite_mode  = gimp_layer_mode_get_paint_composite_mode (mode);
+          layer_mode->fused_function  = gimp_layer_mode_get_fused_function (mode,
+                                                                            layer_mode->composite_mode);
         }
     }
 
@@ -1350,9 +1407,38 @@ gimp_layer_mode_get_blend_function (GimpLayerMode mode)
   if (! info)
     return NULL;
 
+#if COMPILE_AVX2_INTRINISICS
+  if (gimp_cpu_accel_get_support () & GIMP_CPU_ACCEL_X86_AVX2)
+    {
+      gint i;
+
+      for (i = 0; i < G_N_ELEMENTS (layer_mode_blend_functions_avx2); i++)
+        {
+          if (layer_mode_blend_functions_avx2[i].blend_function ==
+              info->blend_function)
+            {
+              return layer_mode_blend_functions_avx2[i].blend_function_avx2;
+            }
+        }
+    }
+#endif /* COMPILE_AVX2_INTRINISICS */
+
   return info->blend_function;
 }
 
+GimpLayerModeFusedFunc
+gimp_layer_mode_get_fused_function (GimpLayerMode          mode,
+                                    GimpLayerCompositeMode composite_mode)
+{
+  const GimpLayerModeInfo *info = gimp_layer_mode_info (mode);
+
+  if (! info || ! info->blend_function)
+    return NULL;
+
+  return gimp_operation_layer_mode_get_fused_function (info->blend_function,
+                                                       composite_mode);
+}
+
 GimpLayerModeContext
 gimp_layer_mode_get_context (GimpLayerMode mode)
 {
@@ -26,6 +26,8 @@
 void                       gimp_layer_modes_init                      (void);
 void                       gimp_layer_modes_exit                      (void);
 
+gint                       gimp_layer_modes_get_n_shortcuts           (void);
+
 gboolean                   gimp_layer_mode_is_legacy                  (GimpLayerMode           mode);
 
 gboolean                   gimp_layer_mode_is_blend_space_mutable     (GimpLayerMode           mode);
@@ -46,6 +48,8 @@ GeglOperation            * gimp_layer_mode_get_operation              (GimpLayer
 
 GimpLayerModeFunc          gimp_layer_mode_get_function               (GimpLayerMode           mode);
 GimpLayerModeBlendFunc     gimp_layer_mode_get_blend_function         (GimpLayerMode           mode);
+GimpLayerModeFusedFunc     gimp_layer_mode_get_fused_function         (GimpLayerMode           mode,
+                                                                       GimpLayerCompositeMode  composite_mode);
 
 GimpLayerModeContext       gimp_layer_mode_get_context                (GimpLayerMode           mode);
 
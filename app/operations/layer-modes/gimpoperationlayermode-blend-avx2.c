@@ -0,0 +1,244 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimpoperationlayermode-blend-avx2.c
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <gegl-plugin.h>
+#include <cairo.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+
+#include "../operations-types.h"
+
+#include "gimpoperationlayermode-blend.h"
+
+
+#if COMPILE_AVX2_INTRINISICS
+
+/* AVX2 */
+#include <immintrin.h>
+
+
+#define EPSILON      1e-6f
+
+#define SAFE_DIV_MIN EPSILON
+#define SAFE_DIV_MAX (1.0f / SAFE_DIV_MIN)
+
+
+/*  the blend functions below process two pixels per iteration, using the same
+ *  arithmetic as their scalar counterparts, and defer to the scalar functions
+ *  for the last odd pixel.  since the value of comp[RED..BLUE] is
+ *  unconstrained when in[ALPHA] or layer[ALPHA] are zero, the color
+ *  components are computed unconditionally, and comp[ALPHA] is taken from
+ *  layer[ALPHA].
+ */
+#define DEFINE_BLEND_FUNCTION(name, ...)                                       \
+void                                                                           \
+gimp_operation_layer_mode_blend_##name##_avx2 (GeglOperation *operation,       \
+                                               const gfloat  *in,              \
+                                               const gfloat  *layer,           \
+                                               gfloat        *comp,            \
+                                               gint           samples)         \
+{                                                                              \
+  const __m256 v_zero = _mm256_setzero_ps ();                                  \
+  const __m256 v_half = _mm256_set1_ps (0.5f);                                 \
+  const __m256 v_one  = _mm256_set1_ps (1.0f);                                 \
+  const __m256 v_two  = _mm256_set1_ps (2.0f);                                 \
+                                                                               \
+  (void) v_zero;                                                               \
+  (void) v_half;                                                               \
+  (void) v_one;                                                                \
+  (void) v_two;                                                                \
+                                                                               \
+  for (; samples >= 2; samples -= 2)                                           \
+    {                                                                          \
+      const __m256 a = _mm256_loadu_ps (in);                                   \
+      const __m256 b = _mm256_loadu_ps (layer);                                \
+      __m256       c;                                                          \
+                                                                               \
+      __VA_ARGS__;                                                             \
+                                                                               \
+      _mm256_storeu_ps (comp, _mm256_blend_ps (c, b, 0x88));                   \
+                                                                               \
+      in    += 8;                                                              \
+      layer += 8;                                                              \
+      comp  += 8;                                                              \
+    }                                                                          \
+                                                                               \
+  if (samples)                                                                 \
+    {                                                                          \
+      gimp_operation_layer_mode_blend_##name (operation, in, layer, comp,      \
+                                              samples);                        \
+    }                                                                          \
+}
+
+
+/*  local function prototypes  */
+
+static inline __m256   safe_div (__m256 a,
+                                 __m256 b);
+
+
+/*  private functions  */
+
+
+/* returns a / b, clamped to [-SAFE_DIV_MAX, SAFE_DIV_MAX].
+ * if -SAFE_DIV_MIN <= a <= SAFE_DIV_MIN, returns 0.
+ */
+static inline __m256
+safe_div (__m256 a,
+          __m256 b)
+{
+  const __m256 v_abs_mask = _mm256_castsi256_ps (_mm256_set1_epi32 (0x7fffffff));
+  __m256       result;
+  __m256       valid;
+
+  valid  = _mm256_cmp_ps (_mm256_and_ps (a, v_abs_mask),
+                          _mm256_set1_ps (SAFE_DIV_MIN), _CMP_GT_OQ);
+
+  result = _mm256_div_ps (a, b);
+  result = _mm256_min_ps (result, _mm256_set1_ps (SAFE_DIV_MAX));
+  result = _mm256_max_ps (result, _mm256_set1_ps (-SAFE_DIV_MAX));
+
+  return _mm256_and_ps (result, valid);
+}
+
+
+/*  public functions  */
+
+
+DEFINE_BLEND_FUNCTION (addition,
+  c = _mm256_add_ps (a, b))
+
+DEFINE_BLEND_FUNCTION (burn,
+  c = _mm256_sub_ps (v_one, safe_div (_mm256_sub_ps (v_one, a), b)))
+
+DEFINE_BLEND_FUNCTION (darken_only,
+  c = _mm256_min_ps (a, b))
+
+DEFINE_BLEND_FUNCTION (difference,
+  c = _mm256_andnot_ps (_mm256_set1_ps (-0.0f), _mm256_sub_ps (a, b)))
+
+DEFINE_BLEND_FUNCTION (divide,
+  c = safe_div (a, b))
+
+DEFINE_BLEND_FUNCTION (dodge,
+  c = safe_div (a, _mm256_sub_ps (v_one, b)))
+
+DEFINE_BLEND_FUNCTION (exclusion,
+  c = _mm256_sub_ps (v_half,
+                     _mm256_mul_ps (_mm256_mul_ps (v_two,
+                                                   _mm256_sub_ps (a, v_half)),
+                                    _mm256_sub_ps (b, v_half))))
+
+DEFINE_BLEND_FUNCTION (grain_extract,
+  c = _mm256_add_ps (_mm256_sub_ps (a, b), v_half))
+
+DEFINE_BLEND_FUNCTION (grain_merge,
+  c = _mm256_sub_ps (_mm256_add_ps (a, b), v_half))
+
+DEFINE_BLEND_FUNCTION (hard_mix,
+  c = _mm256_and_ps (_mm256_cmp_ps (_mm256_add_ps (a, b), v_one, _CMP_NLT_UQ),
+                     v_one))
+
+DEFINE_BLEND_FUNCTION (hardlight,
+  __m256 high;
+  __m256 low;
+
+  high = _mm256_mul_ps (_mm256_sub_ps (v_one, a),
+                        _mm256_sub_ps (v_one,
+                                       _mm256_mul_ps (_mm256_sub_ps (b, v_half),
+                                                      v_two)));
+  high = _mm256_min_ps (_mm256_sub_ps (v_one, high), v_one);
+
+  low  = _mm256_mul_ps (a, _mm256_mul_ps (b, v_two));
+  low  = _mm256_min_ps (low, v_one);
+
+  c = _mm256_blendv_ps (low, high, _mm256_cmp_ps (b, v_half, _CMP_GT_OQ)))
+
+DEFINE_BLEND_FUNCTION (lighten_only,
+  c = _mm256_max_ps (a, b))
+
+DEFINE_BLEND_FUNCTION (linear_burn,
+  c = _mm256_sub_ps (_mm256_add_ps (a, b), v_one))
+
+DEFINE_BLEND_FUNCTION (linear_light,
+  __m256 high;
+  __m256 low;
+
+  high = _mm256_add_ps (a, _mm256_mul_ps (v_two, _mm256_sub_ps (b, v_half)));
+  low  = _mm256_sub_ps (_mm256_add_ps (a, _mm256_mul_ps (v_two, b)), v_one);
+
+  c = _mm256_blendv_ps (high, low, _mm256_cmp_ps (b, v_half, _CMP_LE_OQ)))
+
+DEFINE_BLEND_FUNCTION (multiply,
+  c = _mm256_mul_ps (a, b))
+
+DEFINE_BLEND_FUNCTION (overlay,
+  __m256 high;
+  __m256 low;
+
+  high = _mm256_sub_ps (v_one,
+                        _mm256_mul_ps (_mm256_mul_ps (v_two,
+                                                      _mm256_sub_ps (v_one, b)),
+                                       _mm256_sub_ps (v_one, a)));
+  low  = _mm256_mul_ps (_mm256_mul_ps (v_two, a), b);
+
+  c = _mm256_blendv_ps (high, low, _mm256_cmp_ps (a, v_half, _CMP_LT_OQ)))
+
+DEFINE_BLEND_FUNCTION (pin_light,
+  __m256 high;
+  __m256 low;
+
+  high = _mm256_max_ps (a, _mm256_mul_ps (v_two, _mm256_sub_ps (b, v_half)));
+  low  = _mm256_min_ps (a, _mm256_mul_ps (v_two, b));
+
+  c = _mm256_blendv_ps (low, high, _mm256_cmp_ps (b, v_half, _CMP_GT_OQ)))
+
+DEFINE_BLEND_FUNCTION (screen,
+  c = _mm256_sub_ps (v_one, _mm256_mul_ps (_mm256_sub_ps (v_one, a),
+                                           _mm256_sub_ps (v_one, b))))
+
+DEFINE_BLEND_FUNCTION (softlight,
+  __m256 multiply;
+  __m256 screen;
+
+  multiply = _mm256_mul_ps (a, b);
+  screen   = _mm256_sub_ps (v_one, _mm256_mul_ps (_mm256_sub_ps (v_one, a),
+                                                  _mm256_sub_ps (v_one, b)));
+
+  c = _mm256_add_ps (_mm256_mul_ps (_mm256_sub_ps (v_one, a), multiply),
+                     _mm256_mul_ps (a, screen)))
+
+DEFINE_BLEND_FUNCTION (subtract,
+  c = _mm256_sub_ps (a, b))
+
+DEFINE_BLEND_FUNCTION (vivid_light,
+  __m256 high;
+  __m256 low;
+
+  low  = _mm256_sub_ps (v_one, safe_div (_mm256_sub_ps (v_one, a),
+                                         _mm256_mul_ps (v_two, b)));
+  low  = _mm256_max_ps (low, v_zero);
+
+  high = safe_div (a, _mm256_mul_ps (v_two, _mm256_sub_ps (v_one, b)));
+  high = _mm256_min_ps (high, v_one);
+
+  c = _mm256_blendv_ps (high, low, _mm256_cmp_ps (b, v_half, _CMP_LE_OQ)))
+
+#endif /* COMPILE_AVX2_INTRINISICS */
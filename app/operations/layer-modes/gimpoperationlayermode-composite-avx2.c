@@ -0,0 +1,204 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimpoperationlayermode-composite-avx2.c
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <gegl-plugin.h>
+#include <cairo.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+
+#include "../operations-types.h"
+
+#include "gimpoperationlayermode-composite.h"
+
+
+#if COMPILE_AVX2_INTRINISICS
+
+/* AVX2 */
+#include <immintrin.h>
+
+
+/*  local function prototypes  */
+
+static inline __m256   load_mask (const gfloat *mask);
+
+
+/*  private functions  */
+
+
+/* returns a vector with mask[0] broadcast to the first pixel, and mask[1]
+ * broadcast to the second pixel.
+ */
+static inline __m256
+load_mask (const gfloat *mask)
+{
+  return _mm256_insertf128_ps (_mm256_castps128_ps256 (_mm_set1_ps (mask[0])),
+                               _mm_set1_ps (mask[1]), 1);
+}
+
+
+/*  public functions  */
+
+
+/*  non-subtractive compositing functions.  these functions expect comp[ALPHA]
+ *  to be the same as layer[ALPHA].  when in[ALPHA] or layer[ALPHA] are zero,
+ *  the value of comp[RED..BLUE] is unconstrained (in particular, it may be
+ *  NaN).
+ *
+ *  the functions process two pixels per iteration, selecting between the
+ *  cases of their scalar counterparts per pixel, rather than branching, and
+ *  defer to the scalar functions for the last odd pixel.
+ */
+
+
+void
+gimp_operation_layer_mode_composite_union_avx2 (const gfloat *in,
+                                                const gfloat *layer,
+                                                const gfloat *comp,
+                                                const gfloat *mask,
+                                                gfloat        opacity,
+                                                gfloat       *out,
+                                                gint          samples)
+{
+  const __m256 v_zero    = _mm256_setzero_ps ();
+  const __m256 v_one     = _mm256_set1_ps (1.0f);
+  const __m256 v_opacity = _mm256_set1_ps (opacity);
+
+  for (; samples >= 2; samples -= 2)
+    {
+      __m256 rgba_in    = _mm256_loadu_ps (in);
+      __m256 rgba_layer = _mm256_loadu_ps (layer);
+      __m256 rgba_comp  = _mm256_loadu_ps (comp);
+      __m256 in_alpha;
+      __m256 layer_alpha;
+      __m256 new_alpha;
+      __m256 ratio;
+      __m256 out_pixel;
+
+      in_alpha    = _mm256_permute_ps (rgba_in,    _MM_SHUFFLE (3, 3, 3, 3));
+      layer_alpha = _mm256_permute_ps (rgba_layer, _MM_SHUFFLE (3, 3, 3, 3));
+      layer_alpha = _mm256_mul_ps (layer_alpha, v_opacity);
+
+      if (mask)
+        {
+          layer_alpha = _mm256_mul_ps (layer_alpha, load_mask (mask));
+
+          mask += 2;
+        }
+
+      new_alpha = _mm256_add_ps (layer_alpha,
+                                 _mm256_mul_ps (_mm256_sub_ps (v_one,
+                                                               layer_alpha),
+                                                in_alpha));
+
+      ratio     = _mm256_div_ps (layer_alpha, new_alpha);
+
+      out_pixel = _mm256_sub_ps (rgba_comp, rgba_layer);
+      out_pixel = _mm256_mul_ps (in_alpha, out_pixel);
+      out_pixel = _mm256_add_ps (out_pixel, rgba_layer);
+      out_pixel = _mm256_sub_ps (out_pixel, rgba_in);
+      out_pixel = _mm256_mul_ps (ratio, out_pixel);
+      out_pixel = _mm256_add_ps (out_pixel, rgba_in);
+
+      out_pixel = _mm256_blendv_ps (out_pixel, rgba_layer,
+                                    _mm256_cmp_ps (in_alpha, v_zero,
+                                                   _CMP_EQ_OQ));
+      out_pixel = _mm256_blendv_ps (out_pixel, rgba_in,
+                                    _mm256_or_ps (
+                                      _mm256_cmp_ps (layer_alpha, v_zero,
+                                                     _CMP_EQ_OQ),
+                                      _mm256_cmp_ps (new_alpha, v_zero,
+                                                     _CMP_EQ_OQ)));
+
+      _mm256_storeu_ps (out, _mm256_blend_ps (out_pixel, new_alpha, 0x88));
+
+      in    += 8;
+      layer += 8;
+      comp  += 8;
+      out   += 8;
+    }
+
+  if (samples)
+    {
+      gimp_operation_layer_mode_composite_union (in, layer, comp, mask,
+                                                 opacity, out, samples);
+    }
+}
+
+void
+gimp_operation_layer_mode_composite_clip_to_backdrop_avx2 (const gfloat *in,
+                                                           const gfloat *layer,
+                                                           const gfloat *comp,
+                                                           const gfloat *mask,
+                                                           gfloat        opacity,
+                                                           gfloat       *out,
+                                                           gint          samples)
+{
+  const __m256 v_zero    = _mm256_setzero_ps ();
+  const __m256 v_one     = _mm256_set1_ps (1.0f);
+  const __m256 v_opacity = _mm256_set1_ps (opacity);
+
+  for (; samples >= 2; samples -= 2)
+    {
+      __m256 rgba_in   = _mm256_loadu_ps (in);
+      __m256 rgba_comp = _mm256_loadu_ps (comp);
+      __m256 in_alpha;
+      __m256 layer_alpha;
+      __m256 out_pixel;
+
+      in_alpha    = _mm256_permute_ps (rgba_in,   _MM_SHUFFLE (3, 3, 3, 3));
+      layer_alpha = _mm256_permute_ps (rgba_comp, _MM_SHUFFLE (3, 3, 3, 3));
+      layer_alpha = _mm256_mul_ps (layer_alpha, v_opacity);
+
+      if (mask)
+        {
+          layer_alpha = _mm256_mul_ps (layer_alpha, load_mask (mask));
+
+          mask += 2;
+        }
+
+      out_pixel = _mm256_add_ps (_mm256_mul_ps (rgba_comp, layer_alpha),
+                                 _mm256_mul_ps (rgba_in,
+                                                _mm256_sub_ps (v_one,
+                                                               layer_alpha)));
+
+      out_pixel = _mm256_blendv_ps (out_pixel, rgba_in,
+                                    _mm256_or_ps (
+                                      _mm256_cmp_ps (in_alpha, v_zero,
+                                                     _CMP_EQ_OQ),
+                                      _mm256_cmp_ps (layer_alpha, v_zero,
+                                                     _CMP_EQ_OQ)));
+
+      /*  out[ALPHA] = in[ALPHA]  */
+      _mm256_storeu_ps (out, _mm256_blend_ps (out_pixel, rgba_in, 0x88));
+
+      in    += 8;
+      comp  += 8;
+      out   += 8;
+    }
+
+  if (samples)
+    {
+      gimp_operation_layer_mode_composite_clip_to_backdrop (in, layer, comp,
+                                                            mask, opacity,
+                                                            out, samples);
+    }
+}
+
+#endif /* COMPILE_AVX2_INTRINISICS */
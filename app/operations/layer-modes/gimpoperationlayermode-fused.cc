@@ -0,0 +1,387 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimpoperationlayermode-fused.cc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <gegl-plugin.h>
+#include <cairo.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+
+extern "C"
+{
+
+#include "libgimpmath/gimpmath.h"
+
+#include "../operations-types.h"
+
+#include "gimpoperationlayermode-blend.h"
+#include "gimpoperationlayermode-fused.h"
+
+} /* extern "C" */
+
+
+/*  the fused functions below perform blending and compositing in a single
+ *  pass, without an intermediate buffer, for separable, non-subtractive
+ *  layer modes whose blending and compositing happen in the same color
+ *  space.  they use the same arithmetic as the corresponding blend and
+ *  composite functions, and therefore produce the same results.
+ */
+
+
+/*  blenders  */
+
+
+struct BlendAddition
+{
+  static inline gfloat
+  blend (gfloat in,
+         gfloat layer)
+  {
+    return in + layer;
+  }
+};
+
+struct BlendDarkenOnly
+{
+  static inline gfloat
+  blend (gfloat in,
+         gfloat layer)
+  {
+    return MIN (in, layer);
+  }
+};
+
+struct BlendDifference
+{
+  static inline gfloat
+  blend (gfloat in,
+         gfloat layer)
+  {
+    return fabsf (in - layer);
+  }
+};
+
+struct BlendExclusion
+{
+  static inline gfloat
+  blend (gfloat in,
+         gfloat layer)
+  {
+    return 0.5f - 2.0f * (in - 0.5f) * (layer - 0.5f);
+  }
+};
+
+struct BlendGrainExtract
+{
+  static inline gfloat
+  blend (gfloat in,
+         gfloat layer)
+  {
+    return in - layer + 0.5f;
+  }
+};
+
+struct BlendGrainMerge
+{
+  static inline gfloat
+  blend (gfloat in,
+         gfloat layer)
+  {
+    return in + layer - 0.5f;
+  }
+};
+
+struct BlendHardlight
+{
+  static inline gfloat
+  blend (gfloat in,
+         gfloat layer)
+  {
+    gfloat val;
+
+    if (layer > 0.5f)
+      {
+        val = (1.0f - in) * (1.0f - (layer - 0.5f) * 2.0f);
+        val = MIN (1.0f - val, 1.0f);
+      }
+    else
+      {
+        val = in * (layer * 2.0f);
+        val = MIN (val, 1.0f);
+      }
+
+    return val;
+  }
+};
+
+struct BlendLightenOnly
+{
+  static inline gfloat
+  blend (gfloat in,
+         gfloat layer)
+  {
+    return MAX (in, layer);
+  }
+};
+
+struct BlendLinearBurn
+{
+  static inline gfloat
+  blend (gfloat in,
+         gfloat layer)
+  {
+    return in + layer - 1.0f;
+  }
+};
+
+struct BlendMultiply
+{
+  static inline gfloat
+  blend (gfloat in,
+         gfloat layer)
+  {
+    return in * layer;
+  }
+};
+
+struct BlendOverlay
+{
+  static inline gfloat
+  blend (gfloat in,
+         gfloat layer)
+  {
+    if (in < 0.5f)
+      return 2.0f * in * layer;
+    else
+      return 1.0f - 2.0f * (1.0f - layer) * (1.0f - in);
+  }
+};
+
+struct BlendScreen
+{
+  static inline gfloat
+  blend (gfloat in,
+         gfloat layer)
+  {
+    return 1.0f - (1.0f - in) * (1.0f - layer);
+  }
+};
+
+struct BlendSoftlight
+{
+  static inline gfloat
+  blend (gfloat in,
+         gfloat layer)
+  {
+    gfloat multiply = in * layer;
+    gfloat screen   = 1.0f - (1.0f - in) * (1.0f - layer);
+
+    return (1.0f - in) * multiply + in * screen;
+  }
+};
+
+struct BlendSubtract
+{
+  static inline gfloat
+  blend (gfloat in,
+         gfloat layer)
+  {
+    return in - layer;
+  }
+};
+
+
+/*  fused functions  */
+
+
+template <class Blender,
+          GimpLayerCompositeMode composite_mode,
+          gboolean               has_mask,
+          gboolean               has_opacity>
+static void
+fused_process (const gfloat *in,
+               const gfloat *layer,
+               const gfloat *mask,
+               gfloat        opacity,
+               gfloat       *out,
+               gint          samples)
+{
+  while (samples--)
+    {
+      gfloat in_alpha    = in[ALPHA];
+      gfloat layer_alpha = layer[ALPHA];
+      gint   b;
+
+      if (has_opacity)
+        layer_alpha *= opacity;
+
+      if (has_mask)
+        layer_alpha *= *mask++;
+
+      switch (composite_mode)
+        {
+        case GIMP_LAYER_COMPOSITE_UNION:
+          {
+            gfloat new_alpha = layer_alpha + (1.0f - layer_alpha) * in_alpha;
+
+            if (layer_alpha == 0.0f || new_alpha == 0.0f)
+              {
+                for (b = RED; b < ALPHA; b++)
+                  out[b] = in[b];
+              }
+            else if (in_alpha == 0.0f)
+              {
+                for (b = RED; b < ALPHA; b++)
+                  out[b] = layer[b];
+              }
+            else
+              {
+                gfloat ratio = layer_alpha / new_alpha;
+
+                for (b = RED; b < ALPHA; b++)
+                  {
+                    gfloat comp = Blender::blend (in[b], layer[b]);
+
+                    out[b] = ratio * (in_alpha * (comp - layer[b]) +
+                                      layer[b] - in[b]) +
+                             in[b];
+                  }
+              }
+
+            out[ALPHA] = new_alpha;
+          }
+          break;
+
+        case GIMP_LAYER_COMPOSITE_CLIP_TO_BACKDROP:
+          {
+            if (in_alpha == 0.0f || layer_alpha == 0.0f)
+              {
+                for (b = RED; b < ALPHA; b++)
+                  out[b] = in[b];
+              }
+            else
+              {
+                for (b = RED; b < ALPHA; b++)
+                  {
+                    gfloat comp = Blender::blend (in[b], layer[b]);
+
+                    out[b] = comp * layer_alpha + in[b] * (1.0f - layer_alpha);
+                  }
+              }
+
+            out[ALPHA] = in_alpha;
+          }
+          break;
+
+        default:
+          g_return_if_reached ();
+        }
+
+      in    += 4;
+      layer += 4;
+      out   += 4;
+    }
+}
+
+template <class Blender,
+          GimpLayerCompositeMode composite_mode>
+static void
+fused_dispatch (const gfloat *in,
+                const gfloat *layer,
+                const gfloat *mask,
+                gfloat        opacity,
+                gfloat       *out,
+                gint          samples)
+{
+  if (mask)
+    {
+      if (opacity != 1.0f)
+        {
+          fused_process<Blender, composite_mode, TRUE, TRUE> (
+            in, layer, mask, opacity, out, samples);
+        }
+      else
+        {
+          fused_process<Blender, composite_mode, TRUE, FALSE> (
+            in, layer, mask, opacity, out, samples);
+        }
+    }
+  else
+    {
+      if (opacity != 1.0f)
+        {
+          fused_process<Blender, composite_mode, FALSE, TRUE> (
+            in, layer, mask, opacity, out, samples);
+        }
+      else
+        {
+          fused_process<Blender, composite_mode, FALSE, FALSE> (
+            in, layer, mask, opacity, out, samples);
+        }
+    }
+}
+
+template <class Blender>
+static GimpLayerModeFusedFunc
+fused_get_function (GimpLayerCompositeMode composite_mode)
+{
+  switch (composite_mode)
+    {
+    case GIMP_LAYER_COMPOSITE_UNION:
+      return fused_dispatch<Blender, GIMP_LAYER_COMPOSITE_UNION>;
+
+    case GIMP_LAYER_COMPOSITE_CLIP_TO_BACKDROP:
+      return fused_dispatch<Blender, GIMP_LAYER_COMPOSITE_CLIP_TO_BACKDROP>;
+
+    default:
+      return NULL;
+    }
+}
+
+
+/*  public functions  */
+
+
+GimpLayerModeFusedFunc
+gimp_operation_layer_mode_get_fused_function (GimpLayerModeBlendFunc blend_function,
+                                              GimpLayerCompositeMode composite_mode)
+{
+  #define FUSED_FUNCTION(name, blender)                                        \
+    if (blend_function == gimp_operation_layer_mode_blend_##name)              \
+      return fused_get_function<blender> (composite_mode)
+
+  FUSED_FUNCTION (addition,      BlendAddition);
+  FUSED_FUNCTION (darken_only,   BlendDarkenOnly);
+  FUSED_FUNCTION (difference,    BlendDifference);
+  FUSED_FUNCTION (exclusion,     BlendExclusion);
+  FUSED_FUNCTION (grain_extract, BlendGrainExtract);
+  FUSED_FUNCTION (grain_merge,   BlendGrainMerge);
+  FUSED_FUNCTION (hardlight,     BlendHardlight);
+  FUSED_FUNCTION (lighten_only,  BlendLightenOnly);
+  FUSED_FUNCTION (linear_burn,   BlendLinearBurn);
+  FUSED_FUNCTION (multiply,      BlendMultiply);
+  FUSED_FUNCTION (overlay,       BlendOverlay);
+  FUSED_FUNCTION (screen,        BlendScreen);
+  FUSED_FUNCTION (softlight,     BlendSoftlight);
+  FUSED_FUNCTION (subtract,      BlendSubtract);
+
+  #undef FUSED_FUNCTION
+
+  return NULL;
+}
@@ -0,0 +1,28 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * gimpoperationlayermode-fused.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GIMP_OPERATION_LAYER_MODE_FUSED_H__
+#define __GIMP_OPERATION_LAYER_MODE_FUSED_H__
+
+
+GimpLayerModeFusedFunc gimp_operation_layer_mode_get_fused_function (GimpLayerModeBlendFunc blend_function,
+                                                                     GimpLayerCompositeMode composite_mode);
+
+
+#endif /* __GIMP_OPERATION_LAYER_MODE_FUSED_H__ */
@@ -47,6 +47,12 @@
  */
 #define GIMP_COMPOSITE_BLEND_SPLIT_THRESHOLD 32
 
+/* minimal number of samples for which to check whether the layer is fully
+ * transparent or fully opaque, in order to skip, or copy, the samples
+ * instead of compositing them.
+ */
+#define GIMP_COMPOSITE_SHORTCUT_MIN_SAMPLES 64
+
 
 enum
 {
@@ -68,6 +74,14 @@ typedef void (* CompositeFunc) (const gfloat *in,
                                 gint          samples);
 
 
+typedef enum
+{
+  LAYER_ALPHA_MIXED,
+  LAYER_ALPHA_TRANSPARENT,
+  LAYER_ALPHA_OPAQUE
+} LayerAlpha;
+
+
 static void            gimp_operation_layer_mode_set_property        (GObject                *object,
                                                                       guint                   property_id,
                                                                       const GValue           *value,
@@ -120,6 +134,10 @@ static gboolean        process_last_node                             (GeglOperat
 static void            gimp_operation_layer_mode_cache_fishes        (GimpOperationLayerMode *op,
                                                                       const Babl             *preferred_format);
 
+static LayerAlpha      get_layer_alpha                               (const gfloat           *layer,
+                                                                      const gfloat           *mask,
+                                                                      glong                   samples);
+
 
 G_DEFINE_TYPE (GimpOperationLayerMode, gimp_operation_layer_mode,
                GEGL_TYPE_OPERATION_POINT_COMPOSER3)
@@ -136,6 +154,8 @@ static CompositeFunc composite_clip_to_backdrop_sub = gimp_operation_layer_mode_
 static CompositeFunc composite_clip_to_layer_sub    = gimp_operation_layer_mode_composite_clip_to_layer_sub;
 static CompositeFunc composite_intersection_sub     = gimp_operation_layer_mode_composite_intersection_sub;
 
+static gint          n_shortcuts                    = 0;
+
 
 static void
 gimp_operation_layer_mode_class_init (GimpOperationLayerModeClass *klass)
@@ -205,6 +225,14 @@ gimp_operation_layer_mode_class_init (GimpOperationLayerModeClass *klass)
   if (gimp_cpu_accel_get_support () & GIMP_CPU_ACCEL_X86_SSE2)
     composite_clip_to_backdrop = gimp_operation_layer_mode_composite_clip_to_backdrop_sse2;
 #endif
+
+#if COMPILE_AVX2_INTRINISICS
+  if (gimp_cpu_accel_get_support () & GIMP_CPU_ACCEL_X86_AVX2)
+    {
+      composite_union            = gimp_operation_layer_mode_composite_union_avx2;
+      composite_clip_to_backdrop = gimp_operation_layer_mode_composite_clip_to_backdrop_avx2;
+    }
+#endif
 }
 
 static void
@@ -344,6 +372,29 @@ gimp_operation_layer_mode_prepare (GeglOperation *operation)
 
   self->has_mask = mask_extent && ! gegl_rectangle_is_empty (mask_extent);
 
+  self->fused_function = gimp_layer_mode_get_fused_function (self->layer_mode,
+                                                             self->composite_mode);
+
+  /* a fully-transparent layer leaves the backdrop unchanged, as long as the
+   * composite mode includes the backdrop, and the op doesn't otherwise
+   * affect it.
+   */
+  self->transparent_is_nop =
+    ! self->is_last_node &&
+    (gimp_layer_mode_get_included_region (self->layer_mode,
+                                          self->composite_mode) &
+     GIMP_LAYER_COMPOSITE_REGION_DESTINATION) &&
+    ! (gimp_operation_layer_mode_get_affected_region (self) &
+       GIMP_LAYER_COMPOSITE_REGION_DESTINATION);
+
+  /* a fully-opaque layer replaces the backdrop in normal/union mode, and when
+   * it's simply copied as the bottom layer.
+   */
+  self->opaque_is_copy =
+    self->function == process_last_node ||
+    (self->layer_mode     == GIMP_LAYER_MODE_NORMAL &&
+     self->composite_mode == GIMP_LAYER_COMPOSITE_UNION);
+
   gimp_operation_layer_mode_cache_fishes (self, preferred_format);
 
   format = gimp_layer_mode_get_format (self->layer_mode,
@@ -447,6 +498,46 @@ gimp_operation_layer_mode_parent_process (GeglOperation        *operation,
     operation, context, output_prop, result, level);
 }
 
+static LayerAlpha
+get_layer_alpha (const gfloat *layer,
+                 const gfloat *mask,
+                 glong         samples)
+{
+  const gfloat *end = layer + 4 * samples;
+  gfloat        alpha;
+
+  alpha = layer[ALPHA];
+
+  if (mask)
+    alpha *= mask[0];
+
+  if (alpha == 0.0f)
+    {
+      for (; layer < end; layer += 4)
+        {
+          if (layer[ALPHA] != 0.0f && ! (mask && *mask == 0.0f))
+            return LAYER_ALPHA_MIXED;
+
+          if (mask)
+            mask++;
+        }
+
+      return LAYER_ALPHA_TRANSPARENT;
+    }
+  else if (alpha == 1.0f)
+    {
+      for (; layer < end; layer += 4)
+        {
+          if (layer[ALPHA] != 1.0f || (mask && *mask++ != 1.0f))
+            return LAYER_ALPHA_MIXED;
+        }
+
+      return LAYER_ALPHA_OPAQUE;
+    }
+
+  return LAYER_ALPHA_MIXED;
+}
+
 static gboolean
 gimp_operation_layer_mode_process (GeglOperation       *operation,
                                    void                *in,
@@ -457,8 +548,49 @@ gimp_operation_layer_mode_process (GeglOperation       *operation,
                                    const GeglRectangle *roi,
                                    gint                 level)
 {
-  return ((GimpOperationLayerMode *) operation)->function (
-    operation, in, layer, mask, out, samples, roi, level);
+  GimpOperationLayerMode *layer_mode = (GimpOperationLayerMode *) operation;
+
+  /* sparse layers, such as line art or text, consist mostly of fully
+   * transparent, or fully opaque, areas.  when the entire processed area
+   * of the layer is either, the result is either the backdrop, or the layer
+   * itself, and the samples can be copied as-is without compositing.
+   */
+  if (layer && samples >= GIMP_COMPOSITE_SHORTCUT_MIN_SAMPLES &&
+      (layer_mode->transparent_is_nop || layer_mode->opaque_is_copy))
+    {
+      switch (get_layer_alpha (layer, mask, samples))
+        {
+        case LAYER_ALPHA_MIXED:
+          break;
+
+        case LAYER_ALPHA_TRANSPARENT:
+          if (layer_mode->transparent_is_nop)
+            {
+              if (out != in)
+                memcpy (out, in, 4 * sizeof (gfloat) * samples);
+
+              g_atomic_int_inc (&n_shortcuts);
+
+              return TRUE;
+            }
+          break;
+
+        case LAYER_ALPHA_OPAQUE:
+          if (layer_mode->opaque_is_copy && layer_mode->opacity == 1.0)
+            {
+              if (out != layer)
+                memcpy (out, layer, 4 * sizeof (gfloat) * samples);
+
+              g_atomic_int_inc (&n_shortcuts);
+
+              return TRUE;
+            }
+          break;
+        }
+    }
+
+  return layer_mode->function (operation, in, layer, mask, out, samples,
+                               roi, level);
 }
 
 static gboolean
@@ -671,6 +803,17 @@ gimp_operation_layer_mode_real_process (GeglOperation       *operation,
                                                        [composite_space - 1];
     }
 
+  /* if blending and compositing use the same color space, and the mode has
+   * a fused blend-composite function, use it, avoiding the intermediate
+   * buffer altogether.
+   */
+  if (! composite_to_blend_fish && layer_mode->fused_function)
+    {
+      layer_mode->fused_function (in, layer, mask, opacity, out, samples);
+
+      return TRUE;
+    }
+
   /* if we need to convert the samples between the composite and blend
    * spaces...
    */
@@ -938,7 +1081,6 @@ gimp_operation_layer_mode_cache_fishes (GimpOperationLayerMode *op,
 
 /*  public functions  */
 
-
 GimpLayerCompositeRegion
 gimp_operation_layer_mode_get_affected_region (GimpOperationLayerMode *layer_mode)
 {
@@ -954,3 +1096,9 @@ gimp_operation_layer_mode_get_affected_region (GimpOperationLayerMode *layer_mod
 
   return GIMP_LAYER_COMPOSITE_REGION_INTERSECTION;
 }
+
+gint
+gimp_layer_modes_get_n_shortcuts (void)
+{
+  return g_atomic_int_get (&n_shortcuts);
+}
@@ -52,8 +52,11 @@ struct _GimpOperationLayerMode
 
   GimpLayerModeFunc            function;
   GimpLayerModeBlendFunc       blend_function;
+  GimpLayerModeFusedFunc       fused_function;
   gboolean                     is_last_node;
   gboolean                     has_mask;
+  gboolean                     transparent_is_nop;
+  gboolean                     opaque_is_copy;
 };
 
 struct _GimpOperationLayerModeClass
@@ -72,5 +72,12 @@ typedef  void    (* GimpLayerModeBlendFunc) (GeglOperation          *operation,
                                              gfloat                 *out,
                                              gint                    samples);
 
+typedef  void    (* GimpLayerModeFusedFunc) (const gfloat           *in,
+                                             const gfloat           *layer,
+                                             const gfloat           *mask,
+                                             gfloat                  opacity,
+                                             gfloat                 *out,
+                                             gint                    samples);
+
 
 #endif /* __OPERATIONS_TYPES_H__ */
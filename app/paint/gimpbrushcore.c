@@ -152,6 +152,7 @@ gimp_brush_core_class_init (GimpBrushCoreClass *klass)
   klass->handles_changing_brush             = FALSE;
   klass->handles_transforming_brush         = TRUE;
   klass->handles_dynamic_transforming_brush = TRUE;
+  klass->needs_immediate_updates            = FALSE;
 
   klass->set_brush                          = gimp_brush_core_real_set_brush;
   klass->set_dynamics                       = gimp_brush_core_real_set_dynamics;
@@ -712,6 +713,10 @@ gimp_brush_core_interpolate (GimpPaintCore    *paint_core,
         }
     }
 
+  /*  emit one update per segment, rather than one per dab  */
+  if (! GIMP_BRUSH_CORE_GET_CLASS (core)->needs_immediate_updates)
+    gimp_paint_core_freeze_updates (paint_core);
+
   for (n = 0; n < num_points; n++)
     {
       gdouble t = t0 + n * dt;
@@ -770,6 +775,9 @@ gimp_brush_core_interpolate (GimpPaintCore    *paint_core,
                              GIMP_PAINT_STATE_MOTION, time);
     }
 
+  if (! GIMP_BRUSH_CORE_GET_CLASS (core)->needs_immediate_updates)
+    gimp_paint_core_thaw_updates (paint_core);
+
   current_coords.x        = last_coords.x        + delta_vec.x;
   current_coords.y        = last_coords.y        + delta_vec.y;
   current_coords.pressure = last_coords.pressure + delta_pressure;
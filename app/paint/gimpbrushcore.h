@@ -88,6 +88,9 @@ struct _GimpBrushCoreClass
   /*  Set for tools that don't mind if the brush scales mid stroke  */
   gboolean            handles_dynamic_transforming_brush;
 
+  /*  Set for tools that read back the image they paint on, dab by dab  */
+  gboolean            needs_immediate_updates;
+
   void (* set_brush)    (GimpBrushCore *core,
                          GimpBrush     *brush);
   void (* set_dynamics) (GimpBrushCore *core,
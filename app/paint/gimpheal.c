@@ -101,6 +101,12 @@ static void         gimp_heal_motion             (GimpSourceCore   *source_core,
                                                   gint              paint_area_width,
                                                   gint              paint_area_height);
 
+static void         gimp_heal_laplace_loop       (gfloat           *pixels,
+                                                  gint              height,
+                                                  gint              depth,
+                                                  gint              width,
+                                                  guchar           *mask);
+
 
 G_DEFINE_TYPE (GimpHeal, gimp_heal, GIMP_TYPE_SOURCE_CORE)
 
@@ -345,6 +351,71 @@ gimp_heal_laplace_iteration (gfloat *pixels,
   return err;
 }
 
+/* Solve the system on a grid of half the resolution, and use the result
+ * as the initial guess for the masked pixels.  Relaxation only smooths
+ * out errors on the scale of a few pixels quickly, so starting from the
+ * coarse solution saves most of the iterations on large brushes.
+ */
+static void
+gimp_heal_laplace_init_coarse (gfloat *pixels,
+                               gint    height,
+                               gint    depth,
+                               gint    width,
+                               guchar *mask)
+{
+  gint      cwidth  = width  / 2;
+  gint      cheight = height / 2;
+  gfloat   *cpixels, *cpixels_alloc;
+  guchar   *cmask;
+  gboolean  any_masked = FALSE;
+  gint      i, j, k;
+
+  cpixels_alloc = g_new (gfloat, 4 + (cwidth * cheight + 1) * depth);
+  cpixels = (gfloat*)(((uintptr_t)cpixels_alloc + 15) & ~15);
+
+  cmask = g_new (guchar, cwidth * cheight);
+
+  for (i = 0; i < cheight; i++)
+    for (j = 0; j < cwidth; j++)
+      {
+        gint p00 = (2 * i) * width + (2 * j);
+        gint p01 = p00 + 1;
+        gint p10 = p00 + width;
+        gint p11 = p10 + 1;
+        gint c   = i * cwidth + j;
+
+        for (k = 0; k < depth; k++)
+          {
+            cpixels[c * depth + k] = 0.25f * (pixels[p00 * depth + k] +
+                                              pixels[p01 * depth + k] +
+                                              pixels[p10 * depth + k] +
+                                              pixels[p11 * depth + k]);
+          }
+
+        cmask[c] = mask[p00] && mask[p01] && mask[p10] && mask[p11];
+
+        any_masked |= cmask[c];
+      }
+
+  if (any_masked)
+    {
+      gimp_heal_laplace_loop (cpixels, cheight, depth, cwidth, cmask);
+
+      for (i = 0; i < height; i++)
+        for (j = 0; j < width; j++)
+          if (mask[j + i * width])
+            {
+              gint c = MIN (i / 2, cheight - 1) * cwidth + MIN (j / 2, cwidth - 1);
+
+              for (k = 0; k < depth; k++)
+                pixels[(j + i * width) * depth + k] = cpixels[c * depth + k];
+            }
+    }
+
+  g_free (cmask);
+  g_free (cpixels_alloc);
+}
+
 /* Solve the laplace equation for pixels and store the result in-place.
  */
 static void
@@ -357,12 +428,17 @@ gimp_heal_laplace_loop (gfloat *pixels,
   /* Tolerate a total deviation-from-smoothness of 0.1 LSBs at 8bit depth. */
 #define EPSILON  (0.1/255)
 #define MAX_ITER 500
+  /* Don't bother with a coarser grid for small brushes. */
+#define MIN_COARSE_SIZE 16
 
   gint    i, j, iter, parity, nmask, zero;
   gfloat *Adiag;
   gint   *Aidx;
   gfloat  w;
 
+  if (width >= 2 * MIN_COARSE_SIZE && height >= 2 * MIN_COARSE_SIZE)
+    gimp_heal_laplace_init_coarse (pixels, height, depth, width, mask);
+
   Adiag = g_new (gfloat, width * height);
   Aidx  = g_new (gint, 5 * width * height);
 
@@ -333,10 +333,8 @@ gimp_mybrush_core_motion (GimpPaintCore    *paint_core,
 
   if (rect.width > 0 && rect.height > 0)
     {
-      paint_core->x1 = MIN (paint_core->x1, rect.x);
-      paint_core->y1 = MIN (paint_core->y1, rect.y);
-      paint_core->x2 = MAX (paint_core->x2, rect.x + rect.width);
-      paint_core->y2 = MAX (paint_core->y2, rect.y + rect.height);
+      gimp_paint_core_add_dirty_rect (paint_core, drawable,
+                                      (GeglRectangle *) &rect);
 
       gimp_drawable_update (drawable, rect.x, rect.y, rect.width, rect.height);
     }
@@ -42,6 +42,14 @@ struct _GimpMybrushSurface
   GeglRectangle dirty;
   GimpComponentMask component_mask;
   GimpMybrushOptions *options;
+
+  /* a float copy of the tiles of 'buffer' touched during the stroke, used
+   * when 'buffer' has a different format, so that the dabs don't convert
+   * their area back and forth.  written back to 'buffer' at the end of
+   * each atomic section.
+   */
+  GeglBuffer     *work_buffer;
+  cairo_region_t *work_region;
 };
 
 /* --- Taken from mypaint-tiled-surface.c --- */
@@ -229,6 +237,46 @@ calculate_dab_roi (float x,
   return *GEGL_RECTANGLE (x0, y0, x1 - x0, y1 - y0);
 }
 
+static GeglBuffer *
+gimp_mypaint_surface_get_work_buffer (GimpMybrushSurface  *surface,
+                                      const GeglRectangle *rect)
+{
+  GeglRectangle   area;
+  cairo_region_t *region;
+  gint            n_rects;
+  gint            i;
+
+  if (! surface->work_buffer)
+    return surface->buffer;
+
+  gegl_rectangle_align_to_buffer (&area, rect, surface->work_buffer,
+                                  GEGL_RECTANGLE_ALIGNMENT_SUPERSET);
+
+  /* reads entirely outside of the buffer only see its clamped edges */
+  if (! gegl_rectangle_intersect (&area, &area,
+                                  gegl_buffer_get_extent (surface->buffer)))
+    return surface->buffer;
+
+  region = cairo_region_create_rectangle ((cairo_rectangle_int_t *) &area);
+  cairo_region_subtract (region, surface->work_region);
+
+  n_rects = cairo_region_num_rectangles (region);
+
+  for (i = 0; i < n_rects; i++)
+    {
+      cairo_region_get_rectangle (region, i,
+                                  (cairo_rectangle_int_t *) &area);
+
+      gegl_buffer_copy (surface->buffer, &area, GEGL_ABYSS_NONE,
+                        surface->work_buffer, &area);
+    }
+
+  cairo_region_union (surface->work_region, region);
+  cairo_region_destroy (region);
+
+  return surface->work_buffer;
+}
+
 static void
 gimp_mypaint_surface_get_color (MyPaintSurface *base_surface,
                                 float           x,
@@ -261,9 +309,15 @@ gimp_mypaint_surface_get_color (MyPaintSurface *base_surface,
     float sum_b = 0.0f;
     float sum_a = 0.0f;
 
-     /* Read in clamp mode to avoid transparency bleeding in at the edges */
-    GeglBufferIterator *iter = gegl_buffer_iterator_new (surface->buffer, &dabRect, 0,
-                                                         babl_format ("R'aG'aB'aA float"),
+    GeglBuffer *buffer = gimp_mypaint_surface_get_work_buffer (surface, &dabRect);
+
+    /* Read in the buffer's own format, premultiplying below, so that the
+     * iterator uses the tiles directly instead of converting the area on
+     * every call.  Read in clamp mode to avoid transparency bleeding in at
+     * the edges.
+     */
+    GeglBufferIterator *iter = gegl_buffer_iterator_new (buffer, &dabRect, 0,
+                                                         babl_format ("R'G'B'A float"),
                                                          GEGL_BUFFER_READ,
                                                          GEGL_ABYSS_CLAMP, 2);
     if (surface->paint_mask)
@@ -278,33 +332,59 @@ gimp_mypaint_surface_get_color (MyPaintSurface *base_surface,
 
     while (gegl_buffer_iterator_next (iter))
       {
-        float *pixel = (float *)iter->items[0].data;
-        float *mask;
+        const GeglRectangle *roi = &iter->items[0].roi;
         int iy, ix;
 
-        if (surface->paint_mask)
-          mask = iter->items[1].data;
-        else
-          mask = NULL;
-
-        for (iy = iter->items[0].roi.y; iy < iter->items[0].roi.y + iter->items[0].roi.height; iy++)
+        for (iy = roi->y; iy < roi->y + roi->height; iy++)
           {
-            float yy = (iy + 0.5f - y);
-            for (ix = iter->items[0].roi.x; ix < iter->items[0].roi.x +  iter->items[0].roi.width; ix++)
+            float  yy = (iy + 0.5f - y);
+            float  xx2_max = radius * radius - yy * yy;
+            float  half;
+            int    x0, x1;
+            float *pixel;
+            float *mask;
+
+            /* only visit the pixels within the circle, with a pixel of
+             * slack on each side; the weight test below has the final say
+             */
+            if (xx2_max < 0.0f)
+              continue;
+
+            half = sqrtf (xx2_max);
+            x0   = MAX ((int) floorf (x - half - 0.5f) - 1, roi->x);
+            x1   = MIN ((int) ceilf  (x + half - 0.5f) + 1, roi->x + roi->width - 1);
+
+            pixel = (float *) iter->items[0].data +
+                    ((iy - roi->y) * roi->width + (x0 - roi->x)) * 4;
+
+            if (surface->paint_mask)
+              {
+                mask = (float *) iter->items[1].data +
+                       (iy - roi->y) * roi->width + (x0 - roi->x);
+              }
+            else
+              {
+                mask = NULL;
+              }
+
+            for (ix = x0; ix <= x1; ix++)
               {
                 /* pixel_weight == a standard dab with hardness = 0.5, aspect_ratio = 1.0, and angle = 0.0 */
                 float xx = (ix + 0.5f - x);
                 float rr = (yy * yy + xx * xx) * one_over_radius2;
                 float pixel_weight = 0.0f;
+                float alpha_weight;
                 if (rr <= 1.0f)
                   pixel_weight = 1.0f - rr;
                 if (mask)
                   pixel_weight *= *mask;
 
-                sum_r += pixel_weight * pixel[RED];
-                sum_g += pixel_weight * pixel[GREEN];
-                sum_b += pixel_weight * pixel[BLUE];
-                sum_a += pixel_weight * pixel[ALPHA];
+                alpha_weight = pixel_weight * pixel[ALPHA];
+
+                sum_r += alpha_weight * pixel[RED];
+                sum_g += alpha_weight * pixel[GREEN];
+                sum_b += alpha_weight * pixel[BLUE];
+                sum_a += alpha_weight;
                 sum_weight += pixel_weight;
 
                 pixel += 4;
@@ -386,7 +466,9 @@ gimp_mypaint_surface_draw_dab (MyPaintSurface *base_surface,
 
   gegl_rectangle_bounding_box (&surface->dirty, &surface->dirty, &dabRect);
 
-  iter = gegl_buffer_iterator_new (surface->buffer, &dabRect, 0,
+  iter = gegl_buffer_iterator_new (gimp_mypaint_surface_get_work_buffer (surface,
+                                                                         &dabRect),
+                                   &dabRect, 0,
                                    babl_format ("R'G'B'A float"),
                                    GEGL_BUFFER_READWRITE,
                                    GEGL_ABYSS_NONE, 2);
@@ -513,6 +595,13 @@ gimp_mypaint_surface_end_atomic (MyPaintSurface   *base_surface,
 {
   GimpMybrushSurface *surface = (GimpMybrushSurface *)base_surface;
 
+  if (surface->work_buffer &&
+      surface->dirty.width > 0 && surface->dirty.height > 0)
+    {
+      gegl_buffer_copy (surface->work_buffer, &surface->dirty, GEGL_ABYSS_NONE,
+                        surface->buffer, &surface->dirty);
+    }
+
   roi->x         = surface->dirty.x;
   roi->y         = surface->dirty.y;
   roi->width     = surface->dirty.width;
@@ -527,6 +616,8 @@ gimp_mypaint_surface_destroy (MyPaintSurface *base_surface)
 
   g_clear_object (&surface->buffer);
   g_clear_object (&surface->paint_mask);
+  g_clear_object (&surface->work_buffer);
+  g_clear_pointer (&surface->work_region, cairo_region_destroy);
   g_free (surface);
 }
 
@@ -557,5 +648,13 @@ gimp_mypaint_surface_new (GeglBuffer         *buffer,
   surface->paint_mask_y         = paint_mask_y;
   surface->dirty                = *GEGL_RECTANGLE (0, 0, 0, 0);
 
+  if (gegl_buffer_get_format (buffer) != babl_format ("R'G'B'A float"))
+    {
+      surface->work_buffer =
+        gegl_buffer_new (gegl_buffer_get_extent (buffer),
+                         babl_format ("R'G'B'A float"));
+      surface->work_region = cairo_region_create ();
+    }
+
   return surface;
 }
@@ -19,6 +19,8 @@
 #include <gegl.h>
 #include <gdk-pixbuf/gdk-pixbuf.h>
 
+#include "libgimpmath/gimpmath.h"
+
 extern "C"
 {
 
@@ -107,7 +109,8 @@ enum
   ALGORITHM_COMP_BUFFER            = 1u << 26,
   ALGORITHM_TEMP_COMP_BUFFER       = 1u << 25,
   ALGORITHM_CANVAS_BUFFER_ITERATOR = 1u << 24,
-  ALGORITHM_MASK_BUFFER_ITERATOR   = 1u << 23
+  ALGORITHM_MASK_BUFFER_ITERATOR   = 1u << 23,
+  ALGORITHM_BLEND_BUFFER           = 1u << 22
 };
 
 
@@ -1862,6 +1865,167 @@ struct DispatchPaintMaskToCompMask
 } static dispatch_paint_mask_to_comp_mask;
 
 
+/* BlendValueTraits:
+ *
+ * Whether 'BlendBuffer' converts a component type inline, and its maximal
+ * value.
+ */
+
+template <class T>
+struct BlendValueTraits
+{
+  static constexpr gboolean direct = FALSE;
+  static constexpr gfloat   max    = 1.0f;
+};
+
+template <>
+struct BlendValueTraits<guint8>
+{
+  static constexpr gboolean direct = TRUE;
+  static constexpr gfloat   max    = 255.0f;
+};
+
+template <>
+struct BlendValueTraits<guint16>
+{
+  static constexpr gboolean direct = TRUE;
+  static constexpr gfloat   max    = 65535.0f;
+};
+
+
+/* BlendBuffer, dispatch_blend_buffer():
+ *
+ * An algorithm helper class, providing the pixel type, and number of
+ * components, in which 'DoLayerBlend' reads 'src_buffer' and writes
+ * 'dest_buffer'.  When the buffers are 8- or 16-bit, and their format only
+ * differs from the layer mode's float format in its component type, and
+ * possibly in having no alpha, 'DoLayerBlend' converts each row inline,
+ * instead of letting the buffer iterator convert whole tiles through babl.
+ * Otherwise, the buffers are accessed in the layer mode's format, with a
+ * 'blend_type' of 'gfloat' and 4 'blend_components'.
+ */
+
+template <class Base,
+          class BlendType,
+          gint  BlendComponents>
+struct BlendBuffer : Base
+{
+  /* Component type of the blended buffers. */
+  using blend_type = BlendType;
+
+  /* Number of components of the blended buffers. */
+  static constexpr gint blend_components = BlendComponents;
+
+  /* Whether the blended buffers are converted inline. */
+  static constexpr gboolean blend_direct =
+    BlendValueTraits<BlendType>::direct;
+
+  static constexpr guint filter = Base::filter | ALGORITHM_BLEND_BUFFER;
+
+  using Base::Base;
+};
+
+struct DispatchBlendBuffer
+{
+  static constexpr guint mask = ALGORITHM_BLEND_BUFFER;
+
+  template <class Visitor,
+            class Algorithm>
+  void
+  operator () (Visitor                         visitor,
+               const GimpPaintCoreLoopsParams *params,
+               GimpPaintCoreLoopsAlgorithm     algorithms,
+               identity<Algorithm>             algorithm) const
+  {
+    const Babl *format = gimp_temp_buf_get_format (params->paint_buf);
+    const Babl *src_format;
+
+    src_format = gegl_buffer_get_format (params->src_buffer);
+
+    if (gegl_buffer_get_format (params->dest_buffer) == src_format &&
+        gimp_babl_format_get_base_type (src_format) == GIMP_RGB    &&
+        gimp_babl_format_get_trc (src_format) ==
+        gimp_babl_format_get_trc (format)                          &&
+        babl_format_get_space (src_format) == babl_format_get_space (format))
+      {
+        gboolean has_alpha = babl_format_has_alpha (src_format);
+
+        switch (gimp_babl_format_get_component_type (src_format))
+          {
+          case GIMP_COMPONENT_TYPE_U8:
+            if (has_alpha)
+              visitor (identity<BlendBuffer<Algorithm, guint8, 4>> ());
+            else
+              visitor (identity<BlendBuffer<Algorithm, guint8, 3>> ());
+            return;
+
+          case GIMP_COMPONENT_TYPE_U16:
+            if (has_alpha)
+              visitor (identity<BlendBuffer<Algorithm, guint16, 4>> ());
+            else
+              visitor (identity<BlendBuffer<Algorithm, guint16, 3>> ());
+            return;
+
+          default:
+            break;
+          }
+      }
+
+    visitor (identity<BlendBuffer<Algorithm, gfloat, 4>> ());
+  }
+} static dispatch_blend_buffer;
+
+
+/* blend_row_to_float(), blend_row_from_float():
+ *
+ * Convert a row of 'blend_type' pixels to, and from, RGBA float, the same way
+ * babl converts between formats that only differ in their component type.
+ */
+
+template <class T,
+          gint  N>
+static inline void
+blend_row_to_float (const T *src,
+                    gfloat  *dest,
+                    gint     n_pixels)
+{
+  while (n_pixels--)
+    {
+      gint c;
+
+      for (c = 0; c < 3; c++)
+        dest[c] = src[c] / BlendValueTraits<T>::max;
+
+      dest[3] = N == 4 ? src[3] / BlendValueTraits<T>::max : 1.0f;
+
+      src  += N;
+      dest += 4;
+    }
+}
+
+template <class T,
+          gint  N>
+static inline void
+blend_row_from_float (const gfloat *src,
+                      T            *dest,
+                      gint          n_pixels)
+{
+  while (n_pixels--)
+    {
+      gint c;
+
+      for (c = 0; c < N; c++)
+        {
+          dest[c] = (T) (SAFE_CLAMP (src[c], 0.0f, 1.0f) *
+                         BlendValueTraits<T>::max + 0.5f);
+        }
+
+      src  += 4;
+      dest += N;
+    }
+}
+
+
 /* DoLayerBlend, dispatch_do_layer_blend():
  *
  * An algorithm class, implementing the DO_LAYER_BLEND algorithm.
@@ -1876,7 +2040,10 @@ struct DoLayerBlend : Base
 
   static constexpr gint max_n_iterators = Base::max_n_iterators + 2;
 
+  using blend_type = typename Base::blend_type;
+
   const Babl             *iterator_format;
+  const Babl             *buffer_format;
   GimpOperationLayerMode *layer_mode = NULL;
 
   explicit
@@ -1893,6 +2060,11 @@ struct DoLayerBlend : Base
                                                   gimp_temp_buf_get_format (params->paint_buf));
 
     g_return_if_fail (gimp_temp_buf_get_format (params->paint_buf) == iterator_format);
+
+    if (Base::blend_direct)
+      buffer_format = gegl_buffer_get_format (params->src_buffer);
+    else
+      buffer_format = iterator_format;
   }
 
   template <class Derived>
@@ -1902,10 +2074,13 @@ struct DoLayerBlend : Base
 
     GeglRectangle  process_roi;
 
-    gfloat        *out_pixel;
-    gfloat        *in_pixel;
+    blend_type    *out_pixel;
+    blend_type    *in_pixel;
     gfloat        *mask_pixel;
     gfloat        *paint_pixel;
+
+    gfloat        *in_row;
+    gfloat        *out_row;
   };
 
   template <class Derived>
@@ -1917,14 +2092,14 @@ struct DoLayerBlend : Base
         const GeglRectangle            *area) const
   {
     state->iterator_base = gegl_buffer_iterator_add (iter, params->src_buffer,
-                                                     area, 0, iterator_format,
+                                                     area, 0, buffer_format,
                                                      GEGL_ACCESS_READ,
                                                      GEGL_ABYSS_NONE);
 
     if (! has_comp_buffer ((const Derived *) this))
       {
         gegl_buffer_iterator_add (iter, params->dest_buffer, area, 0,
-                                  iterator_format,
+                                  buffer_format,
                                   GEGL_ACCESS_WRITE, GEGL_ABYSS_NONE);
       }
 
@@ -1946,7 +2121,8 @@ struct DoLayerBlend : Base
   {
     Base::init_step (params, state, iter, roi, area, rect);
 
-    state->in_pixel = (gfloat *) iter->items[state->iterator_base + 0].data;
+    state->in_pixel =
+      (blend_type *) iter->items[state->iterator_base + 0].data;
 
     state->paint_pixel = this->paint_data                        +
                          (rect->y - roi->y) * this->paint_stride +
@@ -1959,7 +2135,22 @@ struct DoLayerBlend : Base
       }
 
     if (! has_comp_buffer ((const Derived *) this))
-      state->out_pixel = (gfloat *) iter->items[state->iterator_base + 1].data;
+      {
+        state->out_pixel =
+          (blend_type *) iter->items[state->iterator_base + 1].data;
+      }
+
+    if (Base::blend_direct)
+      {
+        state->in_row = (gfloat *) gegl_scratch_alloc (
+          sizeof (gfloat) * 4 * rect->width);
+
+        if (! has_comp_buffer ((const Derived *) this))
+          {
+            state->out_row = (gfloat *) gegl_scratch_alloc (
+              sizeof (gfloat) * 4 * rect->width);
+          }
+      }
 
     state->process_roi.x      = rect->x;
     state->process_roi.width  = rect->width;
@@ -1978,6 +2169,7 @@ struct DoLayerBlend : Base
   {
     Base::process_row (params, state, iter, roi, area, rect, y);
 
+    gfloat *in_pixel;
     gfloat *mask_pixel;
     gfloat *out_pixel;
 
@@ -1988,21 +2180,37 @@ struct DoLayerBlend : Base
     else
       mask_pixel = NULL;
 
-    if (! has_comp_buffer ((const Derived *) this))
+    if (Base::blend_direct)
       {
-        out_pixel = state->out_pixel;
+        blend_row_to_float<blend_type, Base::blend_components> (
+          state->in_pixel, state->in_row, rect->width);
+
+        in_pixel = state->in_row;
       }
     else
+      {
+        in_pixel = (gfloat *) state->in_pixel;
+      }
+
+    if (has_comp_buffer ((const Derived *) this))
       {
         out_pixel = comp_buffer_data (
           (const Derived *) this,
           (typename Derived::template State<Derived> *) state);
       }
+    else if (Base::blend_direct)
+      {
+        out_pixel = state->out_row;
+      }
+    else
+      {
+        out_pixel = (gfloat *) state->out_pixel;
+      }
 
     state->process_roi.y = y;
 
     layer_mode->function ((GeglOperation*) layer_mode,
-                          state->in_pixel,
+                          in_pixel,
                           state->paint_pixel,
                           mask_pixel,
                           out_pixel,
@@ -2010,12 +2218,34 @@ struct DoLayerBlend : Base
                           &state->process_roi,
                           0);
 
-    state->in_pixel     += rect->width * 4;
+    if (Base::blend_direct && ! has_comp_buffer ((const Derived *) this))
+      {
+        blend_row_from_float<blend_type, Base::blend_components> (
+          state->out_row, state->out_pixel, rect->width);
+      }
+
+    state->in_pixel     += rect->width * Base::blend_components;
     state->paint_pixel  += this->paint_stride;
     if (! has_comp_mask (this) && has_mask_buffer_iterator (this))
       state->mask_pixel += rect->width;
     if (! has_comp_buffer ((const Derived *) this))
-      state->out_pixel  += rect->width * 4;
+      state->out_pixel  += rect->width * Base::blend_components;
+  }
+
+  template <class Derived>
+  void
+  finalize_step (const GimpPaintCoreLoopsParams *params,
+                 State<Derived>                 *state) const
+  {
+    if (Base::blend_direct)
+      {
+        gegl_scratch_free (state->in_row);
+
+        if (! has_comp_buffer ((const Derived *) this))
+          gegl_scratch_free (state->out_row);
+      }
+
+    Base::finalize_step (params, state);
   }
 };
 
@@ -2023,7 +2253,8 @@ static MandatoryAlgorithmDispatch<
   DoLayerBlend,
   GIMP_PAINT_CORE_LOOPS_ALGORITHM_DO_LAYER_BLEND,
   decltype (dispatch_paint_buf),
-  decltype (dispatch_mask_buffer_iterator)
+  decltype (dispatch_mask_buffer_iterator),
+  decltype (dispatch_blend_buffer)
 >
 dispatch_do_layer_blend;
 
@@ -20,6 +20,7 @@
 
 #include <string.h>
 
+#include <cairo.h>
 #include <gdk-pixbuf/gdk-pixbuf.h>
 #include <gegl.h>
 
@@ -33,10 +34,12 @@
 #include "gegl/gimp-babl.h"
 #include "gegl/gimp-gegl-loops.h"
 #include "gegl/gimp-gegl-nodes.h"
+#include "gegl/gimp-gegl-tile-share.h"
 #include "gegl/gimp-gegl-utils.h"
 #include "gegl/gimpapplicator.h"
 
 #include "core/gimp.h"
+#include "core/gimp-trace.h"
 #include "core/gimp-utils.h"
 #include "core/gimpchannel.h"
 #include "core/gimpimage.h"
@@ -118,6 +121,13 @@ static GimpUndo* gimp_paint_core_real_push_undo      (GimpPaintCore    *core,
                                                       GimpImage        *image,
                                                       const gchar      *undo_desc);
 
+static cairo_region_t *
+                 gimp_paint_core_get_dirty_region    (GimpPaintCore    *core,
+                                                      GimpDrawable     *drawable);
+static void      gimp_paint_core_update_drawable     (GimpPaintCore       *core,
+                                                      GimpDrawable        *drawable,
+                                                      const GeglRectangle *rect);
+
 
 G_DEFINE_TYPE (GimpPaintCore, gimp_paint_core, GIMP_TYPE_OBJECT)
 
@@ -155,6 +165,7 @@ gimp_paint_core_init (GimpPaintCore *core)
 {
   core->ID = global_core_ID++;
   core->undo_buffers = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_object_unref);
+  core->pending_updates = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
 }
 
 static void
@@ -166,6 +177,7 @@ gimp_paint_core_finalize (GObject *object)
 
   g_clear_pointer (&core->undo_desc, g_free);
   g_hash_table_unref (core->undo_buffers);
+  g_hash_table_unref (core->pending_updates);
   if (core->applicators)
     g_hash_table_unref (core->applicators);
 
@@ -296,6 +308,53 @@ gimp_paint_core_real_push_undo (GimpPaintCore *core,
                                NULL);
 }
 
+static cairo_region_t *
+gimp_paint_core_get_dirty_region (GimpPaintCore *core,
+                                  GimpDrawable  *drawable)
+{
+  cairo_region_t *region;
+
+  if (core->dirty_region)
+    region = cairo_region_copy (core->dirty_region);
+  else
+    region = cairo_region_create ();
+
+  cairo_region_intersect_rectangle (
+    region,
+    &(cairo_rectangle_int_t) {0, 0,
+                              gimp_item_get_width  (GIMP_ITEM (drawable)),
+                              gimp_item_get_height (GIMP_ITEM (drawable))});
+
+  return region;
+}
+
+static void
+gimp_paint_core_update_drawable (GimpPaintCore       *core,
+                                 GimpDrawable        *drawable,
+                                 const GeglRectangle *rect)
+{
+  if (core->updates_frozen)
+    {
+      GeglRectangle *area = g_hash_table_lookup (core->pending_updates,
+                                                 drawable);
+
+      if (area)
+        {
+          gegl_rectangle_bounding_box (area, area, rect);
+        }
+      else
+        {
+          g_hash_table_insert (core->pending_updates,
+                               drawable, g_memdup2 (rect, sizeof (*rect)));
+        }
+    }
+  else
+    {
+      gimp_drawable_update (drawable,
+                            rect->x, rect->y, rect->width, rect->height);
+    }
+}
+
 
 /*  public functions  */
 
@@ -333,10 +392,14 @@ gimp_paint_core_paint (GimpPaintCore    *core,
       sym = g_object_ref (gimp_image_get_active_symmetry (image));
       gimp_symmetry_set_origin (sym, drawables->data, &core->cur_coords);
 
+      gimp_trace_begin ("paint", G_OBJECT_TYPE_NAME (core));
+
       core_class->paint (core, drawables,
                          paint_options,
                          sym, paint_state, time);
 
+      gimp_trace_end ();
+
       gimp_symmetry_clear_origin (sym);
       g_object_unref (sym);
 
@@ -433,6 +496,9 @@ gimp_paint_core_start (GimpPaintCore     *core,
   core->x1 = core->x2 = core->cur_coords.x;
   core->y1 = core->y2 = core->cur_coords.y;
 
+  g_clear_pointer (&core->dirty_region, cairo_region_destroy);
+  core->dirty_region = cairo_region_create ();
+
   core->last_paint.x = -1e6;
   core->last_paint.y = -1e6;
 
@@ -526,9 +592,10 @@ gimp_paint_core_finish (GimpPaintCore *core,
 
       if (push_undo)
         {
-          GeglBuffer    *undo_buffer;
-          GeglBuffer    *buffer;
-          GeglRectangle  rect;
+          GeglBuffer     *undo_buffer;
+          cairo_region_t *region;
+          gint            n_rects;
+          gint            i;
 
           if (! g_hash_table_steal_extended (core->undo_buffers, iter->data,
                                              NULL, (gpointer*) &undo_buffer))
@@ -538,16 +605,6 @@ gimp_paint_core_finish (GimpPaintCore *core,
               continue;
             }
 
-          gimp_rectangle_intersect (core->x1, core->y1,
-                                    core->x2 - core->x1, core->y2 - core->y1,
-                                    0, 0,
-                                    gimp_item_get_width  (GIMP_ITEM (iter->data)),
-                                    gimp_item_get_height (GIMP_ITEM (iter->data)),
-                                    &rect.x, &rect.y, &rect.width, &rect.height);
-
-          gegl_rectangle_align_to_buffer (&rect, &rect, undo_buffer,
-                                          GEGL_RECTANGLE_ALIGNMENT_SUPERSET);
-
           if (! undo_group_started)
             {
               gimp_image_undo_group_start (image, GIMP_UNDO_GROUP_PAINT,
@@ -557,19 +614,45 @@ gimp_paint_core_finish (GimpPaintCore *core,
 
           GIMP_PAINT_CORE_GET_CLASS (core)->push_undo (core, image, NULL);
 
-          buffer = gegl_buffer_new (GEGL_RECTANGLE (0, 0, rect.width, rect.height),
-                                    gimp_drawable_get_format (iter->data));
-
-          gimp_gegl_buffer_copy (undo_buffer,
-                                 &rect,
-                                 GEGL_ABYSS_NONE,
-                                 buffer,
-                                 GEGL_RECTANGLE (0, 0, 0, 0));
+          /*  only keep the tiles which have actually been painted on,
+           *  instead of everything within the stroke's extents
+           */
+          region  = gimp_paint_core_get_dirty_region (core, iter->data);
+          n_rects = cairo_region_num_rectangles (region);
 
-          gimp_drawable_push_undo (iter->data, NULL,
-                                   buffer, rect.x, rect.y, rect.width, rect.height);
+          for (i = 0; i < n_rects; i++)
+            {
+              GeglBuffer    *buffer;
+              GeglRectangle  rect;
+
+              cairo_region_get_rectangle (region, i,
+                                          (cairo_rectangle_int_t *) &rect);
+
+              /*  the stroke's dirty tiles include ones it didn't actually
+               *  change, let those go back to sharing the undo buffer's
+               */
+              gimp_gegl_buffer_share_unchanged_tiles (
+                gimp_drawable_get_buffer (iter->data), &rect,
+                undo_buffer, rect.x, rect.y);
+
+              buffer = gegl_buffer_new (GEGL_RECTANGLE (0, 0,
+                                                        rect.width, rect.height),
+                                        gimp_drawable_get_format (iter->data));
+
+              gimp_gegl_buffer_copy (undo_buffer,
+                                     &rect,
+                                     GEGL_ABYSS_NONE,
+                                     buffer,
+                                     GEGL_RECTANGLE (0, 0, 0, 0));
+
+              gimp_drawable_push_undo (iter->data, NULL,
+                                       buffer,
+                                       rect.x, rect.y, rect.width, rect.height);
+
+              g_object_unref (buffer);
+            }
 
-          g_object_unref (buffer);
+          cairo_region_destroy (region);
           g_object_unref (undo_buffer);
         }
 
@@ -579,6 +662,7 @@ gimp_paint_core_finish (GimpPaintCore *core,
   core->image_pickable = NULL;
 
   g_clear_object (&core->saved_proj_buffer);
+  g_clear_pointer (&core->dirty_region, cairo_region_destroy);
 
   if (undo_group_started)
     gimp_image_undo_group_end (image);
@@ -588,9 +672,6 @@ void
 gimp_paint_core_cancel (GimpPaintCore *core,
                         GList         *drawables)
 {
-  gint x, y;
-  gint width, height;
-
   g_return_if_fail (GIMP_IS_PAINT_CORE (core));
 
   /*  Determine if any part of the image has been altered--
@@ -601,44 +682,48 @@ gimp_paint_core_cancel (GimpPaintCore *core,
 
   for (GList *iter = drawables; iter; iter = iter->next)
     {
-      if (gimp_rectangle_intersect (core->x1, core->y1,
-                                    core->x2 - core->x1,
-                                    core->y2 - core->y1,
-                                    0, 0,
-                                    gimp_item_get_width  (GIMP_ITEM (iter->data)),
-                                    gimp_item_get_height (GIMP_ITEM (iter->data)),
-                                    &x, &y, &width, &height))
+      GeglBuffer     *undo_buffer;
+      cairo_region_t *region;
+      gint            n_rects;
+      gint            i;
+
+      if (! g_hash_table_steal_extended (core->undo_buffers, iter->data,
+                                         NULL, (gpointer*) &undo_buffer))
         {
-          GeglBuffer    *undo_buffer;
-          GeglRectangle  rect;
+          g_critical ("%s: missing undo buffer for '%s'.",
+                      G_STRFUNC, gimp_object_get_name (iter->data));
+          continue;
+        }
 
-          if (! g_hash_table_steal_extended (core->undo_buffers, iter->data,
-                                             NULL, (gpointer*) &undo_buffer))
-            {
-              g_critical ("%s: missing undo buffer for '%s'.",
-                          G_STRFUNC, gimp_object_get_name (iter->data));
-              continue;
-            }
+      /*  restore, and update, only the tiles which have been painted on  */
+      region  = gimp_paint_core_get_dirty_region (core, iter->data);
+      n_rects = cairo_region_num_rectangles (region);
+
+      for (i = 0; i < n_rects; i++)
+        {
+          GeglRectangle rect;
 
-          gegl_rectangle_align_to_buffer (&rect,
-                                          GEGL_RECTANGLE (x, y, width, height),
-                                          gimp_drawable_get_buffer (iter->data),
-                                          GEGL_RECTANGLE_ALIGNMENT_SUPERSET);
+          cairo_region_get_rectangle (region, i,
+                                      (cairo_rectangle_int_t *) &rect);
 
           gimp_gegl_buffer_copy (undo_buffer,
                                  &rect,
                                  GEGL_ABYSS_NONE,
                                  gimp_drawable_get_buffer (iter->data),
                                  &rect);
-          g_object_unref (undo_buffer);
+
+          gimp_drawable_update (iter->data,
+                                rect.x, rect.y, rect.width, rect.height);
         }
 
-      gimp_drawable_update (iter->data, x, y, width, height);
+      cairo_region_destroy (region);
+      g_object_unref (undo_buffer);
 
       gimp_viewable_preview_thaw (GIMP_VIEWABLE (iter->data));
     }
 
   g_clear_object (&core->saved_proj_buffer);
+  g_clear_pointer (&core->dirty_region, cairo_region_destroy);
 }
 
 void
@@ -651,6 +736,54 @@ gimp_paint_core_cleanup (GimpPaintCore *core)
   g_clear_object (&core->saved_proj_buffer);
   g_clear_object (&core->canvas_buffer);
   g_clear_object (&core->paint_buffer);
+
+  g_clear_pointer (&core->dirty_region, cairo_region_destroy);
+}
+
+/**
+ * gimp_paint_core_freeze_updates:
+ * @core: a #GimpPaintCore
+ *
+ * Collects the updates of the painted drawables, instead of emitting one
+ * for each dab, until the matching gimp_paint_core_thaw_updates().
+ */
+void
+gimp_paint_core_freeze_updates (GimpPaintCore *core)
+{
+  g_return_if_fail (GIMP_IS_PAINT_CORE (core));
+
+  core->updates_frozen++;
+}
+
+/**
+ * gimp_paint_core_thaw_updates:
+ * @core: a #GimpPaintCore
+ *
+ * Emits the updates collected since gimp_paint_core_freeze_updates(),
+ * one per drawable, once the last freeze is undone.
+ */
+void
+gimp_paint_core_thaw_updates (GimpPaintCore *core)
+{
+  GHashTableIter  iter;
+  gpointer        drawable;
+  GeglRectangle  *rect;
+
+  g_return_if_fail (GIMP_IS_PAINT_CORE (core));
+  g_return_if_fail (core->updates_frozen > 0);
+
+  if (--core->updates_frozen > 0)
+    return;
+
+  g_hash_table_iter_init (&iter, core->pending_updates);
+
+  while (g_hash_table_iter_next (&iter, &drawable, (gpointer *) &rect))
+    {
+      gimp_drawable_update (drawable,
+                            rect->x, rect->y, rect->width, rect->height);
+
+      g_hash_table_iter_remove (&iter);
+    }
 }
 
 void
@@ -844,6 +977,43 @@ gimp_paint_core_get_orig_proj (GimpPaintCore *core)
   return core->saved_proj_buffer;
 }
 
+/**
+ * gimp_paint_core_add_dirty_rect:
+ * @core:     a #GimpPaintCore
+ * @drawable: the #GimpDrawable that was painted on
+ * @rect:     the painted area, in @drawable's coordinates
+ *
+ * Adds @rect to the stroke's undo extents.  The area is tracked in
+ * whole tiles of @drawable's buffer, so that only the tiles which were
+ * actually painted on are copied to the undo, and restored on cancel.
+ */
+void
+gimp_paint_core_add_dirty_rect (GimpPaintCore       *core,
+                                GimpDrawable        *drawable,
+                                const GeglRectangle *rect)
+{
+  GeglRectangle tile_rect;
+
+  g_return_if_fail (GIMP_IS_PAINT_CORE (core));
+  g_return_if_fail (GIMP_IS_DRAWABLE (drawable));
+  g_return_if_fail (rect != NULL);
+
+  core->x1 = MIN (core->x1, rect->x);
+  core->y1 = MIN (core->y1, rect->y);
+  core->x2 = MAX (core->x2, rect->x + rect->width);
+  core->y2 = MAX (core->y2, rect->y + rect->height);
+
+  if (core->dirty_region)
+    {
+      gegl_rectangle_align_to_buffer (&tile_rect, rect,
+                                      gimp_drawable_get_buffer (drawable),
+                                      GEGL_RECTANGLE_ALIGNMENT_SUPERSET);
+
+      cairo_region_union_rectangle (core->dirty_region,
+                                    (cairo_rectangle_int_t *) &tile_rect);
+    }
+}
+
 void
 gimp_paint_core_paste (GimpPaintCore            *core,
                        const GimpTempBuf        *paint_mask,
@@ -868,6 +1038,8 @@ gimp_paint_core_paste (GimpPaintCore            *core,
   if (core->applicators)
     {
       GimpApplicator *applicator;
+      gint            offset_x;
+      gint            offset_y;
 
       applicator = g_hash_table_lookup (core->applicators, drawable);
 
@@ -930,6 +1102,13 @@ gimp_paint_core_paste (GimpPaintCore            *core,
                                           gimp_drawable_get_buffer (drawable));
         }
 
+      /*  gimp_paint_core_replace() leaves its own mask buffer behind,
+       *  instead of restoring ours after every dab
+       */
+      gimp_item_get_offset (GIMP_ITEM (drawable), &offset_x, &offset_y);
+      gimp_applicator_set_mask_buffer (applicator, core->mask_buffer);
+      gimp_applicator_set_mask_offset (applicator, -offset_x, -offset_y);
+
       gimp_applicator_set_apply_buffer (applicator,
                                         core->paint_buffer);
       gimp_applicator_set_apply_offset (applicator,
@@ -1024,16 +1203,16 @@ gimp_paint_core_paste (GimpPaintCore            *core,
     }
 
   /*  Update the undo extents  */
-  core->x1 = MIN (core->x1, core->paint_buffer_x);
-  core->y1 = MIN (core->y1, core->paint_buffer_y);
-  core->x2 = MAX (core->x2, core->paint_buffer_x + width);
-  core->y2 = MAX (core->y2, core->paint_buffer_y + height);
+  gimp_paint_core_add_dirty_rect (core, drawable,
+                                  GEGL_RECTANGLE (core->paint_buffer_x,
+                                                  core->paint_buffer_y,
+                                                  width, height));
 
   /*  Update the drawable  */
-  gimp_drawable_update (drawable,
-                        core->paint_buffer_x,
-                        core->paint_buffer_y,
-                        width, height);
+  gimp_paint_core_update_drawable (core, drawable,
+                                   GEGL_RECTANGLE (core->paint_buffer_x,
+                                                   core->paint_buffer_y,
+                                                   width, height));
 }
 
 /* This works similarly to gimp_paint_core_paste. However, instead of
@@ -1204,9 +1383,6 @@ gimp_paint_core_replace (GimpPaintCore            *core,
                                             core->paint_buffer_y,
                                             width, height));
 
-      gimp_applicator_set_mask_buffer (applicator, core->mask_buffer);
-      gimp_applicator_set_mask_offset (applicator, -offset_x, -offset_y);
-
       g_object_unref (mask_buffer);
     }
   else
@@ -1223,16 +1399,16 @@ gimp_paint_core_replace (GimpPaintCore            *core,
     }
 
   /*  Update the undo extents  */
-  core->x1 = MIN (core->x1, core->paint_buffer_x);
-  core->y1 = MIN (core->y1, core->paint_buffer_y);
-  core->x2 = MAX (core->x2, core->paint_buffer_x + width);
-  core->y2 = MAX (core->y2, core->paint_buffer_y + height);
+  gimp_paint_core_add_dirty_rect (core, drawable,
+                                  GEGL_RECTANGLE (core->paint_buffer_x,
+                                                  core->paint_buffer_y,
+                                                  width, height));
 
   /*  Update the drawable  */
-  gimp_drawable_update (drawable,
-                        core->paint_buffer_x,
-                        core->paint_buffer_y,
-                        width, height);
+  gimp_paint_core_update_drawable (core, drawable,
+                                   GEGL_RECTANGLE (core->paint_buffer_x,
+                                                   core->paint_buffer_y,
+                                                   width, height));
 }
 
 /**
@@ -54,6 +54,8 @@ struct _GimpPaintCore
 
   gint            x1, y1;            /*  undo extents in image coords        */
   gint            x2, y2;            /*  undo extents in image coords        */
+  struct _cairo_region
+                 *dirty_region;      /*  modified tiles, within the extents  */
 
   gboolean        use_saved_proj;    /*  keep the unmodified proj around     */
 
@@ -70,6 +72,9 @@ struct _GimpPaintCore
 
   GHashTable     *applicators;
 
+  gint            updates_frozen;    /*  batch drawable updates              */
+  GHashTable     *pending_updates;   /*  drawable -> area to update          */
+
   GArray         *stroke_buffer;
 };
 
@@ -142,6 +147,9 @@ void      gimp_paint_core_cancel                    (GimpPaintCore    *core,
                                                      GList            *drawables);
 void      gimp_paint_core_cleanup                   (GimpPaintCore    *core);
 
+void      gimp_paint_core_freeze_updates            (GimpPaintCore    *core);
+void      gimp_paint_core_thaw_updates              (GimpPaintCore    *core);
+
 void      gimp_paint_core_interpolate               (GimpPaintCore    *core,
                                                      GList            *drawables,
                                                      GimpPaintOptions *paint_options,
@@ -188,6 +196,10 @@ GeglBuffer * gimp_paint_core_get_orig_image         (GimpPaintCore    *core,
                                                      GimpDrawable     *drawable);
 GeglBuffer * gimp_paint_core_get_orig_proj          (GimpPaintCore    *core);
 
+void      gimp_paint_core_add_dirty_rect            (GimpPaintCore       *core,
+                                                     GimpDrawable        *drawable,
+                                                     const GeglRectangle *rect);
+
 void      gimp_paint_core_paste             (GimpPaintCore            *core,
                                              const GimpTempBuf        *paint_mask,
                                              gint                      paint_mask_offset_x,
@@ -102,6 +102,7 @@ gimp_smudge_class_init (GimpSmudgeClass *klass)
   brush_core_class->handles_changing_brush             = TRUE;
   brush_core_class->handles_transforming_brush         = TRUE;
   brush_core_class->handles_dynamic_transforming_brush = TRUE;
+  brush_core_class->needs_immediate_updates            = TRUE;
 }
 
 static void
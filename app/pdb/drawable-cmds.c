@@ -686,6 +686,114 @@ drawable_set_pixel_invoker (GimpProcedure         *procedure,
                                            error ? *error : NULL);
 }
 
+static GimpValueArray *
+drawable_get_pixels_invoker (GimpProcedure         *procedure,
+                             Gimp                  *gimp,
+                             GimpContext           *context,
+                             GimpProgress          *progress,
+                             const GimpValueArray  *args,
+                             GError               **error)
+{
+  gboolean success = TRUE;
+  GimpValueArray *return_vals;
+  GimpDrawable *drawable;
+  gint x;
+  gint y;
+  gint width;
+  gint height;
+  gint num_bytes = 0;
+  guint8 *pixels = NULL;
+
+  drawable = g_value_get_object (gimp_value_array_index (args, 0));
+  x = g_value_get_int (gimp_value_array_index (args, 1));
+  y = g_value_get_int (gimp_value_array_index (args, 2));
+  width = g_value_get_int (gimp_value_array_index (args, 3));
+  height = g_value_get_int (gimp_value_array_index (args, 4));
+
+  if (success)
+    {
+      const Babl *format = gimp_drawable_get_format (drawable);
+      gint64      size;
+
+      size = (gint64) width * height * babl_format_get_bytes_per_pixel (format);
+
+      if ((gint64) x + width  <= gimp_item_get_width  (GIMP_ITEM (drawable)) &&
+          (gint64) y + height <= gimp_item_get_height (GIMP_ITEM (drawable)) &&
+          size <= G_MAXINT32)
+        {
+          num_bytes = size;
+          pixels    = g_new (guint8, num_bytes);
+
+          gegl_buffer_get (gimp_drawable_get_buffer (drawable),
+                           GEGL_RECTANGLE (x, y, width, height), 1.0,
+                           format, pixels,
+                           GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
+        }
+      else
+        success = FALSE;
+    }
+
+  return_vals = gimp_procedure_get_return_values (procedure, success,
+                                                  error ? *error : NULL);
+
+  if (success)
+    {
+      g_value_set_int (gimp_value_array_index (return_vals, 1), num_bytes);
+      gimp_value_take_uint8_array (gimp_value_array_index (return_vals, 2), pixels, num_bytes);
+    }
+
+  return return_vals;
+}
+
+static GimpValueArray *
+drawable_set_pixels_invoker (GimpProcedure         *procedure,
+                             Gimp                  *gimp,
+                             GimpContext           *context,
+                             GimpProgress          *progress,
+                             const GimpValueArray  *args,
+                             GError               **error)
+{
+  gboolean success = TRUE;
+  GimpDrawable *drawable;
+  gint x;
+  gint y;
+  gint width;
+  gint height;
+  gint num_bytes;
+  const guint8 *pixels;
+
+  drawable = g_value_get_object (gimp_value_array_index (args, 0));
+  x = g_value_get_int (gimp_value_array_index (args, 1));
+  y = g_value_get_int (gimp_value_array_index (args, 2));
+  width = g_value_get_int (gimp_value_array_index (args, 3));
+  height = g_value_get_int (gimp_value_array_index (args, 4));
+  num_bytes = g_value_get_int (gimp_value_array_index (args, 5));
+  pixels = gimp_value_get_uint8_array (gimp_value_array_index (args, 6));
+
+  if (success)
+    {
+      const Babl *format = gimp_drawable_get_format (drawable);
+
+      if (gimp_pdb_item_is_modifiable (GIMP_ITEM (drawable),
+                                       GIMP_PDB_ITEM_CONTENT, error) &&
+          gimp_pdb_item_is_not_group (GIMP_ITEM (drawable), error) &&
+          (gint64) x + width  <= gimp_item_get_width  (GIMP_ITEM (drawable)) &&
+          (gint64) y + height <= gimp_item_get_height (GIMP_ITEM (drawable)) &&
+          num_bytes == ((gint64) width * height *
+                        babl_format_get_bytes_per_pixel (format)))
+        {
+          gegl_buffer_set (gimp_drawable_get_buffer (drawable),
+                           GEGL_RECTANGLE (x, y, width, height),
+                           0, format, pixels, GEGL_AUTO_ROWSTRIDE);
+        }
+      else
+        success = FALSE;
+    }
+
+  return gimp_procedure_get_return_values (procedure, success,
+                                           error ? *error : NULL);
+}
+
 static GimpValueArray *
 drawable_fill_invoker (GimpProcedure         *procedure,
                        Gimp                  *gimp,
@@ -945,6 +1053,7 @@ drawable_foreground_extract_invoker (GimpProcedure         *procedure,
                                                      2,
                                                      2,
                                                      gimp_drawable_get_buffer (mask),
+                                                     1.0,
                                                      progress);
 
           gimp_channel_select_buffer (gimp_image_get_mask (image),
@@ -1637,6 +1746,122 @@ register_drawable_procs (GimpPDB *pdb)
   gimp_pdb_register_procedure (pdb, procedure);
   g_object_unref (procedure);
 
+  /*
+   * gimp-drawable-get-pixels
+   */
+  procedure = gimp_procedure_new (drawable_get_pixels_invoker);
+  gimp_object_set_static_name (GIMP_OBJECT (procedure),
+                               "gimp-drawable-get-pixels");
+  gimp_procedure_set_static_help (procedure,
+                                  "Gets the pixel values of a rectangle of the drawable.",
+                                  "This procedure gets the pixel values of the specified rectangle, in the drawable's format, row by row without padding. The rectangle must lie within the drawable. Use this procedure instead of 'gimp-drawable-get-pixel' when reading more than a few pixels.",
+                                  NULL);
+  gimp_procedure_set_static_attribution (procedure,
+                                         "Spencer Kimball & Peter Mattis",
+                                         "Spencer Kimball & Peter Mattis",
+                                         "2026");
+  gimp_procedure_add_argument (procedure,
+                               gimp_param_spec_drawable ("drawable",
+                                                         "drawable",
+                                                         "The drawable",
+                                                         FALSE,
+                                                         GIMP_PARAM_READWRITE));
+  gimp_procedure_add_argument (procedure,
+                               g_param_spec_int ("x",
+                                                 "x",
+                                                 "x coordinate of upper left corner of the rectangle",
+                                                 0, G_MAXINT32, 0,
+                                                 GIMP_PARAM_READWRITE));
+  gimp_procedure_add_argument (procedure,
+                               g_param_spec_int ("y",
+                                                 "y",
+                                                 "y coordinate of upper left corner of the rectangle",
+                                                 0, G_MAXINT32, 0,
+                                                 GIMP_PARAM_READWRITE));
+  gimp_procedure_add_argument (procedure,
+                               g_param_spec_int ("width",
+                                                 "width",
+                                                 "Width of the rectangle",
+                                                 1, G_MAXINT32, 1,
+                                                 GIMP_PARAM_READWRITE));
+  gimp_procedure_add_argument (procedure,
+                               g_param_spec_int ("height",
+                                                 "height",
+                                                 "Height of the rectangle",
+                                                 1, G_MAXINT32, 1,
+                                                 GIMP_PARAM_READWRITE));
+  gimp_procedure_add_return_value (procedure,
+                                   g_param_spec_int ("num-bytes",
+                                                     "num bytes",
+                                                     "The number of bytes of pixel data",
+                                                     0, G_MAXINT32, 0,
+                                                     GIMP_PARAM_READWRITE | GIMP_PARAM_NO_VALIDATE));
+  gimp_procedure_add_return_value (procedure,
+                                   gimp_param_spec_uint8_array ("pixels",
+                                                                "pixels",
+                                                                "The pixel values",
+                                                                GIMP_PARAM_READWRITE));
+  gimp_pdb_register_procedure (pdb, procedure);
+  g_object_unref (procedure);
+
+  /*
+   * gimp-drawable-set-pixels
+   */
+  procedure = gimp_procedure_new (drawable_set_pixels_invoker);
+  gimp_object_set_static_name (GIMP_OBJECT (procedure),
+                               "gimp-drawable-set-pixels");
+  gimp_procedure_set_static_help (procedure,
+                                  "Sets the pixel values of a rectangle of the drawable.",
+                                  "This procedure sets the pixel values of the specified rectangle, in the drawable's format, row by row without padding. The rectangle must lie within the drawable and 'num_bytes' must be equal to the size of its pixel data. Note that this function is not undoable, you should use it only on drawables you just created yourself.",
+                                  NULL);
+  gimp_procedure_set_static_attribution (procedure,
+                                         "Spencer Kimball & Peter Mattis",
+                                         "Spencer Kimball & Peter Mattis",
+                                         "2026");
+  gimp_procedure_add_argument (procedure,
+                               gimp_param_spec_drawable ("drawable",
+                                                         "drawable",
+                                                         "The drawable",
+                                                         FALSE,
+                                                         GIMP_PARAM_READWRITE));
+  gimp_procedure_add_argument (procedure,
+                               g_param_spec_int ("x",
+                                                 "x",
+                                                 "x coordinate of upper left corner of the rectangle",
+                                                 0, G_MAXINT32, 0,
+                                                 GIMP_PARAM_READWRITE));
+  gimp_procedure_add_argument (procedure,
+                               g_param_spec_int ("y",
+                                                 "y",
+                                                 "y coordinate of upper left corner of the rectangle",
+                                                 0, G_MAXINT32, 0,
+                                                 GIMP_PARAM_READWRITE));
+  gimp_procedure_add_argument (procedure,
+                               g_param_spec_int ("width",
+                                                 "width",
+                                                 "Width of the rectangle",
+                                                 1, G_MAXINT32, 1,
+                                                 GIMP_PARAM_READWRITE));
+  gimp_procedure_add_argument (procedure,
+                               g_param_spec_int ("height",
+                                                 "height",
+                                                 "Height of the rectangle",
+                                                 1, G_MAXINT32, 1,
+                                                 GIMP_PARAM_READWRITE));
+  gimp_procedure_add_argument (procedure,
+                               g_param_spec_int ("num-bytes",
+                                                 "num bytes",
+                                                 "The number of bytes of pixel data",
+                                                 0, G_MAXINT32, 0,
+                                                 GIMP_PARAM_READWRITE | GIMP_PARAM_NO_VALIDATE));
+  gimp_procedure_add_argument (procedure,
+                               gimp_param_spec_uint8_array ("pixels",
+                                                            "pixels",
+                                                            "The pixel values",
+                                                            GIMP_PARAM_READWRITE));
+  gimp_pdb_register_procedure (pdb, procedure);
+  g_object_unref (procedure);
+
   /*
    * gimp-drawable-fill
    */
@@ -72,6 +72,7 @@ static void        gimp_procedure_real_execute_async    (GimpProcedure   *proced
 static void          gimp_procedure_free_help           (GimpProcedure   *procedure);
 static void          gimp_procedure_free_attribution    (GimpProcedure   *procedure);
 
+static gboolean      gimp_procedure_value_type_is_scalar (GType            type);
 static gboolean      gimp_procedure_validate_args       (GimpProcedure   *procedure,
                                                          GParamSpec     **param_specs,
                                                          gint             n_param_specs,
@@ -822,6 +823,31 @@ gimp_procedure_free_attribution (GimpProcedure *procedure)
   procedure->static_attribution = FALSE;
 }
 
+static gboolean
+gimp_procedure_value_type_is_scalar (GType type)
+{
+  switch (G_TYPE_FUNDAMENTAL (type))
+    {
+    case G_TYPE_CHAR:
+    case G_TYPE_UCHAR:
+    case G_TYPE_BOOLEAN:
+    case G_TYPE_INT:
+    case G_TYPE_UINT:
+    case G_TYPE_LONG:
+    case G_TYPE_ULONG:
+    case G_TYPE_INT64:
+    case G_TYPE_UINT64:
+    case G_TYPE_ENUM:
+    case G_TYPE_FLAGS:
+    case G_TYPE_FLOAT:
+    case G_TYPE_DOUBLE:
+      return TRUE;
+
+    default:
+      return FALSE;
+    }
+}
+
 static gboolean
 gimp_procedure_validate_args (GimpProcedure  *procedure,
                               GParamSpec    **param_specs,
@@ -871,17 +897,37 @@ gimp_procedure_validate_args (GimpProcedure  *procedure,
       else if (! (pspec->flags & GIMP_PARAM_NO_VALIDATE))
         {
           GValue string_value = G_VALUE_INIT;
+          GValue scalar_value = G_VALUE_INIT;
 
           g_value_init (&string_value, G_TYPE_STRING);
 
-          if (g_value_type_transformable (arg_type, G_TYPE_STRING))
-            g_value_transform (arg, &string_value);
+          /*  the string is only needed for the error message; scalars
+           *  are cheap to copy, so only format them when they turn out
+           *  to be invalid
+           */
+          if (gimp_procedure_value_type_is_scalar (arg_type))
+            {
+              g_value_init (&scalar_value, arg_type);
+              g_value_copy (arg, &scalar_value);
+            }
+          else if (g_value_type_transformable (arg_type, G_TYPE_STRING))
+            {
+              g_value_transform (arg, &string_value);
+            }
           else
-            g_value_set_static_string (&string_value,
-                                       "<not transformable to string>");
+            {
+              g_value_set_static_string (&string_value,
+                                         "<not transformable to string>");
+            }
 
           if (g_param_value_validate (pspec, arg))
             {
+              if (G_IS_VALUE (&scalar_value))
+                {
+                  g_value_transform (&scalar_value, &string_value);
+                  g_value_unset (&scalar_value);
+                }
+
               if (GIMP_IS_PARAM_SPEC_DRAWABLE (pspec) &&
                   g_value_get_object (arg) == NULL)
                 {
@@ -984,6 +1030,9 @@ gimp_procedure_validate_args (GimpProcedure  *procedure,
               return FALSE;
             }
 
+          if (G_IS_VALUE (&scalar_value))
+            g_value_unset (&scalar_value);
+
           /*  UTT-8 validate all strings  */
           if (G_PARAM_SPEC_TYPE (pspec) == G_TYPE_PARAM_STRING ||
               G_PARAM_SPEC_TYPE (pspec) == GIMP_TYPE_PARAM_STRING_ARRAY)
@@ -52,6 +52,7 @@
 #include "core/gimpparamspecs.h"
 #include "core/gimppickable.h"
 #include "core/gimpprogress.h"
+#include "core/gimpprojection.h"
 #include "core/gimpselection.h"
 #include "core/gimptempbuf.h"
 #include "file/file-utils.h"
@@ -735,7 +736,16 @@ image_pick_color_invoker (GimpProcedure         *procedure,
             }
 
           if (sample_merged)
-            gimp_pickable_flush (GIMP_PICKABLE (image));
+            {
+              gint radius = sample_average ? floor (average_radius) : 0;
+
+              /*  only construct the part of the projection we sample  */
+              gimp_projection_finish_area (gimp_image_get_projection (image),
+                                           GEGL_RECTANGLE ((gint) x - radius,
+                                                           (gint) y - radius,
+                                                           2 * radius + 1,
+                                                           2 * radius + 1));
+            }
 
           success = gimp_image_pick_color (image,
                                            drawable_list,
@@ -892,7 +902,10 @@ image_freeze_layers_invoker (GimpProcedure         *procedure,
         success = gimp_plug_in_cleanup_layers_freeze (plug_in, image);
 
       if (success)
-        gimp_container_freeze (container);
+        {
+          gimp_container_freeze (container);
+          gimp_viewable_preview_freeze (GIMP_VIEWABLE (image));
+        }
     }
 
   return gimp_procedure_get_return_values (procedure, success,
@@ -924,7 +937,12 @@ image_thaw_layers_invoker (GimpProcedure         *procedure,
         success = gimp_container_frozen (container);
 
       if (success)
-        gimp_container_thaw (container);
+        {
+          gimp_container_thaw (container);
+
+          if (gimp_viewable_preview_is_frozen (GIMP_VIEWABLE (image)))
+            gimp_viewable_preview_thaw (GIMP_VIEWABLE (image));
+        }
     }
 
   return gimp_procedure_get_return_values (procedure, success,
@@ -3668,7 +3686,7 @@ register_image_procs (GimpPDB *pdb)
                                "gimp-image-freeze-layers");
   gimp_procedure_set_static_help (procedure,
                                   "Freeze the image's layer list.",
-                                  "This procedure freezes the layer list of the image, suppressing any updates to the Layers dialog in response to changes to the image's layers. This can significantly improve performance while applying changes affecting the layer list.\n"
+                                  "This procedure freezes the layer list of the image, suppressing any updates to the Layers dialog and to the image's preview in response to changes to the image's layers. This can significantly improve performance while applying changes affecting the layer list.\n"
                                      "\n"
                                      "Each call to 'gimp-image-freeze-layers' should be matched by a corresponding call to 'gimp-image-thaw-layers', undoing its effects.",
                                   NULL);
@@ -3693,7 +3711,7 @@ register_image_procs (GimpPDB *pdb)
                                "gimp-image-thaw-layers");
   gimp_procedure_set_static_help (procedure,
                                   "Thaw the image's layer list.",
-                                  "This procedure thaws the layer list of the image, re-enabling updates to the Layers dialog.\n"
+                                  "This procedure thaws the layer list of the image, re-enabling updates to the Layers dialog and to the image's preview.\n"
                                      "\n"
                                      "This procedure should match a corresponding call to 'gimp-image-freeze-layers'.",
                                   NULL);
@@ -473,6 +473,9 @@ gimp_plug_in_cleanup_image (GimpPlugInProcFrame    *proc_frame,
              gimp_container_frozen (container))
         {
           gimp_container_thaw (container);
+
+          if (gimp_viewable_preview_is_frozen (GIMP_VIEWABLE (image)))
+            gimp_viewable_preview_thaw (GIMP_VIEWABLE (image));
         }
     }
 
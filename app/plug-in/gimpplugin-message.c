@@ -60,11 +60,13 @@ static void gimp_plug_in_handle_quit             (GimpPlugIn      *plug_in);
 static void gimp_plug_in_handle_tile_request     (GimpPlugIn      *plug_in,
                                                   GPTileReq       *request);
 static void gimp_plug_in_handle_tile_put         (GimpPlugIn      *plug_in,
-                                                  GPTileReq       *request);
+                                                  GPTileData      *tile_info);
 static void gimp_plug_in_handle_tile_get         (GimpPlugIn      *plug_in,
                                                   GPTileReq       *request);
 static void gimp_plug_in_handle_proc_run         (GimpPlugIn      *plug_in,
                                                   GPProcRun       *proc_run);
+static void gimp_plug_in_handle_proc_run_batch   (GimpPlugIn      *plug_in,
+                                                  GPProcRunBatch  *proc_run_batch);
 static void gimp_plug_in_handle_proc_return      (GimpPlugIn      *plug_in,
                                                   GPProcReturn    *proc_return);
 static void gimp_plug_in_handle_temp_proc_return (GimpPlugIn      *plug_in,
@@ -76,6 +78,10 @@ static void gimp_plug_in_handle_proc_uninstall   (GimpPlugIn      *plug_in,
 static void gimp_plug_in_handle_extension_ack    (GimpPlugIn      *plug_in);
 static void gimp_plug_in_handle_has_init         (GimpPlugIn      *plug_in);
 
+static GimpValueArray *
+            gimp_plug_in_run_proc                (GimpPlugIn      *plug_in,
+                                                  GPProcRun       *proc_run);
+
 
 /*  public functions  */
 
@@ -116,12 +122,7 @@ gimp_plug_in_handle_message (GimpPlugIn      *plug_in,
       break;
 
     case GP_TILE_DATA:
-      gimp_message (plug_in->manager->gimp, NULL, GIMP_MESSAGE_ERROR,
-                    "Plug-in \"%s\"\n(%s)\n\n"
-                    "sent a TILE_DATA message.  This should not happen.",
-                    gimp_object_get_name (plug_in),
-                    gimp_file_get_utf8_name (plug_in->file));
-      gimp_plug_in_close (plug_in, TRUE);
+      gimp_plug_in_handle_tile_put (plug_in, msg->data);
       break;
 
     case GP_PROC_RUN:
@@ -160,6 +161,20 @@ gimp_plug_in_handle_message (GimpPlugIn      *plug_in,
     case GP_HAS_INIT:
       gimp_plug_in_handle_has_init (plug_in);
       break;
+
+    case GP_PROC_RUN_BATCH:
+      gimp_plug_in_handle_proc_run_batch (plug_in, msg->data);
+      break;
+
+    case GP_PROC_RETURN_BATCH:
+      gimp_message (plug_in->manager->gimp, NULL, GIMP_MESSAGE_ERROR,
+                    "Plug-in \"%s\"\n(%s)\n\n"
+                    "sent a PROC_RETURN_BATCH message.  "
+                    "This should not happen.",
+                    gimp_object_get_name (plug_in),
+                    gimp_file_get_utf8_name (plug_in->file));
+      gimp_plug_in_close (plug_in, TRUE);
+      break;
     }
 }
 
@@ -178,59 +193,35 @@ gimp_plug_in_handle_tile_request (GimpPlugIn *plug_in,
 {
   g_return_if_fail (request != NULL);
 
-  if (request->drawable_id == -1)
-    gimp_plug_in_handle_tile_put (plug_in, request);
-  else
-    gimp_plug_in_handle_tile_get (plug_in, request);
+  gimp_plug_in_handle_tile_get (plug_in, request);
 }
 
+/*  plug-ins write tiles by sending them in a TILE_DATA message, directly
+ *  followed by the tile's pixels in shared memory, when it's used.
+ */
 static void
 gimp_plug_in_handle_tile_put (GimpPlugIn *plug_in,
-                              GPTileReq  *request)
+                              GPTileData *tile_info)
 {
-  GPTileData       tile_data;
-  GPTileData      *tile_info;
-  GimpWireMessage  msg;
-  GimpDrawable    *drawable;
-  GeglBuffer      *buffer;
-  const Babl      *format;
-  GeglRectangle    tile_rect;
-
-  tile_data.drawable_id = -1;
-  tile_data.tile_num    = 0;
-  tile_data.shadow      = 0;
-  tile_data.bpp         = 0;
-  tile_data.width       = 0;
-  tile_data.height      = 0;
-  tile_data.use_shm     = (plug_in->manager->shm != NULL);
-  tile_data.data        = NULL;
-
-  if (! gp_tile_data_write (plug_in->my_write, &tile_data, plug_in))
-    {
-      gimp_message (plug_in->manager->gimp, NULL, GIMP_MESSAGE_ERROR,
-                    "%s: ERROR", G_STRFUNC);
-      gimp_plug_in_close (plug_in, TRUE);
-      return;
-    }
+  GimpDrawable  *drawable;
+  GeglBuffer    *buffer;
+  const Babl    *format;
+  GeglRectangle  tile_rect;
 
-  if (! gimp_wire_read_msg (plug_in->my_read, &msg, plug_in))
-    {
-      gimp_message (plug_in->manager->gimp, NULL, GIMP_MESSAGE_ERROR,
-                    "%s: ERROR", G_STRFUNC);
-      gimp_plug_in_close (plug_in, TRUE);
-      return;
-    }
+  g_return_if_fail (tile_info != NULL);
 
-  if (msg.type != GP_TILE_DATA)
+  if (tile_info->use_shm != (plug_in->manager->shm != NULL))
     {
       gimp_message (plug_in->manager->gimp, NULL, GIMP_MESSAGE_ERROR,
-                    "expected tile data and received: %d", msg.type);
+                    "Plug-in \"%s\"\n(%s)\n\n"
+                    "sent tile data with invalid shared memory usage "
+                    "(killing)",
+                    gimp_object_get_name (plug_in),
+                    gimp_file_get_utf8_name (plug_in->file));
       gimp_plug_in_close (plug_in, TRUE);
       return;
     }
 
-  tile_info = msg.data;
-
   drawable = (GimpDrawable *) gimp_item_get_by_id (plug_in->manager->gimp,
                                                    tile_info->drawable_id);
 
@@ -316,7 +307,21 @@ gimp_plug_in_handle_tile_put (GimpPlugIn *plug_in,
 
   format = gegl_buffer_get_format (buffer);
 
-  if (tile_data.use_shm)
+  if (tile_info->width  != tile_rect.width  ||
+      tile_info->height != tile_rect.height ||
+      tile_info->bpp    != babl_format_get_bytes_per_pixel (format))
+    {
+      gimp_message (plug_in->manager->gimp, NULL, GIMP_MESSAGE_ERROR,
+                    "Plug-in \"%s\"\n(%s)\n\n"
+                    "sent tile #%d with invalid dimensions (killing)",
+                    gimp_object_get_name (plug_in),
+                    gimp_file_get_utf8_name (plug_in->file),
+                    tile_info->tile_num);
+      gimp_plug_in_close (plug_in, TRUE);
+      return;
+    }
+
+  if (tile_info->use_shm)
     {
       gegl_buffer_set (buffer, &tile_rect, 0, format,
                        gimp_plug_in_shm_get_addr (plug_in->manager->shm),
@@ -329,8 +334,6 @@ gimp_plug_in_handle_tile_put (GimpPlugIn *plug_in,
                        GEGL_AUTO_ROWSTRIDE);
     }
 
-  gimp_wire_destroy (&msg);
-
   if (! gp_tile_ack_write (plug_in->my_write, plug_in))
     {
       gimp_message (plug_in->manager->gimp, NULL, GIMP_MESSAGE_ERROR,
@@ -499,6 +502,125 @@ gimp_plug_in_handle_proc_error (GimpPlugIn          *plug_in,
 static void
 gimp_plug_in_handle_proc_run (GimpPlugIn *plug_in,
                               GPProcRun  *proc_run)
+{
+  GimpValueArray *return_vals;
+
+  g_return_if_fail (proc_run != NULL);
+  g_return_if_fail (proc_run->name != NULL);
+
+  return_vals = gimp_plug_in_run_proc (plug_in, proc_run);
+
+  /*  Don't bother to send the return value if executing the procedure
+   *  closed the plug-in (e.g. if the procedure is gimp-quit)
+   */
+  if (plug_in->open)
+    {
+      GPProcReturn proc_return;
+
+      /*  Return the name we got called with, *not* proc_name or canonical,
+       *  since proc_name may have been remapped by gimp->procedural_compat_ht
+       *  and canonical may be different too.
+       */
+      proc_return.name     = proc_run->name;
+      proc_return.n_params = gimp_value_array_length (return_vals);
+      proc_return.params   = _gimp_value_array_to_gp_params (return_vals, FALSE);
+
+      if (! gp_proc_return_write (plug_in->my_write, &proc_return, plug_in))
+        {
+          gimp_message (plug_in->manager->gimp, NULL, GIMP_MESSAGE_ERROR,
+                        "%s: ERROR", G_STRFUNC);
+          gimp_plug_in_close (plug_in, TRUE);
+        }
+
+      _gimp_gp_params_free (proc_return.params, proc_return.n_params, FALSE);
+    }
+
+  gimp_value_array_unref (return_vals);
+}
+
+/*  a batch runs its procedures in order, like the same sequence of
+ *  PROC_RUN messages would, but answers them with a single message.
+ *  the batch stops at the first procedure that doesn't succeed, so the
+ *  plug-in gets the return values of the procedures that were run, the
+ *  last of which carries the error.
+ */
+static void
+gimp_plug_in_handle_proc_run_batch (GimpPlugIn     *plug_in,
+                                    GPProcRunBatch *proc_run_batch)
+{
+  GPProcReturnBatch  proc_return_batch;
+  GimpValueArray   **return_vals;
+  guint              i;
+
+  g_return_if_fail (proc_run_batch != NULL);
+
+  for (i = 0; i < proc_run_batch->n_procs; i++)
+    {
+      if (! proc_run_batch->procs[i].name)
+        {
+          gimp_message (plug_in->manager->gimp, NULL, GIMP_MESSAGE_ERROR,
+                        "Plug-in \"%s\"\n(%s)\n\n"
+                        "sent a PROC_RUN_BATCH message with an unnamed "
+                        "procedure (killing)",
+                        gimp_object_get_name (plug_in),
+                        gimp_file_get_utf8_name (plug_in->file));
+          gimp_plug_in_close (plug_in, TRUE);
+          return;
+        }
+    }
+
+  return_vals = g_new0 (GimpValueArray *, proc_run_batch->n_procs);
+
+  proc_return_batch.n_procs = 0;
+  proc_return_batch.procs   = g_new0 (GPProcReturn, proc_run_batch->n_procs);
+
+  for (i = 0; i < proc_run_batch->n_procs && plug_in->open; i++)
+    {
+      GPProcRun         *proc_run = &proc_run_batch->procs[i];
+      GimpPDBStatusType  status;
+
+      return_vals[i] = gimp_plug_in_run_proc (plug_in, proc_run);
+
+      proc_return_batch.procs[i].name     = proc_run->name;
+      proc_return_batch.procs[i].n_params =
+        gimp_value_array_length (return_vals[i]);
+      proc_return_batch.procs[i].params   =
+        _gimp_value_array_to_gp_params (return_vals[i], FALSE);
+
+      proc_return_batch.n_procs++;
+
+      status = g_value_get_enum (gimp_value_array_index (return_vals[i], 0));
+
+      if (status != GIMP_PDB_SUCCESS)
+        break;
+    }
+
+  /*  see gimp_plug_in_handle_proc_run()  */
+  if (plug_in->open)
+    {
+      if (! gp_proc_return_batch_write (plug_in->my_write,
+                                        &proc_return_batch, plug_in))
+        {
+          gimp_message (plug_in->manager->gimp, NULL, GIMP_MESSAGE_ERROR,
+                        "%s: ERROR", G_STRFUNC);
+          gimp_plug_in_close (plug_in, TRUE);
+        }
+    }
+
+  for (i = 0; i < proc_return_batch.n_procs; i++)
+    {
+      _gimp_gp_params_free (proc_return_batch.procs[i].params,
+                            proc_return_batch.procs[i].n_params, FALSE);
+      gimp_value_array_unref (return_vals[i]);
+    }
+
+  g_free (proc_return_batch.procs);
+  g_free (return_vals);
+}
+
+static GimpValueArray *
+gimp_plug_in_run_proc (GimpPlugIn *plug_in,
+                       GPProcRun  *proc_run)
 {
   GimpPlugInProcFrame *proc_frame;
   gchar               *canonical;
@@ -508,9 +630,6 @@ gimp_plug_in_handle_proc_run (GimpPlugIn *plug_in,
   GimpValueArray      *return_vals = NULL;
   GError              *error       = NULL;
 
-  g_return_if_fail (proc_run != NULL);
-  g_return_if_fail (proc_run->name != NULL);
-
   canonical = gimp_canonicalize_identifier (proc_run->name);
 
   proc_frame = gimp_plug_in_get_proc_frame (plug_in);
@@ -602,32 +721,7 @@ gimp_plug_in_handle_proc_run (GimpPlugIn *plug_in,
 
   g_free (canonical);
 
-  /*  Don't bother to send the return value if executing the procedure
-   *  closed the plug-in (e.g. if the procedure is gimp-quit)
-   */
-  if (plug_in->open)
-    {
-      GPProcReturn proc_return;
-
-      /*  Return the name we got called with, *not* proc_name or canonical,
-       *  since proc_name may have been remapped by gimp->procedural_compat_ht
-       *  and canonical may be different too.
-       */
-      proc_return.name     = proc_run->name;
-      proc_return.n_params = gimp_value_array_length (return_vals);
-      proc_return.params   = _gimp_value_array_to_gp_params (return_vals, FALSE);
-
-      if (! gp_proc_return_write (plug_in->my_write, &proc_return, plug_in))
-        {
-          gimp_message (plug_in->manager->gimp, NULL, GIMP_MESSAGE_ERROR,
-                        "%s: ERROR", G_STRFUNC);
-          gimp_plug_in_close (plug_in, TRUE);
-        }
-
-      _gimp_gp_params_free (proc_return.params, proc_return.n_params, FALSE);
-    }
-
-  gimp_value_array_unref (return_vals);
+  return return_vals;
 }
 
 static void
@@ -661,7 +755,9 @@ gimp_plug_in_handle_proc_return (GimpPlugIn   *plug_in,
                                                    proc_frame->return_vals);
     }
 
-  gimp_plug_in_close (plug_in, FALSE);
+  /*  resident plug-ins wait for the next procedure to run  */
+  if (! plug_in->resident)
+    gimp_plug_in_close (plug_in, FALSE);
 }
 
 static void
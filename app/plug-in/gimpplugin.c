@@ -106,6 +106,9 @@ static gboolean   gimp_plug_in_write         (GIOChannel   *channel,
                                               gpointer      data);
 static gboolean   gimp_plug_in_flush         (GIOChannel   *channel,
                                               gpointer      data);
+static gboolean   gimp_plug_in_write_chars   (GIOChannel   *channel,
+                                              const gchar  *buf,
+                                              gsize         count);
 
 #if defined G_OS_WIN32 && defined WIN32_32BIT_DLL_FOLDER
 static void       gimp_plug_in_set_dll_directory (const gchar *path);
@@ -255,6 +258,18 @@ gimp_plug_in_write (GIOChannel   *channel,
   GimpPlugIn *plug_in = data;
   gulong      bytes;
 
+  /*  large payloads, like pixel data and big arrays, are written
+   *  directly after what's already buffered, instead of being copied
+   *  through the buffer and written one buffer-sized piece at a time
+   */
+  if (count >= WRITE_BUFFER_SIZE)
+    {
+      if (! gimp_wire_flush (channel, plug_in))
+        return FALSE;
+
+      return gimp_plug_in_write_chars (channel, (const gchar *) buf, count);
+    }
+
   while (count > 0)
     {
       if ((plug_in->write_buffer_index + count) >= WRITE_BUFFER_SIZE)
@@ -288,48 +303,59 @@ gimp_plug_in_flush (GIOChannel *channel,
   GimpPlugIn *plug_in = data;
 
   if (plug_in->write_buffer_index > 0)
+    {
+      if (! gimp_plug_in_write_chars (channel,
+                                      plug_in->write_buffer,
+                                      plug_in->write_buffer_index))
+        return FALSE;
+
+      plug_in->write_buffer_index = 0;
+    }
+
+  return TRUE;
+}
+
+static gboolean
+gimp_plug_in_write_chars (GIOChannel  *channel,
+                          const gchar *buf,
+                          gsize        count)
+{
+  while (count > 0)
     {
       GIOStatus  status;
       GError    *error = NULL;
-      gint       count;
       gsize      bytes;
 
-      count = 0;
-      while (count != plug_in->write_buffer_index)
+      do
         {
-          do
+          bytes = 0;
+          status = g_io_channel_write_chars (channel,
+                                             buf, count,
+                                             &bytes,
+                                             &error);
+        }
+      while (status == G_IO_STATUS_AGAIN);
+
+      if (status != G_IO_STATUS_NORMAL)
+        {
+          if (error)
             {
-              bytes = 0;
-              status = g_io_channel_write_chars (channel,
-                                                 &plug_in->write_buffer[count],
-                                                 (plug_in->write_buffer_index - count),
-                                                 &bytes,
-                                                 &error);
+              g_warning ("%s: plug_in_flush(): error: %s",
+                         gimp_filename_to_utf8 (g_get_prgname ()),
+                         error->message);
+              g_error_free (error);
             }
-          while (status == G_IO_STATUS_AGAIN);
-
-          if (status != G_IO_STATUS_NORMAL)
+          else
             {
-              if (error)
-                {
-                  g_warning ("%s: plug_in_flush(): error: %s",
-                             gimp_filename_to_utf8 (g_get_prgname ()),
-                             error->message);
-                  g_error_free (error);
-                }
-              else
-                {
-                  g_warning ("%s: plug_in_flush(): error",
-                             gimp_filename_to_utf8 (g_get_prgname ()));
-                }
-
-              return FALSE;
+              g_warning ("%s: plug_in_flush(): error",
+                         gimp_filename_to_utf8 (g_get_prgname ()));
             }
 
-          count += bytes;
+          return FALSE;
         }
 
-      plug_in->write_buffer_index = 0;
+      buf   += bytes;
+      count -= bytes;
     }
 
   return TRUE;
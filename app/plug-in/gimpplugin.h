@@ -25,7 +25,7 @@
 #include "gimppluginprocframe.h"
 
 
-#define WRITE_BUFFER_SIZE  512
+#define WRITE_BUFFER_SIZE  8192
 
 
 #define GIMP_TYPE_PLUG_IN            (gimp_plug_in_get_type ())
@@ -47,6 +47,7 @@ struct _GimpPlugIn
   GimpPlugInCallMode   call_mode;       /*  QUERY, INIT or RUN                */
   guint                open : 1;        /*  Is the plug-in open?              */
   guint                hup : 1;         /*  Did we receive a G_IO_HUP         */
+  guint                resident : 1;    /*  Is it kept open between runs?     */
   GPid                 pid;             /*  Plug-in's process id              */
 
   GIOChannel          *my_read;         /*  App's read and write channels     */
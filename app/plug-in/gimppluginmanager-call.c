@@ -63,19 +63,130 @@ gimp_allow_set_foreground_window (GimpPlugIn *plug_in)
 #endif
 }
 
+/*  with "resident-file-plug-ins" enabled, the plug-ins that run file
+ *  procedures non-interactively are kept open after returning, and are
+ *  sent the next such call to one of their procedures, instead of a new
+ *  plug-in process being started for every file.
+ */
+static gboolean
+gimp_plug_in_manager_call_is_resident (GimpPlugInManager   *manager,
+                                       GimpPlugInProcedure *procedure,
+                                       GimpValueArray      *args,
+                                       gboolean             synchronous)
+{
+  GValue *value;
+
+  if (! manager->gimp->config->resident_file_plug_ins ||
+      ! synchronous                                    ||
+      ! procedure->file_proc                           ||
+      GIMP_PROCEDURE (procedure)->proc_type != GIMP_PDB_PROC_TYPE_PLUGIN)
+    {
+      return FALSE;
+    }
+
+  if (gimp_value_array_length (args) < 1)
+    return FALSE;
+
+  value = gimp_value_array_index (args, 0);
+
+  return (G_VALUE_HOLDS (value, GIMP_TYPE_RUN_MODE) &&
+          g_value_get_enum (value) == GIMP_RUN_NONINTERACTIVE);
+}
+
+static GimpPlugIn *
+gimp_plug_in_manager_call_get_resident (GimpPlugInManager   *manager,
+                                        GimpPlugInProcedure *procedure)
+{
+  GFile  *file = gimp_plug_in_procedure_get_file (procedure);
+  GSList *list;
+
+  for (list = manager->open_plug_ins; list; list = g_slist_next (list))
+    {
+      GimpPlugIn *plug_in = list->data;
+
+      /*  an idle resident plug-in has no procedure in its main frame  */
+      if (plug_in->resident                  &&
+          ! plug_in->main_proc_frame.procedure &&
+          g_file_equal (plug_in->file, file))
+        {
+          return plug_in;
+        }
+    }
+
+  return NULL;
+}
+
+static GimpValueArray *
+gimp_plug_in_manager_call_run_resident (GimpPlugIn          *plug_in,
+                                        GimpContext         *context,
+                                        GimpProgress        *progress,
+                                        GimpPlugInProcedure *procedure,
+                                        GimpValueArray      *args)
+{
+  GimpPlugInProcFrame *proc_frame = &plug_in->main_proc_frame;
+  GimpValueArray      *return_vals;
+  GPProcRun            proc_run;
+
+  g_object_ref (plug_in);
+
+  gimp_plug_in_proc_frame_init (proc_frame, context, progress, procedure);
+
+  /*  the plug-in got its GP_CONFIG when it was started  */
+  proc_run.name     = (gchar *) gimp_object_get_name (procedure);
+  proc_run.n_params = gimp_value_array_length (args);
+  proc_run.params   = _gimp_value_array_to_gp_params (args, FALSE);
+
+  if (! gp_proc_run_write (plug_in->my_write, &proc_run, plug_in) ||
+      ! gimp_wire_flush (plug_in->my_write, plug_in))
+    {
+      const gchar *name  = gimp_object_get_name (plug_in);
+      GError      *error = g_error_new (GIMP_PLUG_IN_ERROR,
+                                        GIMP_PLUG_IN_EXECUTION_FAILED,
+                                        _("Failed to run plug-in \"%s\""),
+                                        name);
+
+      gimp_plug_in_close (plug_in, TRUE);
+
+      return_vals = gimp_procedure_get_return_values (GIMP_PROCEDURE (procedure),
+                                                      FALSE, error);
+      g_error_free (error);
+    }
+  else
+    {
+      proc_frame->main_loop = g_main_loop_new (NULL, FALSE);
+
+      g_main_loop_run (proc_frame->main_loop);
+
+      /*  main_loop is quit in gimp_plug_in_handle_proc_return()  */
+
+      g_clear_pointer (&proc_frame->main_loop, g_main_loop_unref);
+
+      return_vals = gimp_plug_in_proc_frame_get_return_values (proc_frame);
+    }
+
+  _gimp_gp_params_free (proc_run.params, proc_run.n_params, FALSE);
+
+  /*  make the plug-in idle again  */
+  gimp_plug_in_proc_frame_dispose (proc_frame, plug_in);
+
+  g_object_unref (plug_in);
+
+  return return_vals;
+}
+
 
 /*  public functions  */
 
-void
+GimpPlugIn *
 gimp_plug_in_manager_call_query (GimpPlugInManager *manager,
                                  GimpContext       *context,
                                  GimpPlugInDef     *plug_in_def)
 {
   GimpPlugIn *plug_in;
 
-  g_return_if_fail (GIMP_IS_PLUG_IN_MANAGER (manager));
-  g_return_if_fail (GIMP_IS_PDB_CONTEXT (context));
-  g_return_if_fail (GIMP_IS_PLUG_IN_DEF (plug_in_def));
+  g_return_val_if_fail (GIMP_IS_PLUG_IN_MANAGER (manager), NULL);
+  g_return_val_if_fail (GIMP_IS_PDB_CONTEXT (context), NULL);
+  g_return_val_if_fail (GIMP_IS_PLUG_IN_DEF (plug_in_def), NULL);
 
   plug_in = gimp_plug_in_new (manager, context, NULL,
                               NULL, plug_in_def->file);
@@ -84,26 +195,15 @@ gimp_plug_in_manager_call_query (GimpPlugInManager *manager,
     {
       plug_in->plug_in_def = plug_in_def;
 
-      if (gimp_plug_in_open (plug_in, GIMP_PLUG_IN_CALL_QUERY, TRUE))
-        {
-          while (plug_in->open)
-            {
-              GimpWireMessage msg;
-
-              if (! gimp_wire_read_msg (plug_in->my_read, &msg, plug_in))
-                {
-                  gimp_plug_in_close (plug_in, TRUE);
-                }
-              else
-                {
-                  gimp_plug_in_handle_message (plug_in, &msg);
-                  gimp_wire_destroy (&msg);
-                }
-            }
-        }
-
-      g_object_unref (plug_in);
+      /*  the plug-in's messages are handled from the main loop, so that
+       *  several plug-ins can be queried at the same time; it is closed
+       *  when it sends GP_QUIT at the end of its query() function
+       */
+      if (! gimp_plug_in_open (plug_in, GIMP_PLUG_IN_CALL_QUERY, FALSE))
+        g_clear_object (&plug_in);
     }
+
+  return plug_in;
 }
 
 void
@@ -157,6 +257,7 @@ gimp_plug_in_manager_call_run (GimpPlugInManager   *manager,
 {
   GimpValueArray *return_vals = NULL;
   GimpPlugIn     *plug_in;
+  gboolean        resident;
 
   g_return_val_if_fail (GIMP_IS_PLUG_IN_MANAGER (manager), NULL);
   g_return_val_if_fail (GIMP_IS_PDB_CONTEXT (context), NULL);
@@ -165,6 +266,19 @@ gimp_plug_in_manager_call_run (GimpPlugInManager   *manager,
   g_return_val_if_fail (args != NULL, NULL);
   g_return_val_if_fail (display == NULL || GIMP_IS_DISPLAY (display), NULL);
 
+  resident = gimp_plug_in_manager_call_is_resident (manager, procedure,
+                                                    args, synchronous);
+
+  if (resident)
+    {
+      plug_in = gimp_plug_in_manager_call_get_resident (manager, procedure);
+
+      if (plug_in)
+        return gimp_plug_in_manager_call_run_resident (plug_in,
+                                                       context, progress,
+                                                       procedure, args);
+    }
+
   plug_in = gimp_plug_in_new (manager, context, progress, procedure, NULL);
 
   if (plug_in)
@@ -179,6 +293,8 @@ gimp_plug_in_manager_call_run (GimpPlugInManager   *manager,
       GObject           *monitor;
       GFile             *icon_theme_dir;
 
+      plug_in->resident = resident;
+
       if (! gimp_plug_in_open (plug_in, GIMP_PLUG_IN_CALL_RUN, FALSE))
         {
           const gchar *name  = gimp_object_get_name (plug_in);
@@ -234,6 +350,7 @@ gimp_plug_in_manager_call_run (GimpPlugInManager   *manager,
       config.swap_path            = gegl_config->swap_path;
       config.swap_compression     = gegl_config->swap_compression;
       config.num_processors       = gegl_config->num_processors;
+      config.resident             = resident;
 
       proc_run.name     = (gchar *) gimp_object_get_name (procedure);
       proc_run.n_params = gimp_value_array_length (args);
@@ -298,6 +415,10 @@ gimp_plug_in_manager_call_run (GimpPlugInManager   *manager,
           g_clear_pointer (&proc_frame->main_loop, g_main_loop_unref);
 
           return_vals = gimp_plug_in_proc_frame_get_return_values (proc_frame);
+
+          /*  make the plug-in idle, see gimp_plug_in_manager_call_run_resident()  */
+          if (plug_in->resident)
+            gimp_plug_in_proc_frame_dispose (proc_frame, plug_in);
         }
 
       g_object_unref (plug_in);
@@ -25,9 +25,10 @@
 #endif
 
 
-/*  Call the plug-in's query() function
+/*  Start calling the plug-in's query() function, the returned plug-in
+ *  is done once it's no longer open
  */
-void             gimp_plug_in_manager_call_query    (GimpPlugInManager      *manager,
+GimpPlugIn     * gimp_plug_in_manager_call_query    (GimpPlugInManager      *manager,
                                                      GimpContext            *context,
                                                      GimpPlugInDef          *plug_in_def);
 
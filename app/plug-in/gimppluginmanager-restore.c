@@ -32,12 +32,14 @@
 #include "config/gimpcoreconfig.h"
 
 #include "core/gimp.h"
+#include "core/gimp-trace.h"
 #include "core/gimp-utils.h"
 
 #include "pdb/gimppdb.h"
 #include "pdb/gimppdbcontext.h"
 
 #include "gimpinterpreterdb.h"
+#include "gimpplugin.h"
 #include "gimpplugindef.h"
 #include "gimppluginmanager.h"
 #define __YES_I_NEED_GIMP_PLUG_IN_MANAGER_CALL__
@@ -105,18 +107,26 @@ gimp_plug_in_manager_restore (GimpPlugInManager  *manager,
   context = gimp_pdb_context_new (gimp, context, TRUE);
 
   /* search for binaries in the plug-in directory path */
+  gimp_trace_begin ("startup", "plug-in-search");
   gimp_plug_in_manager_search (manager, status_callback);
+  gimp_trace_end ();
 
   /* read the pluginrc file for cached data */
   pluginrc = gimp_plug_in_manager_get_pluginrc (manager);
 
+  gimp_trace_begin ("startup", "pluginrc-read");
   gimp_plug_in_manager_read_pluginrc (manager, pluginrc, status_callback);
+  gimp_trace_end ();
 
   /* query any plug-ins that changed since we last wrote out pluginrc */
+  gimp_trace_begin ("startup", "plug-in-query");
   gimp_plug_in_manager_query_new (manager, context, status_callback);
+  gimp_trace_end ();
 
   /* initialize the plug-ins */
+  gimp_trace_begin ("startup", "plug-in-init");
   gimp_plug_in_manager_init_plug_ins (manager, context, status_callback);
+  gimp_trace_end ();
 
   /* add the procedures to manager->plug_in_procedures */
   for (list = manager->plug_in_defs; list; list = list->next)
@@ -189,7 +199,9 @@ gimp_plug_in_manager_restore (GimpPlugInManager  *manager,
   /* sort the load, save and export procedures, make the raw handler list */
   gimp_plug_in_manager_sort_file_procs (manager);
 
+  gimp_trace_begin ("startup", "plug-in-extensions");
   gimp_plug_in_manager_run_extensions (manager, context, status_callback);
+  gimp_trace_end ();
 
   g_object_unref (context);
 }
@@ -461,31 +473,50 @@ gimp_plug_in_manager_query_new (GimpPlugInManager  *manager,
                                 GimpInitStatusFunc  status_callback)
 {
   GSList *list;
+  GList  *queue = NULL;
   gint    n_plugins;
 
   status_callback (_("Querying new Plug-ins"), "", 0.0);
 
-  for (list = manager->plug_in_defs, n_plugins = 0; list; list = list->next)
+  for (list = manager->plug_in_defs; list; list = list->next)
     {
       GimpPlugInDef *plug_in_def = list->data;
 
       if (plug_in_def->needs_query)
-        n_plugins++;
+        queue = g_list_prepend (queue, plug_in_def);
     }
 
+  queue     = g_list_reverse (queue);
+  n_plugins = g_list_length (queue);
+
   if (n_plugins)
     {
-      gint nth;
+      GimpGeglConfig *gegl_config = GIMP_GEGL_CONFIG (manager->gimp->config);
+      GList          *running     = NULL;
+      gint            n_running   = 0;
+      gint            max_running;
+      gint            nth         = 0;
 
       manager->write_pluginrc = TRUE;
 
-      for (list = manager->plug_in_defs, nth = 0; list; list = list->next)
+      /*  query up to one plug-in per thread at the same time.  each
+       *  plug-in only fills in its own GimpPlugInDef, and manager->plug_in_defs
+       *  keeps the order in which the plug-ins were found, so the result
+       *  doesn't depend on the order in which the queries finish.
+       */
+      max_running = MAX (gegl_config->num_processors, 1);
+
+      while (queue || running)
         {
-          GimpPlugInDef *plug_in_def = list->data;
+          GList *iter;
 
-          if (plug_in_def->needs_query)
+          while (queue && n_running < max_running)
             {
-              gchar *basename;
+              GimpPlugInDef *plug_in_def = queue->data;
+              GimpPlugIn    *plug_in;
+              gchar         *basename;
+
+              queue = g_list_delete_link (queue, queue);
 
               basename =
                 g_path_get_basename (gimp_file_get_utf8_name (plug_in_def->file));
@@ -497,8 +528,37 @@ gimp_plug_in_manager_query_new (GimpPlugInManager  *manager,
                 g_print ("Querying plug-in: '%s'\n",
                          gimp_file_get_utf8_name (plug_in_def->file));
 
-              gimp_plug_in_manager_call_query (manager, context, plug_in_def);
+              plug_in = gimp_plug_in_manager_call_query (manager, context,
+                                                         plug_in_def);
+
+              if (plug_in)
+                {
+                  running = g_list_prepend (running, plug_in);
+                  n_running++;
+                }
             }
+
+          for (iter = running; iter; )
+            {
+              GimpPlugIn *plug_in = iter->data;
+              GList      *next    = g_list_next (iter);
+
+              if (! plug_in->open)
+                {
+                  g_object_unref (plug_in);
+
+                  running = g_list_delete_link (running, iter);
+                  n_running--;
+                }
+
+              iter = next;
+            }
+
+          /*  wait for messages from the running plug-ins, they are
+           *  handled by their watches on the default main context
+           */
+          if (running)
+            g_main_context_iteration (NULL, TRUE);
         }
     }
 
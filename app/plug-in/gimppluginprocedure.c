@@ -32,6 +32,7 @@
 
 #include "core/gimp.h"
 #include "core/gimp-memsize.h"
+#include "core/gimp-trace.h"
 #include "core/gimpdrawable.h"
 #include "core/gimpimage.h"
 #include "core/gimpparamspecs.h"
@@ -375,13 +376,12 @@ gimp_plug_in_procedure_execute (GimpProcedure  *procedure,
                                 GError        **error)
 {
   GimpPlugInProcedure *plug_in_procedure = GIMP_PLUG_IN_PROCEDURE (procedure);
+  GimpValueArray      *return_vals;
   GError              *pdb_error         = NULL;
 
   if (! gimp_plug_in_procedure_validate_args (plug_in_procedure, gimp,
                                               args, &pdb_error))
     {
-      GimpValueArray *return_vals;
-
       return_vals = gimp_procedure_get_return_values (procedure, FALSE,
                                                       pdb_error);
       g_propagate_error (error, pdb_error);
@@ -394,10 +394,16 @@ gimp_plug_in_procedure_execute (GimpProcedure  *procedure,
                                                          context, progress,
                                                          args, error);
 
-  return gimp_plug_in_manager_call_run (gimp->plug_in_manager,
-                                        context, progress,
-                                        GIMP_PLUG_IN_PROCEDURE (procedure),
-                                        args, TRUE, NULL);
+  gimp_trace_begin_intern ("plug-in", gimp_object_get_name (procedure));
+
+  return_vals = gimp_plug_in_manager_call_run (gimp->plug_in_manager,
+                                               context, progress,
+                                               GIMP_PLUG_IN_PROCEDURE (procedure),
+                                               args, TRUE, NULL);
+
+  gimp_trace_end ();
+
+  return return_vals;
 }
 
 static void
@@ -416,11 +422,16 @@ gimp_plug_in_procedure_execute_async (GimpProcedure  *procedure,
     {
       GimpValueArray *return_vals;
 
+      /*  only covers starting the plug-in, which then runs on its own  */
+      gimp_trace_begin_intern ("plug-in", gimp_object_get_name (procedure));
+
       return_vals = gimp_plug_in_manager_call_run (gimp->plug_in_manager,
                                                    context, progress,
                                                    plug_in_procedure,
                                                    args, FALSE, display);
 
+      gimp_trace_end ();
+
       if (return_vals)
         {
           gimp_plug_in_procedure_handle_return_values (plug_in_procedure,
@@ -385,6 +385,9 @@ plug_in_procedure_deserialize (GScanner             *scanner,
   GimpProcedure   *procedure;
   GTokenType       token;
   gchar           *str;
+  gchar           *authors;
+  gchar           *copyright;
+  gchar           *date;
   gint             proc_type;
   gint             n_args;
   gint             n_return_vals;
@@ -426,12 +429,33 @@ plug_in_procedure_deserialize (GScanner             *scanner,
     return G_TOKEN_STRING;
   if (! gimp_scanner_parse_string (scanner, &procedure->help))
     return G_TOKEN_STRING;
-  if (! gimp_scanner_parse_string (scanner, &procedure->authors))
-    return G_TOKEN_STRING;
-  if (! gimp_scanner_parse_string (scanner, &procedure->copyright))
-    return G_TOKEN_STRING;
-  if (! gimp_scanner_parse_string (scanner, &procedure->date))
+
+  /*  the attribution strings are the same for most procedures of a
+   *  plug-in, and often across plug-ins, so intern them instead of
+   *  keeping a copy per procedure
+   */
+  if (! gimp_scanner_parse_string (scanner, &authors))
     return G_TOKEN_STRING;
+  if (! gimp_scanner_parse_string (scanner, &copyright))
+    {
+      g_free (authors);
+      return G_TOKEN_STRING;
+    }
+  if (! gimp_scanner_parse_string (scanner, &date))
+    {
+      g_free (authors);
+      g_free (copyright);
+      return G_TOKEN_STRING;
+    }
+
+  gimp_procedure_set_static_attribution (procedure,
+                                         g_intern_string (authors),
+                                         g_intern_string (copyright),
+                                         g_intern_string (date));
+  g_free (authors);
+  g_free (copyright);
+  g_free (date);
+
   if (! gimp_scanner_parse_string (scanner, &(*proc)->menu_label))
     return G_TOKEN_STRING;
 
@@ -0,0 +1,445 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#ifdef G_OS_WIN32
+#include <io.h>
+#endif
+
+#include <gegl.h>
+#include <gtk/gtk.h>
+
+#include "libgimpbase/gimpbase.h"
+
+#include "widgets/widgets-types.h"
+
+#include "widgets/gimpuimanager.h"
+
+#include "gegl/gimp-gegl-loops.h"
+
+#include "core/gimp.h"
+#include "core/gimpcontext.h"
+#include "core/gimpdrawable.h"
+#include "core/gimpimage.h"
+#include "core/gimpimage-merge.h"
+#include "core/gimplayer.h"
+#include "core/gimplayer-new.h"
+
+#include "plug-in/gimppluginmanager-file.h"
+
+#include "file/file-open.h"
+#include "file/file-save.h"
+
+#include "tests.h"
+
+#include "gimp-app-test-utils.h"
+
+
+/*  all tests only run in performance mode, i.e. "-m perf", and report
+ *  their times with g_test_minimized_result()
+ */
+
+#define GIMP_PERF_BUFFER_SIZE  2048
+#define GIMP_PERF_IMAGE_SIZE   1024
+#define GIMP_PERF_N_LAYERS     100
+#define GIMP_PERF_N_RUNS       5
+#define GIMP_PERF_SEED         2048
+
+#define ADD_TEST(function) \
+  g_test_add_data_func ("/gimp-performance/" #function, gimp, function);
+
+
+typedef void (* GimpPerfFunc) (GeglBuffer *src,
+                               GeglBuffer *dest);
+
+
+static gboolean
+gimp_perf_skip (void)
+{
+  if (! g_test_perf ())
+    {
+      g_test_skip ("only run in performance mode");
+
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+/*  fills the buffer with seeded noise, rather than a single color, so
+ *  that its tiles are neither shared nor uniform, and the kernels have to
+ *  process every pixel
+ */
+static GeglBuffer *
+gimp_perf_buffer_new (const gchar *format)
+{
+  GeglBuffer *buffer;
+  GRand      *rand;
+  guchar     *row;
+  gint        x;
+  gint        y;
+
+  buffer = gegl_buffer_new (GEGL_RECTANGLE (0, 0,
+                                            GIMP_PERF_BUFFER_SIZE,
+                                            GIMP_PERF_BUFFER_SIZE),
+                            babl_format (format));
+
+  rand = g_rand_new_with_seed (GIMP_PERF_SEED);
+  row  = g_malloc (GIMP_PERF_BUFFER_SIZE * 4);
+
+  for (y = 0; y < GIMP_PERF_BUFFER_SIZE; y++)
+    {
+      for (x = 0; x < GIMP_PERF_BUFFER_SIZE * 4; x++)
+        row[x] = g_rand_int_range (rand, 0, 256);
+
+      gegl_buffer_set (buffer,
+                       GEGL_RECTANGLE (0, y, GIMP_PERF_BUFFER_SIZE, 1),
+                       0, babl_format ("R'G'B'A u8"),
+                       row, GEGL_AUTO_ROWSTRIDE);
+    }
+
+  g_free (row);
+  g_rand_free (rand);
+
+  return buffer;
+}
+
+/*  runs func GIMP_PERF_N_RUNS times on fresh copies of the buffers, and
+ *  reports the fastest run
+ */
+static void
+gimp_perf_run_kernel (const gchar  *name,
+                      const gchar  *src_format,
+                      const gchar  *dest_format,
+                      GimpPerfFunc  func)
+{
+  gdouble min_time = G_MAXDOUBLE;
+  gint    i;
+
+  for (i = 0; i < GIMP_PERF_N_RUNS; i++)
+    {
+      GeglBuffer *src  = gimp_perf_buffer_new (src_format);
+      GeglBuffer *dest = gimp_perf_buffer_new (dest_format);
+
+      g_test_timer_start ();
+
+      func (src, dest);
+
+      min_time = MIN (min_time, g_test_timer_elapsed ());
+
+      g_object_unref (src);
+      g_object_unref (dest);
+    }
+
+  g_test_minimized_result (min_time, "%s, %s -> %s: %g seconds",
+                           name, src_format, dest_format, min_time);
+}
+
+static void
+gimp_perf_buffer_copy_func (GeglBuffer *src,
+                            GeglBuffer *dest)
+{
+  gimp_gegl_buffer_copy (src, NULL, GEGL_ABYSS_NONE, dest, NULL);
+}
+
+static void
+gimp_perf_clear_func (GeglBuffer *src,
+                      GeglBuffer *dest)
+{
+  gimp_gegl_clear (dest, NULL);
+}
+
+static void
+gimp_perf_apply_mask_func (GeglBuffer *src,
+                           GeglBuffer *dest)
+{
+  gimp_gegl_apply_mask (src, NULL, dest, NULL, 0.5);
+}
+
+static void
+gimp_perf_combine_mask_func (GeglBuffer *src,
+                             GeglBuffer *dest)
+{
+  gimp_gegl_combine_mask (src, NULL, dest, NULL, 0.5);
+}
+
+static void
+gimp_perf_average_color_func (GeglBuffer *src,
+                              GeglBuffer *dest)
+{
+  gfloat color[4];
+
+  gimp_gegl_average_color (src, NULL, TRUE, GEGL_ABYSS_NONE,
+                           babl_format ("RGBA float"), color);
+}
+
+static void
+buffer_copy (gconstpointer data)
+{
+  if (gimp_perf_skip ())
+    return;
+
+  gimp_perf_run_kernel ("gimp_gegl_buffer_copy",
+                        "RGBA float", "RGBA float",
+                        gimp_perf_buffer_copy_func);
+  gimp_perf_run_kernel ("gimp_gegl_buffer_copy",
+                        "RGBA float", "R'G'B'A u8",
+                        gimp_perf_buffer_copy_func);
+  gimp_perf_run_kernel ("gimp_gegl_buffer_copy",
+                        "R'G'B'A u8", "RGBA float",
+                        gimp_perf_buffer_copy_func);
+}
+
+static void
+clear (gconstpointer data)
+{
+  if (gimp_perf_skip ())
+    return;
+
+  gimp_perf_run_kernel ("gimp_gegl_clear",
+                        "RGBA float", "RGBA float",
+                        gimp_perf_clear_func);
+  gimp_perf_run_kernel ("gimp_gegl_clear",
+                        "R'G'B'A u8", "R'G'B'A u8",
+                        gimp_perf_clear_func);
+}
+
+static void
+apply_mask (gconstpointer data)
+{
+  if (gimp_perf_skip ())
+    return;
+
+  gimp_perf_run_kernel ("gimp_gegl_apply_mask",
+                        "Y float", "RGBA float",
+                        gimp_perf_apply_mask_func);
+}
+
+static void
+combine_mask (gconstpointer data)
+{
+  if (gimp_perf_skip ())
+    return;
+
+  gimp_perf_run_kernel ("gimp_gegl_combine_mask",
+                        "Y float", "Y float",
+                        gimp_perf_combine_mask_func);
+}
+
+static void
+average_color (gconstpointer data)
+{
+  if (gimp_perf_skip ())
+    return;
+
+  gimp_perf_run_kernel ("gimp_gegl_average_color",
+                        "RGBA float", "RGBA float",
+                        gimp_perf_average_color_func);
+  gimp_perf_run_kernel ("gimp_gegl_average_color",
+                        "R'G'B'A u8", "R'G'B'A u8",
+                        gimp_perf_average_color_func);
+}
+
+/*  creates an image with GIMP_PERF_N_LAYERS semi-transparent layers,
+ *  cycling through a few layer modes
+ */
+static GimpImage *
+gimp_perf_image_new (Gimp *gimp)
+{
+  static const GimpLayerMode modes[] =
+  {
+    GIMP_LAYER_MODE_NORMAL,
+    GIMP_LAYER_MODE_MULTIPLY,
+    GIMP_LAYER_MODE_SCREEN,
+    GIMP_LAYER_MODE_OVERLAY
+  };
+
+  GimpImage *image;
+  gint       i;
+
+  image = gimp_image_new (gimp,
+                          GIMP_PERF_IMAGE_SIZE, GIMP_PERF_IMAGE_SIZE,
+                          GIMP_RGB, GIMP_PRECISION_U8_NON_LINEAR);
+
+  for (i = 0; i < GIMP_PERF_N_LAYERS; i++)
+    {
+      GimpLayer *layer;
+      GeglColor *color;
+
+      layer = gimp_layer_new (image,
+                              GIMP_PERF_IMAGE_SIZE, GIMP_PERF_IMAGE_SIZE,
+                              babl_format ("R'G'B'A u8"),
+                              "Layer",
+                              GIMP_OPACITY_OPAQUE,
+                              modes[i % G_N_ELEMENTS (modes)]);
+
+      color = gegl_color_new ("rgba(0.5, 0.25, 0.75, 0.5)");
+      gegl_buffer_set_color (gimp_drawable_get_buffer (GIMP_DRAWABLE (layer)),
+                             NULL, color);
+      g_object_unref (color);
+
+      gimp_image_add_layer (image, layer, NULL, 0, FALSE);
+    }
+
+  return image;
+}
+
+static void
+flatten (gconstpointer data)
+{
+  Gimp      *gimp = GIMP (data);
+  GimpImage *image;
+  gdouble    time;
+
+  if (gimp_perf_skip ())
+    return;
+
+  image = gimp_perf_image_new (gimp);
+
+  g_test_timer_start ();
+
+  gimp_image_flatten (image, gimp_get_user_context (gimp), NULL, NULL);
+
+  time = g_test_timer_elapsed ();
+
+  g_test_minimized_result (time, "flatten %d layers: %g seconds",
+                           GIMP_PERF_N_LAYERS, time);
+
+  g_object_unref (image);
+}
+
+static void
+xcf_save_and_load (gconstpointer data)
+{
+  Gimp                *gimp = GIMP (data);
+  GimpImage           *image;
+  GimpImage           *loaded_image;
+  GimpPlugInProcedure *proc;
+  GimpPDBStatusType    unused;
+  gchar               *filename = NULL;
+  gint                 file_handle;
+  GFile               *file;
+  gdouble              time;
+
+  if (gimp_perf_skip ())
+    return;
+
+  image = gimp_perf_image_new (gimp);
+
+  file_handle = g_file_open_tmp ("gimp-test-XXXXXX.xcf", &filename, NULL);
+  g_assert (file_handle != -1);
+  close (file_handle);
+  file = g_file_new_for_path (filename);
+  g_free (filename);
+
+  proc = gimp_plug_in_manager_file_procedure_find (gimp->plug_in_manager,
+                                                   GIMP_FILE_PROCEDURE_GROUP_SAVE,
+                                                   file,
+                                                   NULL /*error*/);
+
+  g_test_timer_start ();
+
+  file_save (gimp,
+             image,
+             NULL /*progress*/,
+             file,
+             proc,
+             GIMP_RUN_NONINTERACTIVE,
+             FALSE /*change_saved_state*/,
+             FALSE /*export_backward*/,
+             FALSE /*export_forward*/,
+             NULL /*error*/);
+
+  time = g_test_timer_elapsed ();
+
+  g_test_minimized_result (time, "save XCF with %d layers: %g seconds",
+                           GIMP_PERF_N_LAYERS, time);
+
+  proc = gimp_plug_in_manager_file_procedure_find (gimp->plug_in_manager,
+                                                   GIMP_FILE_PROCEDURE_GROUP_OPEN,
+                                                   file,
+                                                   NULL /*error*/);
+
+  g_test_timer_start ();
+
+  loaded_image = file_open_image (gimp,
+                                  gimp_get_user_context (gimp),
+                                  NULL /*progress*/,
+                                  file,
+                                  FALSE /*as_new*/,
+                                  proc,
+                                  GIMP_RUN_NONINTERACTIVE,
+                                  &unused /*status*/,
+                                  NULL /*mime_type*/,
+                                  NULL /*error*/);
+
+  time = g_test_timer_elapsed ();
+
+  g_test_minimized_result (time, "load XCF with %d layers: %g seconds",
+                           GIMP_PERF_N_LAYERS, time);
+
+  g_assert_cmpint (gimp_image_get_n_layers (loaded_image), ==,
+                   GIMP_PERF_N_LAYERS);
+
+  g_file_delete (file, NULL, NULL);
+  g_object_unref (file);
+
+  g_object_unref (loaded_image);
+  g_object_unref (image);
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  Gimp *gimp;
+  int   result;
+
+  g_test_init (&argc, &argv, NULL);
+
+  gimp_test_utils_set_gimp3_directory ("GIMP_TESTING_ABS_TOP_SRCDIR",
+                                       "app/tests/gimpdir");
+
+  /* We share the same application instance across all tests */
+  gimp = gimp_init_for_testing ();
+
+  /* Add tests */
+  ADD_TEST (buffer_copy);
+  ADD_TEST (clear);
+  ADD_TEST (apply_mask);
+  ADD_TEST (combine_mask);
+  ADD_TEST (average_color);
+  ADD_TEST (flatten);
+  ADD_TEST (xcf_save_and_load);
+
+  /* Run the tests */
+  result = g_test_run ();
+
+  /* Don't write files to the source dir */
+  gimp_test_utils_set_gimp3_directory ("GIMP_TESTING_ABS_TOP_BUILDDIR",
+                                       "app/tests/gimpdir-output");
+
+  /* Exit so we don't break script-fu plug-in wire */
+  gimp_exit (gimp, TRUE);
+
+  return result;
+}
@@ -42,6 +42,7 @@
 
 #include "gimpfont.h"
 #include "gimpfontfactory.h"
+#include "gimptextlayout.h"
 
 #include "gimp-intl.h"
 
@@ -90,9 +91,11 @@ static void       gimp_font_factory_recursive_add_fontdir
                                                     (FcConfig        *config,
                                                      GFile           *file,
                                                      GError         **error);
-static void       gimp_font_factory_load_names      (GimpContainer   *container,
+static void       gimp_font_factory_load_names      (GPtrArray       *fonts,
                                                      PangoFontMap    *fontmap,
                                                      PangoContext    *context);
+static void       gimp_font_factory_add_fonts       (GimpContainer   *container,
+                                                     GPtrArray       *fonts);
 
 
 G_DEFINE_TYPE_WITH_PRIVATE (GimpFontFactory, gimp_font_factory,
@@ -258,9 +261,12 @@ gimp_font_factory_load_async_callback (GimpAsync       *async,
       FcConfig     *config = gimp_async_get_result (async);
       PangoFontMap *fontmap;
       PangoContext *context;
+      GPtrArray    *fonts;
 
       FcConfigSetCurrent (config);
 
+      gimp_text_layout_reset_font_map ();
+
       fontmap = pango_cairo_font_map_new_for_font_type (CAIRO_FONT_TYPE_FT);
       if (! fontmap)
         g_error ("You are using a Pango that has been built against a cairo "
@@ -271,8 +277,13 @@ gimp_font_factory_load_async_callback (GimpAsync       *async,
       context = pango_font_map_create_context (fontmap);
       g_object_unref (fontmap);
 
-      gimp_font_factory_load_names (container, PANGO_FONT_MAP (fontmap), context);
+      fonts = g_ptr_array_new_with_free_func (g_object_unref);
+
+      gimp_font_factory_load_names (fonts, PANGO_FONT_MAP (fontmap), context);
       g_object_unref (context);
+
+      gimp_font_factory_add_fonts (container, fonts);
+      g_ptr_array_unref (fonts);
       FcConfigDestroy (config);
     }
 
@@ -513,8 +524,32 @@ gimp_font_factory_recursive_add_fontdir (FcConfig  *config,
     }
 }
 
+static gint
+gimp_font_factory_compare_fonts (GimpData **font1,
+                                 GimpData **font2)
+{
+  return gimp_data_compare (*font1, *font2);
+}
+
+/*  the container is sorted, and inserting into a sorted GimpList walks
+ *  the list from its head.  sort the fonts first and insert them in
+ *  reverse order, so each of them goes right to the head instead of
+ *  walking past all fonts added before it.
+ */
+static void
+gimp_font_factory_add_fonts (GimpContainer *container,
+                             GPtrArray     *fonts)
+{
+  gint i;
+
+  g_ptr_array_sort (fonts, (GCompareFunc) gimp_font_factory_compare_fonts);
+
+  for (i = fonts->len - 1; i >= 0; i--)
+    gimp_container_add (container, g_ptr_array_index (fonts, i));
+}
+
 static void
-gimp_font_factory_add_font (GimpContainer        *container,
+gimp_font_factory_add_font (GPtrArray            *fonts,
                             PangoContext         *context,
                             PangoFontDescription *desc)
 {
@@ -539,8 +574,7 @@ gimp_font_factory_add_font (GimpContainer        *container,
                            "pango-context", context,
                            NULL);
 
-      gimp_container_add (container, GIMP_OBJECT (font));
-      g_object_unref (font);
+      g_ptr_array_add (fonts, font);
     }
 
   g_free (name);
@@ -553,7 +587,7 @@ gimp_font_factory_add_font (GimpContainer        *container,
  * the gimp_font_list_add_font bits.
  */
 static void
-gimp_font_factory_make_alias (GimpContainer *container,
+gimp_font_factory_make_alias (GPtrArray     *fonts,
                               PangoContext  *context,
                               const gchar   *family,
                               gboolean       bold,
@@ -571,13 +605,13 @@ gimp_font_factory_make_alias (GimpContainer *container,
                                      PANGO_WEIGHT_BOLD : PANGO_WEIGHT_NORMAL);
   pango_font_description_set_stretch (desc, PANGO_STRETCH_NORMAL);
 
-  gimp_font_factory_add_font (container, context, desc);
+  gimp_font_factory_add_font (fonts, context, desc);
 
   pango_font_description_free (desc);
 }
 
 static void
-gimp_font_factory_load_aliases (GimpContainer *container,
+gimp_font_factory_load_aliases (GPtrArray     *fonts,
                                 PangoContext  *context)
 {
   const gchar *families[] = { "Sans-serif", "Serif", "Monospace" };
@@ -585,19 +619,19 @@ gimp_font_factory_load_aliases (GimpContainer *container,
 
   for (i = 0; i < 3; i++)
     {
-      gimp_font_factory_make_alias (container, context, families[i],
+      gimp_font_factory_make_alias (fonts, context, families[i],
                                     FALSE, FALSE);
-      gimp_font_factory_make_alias (container, context, families[i],
+      gimp_font_factory_make_alias (fonts, context, families[i],
                                     TRUE,  FALSE);
-      gimp_font_factory_make_alias (container, context, families[i],
+      gimp_font_factory_make_alias (fonts, context, families[i],
                                     FALSE, TRUE);
-      gimp_font_factory_make_alias (container, context, families[i],
+      gimp_font_factory_make_alias (fonts, context, families[i],
                                     TRUE,  TRUE);
     }
 }
 
 static void
-gimp_font_factory_load_names (GimpContainer *container,
+gimp_font_factory_load_names (GPtrArray     *fonts,
                               PangoFontMap  *fontmap,
                               PangoContext  *context)
 {
@@ -631,13 +665,13 @@ gimp_font_factory_load_names (GimpContainer *container,
       PangoFontDescription *desc;
 
       desc = pango_fc_font_description_from_pattern (fontset->fonts[i], FALSE);
-      gimp_font_factory_add_font (container, context, desc);
+      gimp_font_factory_add_font (fonts, context, desc);
       pango_font_description_free (desc);
     }
 
   /*  only create aliases if there is at least one font available  */
   if (fontset->nfont > 0)
-    gimp_font_factory_load_aliases (container, context);
+    gimp_font_factory_load_aliases (fonts, context);
 
   FcFontSetDestroy (fontset);
 }
@@ -645,7 +679,7 @@ gimp_font_factory_load_names (GimpContainer *container,
 #else  /* ! USE_FONTCONFIG_DIRECTLY */
 
 static void
-gimp_font_factory_load_names (GimpContainer *container,
+gimp_font_factory_load_names (GPtrArray     *fonts,
                               PangoFontMap  *fontmap,
                               PangoContext  *context)
 {
@@ -666,7 +700,7 @@ gimp_font_factory_load_names (GimpContainer *container,
           PangoFontDescription *desc;
 
           desc = pango_font_face_describe (faces[j]);
-          gimp_font_factory_add_font (container, context, desc);
+          gimp_font_factory_add_font (fonts, context, desc);
           pango_font_description_free (desc);
         }
     }
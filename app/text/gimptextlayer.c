@@ -68,7 +68,8 @@ enum
 
 struct _GimpTextLayerPrivate
 {
-  GimpTextDirection base_dir;
+  GimpTextDirection  base_dir;
+  GimpTextLayout    *layout;
 };
 
 static void       gimp_text_layer_finalize       (GObject           *object);
@@ -199,6 +200,7 @@ gimp_text_layer_finalize (GObject *object)
 {
   GimpTextLayer *layer = GIMP_TEXT_LAYER (object);
 
+  g_clear_object (&layer->private->layout);
   g_clear_object (&layer->text);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -484,6 +486,8 @@ gimp_text_layer_set_text (GimpTextLayer *layer,
       g_clear_object (&layer->text);
     }
 
+  g_clear_object (&layer->private->layout);
+
   if (text)
     {
       layer->text = g_object_ref (text);
@@ -506,6 +510,25 @@ gimp_text_layer_get_text (GimpTextLayer *layer)
   return layer->text;
 }
 
+/**
+ * gimp_text_layer_get_layout:
+ * @layer: a #GimpTextLayer
+ *
+ * Returns the layout @layer's pixels were last rendered from, so
+ * callers which need a layout of the same text don't have to create
+ * it again.
+ *
+ * Returns: (nullable) (transfer none): the layout, or %NULL if the
+ *          layer was not rendered from its current text.
+ **/
+GimpTextLayout *
+gimp_text_layer_get_layout (GimpTextLayer *layer)
+{
+  g_return_val_if_fail (GIMP_IS_TEXT_LAYER (layer), NULL);
+
+  return layer->private->layout;
+}
+
 void
 gimp_text_layer_set (GimpTextLayer *layer,
                      const gchar   *undo_desc,
@@ -701,6 +724,8 @@ gimp_text_layer_render (GimpTextLayer *layer)
   if (! layer->text)
     return FALSE;
 
+  g_clear_object (&layer->private->layout);
+
   drawable  = GIMP_DRAWABLE (layer);
   item      = GIMP_ITEM (layer);
   image     = gimp_item_get_image (item);
@@ -792,7 +817,8 @@ gimp_text_layer_render (GimpTextLayer *layer)
   if (width > 0 && height > 0)
     gimp_text_layer_render_layout (layer, layout);
 
-  g_object_unref (layout);
+  /*  keep the layout around, the text tool needs the very same one  */
+  layer->private->layout = layout;
 
   g_object_thaw_notify (G_OBJECT (drawable));
 
@@ -66,6 +66,8 @@ GimpLayer * gimp_text_layer_new         (GimpImage     *image,
 GimpText  * gimp_text_layer_get_text    (GimpTextLayer *layer);
 void        gimp_text_layer_set_text    (GimpTextLayer *layer,
                                          GimpText      *text);
+GimpTextLayout *
+            gimp_text_layer_get_layout  (GimpTextLayer *layer);
 void        gimp_text_layer_discard     (GimpTextLayer *layer);
 void        gimp_text_layer_set         (GimpTextLayer *layer,
                                          const gchar   *undo_desc,
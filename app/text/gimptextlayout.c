@@ -66,6 +66,8 @@ G_DEFINE_TYPE (GimpTextLayout, gimp_text_layout, G_TYPE_OBJECT)
 
 #define parent_class gimp_text_layout_parent_class
 
+static PangoFontMap *text_font_map = NULL;
+
 
 static void
 gimp_text_layout_class_init (GimpTextLayoutClass *klass)
@@ -456,6 +458,19 @@ gimp_text_layout_untransform_distance (GimpTextLayout *layout,
     }
 }
 
+/**
+ * gimp_text_layout_reset_font_map:
+ *
+ * Drops the font map shared by all text layouts, so layouts created
+ * afterwards use the current fontconfig configuration. Needs to be
+ * called whenever the fonts are reloaded.
+ */
+void
+gimp_text_layout_reset_font_map (void)
+{
+  g_clear_object (&text_font_map);
+}
+
 static gboolean
 gimp_text_layout_split_markup (const gchar  *markup,
                                gchar       **open_tag,
@@ -732,18 +747,23 @@ gimp_text_get_pango_context (GimpText *text,
                              gdouble   yres)
 {
   PangoContext         *context;
-  PangoFontMap         *fontmap;
   cairo_font_options_t *options;
 
-  fontmap = pango_cairo_font_map_new_for_font_type (CAIRO_FONT_TYPE_FT);
-  if (! fontmap)
-    g_error ("You are using a Pango that has been built against a cairo "
-             "that lacks the Freetype font backend");
+  /*  all layouts share one font map, so fonts and their rendered
+   *  glyphs are cached across layouts instead of being loaded again
+   *  for each of them.  the resolution is set on the context instead.
+   */
+  if (! text_font_map)
+    {
+      text_font_map = pango_cairo_font_map_new_for_font_type (CAIRO_FONT_TYPE_FT);
+      if (! text_font_map)
+        g_error ("You are using a Pango that has been built against a cairo "
+                 "that lacks the Freetype font backend");
+    }
 
-  pango_cairo_font_map_set_resolution (PANGO_CAIRO_FONT_MAP (fontmap), yres);
+  context = pango_font_map_create_context (text_font_map);
 
-  context = pango_font_map_create_context (fontmap);
-  g_object_unref (fontmap);
+  pango_cairo_context_set_resolution (context, yres);
 
   options = gimp_text_get_font_options (text);
   pango_cairo_context_set_font_options (context, options);
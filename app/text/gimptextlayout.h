@@ -75,5 +75,7 @@ void             gimp_text_layout_untransform_distance (GimpTextLayout *layout,
                                                         gdouble        *x,
                                                         gdouble        *y);
 
+void             gimp_text_layout_reset_font_map       (void);
+
 
 #endif /* __GIMP_TEXT_LAYOUT_H__ */
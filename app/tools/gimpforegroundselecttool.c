@@ -40,6 +40,8 @@
 #include "gegl/gimp-gegl-utils.h"
 
 #include "core/gimp.h"
+#include "core/gimpasync.h"
+#include "core/gimpcancelable.h"
 #include "core/gimpchannel-select.h"
 #include "core/gimpdrawable-foreground-extract.h"
 #include "core/gimperror.h"
@@ -67,6 +69,12 @@
 
 #define FAR_OUTSIDE -10000
 
+/*  drawables of at least this many pixels get a preview computed at 1/8
+ *  scale first, which is then refined at 1/4 and full scale in the
+ *  background.
+ */
+#define PROGRESSIVE_MIN_PIXELS (1024 * 1024)
+
 
 typedef struct _StrokeUndo StrokeUndo;
 
@@ -153,6 +161,12 @@ static void   gimp_foreground_select_tool_commit         (GimpForegroundSelectTo
 static void   gimp_foreground_select_tool_set_trimap     (GimpForegroundSelectTool *fg_select);
 static void   gimp_foreground_select_tool_set_preview    (GimpForegroundSelectTool *fg_select);
 static void   gimp_foreground_select_tool_preview        (GimpForegroundSelectTool *fg_select);
+static void   gimp_foreground_select_tool_compute        (GimpForegroundSelectTool *fg_select,
+                                                          gdouble                   scale);
+static void   gimp_foreground_select_tool_refine         (GimpForegroundSelectTool *fg_select);
+static void   gimp_foreground_select_tool_refine_cb      (GimpAsync                *async,
+                                                          GimpForegroundSelectTool *fg_select);
+static void   gimp_foreground_select_tool_cancel_refine  (GimpForegroundSelectTool *fg_select);
 
 static void   gimp_foreground_select_tool_stroke_paint   (GimpForegroundSelectTool *fg_select);
 static void   gimp_foreground_select_tool_cancel_paint   (GimpForegroundSelectTool *fg_select);
@@ -268,6 +282,9 @@ gimp_foreground_select_tool_finalize (GObject *object)
   if (fg_select->mask)
     g_warning ("%s: mask should be NULL at this point", G_STRLOC);
 
+  if (fg_select->async)
+    g_warning ("%s: async should be NULL at this point", G_STRLOC);
+
   if (fg_select->trimap)
     g_warning ("%s: mask should be NULL at this point", G_STRLOC);
 
@@ -972,6 +989,8 @@ gimp_foreground_select_tool_halt (GimpForegroundSelectTool *fg_select)
       gimp_draw_tool_remove_preview (draw_tool, fg_select->grayscale_preview);
     }
 
+  gimp_foreground_select_tool_cancel_refine (fg_select);
+
   g_clear_object (&fg_select->grayscale_preview);
   g_clear_object (&fg_select->trimap);
   g_clear_object (&fg_select->mask);
@@ -1032,8 +1051,12 @@ gimp_foreground_select_tool_commit (GimpForegroundSelectTool *fg_select)
     {
       GimpImage *image = gimp_display_get_image (tool->display);
 
-      if (fg_select->state != MATTING_STATE_PREVIEW_MASK)
-        gimp_foreground_select_tool_preview (fg_select);
+      gimp_foreground_select_tool_cancel_refine (fg_select);
+
+      /*  don't commit a preview computed at a lower scale  */
+      if (fg_select->state != MATTING_STATE_PREVIEW_MASK ||
+          fg_select->mask_scale < 1.0)
+        gimp_foreground_select_tool_compute (fg_select, 1.0);
 
       gimp_channel_select_buffer (gimp_image_get_mask (image),
                                   C_("command", "Foreground Select"),
@@ -1150,6 +1173,29 @@ gimp_foreground_select_tool_set_preview (GimpForegroundSelectTool *fg_select)
 
 static void
 gimp_foreground_select_tool_preview (GimpForegroundSelectTool *fg_select)
+{
+  gdouble scale = 1.0;
+
+  gimp_foreground_select_tool_cancel_refine (fg_select);
+
+  if ((gint64) gegl_buffer_get_width  (fg_select->trimap) *
+               gegl_buffer_get_height (fg_select->trimap) >=
+      PROGRESSIVE_MIN_PIXELS)
+    {
+      scale = 1.0 / 8.0;
+    }
+
+  gimp_foreground_select_tool_compute (fg_select, scale);
+
+  gimp_foreground_select_tool_set_preview (fg_select);
+
+  if (fg_select->mask_scale < 1.0)
+    gimp_foreground_select_tool_refine (fg_select);
+}
+
+static void
+gimp_foreground_select_tool_compute (GimpForegroundSelectTool *fg_select,
+                                     gdouble                   scale)
 {
   GimpTool                    *tool      = GIMP_TOOL (fg_select);
   GimpForegroundSelectOptions *options;
@@ -1172,9 +1218,87 @@ gimp_foreground_select_tool_preview (GimpForegroundSelectTool *fg_select)
                                                       options->levels,
                                                       options->active_levels,
                                                       fg_select->trimap,
+                                                      scale,
                                                       GIMP_PROGRESS (fg_select));
+  fg_select->mask_scale = scale;
+}
 
-  gimp_foreground_select_tool_set_preview (fg_select);
+/*  computes the mask at the next higher scale in the background, on a copy
+ *  of the trimap, so the user can keep painting meanwhile.
+ */
+static void
+gimp_foreground_select_tool_refine (GimpForegroundSelectTool *fg_select)
+{
+  GimpTool                    *tool      = GIMP_TOOL (fg_select);
+  GimpForegroundSelectOptions *options;
+  GimpImage                   *image     = gimp_display_get_image (tool->display);
+  GList                       *drawables = gimp_image_get_selected_drawables (image);
+  GimpDrawable                *drawable;
+
+  if (g_list_length (drawables) != 1)
+    {
+      g_list_free (drawables);
+      return;
+    }
+
+  drawable = drawables->data;
+  g_list_free (drawables);
+
+  options  = GIMP_FOREGROUND_SELECT_TOOL_GET_OPTIONS (tool);
+
+  fg_select->async_scale = fg_select->mask_scale < 0.25 ? 0.25 : 1.0;
+
+  fg_select->async =
+    gimp_drawable_foreground_extract_async (drawable,
+                                            options->engine,
+                                            options->iterations,
+                                            options->levels,
+                                            options->active_levels,
+                                            fg_select->trimap,
+                                            fg_select->async_scale);
+
+  gimp_async_add_callback_for_object (
+    fg_select->async,
+    (GimpAsyncCallback) gimp_foreground_select_tool_refine_cb,
+    fg_select,
+    fg_select);
+}
+
+static void
+gimp_foreground_select_tool_refine_cb (GimpAsync                *async,
+                                       GimpForegroundSelectTool *fg_select)
+{
+  if (gimp_async_is_canceled (async) || async != fg_select->async)
+    return;
+
+  if (gimp_async_is_finished (async))
+    {
+      g_clear_object (&fg_select->mask);
+
+      fg_select->mask       = g_object_ref (gimp_async_get_result (async));
+      fg_select->mask_scale = fg_select->async_scale;
+    }
+
+  g_clear_object (&fg_select->async);
+
+  if (fg_select->mask && fg_select->state == MATTING_STATE_PREVIEW_MASK)
+    {
+      gimp_foreground_select_tool_set_preview (fg_select);
+
+      if (fg_select->mask_scale < 1.0)
+        gimp_foreground_select_tool_refine (fg_select);
+    }
+}
+
+static void
+gimp_foreground_select_tool_cancel_refine (GimpForegroundSelectTool *fg_select)
+{
+  if (fg_select->async)
+    {
+      gimp_cancelable_cancel (GIMP_CANCELABLE (fg_select->async));
+
+      g_clear_object (&fg_select->async);
+    }
 }
 
 static void
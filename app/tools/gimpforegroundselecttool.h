@@ -53,6 +53,9 @@ struct _GimpForegroundSelectTool
   GArray                *stroke;
   GeglBuffer            *trimap;
   GeglBuffer            *mask;
+  gdouble                mask_scale;
+  GimpAsync             *async;
+  gdouble                async_scale;
 
   GList                 *undo_stack;
   GList                 *redo_stack;
@@ -58,9 +58,14 @@ typedef struct
 
 typedef struct
 {
-  GList        *drawables;
   GimpCoords    coords;
   guint32       time;
+} InterpolateEvent;
+
+typedef struct
+{
+  GList        *drawables;
+  GArray       *events;
 } InterpolateData;
 
 
@@ -70,9 +75,14 @@ static gboolean   gimp_paint_tool_paint_use_thread  (GimpPaintTool   *paint_tool
 static gpointer   gimp_paint_tool_paint_thread      (gpointer         data);
 
 static gboolean   gimp_paint_tool_paint_timeout     (GimpPaintTool   *paint_tool);
+static gboolean   gimp_paint_tool_paint_tick        (GtkWidget       *widget,
+                                                     GdkFrameClock   *frame_clock,
+                                                     GimpPaintTool   *paint_tool);
 
 static void       gimp_paint_tool_paint_interpolate (GimpPaintTool   *paint_tool,
                                                      InterpolateData *data);
+static gboolean   gimp_paint_tool_paint_coalesce    (GimpPaintTool          *paint_tool,
+                                                     const InterpolateEvent *event);
 
 
 /*  static variables  */
@@ -87,6 +97,8 @@ static GMutex             paint_queue_mutex;
 static GCond              paint_queue_cond;
 
 static guint              paint_timeout_id;
+static GtkWidget         *paint_tick_widget;
+static guint              paint_tick_id;
 static volatile gboolean  paint_timeout_pending;
 
 
@@ -204,20 +216,69 @@ gimp_paint_tool_paint_timeout (GimpPaintTool *paint_tool)
   return G_SOURCE_CONTINUE;
 }
 
+static gboolean
+gimp_paint_tool_paint_tick (GtkWidget     *widget,
+                            GdkFrameClock *frame_clock,
+                            GimpPaintTool *paint_tool)
+{
+  return gimp_paint_tool_paint_timeout (paint_tool);
+}
+
 static void
 gimp_paint_tool_paint_interpolate (GimpPaintTool   *paint_tool,
                                    InterpolateData *data)
 {
   GimpPaintOptions *paint_options = GIMP_PAINT_TOOL_GET_OPTIONS (paint_tool);
   GimpPaintCore    *core          = paint_tool->core;
+  guint             i;
 
-  gimp_paint_core_interpolate (core, data->drawables, paint_options,
-                               &data->coords, data->time);
+  for (i = 0; i < data->events->len; i++)
+    {
+      InterpolateEvent *event = &g_array_index (data->events,
+                                                InterpolateEvent, i);
 
+      gimp_paint_core_interpolate (core, data->drawables, paint_options,
+                                   &event->coords, event->time);
+    }
+
+  g_array_free (data->events, TRUE);
   g_list_free (data->drawables);
   g_slice_free (InterpolateData, data);
 }
 
+/*  appends the event to the last interpolation item in the queue, if the
+ *  paint thread didn't get to it yet, so that when the paint thread falls
+ *  behind the main thread, it catches up in batches of whole motions,
+ *  instead of handing over an item for each event.
+ */
+static gboolean
+gimp_paint_tool_paint_coalesce (GimpPaintTool          *paint_tool,
+                                const InterpolateEvent *event)
+{
+  PaintItem *item;
+  gboolean   coalesced = FALSE;
+
+  g_mutex_lock (&paint_queue_mutex);
+
+  item = g_queue_peek_tail (&paint_queue);
+
+  if (item                                                  &&
+      item->paint_tool == paint_tool                        &&
+      item->func       == (GimpPaintToolPaintFunc)
+                          gimp_paint_tool_paint_interpolate)
+    {
+      InterpolateData *data = item->data;
+
+      g_array_append_val (data->events, *event);
+
+      coalesced = TRUE;
+    }
+
+  g_mutex_unlock (&paint_queue_mutex);
+
+  return coalesced;
+}
+
 
 /*  public functions  */
 
@@ -344,14 +405,29 @@ gimp_paint_tool_paint_start (GimpPaintTool     *paint_tool,
   gimp_projection_flush_now (gimp_image_get_projection (image), TRUE);
   gimp_display_flush_now (display);
 
-  /*  Start the display update timeout  */
+  /*  Start the display update timeout.  publish the painted area once
+   *  per frame of the canvas, if we can, instead of at a fixed interval
+   */
   if (gimp_paint_tool_paint_use_thread (paint_tool))
     {
-      paint_timeout_id = g_timeout_add_full (
-        G_PRIORITY_HIGH_IDLE,
-        DISPLAY_UPDATE_INTERVAL / 1000,
-        (GSourceFunc) gimp_paint_tool_paint_timeout,
-        paint_tool, NULL);
+      GimpDisplayShell *shell = gimp_display_get_shell (display);
+
+      if (gtk_widget_get_realized (shell->canvas))
+        {
+          paint_tick_widget = g_object_ref (shell->canvas);
+          paint_tick_id     = gtk_widget_add_tick_callback (
+            paint_tick_widget,
+            (GtkTickCallback) gimp_paint_tool_paint_tick,
+            paint_tool, NULL);
+        }
+      else
+        {
+          paint_timeout_id = g_timeout_add_full (
+            G_PRIORITY_HIGH_IDLE,
+            DISPLAY_UPDATE_INTERVAL / 1000,
+            (GSourceFunc) gimp_paint_tool_paint_timeout,
+            paint_tool, NULL);
+        }
     }
 
   return TRUE;
@@ -382,8 +458,18 @@ gimp_paint_tool_paint_end (GimpPaintTool *paint_tool,
 
       g_return_if_fail (gimp_paint_tool_paint_is_active (paint_tool));
 
-      g_source_remove (paint_timeout_id);
-      paint_timeout_id = 0;
+      if (paint_tick_id)
+        {
+          gtk_widget_remove_tick_callback (paint_tick_widget, paint_tick_id);
+          paint_tick_id = 0;
+
+          g_clear_object (&paint_tick_widget);
+        }
+      else
+        {
+          g_source_remove (paint_timeout_id);
+          paint_timeout_id = 0;
+        }
 
       item = g_slice_new (PaintItem);
 
@@ -512,6 +598,7 @@ gimp_paint_tool_paint_motion (GimpPaintTool    *paint_tool,
   GimpPaintCore    *core;
   GList            *drawables;
   InterpolateData  *data;
+  InterpolateEvent  event;
 
   g_return_if_fail (GIMP_IS_PAINT_TOOL (paint_tool));
   g_return_if_fail (coords != NULL);
@@ -521,28 +608,36 @@ gimp_paint_tool_paint_motion (GimpPaintTool    *paint_tool,
   core          = paint_tool->core;
   drawables     = paint_tool->drawables;
 
-  data = g_slice_new (InterpolateData);
-
-  data->drawables = g_list_copy (drawables);
-  data->coords    = *coords;
-  data->time      = time;
+  event.coords = *coords;
+  event.time   = time;
 
-  paint_tool->cursor_x = data->coords.x;
-  paint_tool->cursor_y = data->coords.y;
+  paint_tool->cursor_x = event.coords.x;
+  paint_tool->cursor_y = event.coords.y;
 
-  gimp_paint_core_smooth_coords (core, paint_options, &data->coords);
+  gimp_paint_core_smooth_coords (core, paint_options, &event.coords);
 
   /*  Don't paint while the Shift key is pressed for line drawing  */
   if (paint_tool->draw_line)
     {
-      gimp_paint_core_set_current_coords (core, &data->coords);
-      g_list_free (data->drawables);
+      gimp_paint_core_set_current_coords (core, &event.coords);
 
-      g_slice_free (InterpolateData, data);
+      return;
+    }
 
+  if (gimp_paint_tool_paint_use_thread (paint_tool) &&
+      gimp_paint_tool_paint_coalesce (paint_tool, &event))
+    {
       return;
     }
 
+  data = g_slice_new (InterpolateData);
+
+  data->drawables = g_list_copy (drawables);
+  data->events    = g_array_sized_new (FALSE, FALSE,
+                                       sizeof (InterpolateEvent), 1);
+
+  g_array_append_val (data->events, event);
+
   gimp_paint_tool_paint_push (paint_tool,
                               (GimpPaintToolPaintFunc) gimp_paint_tool_paint_interpolate,
                               data);
@@ -2014,19 +2014,41 @@ gimp_text_tool_ensure_layout (GimpTextTool *text_tool)
 {
   if (! text_tool->layout && text_tool->text)
     {
-      GimpImage *image = gimp_item_get_image (GIMP_ITEM (text_tool->layer));
-      gdouble    xres;
-      gdouble    yres;
-      GError    *error = NULL;
+      GimpImage      *image = gimp_item_get_image (GIMP_ITEM (text_tool->layer));
+      GimpTextLayout *layout;
+      gdouble         xres;
+      gdouble         yres;
+      GError         *error = NULL;
 
       gimp_image_get_resolution (image, &xres, &yres);
 
-      text_tool->layout = gimp_text_layout_new (text_tool->layer->text,
-                                                xres, yres, &error);
-      if (error)
+      /*  reuse the layout the layer has just been rendered from,
+       *  instead of laying out the same text a second time
+       */
+      layout = gimp_text_layer_get_layout (text_tool->layer);
+
+      if (layout &&
+          gimp_text_layout_get_text (layout) == text_tool->layer->text)
         {
-          gimp_message_literal (image->gimp, NULL, GIMP_MESSAGE_ERROR, error->message);
-          g_error_free (error);
+          gdouble layout_xres;
+          gdouble layout_yres;
+
+          gimp_text_layout_get_resolution (layout, &layout_xres, &layout_yres);
+
+          if (layout_xres == xres && layout_yres == yres)
+            text_tool->layout = g_object_ref (layout);
+        }
+
+      if (! text_tool->layout)
+        {
+          text_tool->layout = gimp_text_layout_new (text_tool->layer->text,
+                                                    xres, yres, &error);
+          if (error)
+            {
+              gimp_message_literal (image->gimp, NULL, GIMP_MESSAGE_ERROR,
+                                    error->message);
+              g_error_free (error);
+            }
         }
     }
 
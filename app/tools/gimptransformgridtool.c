@@ -93,6 +93,7 @@ typedef struct
 
   GimpMatrix3            transform;
   GeglRectangle          bounds;
+  GeglSamplerType        sampler;
 } Filter;
 
 typedef struct
@@ -496,6 +497,9 @@ gimp_transform_grid_tool_button_release (GimpTool              *tool,
       /*  recalculate the tool's transformation matrix  */
       gimp_transform_tool_recalc_matrix (tr_tool, display);
     }
+
+  /*  render the final preview quality  */
+  gimp_transform_grid_tool_update_preview (tg_tool);
 }
 
 static void
@@ -1597,11 +1601,20 @@ gimp_transform_grid_tool_update_preview (GimpTransformGridTool *tg_tool)
   GimpTransformTool        *tr_tool    = GIMP_TRANSFORM_TOOL (tg_tool);
   GimpTransformOptions     *tr_options = GIMP_TRANSFORM_TOOL_GET_OPTIONS (tg_tool);
   GimpTransformGridOptions *tg_options = GIMP_TRANSFORM_GRID_TOOL_GET_OPTIONS (tg_tool);
+  GeglSamplerType           sampler;
   gint                      i;
 
   if (! tool->display)
     return;
 
+  /*  keep the preview interactive while a handle is dragged, and refine it
+   *  using the actual interpolation once it's released
+   */
+  if (tg_tool->grab_widget)
+    sampler = GEGL_SAMPLER_NEAREST;
+  else
+    sampler = (GeglSamplerType) tr_options->interpolation;
+
   if (tg_options->show_preview                              &&
       gimp_transform_grid_tool_composited_preview (tg_tool) &&
       tr_tool->transform_valid)
@@ -1686,6 +1699,17 @@ gimp_transform_grid_tool_update_preview (GimpTransformGridTool *tg_tool)
               update = TRUE;
             }
 
+          if (sampler != filter->sampler)
+            {
+              filter->sampler = sampler;
+
+              gegl_node_set (filter->transform_node,
+                             "sampler", sampler,
+                             NULL);
+
+              update = TRUE;
+            }
+
           if (GIMP_IS_LAYER (drawable))
             {
               gimp_drawable_filter_set_add_alpha (
@@ -2046,6 +2070,8 @@ filter_new (GimpTransformGridTool *tg_tool,
         "sampler",   GEGL_SAMPLER_NEAREST,
         NULL);
 
+      filter->sampler = GEGL_SAMPLER_NEAREST;
+
       filter->crop_node = gegl_node_new_child (
         node,
         "operation", "gegl:crop",
@@ -54,6 +54,9 @@ static gdouble
                                             GimpCoords            *ret_point,
                                             gdouble               *ret_pos,
                                             gint                   depth);
+static gdouble
+    gimp_bezier_stroke_segment_min_dist    (const GimpCoords      *beziercoords,
+                                            const GimpCoords      *coord);
 static gdouble
     gimp_bezier_stroke_nearest_tangent_get (GimpStroke            *stroke,
                                             const GimpCoords      *coord1,
@@ -607,12 +610,19 @@ gimp_bezier_stroke_nearest_point_get (GimpStroke        *stroke,
       if (count == 4)
         {
           segment_end = anchorlist->data;
-          dist = gimp_bezier_stroke_segment_nearest_point_get (segmentcoords,
-                                                               coord, precision,
-                                                               &point, &pos,
-                                                               10);
 
-          if (dist < min_dist || min_dist < 0)
+          /*  don't subdivide segments which can't be any closer  */
+          if (min_dist >= 0 &&
+              gimp_bezier_stroke_segment_min_dist (segmentcoords,
+                                                   coord) >= min_dist)
+            dist = -1;
+          else
+            dist = gimp_bezier_stroke_segment_nearest_point_get (segmentcoords,
+                                                                 coord, precision,
+                                                                 &point, &pos,
+                                                                 10);
+
+          if (dist >= 0 && (dist < min_dist || min_dist < 0))
             {
               min_dist = dist;
 
@@ -673,6 +683,34 @@ gimp_bezier_stroke_nearest_point_get (GimpStroke        *stroke,
   return min_dist;
 }
 
+/*  a lower bound of the distance between coord and any point of the
+ *  segment, which lies within the bounding box of its control points
+ */
+static gdouble
+gimp_bezier_stroke_segment_min_dist (const GimpCoords *beziercoords,
+                                     const GimpCoords *coord)
+{
+  gdouble x1, y1, x2, y2;
+  gdouble dx, dy;
+  gint    i;
+
+  x1 = x2 = beziercoords[0].x;
+  y1 = y2 = beziercoords[0].y;
+
+  for (i = 1; i < 4; i++)
+    {
+      x1 = MIN (x1, beziercoords[i].x);
+      y1 = MIN (y1, beziercoords[i].y);
+      x2 = MAX (x2, beziercoords[i].x);
+      y2 = MAX (y2, beziercoords[i].y);
+    }
+
+  dx = MAX (MAX (x1 - coord->x, coord->x - x2), 0.0);
+  dy = MAX (MAX (y1 - coord->y, coord->y - y2), 0.0);
+
+  return sqrt (dx * dx + dy * dy);
+}
+
 
 static gdouble
 gimp_bezier_stroke_segment_nearest_point_get (const GimpCoords *beziercoords,
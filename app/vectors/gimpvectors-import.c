@@ -94,6 +94,7 @@ struct _SvgHandler
   gdouble       height;
   gchar        *id;
   GList        *paths;
+  GList        *paths_tail;
   GimpMatrix3  *transform;
 };
 
@@ -506,7 +507,28 @@ svg_parser_end_element (GMarkupParseContext  *context,
         }
 
       base = g_queue_peek_head (parser->stack);
-      base->paths = g_list_concat (base->paths, handler->paths);
+
+      /*  remember where the parent's list ends; appending with
+       *  g_list_concat() would walk all paths collected so far for
+       *  each element
+       */
+      if (! base->paths_tail)
+        base->paths_tail = g_list_last (base->paths);
+
+      if (base->paths_tail)
+        {
+          base->paths_tail->next = handler->paths;
+          handler->paths->prev   = base->paths_tail;
+        }
+      else
+        {
+          base->paths = handler->paths;
+        }
+
+      if (handler->paths_tail)
+        base->paths_tail = handler->paths_tail;
+      else
+        base->paths_tail = g_list_last (handler->paths);
     }
 
   g_slice_free (SvgHandler, handler);
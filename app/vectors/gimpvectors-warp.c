@@ -40,16 +40,44 @@
 #define DX      2.0
 
 
-static void   gimp_stroke_warp_point   (GimpStroke  *stroke,
-                                        gdouble      x,
-                                        gdouble      y,
-                                        GimpCoords  *point_warped,
-                                        gdouble      y_offset,
-                                        gdouble      x_len);
+/*  warping a point looks up several points along the path, each of
+ *  which used to interpolate the whole stroke again.  interpolate each
+ *  stroke only once per warp instead, and keep the distance along the
+ *  polyline to each of its points for binary searching.
+ */
+typedef struct
+{
+  GimpStroke *stroke;
+  gdouble     length;
+  gboolean    interpolated;
+  GArray     *points;
+  gdouble    *segments;
+  gdouble    *distances;
+} WarpStroke;
+
+
+static GArray * gimp_vectors_warp_strokes_new      (GimpVectors *vectors);
+static void     gimp_vectors_warp_strokes_free     (GArray      *strokes);
 
-static void   gimp_vectors_warp_stroke (GimpVectors *vectors,
-                                        GimpStroke  *stroke,
-                                        gdouble      y_offset);
+static void     gimp_vectors_warp_point_real       (GArray      *strokes,
+                                                    GimpCoords  *point,
+                                                    GimpCoords  *point_warped,
+                                                    gdouble      y_offset);
+
+static gboolean gimp_warp_stroke_get_point_at_dist (WarpStroke  *stroke,
+                                                    gdouble      dist,
+                                                    GimpCoords  *position);
+
+static void     gimp_stroke_warp_point             (WarpStroke  *stroke,
+                                                    gdouble      x,
+                                                    gdouble      y,
+                                                    GimpCoords  *point_warped,
+                                                    gdouble      y_offset,
+                                                    gdouble      x_len);
+
+static void     gimp_vectors_warp_stroke           (GArray      *strokes,
+                                                    GimpStroke  *stroke,
+                                                    gdouble      y_offset);
 
 
 void
@@ -58,38 +86,171 @@ gimp_vectors_warp_point (GimpVectors *vectors,
                          GimpCoords  *point_warped,
                          gdouble      y_offset)
 {
-  gdouble     x      = point->x;
-  gdouble     y      = point->y;
-  gdouble     len;
-  GList      *list;
-  GimpStroke *stroke;
+  GArray *strokes = gimp_vectors_warp_strokes_new (vectors);
+
+  gimp_vectors_warp_point_real (strokes, point, point_warped, y_offset);
+
+  gimp_vectors_warp_strokes_free (strokes);
+}
+
+static GArray *
+gimp_vectors_warp_strokes_new (GimpVectors *vectors)
+{
+  GArray *strokes = g_array_new (FALSE, TRUE, sizeof (WarpStroke));
+  GList  *list;
 
   for (list = vectors->strokes->head;
        list;
        list = g_list_next (list))
     {
-      stroke = list->data;
+      WarpStroke stroke = { 0, };
 
-      len = gimp_vectors_stroke_get_length (vectors, stroke);
+      stroke.stroke = list->data;
+      stroke.length = gimp_vectors_stroke_get_length (vectors, stroke.stroke);
+
+      g_array_append_val (strokes, stroke);
+    }
+
+  return strokes;
+}
+
+static void
+gimp_vectors_warp_strokes_free (GArray *strokes)
+{
+  gint i;
+
+  for (i = 0; i < strokes->len; i++)
+    {
+      WarpStroke *stroke = &g_array_index (strokes, WarpStroke, i);
+
+      if (stroke->points)
+        g_array_free (stroke->points, TRUE);
+
+      g_free (stroke->segments);
+      g_free (stroke->distances);
+    }
+
+  g_array_free (strokes, TRUE);
+}
+
+static void
+gimp_vectors_warp_point_real (GArray     *strokes,
+                              GimpCoords *point,
+                              GimpCoords *point_warped,
+                              gdouble     y_offset)
+{
+  gdouble     x      = point->x;
+  gdouble     y      = point->y;
+  WarpStroke *stroke = NULL;
+  gint        i;
 
-      if (x < len || ! list->next)
+  for (i = 0; i < strokes->len; i++)
+    {
+      stroke = &g_array_index (strokes, WarpStroke, i);
+
+      if (x < stroke->length || i == strokes->len - 1)
         break;
 
-      x -= len;
+      x -= stroke->length;
     }
 
-  if (! list)
+  if (! stroke)
     {
       point_warped->x = 0;
       point_warped->y = 0;
       return;
     }
 
-  gimp_stroke_warp_point (stroke, x, y, point_warped, y_offset, len);
+  gimp_stroke_warp_point (stroke, x, y, point_warped, y_offset,
+                          stroke->length);
+}
+
+/*  returns the same point as gimp_stroke_get_point_at_dist() does  */
+static gboolean
+gimp_warp_stroke_get_point_at_dist (WarpStroke *stroke,
+                                    gdouble     dist,
+                                    GimpCoords *position)
+{
+  GimpCoords *points;
+  gint        n_segments;
+  gint        lo, hi;
+  gint        i;
+  gdouble     u;
+
+  if (! stroke->interpolated)
+    {
+      stroke->interpolated = TRUE;
+      stroke->points       = gimp_stroke_interpolate (stroke->stroke,
+                                                      EPSILON, NULL);
+
+      if (stroke->points && stroke->points->len > 1)
+        {
+          gdouble length = 0.0;
+
+          points     = (GimpCoords *) stroke->points->data;
+          n_segments = stroke->points->len - 1;
+
+          stroke->segments  = g_new (gdouble, n_segments);
+          stroke->distances = g_new (gdouble, n_segments + 1);
+
+          stroke->distances[0] = 0.0;
+
+          for (i = 0; i < n_segments; i++)
+            {
+              GimpCoords difference;
+
+              gimp_coords_difference (&points[i], &points[i + 1],
+                                      &difference);
+
+              stroke->segments[i] = gimp_coords_length (&difference);
+
+              length += stroke->segments[i];
+
+              stroke->distances[i + 1] = length;
+            }
+        }
+    }
+
+  if (! stroke->distances)
+    return FALSE;
+
+  points     = (GimpCoords *) stroke->points->data;
+  n_segments = stroke->points->len - 1;
+
+  /*  find the first segment ending at or beyond dist...  */
+  lo = 0;
+  hi = n_segments;
+
+  while (lo < hi)
+    {
+      gint mid = (lo + hi) / 2;
+
+      if (stroke->distances[mid + 1] >= dist)
+        hi = mid;
+      else
+        lo = mid + 1;
+    }
+
+  /*  ...skipping empty segments  */
+  for (i = lo; i < n_segments && stroke->segments[i] == 0; i++);
+
+  if (i == n_segments)
+    return FALSE;
+
+  /* x = x1 + (x2 - x1 ) u  */
+  /* x   = x1 (1-u) + u x2  */
+
+  u = (dist - stroke->distances[i]) / stroke->segments[i];
+
+  gimp_coords_mix (1 - u, &points[i],
+                       u, &points[i + 1],
+                   position);
+
+  return TRUE;
 }
 
 static void
-gimp_stroke_warp_point (GimpStroke *stroke,
+gimp_stroke_warp_point (WarpStroke *stroke,
                         gdouble     x,
                         gdouble     y,
                         GimpCoords *point_warped,
@@ -99,15 +260,14 @@ gimp_stroke_warp_point (GimpStroke *stroke,
   GimpCoords point_zero  = { 0, };
   GimpCoords point_minus = { 0, };
   GimpCoords point_plus  = { 0, };
-  gdouble    slope;
   gdouble    dx, dy, nx, ny, len;
 
   if (x + DX >= x_len)
     {
       gdouble tx, ty;
 
-      if (! gimp_stroke_get_point_at_dist (stroke, x_len, EPSILON,
-                                           &point_zero, &slope))
+      if (! gimp_warp_stroke_get_point_at_dist (stroke, x_len,
+                                                &point_zero))
         {
           point_warped->x = 0;
           point_warped->y = 0;
@@ -117,8 +277,8 @@ gimp_stroke_warp_point (GimpStroke *stroke,
       point_warped->x = point_zero.x;
       point_warped->y = point_zero.y;
 
-      if (! gimp_stroke_get_point_at_dist (stroke, x_len - DX, EPSILON,
-                                           &point_minus, &slope))
+      if (! gimp_warp_stroke_get_point_at_dist (stroke, x_len - DX,
+                                                &point_minus))
         return;
 
       dx = point_zero.x - point_minus.x;
@@ -141,8 +301,8 @@ gimp_stroke_warp_point (GimpStroke *stroke,
       return;
     }
 
-  if (! gimp_stroke_get_point_at_dist (stroke, x, EPSILON,
-                                       &point_zero, &slope))
+  if (! gimp_warp_stroke_get_point_at_dist (stroke, x,
+                                            &point_zero))
     {
       point_warped->x = 0;
       point_warped->y = 0;
@@ -152,12 +312,12 @@ gimp_stroke_warp_point (GimpStroke *stroke,
   point_warped->x = point_zero.x;
   point_warped->y = point_zero.y;
 
-  if (! gimp_stroke_get_point_at_dist (stroke, x - DX, EPSILON,
-                                       &point_minus, &slope))
+  if (! gimp_warp_stroke_get_point_at_dist (stroke, x - DX,
+                                            &point_minus))
     return;
 
-  if (! gimp_stroke_get_point_at_dist (stroke, x + DX, EPSILON,
-                                       &point_plus, &slope))
+  if (! gimp_warp_stroke_get_point_at_dist (stroke, x + DX,
+                                            &point_plus))
     return;
 
   dx = point_plus.x - point_minus.x;
@@ -176,9 +336,9 @@ gimp_stroke_warp_point (GimpStroke *stroke,
 }
 
 static void
-gimp_vectors_warp_stroke (GimpVectors *vectors,
-                          GimpStroke  *stroke,
-                          gdouble      y_offset)
+gimp_vectors_warp_stroke (GArray     *strokes,
+                          GimpStroke *stroke,
+                          gdouble     y_offset)
 {
   GList *list;
 
@@ -186,9 +346,9 @@ gimp_vectors_warp_stroke (GimpVectors *vectors,
     {
       GimpAnchor *anchor = list->data;
 
-      gimp_vectors_warp_point (vectors,
-                               &anchor->position, &anchor->position,
-                               y_offset);
+      gimp_vectors_warp_point_real (strokes,
+                                    &anchor->position, &anchor->position,
+                                    y_offset);
     }
 }
 
@@ -197,7 +357,8 @@ gimp_vectors_warp_vectors (GimpVectors *vectors,
                            GimpVectors *vectors_in,
                            gdouble      y_offset)
 {
-  GList *list;
+  GArray *strokes = gimp_vectors_warp_strokes_new (vectors);
+  GList  *list;
 
   for (list = vectors_in->strokes->head;
        list;
@@ -205,6 +366,8 @@ gimp_vectors_warp_vectors (GimpVectors *vectors,
     {
       GimpStroke *stroke = list->data;
 
-      gimp_vectors_warp_stroke (vectors, stroke, y_offset);
+      gimp_vectors_warp_stroke (strokes, stroke, y_offset);
     }
+
+  gimp_vectors_warp_strokes_free (strokes);
 }
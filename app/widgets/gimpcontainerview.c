@@ -97,6 +97,8 @@ static void   gimp_container_view_add_container    (GimpContainerView  *view,
                                                     GimpContainer      *container);
 static void   gimp_container_view_add_foreach      (GimpViewable       *viewable,
                                                     GimpContainerView  *view);
+static void   gimp_container_view_prepend_foreach  (GimpViewable       *viewable,
+                                                    GList             **list);
 static void   gimp_container_view_add              (GimpContainerView  *view,
                                                     GimpViewable       *viewable,
                                                     GimpContainer      *container);
@@ -1087,11 +1089,22 @@ static void
 gimp_container_view_add_container (GimpContainerView *view,
                                    GimpContainer     *container)
 {
-  GimpContainerViewPrivate *private = GIMP_CONTAINER_VIEW_GET_PRIVATE (view);
+  GimpContainerViewPrivate *private  = GIMP_CONTAINER_VIEW_GET_PRIVATE (view);
+  GList                    *children = NULL;
+  GList                    *list;
 
+  /*  add the children in reverse order, each at the top, because
+   *  prepending is O(1) for the tree stores used by the views, while
+   *  appending walks all the siblings added so far
+   */
   gimp_container_foreach (container,
-                          (GFunc) gimp_container_view_add_foreach,
-                          view);
+                          (GFunc) gimp_container_view_prepend_foreach,
+                          &children);
+
+  for (list = children; list; list = g_list_next (list))
+    gimp_container_view_add_foreach (list->data, view);
+
+  g_list_free (children);
 
   if (container == private->container)
     {
@@ -1153,7 +1166,7 @@ gimp_container_view_add_foreach (GimpViewable      *viewable,
     parent_insert_data = g_hash_table_lookup (private->item_hash, parent);
 
   insert_data = view_iface->insert_item (view, viewable,
-                                         parent_insert_data, -1);
+                                         parent_insert_data, 0);
 
   g_hash_table_insert (private->item_hash, viewable, insert_data);
 
@@ -1163,6 +1176,13 @@ gimp_container_view_add_foreach (GimpViewable      *viewable,
     gimp_container_view_add_container (view, children);
 }
 
+static void
+gimp_container_view_prepend_foreach (GimpViewable  *viewable,
+                                     GList        **list)
+{
+  *list = g_list_prepend (*list, viewable);
+}
+
 static void
 gimp_container_view_add (GimpContainerView *view,
                          GimpViewable      *viewable,
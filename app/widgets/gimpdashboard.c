@@ -62,11 +62,20 @@
 #include "core/gimp-gui.h"
 #include "core/gimp-utils.h"
 #include "core/gimp-parallel.h"
+#include "core/gimp-trace.h"
 #include "core/gimpasync.h"
 #include "core/gimpbacktrace.h"
+#include "core/gimpbrushcache.h"
+#include "core/gimpchunkiterator.h"
+#include "core/gimpprojection.h"
 #include "core/gimptempbuf.h"
 #include "core/gimpwaitable.h"
 
+#include "gegl/gimpapplicator.h"
+#include "gegl/gimptilehandlervalidate.h"
+
+#include "operations/layer-modes/gimp-layer-modes.h"
+
 #include "gimpactiongroup.h"
 #include "gimpdocked.h"
 #include "gimpdashboard.h"
@@ -101,6 +110,7 @@
 #define LOG_DEFAULT_BACKTRACE          TRUE
 #define LOG_DEFAULT_MESSAGES           TRUE
 #define LOG_DEFAULT_PROGRESSIVE        FALSE
+#define LOG_DEFAULT_TRACE              FALSE
 
 
 typedef enum
@@ -152,9 +162,21 @@ typedef enum
   VARIABLE_ASSIGNED_THREADS,
   VARIABLE_ACTIVE_THREADS,
   VARIABLE_ASYNC_RUNNING,
+  VARIABLE_ASYNC_STEALS,
+  VARIABLE_ASYNC_QUEUE_WAIT_TIME,
+  VARIABLE_CHUNK_TIME_0,
+  VARIABLE_CHUNK_TIME_1,
+  VARIABLE_CHUNK_TIME_2,
+  VARIABLE_CHUNK_TIME_3,
+  VARIABLE_DROPPED_FRAMES,
+  VARIABLE_LAYER_MODE_SHORTCUTS,
+  VARIABLE_APPLICATOR_RECONFIGURE_TIME,
+  VARIABLE_ON_DEMAND_VALIDATION_TIME,
   VARIABLE_TILE_ALLOC_TOTAL,
   VARIABLE_SCRATCH_TOTAL,
   VARIABLE_TEMP_BUF_TOTAL,
+  VARIABLE_BRUSH_CACHE_TOTAL,
+  VARIABLE_BRUSH_CACHE_HIT_RATE,
 
 
   N_VARIABLES,
@@ -325,6 +347,7 @@ struct _GimpDashboardPrivate
   GimpBacktrace                *log_backtrace;
   GHashTable                   *log_addresses;
   GimpLogHandler                log_log_handler;
+  GFile                        *log_trace_file;
 
   GtkWidget                    *log_record_button;
   GtkLabel                     *log_add_marker_label;
@@ -366,6 +389,8 @@ static void       gimp_dashboard_sample_gegl_config             (GimpDashboard
                                                                  Variable             variable);
 static void       gimp_dashboard_sample_gegl_stats              (GimpDashboard       *dashboard,
                                                                  Variable             variable);
+static void       gimp_dashboard_sample_chunk_time_histogram    (GimpDashboard       *dashboard,
+                                                                 Variable             variable);
 static void       gimp_dashboard_sample_variable_changed        (GimpDashboard       *dashboard,
                                                                  Variable             variable);
 static void       gimp_dashboard_sample_variable_rate_of_change (GimpDashboard       *dashboard,
@@ -735,6 +760,108 @@ static const VariableInfo variables[] =
     .data             = gimp_async_get_n_running
   },
 
+  [VARIABLE_ASYNC_STEALS] =
+  { .name             = "async-steals",
+    .title            = NC_("dashboard-variable", "Async steals"),
+    .description      = N_("Number of asynchronous tasks taken from the queue "
+                           "of another worker thread"),
+    .type             = VARIABLE_TYPE_INTEGER,
+    .sample_func      = gimp_dashboard_sample_function,
+    .data             = gimp_parallel_run_async_get_n_steals
+  },
+
+  [VARIABLE_ASYNC_QUEUE_WAIT_TIME] =
+  { .name             = "async-queue-wait-time",
+    .title            = NC_("dashboard-variable", "Async wait"),
+    .description      = N_("Total amount of time asynchronous tasks have "
+                           "spent waiting in a queue"),
+    .type             = VARIABLE_TYPE_DURATION,
+    .sample_func      = gimp_dashboard_sample_function,
+    .data             = gimp_parallel_run_async_get_queue_wait_time
+  },
+
+  [VARIABLE_CHUNK_TIME_0] =
+  { .name             = "chunk-time-0",
+    .title            = NC_("dashboard-variable", "Chunks < 4ms"),
+    .description      = N_("Number of rendered chunks which took less than "
+                           "4 milliseconds"),
+    .type             = VARIABLE_TYPE_INTEGER,
+    .sample_func      = gimp_dashboard_sample_chunk_time_histogram,
+    .data             = GINT_TO_POINTER (0)
+  },
+
+  [VARIABLE_CHUNK_TIME_1] =
+  { .name             = "chunk-time-1",
+    .title            = NC_("dashboard-variable", "Chunks < 16ms"),
+    .description      = N_("Number of rendered chunks which took between "
+                           "4 and 16 milliseconds"),
+    .type             = VARIABLE_TYPE_INTEGER,
+    .sample_func      = gimp_dashboard_sample_chunk_time_histogram,
+    .data             = GINT_TO_POINTER (1)
+  },
+
+  [VARIABLE_CHUNK_TIME_2] =
+  { .name             = "chunk-time-2",
+    .title            = NC_("dashboard-variable", "Chunks < 64ms"),
+    .description      = N_("Number of rendered chunks which took between "
+                           "16 and 64 milliseconds"),
+    .type             = VARIABLE_TYPE_INTEGER,
+    .sample_func      = gimp_dashboard_sample_chunk_time_histogram,
+    .data             = GINT_TO_POINTER (2)
+  },
+
+  [VARIABLE_CHUNK_TIME_3] =
+  { .name             = "chunk-time-3",
+    .title            = NC_("dashboard-variable", "Chunks >= 64ms"),
+    .description      = N_("Number of rendered chunks which took 64 "
+                           "milliseconds or more"),
+    .type             = VARIABLE_TYPE_INTEGER,
+    .sample_func      = gimp_dashboard_sample_chunk_time_histogram,
+    .data             = GINT_TO_POINTER (3)
+  },
+
+  [VARIABLE_DROPPED_FRAMES] =
+  { .name             = "dropped-frames",
+    .title            = NC_("dashboard-variable", "Dropped frames"),
+    .description      = N_("Number of display frames that were dropped "
+                           "while rendering the image"),
+    .type             = VARIABLE_TYPE_INTEGER,
+    .sample_func      = gimp_dashboard_sample_function,
+    .data             = gimp_projection_get_n_dropped_frames
+  },
+
+  [VARIABLE_LAYER_MODE_SHORTCUTS] =
+  { .name             = "layer-mode-shortcuts",
+    .title            = NC_("dashboard-variable", "Composite skips"),
+    .description      = N_("Number of fully transparent or fully opaque "
+                           "layer areas that were skipped or copied, "
+                           "instead of composited"),
+    .type             = VARIABLE_TYPE_INTEGER,
+    .sample_func      = gimp_dashboard_sample_function,
+    .data             = gimp_layer_modes_get_n_shortcuts
+  },
+
+  [VARIABLE_APPLICATOR_RECONFIGURE_TIME] =
+  { .name             = "applicator-reconfigure-time",
+    .title            = NC_("dashboard-variable", "Reconfigure"),
+    .description      = N_("Total amount of time spent reconfiguring the "
+                           "graphs applying paint and filters"),
+    .type             = VARIABLE_TYPE_DURATION,
+    .sample_func      = gimp_dashboard_sample_function,
+    .data             = gimp_applicator_get_reconfigure_time
+  },
+
+  [VARIABLE_ON_DEMAND_VALIDATION_TIME] =
+  { .name             = "on-demand-validation-time",
+    .title            = NC_("dashboard-variable", "On-demand"),
+    .description      = N_("Total amount of time spent rendering tiles "
+                           "on demand, blocking other reads of their "
+                           "buffer"),
+    .type             = VARIABLE_TYPE_DURATION,
+    .sample_func      = gimp_dashboard_sample_function,
+    .data             = gimp_tile_handler_validate_get_on_demand_time
+  },
+
   [VARIABLE_TILE_ALLOC_TOTAL] =
   { .name             = "tile-alloc-total",
     .title            = NC_("dashboard-variable", "Tile"),
@@ -764,6 +891,24 @@ static const VariableInfo variables[] =
     .type             = VARIABLE_TYPE_SIZE,
     .sample_func      = gimp_dashboard_sample_function,
     .data             = gimp_temp_buf_get_total_memsize
+  },
+
+  [VARIABLE_BRUSH_CACHE_TOTAL] =
+  { .name             = "brush-cache-total",
+    .title            = NC_("dashboard-variable", "Brush cache"),
+    .description      = N_("Total size of cached transformed brushes"),
+    .type             = VARIABLE_TYPE_SIZE,
+    .sample_func      = gimp_dashboard_sample_function,
+    .data             = gimp_brush_cache_get_total_memsize
+  },
+
+  [VARIABLE_BRUSH_CACHE_HIT_RATE] =
+  { .name             = "brush-cache-hit-rate",
+    .title            = NC_("dashboard-variable", "Brush hits"),
+    .description      = N_("Brush cache hit rate"),
+    .type             = VARIABLE_TYPE_PERCENTAGE,
+    .sample_func      = gimp_dashboard_sample_function,
+    .data             = gimp_brush_cache_get_hit_rate
   }
 };
 
@@ -972,6 +1117,45 @@ static const GroupInfo groups[] =
                           { .variable       = VARIABLE_ASYNC_RUNNING,
                             .default_active = TRUE
                           },
+                          { .variable       = VARIABLE_ASYNC_STEALS,
+                            .default_active = FALSE
+                          },
+                          { .variable       = VARIABLE_ASYNC_QUEUE_WAIT_TIME,
+                            .default_active = FALSE
+                          },
+
+                          { VARIABLE_SEPARATOR },
+
+                          { .variable       = VARIABLE_CHUNK_TIME_0,
+                            .default_active = FALSE
+                          },
+                          { .variable       = VARIABLE_CHUNK_TIME_1,
+                            .default_active = FALSE
+                          },
+                          { .variable       = VARIABLE_CHUNK_TIME_2,
+                            .default_active = FALSE
+                          },
+                          { .variable       = VARIABLE_CHUNK_TIME_3,
+                            .default_active = FALSE
+                          },
+                          { .variable       = VARIABLE_DROPPED_FRAMES,
+                            .default_active = FALSE
+                          },
+
+                          { VARIABLE_SEPARATOR },
+
+                          { .variable       = VARIABLE_LAYER_MODE_SHORTCUTS,
+                            .default_active = FALSE
+                          },
+                          { .variable       = VARIABLE_APPLICATOR_RECONFIGURE_TIME,
+                            .default_active = FALSE
+                          },
+                          { .variable       = VARIABLE_ON_DEMAND_VALIDATION_TIME,
+                            .default_active = FALSE
+                          },
+
+                          { VARIABLE_SEPARATOR },
+
                           { .variable       = VARIABLE_TILE_ALLOC_TOTAL,
                             .default_active = TRUE
                           },
@@ -982,6 +1166,15 @@ static const GroupInfo groups[] =
                             .default_active = TRUE
                           },
 
+                          { VARIABLE_SEPARATOR },
+
+                          { .variable       = VARIABLE_BRUSH_CACHE_TOTAL,
+                            .default_active = FALSE
+                          },
+                          { .variable       = VARIABLE_BRUSH_CACHE_HIT_RATE,
+                            .default_active = FALSE
+                          },
+
                           {}
                         }
   },
@@ -2059,6 +2252,19 @@ gimp_dashboard_sample_gegl_stats (GimpDashboard *dashboard,
   gimp_dashboard_sample_object (dashboard, G_OBJECT (gegl_stats ()), variable);
 }
 
+static void
+gimp_dashboard_sample_chunk_time_histogram (GimpDashboard *dashboard,
+                                            Variable       variable)
+{
+  GimpDashboardPrivate *priv          = dashboard->priv;
+  const VariableInfo   *variable_info = &variables[variable];
+  VariableData         *variable_data = &priv->variables[variable];
+
+  variable_data->available     = TRUE;
+  variable_data->value.integer = gimp_chunk_iterator_get_time_histogram (
+    GPOINTER_TO_INT (variable_info->data));
+}
+
 static void
 gimp_dashboard_sample_variable_changed (GimpDashboard *dashboard,
                                         Variable       variable)
@@ -4477,6 +4683,12 @@ gimp_dashboard_log_start_recording (GimpDashboard                 *dashboard,
         atoi (g_getenv ("GIMP_PERFORMANCE_LOG_PROGRESSIVE")) ? 1 : 0;
     }
 
+  if (g_getenv ("GIMP_PERFORMANCE_LOG_TRACE"))
+    {
+      priv->log_params.trace =
+        atoi (g_getenv ("GIMP_PERFORMANCE_LOG_TRACE")) ? 1 : 0;
+    }
+
   priv->log_params.sample_frequency = CLAMP (priv->log_params.sample_frequency,
                                              LOG_SAMPLE_FREQUENCY_MIN,
                                              LOG_SAMPLE_FREQUENCY_MAX);
@@ -4515,6 +4727,24 @@ gimp_dashboard_log_start_recording (GimpDashboard                 *dashboard,
   else
     has_backtrace = FALSE;
 
+  /* the trace spans are written, in the Chrome trace format, to a separate
+   * file next to the log, so that they can be viewed alongside the samples.
+   * if a trace is already being recorded (using --profile-startup), leave
+   * it alone.
+   */
+  if (priv->log_params.trace && ! gimp_trace_is_active ())
+    {
+      gchar *uri       = g_file_get_uri (file);
+      gchar *trace_uri = g_strconcat (uri, ".trace.json", NULL);
+
+      priv->log_trace_file = g_file_new_for_uri (trace_uri);
+
+      g_free (trace_uri);
+      g_free (uri);
+
+      gimp_trace_start ();
+    }
+
   gimp_dashboard_log_printf (dashboard,
                              "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
                              "<gimp-performance-log version=\"%d\">\n",
@@ -4527,11 +4757,13 @@ gimp_dashboard_log_start_recording (GimpDashboard                 *dashboard,
                              "<backtrace>%d</backtrace>\n"
                              "<messages>%d</messages>\n"
                              "<progressive>%d</progressive>\n"
+                             "<trace>%d</trace>\n"
                              "</params>\n",
                              priv->log_params.sample_frequency,
                              has_backtrace,
                              priv->log_params.messages,
-                             priv->log_params.progressive);
+                             priv->log_params.progressive,
+                             priv->log_trace_file != NULL);
 
   gimp_dashboard_log_printf (dashboard,
                              "\n"
@@ -4793,6 +5025,14 @@ gimp_dashboard_log_stop_recording (GimpDashboard  *dashboard,
 
   g_clear_object (&priv->log_output);
 
+  if (priv->log_trace_file)
+    {
+      gimp_trace_stop (priv->log_trace_file,
+                       priv->log_error ? NULL : &priv->log_error);
+
+      g_clear_object (&priv->log_trace_file);
+    }
+
   if (priv->log_error)
     {
       g_propagate_error (error, priv->log_error);
@@ -4836,7 +5076,8 @@ gimp_dashboard_log_get_default_params (GimpDashboard *dashboard)
     .sample_frequency = LOG_DEFAULT_SAMPLE_FREQUENCY,
     .backtrace        = LOG_DEFAULT_BACKTRACE,
     .messages         = LOG_DEFAULT_MESSAGES,
-    .progressive      = LOG_DEFAULT_PROGRESSIVE
+    .progressive      = LOG_DEFAULT_PROGRESSIVE,
+    .trace            = LOG_DEFAULT_TRACE
   };
 
   g_return_val_if_fail (GIMP_IS_DASHBOARD (dashboard), NULL);
@@ -31,6 +31,7 @@ struct _GimpDashboardLogParams
   gboolean backtrace;
   gboolean messages;
   gboolean progressive;
+  gboolean trace;
 };
 
 
@@ -47,6 +47,7 @@ struct _GimpSaveDialogState
 {
   gchar    *filter_name;
   gboolean  compression;
+  gboolean  zstd_compression;
 };
 
 
@@ -61,6 +62,10 @@ static void     gimp_save_dialog_add_extra_widgets (GimpSaveDialog      *dialog)
 static void     gimp_save_dialog_compression_toggled
                                                    (GtkToggleButton     *button,
                                                     GimpSaveDialog      *dialog);
+static void     gimp_save_dialog_zstd_toggled      (GtkToggleButton     *button,
+                                                    GimpSaveDialog      *dialog);
+static void     gimp_save_dialog_update_compat_info
+                                                   (GimpSaveDialog      *dialog);
 
 static GimpSaveDialogState
               * gimp_save_dialog_get_state         (GimpSaveDialog      *dialog);
@@ -167,6 +172,7 @@ gimp_save_dialog_set_image (GimpSaveDialog *dialog,
   const gchar    *version_string;
   gint            rle_version;
   gint            zlib_version;
+  gint            zstd_version;
 
   g_return_if_fail (GIMP_IS_SAVE_DIALOG (dialog));
   g_return_if_fail (GIMP_IS_IMAGE (image));
@@ -250,11 +256,14 @@ gimp_save_dialog_set_image (GimpSaveDialog *dialog,
   else
     ext_file = g_file_new_for_uri ("file:///we/only/care/about/extension.xcf");
 
-  gimp_image_get_xcf_version (image, FALSE, &rle_version,
+  gimp_image_get_xcf_version (image, FALSE, FALSE, &rle_version,
                               &version_string, NULL);
-  gimp_image_get_xcf_version (image, TRUE,  &zlib_version,
+  gimp_image_get_xcf_version (image, TRUE,  FALSE, &zlib_version,
+                              NULL, NULL);
+  gimp_image_get_xcf_version (image, FALSE, TRUE,  &zstd_version,
                               NULL, NULL);
-  if (rle_version != zlib_version)
+  if (rle_version != zlib_version ||
+      (dialog->zstd_toggle && rle_version != zstd_version))
     {
       GtkWidget *label;
       gchar     *text;
@@ -267,12 +276,19 @@ gimp_save_dialog_set_image (GimpSaveDialog *dialog,
       gimp_label_set_attributes (GTK_LABEL (label),
                                  PANGO_ATTR_STYLE, PANGO_STYLE_ITALIC,
                                  -1);
-      gtk_container_add (GTK_CONTAINER (dialog->compression_frame),
-                         label);
+      gtk_box_pack_end (GTK_BOX (dialog->compression_box), label,
+                        FALSE, FALSE, 0);
       gtk_widget_show (label);
       g_free (text);
     }
 
+  if (dialog->zstd_toggle)
+    {
+      dialog->zstd_compression = gimp_image_get_xcf_zstd_compression (image);
+      gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (dialog->zstd_toggle),
+                                    dialog->zstd_compression);
+    }
+
   compression_toggle = gtk_frame_get_label_widget (GTK_FRAME (dialog->compression_frame));
   gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (compression_toggle),
                                 gimp_image_get_xcf_compression (image));
@@ -335,6 +351,33 @@ gimp_save_dialog_add_extra_widgets (GimpSaveDialog *dialog)
                                      FALSE, FALSE, 0);
   gtk_widget_show (dialog->compression_frame);
 
+  dialog->compression_box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 2);
+  gtk_container_add (GTK_CONTAINER (dialog->compression_frame),
+                     dialog->compression_box);
+  gtk_widget_show (dialog->compression_box);
+
+#ifdef HAVE_ZSTD
+  /* zstd is a separate choice, since it needs a newer GIMP to load. */
+  dialog->zstd_toggle =
+    gtk_check_button_new_with_mnemonic (_("Use _zstd for faster saving and "
+                                          "loading"));
+  gtk_widget_set_tooltip_text (dialog->zstd_toggle,
+                               _("zstd-compressed files are about as small "
+                                 "as zlib-compressed ones, but much faster "
+                                 "to save and load"));
+  gtk_box_pack_start (GTK_BOX (dialog->compression_box), dialog->zstd_toggle,
+                      FALSE, FALSE, 0);
+  gtk_widget_show (dialog->zstd_toggle);
+
+  g_object_bind_property (compression_toggle,  "active",
+                          dialog->zstd_toggle, "sensitive",
+                          G_BINDING_SYNC_CREATE);
+
+  g_signal_connect (dialog->zstd_toggle, "toggled",
+                    G_CALLBACK (gimp_save_dialog_zstd_toggled),
+                    dialog);
+#endif
+
   /* Additional information explaining file compatibility things */
   dialog->compat_info = gtk_expander_new (NULL);
   label = gtk_label_new ("");
@@ -361,6 +404,29 @@ gimp_save_dialog_add_extra_widgets (GimpSaveDialog *dialog)
 static void
 gimp_save_dialog_compression_toggled (GtkToggleButton *button,
                                       GimpSaveDialog  *dialog)
+{
+  if (! GIMP_FILE_DIALOG (dialog)->image)
+    return;
+
+  dialog->compression = gtk_toggle_button_get_active (button);
+
+  gimp_save_dialog_update_compat_info (dialog);
+}
+
+static void
+gimp_save_dialog_zstd_toggled (GtkToggleButton *button,
+                               GimpSaveDialog  *dialog)
+{
+  if (! GIMP_FILE_DIALOG (dialog)->image)
+    return;
+
+  dialog->zstd_compression = gtk_toggle_button_get_active (button);
+
+  gimp_save_dialog_update_compat_info (dialog);
+}
+
+static void
+gimp_save_dialog_update_compat_info (GimpSaveDialog *dialog)
 {
   const gchar    *version_string = NULL;
   GimpFileDialog *file_dialog    = GIMP_FILE_DIALOG (dialog);
@@ -370,17 +436,10 @@ gimp_save_dialog_compression_toggled (GtkToggleButton *button,
   GtkTextBuffer  *text_buffer;
   gint            version;
 
-  if (! file_dialog->image)
-    return;
-
-  dialog->compression = gtk_toggle_button_get_active (button);
-
-  if (dialog->compression)
-    gimp_image_get_xcf_version (file_dialog->image, TRUE,  &version,
-                                &version_string, &reason);
-  else
-    gimp_image_get_xcf_version (file_dialog->image, FALSE, &version,
-                                &version_string, &reason);
+  gimp_image_get_xcf_version (file_dialog->image,
+                              dialog->compression && ! dialog->zstd_compression,
+                              dialog->compression && dialog->zstd_compression,
+                              &version, &version_string, &reason);
 
   /* Only show compatibility information for GIMP over 2.6. The reason
    * is mostly that we don't have details to make a compatibility list
@@ -435,7 +494,8 @@ gimp_save_dialog_get_state (GimpSaveDialog *dialog)
   if (filter)
     state->filter_name = g_strdup (gtk_file_filter_get_name (filter));
 
-  state->compression = dialog->compression;
+  state->compression      = dialog->compression;
+  state->zstd_compression = dialog->zstd_compression;
 
   return state;
 }
@@ -466,7 +526,8 @@ gimp_save_dialog_set_state (GimpSaveDialog      *dialog,
       g_slist_free (filters);
     }
 
-  dialog->compression = state->compression;
+  dialog->compression      = state->compression;
+  dialog->zstd_compression = state->zstd_compression;
 }
 
 static void
@@ -44,8 +44,11 @@ struct _GimpSaveDialog
   GimpObject          *display_to_close;
 
   GtkWidget           *compression_frame;
+  GtkWidget           *compression_box;
+  GtkWidget           *zstd_toggle;
   GtkWidget           *compat_info;
   gboolean             compression;
+  gboolean             zstd_compression;
 };
 
 struct _GimpSaveDialogClass
@@ -569,18 +569,24 @@ gimp_thumb_box_create_thumbnails (GimpThumbBox *box,
 
   if (n_files > 1)
     {
-      gchar *str;
-
       gimp_progress_start (GIMP_PROGRESS (box), TRUE, "%s", "");
 
       progress = gimp_sub_progress_new (GIMP_PROGRESS (box));
 
       gimp_sub_progress_set_step (GIMP_SUB_PROGRESS (progress), 0, n_files);
+    }
 
-      for (list = box->files->next, i = 1;
-           list;
-           list = g_slist_next (list), i++)
+  /*  the file shown in the box comes first, so its preview doesn't wait
+   *  for all the other selected files
+   */
+  for (list = box->files, i = 1;
+       list;
+       list = g_slist_next (list), i++)
+    {
+      if (n_files > 1)
         {
+          gchar *str;
+
           str = g_strdup_printf (_("Thumbnail %d of %d"), i, n_files);
           gtk_progress_bar_set_text (GTK_PROGRESS_BAR (box->progress), str);
           g_free (str);
@@ -589,44 +595,38 @@ gimp_thumb_box_create_thumbnails (GimpThumbBox *box,
 
           while (g_main_context_pending (NULL))
             g_main_context_iteration (NULL, FALSE);
-
-          gimp_thumb_box_create_thumbnail (box,
-                                           list->data,
-                                           gimp->config->thumbnail_size,
-                                           force,
-                                           progress);
-
-          if (dialog && dialog->canceled)
-            goto canceled;
-
-          gimp_sub_progress_set_step (GIMP_SUB_PROGRESS (progress), i, n_files);
         }
 
-      str = g_strdup_printf (_("Thumbnail %d of %d"), n_files, n_files);
-      gtk_progress_bar_set_text (GTK_PROGRESS_BAR (box->progress), str);
-      g_free (str);
-
-      gimp_progress_set_value (progress, 0.0);
-
-      while (g_main_context_pending (NULL))
-        g_main_context_iteration (NULL, FALSE);
-    }
-
-  if (box->files)
-    {
       gimp_thumb_box_create_thumbnail (box,
-                                       box->files->data,
+                                       list->data,
                                        gimp->config->thumbnail_size,
                                        force,
                                        progress);
 
-      gimp_progress_set_value (progress, 1.0);
-    }
+      if (n_files > 1)
+        {
+          gimp_sub_progress_set_step (GIMP_SUB_PROGRESS (progress), i, n_files);
 
- canceled:
+          if (dialog && dialog->canceled)
+            break;
+        }
+      else
+        {
+          gimp_progress_set_value (progress, 1.0);
+        }
+    }
 
   if (n_files > 1)
     {
+      gchar *basename;
+
+      /*  show the first file again  */
+      basename = g_path_get_basename (gimp_file_get_utf8_name (box->files->data));
+      gtk_label_set_text (GTK_LABEL (box->filename), basename);
+      g_free (basename);
+
+      gimp_imagefile_set_file (box->imagefile, box->files->data);
+
       g_object_unref (progress);
 
       gimp_progress_end (GIMP_PROGRESS (box));
@@ -173,8 +173,8 @@ gimp_view_renderer_brush_render_timeout (gpointer data)
   if (renderbrush->pipe_animation_index >= brush_pipe->n_brushes)
     renderbrush->pipe_animation_index = 0;
 
-  brush =
-    GIMP_BRUSH (brush_pipe->brushes[renderbrush->pipe_animation_index]);
+  brush = gimp_brush_pipe_get_brush (brush_pipe,
+                                     renderbrush->pipe_animation_index);
 
   temp_buf = gimp_viewable_get_new_preview (GIMP_VIEWABLE (brush),
                                             renderer->context,
@@ -48,6 +48,7 @@ struct _GimpViewRendererDrawablePrivate
   gint       render_buf_x;
   gint       render_buf_y;
   gboolean   render_update;
+  gboolean   render_pending;
 
   gint       prev_width;
   gint       prev_height;
@@ -109,7 +110,13 @@ gimp_view_renderer_drawable_invalidate (GimpViewRenderer *renderer)
 {
   GimpViewRendererDrawable *renderdrawable = GIMP_VIEW_RENDERER_DRAWABLE (renderer);
 
-  gimp_view_renderer_drawable_cancel_render (renderdrawable);
+  /* let an ongoing render finish, and render again once it did, instead of
+   * restarting it on every change.  a canceled render can't be interrupted
+   * once it started, so restarting it would only pile up renders of the
+   * same drawable while it keeps changing.
+   */
+  if (renderdrawable->priv->render_async)
+    renderdrawable->priv->render_pending = TRUE;
 
   GIMP_VIEW_RENDERER_CLASS (parent_class)->invalidate (renderer);
 }
@@ -131,7 +138,14 @@ gimp_view_renderer_drawable_render_async_callback (GimpAsync                *asy
   renderdrawable->priv->render_async  = NULL;
   renderdrawable->priv->render_widget = NULL;
 
-  if (gimp_async_is_finished (async))
+  if (renderdrawable->priv->render_pending)
+    {
+      /* the result is already outdated, render again  */
+      renderdrawable->priv->render_pending = FALSE;
+
+      gimp_view_renderer_invalidate (GIMP_VIEW_RENDERER (renderdrawable));
+    }
+  else if (gimp_async_is_finished (async))
     {
       GimpViewRenderer *renderer   = GIMP_VIEW_RENDERER (renderdrawable);
       GimpTempBuf      *render_buf = gimp_async_get_result (async);
@@ -362,5 +376,7 @@ gimp_view_renderer_drawable_cancel_render (GimpViewRendererDrawable *renderdrawa
       renderdrawable->priv->render_async = NULL;
     }
 
+  renderdrawable->priv->render_pending = FALSE;
+
   g_clear_object (&renderdrawable->priv->render_widget);
 }
@@ -27,19 +27,42 @@
 
 #include "widgets-types.h"
 
+#include "core/gimpasync.h"
+#include "core/gimpcancelable.h"
 #include "core/gimpimage.h"
+#include "core/gimpimage-preview.h"
 #include "core/gimpimageproxy.h"
 #include "core/gimptempbuf.h"
 
 #include "gimpviewrendererimage.h"
 
 
-static void   gimp_view_renderer_image_render (GimpViewRenderer *renderer,
-                                               GtkWidget        *widget);
+struct _GimpViewRendererImagePrivate
+{
+  GimpAsync *render_async;
+  GtkWidget *render_widget;
+  gint       render_buf_x;
+  gint       render_buf_y;
+  gint       render_component_index;
+  gboolean   render_update;
+  gboolean   render_pending;
+
+  gint       prev_width;
+  gint       prev_height;
+};
+
+
+static void   gimp_view_renderer_image_dispose        (GObject               *object);
+
+static void   gimp_view_renderer_image_invalidate     (GimpViewRenderer      *renderer);
+static void   gimp_view_renderer_image_render         (GimpViewRenderer      *renderer,
+                                                       GtkWidget             *widget);
 
+static void   gimp_view_renderer_image_cancel_render  (GimpViewRendererImage *rendererimage);
 
-G_DEFINE_TYPE (GimpViewRendererImage, gimp_view_renderer_image,
-               GIMP_TYPE_VIEW_RENDERER)
+
+G_DEFINE_TYPE_WITH_PRIVATE (GimpViewRendererImage, gimp_view_renderer_image,
+                            GIMP_TYPE_VIEW_RENDERER)
 
 #define parent_class gimp_view_renderer_image_parent_class
 
@@ -47,17 +70,166 @@ G_DEFINE_TYPE (GimpViewRendererImage, gimp_view_renderer_image,
 static void
 gimp_view_renderer_image_class_init (GimpViewRendererImageClass *klass)
 {
+  GObjectClass          *object_class   = G_OBJECT_CLASS (klass);
   GimpViewRendererClass *renderer_class = GIMP_VIEW_RENDERER_CLASS (klass);
 
-  renderer_class->render = gimp_view_renderer_image_render;
+  object_class->dispose      = gimp_view_renderer_image_dispose;
+
+  renderer_class->invalidate = gimp_view_renderer_image_invalidate;
+  renderer_class->render     = gimp_view_renderer_image_render;
 }
 
 static void
 gimp_view_renderer_image_init (GimpViewRendererImage *renderer)
 {
+  renderer->priv = gimp_view_renderer_image_get_instance_private (renderer);
+
   renderer->channel = -1;
 }
 
+static void
+gimp_view_renderer_image_dispose (GObject *object)
+{
+  GimpViewRendererImage *rendererimage = GIMP_VIEW_RENDERER_IMAGE (object);
+
+  gimp_view_renderer_image_cancel_render (rendererimage);
+
+  G_OBJECT_CLASS (parent_class)->dispose (object);
+}
+
+static void
+gimp_view_renderer_image_invalidate (GimpViewRenderer *renderer)
+{
+  GimpViewRendererImage *rendererimage = GIMP_VIEW_RENDERER_IMAGE (renderer);
+
+  /* let an ongoing render finish, and render again once it did, like
+   * GimpViewRendererDrawable does, so that an image which keeps changing
+   * still gets its preview updated.
+   */
+  if (rendererimage->priv->render_async)
+    rendererimage->priv->render_pending = TRUE;
+
+  GIMP_VIEW_RENDERER_CLASS (parent_class)->invalidate (renderer);
+}
+
+static void
+gimp_view_renderer_image_render_async_callback (GimpAsync             *async,
+                                                GimpViewRendererImage *rendererimage)
+{
+  GtkWidget *widget;
+
+  /* rendering was canceled, and the view renderer is potentially dead (see
+   * gimp_view_renderer_image_cancel_render()).  bail.
+   */
+  if (gimp_async_is_canceled (async))
+    return;
+
+  widget = rendererimage->priv->render_widget;
+
+  rendererimage->priv->render_async  = NULL;
+  rendererimage->priv->render_widget = NULL;
+
+  if (rendererimage->priv->render_pending)
+    {
+      /* the result is already outdated, render again  */
+      rendererimage->priv->render_pending = FALSE;
+
+      gimp_view_renderer_invalidate (GIMP_VIEW_RENDERER (rendererimage));
+    }
+  else if (gimp_async_is_finished (async))
+    {
+      GimpViewRenderer *renderer   = GIMP_VIEW_RENDERER (rendererimage);
+      GimpTempBuf      *render_buf = gimp_async_get_result (async);
+
+      gimp_view_renderer_render_temp_buf (
+        renderer,
+        widget,
+        render_buf,
+        rendererimage->priv->render_buf_x,
+        rendererimage->priv->render_buf_y,
+        rendererimage->priv->render_component_index,
+        GIMP_VIEW_BG_CHECKS,
+        GIMP_VIEW_BG_WHITE);
+
+      if (rendererimage->priv->render_update)
+        gimp_view_renderer_update (renderer);
+    }
+
+  g_object_unref (widget);
+}
+
+/*  renders the preview of an image from the idle, so that previews of
+ *  large images, such as the navigation view's, don't block the main loop
+ *  until the projection is fully rendered.  returns FALSE if the preview
+ *  isn't ready yet, and the renderer's previous contents don't fit.
+ */
+static gboolean
+gimp_view_renderer_image_render_async (GimpViewRendererImage *rendererimage,
+                                       GtkWidget             *widget,
+                                       GimpImage             *image,
+                                       gint                   view_width,
+                                       gint                   view_height,
+                                       gint                   render_buf_x,
+                                       gint                   render_buf_y,
+                                       gint                   component_index)
+{
+  GimpViewRenderer *renderer = GIMP_VIEW_RENDERER (rendererimage);
+  GimpAsync        *async;
+  gboolean          keep     = TRUE;
+
+  async = gimp_image_get_new_preview_async (image, view_width, view_height);
+
+  rendererimage->priv->render_async           = async;
+  rendererimage->priv->render_widget          = g_object_ref (widget);
+  rendererimage->priv->render_buf_x           = render_buf_x;
+  rendererimage->priv->render_buf_y           = render_buf_y;
+  rendererimage->priv->render_component_index = component_index;
+  rendererimage->priv->render_update          = FALSE;
+
+  gimp_async_add_callback_for_object (
+    async,
+    (GimpAsyncCallback) gimp_view_renderer_image_render_async_callback,
+    rendererimage,
+    rendererimage);
+
+  /* if rendering isn't done yet, update the render-view once it is, and
+   * keep the old image preview for now, unless the size changed.
+   */
+  if (rendererimage->priv->render_async)
+    {
+      rendererimage->priv->render_update = TRUE;
+
+      keep = (renderer->width  == rendererimage->priv->prev_width &&
+              renderer->height == rendererimage->priv->prev_height);
+    }
+
+  rendererimage->priv->prev_width  = renderer->width;
+  rendererimage->priv->prev_height = renderer->height;
+
+  g_object_unref (async);
+
+  return keep;
+}
+
+static void
+gimp_view_renderer_image_cancel_render (GimpViewRendererImage *rendererimage)
+{
+  /* cancel the async render operation (if one is ongoing) without waiting
+   * for it.  it runs in the idle, so it's aborted right away.
+   */
+  if (rendererimage->priv->render_async)
+    {
+      gimp_cancelable_cancel (
+        GIMP_CANCELABLE (rendererimage->priv->render_async));
+
+      rendererimage->priv->render_async = NULL;
+    }
+
+  rendererimage->priv->render_pending = FALSE;
+
+  g_clear_object (&rendererimage->priv->render_widget);
+}
+
 static void
 gimp_view_renderer_image_render (GimpViewRenderer *renderer,
                                  GtkWidget        *widget)
@@ -68,6 +240,10 @@ gimp_view_renderer_image_render (GimpViewRenderer *renderer,
   gint                   width;
   gint                   height;
 
+  /* render is already in progress */
+  if (rendererimage->priv->render_async)
+    return;
+
   if (GIMP_IS_IMAGE (renderer->viewable))
     {
       image = GIMP_IMAGE (renderer->viewable);
@@ -112,7 +288,32 @@ gimp_view_renderer_image_render (GimpViewRenderer *renderer,
                                        &view_height,
                                        &scaling_up);
 
-      if (scaling_up)
+      if (GIMP_IS_IMAGE (renderer->viewable) &&
+          ! scaling_up                         &&
+          view_width  <= renderer->width       &&
+          view_height <= renderer->height)
+        {
+          gint render_buf_x    = (renderer->width  - view_width)  / 2;
+          gint render_buf_y    = (renderer->height - view_height) / 2;
+          gint component_index = -1;
+
+          if (rendererimage->channel != -1)
+            component_index =
+              gimp_image_get_component_index (image, rendererimage->channel);
+
+          if (gimp_view_renderer_image_render_async (rendererimage, widget,
+                                                     image,
+                                                     view_width, view_height,
+                                                     render_buf_x,
+                                                     render_buf_y,
+                                                     component_index))
+            {
+              return;
+            }
+
+          /*  render the icon in the meantime  */
+        }
+      else if (scaling_up)
         {
           GimpTempBuf *temp_buf;
 
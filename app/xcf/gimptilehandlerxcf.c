@@ -0,0 +1,507 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include <cairo.h>
+#include <gio/gio.h>
+#include <gegl.h>
+
+#include "libgimpbase/gimpbase.h"
+
+#include "core/core-types.h"
+
+#include "core/gimp.h"
+
+#include "xcf-private.h"
+#include "xcf-source.h"
+#include "xcf-tile.h"
+
+#include "gimptilehandlerxcf.h"
+
+#include "gimp-intl.h"
+
+
+typedef struct
+{
+  Gimp  *gimp;
+  gchar *message;
+} XcfReportData;
+
+
+static void       gimp_tile_handler_xcf_finalize    (GObject                 *object);
+
+static void       gimp_tile_handler_xcf_validate    (GimpTileHandlerValidate *validate,
+                                                     const GeglRectangle     *rect,
+                                                     const Babl              *format,
+                                                     gpointer                 dest_buf,
+                                                     gint                     dest_stride);
+
+static gpointer   gimp_tile_handler_xcf_command     (GeglTileSource          *source,
+                                                     GeglTileCommand          command,
+                                                     gint                     x,
+                                                     gint                     y,
+                                                     gint                     z,
+                                                     gpointer                 data);
+
+static void       gimp_tile_handler_xcf_load_level  (GimpTileHandlerXcf      *xcf,
+                                                     gint                     x,
+                                                     gint                     y,
+                                                     gint                     z);
+static void       gimp_tile_handler_xcf_check_done  (GimpTileHandlerXcf      *xcf);
+
+static void       gimp_tile_handler_xcf_report      (GimpTileHandlerXcf      *xcf,
+                                                     gboolean                 modified);
+static gboolean   gimp_tile_handler_xcf_report_idle (XcfReportData           *data);
+
+
+G_DEFINE_TYPE (GimpTileHandlerXcf, gimp_tile_handler_xcf,
+               GIMP_TYPE_TILE_HANDLER_VALIDATE)
+
+#define parent_class gimp_tile_handler_xcf_parent_class
+
+
+static void
+gimp_tile_handler_xcf_class_init (GimpTileHandlerXcfClass *klass)
+{
+  GObjectClass                 *object_class   = G_OBJECT_CLASS (klass);
+  GimpTileHandlerValidateClass *validate_class;
+
+  validate_class = GIMP_TILE_HANDLER_VALIDATE_CLASS (klass);
+
+  object_class->finalize   = gimp_tile_handler_xcf_finalize;
+
+  validate_class->validate = gimp_tile_handler_xcf_validate;
+}
+
+static void
+gimp_tile_handler_xcf_init (GimpTileHandlerXcf *xcf)
+{
+  GeglTileSource *source = GEGL_TILE_SOURCE (xcf);
+
+  xcf->validate_command = source->command;
+  source->command       = gimp_tile_handler_xcf_command;
+}
+
+static void
+gimp_tile_handler_xcf_finalize (GObject *object)
+{
+  GimpTileHandlerXcf *xcf = GIMP_TILE_HANDLER_XCF (object);
+
+  g_clear_pointer (&xcf->source_file,  xcf_source_file_unref);
+  g_clear_pointer (&xcf->tile_offsets, g_free);
+  g_clear_pointer (&xcf->tile_lengths, g_free);
+
+  g_clear_object (&xcf->gimp);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gimp_tile_handler_xcf_validate (GimpTileHandlerValidate *validate,
+                                const GeglRectangle     *rect,
+                                const Babl              *format,
+                                gpointer                 dest_buf,
+                                gint                     dest_stride)
+{
+  GimpTileHandlerXcf *xcf = GIMP_TILE_HANDLER_XCF (validate);
+  const guint8       *contents;
+  gsize               length;
+  const Babl         *fish = NULL;
+  gint                src_bpp;
+  gint                dest_bpp;
+  guint8             *tile_data;
+  gint                col0, col1;
+  gint                row0, row1;
+  gint                row;
+  gint                col;
+
+  src_bpp  = babl_format_get_bytes_per_pixel (validate->format);
+  dest_bpp = babl_format_get_bytes_per_pixel (format);
+
+  /*  if the file was modified in place since it was mapped, its contents
+   *  can't be trusted, and reading past its new end would crash.
+   */
+  if (xcf->source_file                        &&
+      ! g_atomic_int_get (&xcf->invalid)      &&
+      ! xcf_source_file_is_valid (xcf->source_file))
+    {
+      g_atomic_int_set (&xcf->invalid, TRUE);
+
+      gimp_tile_handler_xcf_report (xcf, TRUE);
+    }
+
+  if (! xcf->source_file || g_atomic_int_get (&xcf->invalid))
+    {
+      for (row = 0; row < rect->height; row++)
+        {
+          memset ((guint8 *) dest_buf + row * dest_stride,
+                  0, rect->width * dest_bpp);
+        }
+
+      return;
+    }
+
+  contents = xcf_source_file_get_contents (xcf->source_file, &length);
+
+  if (format != validate->format)
+    fish = babl_fish (validate->format, format);
+
+  tile_data = g_alloca (XCF_TILE_WIDTH * XCF_TILE_HEIGHT * src_bpp);
+
+  col0 = rect->x / XCF_TILE_WIDTH;
+  col1 = (rect->x + rect->width  - 1) / XCF_TILE_WIDTH;
+  row0 = rect->y / XCF_TILE_HEIGHT;
+  row1 = (rect->y + rect->height - 1) / XCF_TILE_HEIGHT;
+
+  col1 = MIN (col1, xcf->n_tile_cols - 1);
+  row1 = MIN (row1, xcf->n_tile_rows - 1);
+
+  for (row = row0; row <= row1; row++)
+    {
+      for (col = col0; col <= col1; col++)
+        {
+          GeglRectangle tile_rect;
+          GeglRectangle area;
+          gint          i = row * xcf->n_tile_cols + col;
+          goffset       offset;
+          gsize         data_length;
+          gboolean      nonzero = FALSE;
+          gint          y;
+
+          tile_rect.x      = col * XCF_TILE_WIDTH;
+          tile_rect.y      = row * XCF_TILE_HEIGHT;
+          tile_rect.width  = MIN (XCF_TILE_WIDTH,  xcf->width  - tile_rect.x);
+          tile_rect.height = MIN (XCF_TILE_HEIGHT, xcf->height - tile_rect.y);
+
+          if (! gegl_rectangle_intersect (&area, &tile_rect, rect))
+            continue;
+
+          offset      = xcf->tile_offsets[i];
+          data_length = MIN (xcf->tile_lengths[i], length - offset);
+
+          if (! xcf_tile_decode (xcf->compression, xcf->file_version,
+                                 validate->format,
+                                 contents + offset, data_length,
+                                 tile_data,
+                                 tile_rect.width * tile_rect.height,
+                                 &nonzero))
+            {
+              gimp_tile_handler_xcf_report (xcf, FALSE);
+
+              nonzero = FALSE;
+            }
+
+          for (y = area.y; y < area.y + area.height; y++)
+            {
+              guint8 *dest = (guint8 *) dest_buf                   +
+                             (y      - rect->y) * dest_stride      +
+                             (area.x - rect->x) * dest_bpp;
+
+              if (nonzero)
+                {
+                  const guint8 *src = tile_data                             +
+                                      ((y      - tile_rect.y) * tile_rect.width +
+                                       (area.x - tile_rect.x)) * src_bpp;
+
+                  if (fish)
+                    babl_process (fish, src, dest, area.width);
+                  else
+                    memcpy (dest, src, area.width * src_bpp);
+                }
+              else
+                {
+                  memset (dest, 0, area.width * dest_bpp);
+                }
+            }
+        }
+    }
+}
+
+static gpointer
+gimp_tile_handler_xcf_command (GeglTileSource  *source,
+                               GeglTileCommand  command,
+                               gint             x,
+                               gint             y,
+                               gint             z,
+                               gpointer         data)
+{
+  GimpTileHandlerXcf      *xcf      = GIMP_TILE_HANDLER_XCF (source);
+  GimpTileHandlerValidate *validate = GIMP_TILE_HANDLER_VALIDATE (source);
+  gpointer                 result;
+
+  if (! cairo_region_is_empty (validate->dirty_region))
+    {
+      switch (command)
+        {
+        case GEGL_TILE_GET:
+          /*  mipmap levels are generated from the level-0 tiles below us,
+           *  bypassing the handler, so make sure the tiles they're
+           *  generated from are loaded first.
+           */
+          if (z > 0)
+            gimp_tile_handler_xcf_load_level (xcf, x, y, z);
+          break;
+
+        case GEGL_TILE_SET:
+        case GEGL_TILE_VOID:
+          /*  the tile's contents are being replaced, there's no need to
+           *  load it anymore.
+           */
+          if (z == 0)
+            {
+              cairo_rectangle_int_t tile_rect;
+
+              tile_rect.x      = x * validate->tile_width;
+              tile_rect.y      = y * validate->tile_height;
+              tile_rect.width  = validate->tile_width;
+              tile_rect.height = validate->tile_height;
+
+              cairo_region_subtract_rectangle (validate->dirty_region,
+                                               &tile_rect);
+            }
+          break;
+
+        default:
+          break;
+        }
+    }
+
+  result = xcf->validate_command (source, command, x, y, z, data);
+
+  gimp_tile_handler_xcf_check_done (xcf);
+
+  return result;
+}
+
+static void
+gimp_tile_handler_xcf_load_level (GimpTileHandlerXcf *xcf,
+                                  gint                x,
+                                  gint                y,
+                                  gint                z)
+{
+  GimpTileHandlerValidate *validate = GIMP_TILE_HANDLER_VALIDATE (xcf);
+  GeglTileSource          *source   = GEGL_TILE_SOURCE (xcf);
+  cairo_rectangle_int_t    level_rect;
+  cairo_rectangle_int_t    extents;
+  gint                     x1, x2;
+  gint                     y1, y2;
+  gint                     u, v;
+
+  if (z >= 16)
+    return;
+
+  level_rect.x      = (x << z) * validate->tile_width;
+  level_rect.y      = (y << z) * validate->tile_height;
+  level_rect.width  = (1 << z) * validate->tile_width;
+  level_rect.height = (1 << z) * validate->tile_height;
+
+  cairo_region_get_extents (validate->dirty_region, &extents);
+
+  if (! gegl_rectangle_intersect ((GeglRectangle *) &extents,
+                                  (GeglRectangle *) &extents,
+                                  (GeglRectangle *) &level_rect))
+    {
+      return;
+    }
+
+  x1 = extents.x / validate->tile_width;
+  y1 = extents.y / validate->tile_height;
+  x2 = (extents.x + extents.width  - 1) / validate->tile_width;
+  y2 = (extents.y + extents.height - 1) / validate->tile_height;
+
+  for (v = y1; v <= y2; v++)
+    {
+      for (u = x1; u <= x2; u++)
+        {
+          cairo_rectangle_int_t tile_rect;
+
+          tile_rect.x      = u * validate->tile_width;
+          tile_rect.y      = v * validate->tile_height;
+          tile_rect.width  = validate->tile_width;
+          tile_rect.height = validate->tile_height;
+
+          if (cairo_region_contains_rectangle (validate->dirty_region,
+                                               &tile_rect) !=
+              CAIRO_REGION_OVERLAP_OUT)
+            {
+              GeglTile *tile;
+
+              tile = xcf->validate_command (source, GEGL_TILE_GET, u, v, 0,
+                                            NULL);
+
+              if (tile)
+                gegl_tile_unref (tile);
+            }
+        }
+    }
+}
+
+static void
+gimp_tile_handler_xcf_check_done (GimpTileHandlerXcf *xcf)
+{
+  GimpTileHandlerValidate *validate = GIMP_TILE_HANDLER_VALIDATE (xcf);
+
+  if (xcf->source_file && cairo_region_is_empty (validate->dirty_region))
+    {
+      g_clear_pointer (&xcf->source_file,  xcf_source_file_unref);
+      g_clear_pointer (&xcf->tile_offsets, g_free);
+      g_clear_pointer (&xcf->tile_lengths, g_free);
+    }
+}
+
+/*  validation may happen on any thread, so the message is shown from the
+ *  main loop.  only the first problem of each file is reported, rather
+ *  than one per layer.
+ */
+static void
+gimp_tile_handler_xcf_report (GimpTileHandlerXcf *xcf,
+                              gboolean            modified)
+{
+  XcfReportData *data;
+  const gchar   *filename;
+
+  if (! xcf_source_file_begin_report (xcf->source_file))
+    return;
+
+  filename = gimp_file_get_utf8_name (
+    xcf_source_file_get_file (xcf->source_file));
+
+  data = g_slice_new (XcfReportData);
+
+  data->gimp = g_object_ref (xcf->gimp);
+
+  if (modified)
+    {
+      data->message =
+        g_strdup_printf (_("'%s' was modified by another program before "
+                           "all of its image data was read.  The parts "
+                           "that weren't read yet are left transparent."),
+                         filename);
+    }
+  else
+    {
+      data->message =
+        g_strdup_printf (_("Some of the image data of '%s' could not be "
+                           "decoded, the file may be corrupt.  The "
+                           "affected areas are left transparent."),
+                         filename);
+    }
+
+  g_idle_add ((GSourceFunc) gimp_tile_handler_xcf_report_idle, data);
+}
+
+static gboolean
+gimp_tile_handler_xcf_report_idle (XcfReportData *data)
+{
+  gimp_message_literal (data->gimp, NULL, GIMP_MESSAGE_WARNING,
+                        data->message);
+
+  g_object_unref (data->gimp);
+  g_free (data->message);
+
+  g_slice_free (XcfReportData, data);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+/*  public functions  */
+
+/* assigns a handler to buffer, which lazily loads the buffer's contents from
+ * source_file.  tile_offsets and tile_lengths specify the location of each
+ * of the level's XCF tiles, in row-major order; the offsets have already
+ * been validated against the size of the mapped file by the caller.
+ * problems are reported to the user through gimp.
+ */
+void
+gimp_tile_handler_xcf_assign (GeglBuffer         *buffer,
+                              Gimp               *gimp,
+                              XcfSourceFile      *source_file,
+                              XcfCompressionType  compression,
+                              gint                file_version,
+                              const goffset      *tile_offsets,
+                              const gsize        *tile_lengths)
+{
+  GimpTileHandlerXcf      *xcf;
+  GimpTileHandlerValidate *validate;
+  gint                     n_tiles;
+
+  g_return_if_fail (GEGL_IS_BUFFER (buffer));
+  g_return_if_fail (GIMP_IS_GIMP (gimp));
+  g_return_if_fail (source_file != NULL);
+  g_return_if_fail (tile_offsets != NULL);
+  g_return_if_fail (tile_lengths != NULL);
+
+  xcf      = g_object_new (GIMP_TYPE_TILE_HANDLER_XCF, NULL);
+  validate = GIMP_TILE_HANDLER_VALIDATE (xcf);
+
+  xcf->gimp         = g_object_ref (gimp);
+  xcf->source_file  = xcf_source_file_ref (source_file);
+  xcf->compression  = compression;
+  xcf->file_version = file_version;
+  xcf->width        = gegl_buffer_get_width  (buffer);
+  xcf->height       = gegl_buffer_get_height (buffer);
+  xcf->n_tile_cols  = (xcf->width  + XCF_TILE_WIDTH  - 1) / XCF_TILE_WIDTH;
+  xcf->n_tile_rows  = (xcf->height + XCF_TILE_HEIGHT - 1) / XCF_TILE_HEIGHT;
+
+  n_tiles = xcf->n_tile_cols * xcf->n_tile_rows;
+
+  xcf->tile_offsets = g_memdup2 (tile_offsets, n_tiles * sizeof (goffset));
+  xcf->tile_lengths = g_memdup2 (tile_lengths, n_tiles * sizeof (gsize));
+
+  gimp_tile_handler_validate_assign (validate, buffer);
+
+  g_object_unref (xcf);
+
+  gimp_tile_handler_validate_invalidate (validate,
+                                         gegl_buffer_get_extent (buffer));
+}
+
+/* loads all the tiles of buffer that weren't accessed yet, if they are
+ * lazily loaded from file, or from any file if file is NULL.  this must
+ * be done before file is written to, since it may be modified in place.
+ */
+void
+gimp_tile_handler_xcf_load (GeglBuffer *buffer,
+                            GFile      *file)
+{
+  GimpTileHandlerValidate *validate;
+  GimpTileHandlerXcf      *xcf;
+
+  g_return_if_fail (GEGL_IS_BUFFER (buffer));
+  g_return_if_fail (file == NULL || G_IS_FILE (file));
+
+  validate = gimp_tile_handler_validate_get_assigned (buffer);
+
+  if (! GIMP_IS_TILE_HANDLER_XCF (validate))
+    return;
+
+  xcf = GIMP_TILE_HANDLER_XCF (validate);
+
+  if (! xcf->source_file)
+    return;
+
+  if (file && ! xcf_source_file_is_file (xcf->source_file, file))
+    return;
+
+  gimp_tile_handler_validate_validate_parallel (validate, buffer, NULL, TRUE);
+
+  gimp_tile_handler_xcf_check_done (xcf);
+}
@@ -18,7 +18,6 @@
 #include "config.h"
 
 #include <string.h>
-#include <zlib.h>
 
 #include <cairo.h>
 #include <gegl.h>
@@ -35,6 +34,9 @@
 #include "gegl/gimp-gegl-tile-compat.h"
 
 #include "core/gimp.h"
+#include "core/gimp-parallel.h"
+#include "core/gimp-trace.h"
+#include "core/gimpasync.h"
 #include "core/gimpcontainer.h"
 #include "core/gimpdrawable-private.h" /* eek */
 #include "core/gimpgrid.h"
@@ -57,6 +59,7 @@
 #include "core/gimpselection.h"
 #include "core/gimpsymmetry.h"
 #include "core/gimptemplate.h"
+#include "core/gimpwaitable.h"
 
 #include "operations/layer-modes/gimp-layer-modes.h"
 
@@ -73,7 +76,10 @@
 #include "xcf-load.h"
 #include "xcf-read.h"
 #include "xcf-seek.h"
-#include "xcf-utils.h"
+#include "xcf-source.h"
+#include "xcf-tile.h"
+
+#include "gimptilehandlerxcf.h"
 
 #include "gimp-log.h"
 #include "gimp-intl.h"
@@ -81,9 +87,29 @@
 
 #define MAX_XCF_PARASITE_DATA_LEN (256L * 1024 * 1024)
 
+/* the maximal amount of compressed tile data xcf_load_level() reads in at
+ * once, while the previously read tiles are being decoded
+ */
+#define XCF_LOAD_BATCH_SIZE (16 * 1024 * 1024)
+
 /* #define GIMP_XCF_PATH_DEBUG */
 
 
+typedef struct
+{
+  GeglBuffer         *buffer;
+  const Babl         *format;
+  XcfCompressionType  compression;
+  gint                file_version;
+  gsize               max_data_length;
+  gint                first_tile;
+  gint                n_tiles;
+  guint8             *tile_data;
+  gsize              *tile_data_lengths;
+  gint                failed;
+} XcfLoadTilesData;
+
+
 static void            xcf_load_add_masks     (GimpImage     *image);
 static gboolean        xcf_load_image_props   (XcfInfo       *info,
                                                GimpImage     *image);
@@ -117,20 +143,22 @@ static gboolean        xcf_load_buffer        (XcfInfo       *info,
                                                GeglBuffer    *buffer);
 static gboolean        xcf_load_level         (XcfInfo       *info,
                                                GeglBuffer    *buffer);
-static gboolean        xcf_load_tile          (XcfInfo       *info,
-                                               GeglBuffer    *buffer,
-                                               GeglRectangle *tile_rect,
-                                               const Babl    *format);
-static gboolean        xcf_load_tile_rle      (XcfInfo       *info,
+static gboolean        xcf_load_level_offsets (XcfInfo       *info,
+                                               goffset        offset,
+                                               goffset        max_data_length,
+                                               gint           n_tiles,
+                                               goffset       *tile_offsets,
+                                               gsize         *tile_lengths);
+static void            xcf_load_level_mapped  (XcfInfo       *info,
                                                GeglBuffer    *buffer,
-                                               GeglRectangle *tile_rect,
-                                               const Babl    *format,
-                                               gint           data_length);
-static gboolean        xcf_load_tile_zlib     (XcfInfo       *info,
-                                               GeglBuffer    *buffer,
-                                               GeglRectangle *tile_rect,
-                                               const Babl    *format,
-                                               gint           data_length);
+                                               gint           n_tiles,
+                                               goffset       *tile_offsets,
+                                               gsize         *tile_lengths);
+static void            xcf_load_tiles_async   (GimpAsync     *async,
+                                               XcfLoadTilesData *data);
+static void            xcf_load_tiles_func    (gint           i,
+                                               gint           n,
+                                               XcfLoadTilesData *data);
 static GimpParasite  * xcf_load_parasite      (XcfInfo       *info);
 static gboolean        xcf_load_old_paths     (XcfInfo       *info,
                                                GimpImage     *image);
@@ -858,7 +886,8 @@ xcf_load_image_props (XcfInfo   *info,
             if ((compression != COMPRESS_NONE) &&
                 (compression != COMPRESS_RLE) &&
                 (compression != COMPRESS_ZLIB) &&
-                (compression != COMPRESS_FRACTAL))
+                (compression != COMPRESS_FRACTAL) &&
+                (compression != COMPRESS_ZSTD))
               {
                 gimp_message (info->gimp, G_OBJECT (info->progress),
                               GIMP_MESSAGE_ERROR,
@@ -871,6 +900,8 @@ xcf_load_image_props (XcfInfo   *info,
 
             gimp_image_set_xcf_compression (image,
                                             compression >= COMPRESS_ZLIB);
+            gimp_image_set_xcf_zstd_compression (image,
+                                                 compression == COMPRESS_ZSTD);
 
             GIMP_LOG (XCF, "prop compression=%d", compression);
           }
@@ -2304,19 +2335,24 @@ static gboolean
 xcf_load_level (XcfInfo    *info,
                 GeglBuffer *buffer)
 {
-  const Babl *format;
-  gint        bpp;
-  goffset     saved_pos;
-  goffset     offset;
-  goffset     offset2;
-  goffset     max_data_length;
-  gint        n_tile_rows;
-  gint        n_tile_cols;
-  guint       ntiles;
-  gint        width;
-  gint        height;
-  gint        i;
-  gint        fail;
+  XcfLoadTilesData  data[2] = { { NULL, }, { NULL, } };
+  GimpAsync        *async   = NULL;
+  const Babl       *format;
+  goffset          *tile_offsets;
+  gsize            *tile_lengths;
+  goffset           saved_pos;
+  goffset           offset;
+  goffset           max_data_length;
+  gint              bpp;
+  gint              n_tile_rows;
+  gint              n_tile_cols;
+  guint             ntiles;
+  gint              width;
+  gint              height;
+  gint              batch_size;
+  gint              first_tile;
+  gint              i;
+  gboolean          success = FALSE;
 
   format = gegl_buffer_get_format (buffer);
   bpp    = babl_format_get_bytes_per_pixel (format);
@@ -2328,6 +2364,25 @@ xcf_load_level (XcfInfo    *info,
       height != gegl_buffer_get_height (buffer))
     return FALSE;
 
+  switch (info->compression)
+    {
+    case COMPRESS_NONE:
+    case COMPRESS_RLE:
+    case COMPRESS_ZLIB:
+    case COMPRESS_ZSTD:
+      break;
+
+    case COMPRESS_FRACTAL:
+      g_printerr ("xcf: fractal compression unimplemented. "
+                  "Possibly corrupt XCF file.");
+      return FALSE;
+
+    default:
+      g_printerr ("xcf: unknown compression. "
+                  "Possibly corrupt XCF file.");
+      return FALSE;
+    }
+
   /* maximal allowable size of on-disk tile data.  make it somewhat bigger than
    * the uncompressed tile size, to allow for the possibility of negative
    * compression.
@@ -2347,392 +2402,313 @@ xcf_load_level (XcfInfo    *info,
   n_tile_cols = gimp_gegl_buffer_get_n_tile_cols (buffer, XCF_TILE_WIDTH);
 
   ntiles = n_tile_rows * n_tile_cols;
-  for (i = 0; i < ntiles; i++)
+
+  tile_offsets = g_new (goffset, ntiles);
+  tile_lengths = g_new (gsize,   ntiles);
+
+  if (! xcf_load_level_offsets (info, offset, max_data_length, ntiles,
+                                tile_offsets, tile_lengths))
     {
-      GeglRectangle rect;
+      goto out;
+    }
 
-      fail = FALSE;
+  /* if the file is memory-mapped, let the buffer decode its tiles when
+   * they're first accessed.
+   */
+  if (info->source_file)
+    {
+      xcf_load_level_mapped (info, buffer, ntiles, tile_offsets, tile_lengths);
 
-      if (offset == 0)
-        {
-          gimp_message_literal (info->gimp, G_OBJECT (info->progress),
-                                GIMP_MESSAGE_ERROR,
-                                "not enough tiles found in level");
-          return FALSE;
-        }
+      success = TRUE;
+      goto out;
+    }
 
-      /* save the current position as it is where the
-       *  next tile offset is stored.
-       */
-      saved_pos = info->cp;
+  /* 'saved_pos' is the end of the offset table */
+  saved_pos = info->cp;
 
-      /* read in the offset of the next tile so we can calculate the amount
-       * of data needed for this tile
-       */
-      xcf_read_offset (info, &offset2, 1);
+  batch_size = MAX (XCF_LOAD_BATCH_SIZE / max_data_length, 1);
+  batch_size = MIN (batch_size, ntiles);
 
-      /* if the offset is 0 then we need to read in the maximum possible
-       * allowing for negative compression
-       */
-      if (offset2 == 0)
-        offset2 = offset + max_data_length;
+  for (i = 0; i < G_N_ELEMENTS (data); i++)
+    {
+      data[i].buffer            = buffer;
+      data[i].format            = format;
+      data[i].compression       = info->compression;
+      data[i].file_version      = info->file_version;
+      data[i].max_data_length   = max_data_length;
+      data[i].tile_data         = g_malloc (batch_size * max_data_length);
+      data[i].tile_data_lengths = g_new (gsize, batch_size);
+    }
 
-      /* seek to the tile offset */
-      if (! xcf_seek_pos (info, offset, NULL))
-        return FALSE;
+  /* the tiles are read in batches, in order.  each batch is decoded, and
+   * written to the buffer, in parallel, while the next batch is being read.
+   */
+  for (first_tile = 0, i = 0; first_tile < ntiles; i = ! i)
+    {
+      XcfLoadTilesData *batch = &data[i];
+      gint              j;
 
-      if (offset2 < offset || offset2 - offset > max_data_length)
+      batch->first_tile = first_tile;
+      batch->n_tiles    = MIN (batch_size, ntiles - first_tile);
+      batch->failed     = FALSE;
+
+      for (j = 0; j < batch->n_tiles; j++)
         {
-          gimp_message (info->gimp, G_OBJECT (info->progress),
-                        GIMP_MESSAGE_ERROR,
-                        "invalid tile data length: %" G_GOFFSET_FORMAT,
-                        offset2 - offset);
-          return FALSE;
+          if (! xcf_seek_pos (info, tile_offsets[first_tile + j], NULL))
+            goto out;
+
+          /* we have to read directly instead of xcf_read_* because we may be
+           * reading past the end of the file here
+           */
+          g_input_stream_read_all (info->input,
+                                   batch->tile_data + j * max_data_length,
+                                   tile_lengths[first_tile + j],
+                                   &batch->tile_data_lengths[j], NULL, NULL);
+          info->cp += batch->tile_data_lengths[j];
         }
 
-      /* get buffer rectangle to write to */
-      gimp_gegl_buffer_get_tile_rect (buffer,
-                                      XCF_TILE_WIDTH, XCF_TILE_HEIGHT,
-                                      i, &rect);
+      GIMP_LOG (XCF, "read tiles %d-%d/%d",
+                first_tile + 1, first_tile + batch->n_tiles, ntiles);
 
-      GIMP_LOG (XCF, "loading tile %d/%d", i + 1, ntiles);
+      first_tile += batch->n_tiles;
 
-      /* read in the tile */
-      switch (info->compression)
+      /* wait for the previous batch, which uses the other buffer */
+      if (async)
         {
-        case COMPRESS_NONE:
-          if (! xcf_load_tile (info, buffer, &rect, format))
-            fail = TRUE;
-          break;
-        case COMPRESS_RLE:
-          if (! xcf_load_tile_rle (info, buffer, &rect, format,
-                                   offset2 - offset))
-            fail = TRUE;
-          break;
-        case COMPRESS_ZLIB:
-          if (! xcf_load_tile_zlib (info, buffer, &rect, format,
-                                    offset2 - offset))
-            fail = TRUE;
-          break;
-        case COMPRESS_FRACTAL:
-          g_printerr ("xcf: fractal compression unimplemented. "
-                      "Possibly corrupt XCF file.");
-          fail = TRUE;
-          break;
-        default:
-          g_printerr ("xcf: unknown compression. "
-                      "Possibly corrupt XCF file.");
-          fail = TRUE;
-          break;
+          gimp_waitable_wait (GIMP_WAITABLE (async));
+          g_clear_object (&async);
+
+          if (data[! i].failed)
+            goto out;
         }
 
-      if (fail)
-        return FALSE;
+      async = gimp_parallel_run_async_full (
+        0,
+        (GimpRunAsyncFunc) xcf_load_tiles_async,
+        batch,
+        NULL);
+    }
 
-      GIMP_LOG (XCF, "loaded tile %d/%d", i + 1, ntiles);
+  gimp_waitable_wait (GIMP_WAITABLE (async));
+  g_clear_object (&async);
 
-      /* restore the saved position so we'll be ready to
-       *  read the next offset.
-       */
-      if (!xcf_seek_pos (info, saved_pos, NULL))
-        return FALSE;
+  if (data[! i].failed)
+    goto out;
 
-      /* read in the offset of the next tile */
-      xcf_read_offset (info, &offset, 1);
-    }
+  GIMP_LOG (XCF, "loaded %d tiles", ntiles);
 
-  if (offset != 0)
-    {
-      gimp_message (info->gimp, G_OBJECT (info->progress), GIMP_MESSAGE_ERROR,
-                    "encountered garbage after reading level: %" G_GOFFSET_FORMAT,
-                    offset);
-      return FALSE;
-    }
+  /* restore the saved position, at the end of the offset table */
+  if (! xcf_seek_pos (info, saved_pos, NULL))
+    goto out;
 
-  return TRUE;
-}
-
-static gboolean
-xcf_load_tile (XcfInfo       *info,
-               GeglBuffer    *buffer,
-               GeglRectangle *tile_rect,
-               const Babl    *format)
-{
-  gint    bpp       = babl_format_get_bytes_per_pixel (format);
-  gint    tile_size = bpp * tile_rect->width * tile_rect->height;
-  guchar *tile_data = g_alloca (tile_size);
+  success = TRUE;
 
-  if (info->file_version <= 11)
+ out:
+  if (async)
     {
-      xcf_read_int8 (info, tile_data, tile_size);
+      gimp_waitable_wait (GIMP_WAITABLE (async));
+      g_object_unref (async);
     }
-  else
-    {
-      gint n_components = babl_format_get_n_components (format);
 
-      xcf_read_component (info, bpp / n_components, tile_data,
-                          tile_size / bpp * n_components);
-    }
-
-  if (! xcf_data_is_zero (tile_data, tile_size))
+  for (i = 0; i < G_N_ELEMENTS (data); i++)
     {
-      gegl_buffer_set (buffer, tile_rect, 0, format, tile_data,
-                       GEGL_AUTO_ROWSTRIDE);
+      g_free (data[i].tile_data);
+      g_free (data[i].tile_data_lengths);
     }
 
-  return TRUE;
+  g_free (tile_offsets);
+  g_free (tile_lengths);
+
+  return success;
 }
 
 static gboolean
-xcf_load_tile_rle (XcfInfo       *info,
-                   GeglBuffer    *buffer,
-                   GeglRectangle *tile_rect,
-                   const Babl    *format,
-                   gint           data_length)
+xcf_load_level_offsets (XcfInfo *info,
+                        goffset  offset,
+                        goffset  max_data_length,
+                        gint     n_tiles,
+                        goffset *tile_offsets,
+                        gsize   *tile_lengths)
 {
-  gint    bpp       = babl_format_get_bytes_per_pixel (format);
-  gint    tile_size = bpp * tile_rect->width * tile_rect->height;
-  guchar *tile_data = g_alloca (tile_size);
-  guchar  nonzero   = FALSE;
-  gsize   bytes_read;
-  gint    i;
-  guchar *xcfdata;
-  guchar *xcfodata;
-  guchar *xcfdatalimit;
-
-  /* Workaround for bug #357809: avoid crashing on g_malloc() and skip
-   * this tile (return TRUE without storing data) as if it did not
-   * contain any data.  It is better than returning FALSE, which would
-   * skip the whole hierarchy while there may still be some valid
-   * tiles in the file.
-   */
-  if (data_length <= 0)
-    return TRUE;
-
-  xcfdata = xcfodata = g_alloca (data_length);
-
-  /* we have to read directly instead of xcf_read_* because we may be
-   * reading past the end of the file here
-   */
-  g_input_stream_read_all (info->input, xcfdata, data_length,
-                           &bytes_read, NULL, NULL);
-  info->cp += bytes_read;
-
-  if (bytes_read == 0)
-    return TRUE;
-
-  xcfdatalimit = &xcfodata[bytes_read - 1];
+  gint i;
 
-  for (i = 0; i < bpp; i++)
+  for (i = 0; i < n_tiles; i++)
     {
-      guchar *data  = tile_data + i;
-      gint    size  = tile_rect->width * tile_rect->height;
-      gint    count = 0;
-      guchar  val;
-      gint    length;
-      gint    j;
-
-      while (size > 0)
-        {
-          if (xcfdata > xcfdatalimit)
-            {
-              goto bogus_rle;
-            }
-
-          val = *xcfdata++;
-
-          length = val;
-          if (length >= 128)
-            {
-              length = 255 - (length - 1);
-              if (length == 128)
-                {
-                  if (xcfdata >= xcfdatalimit)
-                    {
-                      goto bogus_rle;
-                    }
-
-                  length = (*xcfdata << 8) + xcfdata[1];
-                  xcfdata += 2;
-                }
-
-              count += length;
-              size -= length;
-
-              if (size < 0)
-                {
-                  goto bogus_rle;
-                }
+      goffset next_offset;
+      goffset offset2;
 
-              if (&xcfdata[length-1] > xcfdatalimit)
-                {
-                  goto bogus_rle;
-                }
-
-              while (length-- > 0)
-                {
-                  *data = *xcfdata++;
-                  nonzero |= *data;
-                  data += bpp;
-                }
-            }
-          else
-            {
-              length += 1;
-              if (length == 128)
-                {
-                  if (xcfdata >= xcfdatalimit)
-                    {
-                      goto bogus_rle;
-                    }
-
-                  length = (*xcfdata << 8) + xcfdata[1];
-                  xcfdata += 2;
-                }
+      if (offset == 0)
+        {
+          gimp_message_literal (info->gimp, G_OBJECT (info->progress),
+                                GIMP_MESSAGE_ERROR,
+                                "not enough tiles found in level");
+          return FALSE;
+        }
 
-              count += length;
-              size -= length;
+      /* read in the offset of the next tile so we can calculate the amount
+       * of data needed for this tile
+       */
+      xcf_read_offset (info, &next_offset, 1);
 
-              if (size < 0)
-                {
-                  goto bogus_rle;
-                }
+      /* if the offset is 0 then we need to read in the maximum possible
+       * allowing for negative compression
+       */
+      offset2 = next_offset ? next_offset : offset + max_data_length;
 
-              if (xcfdata > xcfdatalimit)
-                {
-                  goto bogus_rle;
-                }
+      if (offset2 < offset || offset2 - offset > max_data_length)
+        {
+          gimp_message (info->gimp, G_OBJECT (info->progress),
+                        GIMP_MESSAGE_ERROR,
+                        "invalid tile data length: %" G_GOFFSET_FORMAT,
+                        offset2 - offset);
+          return FALSE;
+        }
 
-              val = *xcfdata++;
-              nonzero |= val;
+      tile_offsets[i] = offset;
+      tile_lengths[i] = offset2 - offset;
 
-              for (j = 0; j < length; j++)
-                {
-                  *data = val;
-                  data += bpp;
-                }
-            }
-        }
+      offset = next_offset;
     }
 
-  if (nonzero)
+  if (offset != 0)
     {
-      if (info->file_version >= 12)
-        {
-          gint n_components = babl_format_get_n_components (format);
-
-          xcf_read_from_be (bpp / n_components, tile_data,
-                            tile_size / bpp * n_components);
-        }
-
-      gegl_buffer_set (buffer, tile_rect, 0, format, tile_data,
-                       GEGL_AUTO_ROWSTRIDE);
+      gimp_message (info->gimp, G_OBJECT (info->progress), GIMP_MESSAGE_ERROR,
+                    "encountered garbage after reading level: %" G_GOFFSET_FORMAT,
+                    offset);
+      return FALSE;
     }
 
   return TRUE;
-
- bogus_rle:
-  return FALSE;
 }
 
-static gboolean
-xcf_load_tile_zlib (XcfInfo       *info,
-                    GeglBuffer    *buffer,
-                    GeglRectangle *tile_rect,
-                    const Babl    *format,
-                    gint           data_length)
+static void
+xcf_load_level_mapped (XcfInfo    *info,
+                       GeglBuffer *buffer,
+                       gint        n_tiles,
+                       goffset    *tile_offsets,
+                       gsize      *tile_lengths)
 {
-  z_stream  strm;
-  int       action;
-  int       status;
-  gint      bpp       = babl_format_get_bytes_per_pixel (format);
-  gint      tile_size = bpp * tile_rect->width * tile_rect->height;
-  guchar   *tile_data = g_alloca (tile_size);
-  gsize     bytes_read;
-  guchar   *xcfdata;
-
-  /* Workaround for bug #357809: avoid crashing on g_malloc() and skip
-   * this tile (return TRUE without storing data) as if it did not
-   * contain any data.  It is better than returning FALSE, which would
-   * skip the whole hierarchy while there may still be some valid
-   * tiles in the file.
+  const guint8 *contents;
+  goffset       file_length = g_mapped_file_get_length (info->mapped_file);
+  gint          n_tile_cols;
+  gint          last_width;
+  gint          last_height;
+  gint          last = n_tiles - 1;
+  gint          i;
+
+  /* tiles past the end of the file are treated as empty, like when
+   * reading them from the stream.
    */
-  if (data_length <= 0)
-    return TRUE;
+  for (i = 0; i < n_tiles; i++)
+    {
+      tile_offsets[i] = MIN (tile_offsets[i], file_length);
+      tile_lengths[i] = MIN (tile_lengths[i], file_length - tile_offsets[i]);
+    }
+
+  GIMP_LOG (XCF, "mapped %d tiles", n_tiles);
 
-  xcfdata = g_alloca (data_length);
+  gimp_tile_handler_xcf_assign (buffer, info->gimp, info->source_file,
+                                info->compression, info->file_version,
+                                tile_offsets, tile_lengths);
 
-  /* we have to read directly instead of xcf_read_* because we may be
-   * reading past the end of the file here
+  /* the length of the last tile isn't stored in the file, only an upper
+   * bound, which generally covers unrelated data following the tile.
+   * find its actual length, so that copying it when saving doesn't copy
+   * that data along.
    */
-  g_input_stream_read_all (info->input, xcfdata, data_length,
-                           &bytes_read, NULL, NULL);
-  info->cp += bytes_read;
+  contents    = (const guint8 *) g_mapped_file_get_contents (info->mapped_file);
+  n_tile_cols = gimp_gegl_buffer_get_n_tile_cols (buffer, XCF_TILE_WIDTH);
+  last_width  = gegl_buffer_get_width  (buffer) -
+                (last % n_tile_cols) * XCF_TILE_WIDTH;
+  last_height = gegl_buffer_get_height (buffer) -
+                (last / n_tile_cols) * XCF_TILE_HEIGHT;
+
+  if (tile_lengths[last] > 0 &&
+      ! xcf_tile_get_length (info->compression,
+                             gegl_buffer_get_format (buffer),
+                             contents + tile_offsets[last],
+                             tile_lengths[last],
+                             last_width * last_height,
+                             &tile_lengths[last]))
+    {
+      /* the tile is corrupt, don't copy any of the level's tiles when
+       * saving, but encode them again
+       */
+      return;
+    }
 
-  if (bytes_read == 0)
-    return TRUE;
+  /* remember where the tiles are, so that the ones that don't change can
+   * be copied as-is when saving
+   */
+  xcf_source_level_attach (xcf_source_level_new (buffer,
+                                                 info->compression,
+                                                 info->file_version,
+                                                 n_tiles,
+                                                 tile_offsets,
+                                                 tile_lengths),
+                           info->source_file, buffer);
+}
 
-  strm.next_out  = tile_data;
-  strm.avail_out = tile_size;
+static void
+xcf_load_tiles_async (GimpAsync        *async,
+                      XcfLoadTilesData *data)
+{
+  gimp_parallel_distribute (data->n_tiles,
+                            (GeglParallelDistributeFunc) xcf_load_tiles_func,
+                            data);
 
-  strm.zalloc    = Z_NULL;
-  strm.zfree     = Z_NULL;
-  strm.opaque    = Z_NULL;
-  strm.next_in   = xcfdata;
-  strm.avail_in  = bytes_read;
+  gimp_async_finish (async, NULL);
+}
 
-  /* Initialize the stream decompression. */
-  status = inflateInit (&strm);
-  if (status != Z_OK)
-    return FALSE;
+static void
+xcf_load_tiles_func (gint              i,
+                     gint              n,
+                     XcfLoadTilesData *data)
+{
+  gint    bpp       = babl_format_get_bytes_per_pixel (data->format);
+  guchar *tile_data = g_malloc (XCF_TILE_WIDTH * XCF_TILE_HEIGHT * bpp);
+  gint    first     = (gint64) data->n_tiles * i       / n;
+  gint    last      = (gint64) data->n_tiles * (i + 1) / n;
+  gint    j;
 
-  action = Z_NO_FLUSH;
+  gimp_trace_begin ("xcf", "decode-tiles");
 
-  while (status == Z_OK)
+  for (j = first; j < last && ! g_atomic_int_get (&data->failed); j++)
     {
-      if (strm.avail_in == 0)
-        {
-          action = Z_FINISH;
-        }
+      GeglRectangle rect;
+      gboolean      nonzero;
 
-      status = inflate (&strm, action);
+      /* Workaround for bug #357809: skip empty (or truncated) tiles as if
+       * they did not contain any data.  It is better than failing, which
+       * would skip the whole hierarchy while there may still be some
+       * valid tiles in the file.
+       */
+      if (data->tile_data_lengths[j] == 0)
+        continue;
 
-      if (status == Z_STREAM_END)
-        {
-          /* All the data was successfully decoded. */
-          break;
-        }
-      else if (status == Z_BUF_ERROR)
-        {
-          g_printerr ("xcf: decompressed tile bigger than the expected size.");
-          inflateEnd (&strm);
-          return FALSE;
-        }
-      else if (status != Z_OK)
+      gimp_gegl_buffer_get_tile_rect (data->buffer,
+                                      XCF_TILE_WIDTH, XCF_TILE_HEIGHT,
+                                      data->first_tile + j, &rect);
+
+      if (! xcf_tile_decode (data->compression, data->file_version,
+                             data->format,
+                             data->tile_data + j * data->max_data_length,
+                             data->tile_data_lengths[j],
+                             tile_data, rect.width * rect.height,
+                             &nonzero))
         {
-          g_printerr ("xcf: tile decompression failed: %s", zError (status));
-          inflateEnd (&strm);
-          return FALSE;
+          g_atomic_int_set (&data->failed, TRUE);
         }
-    }
-
-  if (! xcf_data_is_zero (tile_data, tile_size))
-    {
-      if (info->file_version >= 12)
+      else if (nonzero)
         {
-          gint n_components = babl_format_get_n_components (format);
-
-          xcf_read_from_be (bpp / n_components, tile_data,
-                            tile_size / bpp * n_components);
+          gegl_buffer_set (data->buffer, &rect, 0, data->format, tile_data,
+                           GEGL_AUTO_ROWSTRIDE);
         }
-
-      gegl_buffer_set (buffer, tile_rect, 0, format, tile_data,
-                       GEGL_AUTO_ROWSTRIDE);
     }
 
-  inflateEnd (&strm);
+  gimp_trace_end ();
 
-  return TRUE;
+  g_free (tile_data);
 }
 
 static GimpParasite *
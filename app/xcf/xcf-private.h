@@ -72,7 +72,8 @@ typedef enum
   COMPRESS_NONE              =  0,
   COMPRESS_RLE               =  1,
   COMPRESS_ZLIB              =  2,  /* unused */
-  COMPRESS_FRACTAL           =  3   /* unused */
+  COMPRESS_FRACTAL           =  3,  /* unused */
+  COMPRESS_ZSTD              =  4
 } XcfCompressionType;
 
 typedef enum
@@ -92,7 +93,9 @@ typedef enum
   XCF_GROUP_ITEM_EXPANDED      = 1
 } XcfGroupItemFlagsType;
 
-typedef struct _XcfInfo  XcfInfo;
+typedef struct _XcfInfo        XcfInfo;
+typedef struct _XcfSourceFile  XcfSourceFile;
+typedef struct _XcfSourceLevel XcfSourceLevel;
 
 struct _XcfInfo
 {
@@ -112,6 +115,9 @@ struct _XcfInfo
   goffset             floating_sel_offset;
   XcfCompressionType  compression;
   gint                file_version;
+  GMappedFile        *mapped_file;
+  XcfSourceFile      *source_file;
+  GHashTable         *source_levels;
 };
 
 
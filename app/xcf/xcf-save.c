@@ -18,7 +18,6 @@
 #include "config.h"
 
 #include <string.h>
-#include <zlib.h>
 
 #include <cairo.h>
 #include <gegl.h>
@@ -33,6 +32,8 @@
 #include "gegl/gimp-gegl-tile-compat.h"
 
 #include "core/gimp.h"
+#include "core/gimp-parallel.h"
+#include "core/gimp-trace.h"
 #include "core/gimpcontainer.h"
 #include "core/gimpchannel.h"
 #include "core/gimpdrawable.h"
@@ -68,11 +69,35 @@
 #include "xcf-read.h"
 #include "xcf-save.h"
 #include "xcf-seek.h"
+#include "xcf-source.h"
+#include "xcf-tile.h"
 #include "xcf-write.h"
 
 #include "gimp-intl.h"
 
 
+/* the maximal amount of encoded tile data xcf_save_level() keeps in memory
+ * before writing it out
+ */
+#define XCF_SAVE_BATCH_SIZE (16 * 1024 * 1024)
+
+
+typedef struct
+{
+  GeglBuffer         *buffer;
+  const Babl         *format;
+  XcfCompressionType  compression;
+  gint                file_version;
+  XcfSourceLevel     *source_level;
+  gsize               max_data_length;
+  gint                first_tile;
+  gint                n_tiles;
+  guint8             *tile_data;
+  gsize              *tile_data_lengths;
+  gint                failed;
+} XcfSaveTilesData;
+
+
 static gboolean xcf_save_image_props   (XcfInfo           *info,
                                         GimpImage         *image,
                                         GError           **error);
@@ -103,22 +128,9 @@ static gboolean xcf_save_buffer        (XcfInfo           *info,
 static gboolean xcf_save_level         (XcfInfo           *info,
                                         GeglBuffer        *buffer,
                                         GError           **error);
-static gboolean xcf_save_tile          (XcfInfo           *info,
-                                        GeglBuffer        *buffer,
-                                        GeglRectangle     *tile_rect,
-                                        const Babl        *format,
-                                        GError           **error);
-static gboolean xcf_save_tile_rle      (XcfInfo           *info,
-                                        GeglBuffer        *buffer,
-                                        GeglRectangle     *tile_rect,
-                                        const Babl        *format,
-                                        guchar            *rlebuf,
-                                        GError           **error);
-static gboolean xcf_save_tile_zlib     (XcfInfo           *info,
-                                        GeglBuffer        *buffer,
-                                        GeglRectangle     *tile_rect,
-                                        const Babl        *format,
-                                        GError           **error);
+static void     xcf_save_tiles_func    (gint               i,
+                                        gint               n,
+                                        XcfSaveTilesData  *data);
 static gboolean xcf_save_parasite      (XcfInfo           *info,
                                         GimpParasite      *parasite,
                                         GError           **error);
@@ -1581,21 +1593,24 @@ xcf_save_level (XcfInfo     *info,
                 GeglBuffer  *buffer,
                 GError     **error)
 {
-  const Babl *format;
-  goffset    *offset_table;
-  goffset    *next_offset;
-  goffset     saved_pos;
-  goffset     offset;
-  goffset     max_data_length;
-  guint32     width;
-  guint32     height;
-  gint        bpp;
-  gint        n_tile_rows;
-  gint        n_tile_cols;
-  guint       ntiles;
-  gint        i;
-  guchar     *rlebuf    = NULL;
-  GError     *tmp_error = NULL;
+  XcfSaveTilesData  data;
+  const Babl       *format;
+  goffset          *offset_table;
+  goffset          *next_offset;
+  gsize            *tile_lengths;
+  goffset           saved_pos;
+  goffset           offset;
+  goffset           max_data_length;
+  guint32           width;
+  guint32           height;
+  gint              bpp;
+  gint              n_tile_rows;
+  gint              n_tile_cols;
+  guint             ntiles;
+  gint              batch_size;
+  gint              first_tile;
+  gboolean          success   = FALSE;
+  GError           *tmp_error = NULL;
 
   format = gegl_buffer_get_format (buffer);
 
@@ -1606,7 +1621,22 @@ xcf_save_level (XcfInfo     *info,
   xcf_write_int32_check_error (info, (guint32 *) &width,  1);
   xcf_write_int32_check_error (info, (guint32 *) &height, 1);
 
-  saved_pos = info->cp;
+  switch (info->compression)
+    {
+    case COMPRESS_NONE:
+    case COMPRESS_RLE:
+    case COMPRESS_ZLIB:
+    case COMPRESS_ZSTD:
+      break;
+
+    case COMPRESS_FRACTAL:
+      g_warning ("xcf: fractal compression unimplemented");
+      return FALSE;
+
+    default:
+      g_warning ("xcf: unknown compression");
+      return FALSE;
+    }
 
   /* maximal allowable size of on-disk tile data.  make it somewhat bigger than
    * the uncompressed tile size, to allow for the possibility of negative
@@ -1615,12 +1645,6 @@ xcf_save_level (XcfInfo     *info,
   max_data_length = XCF_TILE_WIDTH * XCF_TILE_HEIGHT * bpp *
                     XCF_TILE_MAX_DATA_LENGTH_FACTOR /* = 1.5, currently */;
 
-  /* allocate a temporary buffer to store the rle data before it is
-   * written to disk
-   */
-  if (info->compression == COMPRESS_RLE)
-    rlebuf = g_alloca (max_data_length);
-
   n_tile_rows = gimp_gegl_buffer_get_n_tile_rows (buffer, XCF_TILE_HEIGHT);
   n_tile_cols = gimp_gegl_buffer_get_n_tile_cols (buffer, XCF_TILE_WIDTH);
 
@@ -1635,312 +1659,170 @@ xcf_save_level (XcfInfo     *info,
   offset_table = g_malloc0 ((ntiles + 1) * sizeof (goffset));
   next_offset = offset_table;
 
+  tile_lengths = g_new (gsize, ntiles);
+
+  /* the tiles are encoded in parallel, in batches, each of which is then
+   * written out in order.  the tiles that didn't change since the buffer was
+   * last loaded or saved are copied as-is from that file, if possible.
+   */
+  batch_size = MAX (XCF_SAVE_BATCH_SIZE / max_data_length, 1);
+  batch_size = MIN (batch_size, ntiles);
+
+  data.buffer            = buffer;
+  data.format            = format;
+  data.compression       = info->compression;
+  data.file_version      = info->file_version;
+  data.source_level      = xcf_source_level_get (buffer,
+                                                 info->compression,
+                                                 info->file_version);
+  data.max_data_length   = max_data_length;
+  data.tile_data         = g_malloc (batch_size * max_data_length);
+  data.tile_data_lengths = g_new (gsize, batch_size);
+
   /* 'saved_pos' is the offset of the tile offset table  */
   saved_pos = info->cp;
 
   /* write an empty offset table */
-  xcf_write_zero_offset_check_error (info, ntiles + 1);
+  xcf_write_zero_offset (info, ntiles + 1, &tmp_error);
+  if (tmp_error)
+    goto out;
 
   /* 'offset' is where we will write the next tile */
   offset = info->cp;
 
-  for (i = 0; i < ntiles; i++)
+  for (first_tile = 0; first_tile < ntiles; first_tile += data.n_tiles)
     {
-      GeglRectangle rect;
+      gint i;
 
-      /* store the offset in the table and increment the next pointer */
-      *next_offset++ = offset;
+      data.first_tile = first_tile;
+      data.n_tiles    = MIN (batch_size, ntiles - first_tile);
+      data.failed     = FALSE;
 
-      gimp_gegl_buffer_get_tile_rect (buffer,
-                                      XCF_TILE_WIDTH, XCF_TILE_HEIGHT,
-                                      i, &rect);
-
-      /* write out the tile. */
-      switch (info->compression)
-        {
-        case COMPRESS_NONE:
-          xcf_check_error (xcf_save_tile (info, buffer, &rect, format,
-                                          error));
-          break;
-        case COMPRESS_RLE:
-          xcf_check_error (xcf_save_tile_rle (info, buffer, &rect, format,
-                                              rlebuf, error));
-          break;
-        case COMPRESS_ZLIB:
-          xcf_check_error (xcf_save_tile_zlib (info, buffer, &rect, format,
-                                               error));
-          break;
-        case COMPRESS_FRACTAL:
-          g_warning ("xcf: fractal compression unimplemented");
-          g_free (offset_table);
-          return FALSE;
-        }
+      gimp_parallel_distribute (data.n_tiles,
+                                (GeglParallelDistributeFunc) xcf_save_tiles_func,
+                                &data);
 
       /* make sure the on-disk tile data didn't end up being too big.
        * xcf_load_level() would refuse to load the file if it did.
        */
-      if (info->cp < offset || info->cp - offset > max_data_length)
+      if (data.failed)
         {
-          g_message ("xcf: invalid tile data length: %" G_GOFFSET_FORMAT,
-                     info->cp - offset);
-          g_free (offset_table);
-          return FALSE;
+          g_message ("xcf: failed to encode tile data");
+          goto out;
         }
 
-      /* the next tile's offset is after the tile we just wrote */
-      offset = info->cp;
-    }
-
-  /* seek back to the offset table and write it  */
-  xcf_check_error (xcf_seek_pos (info, saved_pos, error));
-  xcf_write_offset_check_error (info, offset_table, ntiles + 1);
-
-  /* seek to the end of the file */
-  xcf_check_error (xcf_seek_pos (info, offset, error));
-
-  g_free (offset_table);
-
-  return TRUE;
-}
-
-static gboolean
-xcf_save_tile (XcfInfo        *info,
-               GeglBuffer     *buffer,
-               GeglRectangle  *tile_rect,
-               const Babl     *format,
-               GError        **error)
-{
-  gint    bpp       = babl_format_get_bytes_per_pixel (format);
-  gint    tile_size = bpp * tile_rect->width * tile_rect->height;
-  guchar *tile_data = g_alloca (tile_size);
-  GError *tmp_error = NULL;
+      for (i = 0; i < data.n_tiles; i++)
+        {
+          /* store the offset in the table and increment the next pointer */
+          *next_offset++ = offset;
 
-  gegl_buffer_get (buffer, tile_rect, 1.0, format, tile_data,
-                   GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
+          tile_lengths[first_tile + i] = data.tile_data_lengths[i];
 
-  if (info->file_version <= 11)
-    {
-      xcf_write_int8_check_error (info, tile_data, tile_size);
-    }
-  else
-    {
-      gint n_components = babl_format_get_n_components (format);
+          /* write out the tile. */
+          xcf_write_int8 (info,
+                          data.tile_data + i * max_data_length,
+                          data.tile_data_lengths[i],
+                          &tmp_error);
+          if (tmp_error)
+            goto out;
 
-      xcf_write_component_check_error (info, bpp / n_components, tile_data,
-                                       tile_size / bpp * n_components);
+          /* the next tile's offset is after the tile we just wrote */
+          offset = info->cp;
+        }
     }
 
-  return TRUE;
-}
+  /* seek back to the offset table and write it  */
+  if (! xcf_seek_pos (info, saved_pos, error))
+    goto out;
 
-static gboolean
-xcf_save_tile_rle (XcfInfo        *info,
-                   GeglBuffer     *buffer,
-                   GeglRectangle  *tile_rect,
-                   const Babl     *format,
-                   guchar         *rlebuf,
-                   GError        **error)
-{
-  gint    bpp       = babl_format_get_bytes_per_pixel (format);
-  gint    tile_size = bpp * tile_rect->width * tile_rect->height;
-  guchar *tile_data = g_alloca (tile_size);
-  gint    len       = 0;
-  gint    i, j;
-  GError *tmp_error  = NULL;
+  xcf_write_offset (info, offset_table, ntiles + 1, &tmp_error);
+  if (tmp_error)
+    goto out;
 
-  gegl_buffer_get (buffer, tile_rect, 1.0, format, tile_data,
-                   GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
+  /* seek to the end of the file */
+  if (! xcf_seek_pos (info, offset, error))
+    goto out;
 
-  if (info->file_version >= 12)
+  if (info->source_levels)
     {
-      gint n_components = babl_format_get_n_components (format);
-
-      xcf_write_to_be (bpp / n_components, tile_data,
-                       tile_size / bpp * n_components);
+      g_hash_table_insert (info->source_levels,
+                           g_object_ref (buffer),
+                           xcf_source_level_new (buffer,
+                                                 info->compression,
+                                                 info->file_version,
+                                                 ntiles,
+                                                 offset_table,
+                                                 tile_lengths));
     }
 
-  for (i = 0; i < bpp; i++)
-    {
-      const guchar *data   = tile_data + i;
-      gint          state  = 0;
-      gint          length = 0;
-      gint          count  = 0;
-      gint          size   = tile_rect->width * tile_rect->height;
-      guint         last   = -1;
-
-      while (size > 0)
-        {
-          switch (state)
-            {
-            case 0:
-              /* in state 0 we try to find a long sequence of
-               *  matching values.
-               */
-              if ((length == 32768) ||
-                  ((size - length) <= 0) ||
-                  ((length > 1) && (last != *data)))
-                {
-                  count += length;
-
-                  if (length >= 128)
-                    {
-                      rlebuf[len++] = 127;
-                      rlebuf[len++] = (length >> 8);
-                      rlebuf[len++] = length & 0x00FF;
-                      rlebuf[len++] = last;
-                    }
-                  else
-                    {
-                      rlebuf[len++] = length - 1;
-                      rlebuf[len++] = last;
-                    }
-
-                  size -= length;
-                  length = 0;
-                }
-              else if ((length == 1) && (last != *data))
-                {
-                  state = 1;
-                }
-              break;
-
-            case 1:
-              /* in state 1 we try and find a long sequence of
-               *  non-matching values.
-               */
-              if ((length == 32768) ||
-                  ((size - length) == 0) ||
-                  ((length > 0) && (last == *data) &&
-                   ((size - length) == 1 || last == data[bpp])))
-                {
-                  const guchar *t;
-
-                  /* if we came here because of a new run, backup one */
-                  if (!((length == 32768) || ((size - length) == 0)))
-                    {
-                      length--;
-                      data -= bpp;
-                    }
-
-                  count += length;
-                  state = 0;
-
-                  if (length >= 128)
-                    {
-                      rlebuf[len++] = 255 - 127;
-                      rlebuf[len++] = (length >> 8);
-                      rlebuf[len++] = length & 0x00FF;
-                    }
-                  else
-                    {
-                      rlebuf[len++] = 255 - (length - 1);
-                    }
-
-                  t = data - length * bpp;
-
-                  for (j = 0; j < length; j++)
-                    {
-                      rlebuf[len++] = *t;
-                      t += bpp;
-                    }
-
-                  size -= length;
-                  length = 0;
-                }
-              break;
-            }
-
-          if (size > 0)
-            {
-              length += 1;
-              last = *data;
-              data += bpp;
-            }
-        }
+  success = TRUE;
 
-      if (count != (tile_rect->width * tile_rect->height))
-        g_message ("xcf: uh oh! xcf rle tile saving error: %d", count);
-    }
+ out:
+  if (tmp_error)
+    g_propagate_error (error, tmp_error);
 
-  xcf_write_int8_check_error (info, rlebuf, len);
+  g_clear_pointer (&data.source_level, xcf_source_level_free);
+  g_free (data.tile_data);
+  g_free (data.tile_data_lengths);
+  g_free (tile_lengths);
+  g_free (offset_table);
 
-  return TRUE;
+  return success;
 }
 
-static gboolean
-xcf_save_tile_zlib (XcfInfo        *info,
-                    GeglBuffer     *buffer,
-                    GeglRectangle  *tile_rect,
-                    const Babl     *format,
-                    GError        **error)
+static void
+xcf_save_tiles_func (gint              i,
+                     gint              n,
+                     XcfSaveTilesData *data)
 {
-  gint      bpp       = babl_format_get_bytes_per_pixel (format);
-  gint      tile_size = bpp * tile_rect->width * tile_rect->height;
-  guchar   *tile_data = g_alloca (tile_size);
-  /* The buffer for compressed data. */
-  guchar   *buf       = g_alloca (tile_size);
-  GError   *tmp_error = NULL;
-  z_stream  strm;
-  int       action;
-  int       status;
-
-  gegl_buffer_get (buffer, tile_rect, 1.0, format, tile_data,
-                   GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
-
-  if (info->file_version >= 12)
-    {
-      gint n_components = babl_format_get_n_components (format);
+  gint    bpp       = babl_format_get_bytes_per_pixel (data->format);
+  guchar *tile_data = g_malloc (XCF_TILE_WIDTH * XCF_TILE_HEIGHT * bpp);
+  gint    first     = (gint64) data->n_tiles * i       / n;
+  gint    last      = (gint64) data->n_tiles * (i + 1) / n;
+  gint    j;
 
-      xcf_write_to_be (bpp / n_components, tile_data,
-                       tile_size / bpp * n_components);
-    }
+  gimp_trace_begin ("xcf", "encode-tiles");
 
-  /* allocate deflate state */
-  strm.zalloc = Z_NULL;
-  strm.zfree  = Z_NULL;
-  strm.opaque = Z_NULL;
-
-  status = deflateInit (&strm, Z_DEFAULT_COMPRESSION);
-  if (status != Z_OK)
-    return FALSE;
-
-  strm.next_in   = tile_data;
-  strm.avail_in  = tile_size;
-  strm.next_out  = buf;
-  strm.avail_out = tile_size;
-
-  action = Z_NO_FLUSH;
-
-  while (status == Z_OK || status == Z_BUF_ERROR)
+  for (j = first; j < last && ! g_atomic_int_get (&data->failed); j++)
     {
-      if (strm.avail_in == 0)
-        {
-          /* Finish the encoding. */
-          action = Z_FINISH;
-        }
+      GeglRectangle  rect;
+      const guint8  *source_data;
+      gsize          source_data_length;
 
-      status = deflate (&strm, action);
+      gimp_gegl_buffer_get_tile_rect (data->buffer,
+                                      XCF_TILE_WIDTH, XCF_TILE_HEIGHT,
+                                      data->first_tile + j, &rect);
 
-      if (status == Z_STREAM_END || status == Z_BUF_ERROR)
+      if (data->source_level &&
+          xcf_source_level_get_tile (data->source_level,
+                                     data->first_tile + j, &rect,
+                                     &source_data, &source_data_length))
         {
-          size_t write_size = tile_size - strm.avail_out;
+          memcpy (data->tile_data + j * data->max_data_length,
+                  source_data, source_data_length);
 
-          xcf_write_int8_check_error (info, buf, write_size);
+          data->tile_data_lengths[j] = source_data_length;
 
-          /* Reset next_out and avail_out. */
-          strm.next_out  = buf;
-          strm.avail_out = tile_size;
+          continue;
         }
-      else if (status != Z_OK)
+
+      gegl_buffer_get (data->buffer, &rect, 1.0, data->format, tile_data,
+                       GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
+
+      if (! xcf_tile_encode (data->compression, data->file_version,
+                             data->format,
+                             tile_data, rect.width * rect.height,
+                             data->tile_data + j * data->max_data_length,
+                             data->max_data_length,
+                             &data->tile_data_lengths[j]))
         {
-          g_printerr ("xcf: tile compression failed: %s", zError (status));
-          deflateEnd (&strm);
-          return FALSE;
+          g_atomic_int_set (&data->failed, TRUE);
         }
     }
 
-  deflateEnd (&strm);
-  return TRUE;
+  gimp_trace_end ();
+
+  g_free (tile_data);
 }
 
 static gboolean
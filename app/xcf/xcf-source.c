@@ -0,0 +1,504 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include <cairo.h>
+#include <gio/gio.h>
+#include <gegl.h>
+
+#include "libgimpbase/gimpbase.h"
+
+#include "core/core-types.h"
+
+#include "gegl/gimptilehandlervalidate.h"
+
+#include "xcf-private.h"
+#include "xcf-source.h"
+
+#include "gimptilehandlerxcf.h"
+
+
+#define XCF_SOURCE_FILE_ATTRIBUTES    \
+  G_FILE_ATTRIBUTE_ID_FILE ","        \
+  G_FILE_ATTRIBUTE_STANDARD_SIZE ","  \
+  G_FILE_ATTRIBUTE_TIME_MODIFIED ","  \
+  G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC
+
+
+struct _XcfSourceFile
+{
+  gint         ref_count;
+
+  GFile       *file;
+  GMappedFile *mapped_file;
+
+  /* the identity, size and modification time of the file when it was
+   * mapped, used to detect in-place modifications
+   */
+  gchar       *id;
+  goffset      size;
+  guint64      mtime;
+  guint32      mtime_usec;
+
+  /* whether a problem with the file was already reported to the user */
+  gint         reported;
+};
+
+struct _XcfSourceLevel
+{
+  XcfSourceFile      *source_file;
+  XcfCompressionType  compression;
+  gint                file_version;
+  const Babl         *format;
+  gint                width;
+  gint                height;
+  gint                n_tiles;
+  goffset            *tile_offsets;
+  gsize              *tile_lengths;
+
+  /* the area of the buffer that changed since the level was attached */
+  cairo_region_t     *dirty_region;
+};
+
+typedef struct
+{
+  GMutex          mutex;
+  XcfSourceLevel *level;
+} XcfSourceBuffer;
+
+
+/*  local function prototypes  */
+
+static void       xcf_source_buffer_free    (XcfSourceBuffer     *source_buffer);
+static void       xcf_source_buffer_changed (GeglBuffer          *buffer,
+                                             const GeglRectangle *rect,
+                                             XcfSourceBuffer     *source_buffer);
+
+
+static GQuark xcf_source_buffer_quark;
+
+
+/*  private functions  */
+
+static void
+xcf_source_buffer_free (XcfSourceBuffer *source_buffer)
+{
+  g_clear_pointer (&source_buffer->level, xcf_source_level_free);
+
+  g_mutex_clear (&source_buffer->mutex);
+
+  g_slice_free (XcfSourceBuffer, source_buffer);
+}
+
+static void
+xcf_source_buffer_changed (GeglBuffer          *buffer,
+                           const GeglRectangle *rect,
+                           XcfSourceBuffer     *source_buffer)
+{
+  /* the buffer may be modified by any thread */
+  g_mutex_lock (&source_buffer->mutex);
+
+  if (source_buffer->level)
+    {
+      cairo_region_union_rectangle (source_buffer->level->dirty_region,
+                                    (const cairo_rectangle_int_t *) rect);
+    }
+
+  g_mutex_unlock (&source_buffer->mutex);
+}
+
+
+/*  public functions  */
+
+XcfSourceFile *
+xcf_source_file_new (GFile       *file,
+                     GMappedFile *mapped_file)
+{
+  XcfSourceFile *source_file;
+  GFileInfo     *info;
+
+  g_return_val_if_fail (G_IS_FILE (file), NULL);
+  g_return_val_if_fail (mapped_file != NULL, NULL);
+
+  info = g_file_query_info (file, XCF_SOURCE_FILE_ATTRIBUTES,
+                            G_FILE_QUERY_INFO_NONE, NULL, NULL);
+
+  if (! info)
+    return NULL;
+
+  source_file = g_slice_new0 (XcfSourceFile);
+
+  source_file->ref_count   = 1;
+  source_file->file        = g_object_ref (file);
+  source_file->mapped_file = g_mapped_file_ref (mapped_file);
+
+  source_file->id         = g_strdup (g_file_info_get_attribute_string (
+                                        info, G_FILE_ATTRIBUTE_ID_FILE));
+  source_file->size       = g_file_info_get_size (info);
+  source_file->mtime      = g_file_info_get_attribute_uint64 (
+                              info, G_FILE_ATTRIBUTE_TIME_MODIFIED);
+  source_file->mtime_usec = g_file_info_get_attribute_uint32 (
+                              info, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+
+  g_object_unref (info);
+
+  return source_file;
+}
+
+XcfSourceFile *
+xcf_source_file_ref (XcfSourceFile *source_file)
+{
+  g_return_val_if_fail (source_file != NULL, NULL);
+
+  g_atomic_int_inc (&source_file->ref_count);
+
+  return source_file;
+}
+
+void
+xcf_source_file_unref (XcfSourceFile *source_file)
+{
+  g_return_if_fail (source_file != NULL);
+
+  if (g_atomic_int_dec_and_test (&source_file->ref_count))
+    {
+      g_object_unref (source_file->file);
+      g_mapped_file_unref (source_file->mapped_file);
+      g_free (source_file->id);
+
+      g_slice_free (XcfSourceFile, source_file);
+    }
+}
+
+GFile *
+xcf_source_file_get_file (XcfSourceFile *source_file)
+{
+  g_return_val_if_fail (source_file != NULL, NULL);
+
+  return source_file->file;
+}
+
+/* returns whether the mapped contents of source_file can still be read.
+ * safe to call from multiple threads.
+ */
+gboolean
+xcf_source_file_is_valid (XcfSourceFile *source_file)
+{
+  GFileInfo *info;
+  gboolean   valid = TRUE;
+
+  g_return_val_if_fail (source_file != NULL, FALSE);
+
+  info = g_file_query_info (source_file->file, XCF_SOURCE_FILE_ATTRIBUTES,
+                            G_FILE_QUERY_INFO_NONE, NULL, NULL);
+
+  /* if the file was deleted, or replaced by another file, the mapped file
+   * still refers to the original, unmodified, contents.  if, on the other
+   * hand, it was modified in place (in particular, if it was truncated in
+   * order to be overwritten by the current save), the mapped contents can
+   * no longer be trusted.
+   */
+  if (info)
+    {
+      const gchar *id = g_file_info_get_attribute_string (
+        info, G_FILE_ATTRIBUTE_ID_FILE);
+
+      if (! source_file->id || ! id || ! strcmp (source_file->id, id))
+        {
+          valid =
+            g_file_info_get_size (info) == source_file->size                 &&
+            g_file_info_get_attribute_uint64 (
+              info, G_FILE_ATTRIBUTE_TIME_MODIFIED) == source_file->mtime    &&
+            g_file_info_get_attribute_uint32 (
+              info, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC) == source_file->mtime_usec;
+        }
+
+      g_object_unref (info);
+    }
+
+  return valid;
+}
+
+/* returns whether file refers to the same file on disk as source_file,
+ * including through a symbolic or hard link, i.e., whether writing to file
+ * may modify the mapped contents in place.
+ */
+gboolean
+xcf_source_file_is_file (XcfSourceFile *source_file,
+                         GFile         *file)
+{
+  GFileInfo *info;
+  gboolean   same;
+
+  g_return_val_if_fail (source_file != NULL, FALSE);
+  g_return_val_if_fail (G_IS_FILE (file), FALSE);
+
+  if (g_file_equal (source_file->file, file))
+    return TRUE;
+
+  if (! source_file->id)
+    return FALSE;
+
+  info = g_file_query_info (file, G_FILE_ATTRIBUTE_ID_FILE,
+                            G_FILE_QUERY_INFO_NONE, NULL, NULL);
+
+  if (! info)
+    return FALSE;
+
+  same = ! g_strcmp0 (source_file->id,
+                      g_file_info_get_attribute_string (
+                        info, G_FILE_ATTRIBUTE_ID_FILE));
+
+  g_object_unref (info);
+
+  return same;
+}
+
+/* returns TRUE the first time it's called for source_file, so that a
+ * problem affecting many of its levels is only reported once.
+ */
+gboolean
+xcf_source_file_begin_report (XcfSourceFile *source_file)
+{
+  g_return_val_if_fail (source_file != NULL, FALSE);
+
+  return g_atomic_int_compare_and_exchange (&source_file->reported,
+                                            FALSE, TRUE);
+}
+
+const guint8 *
+xcf_source_file_get_contents (XcfSourceFile *source_file,
+                              gsize         *length)
+{
+  g_return_val_if_fail (source_file != NULL, NULL);
+  g_return_val_if_fail (length != NULL, NULL);
+
+  *length = g_mapped_file_get_length (source_file->mapped_file);
+
+  return (const guint8 *) g_mapped_file_get_contents (
+    source_file->mapped_file);
+}
+
+/* creates a level describing the tiles of buffer, as stored at the given
+ * offsets of a yet-unspecified file, see xcf_source_level_attach().
+ */
+XcfSourceLevel *
+xcf_source_level_new (GeglBuffer         *buffer,
+                      XcfCompressionType  compression,
+                      gint                file_version,
+                      gint                n_tiles,
+                      const goffset      *tile_offsets,
+                      const gsize        *tile_lengths)
+{
+  XcfSourceLevel *level;
+
+  g_return_val_if_fail (GEGL_IS_BUFFER (buffer), NULL);
+  g_return_val_if_fail (n_tiles > 0, NULL);
+  g_return_val_if_fail (tile_offsets != NULL, NULL);
+  g_return_val_if_fail (tile_lengths != NULL, NULL);
+
+  level = g_slice_new0 (XcfSourceLevel);
+
+  level->compression  = compression;
+  level->file_version = file_version;
+  level->format       = gegl_buffer_get_format (buffer);
+  level->width        = gegl_buffer_get_width  (buffer);
+  level->height       = gegl_buffer_get_height (buffer);
+  level->n_tiles      = n_tiles;
+  level->tile_offsets = g_memdup2 (tile_offsets, n_tiles * sizeof (goffset));
+  level->tile_lengths = g_memdup2 (tile_lengths, n_tiles * sizeof (gsize));
+  level->dirty_region = cairo_region_create ();
+
+  return level;
+}
+
+void
+xcf_source_level_free (XcfSourceLevel *level)
+{
+  g_return_if_fail (level != NULL);
+
+  g_clear_pointer (&level->source_file, xcf_source_file_unref);
+
+  g_free (level->tile_offsets);
+  g_free (level->tile_lengths);
+
+  cairo_region_destroy (level->dirty_region);
+
+  g_slice_free (XcfSourceLevel, level);
+}
+
+/* attaches level, whose tiles are stored in source_file, to buffer,
+ * replacing any previously-attached level.  the buffer takes ownership of
+ * the level.
+ */
+void
+xcf_source_level_attach (XcfSourceLevel *level,
+                         XcfSourceFile  *source_file,
+                         GeglBuffer     *buffer)
+{
+  XcfSourceBuffer *source_buffer;
+
+  g_return_if_fail (level != NULL);
+  g_return_if_fail (source_file != NULL);
+  g_return_if_fail (GEGL_IS_BUFFER (buffer));
+
+  if (! xcf_source_buffer_quark)
+    xcf_source_buffer_quark = g_quark_from_static_string ("gimp-xcf-source");
+
+  g_clear_pointer (&level->source_file, xcf_source_file_unref);
+  level->source_file = xcf_source_file_ref (source_file);
+
+  cairo_region_destroy (level->dirty_region);
+  level->dirty_region = cairo_region_create ();
+
+  source_buffer = g_object_get_qdata (G_OBJECT (buffer),
+                                      xcf_source_buffer_quark);
+
+  if (! source_buffer)
+    {
+      source_buffer = g_slice_new0 (XcfSourceBuffer);
+
+      g_mutex_init (&source_buffer->mutex);
+
+      g_object_set_qdata_full (G_OBJECT (buffer), xcf_source_buffer_quark,
+                               source_buffer,
+                               (GDestroyNotify) xcf_source_buffer_free);
+
+      gegl_buffer_signal_connect (buffer, "changed",
+                                  G_CALLBACK (xcf_source_buffer_changed),
+                                  source_buffer);
+    }
+
+  g_mutex_lock (&source_buffer->mutex);
+
+  g_clear_pointer (&source_buffer->level, xcf_source_level_free);
+  source_buffer->level = level;
+
+  g_mutex_unlock (&source_buffer->mutex);
+}
+
+/* returns a copy of the level attached to buffer, if there is one, and if
+ * its tiles can be copied as-is to a file using the given compression and
+ * version; otherwise, returns NULL.
+ */
+XcfSourceLevel *
+xcf_source_level_get (GeglBuffer         *buffer,
+                      XcfCompressionType  compression,
+                      gint                file_version)
+{
+  XcfSourceBuffer         *source_buffer;
+  GimpTileHandlerValidate *validate;
+  XcfSourceLevel          *level = NULL;
+
+  g_return_val_if_fail (GEGL_IS_BUFFER (buffer), NULL);
+
+  if (! xcf_source_buffer_quark)
+    return NULL;
+
+  source_buffer = g_object_get_qdata (G_OBJECT (buffer),
+                                      xcf_source_buffer_quark);
+
+  if (! source_buffer)
+    return NULL;
+
+  /* buffers whose contents are rendered by a validate handler, such as
+   * those of layer groups, change without emitting "changed".
+   */
+  validate = gimp_tile_handler_validate_get_assigned (buffer);
+
+  if (validate && ! GIMP_IS_TILE_HANDLER_XCF (validate))
+    return NULL;
+
+  g_mutex_lock (&source_buffer->mutex);
+
+  if (source_buffer->level)
+    {
+      XcfSourceLevel *source_level = source_buffer->level;
+
+      /* the tile data of versions before 12 isn't stored in big-endian
+       * byte order, but is otherwise the same.
+       */
+      if (source_level->compression         == compression                  &&
+          (source_level->file_version >= 12) == (file_version >= 12)       &&
+          source_level->format              == gegl_buffer_get_format (buffer) &&
+          source_level->width               == gegl_buffer_get_width  (buffer) &&
+          source_level->height              == gegl_buffer_get_height (buffer) &&
+          xcf_source_file_is_valid (source_level->source_file))
+        {
+          level = xcf_source_level_new (buffer,
+                                        source_level->compression,
+                                        source_level->file_version,
+                                        source_level->n_tiles,
+                                        source_level->tile_offsets,
+                                        source_level->tile_lengths);
+
+          level->source_file = xcf_source_file_ref (source_level->source_file);
+
+          cairo_region_union (level->dirty_region,
+                              source_level->dirty_region);
+        }
+    }
+
+  g_mutex_unlock (&source_buffer->mutex);
+
+  return level;
+}
+
+/* returns, in data and data_length, the encoded data of the given tile,
+ * if it didn't change since the level was attached.  safe to call from
+ * multiple threads.
+ */
+gboolean
+xcf_source_level_get_tile (XcfSourceLevel       *level,
+                           gint                  tile_num,
+                           const GeglRectangle  *tile_rect,
+                           const guint8        **data,
+                           gsize                *data_length)
+{
+  const guint8 *contents;
+  gsize         length;
+  goffset       offset;
+
+  g_return_val_if_fail (level != NULL, FALSE);
+  g_return_val_if_fail (level->source_file != NULL, FALSE);
+  g_return_val_if_fail (tile_num >= 0 && tile_num < level->n_tiles, FALSE);
+  g_return_val_if_fail (tile_rect != NULL, FALSE);
+  g_return_val_if_fail (data != NULL, FALSE);
+  g_return_val_if_fail (data_length != NULL, FALSE);
+
+  if (cairo_region_contains_rectangle (
+        level->dirty_region,
+        (const cairo_rectangle_int_t *) tile_rect) != CAIRO_REGION_OVERLAP_OUT)
+    {
+      return FALSE;
+    }
+
+  contents = (const guint8 *) g_mapped_file_get_contents (
+    level->source_file->mapped_file);
+  length   = g_mapped_file_get_length (level->source_file->mapped_file);
+
+  /* the data of tiles past the end of the file is empty */
+  offset = MIN (level->tile_offsets[tile_num], length);
+
+  *data        = contents + offset;
+  *data_length = MIN (level->tile_lengths[tile_num], length - offset);
+
+  return TRUE;
+}
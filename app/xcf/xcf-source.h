@@ -0,0 +1,66 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __XCF_SOURCE_H__
+#define __XCF_SOURCE_H__
+
+
+/* an XcfSourceFile is a memory-mapped XCF file, and an XcfSourceLevel is
+ * the location of the tiles of a level inside such a file.  a level can be
+ * attached to the buffer whose contents it holds, in which case the tiles
+ * of the buffer that don't change are written to subsequent saves by
+ * copying their encoded data from the file, instead of encoding them again.
+ */
+
+XcfSourceFile  * xcf_source_file_new       (GFile                *file,
+                                            GMappedFile          *mapped_file);
+XcfSourceFile  * xcf_source_file_ref       (XcfSourceFile        *source_file);
+void             xcf_source_file_unref     (XcfSourceFile        *source_file);
+
+GFile          * xcf_source_file_get_file  (XcfSourceFile        *source_file);
+gboolean         xcf_source_file_is_valid  (XcfSourceFile        *source_file);
+gboolean         xcf_source_file_is_file   (XcfSourceFile        *source_file,
+                                            GFile                *file);
+gboolean         xcf_source_file_begin_report
+                                           (XcfSourceFile        *source_file);
+const guint8   * xcf_source_file_get_contents
+                                           (XcfSourceFile        *source_file,
+                                            gsize                *length);
+
+XcfSourceLevel * xcf_source_level_new      (GeglBuffer           *buffer,
+                                            XcfCompressionType    compression,
+                                            gint                  file_version,
+                                            gint                  n_tiles,
+                                            const goffset        *tile_offsets,
+                                            const gsize          *tile_lengths);
+void             xcf_source_level_free     (XcfSourceLevel       *level);
+
+void             xcf_source_level_attach   (XcfSourceLevel       *level,
+                                            XcfSourceFile        *source_file,
+                                            GeglBuffer           *buffer);
+XcfSourceLevel * xcf_source_level_get      (GeglBuffer           *buffer,
+                                            XcfCompressionType    compression,
+                                            gint                  file_version);
+
+gboolean         xcf_source_level_get_tile (XcfSourceLevel       *level,
+                                            gint                  tile_num,
+                                            const GeglRectangle  *tile_rect,
+                                            const guint8        **data,
+                                            gsize                *data_length);
+
+
+#endif  /* __XCF_SOURCE_H__ */
@@ -0,0 +1,770 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <string.h>
+#include <zlib.h>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include <gio/gio.h>
+#include <gegl.h>
+
+#include "libgimpbase/gimpbase.h"
+
+#include "core/core-types.h"
+
+#include "xcf-private.h"
+#include "xcf-read.h"
+#include "xcf-tile.h"
+#include "xcf-utils.h"
+#include "xcf-write.h"
+
+
+/* the zstd compression level used for saving.  the default level gives a
+ * ratio similar to zlib's default, at a fraction of the cost.
+ */
+#define XCF_ZSTD_COMPRESSION_LEVEL 3
+
+
+static gboolean   xcf_tile_decode_none (const guint8 *data,
+                                        gsize         data_length,
+                                        guint8       *tile_data,
+                                        gint          bpp,
+                                        gint          n_pixels,
+                                        gboolean     *nonzero,
+                                        gsize        *used_length);
+static gboolean   xcf_tile_decode_rle  (const guint8 *data,
+                                        gsize         data_length,
+                                        guint8       *tile_data,
+                                        gint          bpp,
+                                        gint          n_pixels,
+                                        gboolean     *nonzero,
+                                        gsize        *used_length);
+static gboolean   xcf_tile_decode_zlib (const guint8 *data,
+                                        gsize         data_length,
+                                        guint8       *tile_data,
+                                        gint          bpp,
+                                        gint          n_pixels,
+                                        gboolean     *nonzero,
+                                        gsize        *used_length);
+static gboolean   xcf_tile_decode_zstd (const guint8 *data,
+                                        gsize         data_length,
+                                        guint8       *tile_data,
+                                        gint          bpp,
+                                        gint          n_pixels,
+                                        gboolean     *nonzero,
+                                        gsize        *used_length);
+
+static gboolean   xcf_tile_encode_none (const guint8 *tile_data,
+                                        gint          bpp,
+                                        gint          n_pixels,
+                                        guint8       *data,
+                                        gsize         max_data_length,
+                                        gsize        *data_length);
+static gboolean   xcf_tile_encode_rle  (const guint8 *tile_data,
+                                        gint          bpp,
+                                        gint          n_pixels,
+                                        guint8       *data,
+                                        gsize         max_data_length,
+                                        gsize        *data_length);
+static gboolean   xcf_tile_encode_zlib (const guint8 *tile_data,
+                                        gint          bpp,
+                                        gint          n_pixels,
+                                        guint8       *data,
+                                        gsize         max_data_length,
+                                        gsize        *data_length);
+static gboolean   xcf_tile_encode_zstd (const guint8 *tile_data,
+                                        gint          bpp,
+                                        gint          n_pixels,
+                                        guint8       *data,
+                                        gsize         max_data_length,
+                                        gsize        *data_length);
+
+static gboolean   xcf_tile_decode_real (XcfCompressionType  compression,
+                                        gint                file_version,
+                                        const Babl         *format,
+                                        const guint8       *data,
+                                        gsize               data_length,
+                                        guint8             *tile_data,
+                                        gint                n_pixels,
+                                        gboolean           *nonzero,
+                                        gsize              *used_length);
+
+
+#ifdef HAVE_ZSTD
+/* zstd contexts are relatively expensive to create, so keep one per thread */
+static GPrivate xcf_tile_zstd_cctx = G_PRIVATE_INIT ((GDestroyNotify) ZSTD_freeCCtx);
+static GPrivate xcf_tile_zstd_dctx = G_PRIVATE_INIT ((GDestroyNotify) ZSTD_freeDCtx);
+#endif
+
+
+/*  private functions  */
+
+static gboolean
+xcf_tile_decode_none (const guint8 *data,
+                      gsize         data_length,
+                      guint8       *tile_data,
+                      gint          bpp,
+                      gint          n_pixels,
+                      gboolean     *nonzero,
+                      gsize        *used_length)
+{
+  gsize tile_size = (gsize) bpp * n_pixels;
+
+  if (data_length < tile_size)
+    return FALSE;
+
+  memcpy (tile_data, data, tile_size);
+
+  *nonzero     = ! xcf_data_is_zero (tile_data, tile_size);
+  *used_length = tile_size;
+
+  return TRUE;
+}
+
+static gboolean
+xcf_tile_decode_rle (const guint8 *data,
+                     gsize         data_length,
+                     guint8       *tile_data,
+                     gint          bpp,
+                     gint          n_pixels,
+                     gboolean     *nonzero,
+                     gsize        *used_length)
+{
+  const guint8 *xcfdata      = data;
+  const guint8 *xcfdatalimit = &data[data_length - 1];
+  guint8        nz           = FALSE;
+  gint          i;
+
+  for (i = 0; i < bpp; i++)
+    {
+      guint8 *dest  = tile_data + i;
+      gint    size  = n_pixels;
+      guint8  val;
+      gint    length;
+      gint    j;
+
+      while (size > 0)
+        {
+          if (xcfdata > xcfdatalimit)
+            return FALSE;
+
+          val = *xcfdata++;
+
+          length = val;
+          if (length >= 128)
+            {
+              length = 255 - (length - 1);
+              if (length == 128)
+                {
+                  if (xcfdata >= xcfdatalimit)
+                    return FALSE;
+
+                  length = (*xcfdata << 8) + xcfdata[1];
+                  xcfdata += 2;
+                }
+
+              size -= length;
+
+              if (size < 0)
+                return FALSE;
+
+              if (&xcfdata[length - 1] > xcfdatalimit)
+                return FALSE;
+
+              while (length-- > 0)
+                {
+                  *dest = *xcfdata++;
+                  nz |= *dest;
+                  dest += bpp;
+                }
+            }
+          else
+            {
+              length += 1;
+              if (length == 128)
+                {
+                  if (xcfdata >= xcfdatalimit)
+                    return FALSE;
+
+                  length = (*xcfdata << 8) + xcfdata[1];
+                  xcfdata += 2;
+                }
+
+              size -= length;
+
+              if (size < 0)
+                return FALSE;
+
+              if (xcfdata > xcfdatalimit)
+                return FALSE;
+
+              val = *xcfdata++;
+              nz |= val;
+
+              for (j = 0; j < length; j++)
+                {
+                  *dest = val;
+                  dest += bpp;
+                }
+            }
+        }
+    }
+
+  *nonzero     = nz != 0;
+  *used_length = xcfdata - data;
+
+  return TRUE;
+}
+
+static gboolean
+xcf_tile_decode_zlib (const guint8 *data,
+                      gsize         data_length,
+                      guint8       *tile_data,
+                      gint          bpp,
+                      gint          n_pixels,
+                      gboolean     *nonzero,
+                      gsize        *used_length)
+{
+  z_stream strm;
+  int      action;
+  int      status;
+  gint     tile_size = bpp * n_pixels;
+
+  strm.next_out  = tile_data;
+  strm.avail_out = tile_size;
+
+  strm.zalloc    = Z_NULL;
+  strm.zfree     = Z_NULL;
+  strm.opaque    = Z_NULL;
+  strm.next_in   = (guint8 *) data;
+  strm.avail_in  = data_length;
+
+  /* Initialize the stream decompression. */
+  status = inflateInit (&strm);
+  if (status != Z_OK)
+    return FALSE;
+
+  action = Z_NO_FLUSH;
+
+  while (status == Z_OK)
+    {
+      if (strm.avail_in == 0)
+        {
+          action = Z_FINISH;
+        }
+
+      status = inflate (&strm, action);
+
+      if (status == Z_STREAM_END)
+        {
+          /* All the data was successfully decoded. */
+          break;
+        }
+      else if (status == Z_BUF_ERROR)
+        {
+          g_printerr ("xcf: decompressed tile bigger than the expected size.");
+          inflateEnd (&strm);
+          return FALSE;
+        }
+      else if (status != Z_OK)
+        {
+          g_printerr ("xcf: tile decompression failed: %s", zError (status));
+          inflateEnd (&strm);
+          return FALSE;
+        }
+    }
+
+  *used_length = strm.total_in;
+
+  inflateEnd (&strm);
+
+  *nonzero = ! xcf_data_is_zero (tile_data, tile_size);
+
+  return TRUE;
+}
+
+static gboolean
+xcf_tile_decode_zstd (const guint8 *data,
+                      gsize         data_length,
+                      guint8       *tile_data,
+                      gint          bpp,
+                      gint          n_pixels,
+                      gboolean     *nonzero,
+                      gsize        *used_length)
+{
+#ifdef HAVE_ZSTD
+  ZSTD_DCtx *dctx      = g_private_get (&xcf_tile_zstd_dctx);
+  gsize      tile_size = (gsize) bpp * n_pixels;
+  gsize      size;
+
+  if (! dctx)
+    {
+      dctx = ZSTD_createDCtx ();
+
+      g_private_set (&xcf_tile_zstd_dctx, dctx);
+    }
+
+  /* the data of the last tile of a level may be followed by unrelated
+   * bytes, since its length isn't stored in the file; only decompress the
+   * first frame.
+   */
+  *used_length = ZSTD_findFrameCompressedSize (data, data_length);
+
+  if (ZSTD_isError (*used_length))
+    size = *used_length;
+  else
+    size = ZSTD_decompressDCtx (dctx, tile_data, tile_size,
+                                data, *used_length);
+
+  if (ZSTD_isError (size))
+    {
+      g_printerr ("xcf: tile decompression failed: %s",
+                  ZSTD_getErrorName (size));
+      return FALSE;
+    }
+  else if (size != tile_size)
+    {
+      g_printerr ("xcf: decompressed tile size doesn't match the expected "
+                  "size.");
+      return FALSE;
+    }
+
+  *nonzero = ! xcf_data_is_zero (tile_data, tile_size);
+
+  return TRUE;
+#else
+  g_printerr ("xcf: zstd compression is not supported by this build.");
+
+  return FALSE;
+#endif
+}
+
+static gboolean
+xcf_tile_encode_none (const guint8 *tile_data,
+                      gint          bpp,
+                      gint          n_pixels,
+                      guint8       *data,
+                      gsize         max_data_length,
+                      gsize        *data_length)
+{
+  gsize tile_size = (gsize) bpp * n_pixels;
+
+  if (tile_size > max_data_length)
+    return FALSE;
+
+  memcpy (data, tile_data, tile_size);
+
+  *data_length = tile_size;
+
+  return TRUE;
+}
+
+static gboolean
+xcf_tile_encode_rle (const guint8 *tile_data,
+                     gint          bpp,
+                     gint          n_pixels,
+                     guint8       *rlebuf,
+                     gsize         max_data_length,
+                     gsize        *data_length)
+{
+  gsize len = 0;
+  gint  i, j;
+
+  for (i = 0; i < bpp; i++)
+    {
+      const guchar *data   = tile_data + i;
+      gint          state  = 0;
+      gint          length = 0;
+      gint          count  = 0;
+      gint          size   = n_pixels;
+      guint         last   = -1;
+
+      while (size > 0)
+        {
+          switch (state)
+            {
+            case 0:
+              /* in state 0 we try to find a long sequence of
+               *  matching values.
+               */
+              if ((length == 32768) ||
+                  ((size - length) <= 0) ||
+                  ((length > 1) && (last != *data)))
+                {
+                  if (len + 4 > max_data_length)
+                    return FALSE;
+
+                  count += length;
+
+                  if (length >= 128)
+                    {
+                      rlebuf[len++] = 127;
+                      rlebuf[len++] = (length >> 8);
+                      rlebuf[len++] = length & 0x00FF;
+                      rlebuf[len++] = last;
+                    }
+                  else
+                    {
+                      rlebuf[len++] = length - 1;
+                      rlebuf[len++] = last;
+                    }
+
+                  size -= length;
+                  length = 0;
+                }
+              else if ((length == 1) && (last != *data))
+                {
+                  state = 1;
+                }
+              break;
+
+            case 1:
+              /* in state 1 we try and find a long sequence of
+               *  non-matching values.
+               */
+              if ((length == 32768) ||
+                  ((size - length) == 0) ||
+                  ((length > 0) && (last == *data) &&
+                   ((size - length) == 1 || last == data[bpp])))
+                {
+                  const guchar *t;
+
+                  /* if we came here because of a new run, backup one */
+                  if (!((length == 32768) || ((size - length) == 0)))
+                    {
+                      length--;
+                      data -= bpp;
+                    }
+
+                  if (len + 3 + length > max_data_length)
+                    return FALSE;
+
+                  count += length;
+                  state = 0;
+
+                  if (length >= 128)
+                    {
+                      rlebuf[len++] = 255 - 127;
+                      rlebuf[len++] = (length >> 8);
+                      rlebuf[len++] = length & 0x00FF;
+                    }
+                  else
+                    {
+                      rlebuf[len++] = 255 - (length - 1);
+                    }
+
+                  t = data - length * bpp;
+
+                  for (j = 0; j < length; j++)
+                    {
+                      rlebuf[len++] = *t;
+                      t += bpp;
+                    }
+
+                  size -= length;
+                  length = 0;
+                }
+              break;
+            }
+
+          if (size > 0)
+            {
+              length += 1;
+              last = *data;
+              data += bpp;
+            }
+        }
+
+      if (count != n_pixels)
+        g_message ("xcf: uh oh! xcf rle tile saving error: %d", count);
+    }
+
+  *data_length = len;
+
+  return TRUE;
+}
+
+static gboolean
+xcf_tile_encode_zlib (const guint8 *tile_data,
+                      gint          bpp,
+                      gint          n_pixels,
+                      guint8       *data,
+                      gsize         max_data_length,
+                      gsize        *data_length)
+{
+  z_stream strm;
+  int      status;
+
+  /* allocate deflate state */
+  strm.zalloc = Z_NULL;
+  strm.zfree  = Z_NULL;
+  strm.opaque = Z_NULL;
+
+  status = deflateInit (&strm, Z_DEFAULT_COMPRESSION);
+  if (status != Z_OK)
+    return FALSE;
+
+  strm.next_in   = (guint8 *) tile_data;
+  strm.avail_in  = bpp * n_pixels;
+  strm.next_out  = data;
+  strm.avail_out = max_data_length;
+
+  status = deflate (&strm, Z_FINISH);
+
+  deflateEnd (&strm);
+
+  if (status != Z_STREAM_END)
+    {
+      /* the output didn't fit in max_data_length bytes */
+      if (status != Z_OK && status != Z_BUF_ERROR)
+        g_printerr ("xcf: tile compression failed: %s", zError (status));
+
+      return FALSE;
+    }
+
+  *data_length = max_data_length - strm.avail_out;
+
+  return TRUE;
+}
+
+
+static gboolean
+xcf_tile_encode_zstd (const guint8 *tile_data,
+                      gint          bpp,
+                      gint          n_pixels,
+                      guint8       *data,
+                      gsize         max_data_length,
+                      gsize        *data_length)
+{
+#ifdef HAVE_ZSTD
+  ZSTD_CCtx *cctx = g_private_get (&xcf_tile_zstd_cctx);
+  gsize      size;
+
+  if (! cctx)
+    {
+      cctx = ZSTD_createCCtx ();
+
+      g_private_set (&xcf_tile_zstd_cctx, cctx);
+    }
+
+  size = ZSTD_compressCCtx (cctx,
+                            data, max_data_length,
+                            tile_data, (gsize) bpp * n_pixels,
+                            XCF_ZSTD_COMPRESSION_LEVEL);
+
+  /* this includes the case where the output didn't fit in max_data_length
+   * bytes
+   */
+  if (ZSTD_isError (size))
+    return FALSE;
+
+  *data_length = size;
+
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+static gboolean
+xcf_tile_decode_real (XcfCompressionType  compression,
+                      gint                file_version,
+                      const Babl         *format,
+                      const guint8       *data,
+                      gsize               data_length,
+                      guint8             *tile_data,
+                      gint                n_pixels,
+                      gboolean           *nonzero,
+                      gsize              *used_length)
+{
+  gint     bpp = babl_format_get_bytes_per_pixel (format);
+  gboolean success;
+
+  *nonzero     = FALSE;
+  *used_length = 0;
+
+  /* an empty (or truncated) tile carries no data; treat it as if it was
+   * all zero, rather than failing the whole level.
+   */
+  if (! data || data_length == 0)
+    return compression != COMPRESS_NONE;
+
+  switch (compression)
+    {
+    case COMPRESS_NONE:
+      success = xcf_tile_decode_none (data, data_length, tile_data,
+                                      bpp, n_pixels, nonzero,
+                                      used_length);
+      break;
+
+    case COMPRESS_RLE:
+      success = xcf_tile_decode_rle (data, data_length, tile_data,
+                                     bpp, n_pixels, nonzero,
+                                     used_length);
+      break;
+
+    case COMPRESS_ZLIB:
+      success = xcf_tile_decode_zlib (data, data_length, tile_data,
+                                      bpp, n_pixels, nonzero,
+                                      used_length);
+      break;
+
+    case COMPRESS_ZSTD:
+      success = xcf_tile_decode_zstd (data, data_length, tile_data,
+                                      bpp, n_pixels, nonzero,
+                                      used_length);
+      break;
+
+    default:
+      return FALSE;
+    }
+
+  if (success && *nonzero && file_version >= 12)
+    {
+      gint n_components = babl_format_get_n_components (format);
+
+      xcf_read_from_be (bpp / n_components, tile_data,
+                        n_pixels * n_components);
+    }
+
+  return success;
+}
+
+
+/*  public functions  */
+
+/* decodes the on-disk data of a single tile into tile_data, which must be
+ * large enough to hold n_pixels pixels of the given format.  the decoded
+ * data is converted to the native byte order.
+ *
+ * nonzero is set to whether the tile contains any nonzero data; when it is
+ * FALSE, the contents of tile_data are unspecified, and the tile can be
+ * skipped altogether.
+ */
+gboolean
+xcf_tile_decode (XcfCompressionType  compression,
+                 gint                file_version,
+                 const Babl         *format,
+                 const guint8       *data,
+                 gsize               data_length,
+                 guint8             *tile_data,
+                 gint                n_pixels,
+                 gboolean           *nonzero)
+{
+  gsize used_length;
+
+  g_return_val_if_fail (tile_data != NULL, FALSE);
+  g_return_val_if_fail (nonzero != NULL, FALSE);
+
+  return xcf_tile_decode_real (compression, file_version, format,
+                               data, data_length, tile_data, n_pixels,
+                               nonzero, &used_length);
+}
+
+/* finds the length of the encoded data of a single tile, which starts at
+ * data and spans at most data_length bytes, by decoding it.  this is
+ * needed for the last tile of a level, whose length isn't stored in the
+ * file, and whose data may be followed by unrelated bytes.
+ *
+ * returns FALSE if the tile can't be decoded.
+ */
+gboolean
+xcf_tile_get_length (XcfCompressionType  compression,
+                     const Babl         *format,
+                     const guint8       *data,
+                     gsize               data_length,
+                     gint                n_pixels,
+                     gsize              *length)
+{
+  guint8   *tile_data;
+  gboolean  nonzero;
+  gboolean  success;
+
+  g_return_val_if_fail (length != NULL, FALSE);
+
+  tile_data = g_malloc ((gsize) babl_format_get_bytes_per_pixel (format) *
+                        n_pixels);
+
+  /* the byte order doesn't affect the length, so skip the conversion */
+  success = xcf_tile_decode_real (compression, 0, format,
+                                  data, data_length, tile_data, n_pixels,
+                                  &nonzero, length);
+
+  g_free (tile_data);
+
+  return success;
+}
+
+/* encodes a single tile into data, which must be large enough to hold
+ * max_data_length bytes.  tile_data holds n_pixels pixels of the given
+ * format, in the native byte order; it is used as scratch space, and its
+ * contents are unspecified upon return.
+ *
+ * returns FALSE if encoding failed, or if the encoded data is longer than
+ * max_data_length.
+ */
+gboolean
+xcf_tile_encode (XcfCompressionType  compression,
+                 gint                file_version,
+                 const Babl         *format,
+                 guint8             *tile_data,
+                 gint                n_pixels,
+                 guint8             *data,
+                 gsize               max_data_length,
+                 gsize              *data_length)
+{
+  gint bpp = babl_format_get_bytes_per_pixel (format);
+
+  g_return_val_if_fail (tile_data != NULL, FALSE);
+  g_return_val_if_fail (data != NULL, FALSE);
+  g_return_val_if_fail (data_length != NULL, FALSE);
+
+  if (file_version >= 12)
+    {
+      gint n_components = babl_format_get_n_components (format);
+
+      xcf_write_to_be (bpp / n_components, tile_data,
+                       n_pixels * n_components);
+    }
+
+  switch (compression)
+    {
+    case COMPRESS_NONE:
+      return xcf_tile_encode_none (tile_data, bpp, n_pixels,
+                                   data, max_data_length, data_length);
+
+    case COMPRESS_RLE:
+      return xcf_tile_encode_rle (tile_data, bpp, n_pixels,
+                                  data, max_data_length, data_length);
+
+    case COMPRESS_ZLIB:
+      return xcf_tile_encode_zlib (tile_data, bpp, n_pixels,
+                                   data, max_data_length, data_length);
+
+    case COMPRESS_ZSTD:
+      return xcf_tile_encode_zstd (tile_data, bpp, n_pixels,
+                                   data, max_data_length, data_length);
+
+    default:
+      return FALSE;
+    }
+}
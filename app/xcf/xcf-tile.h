@@ -0,0 +1,47 @@
+/* GIMP - The GNU Image Manipulation Program
+ * Copyright (C) 1995 Spencer Kimball and Peter Mattis
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __XCF_TILE_H__
+#define __XCF_TILE_H__
+
+
+gboolean   xcf_tile_decode (XcfCompressionType  compression,
+                            gint                file_version,
+                            const Babl         *format,
+                            const guint8       *data,
+                            gsize               data_length,
+                            guint8             *tile_data,
+                            gint                n_pixels,
+                            gboolean           *nonzero);
+gboolean   xcf_tile_get_length
+                           (XcfCompressionType  compression,
+                            const Babl         *format,
+                            const guint8       *data,
+                            gsize               data_length,
+                            gint                n_pixels,
+                            gsize              *length);
+gboolean   xcf_tile_encode (XcfCompressionType  compression,
+                            gint                file_version,
+                            const Babl         *format,
+                            guint8             *tile_data,
+                            gint                n_pixels,
+                            guint8             *data,
+                            gsize               max_data_length,
+                            gsize              *data_length);
+
+
+#endif  /* __XCF_TILE_H__ */
@@ -30,8 +30,11 @@
 #include "core/core-types.h"
 
 #include "core/gimp.h"
+#include "core/gimp-trace.h"
 #include "core/gimpimage.h"
 #include "core/gimpdrawable.h"
+#include "core/gimplayer.h"
+#include "core/gimplayermask.h"
 #include "core/gimpparamspecs.h"
 #include "core/gimpprogress.h"
 
@@ -43,6 +46,9 @@
 #include "xcf-load.h"
 #include "xcf-read.h"
 #include "xcf-save.h"
+#include "xcf-source.h"
+
+#include "gimptilehandlerxcf.h"
 
 #include "gimp-intl.h"
 
@@ -65,6 +71,10 @@ static GimpValueArray * xcf_save_invoker (GimpProcedure         *procedure,
                                           const GimpValueArray  *args,
                                           GError               **error);
 
+static void             xcf_save_stream_attach (XcfInfo         *info);
+static void             xcf_save_load_mapped   (GimpImage       *image,
+                                                GFile           *file);
+
 
 static GimpXcfLoaderFunc * const xcf_loaders[] =
 {
@@ -83,7 +93,8 @@ static GimpXcfLoaderFunc * const xcf_loaders[] =
   xcf_load_image,   /* version 12 */
   xcf_load_image,   /* version 13 */
   xcf_load_image,   /* version 14 */
-  xcf_load_image    /* version 15 */
+  xcf_load_image,   /* version 15 */
+  xcf_load_image    /* version 16 */
 };
 
 
@@ -269,6 +280,8 @@ xcf_load_stream (Gimp          *gimp,
   info.file             = input_file;
   info.compression      = COMPRESS_NONE;
 
+  gimp_trace_begin ("xcf", "load");
+
   if (progress)
     gimp_progress_start (progress, FALSE, _("Opening '%s'"), filename);
 
@@ -297,6 +310,33 @@ xcf_load_stream (Gimp          *gimp,
   if (info.file_version >= 11)
     info.bytes_per_offset = 8;
 
+#ifndef G_OS_WIN32
+  /* map local files into memory, so that the layer buffers can be filled
+   * lazily, as their tiles are accessed, instead of all at once.  not on
+   * windows, where a mapped file can't be replaced or deleted.  the
+   * source file remembers the file's identity, so that in-place
+   * modifications are detected before the mapping is read.
+   */
+  if (success && input_file)
+    {
+      gchar *path = g_file_get_path (input_file);
+
+      if (path)
+        {
+          info.mapped_file = g_mapped_file_new (path, FALSE, NULL);
+
+          if (info.mapped_file)
+            info.source_file = xcf_source_file_new (input_file,
+                                                    info.mapped_file);
+
+          if (! info.source_file)
+            g_clear_pointer (&info.mapped_file, g_mapped_file_unref);
+
+          g_free (path);
+        }
+    }
+#endif
+
   if (success)
     {
       if (info.file_version >= 0 &&
@@ -318,9 +358,14 @@ xcf_load_stream (Gimp          *gimp,
         }
     }
 
+  g_clear_pointer (&info.source_file, xcf_source_file_unref);
+  g_clear_pointer (&info.mapped_file, g_mapped_file_unref);
+
   if (progress)
     gimp_progress_end (progress);
 
+  gimp_trace_end ();
+
   return image;
 }
 
@@ -357,19 +402,44 @@ xcf_save_stream (Gimp           *gimp,
   info.progress         = progress;
   info.file             = output_file;
 
-  if (gimp_image_get_xcf_compression (image))
-    info.compression = COMPRESS_ZLIB;
-  else
+  /* zstd is only used when explicitly requested, since it needs a
+   * newer file version than zlib and a GIMP built with zstd support to
+   * read the file back.
+   */
+  if (! gimp_image_get_xcf_compression (image))
     info.compression = COMPRESS_RLE;
+#ifdef HAVE_ZSTD
+  else if (gimp_image_get_xcf_zstd_compression (image))
+    info.compression = COMPRESS_ZSTD;
+#endif
+  else
+    info.compression = COMPRESS_ZLIB;
 
   info.file_version = gimp_image_get_xcf_version (image,
                                                   info.compression ==
                                                   COMPRESS_ZLIB,
+                                                  info.compression ==
+                                                  COMPRESS_ZSTD,
                                                   NULL, NULL, NULL);
 
   if (info.file_version >= 11)
     info.bytes_per_offset = 8;
 
+#ifndef G_OS_WIN32
+  /* collect the location of the saved tiles, see xcf_save_stream_attach()
+   * below
+   */
+  if (output_file)
+    {
+      info.source_levels = g_hash_table_new_full (
+        NULL, NULL,
+        (GDestroyNotify) g_object_unref,
+        (GDestroyNotify) xcf_source_level_free);
+    }
+#endif
+
+  gimp_trace_begin ("xcf", "save");
+
   if (progress)
     gimp_progress_start (progress, FALSE, _("Saving '%s'"), filename);
 
@@ -399,15 +469,106 @@ xcf_save_stream (Gimp           *gimp,
     g_propagate_prefixed_error (error, my_error,
                                 _("Error writing '%s': "), filename);
 
+  if (success && info.source_levels)
+    xcf_save_stream_attach (&info);
+
+  g_clear_pointer (&info.source_levels, g_hash_table_unref);
+
   if (progress)
     gimp_progress_end (progress);
 
+  gimp_trace_end ();
+
   return success;
 }
 
 
 /*  private functions  */
 
+/* maps the newly-saved file into memory, and attaches the location of the
+ * tiles of each saved buffer to the buffer, so that the next save can copy
+ * the tiles that didn't change from the file, instead of encoding them
+ * again.
+ */
+static void
+xcf_save_stream_attach (XcfInfo *info)
+{
+  GMappedFile    *mapped_file = NULL;
+  XcfSourceFile  *source_file = NULL;
+  gchar          *path;
+  GHashTableIter  iter;
+  gpointer        buffer;
+  gpointer        level;
+
+  path = g_file_get_path (info->file);
+
+  if (path)
+    {
+      mapped_file = g_mapped_file_new (path, FALSE, NULL);
+
+      g_free (path);
+    }
+
+  if (mapped_file)
+    {
+      source_file = xcf_source_file_new (info->file, mapped_file);
+
+      g_mapped_file_unref (mapped_file);
+    }
+
+  if (! source_file)
+    return;
+
+  g_hash_table_iter_init (&iter, info->source_levels);
+
+  while (g_hash_table_iter_next (&iter, &buffer, &level))
+    {
+      g_hash_table_iter_steal (&iter);
+
+      xcf_source_level_attach (level, source_file, buffer);
+
+      g_object_unref (buffer);
+    }
+
+  xcf_source_file_unref (source_file);
+}
+
+/* loads the tiles of all the image's drawables that are still lazily
+ * loaded from file.
+ */
+static void
+xcf_save_load_mapped (GimpImage *image,
+                      GFile     *file)
+{
+  GList *drawables;
+  GList *list;
+
+  drawables = g_list_concat (gimp_image_get_layer_list (image),
+                             gimp_image_get_channel_list (image));
+
+  for (list = drawables; list; list = g_list_next (list))
+    {
+      GimpDrawable *drawable = list->data;
+
+      gimp_tile_handler_xcf_load (gimp_drawable_get_buffer (drawable), file);
+
+      if (GIMP_IS_LAYER (drawable) &&
+          gimp_layer_get_mask (GIMP_LAYER (drawable)))
+        {
+          GimpLayerMask *mask = gimp_layer_get_mask (GIMP_LAYER (drawable));
+
+          gimp_tile_handler_xcf_load (
+            gimp_drawable_get_buffer (GIMP_DRAWABLE (mask)), file);
+        }
+    }
+
+  g_list_free (drawables);
+
+  gimp_tile_handler_xcf_load (
+    gimp_drawable_get_buffer (GIMP_DRAWABLE (gimp_image_get_mask (image))),
+    file);
+}
+
 static GimpValueArray *
 xcf_load_invoker (GimpProcedure         *procedure,
                   Gimp                  *gimp,
@@ -472,6 +633,11 @@ xcf_save_invoker (GimpProcedure         *procedure,
   image = g_value_get_object (gimp_value_array_index (args, 1));
   file  = g_value_get_object (gimp_value_array_index (args, 4));
 
+  /* g_file_replace() may write to the existing file in place, so make
+   * sure no tile is still to be read from it.
+   */
+  xcf_save_load_mapped (image, file);
+
   output = G_OUTPUT_STREAM (g_file_replace (file,
                                             NULL, FALSE, G_FILE_CREATE_NONE,
                                             NULL, &my_error));
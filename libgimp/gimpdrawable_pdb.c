@@ -816,6 +816,124 @@ gimp_drawable_set_pixel (GimpDrawable *drawable,
   return success;
 }
 
+/**
+ * gimp_drawable_get_pixels:
+ * @drawable: The drawable.
+ * @x: x coordinate of upper left corner of the rectangle.
+ * @y: y coordinate of upper left corner of the rectangle.
+ * @width: Width of the rectangle.
+ * @height: Height of the rectangle.
+ * @num_bytes: (out): The number of bytes of pixel data.
+ *
+ * Gets the pixel values of a rectangle of the drawable.
+ *
+ * This procedure gets the pixel values of the specified rectangle, in
+ * the drawable's format, row by row without padding. The rectangle
+ * must lie within the drawable. Use this procedure instead of
+ * gimp_drawable_get_pixel() when reading more than a few pixels.
+ *
+ * Returns: (array length=num_bytes) (element-type guint8) (transfer full):
+ *          The pixel values.
+ *          The returned value must be freed with g_free().
+ *
+ * Since: 3.0
+ **/
+guint8 *
+gimp_drawable_get_pixels (GimpDrawable *drawable,
+                          gint          x,
+                          gint          y,
+                          gint          width,
+                          gint          height,
+                          gint         *num_bytes)
+{
+  GimpValueArray *args;
+  GimpValueArray *return_vals;
+  guint8 *pixels = NULL;
+
+  args = gimp_value_array_new_from_types (NULL,
+                                          GIMP_TYPE_DRAWABLE, drawable,
+                                          G_TYPE_INT, x,
+                                          G_TYPE_INT, y,
+                                          G_TYPE_INT, width,
+                                          G_TYPE_INT, height,
+                                          G_TYPE_NONE);
+
+  return_vals = gimp_pdb_run_procedure_array (gimp_get_pdb (),
+                                              "gimp-drawable-get-pixels",
+                                              args);
+  gimp_value_array_unref (args);
+
+  *num_bytes = 0;
+
+  if (GIMP_VALUES_GET_ENUM (return_vals, 0) == GIMP_PDB_SUCCESS)
+    {
+      *num_bytes = GIMP_VALUES_GET_INT (return_vals, 1);
+      pixels = GIMP_VALUES_DUP_UINT8_ARRAY (return_vals, 2);
+    }
+
+  gimp_value_array_unref (return_vals);
+
+  return pixels;
+}
+
+/**
+ * gimp_drawable_set_pixels:
+ * @drawable: The drawable.
+ * @x: x coordinate of upper left corner of the rectangle.
+ * @y: y coordinate of upper left corner of the rectangle.
+ * @width: Width of the rectangle.
+ * @height: Height of the rectangle.
+ * @num_bytes: The number of bytes of pixel data.
+ * @pixels: (array length=num_bytes) (element-type guint8): The pixel values.
+ *
+ * Sets the pixel values of a rectangle of the drawable.
+ *
+ * This procedure sets the pixel values of the specified rectangle, in
+ * the drawable's format, row by row without padding. The rectangle
+ * must lie within the drawable and 'num_bytes' must be equal to the
+ * size of its pixel data. Note that this function is not undoable, you
+ * should use it only on drawables you just created yourself.
+ *
+ * Returns: TRUE on success.
+ *
+ * Since: 3.0
+ **/
+gboolean
+gimp_drawable_set_pixels (GimpDrawable *drawable,
+                          gint          x,
+                          gint          y,
+                          gint          width,
+                          gint          height,
+                          gint          num_bytes,
+                          const guint8 *pixels)
+{
+  GimpValueArray *args;
+  GimpValueArray *return_vals;
+  gboolean success = TRUE;
+
+  args = gimp_value_array_new_from_types (NULL,
+                                          GIMP_TYPE_DRAWABLE, drawable,
+                                          G_TYPE_INT, x,
+                                          G_TYPE_INT, y,
+                                          G_TYPE_INT, width,
+                                          G_TYPE_INT, height,
+                                          G_TYPE_INT, num_bytes,
+                                          GIMP_TYPE_UINT8_ARRAY, NULL,
+                                          G_TYPE_NONE);
+  gimp_value_set_uint8_array (gimp_value_array_index (args, 6), pixels, num_bytes);
+
+  return_vals = gimp_pdb_run_procedure_array (gimp_get_pdb (),
+                                              "gimp-drawable-set-pixels",
+                                              args);
+  gimp_value_array_unref (args);
+
+  success = GIMP_VALUES_GET_ENUM (return_vals, 0) == GIMP_PDB_SUCCESS;
+
+  gimp_value_array_unref (return_vals);
+
+  return success;
+}
+
 /**
  * gimp_drawable_fill:
  * @drawable: The drawable.
@@ -73,6 +73,19 @@ gboolean                 gimp_drawable_set_pixel             (GimpDrawable
                                                               gint                        y_coord,
                                                               gint                        num_channels,
                                                               const guint8               *pixel);
+guint8*                  gimp_drawable_get_pixels            (GimpDrawable               *drawable,
+                                                              gint                        x,
+                                                              gint                        y,
+                                                              gint                        width,
+                                                              gint                        height,
+                                                              gint                       *num_bytes);
+gboolean                 gimp_drawable_set_pixels            (GimpDrawable               *drawable,
+                                                              gint                        x,
+                                                              gint                        y,
+                                                              gint                        width,
+                                                              gint                        height,
+                                                              gint                        num_bytes,
+                                                              const guint8               *pixels);
 gboolean                 gimp_drawable_fill                  (GimpDrawable               *drawable,
                                                               GimpFillType                fill_type);
 gboolean                 gimp_drawable_offset                (GimpDrawable               *drawable,
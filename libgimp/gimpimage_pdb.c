@@ -967,9 +967,9 @@ gimp_image_remove_layer (GimpImage *image,
  * Freeze the image's layer list.
  *
  * This procedure freezes the layer list of the image, suppressing any
- * updates to the Layers dialog in response to changes to the image's
- * layers. This can significantly improve performance while applying
- * changes affecting the layer list.
+ * updates to the Layers dialog and to the image's preview in response
+ * to changes to the image's layers. This can significantly improve
+ * performance while applying changes affecting the layer list.
  *
  * Each call to gimp_image_freeze_layers() should be matched by a
  * corresponding call to gimp_image_thaw_layers(), undoing its effects.
@@ -1008,7 +1008,7 @@ gimp_image_freeze_layers (GimpImage *image)
  * Thaw the image's layer list.
  *
  * This procedure thaws the layer list of the image, re-enabling
- * updates to the Layers dialog.
+ * updates to the Layers dialog and to the image's preview.
  *
  * This procedure should match a corresponding call to
  * gimp_image_freeze_layers().
@@ -367,6 +367,107 @@ gimp_pdb_run_procedure_array (GimpPDB              *pdb,
   return return_values;
 }
 
+/**
+ * gimp_pdb_run_procedure_batch:
+ * @pdb:             the #GimpPDB object.
+ * @procedure_names: (array length=n_procedures): the procedures' registered
+ *                   names.
+ * @arguments:       (array length=n_procedures): the call arguments of each
+ *                   procedure.
+ * @n_procedures:    the number of procedures to run.
+ *
+ * Runs the procedures named in @procedure_names in order, each one with
+ * the corresponding element of @arguments, using a single round trip to
+ * the core instead of one per procedure.
+ *
+ * The batch stops at the first procedure that doesn't return
+ * %GIMP_PDB_SUCCESS; the procedures following it are not run.  The
+ * returned array therefore holds the return values of the procedures
+ * that were run, the last one being the failing procedure's, if any.
+ * The error message of the last procedure run is available through
+ * gimp_pdb_get_last_error().
+ *
+ * Returns: (array zero-terminated=1) (transfer full): the %NULL-terminated
+ *          return values of the procedure calls.  Free each element with
+ *          gimp_value_array_unref() and the array with g_free().
+ *
+ * Since: 3.0
+ */
+GimpValueArray **
+gimp_pdb_run_procedure_batch (GimpPDB             *pdb,
+                              const gchar * const *procedure_names,
+                              GimpValueArray     **arguments,
+                              gint                 n_procedures)
+{
+  GPProcRunBatch     proc_run_batch;
+  GPProcReturnBatch *proc_return_batch;
+  GimpWireMessage    msg;
+  GimpValueArray   **return_values;
+  gint               n_return_values;
+  gint               i;
+
+  g_return_val_if_fail (GIMP_IS_PDB (pdb), NULL);
+  g_return_val_if_fail (n_procedures >= 0, NULL);
+  g_return_val_if_fail (procedure_names != NULL || n_procedures == 0, NULL);
+  g_return_val_if_fail (arguments != NULL || n_procedures == 0, NULL);
+
+  for (i = 0; i < n_procedures; i++)
+    {
+      g_return_val_if_fail (gimp_is_canonical_identifier (procedure_names[i]),
+                            NULL);
+      g_return_val_if_fail (arguments[i] != NULL, NULL);
+    }
+
+  proc_run_batch.n_procs = n_procedures;
+  proc_run_batch.procs   = g_new0 (GPProcRun, n_procedures);
+
+  for (i = 0; i < n_procedures; i++)
+    {
+      GPProcRun *proc_run = &proc_run_batch.procs[i];
+
+      proc_run->name     = (gchar *) procedure_names[i];
+      proc_run->n_params = gimp_value_array_length (arguments[i]);
+      proc_run->params   = _gimp_value_array_to_gp_params (arguments[i], FALSE);
+    }
+
+  if (! gp_proc_run_batch_write (_gimp_plug_in_get_write_channel (pdb->priv->plug_in),
+                                 &proc_run_batch, pdb->priv->plug_in))
+    gimp_quit ();
+
+  for (i = 0; i < n_procedures; i++)
+    _gimp_gp_params_free (proc_run_batch.procs[i].params,
+                          proc_run_batch.procs[i].n_params, FALSE);
+
+  g_free (proc_run_batch.procs);
+
+  _gimp_plug_in_read_expect_msg (pdb->priv->plug_in, &msg,
+                                 GP_PROC_RETURN_BATCH);
+
+  proc_return_batch = msg.data;
+
+  n_return_values = MIN (proc_return_batch->n_procs, n_procedures);
+
+  return_values = g_new0 (GimpValueArray *, n_return_values + 1);
+
+  for (i = 0; i < n_return_values; i++)
+    {
+      GPProcReturn *proc_return = &proc_return_batch->procs[i];
+
+      return_values[i] = _gimp_gp_params_to_value_array (NULL,
+                                                         NULL, 0,
+                                                         proc_return->params,
+                                                         proc_return->n_params,
+                                                         TRUE);
+    }
+
+  gimp_wire_destroy (&msg);
+
+  if (n_return_values > 0)
+    gimp_pdb_set_error (pdb, return_values[n_return_values - 1]);
+
+  return return_values;
+}
+
 /**
  * gimp_pdb_temp_procedure_name:
  * @pdb: the #GimpPDB object.
@@ -88,6 +88,10 @@ GimpValueArray * gimp_pdb_run_procedure_argv   (GimpPDB              *pdb,
 GimpValueArray * gimp_pdb_run_procedure_array  (GimpPDB              *pdb,
                                                 const gchar          *procedure_name,
                                                 const GimpValueArray *arguments);
+GimpValueArray ** gimp_pdb_run_procedure_batch (GimpPDB              *pdb,
+                                                const gchar * const  *procedure_names,
+                                                GimpValueArray      **arguments,
+                                                gint                  n_procedures);
 
 gchar          * gimp_pdb_temp_procedure_name  (GimpPDB              *pdb);
 
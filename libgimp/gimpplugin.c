@@ -104,7 +104,7 @@
  **/
 
 
-#define WRITE_BUFFER_SIZE 1024
+#define WRITE_BUFFER_SIZE 8192
 
 /**
  * gimp_plug_in_error_quark:
@@ -145,6 +145,8 @@ struct _GimpPlugInPrivate
 
   guint       extension_source_id;
 
+  gboolean    resident;
+
   gchar      *translation_domain_name;
   GFile      *translation_domain_path;
 
@@ -183,6 +185,9 @@ static gboolean   gimp_plug_in_write             (GIOChannel      *channel,
                                                   gpointer         user_data);
 static gboolean   gimp_plug_in_flush             (GIOChannel      *channel,
                                                   gpointer         user_data);
+static gboolean   gimp_plug_in_write_chars       (GIOChannel      *channel,
+                                                  const gchar     *buf,
+                                                  gsize            count);
 static gboolean   gimp_plug_in_io_error_handler  (GIOChannel      *channel,
                                                   GIOCondition     cond,
                                                   gpointer         data);
@@ -959,6 +964,15 @@ gimp_plug_in_write (GIOChannel   *channel,
 {
   GimpPlugIn *plug_in = user_data;
 
+  /*  write large payloads directly, see the core's gimp_plug_in_write()  */
+  if (count >= WRITE_BUFFER_SIZE)
+    {
+      if (! gimp_wire_flush (channel, plug_in))
+        return FALSE;
+
+      return gimp_plug_in_write_chars (channel, (const gchar *) buf, count);
+    }
+
   while (count > 0)
     {
       gulong bytes;
@@ -996,45 +1010,56 @@ gimp_plug_in_flush (GIOChannel *channel,
 
   if (plug_in->priv->write_buffer_index > 0)
     {
-      gsize count = 0;
+      if (! gimp_plug_in_write_chars (channel,
+                                      plug_in->priv->write_buffer,
+                                      plug_in->priv->write_buffer_index))
+        return FALSE;
+
+      plug_in->priv->write_buffer_index = 0;
+    }
 
-      while (count != plug_in->priv->write_buffer_index)
+  return TRUE;
+}
+
+static gboolean
+gimp_plug_in_write_chars (GIOChannel  *channel,
+                          const gchar *buf,
+                          gsize        count)
+{
+  while (count > 0)
+    {
+      GIOStatus status;
+      gsize     bytes;
+      GError   *error = NULL;
+
+      do
         {
-          GIOStatus status;
-          gsize     bytes;
-          GError   *error = NULL;
+          bytes = 0;
+          status = g_io_channel_write_chars (channel,
+                                             buf, count,
+                                             &bytes,
+                                             &error);
+        }
+      while (status == G_IO_STATUS_AGAIN);
 
-          do
+      if (status != G_IO_STATUS_NORMAL)
+        {
+          if (error)
             {
-              bytes = 0;
-              status = g_io_channel_write_chars (channel,
-                                                 &plug_in->priv->write_buffer[count],
-                                                 (plug_in->priv->write_buffer_index - count),
-                                                 &bytes,
-                                                 &error);
+              g_warning ("%s: gimp_flush(): error: %s",
+                         g_get_prgname (), error->message);
+              g_error_free (error);
             }
-          while (status == G_IO_STATUS_AGAIN);
-
-          if (status != G_IO_STATUS_NORMAL)
+          else
             {
-              if (error)
-                {
-                  g_warning ("%s: gimp_flush(): error: %s",
-                             g_get_prgname (), error->message);
-                  g_error_free (error);
-                }
-              else
-                {
-                  g_warning ("%s: gimp_flush(): error", g_get_prgname ());
-                }
-
-              return FALSE;
+              g_warning ("%s: gimp_flush(): error", g_get_prgname ());
             }
 
-          count += bytes;
+          return FALSE;
         }
 
-      plug_in->priv->write_buffer_index = 0;
+      buf   += bytes;
+      count -= bytes;
     }
 
   return TRUE;
@@ -1070,6 +1095,8 @@ gimp_plug_in_loop (GimpPlugIn *plug_in)
 
         case GP_CONFIG:
           _gimp_config (msg.data);
+
+          plug_in->priv->resident = ((GPConfig *) msg.data)->resident;
           break;
 
         case GP_TILE_REQ:
@@ -1080,6 +1107,13 @@ gimp_plug_in_loop (GimpPlugIn *plug_in)
 
         case GP_PROC_RUN:
           gimp_plug_in_proc_run (plug_in, msg.data);
+
+          /*  a resident plug-in is kept alive by the core to run more
+           *  procedures, until it is sent GP_QUIT
+           */
+          if (plug_in->priv->resident)
+            break;
+
           gimp_wire_destroy (&msg);
           return;
 
@@ -1102,6 +1136,11 @@ gimp_plug_in_loop (GimpPlugIn *plug_in)
         case GP_HAS_INIT:
           g_warning ("unexpected has init message received (should not happen)");
           break;
+
+        case GP_PROC_RUN_BATCH:
+        case GP_PROC_RETURN_BATCH:
+          g_warning ("unexpected proc batch message received (should not happen)");
+          break;
         }
 
       gimp_wire_destroy (&msg);
@@ -1157,6 +1196,10 @@ gimp_plug_in_process_message (GimpPlugIn      *plug_in,
     case GP_HAS_INIT:
       g_warning ("unexpected has init message received (should not happen)");
       break;
+    case GP_PROC_RUN_BATCH:
+    case GP_PROC_RETURN_BATCH:
+      g_warning ("unexpected proc batch message received (should not happen)");
+      break;
     }
 }
 
@@ -85,9 +85,19 @@ static gboolean   gimp_tile_init  (GimpTileBackendPlugin *backend_plugin,
 static void       gimp_tile_unset (GimpTileBackendPlugin *backend_plugin,
                                    GimpTile              *tile);
 static void       gimp_tile_get   (GimpTileBackendPlugin *backend_plugin,
-                                   GimpTile              *tile);
+                                   GimpTile              *tile,
+                                   guchar                *dest,
+                                   gint                   dest_stride);
 static void       gimp_tile_put   (GimpTileBackendPlugin *backend_plugin,
-                                   GimpTile              *tile);
+                                   GimpTile              *tile,
+                                   const guchar          *src,
+                                   gint                   src_stride);
+static void       gimp_tile_copy  (const guchar          *src,
+                                   gint                   src_stride,
+                                   guchar                *dest,
+                                   gint                   dest_stride,
+                                   gint                   row_size,
+                                   gint                   n_rows);
 
 
 G_DEFINE_TYPE_WITH_PRIVATE (GimpTileBackendPlugin, _gimp_tile_backend_plugin,
@@ -215,34 +225,15 @@ gimp_tile_read (GimpTileBackendPlugin *backend_plugin,
   GeglTile                     *tile;
   GimpTile                      gimp_tile = { 0, };
   gint                          tile_size;
-  guchar                       *tile_data;
 
   if (! gimp_tile_init (backend_plugin, &gimp_tile, y, x))
     return NULL;
 
   tile_size  = gegl_tile_backend_get_tile_size (backend);
   tile       = gegl_tile_new (tile_size);
-  tile_data  = gegl_tile_get_data (tile);
 
-  gimp_tile_get (backend_plugin, &gimp_tile);
-
-  if (gimp_tile.ewidth * gimp_tile.eheight * priv->bpp == tile_size)
-    {
-      memcpy (tile_data, gimp_tile.data, tile_size);
-    }
-  else
-    {
-      gint  tile_stride      = TILE_WIDTH * priv->bpp;
-      gint  gimp_tile_stride = gimp_tile.ewidth * priv->bpp;
-      guint row;
-
-      for (row = 0; row < gimp_tile.eheight; row++)
-        {
-          memcpy (tile_data      + row * tile_stride,
-                  gimp_tile.data + row * gimp_tile_stride,
-                  gimp_tile_stride);
-        }
-    }
+  gimp_tile_get (backend_plugin, &gimp_tile,
+                 gegl_tile_get_data (tile), TILE_WIDTH * priv->bpp);
 
   gimp_tile_unset (backend_plugin, &gimp_tile);
 
@@ -256,40 +247,14 @@ gimp_tile_write (GimpTileBackendPlugin *backend_plugin,
                  GeglTile              *tile)
 {
   GimpTileBackendPluginPrivate *priv      = backend_plugin->priv;
-  GeglTileBackend              *backend   = GEGL_TILE_BACKEND (backend_plugin);
   GimpTile                      gimp_tile = { 0, };
-  gint                          tile_size;
-  guchar                       *tile_data;
 
   if (! gimp_tile_init (backend_plugin, &gimp_tile, y, x))
     return FALSE;
 
-  tile_size = gegl_tile_backend_get_tile_size (backend);
-  tile_data = gegl_tile_get_data (tile);
-
-  gimp_tile.data = g_new (guchar,
-                          gimp_tile.ewidth * gimp_tile.eheight *
-                          priv->bpp);
+  gimp_tile_put (backend_plugin, &gimp_tile,
+                 gegl_tile_get_data (tile), TILE_WIDTH * priv->bpp);
 
-  if (gimp_tile.ewidth * gimp_tile.eheight * priv->bpp == tile_size)
-    {
-      memcpy (gimp_tile.data, tile_data, tile_size);
-    }
-  else
-    {
-      gint  tile_stride      = TILE_WIDTH * priv->bpp;
-      gint  gimp_tile_stride = gimp_tile.ewidth * priv->bpp;
-      guint row;
-
-      for (row = 0; row < gimp_tile.eheight; row++)
-        {
-          memcpy (gimp_tile.data + row * gimp_tile_stride,
-                  tile_data      + row * tile_stride,
-                  gimp_tile_stride);
-        }
-    }
-
-  gimp_tile_put (backend_plugin, &gimp_tile);
   gimp_tile_unset (backend_plugin, &gimp_tile);
 
   return TRUE;
@@ -335,7 +300,9 @@ gimp_tile_unset (GimpTileBackendPlugin *backend_plugin,
 
 static void
 gimp_tile_get (GimpTileBackendPlugin *backend_plugin,
-               GimpTile              *tile)
+               GimpTile              *tile,
+               guchar                *dest,
+               gint                   dest_stride)
 {
   GimpTileBackendPluginPrivate *priv    = backend_plugin->priv;
   GimpPlugIn                   *plug_in = gimp_get_plug_in ();
@@ -381,16 +348,13 @@ gimp_tile_get (GimpTileBackendPlugin *backend_plugin,
       gimp_quit ();
     }
 
-  if (tile_data->use_shm)
-    {
-      tile->data = g_memdup2 (_gimp_shm_addr (),
-                              tile->ewidth * tile->eheight * priv->bpp);
-    }
-  else
-    {
-      tile->data = tile_data->data;
-      tile_data->data = NULL;
-    }
+  /* copy the tile straight from the message, or from shared memory, to
+   * its destination
+   */
+  gimp_tile_copy (tile_data->use_shm ? _gimp_shm_addr () : tile_data->data,
+                  tile->ewidth * priv->bpp,
+                  dest, dest_stride,
+                  tile->ewidth * priv->bpp, tile->eheight);
 
   if (! gp_tile_ack_write (_gimp_plug_in_get_write_channel (plug_in),
                            plug_in))
@@ -401,44 +365,48 @@ gimp_tile_get (GimpTileBackendPlugin *backend_plugin,
 
 static void
 gimp_tile_put (GimpTileBackendPlugin *backend_plugin,
-               GimpTile              *tile)
+               GimpTile              *tile,
+               const guchar          *src,
+               gint                   src_stride)
 {
-  GimpTileBackendPluginPrivate *priv    = backend_plugin->priv;
-  GimpPlugIn                   *plug_in = gimp_get_plug_in ();
-  GPTileReq                     tile_req;
+  GimpTileBackendPluginPrivate *priv     = backend_plugin->priv;
+  GimpPlugIn                   *plug_in  = gimp_get_plug_in ();
+  gint                          row_size = tile->ewidth * priv->bpp;
   GPTileData                    tile_data;
-  GPTileData                   *tile_info;
   GimpWireMessage               msg;
 
-  tile_req.drawable_id = -1;
-  tile_req.tile_num    = 0;
-  tile_req.shadow      = 0;
-
-  if (! gp_tile_req_write (_gimp_plug_in_get_write_channel (plug_in),
-                           &tile_req, plug_in))
-    gimp_quit ();
-
-  _gimp_plug_in_read_expect_msg (plug_in, &msg, GP_TILE_DATA);
-
-  tile_info = msg.data;
-
   tile_data.drawable_id = priv->drawable_id;
   tile_data.tile_num    = tile->tile_num;
   tile_data.shadow      = priv->shadow;
   tile_data.bpp         = priv->bpp;
   tile_data.width       = tile->ewidth;
   tile_data.height      = tile->eheight;
-  tile_data.use_shm     = tile_info->use_shm;
+  tile_data.use_shm     = (_gimp_shm_addr () != NULL);
   tile_data.data        = NULL;
 
-  if (tile_info->use_shm)
+  /* the core is waiting for the tile's pixels in shared memory, if it's
+   * used, right after the TILE_DATA message; otherwise, send them along
+   * with the message, without copying whole-width tiles, which are
+   * already contiguous.
+   */
+  if (tile_data.use_shm)
     {
-      memcpy (_gimp_shm_addr (),
-              tile->data,
-              tile->ewidth * tile->eheight * priv->bpp);
+      gimp_tile_copy (src, src_stride,
+                      _gimp_shm_addr (), row_size,
+                      row_size, tile->eheight);
+    }
+  else if (src_stride == row_size)
+    {
+      tile_data.data = (guchar *) src;
     }
   else
     {
+      tile->data = g_new (guchar, row_size * tile->eheight);
+
+      gimp_tile_copy (src, src_stride,
+                      tile->data, row_size,
+                      row_size, tile->eheight);
+
       tile_data.data = tile->data;
     }
 
@@ -446,12 +414,32 @@ gimp_tile_put (GimpTileBackendPlugin *backend_plugin,
                             &tile_data, plug_in))
     gimp_quit ();
 
-  if (! tile_info->use_shm)
-    tile_data.data = NULL;
+  _gimp_plug_in_read_expect_msg (plug_in, &msg, GP_TILE_ACK);
 
   gimp_wire_destroy (&msg);
+}
 
-  _gimp_plug_in_read_expect_msg (plug_in, &msg, GP_TILE_ACK);
+static void
+gimp_tile_copy (const guchar *src,
+                gint          src_stride,
+                guchar       *dest,
+                gint          dest_stride,
+                gint          row_size,
+                gint          n_rows)
+{
+  if (src_stride == row_size && dest_stride == row_size)
+    {
+      memcpy (dest, src, row_size * n_rows);
+    }
+  else
+    {
+      gint row;
 
-  gimp_wire_destroy (&msg);
+      for (row = 0; row < n_rows; row++)
+        {
+          memcpy (dest + row * dest_stride,
+                  src  + row * src_stride,
+                  row_size);
+        }
+    }
 }
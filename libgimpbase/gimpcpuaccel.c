@@ -128,9 +128,21 @@ enum
   ARCH_X86_INTEL_FEATURE_SSSE3    = 1 << 9,
   ARCH_X86_INTEL_FEATURE_SSE4_1   = 1 << 19,
   ARCH_X86_INTEL_FEATURE_SSE4_2   = 1 << 20,
+  ARCH_X86_INTEL_FEATURE_OSXSAVE  = 1 << 27,
   ARCH_X86_INTEL_FEATURE_AVX      = 1 << 28
 };
 
+enum
+{
+  ARCH_X86_INTEL_FEATURE_AVX2     = 1 << 5
+};
+
+enum
+{
+  ARCH_X86_XCR0_SSE               = 1 << 1,
+  ARCH_X86_XCR0_AVX               = 1 << 2
+};
+
 #if !defined(ARCH_X86_64) && (defined(PIC) || defined(__PIC__))
 #define cpuid(op,eax,ebx,ecx,edx)  \
   __asm__ ("movl %%ebx, %%esi\n\t" \
@@ -141,6 +153,16 @@ enum
              "=c" (ecx),           \
              "=d" (edx)            \
            : "0" (op))
+#define cpuid_count(op,count,eax,ebx,ecx,edx) \
+  __asm__ ("movl %%ebx, %%esi\n\t"     \
+           "cpuid\n\t"                 \
+           "xchgl %%ebx,%%esi"         \
+           : "=a" (eax),               \
+             "=S" (ebx),               \
+             "=c" (ecx),               \
+             "=d" (edx)                \
+           : "0" (op),                 \
+             "2" (count))
 #else
 #define cpuid(op,eax,ebx,ecx,edx)  \
   __asm__ ("cpuid"                 \
@@ -149,8 +171,25 @@ enum
              "=c" (ecx),           \
              "=d" (edx)            \
            : "0" (op))
+#define cpuid_count(op,count,eax,ebx,ecx,edx) \
+  __asm__ ("cpuid"                     \
+           : "=a" (eax),               \
+             "=b" (ebx),               \
+             "=c" (ecx),               \
+             "=d" (edx)                \
+           : "0" (op),                 \
+             "2" (count))
 #endif
 
+/* reads the XCR0 register, which tells which register sets are saved by
+ * the OS on context switches.  must only be called if OSXSAVE is set.
+ */
+#define xgetbv0(eax,edx)           \
+  __asm__ (".byte 0x0f, 0x01, 0xd0" \
+           : "=a" (eax),           \
+             "=d" (edx)            \
+           : "c" (0))
+
 
 static X86Vendor
 arch_get_vendor (void)
@@ -266,6 +305,31 @@ arch_accel_intel (void)
 
     if (ecx & ARCH_X86_INTEL_FEATURE_AVX)
       caps |= GIMP_CPU_ACCEL_X86_AVX;
+
+    /* AVX2 operates on the ymm registers, which are only usable if the OS
+     * saves them on context switches.
+     */
+    if ((ecx & ARCH_X86_INTEL_FEATURE_AVX) &&
+        (ecx & ARCH_X86_INTEL_FEATURE_OSXSAVE))
+      {
+        guint32 xcr0_eax, xcr0_edx;
+
+        xgetbv0 (xcr0_eax, xcr0_edx);
+
+        if ((xcr0_eax & (ARCH_X86_XCR0_SSE | ARCH_X86_XCR0_AVX)) ==
+            (ARCH_X86_XCR0_SSE | ARCH_X86_XCR0_AVX))
+          {
+            cpuid (0, eax, ebx, ecx, edx);
+
+            if (eax >= 7)
+              {
+                cpuid_count (7, 0, eax, ebx, ecx, edx);
+
+                if (ebx & ARCH_X86_INTEL_FEATURE_AVX2)
+                  caps |= GIMP_CPU_ACCEL_X86_AVX2;
+              }
+          }
+      }
 #endif /* USE_SSE */
   }
 #endif /* USE_MMX */
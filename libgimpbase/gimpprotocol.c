@@ -144,6 +144,22 @@ static void _gp_has_init_write           (GIOChannel       *channel,
                                           gpointer          user_data);
 static void _gp_has_init_destroy         (GimpWireMessage  *msg);
 
+static void _gp_proc_run_batch_read      (GIOChannel       *channel,
+                                          GimpWireMessage  *msg,
+                                          gpointer          user_data);
+static void _gp_proc_run_batch_write     (GIOChannel       *channel,
+                                          GimpWireMessage  *msg,
+                                          gpointer          user_data);
+static void _gp_proc_run_batch_destroy   (GimpWireMessage  *msg);
+
+static void _gp_proc_return_batch_read   (GIOChannel       *channel,
+                                          GimpWireMessage  *msg,
+                                          gpointer          user_data);
+static void _gp_proc_return_batch_write  (GIOChannel       *channel,
+                                          GimpWireMessage  *msg,
+                                          gpointer          user_data);
+static void _gp_proc_return_batch_destroy (GimpWireMessage *msg);
+
 
 
 void
@@ -201,6 +217,14 @@ gp_init (void)
                       _gp_has_init_read,
                       _gp_has_init_write,
                       _gp_has_init_destroy);
+  gimp_wire_register (GP_PROC_RUN_BATCH,
+                      _gp_proc_run_batch_read,
+                      _gp_proc_run_batch_write,
+                      _gp_proc_run_batch_destroy);
+  gimp_wire_register (GP_PROC_RETURN_BATCH,
+                      _gp_proc_return_batch_read,
+                      _gp_proc_return_batch_write,
+                      _gp_proc_return_batch_destroy);
 }
 
 /* public writing API */
@@ -448,6 +472,44 @@ gp_has_init_write (GIOChannel *channel,
   return TRUE;
 }
 
+gboolean
+gp_proc_run_batch_write (GIOChannel     *channel,
+                         GPProcRunBatch *proc_run_batch,
+                         gpointer        user_data)
+{
+  GimpWireMessage msg;
+
+  msg.type = GP_PROC_RUN_BATCH;
+  msg.data = proc_run_batch;
+
+  if (! gimp_wire_write_msg (channel, &msg, user_data))
+    return FALSE;
+
+  if (! gimp_wire_flush (channel, user_data))
+    return FALSE;
+
+  return TRUE;
+}
+
+gboolean
+gp_proc_return_batch_write (GIOChannel        *channel,
+                            GPProcReturnBatch *proc_return_batch,
+                            gpointer           user_data)
+{
+  GimpWireMessage msg;
+
+  msg.type = GP_PROC_RETURN_BATCH;
+  msg.data = proc_return_batch;
+
+  if (! gimp_wire_write_msg (channel, &msg, user_data))
+    return FALSE;
+
+  if (! gimp_wire_flush (channel, user_data))
+    return FALSE;
+
+  return TRUE;
+}
+
 /*  quit  */
 
 static void
@@ -562,6 +624,9 @@ _gp_config_read (GIOChannel      *channel,
                                (guint32 *) &config->num_processors, 1,
                                user_data))
     goto cleanup;
+  if (! _gimp_wire_read_int8 (channel,
+                              (guint8 *) &config->resident, 1, user_data))
+    goto cleanup;
 
   msg->data = config;
   return;
@@ -670,6 +735,10 @@ _gp_config_write (GIOChannel      *channel,
                                 (const guint32 *) &config->num_processors, 1,
                                 user_data))
     return;
+  if (! _gimp_wire_write_int8 (channel,
+                               (const guint8 *) &config->resident, 1,
+                               user_data))
+    return;
 }
 
 static void
@@ -1937,3 +2006,204 @@ static void
 _gp_has_init_destroy (GimpWireMessage *msg)
 {
 }
+
+/*  proc_run_batch  */
+
+static void
+_gp_proc_run_batch_read (GIOChannel      *channel,
+                         GimpWireMessage *msg,
+                         gpointer         user_data)
+{
+  GPProcRunBatch *proc_run_batch = g_slice_new0 (GPProcRunBatch);
+  guint           i;
+
+  if (! _gimp_wire_read_int32 (channel,
+                               &proc_run_batch->n_procs, 1, user_data))
+    goto cleanup;
+
+  if (proc_run_batch->n_procs > 0)
+    {
+      proc_run_batch->procs = g_try_new0 (GPProcRun,
+                                          proc_run_batch->n_procs);
+
+      /* same as in _gp_params_read(), a bogus count is a plug-in error */
+      if (! proc_run_batch->procs)
+        {
+          g_printerr ("%s: failed to allocate %u procedure calls\n",
+                      G_STRFUNC, proc_run_batch->n_procs);
+          goto cleanup;
+        }
+    }
+
+  for (i = 0; i < proc_run_batch->n_procs; i++)
+    {
+      GPProcRun *proc_run = &proc_run_batch->procs[i];
+
+      if (! _gimp_wire_read_string (channel, &proc_run->name, 1, user_data))
+        {
+          proc_run_batch->n_procs = i;
+          msg->data = proc_run_batch;
+          _gp_proc_run_batch_destroy (msg);
+          msg->data = NULL;
+          return;
+        }
+
+      _gp_params_read (channel,
+                       &proc_run->params, (guint *) &proc_run->n_params,
+                       user_data);
+    }
+
+  msg->data = proc_run_batch;
+  return;
+
+ cleanup:
+  g_slice_free (GPProcRunBatch, proc_run_batch);
+  msg->data = NULL;
+}
+
+static void
+_gp_proc_run_batch_write (GIOChannel      *channel,
+                          GimpWireMessage *msg,
+                          gpointer         user_data)
+{
+  GPProcRunBatch *proc_run_batch = msg->data;
+  guint           i;
+
+  if (! _gimp_wire_write_int32 (channel,
+                                &proc_run_batch->n_procs, 1, user_data))
+    return;
+
+  for (i = 0; i < proc_run_batch->n_procs; i++)
+    {
+      GPProcRun *proc_run = &proc_run_batch->procs[i];
+
+      if (! _gimp_wire_write_string (channel, &proc_run->name, 1, user_data))
+        return;
+
+      _gp_params_write (channel,
+                        proc_run->params, proc_run->n_params, user_data);
+    }
+}
+
+static void
+_gp_proc_run_batch_destroy (GimpWireMessage *msg)
+{
+  GPProcRunBatch *proc_run_batch = msg->data;
+
+  if (proc_run_batch)
+    {
+      guint i;
+
+      for (i = 0; i < proc_run_batch->n_procs; i++)
+        {
+          _gp_params_destroy (proc_run_batch->procs[i].params,
+                              proc_run_batch->procs[i].n_params);
+
+          g_free (proc_run_batch->procs[i].name);
+        }
+
+      g_free (proc_run_batch->procs);
+      g_slice_free (GPProcRunBatch, proc_run_batch);
+    }
+}
+
+/*  proc_return_batch  */
+
+static void
+_gp_proc_return_batch_read (GIOChannel      *channel,
+                            GimpWireMessage *msg,
+                            gpointer         user_data)
+{
+  GPProcReturnBatch *proc_return_batch = g_slice_new0 (GPProcReturnBatch);
+  guint              i;
+
+  if (! _gimp_wire_read_int32 (channel,
+                               &proc_return_batch->n_procs, 1, user_data))
+    goto cleanup;
+
+  if (proc_return_batch->n_procs > 0)
+    {
+      proc_return_batch->procs = g_try_new0 (GPProcReturn,
+                                             proc_return_batch->n_procs);
+
+      if (! proc_return_batch->procs)
+        {
+          g_printerr ("%s: failed to allocate %u procedure returns\n",
+                      G_STRFUNC, proc_return_batch->n_procs);
+          goto cleanup;
+        }
+    }
+
+  for (i = 0; i < proc_return_batch->n_procs; i++)
+    {
+      GPProcReturn *proc_return = &proc_return_batch->procs[i];
+
+      if (! _gimp_wire_read_string (channel,
+                                    &proc_return->name, 1, user_data))
+        {
+          proc_return_batch->n_procs = i;
+          msg->data = proc_return_batch;
+          _gp_proc_return_batch_destroy (msg);
+          msg->data = NULL;
+          return;
+        }
+
+      _gp_params_read (channel,
+                       &proc_return->params, (guint *) &proc_return->n_params,
+                       user_data);
+    }
+
+  msg->data = proc_return_batch;
+  return;
+
+ cleanup:
+  g_slice_free (GPProcReturnBatch, proc_return_batch);
+  msg->data = NULL;
+}
+
+static void
+_gp_proc_return_batch_write (GIOChannel      *channel,
+                             GimpWireMessage *msg,
+                             gpointer         user_data)
+{
+  GPProcReturnBatch *proc_return_batch = msg->data;
+  guint              i;
+
+  if (! _gimp_wire_write_int32 (channel,
+                                &proc_return_batch->n_procs, 1, user_data))
+    return;
+
+  for (i = 0; i < proc_return_batch->n_procs; i++)
+    {
+      GPProcReturn *proc_return = &proc_return_batch->procs[i];
+
+      if (! _gimp_wire_write_string (channel,
+                                     &proc_return->name, 1, user_data))
+        return;
+
+      _gp_params_write (channel,
+                        proc_return->params, proc_return->n_params, user_data);
+    }
+}
+
+static void
+_gp_proc_return_batch_destroy (GimpWireMessage *msg)
+{
+  GPProcReturnBatch *proc_return_batch = msg->data;
+
+  if (proc_return_batch)
+    {
+      guint i;
+
+      for (i = 0; i < proc_return_batch->n_procs; i++)
+        {
+          _gp_params_destroy (proc_return_batch->procs[i].params,
+                              proc_return_batch->procs[i].n_params);
+
+          g_free (proc_return_batch->procs[i].name);
+        }
+
+      g_free (proc_return_batch->procs);
+      g_slice_free (GPProcReturnBatch, proc_return_batch);
+    }
+}
@@ -26,7 +26,7 @@ G_BEGIN_DECLS
 
 /* Increment every time the protocol changes
  */
-#define GIMP_PROTOCOL_VERSION  0x010E
+#define GIMP_PROTOCOL_VERSION  0x0111
 
 
 enum
@@ -43,7 +43,9 @@ enum
   GP_PROC_INSTALL,
   GP_PROC_UNINSTALL,
   GP_EXTENSION_ACK,
-  GP_HAS_INIT
+  GP_HAS_INIT,
+  GP_PROC_RUN_BATCH,
+  GP_PROC_RETURN_BATCH
 };
 
 typedef enum
@@ -95,6 +97,8 @@ typedef struct _GPParamStringArray GPParamStringArray;
 typedef struct _GPParamIDArray     GPParamIDArray;
 typedef struct _GPProcRun          GPProcRun;
 typedef struct _GPProcReturn       GPProcReturn;
+typedef struct _GPProcRunBatch     GPProcRunBatch;
+typedef struct _GPProcReturnBatch  GPProcReturnBatch;
 typedef struct _GPProcInstall      GPProcInstall;
 typedef struct _GPProcUninstall    GPProcUninstall;
 
@@ -125,6 +129,7 @@ struct _GPConfig
   gchar   *swap_path;
   gchar   *swap_compression;
   gint32   num_processors;
+  gint8    resident;
 };
 
 struct _GPTileReq
@@ -274,6 +279,18 @@ struct _GPProcReturn
   GPParam *params;
 };
 
+struct _GPProcRunBatch
+{
+  guint32    n_procs;
+  GPProcRun *procs;
+};
+
+struct _GPProcReturnBatch
+{
+  guint32       n_procs;
+  GPProcReturn *procs;
+};
+
 struct _GPProcInstall
 {
   gchar      *name;
@@ -290,43 +307,49 @@ struct _GPProcUninstall
 };
 
 
-void      gp_init                   (void);
-
-gboolean  gp_quit_write             (GIOChannel      *channel,
-                                     gpointer         user_data);
-gboolean  gp_config_write           (GIOChannel      *channel,
-                                     GPConfig        *config,
-                                     gpointer         user_data);
-gboolean  gp_tile_req_write         (GIOChannel      *channel,
-                                     GPTileReq       *tile_req,
-                                     gpointer         user_data);
-gboolean  gp_tile_ack_write         (GIOChannel      *channel,
-                                     gpointer         user_data);
-gboolean  gp_tile_data_write        (GIOChannel      *channel,
-                                     GPTileData      *tile_data,
-                                     gpointer         user_data);
-gboolean  gp_proc_run_write         (GIOChannel      *channel,
-                                     GPProcRun       *proc_run,
-                                     gpointer         user_data);
-gboolean  gp_proc_return_write      (GIOChannel      *channel,
-                                     GPProcReturn    *proc_return,
-                                     gpointer         user_data);
-gboolean  gp_temp_proc_run_write    (GIOChannel      *channel,
-                                     GPProcRun       *proc_run,
-                                     gpointer         user_data);
-gboolean  gp_temp_proc_return_write (GIOChannel      *channel,
-                                     GPProcReturn    *proc_return,
-                                     gpointer         user_data);
-gboolean  gp_proc_install_write     (GIOChannel      *channel,
-                                     GPProcInstall   *proc_install,
-                                     gpointer         user_data);
-gboolean  gp_proc_uninstall_write   (GIOChannel      *channel,
-                                     GPProcUninstall *proc_uninstall,
-                                     gpointer         user_data);
-gboolean  gp_extension_ack_write    (GIOChannel      *channel,
-                                     gpointer         user_data);
-gboolean  gp_has_init_write         (GIOChannel      *channel,
-                                     gpointer         user_data);
+void      gp_init                    (void);
+
+gboolean  gp_quit_write              (GIOChannel        *channel,
+                                      gpointer           user_data);
+gboolean  gp_config_write            (GIOChannel        *channel,
+                                      GPConfig          *config,
+                                      gpointer           user_data);
+gboolean  gp_tile_req_write          (GIOChannel        *channel,
+                                      GPTileReq         *tile_req,
+                                      gpointer           user_data);
+gboolean  gp_tile_ack_write          (GIOChannel        *channel,
+                                      gpointer           user_data);
+gboolean  gp_tile_data_write         (GIOChannel        *channel,
+                                      GPTileData        *tile_data,
+                                      gpointer           user_data);
+gboolean  gp_proc_run_write          (GIOChannel        *channel,
+                                      GPProcRun         *proc_run,
+                                      gpointer           user_data);
+gboolean  gp_proc_return_write       (GIOChannel        *channel,
+                                      GPProcReturn      *proc_return,
+                                      gpointer           user_data);
+gboolean  gp_temp_proc_run_write     (GIOChannel        *channel,
+                                      GPProcRun         *proc_run,
+                                      gpointer           user_data);
+gboolean  gp_temp_proc_return_write  (GIOChannel        *channel,
+                                      GPProcReturn      *proc_return,
+                                      gpointer           user_data);
+gboolean  gp_proc_install_write      (GIOChannel        *channel,
+                                      GPProcInstall     *proc_install,
+                                      gpointer           user_data);
+gboolean  gp_proc_uninstall_write    (GIOChannel        *channel,
+                                      GPProcUninstall   *proc_uninstall,
+                                      gpointer           user_data);
+gboolean  gp_extension_ack_write     (GIOChannel        *channel,
+                                      gpointer           user_data);
+gboolean  gp_has_init_write          (GIOChannel        *channel,
+                                      gpointer           user_data);
+gboolean  gp_proc_run_batch_write    (GIOChannel        *channel,
+                                      GPProcRunBatch    *proc_run_batch,
+                                      gpointer           user_data);
+gboolean  gp_proc_return_batch_write (GIOChannel        *channel,
+                                      GPProcReturnBatch *proc_return_batch,
+                                      gpointer           user_data);
 
 
 G_END_DECLS
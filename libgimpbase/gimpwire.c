@@ -27,6 +27,13 @@
 #include "gimpwire.h"
 
 
+/*  the multi-byte write functions convert their data to network byte
+ *  order in chunks of this size, and pass each chunk to the writer in
+ *  one go, instead of doing one write per value.
+ */
+#define WIRE_WRITE_CHUNK_SIZE 1024
+
+
 typedef struct _GimpWireHandler  GimpWireHandler;
 
 struct _GimpWireHandler
@@ -500,18 +507,21 @@ _gimp_wire_write_int64 (GIOChannel    *channel,
 {
   g_return_val_if_fail (count >= 0, FALSE);
 
-  if (count > 0)
+  while (count > 0)
     {
-      gint i;
+      guint64 tmp[WIRE_WRITE_CHUNK_SIZE / sizeof (guint64)];
+      gint    n = MIN (count, G_N_ELEMENTS (tmp));
+      gint    i;
 
-      for (i = 0; i < count; i++)
-        {
-          guint64 tmp = GUINT64_TO_BE (data[i]);
+      for (i = 0; i < n; i++)
+        tmp[i] = GUINT64_TO_BE (data[i]);
 
-          if (! _gimp_wire_write_int8 (channel,
-                                       (const guint8 *) &tmp, 8, user_data))
-            return FALSE;
-        }
+      if (! _gimp_wire_write_int8 (channel,
+                                   (const guint8 *) tmp, n * 8, user_data))
+        return FALSE;
+
+      data  += n;
+      count -= n;
     }
 
   return TRUE;
@@ -525,18 +535,21 @@ _gimp_wire_write_int32 (GIOChannel    *channel,
 {
   g_return_val_if_fail (count >= 0, FALSE);
 
-  if (count > 0)
+  while (count > 0)
     {
-      gint i;
+      guint32 tmp[WIRE_WRITE_CHUNK_SIZE / sizeof (guint32)];
+      gint    n = MIN (count, G_N_ELEMENTS (tmp));
+      gint    i;
 
-      for (i = 0; i < count; i++)
-        {
-          guint32 tmp = g_htonl (data[i]);
+      for (i = 0; i < n; i++)
+        tmp[i] = g_htonl (data[i]);
 
-          if (! _gimp_wire_write_int8 (channel,
-                                       (const guint8 *) &tmp, 4, user_data))
-            return FALSE;
-        }
+      if (! _gimp_wire_write_int8 (channel,
+                                   (const guint8 *) tmp, n * 4, user_data))
+        return FALSE;
+
+      data  += n;
+      count -= n;
     }
 
   return TRUE;
@@ -550,18 +563,21 @@ _gimp_wire_write_int16 (GIOChannel    *channel,
 {
   g_return_val_if_fail (count >= 0, FALSE);
 
-  if (count > 0)
+  while (count > 0)
     {
-      gint i;
+      guint16 tmp[WIRE_WRITE_CHUNK_SIZE / sizeof (guint16)];
+      gint    n = MIN (count, G_N_ELEMENTS (tmp));
+      gint    i;
 
-      for (i = 0; i < count; i++)
-        {
-          guint16 tmp = g_htons (data[i]);
+      for (i = 0; i < n; i++)
+        tmp[i] = g_htons (data[i]);
 
-          if (! _gimp_wire_write_int8 (channel,
-                                       (const guint8 *) &tmp, 2, user_data))
-            return FALSE;
-        }
+      if (! _gimp_wire_write_int8 (channel,
+                                   (const guint8 *) tmp, n * 2, user_data))
+        return FALSE;
+
+      data  += n;
+      count -= n;
     }
 
   return TRUE;
@@ -584,47 +600,26 @@ _gimp_wire_write_double (GIOChannel    *channel,
                          gint           count,
                          gpointer       user_data)
 {
-  gdouble *t;
-  guint8   tmp[8];
-  gint     i;
-#if (G_BYTE_ORDER == G_LITTLE_ENDIAN)
-  gint     j;
-#endif
-
   g_return_val_if_fail (count >= 0, FALSE);
 
-  t = (gdouble *) tmp;
-
-  for (i = 0; i < count; i++)
+  /*  doubles are sent as their big-endian IEEE 754 representation  */
+  while (count > 0)
     {
-      *t = data[i];
+      guint64 tmp[WIRE_WRITE_CHUNK_SIZE / sizeof (guint64)];
+      gint    n = MIN (count, G_N_ELEMENTS (tmp));
+      gint    i;
 
-#if (G_BYTE_ORDER == G_LITTLE_ENDIAN)
-      for (j = 0; j < 4; j++)
-        {
-          guint8 swap;
+      memcpy (tmp, data, n * sizeof (gdouble));
 
-          swap       = tmp[j];
-          tmp[j]     = tmp[7 - j];
-          tmp[7 - j] = swap;
-        }
-#endif
+      for (i = 0; i < n; i++)
+        tmp[i] = GUINT64_TO_BE (tmp[i]);
 
-      if (! _gimp_wire_write_int8 (channel, tmp, 8, user_data))
+      if (! _gimp_wire_write_int8 (channel,
+                                   (const guint8 *) tmp, n * 8, user_data))
         return FALSE;
 
-#if 0
-      {
-        gint k;
-
-        g_print ("Wire representation of %f:\t", data[i]);
-
-        for (k = 0; k < 8; k++)
-          g_print ("%02x ", tmp[k]);
-
-        g_print ("\n");
-      }
-#endif
+      data  += n;
+      count -= n;
     }
 
   return TRUE;
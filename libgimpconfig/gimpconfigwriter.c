@@ -182,9 +182,14 @@ gimp_config_writer_new_from_file (GFile        *file,
 
   writer = g_slice_new0 (GimpConfigWriter);
 
+  /*  the writer flushes each top-level element, buffer the file so
+   *  that doesn't become one write() per element
+   */
   writer->ref_count = 1;
-  writer->output    = output;
+  writer->output    = g_buffered_output_stream_new (output);
   writer->file      = g_object_ref (file);
+
+  g_object_unref (output);
   writer->buffer    = g_string_new (NULL);
 
   if (header)
@@ -83,6 +83,12 @@
 #define TAG_THUMB_GIMP_TYPE       "tEXt::Thumb::X-GIMP::Type"
 #define TAG_THUMB_GIMP_LAYERS     "tEXt::Thumb::X-GIMP::Layers"
 
+/*  how long the result of checking the image file is trusted by
+ *  gimp_thumbnail_peek_thumb(), so that views redrawing a thumbnail
+ *  don't stat the image (possibly on a network mount) each time
+ */
+#define IMAGE_CHECK_INTERVAL      (2 * G_TIME_SPAN_SECOND)
+
 
 enum
 {
@@ -111,7 +117,8 @@ static void      gimp_thumbnail_get_property (GObject        *object,
                                               GParamSpec     *pspec);
 static void      gimp_thumbnail_reset_info   (GimpThumbnail  *thumbnail);
 
-static void      gimp_thumbnail_update_image (GimpThumbnail  *thumbnail);
+static void      gimp_thumbnail_update_image (GimpThumbnail  *thumbnail,
+                                              gboolean        force);
 static void      gimp_thumbnail_update_thumb (GimpThumbnail  *thumbnail,
                                               GimpThumbSize   size);
 
@@ -127,7 +134,13 @@ static void      gimp_thumbnail_debug_notify (GObject        *object,
 #endif
 
 
-G_DEFINE_TYPE (GimpThumbnail, gimp_thumbnail, G_TYPE_OBJECT)
+struct _GimpThumbnailPrivate
+{
+  gint64  image_checked;
+};
+
+
+G_DEFINE_TYPE_WITH_PRIVATE (GimpThumbnail, gimp_thumbnail, G_TYPE_OBJECT)
 
 #define parent_class gimp_thumbnail_parent_class
 
@@ -215,6 +228,8 @@ gimp_thumbnail_class_init (GimpThumbnailClass *klass)
 static void
 gimp_thumbnail_init (GimpThumbnail *thumbnail)
 {
+  thumbnail->priv = gimp_thumbnail_get_instance_private (thumbnail);
+
   thumbnail->image_state      = GIMP_THUMB_STATE_UNKNOWN;
   thumbnail->image_uri        = NULL;
   thumbnail->image_filename   = NULL;
@@ -394,6 +409,8 @@ gimp_thumbnail_set_uri (GimpThumbnail *thumbnail,
   thumbnail->thumb_filesize = 0;
   thumbnail->thumb_mtime    = 0;
 
+  thumbnail->priv->image_checked = 0;
+
   g_object_set (thumbnail,
                 "image-state",      GIMP_THUMB_STATE_UNKNOWN,
                 "image-filesize",   (gint64) 0,
@@ -508,7 +525,7 @@ gimp_thumbnail_peek_image (GimpThumbnail *thumbnail)
 
   g_object_freeze_notify (G_OBJECT (thumbnail));
 
-  gimp_thumbnail_update_image (thumbnail);
+  gimp_thumbnail_update_image (thumbnail, TRUE);
 
   g_object_thaw_notify (G_OBJECT (thumbnail));
 
@@ -529,6 +546,10 @@ gimp_thumbnail_peek_image (GimpThumbnail *thumbnail)
  * gimp_thumbnail_load_thumb(), or, if you don't need the resulting
  * thumbnail pixbuf, use gimp_thumbnail_check_thumb().
  *
+ * The image file itself is checked again only if that was last done
+ * more than two seconds ago, use gimp_thumbnail_peek_image() to force
+ * an update.
+ *
  * Returns: the thumbnail's #GimpThumbState after the update
  **/
 GimpThumbState
@@ -542,7 +563,7 @@ gimp_thumbnail_peek_thumb (GimpThumbnail *thumbnail,
 
   g_object_freeze_notify (G_OBJECT (thumbnail));
 
-  gimp_thumbnail_update_image (thumbnail);
+  gimp_thumbnail_update_image (thumbnail, FALSE);
   gimp_thumbnail_update_thumb (thumbnail, size);
 
   g_object_thaw_notify (G_OBJECT (thumbnail));
@@ -585,7 +606,8 @@ gimp_thumbnail_check_thumb (GimpThumbnail *thumbnail,
 }
 
 static void
-gimp_thumbnail_update_image (GimpThumbnail *thumbnail)
+gimp_thumbnail_update_image (GimpThumbnail *thumbnail,
+                             gboolean       force)
 {
   GimpThumbState  state;
   gint64          mtime    = 0;
@@ -623,6 +645,17 @@ gimp_thumbnail_update_image (GimpThumbnail *thumbnail)
       break;
 
     default:
+      {
+        gint64 now = g_get_monotonic_time ();
+
+        if (! force                            &&
+            thumbnail->priv->image_checked > 0 &&
+            now - thumbnail->priv->image_checked < IMAGE_CHECK_INTERVAL)
+          return;
+
+        thumbnail->priv->image_checked = now;
+      }
+
       switch (gimp_thumb_file_test (thumbnail->image_filename,
                                     &mtime, &filesize,
                                     &thumbnail->image_not_found_errno))
@@ -850,6 +850,40 @@ do_optimizations (GimpRunMode  run_mode,
 
               for (yit=0; yit<height; yit++)
                 {
+                  const guchar *this_row = &this_frame[yit*width*pixelstep];
+                  const guchar *last_row = &last_frame[yit*width*pixelstep];
+
+                  /* A row that didn't change keeps none of its pixels,
+                   *  so there's no need to compare them one by one; only
+                   *  its opaque extent matters, for the rbox.
+                   */
+                  if (memcmp (this_row, last_row, width*pixelstep) == 0)
+                    {
+                      gint first, last;
+
+                      for (first=0; first<width; first++)
+                        if (this_row[first*pixelstep + pixelstep-1]&128)
+                          break;
+
+                      for (last=width-1; last>first; last--)
+                        if (this_row[last*pixelstep + pixelstep-1]&128)
+                          break;
+
+                      if (first<width)
+                        {
+                          if (first<rbox_left) rbox_left=first;
+                          if (last>rbox_right) rbox_right=last;
+                          if (yit<rbox_top) rbox_top=yit;
+                          if (yit>rbox_bottom) rbox_bottom=yit;
+                        }
+
+                      for (xit=0; xit<width; xit++)
+                        opti_frame[yit*width*pixelstep + xit*pixelstep
+                                   + pixelstep-1] = 0;
+
+                      continue;
+                    }
+
                   for (xit=0; xit<width; xit++)
                     {
                       gboolean keep_pix;
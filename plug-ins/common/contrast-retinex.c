@@ -123,7 +123,9 @@ static void     gausssmooth                 (gfloat       *in,
                                              gfloat       *out,
                                              gint          size,
                                              gint          rowtride,
-                                             gauss3_coefs *c);
+                                             gauss3_coefs *c,
+                                             gfloat       *w1,
+                                             gfloat       *w2);
 
 static void contrast_retinex_scale_entry_update_int   (GimpLabelSpin *entry,
                                                        gint          *value);
@@ -633,7 +635,8 @@ compute_coefs3 (gauss3_coefs *c, gfloat sigma)
 }
 
 static void
-gausssmooth (gfloat *in, gfloat *out, gint size, gint rowstride, gauss3_coefs *c)
+gausssmooth (gfloat *in, gfloat *out, gint size, gint rowstride, gauss3_coefs *c,
+             gfloat *w1, gfloat *w2)
 {
   /*
    * Papers:  "Recursive Implementation of the gaussian filter.",
@@ -641,15 +644,13 @@ gausssmooth (gfloat *in, gfloat *out, gint size, gint rowstride, gauss3_coefs *c
    * formula: 9a        forward filter
    *          9b        backward filter
    *          fig7      algorithm
+   *
+   * w1 and w2 are work buffers of at least size + 3 floats.
    */
-  gint i,n, bufsize;
-  gfloat *w1,*w2;
+  gint i,n;
 
   /* forward pass */
-  bufsize = size+3;
   size -= 1;
-  w1 = (gfloat *) g_try_malloc (bufsize * sizeof (gfloat));
-  w2 = (gfloat *) g_try_malloc (bufsize * sizeof (gfloat));
   w1[0] = in[0];
   w1[1] = in[0];
   w1[2] = in[0];
@@ -672,9 +673,6 @@ gausssmooth (gfloat *in, gfloat *out, gint size, gint rowstride, gauss3_coefs *c
                                              c->b[2]*w2[n+2] +
                                              c->b[3]*w2[n+3] ) / c->b[0]));
     }
-
-  g_free (w1);
-  g_free (w2);
 }
 
 /*
@@ -694,6 +692,8 @@ MSRCR (guchar *src, gint width, gint height, gint bytes, gboolean preview_mode)
   gfloat       *dst  = NULL;            /* float buffer for algorithm */
   gfloat       *pdst = NULL;            /* backup pointer for float buffer */
   gfloat       *in, *out;
+  gfloat       *w1, *w2;                /* work buffers for gausssmooth() */
+  gdouble       log_src[256];           /* log (value + 1) */
   gint          channelsize;            /* Float memory cache for one channel */
   gfloat        weight;
   gauss3_coefs  coef;
@@ -738,6 +738,12 @@ MSRCR (guchar *src, gint width, gint height, gint bytes, gboolean preview_mode)
       return; /* do some clever stuff */
     }
 
+  w1 = g_new (gfloat, MAX (width, height) + 3);
+  w2 = g_new (gfloat, MAX (width, height) + 3);
+
+  for (i = 0; i < 256; i++)
+    log_src[i] = log (i + 1.);
+
 
   /*
      Calculate the scales of filtering according to the
@@ -778,11 +784,10 @@ MSRCR (guchar *src, gint width, gint height, gint bytes, gboolean preview_mode)
           for (row=0 ;row < height; row++)
             {
               pos =  row * width;
-              gausssmooth (in + pos, out + pos, width, 1, &coef);
+              gausssmooth (in + pos, out + pos, width, 1, &coef, w1, w2);
             }
 
           memcpy(in,  out, channelsize * sizeof(gfloat));
-          memset(out, 0  , channelsize * sizeof(gfloat));
 
           /*
            *  Filtering (smoothing) Gaussian recursive.
@@ -792,7 +797,7 @@ MSRCR (guchar *src, gint width, gint height, gint bytes, gboolean preview_mode)
           for (col=0; col < width; col++)
             {
               pos = col;
-              gausssmooth(in + pos, out + pos, height, width, &coef);
+              gausssmooth(in + pos, out + pos, height, width, &coef, w1, w2);
             }
 
           /*
@@ -801,7 +806,7 @@ MSRCR (guchar *src, gint width, gint height, gint bytes, gboolean preview_mode)
            */
           for (i = 0, pos = channel; i < channelsize; i++, pos += bytes)
             {
-              dst[pos] += weight * (log (src[pos] + 1.) - log (out[i]));
+              dst[pos] += weight * (log_src[src[pos]] - log (out[i]));
             }
 
            if (!preview_mode)
@@ -811,6 +816,8 @@ MSRCR (guchar *src, gint width, gint height, gint bytes, gboolean preview_mode)
     }
   g_free(in);
   g_free(out);
+  g_free(w1);
+  g_free(w2);
 
   /*
       Final calculation with original value and cumulated filter values.
@@ -18,6 +18,8 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include <libgimp/gimp.h>
 
 #include "libgimp/stdplugins-intl.h"
@@ -197,18 +199,20 @@ static void
 do_zcrop (GimpDrawable *drawable,
           GimpImage    *image)
 {
-  GeglBuffer   *drawable_buffer;
-  GeglBuffer   *shadow_buffer;
-  gfloat       *linear_buf;
-  const Babl   *format;
-
-  gint          x, y, width, height;
-  gint          components;
-  gint8        *killrows;
-  gint8        *killcols;
-  gint32        livingrows, livingcols, destrow, destcol;
-  GimpChannel  *selection_copy;
-  gboolean      has_alpha;
+  GeglBuffer         *drawable_buffer;
+  GeglBuffer         *shadow_buffer;
+  GeglBufferIterator *iter;
+  gfloat             *row_ref;
+  gfloat             *col_ref;
+  const Babl         *format;
+
+  gint                x, y, width, height;
+  gint                components;
+  gint8              *killrows;
+  gint8              *killcols;
+  gint32              livingrows, livingcols, destrow, destcol;
+  GimpChannel        *selection_copy;
+  gboolean            has_alpha;
 
   drawable_buffer = gimp_drawable_get_buffer (drawable);
   shadow_buffer   = gimp_drawable_get_shadow_buffer (drawable);
@@ -227,54 +231,86 @@ do_zcrop (GimpDrawable *drawable,
   killrows = g_new (gint8, height);
   killcols = g_new (gint8, width);
 
-  linear_buf = g_new (gfloat, (width > height ? width : height) * components);
+  /* a row is removed if all of its pixels equal its leftmost one, and a
+   * column if all of its pixels equal its topmost one
+   */
+  row_ref = g_new (gfloat, height * components);
+  col_ref = g_new (gfloat, width  * components);
 
-  /* search which rows to remove */
+  gegl_buffer_get (drawable_buffer, GEGL_RECTANGLE (0, 0, 1, height),
+                   1.0, format, row_ref,
+                   GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
+  gegl_buffer_get (drawable_buffer, GEGL_RECTANGLE (0, 0, width, 1),
+                   1.0, format, col_ref,
+                   GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
 
-  livingrows = 0;
-  for (y = 0; y < height; y++)
-    {
-      gegl_buffer_get (drawable_buffer, GEGL_RECTANGLE (0, y, width, 1),
-                       1.0, format, linear_buf,
-                       GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
+  memset (killrows, TRUE, height);
+  memset (killcols, TRUE, width);
 
-      killrows[y] = TRUE;
+  /* search which rows and columns to remove, in a single pass over the
+   * buffer's tiles.  uniform tiles only need to be compared once per row
+   * and column.
+   */
+
+  iter = gegl_buffer_iterator_new (drawable_buffer, NULL, 0, format,
+                                   GEGL_ACCESS_READ, GEGL_ABYSS_NONE, 1);
+
+  while (gegl_buffer_iterator_next (iter))
+    {
+      const GeglRectangle *roi  = &iter->items[0].roi;
+      const gfloat        *data = iter->items[0].data;
 
-      for (x = components; x < width * components; x += components)
+      if (! memcmp (data, data + components,
+                    (iter->length - 1) * components * sizeof (gfloat)))
         {
-          if (! colors_equal (linear_buf, &linear_buf[x], components, has_alpha))
+          for (y = roi->y; y < roi->y + roi->height; y++)
             {
-              livingrows++;
-              killrows[y] = FALSE;
-              break;
+              if (killrows[y] &&
+                  ! colors_equal (&row_ref[y * components], data,
+                                  components, has_alpha))
+                killrows[y] = FALSE;
             }
-        }
-    }
-
-  gimp_progress_update (0.25);
 
-  /* search which columns to remove */
-
-  livingcols = 0;
-  for (x = 0; x < width; x++)
-    {
-      gegl_buffer_get (drawable_buffer, GEGL_RECTANGLE (x, 0, 1, height),
-                       1.0, format, linear_buf,
-                       GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
+          for (x = roi->x; x < roi->x + roi->width; x++)
+            {
+              if (killcols[x] &&
+                  ! colors_equal (&col_ref[x * components], data,
+                                  components, has_alpha))
+                killcols[x] = FALSE;
+            }
 
-      killcols[x] = TRUE;
+          continue;
+        }
 
-      for (y = components; y < height * components; y += components)
+      for (y = roi->y; y < roi->y + roi->height; y++)
         {
-          if (! colors_equal (linear_buf, &linear_buf[y], components, has_alpha))
+          for (x = roi->x; x < roi->x + roi->width; x++)
             {
-              livingcols++;
-              killcols[x] = FALSE;
-              break;
+              if (killrows[y] &&
+                  ! colors_equal (&row_ref[y * components], data,
+                                  components, has_alpha))
+                killrows[y] = FALSE;
+
+              if (killcols[x] &&
+                  ! colors_equal (&col_ref[x * components], data,
+                                  components, has_alpha))
+                killcols[x] = FALSE;
+
+              data += components;
             }
         }
     }
 
+  livingrows = 0;
+  for (y = 0; y < height; y++)
+    if (! killrows[y])
+      livingrows++;
+
+  livingcols = 0;
+  for (x = 0; x < width; x++)
+    if (! killcols[x])
+      livingcols++;
+
   gimp_progress_update (0.5);
 
   if ((livingcols == 0 || livingrows == 0) ||
@@ -285,7 +321,8 @@ do_zcrop (GimpDrawable *drawable,
       g_object_unref (shadow_buffer);
       g_object_unref (drawable_buffer);
 
-      g_free (linear_buf);
+      g_free (row_ref);
+      g_free (col_ref);
       g_free (killrows);
       g_free (killcols);
       return;
@@ -349,7 +386,8 @@ do_zcrop (GimpDrawable *drawable,
   g_object_unref (shadow_buffer);
   g_object_unref (drawable_buffer);
 
-  g_free (linear_buf);
+  g_free (row_ref);
+  g_free (col_ref);
   g_free (killrows);
   g_free (killcols);
 }
@@ -59,6 +59,8 @@ typedef struct
 {
   gint       elems[256]; /* Number of pixels that fall into each luma bucket */
   PixelsList origs[256]; /* Original pixels */
+  gint       median;     /* Luma bucket the median was last found in */
+  gint       below;      /* Number of pixels in the buckets below it */
   gint       xmin;
   gint       ymin;
   gint       xmax;
@@ -685,6 +687,9 @@ histogram_add (DespeckleHistogram *hist,
 {
   hist->elems[val]++;
   list_add_elem (&hist->origs[val], orig);
+
+  if (val < hist->median)
+    hist->below++;
 }
 
 static inline void
@@ -693,6 +698,9 @@ histogram_remove (DespeckleHistogram *hist,
 {
   hist->elems[val]--;
   list_del_elem (&hist->origs[val]);
+
+  if (val < hist->median)
+    hist->below--;
 }
 
 static inline void
@@ -705,6 +713,9 @@ histogram_clean (DespeckleHistogram *hist)
       hist->elems[i] = 0;
       hist->origs[i].count = 0;
     }
+
+  hist->median = 0;
+  hist->below  = 0;
 }
 
 static inline const guchar *
@@ -712,19 +723,29 @@ histogram_get_median (DespeckleHistogram *hist,
                       const guchar       *_default)
 {
   gint count = histrest;
-  gint i;
-  gint sum = 0;
 
   if (! count)
     return _default;
 
   count = (count + 1) / 2;
 
-  i = 0;
-  while ((sum += hist->elems[i]) < count)
-    i++;
+  /* the window only moves by a row or column of pixels between calls,
+   * so the median is looked for starting from where it was last found,
+   * rather than from the first bucket
+   */
+  while (hist->below + hist->elems[hist->median] < count)
+    {
+      hist->below += hist->elems[hist->median];
+      hist->median++;
+    }
+
+  while (hist->below >= count)
+    {
+      hist->median--;
+      hist->below -= hist->elems[hist->median];
+    }
 
-  return list_get_random_elem (&hist->origs[i]);
+  return list_get_random_elem (&hist->origs[hist->median]);
 }
 
 static inline void
@@ -407,7 +407,7 @@ static gint colors_to_bpp                  (gint           colors);
 static gint bpp_to_colors                  (gint           bpp);
 static gint get_pixel                      (gint           x,
                                             gint           y);
-static gint gif_next_pixel                 (ifunptr        getpixel);
+static gint gif_next_pixel                 (void);
 static void bump_pixel                     (void);
 
 static gboolean gif_encode_header              (GOutputStream  *output,
@@ -436,7 +436,6 @@ static gboolean gif_encode_image_data          (GOutputStream  *output,
                                                 gint            height,
                                                 gint            interlace,
                                                 gint            bpp,
-                                                ifunptr         get_pixel,
                                                 gint            offset_x,
                                                 gint            offset_y,
                                                 GError        **error);
@@ -456,19 +455,15 @@ static gint     max_progress;
 
 static gboolean compress        (GOutputStream *output,
                                  gint           init_bits,
-                                 ifunptr        ReadValue,
                                  GError        **error);
 static gboolean no_compress     (GOutputStream *output,
                                  gint           init_bits,
-                                 ifunptr        ReadValue,
                                  GError        **error);
 static gboolean rle_compress    (GOutputStream *output,
                                  gint           init_bits,
-                                 ifunptr        ReadValue,
                                  GError        **error);
 static gboolean normal_compress (GOutputStream *output,
                                  gint           init_bits,
-                                 ifunptr        ReadValue,
                                  GError        **error);
 
 static gboolean put_byte        (GOutputStream  *output,
@@ -910,11 +905,16 @@ save_image (GFile         *file,
                                             NULL, error));
   if (output)
     {
+      GOutputStream     *buffered;
       GDataOutputStream *data_output;
 
-      data_output = g_data_output_stream_new (output);
+      /*  GDataOutputStream doesn't buffer, and we write byte by byte  */
+      buffered = g_buffered_output_stream_new (output);
       g_object_unref (output);
 
+      data_output = g_data_output_stream_new (buffered);
+      g_object_unref (buffered);
+
       g_data_output_stream_set_byte_order (data_output,
                                            G_DATA_STREAM_BYTE_ORDER_LITTLE_ENDIAN);
 
@@ -1107,7 +1107,6 @@ save_image (GFile         *file,
       if (! gif_encode_image_data (output, cols, rows,
                                    (rows > 4) ? config_interlace : 0,
                                    useBPP,
-                                   get_pixel,
                                    offset_x, offset_y,
                                    error))
         return FALSE;
@@ -1397,10 +1396,11 @@ get_pixel (gint x,
  *
  *****************************************************************************/
 
-static gint  Width, Height;
-static gint  curx, cury;
-static glong CountDown;
-static gint  Pass = 0;
+static gint     Width, Height;
+static gint     curx, cury;
+static guchar  *cur_row;
+static glong    CountDown;
+static gint     Pass = 0;
 
 /*
  * Bump the 'curx' and 'cury' to point to the next pixel
@@ -1466,6 +1466,8 @@ bump_pixel (void)
               break;
             }
         }
+
+      cur_row = pixels + rowstride * (glong) cury;
     }
 }
 
@@ -1473,7 +1475,7 @@ bump_pixel (void)
  * Return the next pixel from the image
  */
 static gint
-gif_next_pixel (ifunptr getpixel)
+gif_next_pixel (void)
 {
   gint r;
 
@@ -1482,7 +1484,7 @@ gif_next_pixel (ifunptr getpixel)
 
   --CountDown;
 
-  r = (*getpixel) (curx, cury);
+  r = cur_row[curx];
 
   bump_pixel ();
 
@@ -1672,7 +1674,6 @@ gif_encode_image_data (GOutputStream *output,
                        int            GHeight,
                        int            GInterlace,
                        int            BitsPerPixel,
-                       ifunptr        get_pixel,
                        gint           offset_x,
                        gint           offset_y,
                        GError       **error)
@@ -1709,6 +1710,7 @@ gif_encode_image_data (GOutputStream *output,
    * Set up the current x and y position
    */
   curx = cury = 0;
+  cur_row = pixels;
 
   /*
    * Write an Image separator
@@ -1749,7 +1751,7 @@ gif_encode_image_data (GOutputStream *output,
   /*
    * Go and actually compress the data
    */
-  if (! compress (output, InitCodeSize + 1, get_pixel, error))
+  if (! compress (output, InitCodeSize + 1, error))
     return FALSE;
 
   /*
@@ -1973,21 +1975,19 @@ static gulong masks[] =
 static gboolean
 compress (GOutputStream  *output,
           gint            init_bits,
-          ifunptr         ReadValue,
           GError        **error)
 {
   if (FALSE)
-    return no_compress (output, init_bits, ReadValue, error);
+    return no_compress (output, init_bits, error);
   else if (FALSE)
-    return rle_compress (output, init_bits, ReadValue, error);
+    return rle_compress (output, init_bits, error);
   else
-    return normal_compress (output, init_bits, ReadValue, error);
+    return normal_compress (output, init_bits, error);
 }
 
 static gboolean
 no_compress (GOutputStream  *output,
              gint            init_bits,
-             ifunptr         ReadValue,
              GError        **error)
 {
   glong fcode;
@@ -2025,7 +2025,7 @@ no_compress (GOutputStream  *output,
 
   char_init();
 
-  ent = gif_next_pixel (ReadValue);
+  ent = gif_next_pixel ();
 
   hshift = 0;
   for (fcode = (long) hsize; fcode < 65536L; fcode *= 2L)
@@ -2038,7 +2038,7 @@ no_compress (GOutputStream  *output,
   if (! output_code (output, (gint) ClearCode, error))
     return FALSE;
 
-  while ((c = gif_next_pixel (ReadValue)) != EOF)
+  while ((c = gif_next_pixel ()) != EOF)
     {
       ++in_count;
 
@@ -2080,7 +2080,6 @@ no_compress (GOutputStream  *output,
 static gboolean
 rle_compress (GOutputStream  *output,
               gint            init_bits,
-              ifunptr         ReadValue,
               GError        **error)
 {
   glong fcode;
@@ -2119,7 +2118,7 @@ rle_compress (GOutputStream  *output,
 
   char_init ();
 
-  last = ent = gif_next_pixel (ReadValue);
+  last = ent = gif_next_pixel ();
 
   hshift = 0;
   for (fcode = (long) hsize; fcode < 65536L; fcode *= 2L)
@@ -2133,7 +2132,7 @@ rle_compress (GOutputStream  *output,
     return FALSE;
 
 
-  while ((c = gif_next_pixel (ReadValue)) != EOF)
+  while ((c = gif_next_pixel ()) != EOF)
     {
       ++in_count;
 
@@ -2199,7 +2198,6 @@ rle_compress (GOutputStream  *output,
 static gboolean
 normal_compress (GOutputStream  *output,
                  gint            init_bits,
-                 ifunptr         ReadValue,
                  GError        **error)
 {
   glong fcode;
@@ -2238,7 +2236,7 @@ normal_compress (GOutputStream  *output,
 
   char_init();
 
-  ent = gif_next_pixel (ReadValue);
+  ent = gif_next_pixel ();
 
   hshift = 0;
   for (fcode = (long) hsize; fcode < 65536L; fcode *= 2L)
@@ -2252,7 +2250,7 @@ normal_compress (GOutputStream  *output,
     return FALSE;
 
 
-  while ((c = gif_next_pixel (ReadValue)) != EOF)
+  while ((c = gif_next_pixel ()) != EOF)
     {
       ++in_count;
 
@@ -880,6 +880,11 @@ load_image (GFile              *file,
       return NULL;
     }
 
+#if LIBHEIF_HAVE_VERSION(1,5,0)
+  /*  grid images are decoded tile by tile, on this many threads  */
+  heif_context_set_max_decoding_threads (ctx, gimp_get_num_processors ());
+#endif
+
   err = heif_context_read_from_memory (ctx, file_buffer, file_size, NULL);
   if (err.code)
     {
@@ -790,6 +790,109 @@ render_page_to_pixbuf (PopplerPage *page,
 
 #endif
 
+/*  pages are rendered by worker threads, each with its own document,
+ *  while the main thread turns them into layers in page order.  the
+ *  workers stay at most max_ahead pages ahead of the main thread, which
+ *  bounds the memory held by rendered surfaces.
+ */
+typedef struct
+{
+  GFile             *file;
+  PdfSelectedPages  *pages;
+  gint               base_index;
+  gint               sign;
+  gdouble            scale;
+  gboolean           antialias;
+  gint               max_ahead;
+
+  GMutex             mutex;
+  GCond              cond;
+  gint               next;
+  gint               consumed;
+  gboolean           stop;
+  cairo_surface_t  **surfaces;
+  gboolean          *rendered;
+} PdfRenderQueue;
+
+static cairo_surface_t *
+render_page_num (PopplerDocument *doc,
+                 gint             page_num,
+                 gdouble          scale,
+                 gboolean         antialias)
+{
+  PopplerPage     *page;
+  cairo_surface_t *surface;
+  gdouble          page_width;
+  gdouble          page_height;
+
+  page = poppler_document_get_page (doc, page_num);
+
+  if (! page)
+    return NULL;
+
+  poppler_page_get_size (page, &page_width, &page_height);
+
+  surface = render_page_to_surface (page,
+                                    page_width  * scale,
+                                    page_height * scale,
+                                    scale, antialias);
+
+  g_object_unref (page);
+
+  return surface;
+}
+
+static gpointer
+render_thread_func (PdfRenderQueue *queue)
+{
+  PopplerDocument *doc;
+
+  doc = poppler_document_new_from_gfile (queue->file, loadvals.PDF_password,
+                                         NULL, NULL);
+
+  g_mutex_lock (&queue->mutex);
+
+  while (! queue->stop && queue->next < queue->pages->n_pages)
+    {
+      cairo_surface_t *surface = NULL;
+      gint             i;
+
+      if (queue->next - queue->consumed >= queue->max_ahead)
+        {
+          g_cond_wait (&queue->cond, &queue->mutex);
+          continue;
+        }
+
+      i = queue->next++;
+
+      g_mutex_unlock (&queue->mutex);
+
+      /*  if the document can't be opened here, leave the surface NULL,
+       *  and let the main thread render the page
+       */
+      if (doc)
+        {
+          gint page_index = queue->base_index + queue->sign * i;
+
+          surface = render_page_num (doc, queue->pages->pages[page_index],
+                                     queue->scale, queue->antialias);
+        }
+
+      g_mutex_lock (&queue->mutex);
+
+      queue->surfaces[i] = surface;
+      queue->rendered[i] = TRUE;
+
+      g_cond_broadcast (&queue->cond);
+    }
+
+  g_mutex_unlock (&queue->mutex);
+
+  g_clear_object (&doc);
+
+  return NULL;
+}
+
 static GimpImage *
 load_image (PopplerDocument        *doc,
             GFile                  *file,
@@ -800,13 +903,16 @@ load_image (PopplerDocument        *doc,
             gboolean                reverse_order,
             PdfSelectedPages       *pages)
 {
-  GimpImage  *image = NULL;
-  GimpImage **images   = NULL;
-  gint        i;
-  gdouble     scale;
-  gdouble     doc_progress = 0;
-  gint        base_index = 0;
-  gint        sign = 1;
+  GimpImage      *image = NULL;
+  GimpImage     **images   = NULL;
+  gint            i;
+  gdouble         scale;
+  gdouble         doc_progress = 0;
+  gint            base_index = 0;
+  gint            sign = 1;
+  PdfRenderQueue  queue;
+  GThread       **threads   = NULL;
+  gint            n_threads;
 
   if (reverse_order && pages->n_pages > 0)
     {
@@ -822,6 +928,34 @@ load_image (PopplerDocument        *doc,
 
   scale = resolution / gimp_unit_get_factor (GIMP_UNIT_POINT);
 
+  n_threads = MIN (gimp_get_num_processors (), pages->n_pages);
+
+  if (n_threads > 1)
+    {
+      queue.file       = file;
+      queue.pages      = pages;
+      queue.base_index = base_index;
+      queue.sign       = sign;
+      queue.scale      = scale;
+      queue.antialias  = antialias;
+      queue.max_ahead  = 2 * n_threads;
+      queue.next       = 0;
+      queue.consumed   = 0;
+      queue.stop       = FALSE;
+      queue.surfaces   = g_new0 (cairo_surface_t *, pages->n_pages);
+      queue.rendered   = g_new0 (gboolean, pages->n_pages);
+
+      g_mutex_init (&queue.mutex);
+      g_cond_init (&queue.cond);
+
+      threads = g_new (GThread *, n_threads);
+
+      for (i = 0; i < n_threads; i++)
+        threads[i] = g_thread_new ("pdf-render",
+                                   (GThreadFunc) render_thread_func,
+                                   &queue);
+    }
+
   /* read the file */
 
   for (i = 0; i < pages->n_pages; i++)
@@ -875,7 +1009,27 @@ load_image (PopplerDocument        *doc,
           gimp_image_set_resolution (image, resolution, resolution);
         }
 
-      surface = render_page_to_surface (page, width, height, scale, antialias);
+      surface = NULL;
+
+      if (threads)
+        {
+          g_mutex_lock (&queue.mutex);
+
+          while (! queue.rendered[i])
+            g_cond_wait (&queue.cond, &queue.mutex);
+
+          surface = queue.surfaces[i];
+          queue.surfaces[i] = NULL;
+          queue.consumed    = i + 1;
+
+          g_cond_broadcast (&queue.cond);
+
+          g_mutex_unlock (&queue.mutex);
+        }
+
+      if (! surface)
+        surface = render_page_to_surface (page, width, height, scale,
+                                          antialias);
 
       layer_from_surface (image, page_label, 0, surface,
                           doc_progress, 1.0 / pages->n_pages);
@@ -896,6 +1050,26 @@ load_image (PopplerDocument        *doc,
           image = 0;
         }
     }
+
+  if (threads)
+    {
+      g_mutex_lock (&queue.mutex);
+      queue.stop = TRUE;
+      g_cond_broadcast (&queue.cond);
+      g_mutex_unlock (&queue.mutex);
+
+      for (i = 0; i < n_threads; i++)
+        g_thread_join (threads[i]);
+
+      g_free (threads);
+
+      g_mutex_clear (&queue.mutex);
+      g_cond_clear (&queue.cond);
+
+      g_free (queue.surfaces);
+      g_free (queue.rendered);
+    }
+
   gimp_progress_update (1.0);
 
   if (image)
@@ -1718,6 +1718,12 @@ save_image (GFile        *file,
 
   png_set_compression_level (pp, compression_level);
 
+  /* Without compression, filtering the rows can't make the file any
+   * smaller, so don't let libpng try every filter on every row.
+   */
+  if (compression_level == 0)
+    png_set_filter (pp, PNG_FILTER_TYPE_BASE, PNG_FILTER_NONE);
+
   /* All this stuff is optional extras, if the user is aiming for smallest
      possible file size she can turn them all off */
 
@@ -897,9 +897,10 @@ pnm_load_raw (PNMScanner *scan,
 {
   GInputStream *input;
   gint          bpc;
-  guchar       *data, *d;
-  gushort      *s;
-  gint          x, y, i;
+  guchar       *data;
+  guchar        lut[256];
+  gsize         i;
+  gint          x, y;
   gint          start, end, scanlines;
 
   if (info->maxval > 255)
@@ -907,6 +908,12 @@ pnm_load_raw (PNMScanner *scan,
   else
     bpc = 1;
 
+  if (bpc == 1 && info->maxval != 255)
+    {
+      for (x = 0; x < 256; x++)
+        lut[x] = 255 * (guint) MIN (x, info->maxval) / (guint) info->maxval;
+    }
+
   /* No overflow as long as gimp_tile_height() < 1365 = 2^(31 - 18) / 6 */
   data = g_new (guchar, gimp_tile_height () * info->xres * info->np * bpc);
 
@@ -914,58 +921,55 @@ pnm_load_raw (PNMScanner *scan,
 
   for (y = 0; y < info->yres; y += scanlines)
     {
+      gsize   n_samples;
+      gsize   bytes_read;
+      GError *error = NULL;
+
       start = y;
       end = y + gimp_tile_height ();
       end = MIN (end, info->yres);
       scanlines = end - start;
-      d = data;
-      s = (gushort *)data;
 
-      for (i = 0; i < scanlines; i++)
+      /* the rows of a band are contiguous in the file */
+      n_samples = (gsize) scanlines * info->xres * info->np;
+
+      if (g_input_stream_read_all (input, data, n_samples * bpc,
+                                   &bytes_read, NULL, &error))
         {
-          gsize   bytes_read;
-          GError *error = NULL;
+          CHECK_FOR_ERROR (n_samples * bpc != bytes_read,
+                           info->jmpbuf,
+                           _("Premature end of file."));
+        }
+      else
+        {
+          CHECK_FOR_ERROR (FALSE, info->jmpbuf, "%s", error->message);
+        }
 
-          if (g_input_stream_read_all (input, d, info->xres * info->np * bpc,
-                                       &bytes_read, NULL, &error))
-            {
-              CHECK_FOR_ERROR (info->xres * info->np * bpc != bytes_read,
-                               info->jmpbuf,
-                               _("Premature end of file."));
-            }
-          else
-            {
-              CHECK_FOR_ERROR (FALSE, info->jmpbuf, "%s", error->message);
-            }
+      if (bpc > 1)
+        {
+          guint16 *s = (guint16 *) data;
 
-          if (bpc > 1)
+          if (info->maxval == 65535)
             {
-              for (x = 0; x < info->xres * info->np; x++)
-                {
-                  int v;
-
-                  v = *d++ << 8;
-                  v += *d++;
-
-                  s[x] = MIN (v, info->maxval); /* guard against overflow */
-                  s[x] = 65535.0 * (gdouble) v / (gdouble) info->maxval;
-                }
-              s += info->xres * info->np;
+              for (i = 0; i < n_samples; i++)
+                s[i] = GUINT16_FROM_BE (s[i]);
             }
           else
             {
-              if (info->maxval != 255)      /* Normalize if needed */
+              for (i = 0; i < n_samples; i++)
                 {
-                  for (x = 0; x < info->xres * info->np; x++)
-                    {
-                      d[x] = MIN (d[x], info->maxval); /* guard against overflow */
-                      d[x] = 255.0 * (gdouble) d[x] / (gdouble) info->maxval;
-                    }
-                }
+                  guint v = GUINT16_FROM_BE (s[i]);
 
-              d += info->xres * info->np;
+                  v = MIN (v, (guint) info->maxval); /* guard against overflow */
+                  s[i] = 65535 * v / (guint) info->maxval;
+                }
             }
         }
+      else if (info->maxval != 255)      /* Normalize if needed */
+        {
+          for (i = 0; i < n_samples; i++)
+            data[i] = lut[data[i]];
+        }
 
       gegl_buffer_set (buffer,
                        GEGL_RECTANGLE (0, y, info->xres, scanlines), 0,
@@ -156,25 +156,12 @@ static GtkWidget *dialog;
 /************************/
 
 static void
-peek (GeglBuffer *buffer,
-      gint        x,
-      gint        y,
-      GimpRGB    *color)
+peek (GeglSampler *sampler,
+      gint         x,
+      gint         y,
+      GimpRGB     *color)
 {
-  gegl_buffer_sample (buffer, x, y, NULL,
-                      color, babl_format ("R'G'B'A double"),
-                      GEGL_SAMPLER_NEAREST, GEGL_ABYSS_NONE);
-}
-
-static void
-poke (GeglBuffer *buffer,
-      gint        x,
-      gint        y,
-      GimpRGB    *color)
-{
-  gegl_buffer_set (buffer, GEGL_RECTANGLE (x, y, 1, 1), 0,
-                   babl_format ("R'G'B'A double"), color,
-                   GEGL_AUTO_ROWSTRIDE);
+  gegl_sampler_get (sampler, x, y, NULL, color, GEGL_ABYSS_NONE);
 }
 
 static gint
@@ -379,10 +366,10 @@ lic_noise (gint    x,
 }
 
 static void
-getpixel (GeglBuffer *buffer,
-          GimpRGB    *p,
-          gdouble     u,
-          gdouble     v)
+getpixel (GeglSampler *sampler,
+          GimpRGB     *p,
+          gdouble      u,
+          gdouble      v)
 {
   register gint x1, y1, x2, y2;
   gint width, height;
@@ -407,10 +394,10 @@ getpixel (GeglBuffer *buffer,
   x2 = (x1 + 1) % width;
   y2 = (y1 + 1) % height;
 
-  peek (buffer, x1, y1, &pp[0]);
-  peek (buffer, x2, y1, &pp[1]);
-  peek (buffer, x1, y2, &pp[2]);
-  peek (buffer, x2, y2, &pp[3]);
+  peek (sampler, x1, y1, &pp[0]);
+  peek (sampler, x2, y1, &pp[1]);
+  peek (sampler, x1, y2, &pp[2]);
+  peek (sampler, x2, y2, &pp[3]);
 
   if (source_drw_has_alpha)
     *p = gimp_bilinear_rgba (u, v, pp);
@@ -419,12 +406,12 @@ getpixel (GeglBuffer *buffer,
 }
 
 static void
-lic_image (GeglBuffer *buffer,
-           gint        x,
-           gint        y,
-           gdouble     vx,
-           gdouble     vy,
-           GimpRGB    *color)
+lic_image (GeglSampler *sampler,
+           gint         x,
+           gint         y,
+           gdouble      vx,
+           gdouble      vy,
+           GimpRGB     *color)
 {
   gdouble u, step = 2.0 * l / isteps;
   gdouble xx = (gdouble) x, yy = (gdouble) y;
@@ -441,7 +428,7 @@ lic_image (GeglBuffer *buffer,
   /* Calculate integral numerically */
   /* ============================== */
 
-  getpixel (buffer, &col1, xx + l * c, yy + l * s);
+  getpixel (sampler, &col1, xx + l * c, yy + l * s);
 
   if (source_drw_has_alpha)
     gimp_rgba_multiply (&col1, filter (-l));
@@ -450,7 +437,7 @@ lic_image (GeglBuffer *buffer,
 
   for (u = -l + step; u <= l; u += step)
     {
-      getpixel (buffer, &col2, xx - u * c, yy - u * s);
+      getpixel (sampler, &col2, xx - u * c, yy - u * s);
 
       if (source_drw_has_alpha)
         {
@@ -486,7 +473,7 @@ rgb_to_hsl (GimpDrawable     *drawable,
             LICEffectChannel  effect_channel)
 {
   GeglBuffer *buffer;
-  guchar     *themap, data[4];
+  guchar     *themap, *row, *data;
   gint        x, y;
   GimpRGB     color;
   GimpHSL     color_hsl;
@@ -501,17 +488,16 @@ rgb_to_hsl (GimpDrawable     *drawable,
   buffer = gimp_drawable_get_buffer (drawable);
 
   themap = g_new (guchar, maxc);
+  row    = g_new (guchar, border_w * 4);
 
   for (y = 0; y < border_h; y++)
     {
-      for (x = 0; x < border_w; x++)
-        {
-          data[3] = 255;
-
-          gegl_buffer_sample (buffer, x, y, NULL,
-                              data, babl_format ("R'G'B'A u8"),
-                              GEGL_SAMPLER_NEAREST, GEGL_ABYSS_NONE);
+      gegl_buffer_get (buffer, GEGL_RECTANGLE (0, y, border_w, 1), 1.0,
+                       babl_format ("R'G'B'A u8"), row,
+                       GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
 
+      for (x = 0, data = row; x < border_w; x++, data += 4)
+        {
           gimp_rgba_set_uchar (&color, data[0], data[1], data[2], data[3]);
           gimp_rgb_to_hsl (&color, &color_hsl);
 
@@ -535,6 +521,8 @@ rgb_to_hsl (GimpDrawable     *drawable,
         }
     }
 
+  g_free (row);
+
   g_object_unref (buffer);
 
   g_rand_free (gr);
@@ -548,15 +536,22 @@ compute_lic (GimpDrawable *drawable,
              const guchar *scalarfield,
              gboolean      rotate)
 {
-  GeglBuffer *src_buffer;
-  GeglBuffer *dest_buffer;
-  gint        xcount, ycount;
-  GimpRGB     color;
-  gdouble     vx, vy, tmp;
+  GeglBuffer  *src_buffer;
+  GeglSampler *src_sampler;
+  GeglBuffer  *dest_buffer;
+  GimpRGB     *dest_row;
+  gint         xcount, ycount;
+  GimpRGB      color;
+  gdouble      vx, vy, tmp;
 
   src_buffer  = gimp_drawable_get_buffer (drawable);
+  src_sampler = gegl_buffer_sampler_new (src_buffer,
+                                         babl_format ("R'G'B'A double"),
+                                         GEGL_SAMPLER_NEAREST);
   dest_buffer = gimp_drawable_get_shadow_buffer (drawable);
 
+  dest_row = g_new (GimpRGB, border_w);
+
   for (ycount = 0; ycount < border_h; ycount++)
     {
       for (xcount = 0; xcount < border_w; xcount++)
@@ -588,7 +583,7 @@ compute_lic (GimpDrawable *drawable,
 
           if (licvals.effect_convolve == 0)
             {
-              peek (src_buffer, xcount, ycount, &color);
+              peek (src_sampler, xcount, ycount, &color);
 
               tmp = lic_noise (xcount, ycount, vx, vy);
 
@@ -599,15 +594,22 @@ compute_lic (GimpDrawable *drawable,
             }
           else
             {
-              lic_image (src_buffer, xcount, ycount, vx, vy, &color);
+              lic_image (src_sampler, xcount, ycount, vx, vy, &color);
             }
 
-          poke (dest_buffer, xcount, ycount, &color);
+          dest_row[xcount] = color;
         }
 
+      gegl_buffer_set (dest_buffer, GEGL_RECTANGLE (0, ycount, border_w, 1), 0,
+                       babl_format ("R'G'B'A double"), dest_row,
+                       GEGL_AUTO_ROWSTRIDE);
+
       gimp_progress_update ((gfloat) ycount / (gfloat) border_h);
     }
 
+  g_free (dest_row);
+
+  g_object_unref (src_sampler);
   g_object_unref (src_buffer);
   g_object_unref (dest_buffer);
 
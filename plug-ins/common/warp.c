@@ -161,7 +161,7 @@ static void             warp_one              (GimpDrawable   *draw,
 static void             warp                  (GimpDrawable   *drawable);
 
 static gboolean         warp_dialog           (GimpDrawable   *drawable);
-static void             warp_pixel            (GeglBuffer     *buffer,
+static void             warp_pixel            (GeglSampler    *sampler,
                                                const Babl     *format,
                                                gint            width,
                                                gint            height,
@@ -1484,6 +1484,10 @@ warp_one (GimpDrawable *draw,
   GeglBuffer *map_y_buffer;
   GeglBuffer *mag_buffer = NULL;
 
+  GeglSampler *src_sampler;
+  GeglSampler *map_x_sampler;
+  GeglSampler *map_y_sampler;
+
   GeglBufferIterator *iter;
 
   gint        width;
@@ -1606,6 +1610,16 @@ warp_one (GimpDrawable *draw,
                                 GEGL_ACCESS_READ, GEGL_ABYSS_NONE);
     }
 
+  /* the neighbouring pixels are read through samplers, which keep the
+   * tiles around the last pixel at hand
+   */
+  src_sampler   = gegl_buffer_sampler_new (src_buffer, src_format,
+                                           GEGL_SAMPLER_NEAREST);
+  map_x_sampler = gegl_buffer_sampler_new (map_x_buffer, map_x_format,
+                                           GEGL_SAMPLER_NEAREST);
+  map_y_sampler = gegl_buffer_sampler_new (map_y_buffer, map_y_format,
+                                           GEGL_SAMPLER_NEAREST);
+
   /* substep displacement vector scale factor */
   dscalefac = dvals.amount / (256 * 127.5 * dvals.substeps);
 
@@ -1673,22 +1687,22 @@ warp_one (GimpDrawable *draw,
                         yi = -((gint) -needy + 1);
 
                       /* get 4 neighboring DX values from DiffX drawable for linear interpolation */
-                      warp_pixel (map_x_buffer, map_x_format,
+                      warp_pixel (map_x_sampler, map_x_format,
                                   width, height,
                                   x1, y1, x2, y2,
                                   xi, yi,
                                   pixel[0]);
-                      warp_pixel (map_x_buffer, map_x_format,
+                      warp_pixel (map_x_sampler, map_x_format,
                                   width, height,
                                   x1, y1, x2, y2,
                                   xi + 1, yi,
                                   pixel[1]);
-                      warp_pixel (map_x_buffer, map_x_format,
+                      warp_pixel (map_x_sampler, map_x_format,
                                   width, height,
                                   x1, y1, x2, y2,
                                   xi, yi + 1,
                                   pixel[2]);
-                      warp_pixel (map_x_buffer, map_x_format,
+                      warp_pixel (map_x_sampler, map_x_format,
                                   width, height,
                                   x1, y1, x2, y2,
                                   xi + 1, yi + 1,
@@ -1702,22 +1716,22 @@ warp_one (GimpDrawable *draw,
                       xval = gimp_bilinear_32 (needx, needy, ivalues);
 
                       /* get 4 neighboring DY values from DiffY drawable for linear interpolation */
-                      warp_pixel (map_y_buffer, map_y_format,
+                      warp_pixel (map_y_sampler, map_y_format,
                                   width, height,
                                   x1, y1, x2, y2,
                                   xi, yi,
                                   pixel[0]);
-                      warp_pixel (map_y_buffer, map_y_format,
+                      warp_pixel (map_y_sampler, map_y_format,
                                   width, height,
                                   x1, y1, x2, y2,
                                   xi + 1, yi,
                                   pixel[1]);
-                      warp_pixel (map_y_buffer, map_y_format,
+                      warp_pixel (map_y_sampler, map_y_format,
                                   width, height,
                                   x1, y1, x2, y2,
                                   xi, yi + 1,
                                   pixel[2]);
-                      warp_pixel (map_y_buffer, map_y_format,
+                      warp_pixel (map_y_sampler, map_y_format,
                                   width, height,
                                   x1, y1, x2, y2,
                                   xi + 1, yi + 1,
@@ -1763,22 +1777,22 @@ warp_one (GimpDrawable *draw,
               /* get 4 neighboring pixel values from source drawable
                * for linear interpolation
                */
-              warp_pixel (src_buffer, src_format,
+              warp_pixel (src_sampler, src_format,
                           width, height,
                           x1, y1, x2, y2,
                           xi, yi,
                           pixel[0]);
-              warp_pixel (src_buffer, src_format,
+              warp_pixel (src_sampler, src_format,
                           width, height,
                           x1, y1, x2, y2,
                           xi + 1, yi,
                           pixel[1]);
-              warp_pixel (src_buffer, src_format,
+              warp_pixel (src_sampler, src_format,
                           width, height,
                           x1, y1, x2, y2,
                           xi, yi + 1,
                           pixel[2]);
-              warp_pixel (src_buffer, src_format,
+              warp_pixel (src_sampler, src_format,
                           width, height,
                           x1, y1, x2, y2,
                           xi + 1, yi + 1,
@@ -1811,6 +1825,10 @@ warp_one (GimpDrawable *draw,
       gimp_progress_update ((double) progress / (double) max_progress);
     }
 
+  g_object_unref (src_sampler);
+  g_object_unref (map_x_sampler);
+  g_object_unref (map_y_sampler);
+
   g_object_unref (src_buffer);
   g_object_unref (dest_buffer);
   g_object_unref (map_x_buffer);
@@ -1851,17 +1869,17 @@ warp_map_mag_give_value (guchar *pt,
 
 
 static void
-warp_pixel (GeglBuffer *buffer,
-            const Babl *format,
-            gint        width,
-            gint        height,
-            gint        x1,
-            gint        y1,
-            gint        x2,
-            gint        y2,
-            gint        x,
-            gint        y,
-            guchar     *pixel)
+warp_pixel (GeglSampler *sampler,
+            const Babl  *format,
+            gint         width,
+            gint         height,
+            gint         x1,
+            gint         y1,
+            gint         x2,
+            gint         y2,
+            gint         x,
+            gint         y,
+            guchar      *pixel)
 {
   static guchar  empty_pixel[4] = { 0, 0, 0, 0 };
   guchar        *data;
@@ -1895,8 +1913,7 @@ warp_pixel (GeglBuffer *buffer,
 
   if (x >= x1 && y >= y1 && x < x2 && y < y2)
     {
-      gegl_buffer_sample (buffer, x, y, NULL, pixel, format,
-                          GEGL_SAMPLER_NEAREST, GEGL_ABYSS_NONE);
+      gegl_sampler_get (sampler, x, y, NULL, pixel, GEGL_ABYSS_NONE);
     }
   else
     {
@@ -69,7 +69,8 @@ static GimpValueArray * wavelet_run              (GimpProcedure        *procedur
                                                   const GimpValueArray *args,
                                                   gpointer              run_data);
 
-static void             wavelet_blur             (GimpDrawable         *drawable,
+static GeglBuffer     * wavelet_blur             (GimpDrawable         *drawable,
+                                                  GeglBuffer           *src,
                                                   gint                  radius);
 
 static gboolean         wavelet_decompose_dialog (void);
@@ -174,6 +175,7 @@ wavelet_run (GimpProcedure        *procedure,
   GimpLayer     *new_scale;
   GimpLayer     *parent             = NULL;
   GimpDrawable  *drawable;
+  GeglBuffer    *residual           = NULL;
   GimpLayerMode  grain_extract_mode = GIMP_LAYER_MODE_GRAIN_EXTRACT;
   GimpLayerMode  grain_merge_mode   = GIMP_LAYER_MODE_GRAIN_MERGE;
   gint           id;
@@ -307,7 +309,7 @@ wavelet_run (GimpProcedure        *procedure,
       gimp_image_insert_layer (image, tmp, parent,
                                gimp_image_get_item_position (image,
                                                              GIMP_ITEM (new_scale)));
-      wavelet_blur (GIMP_DRAWABLE (tmp), pow (2.0, id));
+      residual = wavelet_blur (GIMP_DRAWABLE (tmp), residual, pow (2.0, id));
 
       blur = gimp_layer_copy (tmp);
       gimp_image_insert_layer (image, blur, parent,
@@ -324,6 +326,8 @@ wavelet_run (GimpProcedure        *procedure,
       new_scale = blur;
     }
 
+  g_clear_object (&residual);
+
   gimp_item_set_name (GIMP_ITEM (new_scale), _("Residual"));
 
   for (id = 0; id < wavelet_params.scales; id++)
@@ -366,28 +370,54 @@ wavelet_run (GimpProcedure        *procedure,
   return gimp_procedure_new_return_values (procedure, GIMP_PDB_SUCCESS, NULL);
 }
 
-static void
+/* Blurs @drawable, which holds the same pixels as @src when that is
+ * non-NULL, and returns a local copy of the result, or NULL when the
+ * drawable doesn't end up holding the blurred pixels everywhere.
+ * Passing the returned buffer to the next call saves reading the whole
+ * drawable back from the core for every scale.  Takes ownership of @src.
+ */
+static GeglBuffer *
 wavelet_blur (GimpDrawable *drawable,
+              GeglBuffer   *src,
               gint          radius)
 {
-  gint x, y, width, height;
+  GeglBuffer *blur = NULL;
+  gint        x, y, width, height;
 
   if (gimp_drawable_mask_intersect (drawable, &x, &y, &width, &height))
     {
-      GeglBuffer *buffer = gimp_drawable_get_buffer (drawable);
+      GeglBuffer *buffer;
       GeglBuffer *shadow = gimp_drawable_get_shadow_buffer (drawable);
 
-      gegl_render_op (buffer, shadow,
+      if (src)
+        buffer = g_object_ref (src);
+      else
+        buffer = gimp_drawable_get_buffer (drawable);
+
+      blur = gegl_buffer_new (gegl_buffer_get_extent (buffer),
+                              gegl_buffer_get_format (shadow));
+
+      gegl_render_op (buffer, blur,
                       "gegl:wavelet-blur",
                       "radius", (gdouble) radius,
                       NULL);
 
+      gegl_buffer_copy (blur, NULL, GEGL_ABYSS_NONE, shadow, NULL);
+
       gegl_buffer_flush (shadow);
       gimp_drawable_merge_shadow (drawable, FALSE);
       gimp_drawable_update (drawable, x, y, width, height);
       g_object_unref (buffer);
       g_object_unref (shadow);
+
+      /*  with a selection, only part of the blur was merged  */
+      if (! gimp_selection_is_empty (gimp_item_get_image (GIMP_ITEM (drawable))))
+        g_clear_object (&blur);
     }
+
+  g_clear_object (&src);
+
+  return blur;
 }
 
 static gboolean
@@ -658,6 +658,7 @@ ReadImage (FILE                 *fd,
   guchar             gimp_cmap[768];
   gushort            rgb;
   glong              rowstride, channels;
+  gint               band_y, band_height;
   gint               i, i_max, j, cur_progress, max_progress;
   gint               total_bytes_read;
   GimpImageBaseType  base_type;
@@ -743,10 +744,23 @@ ReadImage (FILE                 *fd,
 
   gimp_image_insert_layer (image, layer, NULL, 0);
 
+  buffer = gimp_drawable_get_buffer (GIMP_DRAWABLE (layer));
+
+  /* uncompressed RGB rows are written to the layer a band at a time,
+   * palette and RLE bitmaps are decoded into a buffer for the whole
+   * image, as RLE deltas can skip over any number of rows.
+   */
+  if (bpp >= 16)
+    band_height = MIN (gimp_tile_height (), height);
+  else
+    band_height = height;
+
+  band_y = height - band_height;
+
   /* use g_malloc0 to initialize the dest buffer so that unspecified
      pixels in RLE bitmaps show up as the zeroth element in the palette.
   */
-  dest      = g_malloc0 (width * height * channels);
+  dest      = g_malloc0 (width * band_height * channels);
   row_buf   = g_malloc (rowbytes);
   rowstride = width * channels;
 
@@ -758,18 +772,49 @@ ReadImage (FILE                 *fd,
     {
     case 32:
       {
+        /* the usual BGRA/BGRX masks need no scaling */
+        gboolean plain_8bit = (masks[0].max_value == 255.0 &&
+                               masks[1].max_value == 255.0 &&
+                               masks[2].max_value == 255.0 &&
+                               (channels == 3 || masks[3].max_value == 255.0));
+
         while (ReadOK (fd, row_buf, rowbytes))
           {
-            temp = dest + (ypos * rowstride);
+            temp = dest + ((ypos - band_y) * rowstride);
 
-            for (xpos= 0; xpos < width; ++xpos)
+            if (plain_8bit)
               {
-                px32 = ToL(&row_buf[xpos*4]);
-                *(temp++) = ((px32 & masks[0].mask) >> masks[0].shiftin) * 255.0 / masks[0].max_value + 0.5;
-                *(temp++) = ((px32 & masks[1].mask) >> masks[1].shiftin) * 255.0 / masks[1].max_value + 0.5;
-                *(temp++) = ((px32 & masks[2].mask) >> masks[2].shiftin) * 255.0 / masks[2].max_value + 0.5;
-                if (channels > 3)
-                  *(temp++) = ((px32 & masks[3].mask) >> masks[3].shiftin) * 255.0 / masks[3].max_value + 0.5;
+                for (xpos= 0; xpos < width; ++xpos)
+                  {
+                    px32 = ToL(&row_buf[xpos*4]);
+                    *(temp++) = (px32 & masks[0].mask) >> masks[0].shiftin;
+                    *(temp++) = (px32 & masks[1].mask) >> masks[1].shiftin;
+                    *(temp++) = (px32 & masks[2].mask) >> masks[2].shiftin;
+                    if (channels > 3)
+                      *(temp++) = (px32 & masks[3].mask) >> masks[3].shiftin;
+                  }
+              }
+            else
+              {
+                for (xpos= 0; xpos < width; ++xpos)
+                  {
+                    px32 = ToL(&row_buf[xpos*4]);
+                    *(temp++) = ((px32 & masks[0].mask) >> masks[0].shiftin) * 255.0 / masks[0].max_value + 0.5;
+                    *(temp++) = ((px32 & masks[1].mask) >> masks[1].shiftin) * 255.0 / masks[1].max_value + 0.5;
+                    *(temp++) = ((px32 & masks[2].mask) >> masks[2].shiftin) * 255.0 / masks[2].max_value + 0.5;
+                    if (channels > 3)
+                      *(temp++) = ((px32 & masks[3].mask) >> masks[3].shiftin) * 255.0 / masks[3].max_value + 0.5;
+                  }
+              }
+
+            if (ypos == band_y)
+              {
+                gegl_buffer_set (buffer,
+                                 GEGL_RECTANGLE (0, band_y, width, band_height),
+                                 0, NULL, dest, GEGL_AUTO_ROWSTRIDE);
+
+                band_height = MIN (band_height, band_y);
+                band_y     -= band_height;
               }
 
             if (ypos == 0)
@@ -789,7 +834,7 @@ ReadImage (FILE                 *fd,
       {
         while (ReadOK (fd, row_buf, rowbytes))
           {
-            temp = dest + (ypos * rowstride);
+            temp = dest + ((ypos - band_y) * rowstride);
 
             for (xpos= 0; xpos < width; ++xpos)
               {
@@ -798,6 +843,16 @@ ReadImage (FILE                 *fd,
                 *(temp++) = row_buf[xpos * 3];
               }
 
+            if (ypos == band_y)
+              {
+                gegl_buffer_set (buffer,
+                                 GEGL_RECTANGLE (0, band_y, width, band_height),
+                                 0, NULL, dest, GEGL_AUTO_ROWSTRIDE);
+
+                band_height = MIN (band_height, band_y);
+                band_y     -= band_height;
+              }
+
             if (ypos == 0)
               break;
 
@@ -815,7 +870,7 @@ ReadImage (FILE                 *fd,
       {
         while (ReadOK (fd, row_buf, rowbytes))
           {
-            temp = dest + (ypos * rowstride);
+            temp = dest + ((ypos - band_y) * rowstride);
 
             for (xpos= 0; xpos < width; ++xpos)
               {
@@ -827,6 +882,16 @@ ReadImage (FILE                 *fd,
                   *(temp++) = ((rgb & masks[3].mask) >> masks[3].shiftin) * 255.0 / masks[3].max_value + 0.5;
               }
 
+            if (ypos == band_y)
+              {
+                gegl_buffer_set (buffer,
+                                 GEGL_RECTANGLE (0, band_y, width, band_height),
+                                 0, NULL, dest, GEGL_AUTO_ROWSTRIDE);
+
+                band_height = MIN (band_height, band_y);
+                band_y     -= band_height;
+              }
+
             if (ypos == 0)
               break;
 
@@ -1008,10 +1073,20 @@ ReadImage (FILE                 *fd,
         gimp_cmap[j++] = cmap[i][2];
       }
 
-  buffer = gimp_drawable_get_buffer (GIMP_DRAWABLE (layer));
-
-  gegl_buffer_set (buffer, GEGL_RECTANGLE (0, 0, width, height), 0,
-                   NULL, dest, GEGL_AUTO_ROWSTRIDE);
+  if (bpp < 16)
+    {
+      gegl_buffer_set (buffer, GEGL_RECTANGLE (0, 0, width, height), 0,
+                       NULL, dest, GEGL_AUTO_ROWSTRIDE);
+    }
+  else if (band_height > 0 && ypos + 1 < band_y + band_height)
+    {
+      /* the file ended in the middle of a band */
+      gegl_buffer_set (buffer,
+                       GEGL_RECTANGLE (0, ypos + 1,
+                                       width, band_y + band_height - (ypos + 1)),
+                       0, NULL, dest + (ypos + 1 - band_y) * rowstride,
+                       GEGL_AUTO_ROWSTRIDE);
+    }
 
   g_object_unref (buffer);
 
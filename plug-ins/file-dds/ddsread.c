@@ -1330,6 +1330,35 @@ load_layer (FILE             *fp,
   return TRUE;
 }
 
+/* the number of bytes load_layer() reads for the given level */
+static guint
+layer_data_size (dds_header_t    *hdr,
+                 dds_load_info_t *d,
+                 guint            level)
+{
+  guint width  = MAX (hdr->width  >> level, 1);
+  guint height = MAX (hdr->height >> level, 1);
+
+  if (hdr->pixelfmt.flags & DDPF_FOURCC)
+    {
+      guint size = ((width + 3) >> 2) * ((height + 3) >> 2);
+
+      switch (GETL32 (hdr->pixelfmt.fourcc))
+        {
+        case FOURCC ('D','X','T','1'):
+        case FOURCC ('A','T','I','1'):
+        case FOURCC ('B','C','4','U'):
+        case FOURCC ('B','C','4','S'):
+          return size * 8;
+
+        default:
+          return size * 16;
+        }
+    }
+
+  return width * height * d->bpp;
+}
+
 static gboolean
 load_mipmaps (FILE             *fp,
               dds_header_t     *hdr,
@@ -1346,14 +1375,32 @@ load_mipmaps (FILE             *fp,
   guint level;
 
   if ((hdr->flags & DDSD_MIPMAPCOUNT) &&
-      (hdr->caps.caps1 & DDSCAPS_MIPMAP) &&
-      read_mipmaps)
+      (hdr->caps.caps1 & DDSCAPS_MIPMAP))
     {
-      for (level = 1; level < hdr->num_mipmaps; ++level)
+      if (read_mipmaps)
         {
-          if (! load_layer (fp, hdr, d, image, level, prefix, l, pixels, buf,
-                            decode_images, error))
-            return FALSE;
+          for (level = 1; level < hdr->num_mipmaps; ++level)
+            {
+              if (! load_layer (fp, hdr, d, image, level, prefix, l,
+                                pixels, buf, decode_images, error))
+                return FALSE;
+            }
+        }
+      else
+        {
+          /* skip the mipmaps without reading them, cube map faces and
+           * array elements following them must not be read from the
+           * wrong position
+           */
+          for (level = 1; level < hdr->num_mipmaps; ++level)
+            {
+              if (fseek (fp, layer_data_size (hdr, d, level), SEEK_CUR))
+                {
+                  g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_FAILED,
+                               _("Unexpected EOF.\n"));
+                  return FALSE;
+                }
+            }
         }
     }
 
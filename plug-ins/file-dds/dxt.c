@@ -33,6 +33,7 @@
 #include <string.h>
 #include <math.h>
 #include <glib.h>
+#include <gegl.h>
 
 #include "dds.h"
 #include "dxt.h"
@@ -1013,162 +1014,135 @@ encode_alpha_block_BC3 (unsigned char       *dst,
     }
 }
 
-#define BLOCK_COUNT(w, h)          ((((h) + 3) >> 2) * (((w) + 3) >> 2))
 #define BLOCK_OFFSET(x, y, w, bs)  (((y) >> 2) * ((bs) * (((w) + 3) >> 2)) + ((bs) * ((x) >> 2)))
 
-static void
-compress_BC1 (unsigned char       *dst,
-              const unsigned char *src,
-              int                  w,
-              int                  h,
-              int                  flags)
+/* minimum number of blocks a thread compresses */
+#define COMPRESS_BLOCKS_PER_THREAD 1024
+
+typedef void (* encode_block_func_t) (unsigned char       *dst,
+                                      const unsigned char *block,
+                                      int                  flags);
+
+typedef struct
 {
-  const unsigned int block_count = BLOCK_COUNT(w, h);
-  unsigned int i;
-  unsigned char block[64], *p;
-  int x, y;
+  unsigned char       *dst;
+  const unsigned char *src;
+  int                  w;
+  int                  h;
+  int                  block_size;
+  int                  flags;
+  encode_block_func_t  encode_block;
+} compress_data_t;
 
-#ifdef _OPENMP
-#pragma omp parallel for schedule(dynamic, 256) private(block, p, x, y)
-#endif
-  for (i = 0; i < block_count; ++i)
-    {
-      x = (i % ((w + 3) >> 2)) << 2;
-      y = (i / ((w + 3) >> 2)) << 2;
-      p = dst + BLOCK_OFFSET(x, y, w, 8);
-      extract_block(src, x, y, w, h, block);
-      encode_color_block(p, block, DXT_BC1 | flags);
-    }
+static void
+encode_block_BC1 (unsigned char       *dst,
+                  const unsigned char *block,
+                  int                  flags)
+{
+  encode_color_block(dst, block, DXT_BC1 | flags);
 }
 
 static void
-compress_BC2 (unsigned char       *dst,
-              const unsigned char *src,
-              int                  w,
-              int                  h,
-              int                  flags)
+encode_block_BC2 (unsigned char       *dst,
+                  const unsigned char *block,
+                  int                  flags)
 {
-  const unsigned int block_count = BLOCK_COUNT(w, h);
-  unsigned int i;
-  unsigned char block[64], *p;
-  int x, y;
-
-#ifdef _OPENMP
-#pragma omp parallel for schedule(dynamic, 256) private(block, p, x, y)
-#endif
-  for (i = 0; i < block_count; ++i)
-    {
-      x = (i % ((w + 3) >> 2)) << 2;
-      y = (i / ((w + 3) >> 2)) << 2;
-      p = dst + BLOCK_OFFSET(x, y, w, 16);
-      extract_block(src, x, y, w, h, block);
-      encode_alpha_block_BC2(p, block);
-      encode_color_block(p + 8, block, DXT_BC2 | flags);
-    }
+  encode_alpha_block_BC2(dst, block);
+  encode_color_block(dst + 8, block, DXT_BC2 | flags);
 }
 
 static void
-compress_BC3 (unsigned char       *dst,
-              const unsigned char *src,
-              int                  w,
-              int                  h,
-              int                  flags)
+encode_block_BC3 (unsigned char       *dst,
+                  const unsigned char *block,
+                  int                  flags)
 {
-  const unsigned int block_count = BLOCK_COUNT(w, h);
-  unsigned int i;
-  unsigned char block[64], *p;
-  int x, y;
+  encode_alpha_block_BC3(dst, block, 0);
+  encode_color_block(dst + 8, block, DXT_BC3 | flags);
+}
 
-#ifdef _OPENMP
-#pragma omp parallel for schedule(dynamic, 256) private(block, p, x, y)
-#endif
-  for (i = 0; i < block_count; ++i)
-    {
-      x = (i % ((w + 3) >> 2)) << 2;
-      y = (i / ((w + 3) >> 2)) << 2;
-      p = dst + BLOCK_OFFSET(x, y, w, 16);
-      extract_block(src, x, y, w, h, block);
-      encode_alpha_block_BC3(p, block, 0);
-      encode_color_block(p + 8, block, DXT_BC3 | flags);
-    }
+static void
+encode_block_BC4 (unsigned char       *dst,
+                  const unsigned char *block,
+                  int                  flags)
+{
+  encode_alpha_block_BC3(dst, block, -1);
 }
 
 static void
-compress_BC4 (unsigned char       *dst,
-              const unsigned char *src,
-              int                  w,
-              int                  h)
+encode_block_BC5 (unsigned char       *dst,
+                  const unsigned char *block,
+                  int                  flags)
 {
-  const unsigned int block_count = BLOCK_COUNT(w, h);
-  unsigned int i;
-  unsigned char block[64], *p;
-  int x, y;
+  /* Pixels are ordered as BGRA (see write_layer)
+   * First we encode red  -1+3: channel 2;
+   * then we encode green -2+3: channel 1.
+   */
+  encode_alpha_block_BC3(dst, block, -1);
+  encode_alpha_block_BC3(dst + 8, block, -2);
+}
 
-#ifdef _OPENMP
-#pragma omp parallel for schedule(dynamic, 256) private(block, p, x, y)
-#endif
-  for (i = 0; i < block_count; ++i)
-    {
-      x = (i % ((w + 3) >> 2)) << 2;
-      y = (i / ((w + 3) >> 2)) << 2;
-      p = dst + BLOCK_OFFSET(x, y, w, 8);
-      extract_block(src, x, y, w, h, block);
-      encode_alpha_block_BC3(p, block, -1);
-    }
+static void
+encode_block_YCoCg (unsigned char       *dst,
+                    const unsigned char *block,
+                    int                  flags)
+{
+  encode_alpha_block_BC3(dst, block, 0);
+  encode_YCoCg_block(dst + 8, block);
 }
 
 static void
-compress_BC5 (unsigned char       *dst,
-              const unsigned char *src,
-              int                  w,
-              int                  h)
+compress_block_rows (gsize            offset,
+                     gsize            size,
+                     compress_data_t *data)
 {
-  const unsigned int block_count = BLOCK_COUNT(w, h);
-  unsigned int i;
-  unsigned char block[64], *p;
-  int x, y;
+  const int bw = (data->w + 3) >> 2;
+  unsigned char block[64];
+  gsize by;
+  int bx, x, y;
 
-#ifdef _OPENMP
-#pragma omp parallel for schedule(dynamic, 256) private(block, p, x, y)
-#endif
-  for (i = 0; i < block_count; ++i)
+  for (by = offset; by < offset + size; ++by)
     {
-      x = (i % ((w + 3) >> 2)) << 2;
-      y = (i / ((w + 3) >> 2)) << 2;
-      p = dst + BLOCK_OFFSET(x, y, w, 16);
-      extract_block(src, x, y, w, h, block);
-      /* Pixels are ordered as BGRA (see write_layer)
-       * First we encode red  -1+3: channel 2;
-       * then we encode green -2+3: channel 1.
-       */
-      encode_alpha_block_BC3(p, block, -1);
-      encode_alpha_block_BC3(p + 8, block, -2);
+      y = by << 2;
+
+      for (bx = 0; bx < bw; ++bx)
+        {
+          x = bx << 2;
+          extract_block(data->src, x, y, data->w, data->h, block);
+          data->encode_block(data->dst + BLOCK_OFFSET(x, y, data->w,
+                                                      data->block_size),
+                             block, data->flags);
+        }
     }
 }
 
+/* compress the blocks of one mipmap level, distributing whole rows of
+ * blocks over GEGL's worker threads
+ */
 static void
-compress_YCoCg (unsigned char       *dst,
-                const unsigned char *src,
-                int                  w,
-                int                  h)
+compress_blocks (unsigned char       *dst,
+                 const unsigned char *src,
+                 int                  w,
+                 int                  h,
+                 int                  block_size,
+                 int                  flags,
+                 encode_block_func_t  encode_block)
 {
-  const unsigned int block_count = BLOCK_COUNT(w, h);
-  unsigned int i;
-  unsigned char block[64], *p;
-  int x, y;
-
-#ifdef _OPENMP
-#pragma omp parallel for schedule(dynamic, 256) private(block, p, x, y)
-#endif
-  for (i = 0; i < block_count; ++i)
-    {
-      x = (i % ((w + 3) >> 2)) << 2;
-      y = (i / ((w + 3) >> 2)) << 2;
-      p = dst + BLOCK_OFFSET(x, y, w, 16);
-      extract_block(src, x, y, w, h, block);
-      encode_alpha_block_BC3(p, block, 0);
-      encode_YCoCg_block(p + 8, block);
-    }
+  compress_data_t data;
+  const int bw = (w + 3) >> 2;
+  const int bh = (h + 3) >> 2;
+
+  data.dst          = dst;
+  data.src          = src;
+  data.w            = w;
+  data.h            = h;
+  data.block_size   = block_size;
+  data.flags        = flags;
+  data.encode_block = encode_block;
+
+  gegl_parallel_distribute_range(bh,
+                                 MAX(1, COMPRESS_BLOCKS_PER_THREAD / bw),
+                                 (GeglParallelDistributeRangeFunc) compress_block_rows,
+                                 &data);
 }
 
 int
@@ -1250,29 +1224,36 @@ dxt_compress (unsigned char *dst,
       switch (format)
         {
         case DDS_COMPRESS_BC1:
-          compress_BC1(dst + offset, s, w, h, flags);
+          compress_blocks(dst + offset, s, w, h, 8, flags,
+                          encode_block_BC1);
           break;
         case DDS_COMPRESS_BC2:
-          compress_BC2(dst + offset, s, w, h, flags);
+          compress_blocks(dst + offset, s, w, h, 16, flags,
+                          encode_block_BC2);
           break;
         case DDS_COMPRESS_BC3:
         case DDS_COMPRESS_BC3N:
         case DDS_COMPRESS_RXGB:
         case DDS_COMPRESS_AEXP:
         case DDS_COMPRESS_YCOCG:
-          compress_BC3(dst + offset, s, w, h, flags);
+          compress_blocks(dst + offset, s, w, h, 16, flags,
+                          encode_block_BC3);
           break;
         case DDS_COMPRESS_BC4:
-          compress_BC4(dst + offset, s, w, h);
+          compress_blocks(dst + offset, s, w, h, 8, 0,
+                          encode_block_BC4);
           break;
         case DDS_COMPRESS_BC5:
-          compress_BC5(dst + offset, s, w, h);
+          compress_blocks(dst + offset, s, w, h, 16, 0,
+                          encode_block_BC5);
           break;
         case DDS_COMPRESS_YCOCGS:
-          compress_YCoCg(dst + offset, s, w, h);
+          compress_blocks(dst + offset, s, w, h, 16, 0,
+                          encode_block_YCoCg);
           break;
         default:
-          compress_BC3(dst + offset, s, w, h, flags);
+          compress_blocks(dst + offset, s, w, h, 16, flags,
+                          encode_block_BC3);
           break;
         }
       s += (w * h * bpp);
@@ -1464,63 +1445,107 @@ put_block (unsigned char *dst,
     }
 }
 
-int
-dxt_decompress (unsigned char *dst,
-                unsigned char *src,
-                int            format,
-                unsigned int   size,
-                unsigned int   width,
-                unsigned int   height,
-                int            bpp,
-                int            normals)
+/* minimum number of blocks a thread decompresses */
+#define DECOMPRESS_BLOCKS_PER_THREAD 4096
+
+typedef struct
 {
+  unsigned char *dst;
+  unsigned char *src;
+  int            format;
+  unsigned int   width;
+  unsigned int   height;
+  int            bpp;
+  int            normals;
+} decompress_data_t;
+
+static void
+decompress_block_rows (gsize              offset,
+                       gsize              size,
+                       decompress_data_t *data)
+{
+  const int format = data->format;
+  const unsigned int bw = (data->width + 3) >> 2;
+  const unsigned int block_size =
+    (format == DDS_COMPRESS_BC1 || format == DDS_COMPRESS_BC4) ? 8 : 16;
   unsigned char *s;
   unsigned int x, y;
   unsigned char block[16 * 4];
+  gsize by;
 
-  s = src;
-
-  for (y = 0; y < height; y += 4)
+  for (by = offset; by < offset + size; ++by)
     {
-      for (x = 0; x < width; x += 4)
+      y = by << 2;
+      s = data->src + by * bw * block_size;
+
+      for (x = 0; x < data->width; x += 4)
         {
           memset(block, 0, 16 * 4);
 
           if (format == DDS_COMPRESS_BC1)
             {
               decode_color_block(block, s, format);
-              s += 8;
             }
           else if (format == DDS_COMPRESS_BC2)
             {
               decode_alpha_block_BC2(block + 3, s);
               decode_color_block(block, s + 8, format);
-              s += 16;
             }
           else if (format == DDS_COMPRESS_BC3)
             {
-              decode_alpha_block_BC3(block + 3, s, width);
+              decode_alpha_block_BC3(block + 3, s, data->width);
               decode_color_block(block, s + 8, format);
-              s += 16;
             }
           else if (format == DDS_COMPRESS_BC4)
             {
-              decode_alpha_block_BC3(block, s, width);
-              s += 8;
+              decode_alpha_block_BC3(block, s, data->width);
             }
           else if (format == DDS_COMPRESS_BC5)
             {
-              decode_alpha_block_BC3(block, s, width);
-              decode_alpha_block_BC3(block + 1, s + 8, width);
-              s += 16;
+              decode_alpha_block_BC3(block, s, data->width);
+              decode_alpha_block_BC3(block + 1, s + 8, data->width);
             }
 
-          if (normals)
+          s += block_size;
+
+          if (data->normals)
             normalize_block(block, format);
 
-          put_block(dst, block, x, y, width, height, bpp);
+          put_block(data->dst, block, x, y, data->width, data->height,
+                    data->bpp);
         }
     }
+}
+
+int
+dxt_decompress (unsigned char *dst,
+                unsigned char *src,
+                int            format,
+                unsigned int   size,
+                unsigned int   width,
+                unsigned int   height,
+                int            bpp,
+                int            normals)
+{
+  decompress_data_t data;
+  const unsigned int bw = (width + 3) >> 2;
+  const unsigned int bh = (height + 3) >> 2;
+
+  data.dst     = dst;
+  data.src     = src;
+  data.format  = format;
+  data.width   = width;
+  data.height  = height;
+  data.bpp     = bpp;
+  data.normals = normals;
+
+  /* every row of blocks starts at a fixed offset, so the rows can be
+   * decoded independently
+   */
+  gegl_parallel_distribute_range(bh,
+                                 MAX(1, DECOMPRESS_BLOCKS_PER_THREAD / bw),
+                                 (GeglParallelDistributeRangeFunc) decompress_block_rows,
+                                 &data);
 
   return 1;
 }
@@ -25,6 +25,7 @@
 #include "openexr-wrapper.h"
 
 #define LOAD_PROC       "file-exr-load"
+#define SAVE_PROC       "file-exr-save"
 #define PLUG_IN_BINARY  "file-exr"
 #define PLUG_IN_VERSION "0.0.0"
 
@@ -57,10 +58,24 @@ static GimpValueArray * exr_load             (GimpProcedure        *procedure,
                                               GFile                *file,
                                               const GimpValueArray *args,
                                               gpointer              run_data);
+static GimpValueArray * exr_save             (GimpProcedure        *procedure,
+                                              GimpRunMode           run_mode,
+                                              GimpImage            *image,
+                                              gint                  n_drawables,
+                                              GimpDrawable        **drawables,
+                                              GFile                *file,
+                                              const GimpValueArray *args,
+                                              gpointer              run_data);
 
 static GimpImage      * load_image           (GFile                *file,
                                               gboolean              interactive,
                                               GError              **error);
+static gboolean         save_image           (GFile                *file,
+                                              GimpDrawable         *drawable,
+                                              GObject              *config,
+                                              GError              **error);
+static gboolean         save_dialog          (GimpProcedure        *procedure,
+                                              GObject              *config);
 static void             sanitize_comment     (gchar                *comment);
 
 
@@ -86,7 +101,12 @@ exr_init (Exr *exr)
 static GList *
 exr_query_procedures (GimpPlugIn *plug_in)
 {
-  return g_list_append (NULL, g_strdup (LOAD_PROC));
+  GList *list = NULL;
+
+  list = g_list_append (list, g_strdup (LOAD_PROC));
+  list = g_list_append (list, g_strdup (SAVE_PROC));
+
+  return list;
 }
 
 static GimpProcedure *
@@ -121,6 +141,60 @@ exr_create_procedure (GimpPlugIn  *plug_in,
       gimp_file_procedure_set_magics (GIMP_FILE_PROCEDURE (procedure),
                                       "0,long,0x762f3101");
     }
+  else if (! strcmp (name, SAVE_PROC))
+    {
+      procedure = gimp_save_procedure_new (plug_in, name,
+                                           GIMP_PDB_PROC_TYPE_PLUGIN,
+                                           exr_save, NULL, NULL);
+
+      gimp_procedure_set_image_types (procedure, "RGB*, GRAY*");
+
+      gimp_procedure_set_menu_label (procedure, N_("OpenEXR image"));
+
+      gimp_procedure_set_documentation (procedure,
+                                        "Saves files in the OpenEXR file format",
+                                        "This plug-in saves OpenEXR files, "
+                                        "as linear half or float data, in "
+                                        "scanline or tiled layout.",
+                                        name);
+      gimp_procedure_set_attribution (procedure,
+                                      "agent <agent@local>",
+                                      "agent <agent@local>",
+                                      "2026");
+
+      gimp_file_procedure_set_mime_types (GIMP_FILE_PROCEDURE (procedure),
+                                          "image/x-exr");
+      gimp_file_procedure_set_extensions (GIMP_FILE_PROCEDURE (procedure),
+                                          "exr");
+
+      GIMP_PROC_ARG_INT (procedure, "compression",
+                         "Compression",
+                         "Compression type { NONE (0), RLE (1), ZIPS (2), "
+                         "ZIP (3), PIZ (4), PXR24 (5), B44 (6), B44A (7), "
+                         "DWAA (8), DWAB (9) }",
+                         EXR_COMPRESSION_NONE, EXR_COMPRESSION_DWAB,
+                         EXR_COMPRESSION_ZIP,
+                         G_PARAM_READWRITE);
+
+      GIMP_PROC_ARG_BOOLEAN (procedure, "save-half",
+                             "Save half",
+                             "Save 16-bit half floats instead of "
+                             "32-bit floats",
+                             TRUE,
+                             G_PARAM_READWRITE);
+
+      GIMP_PROC_ARG_BOOLEAN (procedure, "tiled",
+                             "Tiled",
+                             "Save a tiled file instead of scanlines",
+                             FALSE,
+                             G_PARAM_READWRITE);
+
+      GIMP_PROC_ARG_INT (procedure, "tile-size",
+                         "Tile size",
+                         "Width and height of the tiles of a tiled file",
+                         16, 512, 64,
+                         G_PARAM_READWRITE);
+    }
 
   return procedure;
 }
@@ -156,6 +230,82 @@ exr_load (GimpProcedure        *procedure,
   return return_vals;
 }
 
+static GimpValueArray *
+exr_save (GimpProcedure        *procedure,
+          GimpRunMode           run_mode,
+          GimpImage            *image,
+          gint                  n_drawables,
+          GimpDrawable        **drawables,
+          GFile                *file,
+          const GimpValueArray *args,
+          gpointer              run_data)
+{
+  GimpProcedureConfig *config;
+  GimpPDBStatusType    status = GIMP_PDB_SUCCESS;
+  GimpExportReturn     export = GIMP_EXPORT_CANCEL;
+  GError              *error  = NULL;
+
+  INIT_I18N ();
+  gegl_init (NULL, NULL);
+
+  config = gimp_procedure_create_config (procedure);
+  gimp_procedure_config_begin_run (config, image, run_mode, args);
+
+  switch (run_mode)
+    {
+    case GIMP_RUN_INTERACTIVE:
+    case GIMP_RUN_WITH_LAST_VALS:
+      gimp_ui_init (PLUG_IN_BINARY);
+
+      export = gimp_export_image (&image, &n_drawables, &drawables, "OpenEXR",
+                                  GIMP_EXPORT_CAN_HANDLE_RGB  |
+                                  GIMP_EXPORT_CAN_HANDLE_GRAY |
+                                  GIMP_EXPORT_CAN_HANDLE_ALPHA);
+
+      if (export == GIMP_EXPORT_CANCEL)
+        return gimp_procedure_new_return_values (procedure,
+                                                 GIMP_PDB_CANCEL,
+                                                 NULL);
+      break;
+
+    default:
+      break;
+    }
+
+  if (n_drawables != 1)
+    {
+      g_set_error (&error, G_FILE_ERROR, 0,
+                   _("OpenEXR format does not support multiple layers."));
+
+      return gimp_procedure_new_return_values (procedure,
+                                               GIMP_PDB_CALLING_ERROR,
+                                               error);
+    }
+
+  if (run_mode == GIMP_RUN_INTERACTIVE)
+    {
+      if (! save_dialog (procedure, G_OBJECT (config)))
+        status = GIMP_PDB_CANCEL;
+    }
+
+  if (status == GIMP_PDB_SUCCESS)
+    {
+      if (! save_image (file, drawables[0], G_OBJECT (config), &error))
+        status = GIMP_PDB_EXECUTION_ERROR;
+    }
+
+  gimp_procedure_config_end_run (config, status);
+  g_object_unref (config);
+
+  if (export == GIMP_EXPORT_EXPORT)
+    {
+      gimp_image_delete (image);
+      g_free (drawables);
+    }
+
+  return gimp_procedure_new_return_values (procedure, status, error);
+}
+
 static GimpImage *
 load_image (GFile        *file,
             gboolean      interactive,
@@ -285,25 +435,19 @@ load_image (GFile        *file,
     {
       gint end;
       gint num;
-      gint i;
+      gint retval;
 
       end = MIN (begin + tile_height, height);
       num = end - begin;
 
-      for (i = 0; i < num; i++)
+      retval = exr_loader_read_pixel_rows (loader, pixels, bpp, begin, num);
+
+      if (retval < 0)
         {
-          gint retval;
-
-          retval = exr_loader_read_pixel_row (loader,
-                                              pixels + (i * width * bpp),
-                                              bpp, begin + i);
-          if (retval < 0)
-            {
-              g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_FAILED,
-                           _("Error reading pixel data from '%s'"),
-                           gimp_file_get_utf8_name (file));
-              goto out;
-            }
+          g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_FAILED,
+                       _("Error reading pixel data from '%s'"),
+                       gimp_file_get_utf8_name (file));
+          goto out;
         }
 
       gegl_buffer_set (buffer, GEGL_RECTANGLE (0, begin, width, num),
@@ -379,6 +523,194 @@ load_image (GFile        *file,
   return NULL;
 }
 
+static gboolean
+save_image (GFile        *file,
+            GimpDrawable *drawable,
+            GObject      *config,
+            GError      **error)
+{
+  EXRWriter      *writer;
+  EXRCompression  compression;
+  EXRImageType    image_type;
+  gboolean        save_half;
+  gboolean        tiled;
+  gint            tile_size;
+  gint            width;
+  gint            height;
+  gboolean        has_alpha;
+  const Babl     *format;
+  GeglBuffer     *buffer;
+  gchar          *pixels;
+  gint            bpp;
+  gint            band_height;
+  gint            begin;
+  gboolean        success = FALSE;
+
+  g_object_get (config,
+                "compression", &compression,
+                "save-half",   &save_half,
+                "tiled",       &tiled,
+                "tile-size",   &tile_size,
+                NULL);
+
+  gimp_progress_init_printf (_("Exporting '%s'"),
+                             gimp_file_get_utf8_name (file));
+
+  width     = gimp_drawable_get_width (drawable);
+  height    = gimp_drawable_get_height (drawable);
+  has_alpha = gimp_drawable_has_alpha (drawable);
+
+  /* the file carries no chromaticities, so readers will assume sRGB
+   * primaries; the alpha channel is kept unassociated, like our loader
+   * expects it.
+   */
+  if (gimp_drawable_is_gray (drawable))
+    {
+      image_type = IMAGE_TYPE_GRAY;
+
+      if (has_alpha)
+        format = babl_format (save_half ? "YA half" : "YA float");
+      else
+        format = babl_format (save_half ? "Y half" : "Y float");
+    }
+  else
+    {
+      image_type = IMAGE_TYPE_RGB;
+
+      if (has_alpha)
+        format = babl_format (save_half ? "RGBA half" : "RGBA float");
+      else
+        format = babl_format (save_half ? "RGB half" : "RGB float");
+    }
+
+  writer = exr_writer_new (g_file_peek_path (file),
+                           width, height, image_type, has_alpha,
+                           save_half ? PREC_HALF : PREC_FLOAT,
+                           compression,
+                           tiled ? tile_size : 0);
+
+  if (! writer)
+    {
+      g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_FAILED,
+                   _("Could not open '%s' for writing"),
+                   gimp_file_get_utf8_name (file));
+      return FALSE;
+    }
+
+  buffer = gimp_drawable_get_buffer (drawable);
+  bpp    = babl_format_get_bytes_per_pixel (format);
+
+  /* a tiled file is written a row of tiles at a time */
+  band_height = tiled ? tile_size : gimp_tile_height ();
+  pixels      = g_new (gchar, (gsize) band_height * width * bpp);
+
+  for (begin = 0; begin < height; begin += band_height)
+    {
+      gint num = MIN (band_height, height - begin);
+
+      gegl_buffer_get (buffer, GEGL_RECTANGLE (0, begin, width, num), 1.0,
+                       format, pixels,
+                       GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
+
+      if (exr_writer_write_pixel_rows (writer, pixels, bpp, begin, num) < 0)
+        {
+          g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_FAILED,
+                       _("Error writing pixel data to '%s'"),
+                       gimp_file_get_utf8_name (file));
+          goto out;
+        }
+
+      gimp_progress_update ((gdouble) (begin + num) / (gdouble) height);
+    }
+
+  gimp_progress_update (1.0);
+
+  success = TRUE;
+
+ out:
+  exr_writer_free (writer);
+
+  g_object_unref (buffer);
+  g_free (pixels);
+
+  return success;
+}
+
+static gboolean
+save_dialog (GimpProcedure *procedure,
+             GObject       *config)
+{
+  GtkWidget    *dialog;
+  GtkWidget    *main_vbox;
+  GtkWidget    *grid;
+  GtkWidget    *combo;
+  GtkWidget    *button;
+  GtkWidget    *spin;
+  GtkListStore *store;
+  gboolean      run;
+
+  dialog = gimp_procedure_dialog_new (procedure,
+                                      GIMP_PROCEDURE_CONFIG (config),
+                                      _("Export Image as OpenEXR"));
+
+  main_vbox = gtk_box_new (GTK_ORIENTATION_VERTICAL, 12);
+  gtk_container_set_border_width (GTK_CONTAINER (main_vbox), 12);
+  gtk_box_pack_start (GTK_BOX (gtk_dialog_get_content_area (GTK_DIALOG (dialog))),
+                      main_vbox, FALSE, FALSE, 0);
+  gtk_widget_show (main_vbox);
+
+  grid = gtk_grid_new ();
+  gtk_grid_set_column_spacing (GTK_GRID (grid), 6);
+  gtk_grid_set_row_spacing (GTK_GRID (grid), 6);
+  gtk_box_pack_start (GTK_BOX (main_vbox), grid, FALSE, FALSE, 0);
+  gtk_widget_show (grid);
+
+  store = gimp_int_store_new (_("None"),  EXR_COMPRESSION_NONE,
+                              _("RLE"),   EXR_COMPRESSION_RLE,
+                              _("ZIP (single scanline)"),
+                                          EXR_COMPRESSION_ZIPS,
+                              _("ZIP"),   EXR_COMPRESSION_ZIP,
+                              _("PIZ"),   EXR_COMPRESSION_PIZ,
+                              _("PXR24"), EXR_COMPRESSION_PXR24,
+                              _("B44"),   EXR_COMPRESSION_B44,
+                              _("B44A"),  EXR_COMPRESSION_B44A,
+                              _("DWAA"),  EXR_COMPRESSION_DWAA,
+                              _("DWAB"),  EXR_COMPRESSION_DWAB,
+                              NULL);
+
+  combo = gimp_prop_int_combo_box_new (config, "compression",
+                                       GIMP_INT_STORE (store));
+  g_object_unref (store);
+  gimp_grid_attach_aligned (GTK_GRID (grid), 0, 0,
+                            _("Co_mpression:"), 0.0, 0.5,
+                            combo, 2);
+
+  spin = gimp_prop_spin_button_new (config, "tile-size", 16, 64, 0);
+  gimp_grid_attach_aligned (GTK_GRID (grid), 0, 1,
+                            _("Tile si_ze:"), 0.0, 0.5,
+                            spin, 1);
+
+  g_object_bind_property (config, "tiled",
+                          spin,   "sensitive",
+                          G_BINDING_SYNC_CREATE);
+
+  button = gimp_prop_check_button_new (config, "tiled",
+                                       _("Save _tiled"));
+  gtk_box_pack_start (GTK_BOX (main_vbox), button, FALSE, FALSE, 0);
+
+  button = gimp_prop_check_button_new (config, "save-half",
+                                       _("Save as _half floats"));
+  gtk_box_pack_start (GTK_BOX (main_vbox), button, FALSE, FALSE, 0);
+
+  gtk_widget_show (dialog);
+
+  run = gimp_procedure_dialog_run (GIMP_PROCEDURE_DIALOG (dialog));
+
+  gtk_widget_destroy (dialog);
+
+  return run;
+}
+
 /* copy & pasted from file-jpeg/jpeg-load.c */
 static void
 sanitize_comment (gchar *comment)
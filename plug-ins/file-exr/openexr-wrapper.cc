@@ -51,11 +51,15 @@
 /* ignore deprecated warnings from OpenEXR headers */
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated"
+#include <OpenEXRConfig.h>
 #include <ImfInputFile.h>
+#include <ImfOutputFile.h>
+#include <ImfTiledOutputFile.h>
 #include <ImfChannelList.h>
 #include <ImfRgbaFile.h>
 #include <ImfRgbaYca.h>
 #include <ImfStandardAttributes.h>
+#include <ImfThreading.h>
 #pragma GCC diagnostic pop
 
 #include "exr-attribute-blob.h"
@@ -149,40 +153,43 @@ struct _EXRLoader
       }
   }
 
-  int readPixelRow(char* pixels,
-                   int bpp,
-                   int row)
+  int readPixelRows(char* pixels,
+                    int bpp,
+                    int row,
+                    int n_rows)
   {
     const int actual_row = data_window_.min.y + row;
+    const size_t stride = (size_t) getWidth() * bpp;
     FrameBuffer fb;
     // This is necessary because OpenEXR expects the buffer to begin at
     // (0, 0). Though it probably results in some unmapped address,
     // hopefully OpenEXR will not make use of it. :/
-    char* base = pixels - (data_window_.min.x * bpp);
+    char* base = pixels - (data_window_.min.x * bpp) -
+                 ((ptrdiff_t) actual_row * (ptrdiff_t) stride);
 
     switch (image_type_)
       {
       case IMAGE_TYPE_GRAY:
-        fb.insert("Y", Slice(pt_, base, bpp, 0, 1, 1, 0.5));
+        fb.insert("Y", Slice(pt_, base, bpp, stride, 1, 1, 0.5));
         if (hasAlpha())
           {
-            fb.insert("A", Slice(pt_, base + bpc_, bpp, 0, 1, 1, 1.0));
+            fb.insert("A", Slice(pt_, base + bpc_, bpp, stride, 1, 1, 1.0));
           }
         break;
 
       case IMAGE_TYPE_RGB:
       default:
-        fb.insert("R", Slice(pt_, base + (bpc_ * 0), bpp, 0, 1, 1, 0.0));
-        fb.insert("G", Slice(pt_, base + (bpc_ * 1), bpp, 0, 1, 1, 0.0));
-        fb.insert("B", Slice(pt_, base + (bpc_ * 2), bpp, 0, 1, 1, 0.0));
+        fb.insert("R", Slice(pt_, base + (bpc_ * 0), bpp, stride, 1, 1, 0.0));
+        fb.insert("G", Slice(pt_, base + (bpc_ * 1), bpp, stride, 1, 1, 0.0));
+        fb.insert("B", Slice(pt_, base + (bpc_ * 2), bpp, stride, 1, 1, 0.0));
         if (hasAlpha())
           {
-            fb.insert("A", Slice(pt_, base + (bpc_ * 3), bpp, 0, 1, 1, 1.0));
+            fb.insert("A", Slice(pt_, base + (bpc_ * 3), bpp, stride, 1, 1, 1.0));
           }
       }
 
     file_.setFrameBuffer(fb);
-    file_.readPixels(actual_row);
+    file_.readPixels(actual_row, actual_row + n_rows - 1);
 
     return 0;
   }
@@ -394,6 +401,11 @@ exr_loader_new (const char *filename)
   try
     {
       Imf::BlobAttribute::registerAttributeType();
+
+      // Let OpenEXR decompress line buffers or tiles in parallel when
+      // reading more than one of them at once.
+      Imf::setGlobalThreadCount(gimp_get_num_processors());
+
       file = new EXRLoader(filename);
     }
   catch (...)
@@ -502,16 +514,212 @@ exr_loader_get_xmp (EXRLoader *loader,
 }
 
 int
-exr_loader_read_pixel_row (EXRLoader *loader,
-                           char *pixels,
-                           int bpp,
-                           int row)
+exr_loader_read_pixel_rows (EXRLoader *loader,
+                            char *pixels,
+                            int bpp,
+                            int row,
+                            int n_rows)
+{
+  int retval = -1;
+  // Don't let any exceptions propagate to the C layer.
+  try
+    {
+      retval = loader->readPixelRows(pixels, bpp, row, n_rows);
+    }
+  catch (...)
+    {
+      retval = -1;
+    }
+
+  return retval;
+}
+
+struct _EXRWriter
+{
+  _EXRWriter(const char*    filename,
+             int            width,
+             int            height,
+             EXRImageType   image_type,
+             bool           has_alpha,
+             EXRPrecision   precision,
+             EXRCompression compression,
+             int            tile_size) :
+    header_(width, height),
+    file_(NULL),
+    tiled_file_(NULL),
+    pt_(precision == PREC_HALF ? HALF : FLOAT),
+    bpc_(precision == PREC_HALF ? 2 : 4),
+    width_(width),
+    image_type_(image_type),
+    has_alpha_(has_alpha),
+    tile_size_(tile_size)
+  {
+    header_.compression() = getCompression(compression);
+
+    switch (image_type_)
+      {
+      case IMAGE_TYPE_GRAY:
+        header_.channels().insert("Y", Channel(pt_));
+        break;
+
+      case IMAGE_TYPE_RGB:
+      default:
+        header_.channels().insert("R", Channel(pt_));
+        header_.channels().insert("G", Channel(pt_));
+        header_.channels().insert("B", Channel(pt_));
+      }
+
+    if (has_alpha_)
+      header_.channels().insert("A", Channel(pt_));
+
+    if (tile_size_ > 0)
+      {
+        header_.setTileDescription(TileDescription(tile_size_, tile_size_,
+                                                   ONE_LEVEL));
+        tiled_file_ = new TiledOutputFile(filename, header_);
+      }
+    else
+      {
+        file_ = new OutputFile(filename, header_);
+      }
+  }
+
+  ~_EXRWriter()
+  {
+    delete file_;
+    delete tiled_file_;
+  }
+
+  static Compression getCompression(EXRCompression compression)
+  {
+    switch (compression)
+      {
+      case EXR_COMPRESSION_NONE:  return NO_COMPRESSION;
+      case EXR_COMPRESSION_RLE:   return RLE_COMPRESSION;
+      case EXR_COMPRESSION_ZIPS:  return ZIPS_COMPRESSION;
+      case EXR_COMPRESSION_ZIP:   return ZIP_COMPRESSION;
+      case EXR_COMPRESSION_PIZ:   return PIZ_COMPRESSION;
+      case EXR_COMPRESSION_PXR24: return PXR24_COMPRESSION;
+      case EXR_COMPRESSION_B44:   return B44_COMPRESSION;
+      case EXR_COMPRESSION_B44A:  return B44A_COMPRESSION;
+#if defined(OPENEXR_VERSION_MAJOR) && \
+    (OPENEXR_VERSION_MAJOR > 2 || \
+     (OPENEXR_VERSION_MAJOR == 2 && OPENEXR_VERSION_MINOR >= 2))
+      case EXR_COMPRESSION_DWAA:  return DWAA_COMPRESSION;
+      case EXR_COMPRESSION_DWAB:  return DWAB_COMPRESSION;
+#endif
+      default:                    return ZIP_COMPRESSION;
+      }
+  }
+
+  int writePixelRows(const char* pixels,
+                     int bpp,
+                     int row,
+                     int n_rows)
+  {
+    const size_t stride = (size_t) width_ * bpp;
+    FrameBuffer fb;
+    // The data window starts at (0, 0), so only the rows before this
+    // band need to be skipped.
+    char* base = (char*) pixels - ((ptrdiff_t) row * (ptrdiff_t) stride);
+
+    switch (image_type_)
+      {
+      case IMAGE_TYPE_GRAY:
+        fb.insert("Y", Slice(pt_, base, bpp, stride));
+        if (has_alpha_)
+          {
+            fb.insert("A", Slice(pt_, base + bpc_, bpp, stride));
+          }
+        break;
+
+      case IMAGE_TYPE_RGB:
+      default:
+        fb.insert("R", Slice(pt_, base + (bpc_ * 0), bpp, stride));
+        fb.insert("G", Slice(pt_, base + (bpc_ * 1), bpp, stride));
+        fb.insert("B", Slice(pt_, base + (bpc_ * 2), bpp, stride));
+        if (has_alpha_)
+          {
+            fb.insert("A", Slice(pt_, base + (bpc_ * 3), bpp, stride));
+          }
+      }
+
+    // Handing OpenEXR several line buffers or tiles at once lets its
+    // thread pool compress them in parallel.
+    if (tiled_file_)
+      {
+        tiled_file_->setFrameBuffer(fb);
+        tiled_file_->writeTiles(0, tiled_file_->numXTiles() - 1,
+                                row / tile_size_,
+                                (row + n_rows - 1) / tile_size_);
+      }
+    else
+      {
+        file_->setFrameBuffer(fb);
+        file_->writePixels(n_rows);
+      }
+
+    return 0;
+  }
+
+  Header header_;
+  OutputFile* file_;
+  TiledOutputFile* tiled_file_;
+  PixelType pt_;
+  int bpc_;
+  int width_;
+  EXRImageType image_type_;
+  bool has_alpha_;
+  int tile_size_;
+};
+
+EXRWriter*
+exr_writer_new (const char     *filename,
+                int             width,
+                int             height,
+                EXRImageType    image_type,
+                int             has_alpha,
+                EXRPrecision    precision,
+                EXRCompression  compression,
+                int             tile_size)
+{
+  EXRWriter* writer;
+
+  // Don't let any exceptions propagate to the C layer.
+  try
+    {
+      Imf::setGlobalThreadCount(gimp_get_num_processors());
+
+      writer = new EXRWriter(filename, width, height, image_type,
+                             has_alpha ? true : false, precision,
+                             compression, tile_size);
+    }
+  catch (...)
+    {
+      writer = NULL;
+    }
+
+  return writer;
+}
+
+void
+exr_writer_free (EXRWriter *writer)
+{
+  delete writer;
+}
+
+int
+exr_writer_write_pixel_rows (EXRWriter  *writer,
+                             const char *pixels,
+                             int         bpp,
+                             int         row,
+                             int         n_rows)
 {
   int retval = -1;
   // Don't let any exceptions propagate to the C layer.
   try
     {
-      retval = loader->readPixelRow(pixels, bpp, row);
+      retval = writer->writePixelRows(pixels, bpp, row, n_rows);
     }
   catch (...)
     {
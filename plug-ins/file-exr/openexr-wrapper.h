@@ -24,6 +24,7 @@ G_BEGIN_DECLS
  * exposed to more than this.
  */
 typedef struct _EXRLoader EXRLoader;
+typedef struct _EXRWriter EXRWriter;
 
 typedef enum
 {
@@ -38,6 +39,20 @@ typedef enum
   IMAGE_TYPE_GRAY
 } EXRImageType;
 
+typedef enum
+{
+  EXR_COMPRESSION_NONE,
+  EXR_COMPRESSION_RLE,
+  EXR_COMPRESSION_ZIPS,
+  EXR_COMPRESSION_ZIP,
+  EXR_COMPRESSION_PIZ,
+  EXR_COMPRESSION_PXR24,
+  EXR_COMPRESSION_B44,
+  EXR_COMPRESSION_B44A,
+  EXR_COMPRESSION_DWAA,
+  EXR_COMPRESSION_DWAB
+} EXRCompression;
+
 
 EXRLoader        * exr_loader_new            (const char *filename);
 
@@ -58,10 +73,33 @@ guchar           * exr_loader_get_exif       (EXRLoader  *loader,
 guchar           * exr_loader_get_xmp        (EXRLoader  *loader,
                                               guint      *size);
 
-int                exr_loader_read_pixel_row (EXRLoader *loader,
-                                              char      *pixels,
-                                              int        bpp,
-                                              int        row);
+int                exr_loader_read_pixel_rows (EXRLoader *loader,
+                                               char      *pixels,
+                                               int        bpp,
+                                               int        row,
+                                               int        n_rows);
+
+/* precision must be PREC_HALF or PREC_FLOAT.  a tile_size of 0 writes
+ * a scanline file, otherwise the rows passed to
+ * exr_writer_write_pixel_rows() must start at a row of tiles and, but
+ * for the last call, cover whole rows of tiles.  rows must be written
+ * from top to bottom.
+ */
+EXRWriter        * exr_writer_new            (const char     *filename,
+                                              int             width,
+                                              int             height,
+                                              EXRImageType    image_type,
+                                              int             has_alpha,
+                                              EXRPrecision    precision,
+                                              EXRCompression  compression,
+                                              int             tile_size);
+void               exr_writer_free           (EXRWriter      *writer);
+
+int                exr_writer_write_pixel_rows (EXRWriter  *writer,
+                                                const char *pixels,
+                                                int         bpp,
+                                                int         row,
+                                                int         n_rows);
 
 G_END_DECLS
 
@@ -59,6 +59,7 @@ GimpImage *
 load_image (GFile        *file,
             GimpRunMode   runmode,
             gboolean      preview,
+            gint          size,
             gboolean     *resolution_loaded,
             GError      **error)
 {
@@ -163,6 +164,24 @@ load_image (GFile        *file,
 
   cinfo.dct_method = JDCT_FLOAT;
 
+  /* When only a small version of the image is wanted, let the library
+   * scale by 1/2, 1/4 or 1/8 while doing the inverse DCT, which costs a
+   * fraction of a full size decode.
+   */
+  if (size > 0)
+    {
+      gint max_size = MAX (cinfo.image_width, cinfo.image_height);
+
+      cinfo.scale_num   = 1;
+      cinfo.scale_denom = 1;
+
+      while (cinfo.scale_denom < 8 &&
+             max_size / (gint) (cinfo.scale_denom * 2) >= size)
+        {
+          cinfo.scale_denom *= 2;
+        }
+    }
+
   /* Step 5: Start decompressor */
 
   jpeg_start_decompress (&cinfo);
@@ -513,6 +532,7 @@ jpeg_load_sanitize_comment (gchar *comment)
 
 GimpImage *
 load_thumbnail_image (GFile         *file,
+                      gint           size,
                       gint          *width,
                       gint          *height,
                       GimpImageType *type,
@@ -526,7 +546,15 @@ load_thumbnail_image (GFile         *file,
   gimp_progress_init_printf (_("Opening thumbnail for '%s'"),
                              g_file_get_parse_name (file));
 
-  image = gimp_image_metadata_load_thumbnail (file, error);
+  image = gimp_image_metadata_load_thumbnail (file, NULL);
+
+  /* without an Exif thumbnail, decode a scaled down version of the
+   * image instead
+   */
+  if (! image)
+    image = load_image (file, GIMP_RUN_NONINTERACTIVE, FALSE, size,
+                        NULL, error);
+
   if (! image)
     return NULL;
 
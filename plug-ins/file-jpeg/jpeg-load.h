@@ -21,10 +21,12 @@
 GimpImage * load_image           (GFile        *file,
                                   GimpRunMode   runmode,
                                   gboolean      preview,
+                                  gint          size,
                                   gboolean     *resolution_loaded,
                                   GError      **error);
 
 GimpImage * load_thumbnail_image (GFile         *file,
+                                  gint           size,
                                   gint          *width,
                                   gint          *height,
                                   GimpImageType *type,
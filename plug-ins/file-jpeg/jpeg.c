@@ -334,7 +334,7 @@ jpeg_load (GimpProcedure        *procedure,
       break;
     }
 
-  image = load_image (file, run_mode, FALSE,
+  image = load_image (file, run_mode, FALSE, 0,
                       &resolution_loaded, &error);
 
   if (image)
@@ -392,7 +392,7 @@ jpeg_load_thumb (GimpProcedure        *procedure,
   preview_image = NULL;
   preview_layer = NULL;
 
-  image = load_thumbnail_image (file, &width, &height, &type,
+  image = load_thumbnail_image (file, size, &width, &height, &type,
                                 &error);
 
 
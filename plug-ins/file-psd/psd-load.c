@@ -38,6 +38,18 @@
 
 #define COMP_MODE_SIZE sizeof(guint16)
 
+#define PACKBITS_ROWS_PER_THREAD 64
+
+
+typedef struct
+{
+  const gchar   *src;
+  const gsize   *offsets;
+  const guint32 *rle_pack_len;
+  gchar         *dst;
+  guint32        readline_len;
+} PackBitsData;
+
 
 /*  Local function prototypes  */
 static gint             read_header_block          (PSDimage       *img_a,
@@ -106,6 +118,10 @@ static gint             read_channel_data          (PSDchannel     *channel,
                                                     guint32         comp_len,
                                                     GError        **error);
 
+static void             decode_packbits_rows       (gsize           offset,
+                                                    gsize           size,
+                                                    PackBitsData   *data);
+
 static void             convert_1_bit              (const gchar    *src,
                                                     gchar          *dst,
                                                     guint32         rows,
@@ -2579,6 +2595,22 @@ get_gimp_image_type (GimpImageBaseType image_base_type,
   return image_type;
 }
 
+static void
+decode_packbits_rows (gsize         offset,
+                      gsize         size,
+                      PackBitsData *data)
+{
+  gsize i;
+
+  /* FIXME check for errors returned from decode packbits */
+  for (i = offset; i < offset + size; i++)
+    {
+      decode_packbits (data->src + data->offsets[i],
+                       data->dst + i * data->readline_len,
+                       data->rle_pack_len[i], data->readline_len);
+    }
+}
+
 static voidpf
 zzalloc (voidpf opaque, uInt items, uInt size)
 {
@@ -2635,27 +2667,60 @@ read_channel_data (PSDchannel     *channel,
         break;
 
       case PSD_COMP_RLE:
-        for (i = 0; i < channel->rows; ++i)
-          {
-            src = gegl_scratch_alloc (rle_pack_len[i]);
+        {
+          PackBitsData  data;
+          gsize        *offsets;
+          gsize         packed_len = 0;
+
+          /*  read all rows in one go, and decode them in parallel, the
+           *  rows are compressed independently of each other
+           */
+          offsets = g_new (gsize, channel->rows);
+
+          for (i = 0; i < channel->rows; ++i)
+            {
+              offsets[i]  = packed_len;
+              packed_len += rle_pack_len[i];
+            }
+
+          if (packed_len > G_MAXINT)
+            {
+              g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_FAILED,
+                           _("Unsupported or invalid channel size"));
+              g_free (offsets);
+              return -1;
+            }
+
+          src = g_malloc (MAX (packed_len, 1));
 /*      FIXME check for over-run
-            if (PSD_TELL(input) + rle_pack_len[i] > block_end)
-              {
-                psd_set_error (TRUE, errno, error);
-                return -1;
-              }
+          if (PSD_TELL(input) + packed_len > block_end)
+            {
+              psd_set_error (TRUE, errno, error);
+              return -1;
+            }
 */
-            if (psd_read (input, src, rle_pack_len[i], error) < rle_pack_len[i])
-              {
-                psd_set_error (error);
-                gegl_scratch_free (src);
-                return -1;
-              }
-            /* FIXME check for errors returned from decode packbits */
-            decode_packbits (src, raw_data + i * readline_len,
-                             rle_pack_len[i], readline_len);
-            gegl_scratch_free (src);
-          }
+          if (psd_read (input, src, packed_len, error) < (gint) packed_len)
+            {
+              psd_set_error (error);
+              g_free (offsets);
+              g_free (src);
+              return -1;
+            }
+
+          data.src          = src;
+          data.offsets      = offsets;
+          data.rle_pack_len = rle_pack_len;
+          data.dst          = raw_data;
+          data.readline_len = readline_len;
+
+          gegl_parallel_distribute_range (
+            channel->rows, PACKBITS_ROWS_PER_THREAD,
+            (GeglParallelDistributeRangeFunc) decode_packbits_rows,
+            &data);
+
+          g_free (offsets);
+          g_free (src);
+        }
         break;
       case PSD_COMP_ZIP:
       case PSD_COMP_ZIP_PRED:
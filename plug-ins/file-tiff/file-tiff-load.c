@@ -1865,6 +1865,7 @@ load_contiguous (TIFF         *tif,
   const Babl *src_format;
   guchar     *buffer;
   guchar     *bw_buffer = NULL;
+  gsize       scanline_size = 0;
   gdouble     progress  = 0.0;
   gdouble     one_row;
   guint32     y;
@@ -1887,10 +1888,16 @@ load_contiguous (TIFF         *tif,
     }
   else
     {
+      /*  read a block of scanlines at a time, so that the drawable's
+       *  buffer is written a whole tile row at a time, instead of one
+       *  pixel row at a time
+       */
       tile_width  = image_width;
-      tile_height = 1;
+      tile_height = MAX (MIN (gimp_tile_height (), image_height), 1);
 
-      buffer = g_malloc (TIFFScanlineSize (tif));
+      scanline_size = TIFFScanlineSize (tif);
+
+      buffer = g_malloc (scanline_size * tile_height);
     }
 
   if (tiff_mode != GIMP_TIFF_DEFAULT && bps < 8)
@@ -1926,6 +1933,9 @@ load_contiguous (TIFF         *tif,
           gimp_progress_update (progress + one_row *
                                 ((gdouble) x / (gdouble) image_width));
 
+          cols = MIN (image_width  - x, tile_width);
+          rows = MIN (image_height - y, tile_height);
+
           if (TIFFIsTiled (tif))
             {
               if (TIFFReadTile (tif, buffer, x, y, 0, 0) == -1)
@@ -1936,17 +1946,23 @@ load_contiguous (TIFF         *tif,
                   return;
                 }
             }
-          else if (TIFFReadScanline (tif, buffer, y, 0) == -1)
+          else
             {
-              /* Error reading scanline, stop loading */
-              g_message (_("Reading scanline failed. Image may be corrupt at line %d."), y);
-              g_free (buffer);
-              g_free (bw_buffer);
-              return;
-            }
+              guint32 row;
 
-          cols = MIN (image_width  - x, tile_width);
-          rows = MIN (image_height - y, tile_height);
+              for (row = 0; row < rows; row++)
+                {
+                  if (TIFFReadScanline (tif, buffer + row * scanline_size,
+                                        y + row, 0) == -1)
+                    {
+                      /* Error reading scanline, stop loading */
+                      g_message (_("Reading scanline failed. Image may be corrupt at line %d."), y + row);
+                      g_free (buffer);
+                      g_free (bw_buffer);
+                      return;
+                    }
+                }
+            }
 
           if (needs_upscale)
             {
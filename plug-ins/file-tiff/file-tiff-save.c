@@ -418,7 +418,6 @@ save_layer (TIFF        *tif,
   switch (drawable_type)
     {
     case GIMP_RGB_IMAGE:
-      predictor       = 2;
       samplesperpixel = 3;
       photometric     = PHOTOMETRIC_RGB;
       alpha           = FALSE;
@@ -463,7 +462,6 @@ save_layer (TIFF        *tif,
       break;
 
     case GIMP_RGBA_IMAGE:
-      predictor       = 2;
       samplesperpixel = 4;
       photometric     = PHOTOMETRIC_RGB;
       alpha           = TRUE;
@@ -606,6 +604,19 @@ save_layer (TIFF        *tif,
       goto out;
     }
 
+  /* differencing only helps continuous-tone data.  floating point
+   * samples get their own predictor, libtiff's horizontal differencing
+   * barely shrinks them and refuses 64-bit samples altogether.
+   */
+  if (drawable_type != GIMP_INDEXED_IMAGE &&
+      drawable_type != GIMP_INDEXEDA_IMAGE)
+    {
+      if (sampleformat == SAMPLEFORMAT_IEEEFP)
+        predictor = PREDICTOR_FLOATINGPOINT;
+      else
+        predictor = PREDICTOR_HORIZONTAL;
+    }
+
   format = babl_format_with_space (babl_format_get_encoding (format),
                                    space ? space : gegl_buffer_get_format (buffer));
 
@@ -241,6 +241,7 @@ save_layer (GFile         *file,
       webp_config.lossless      = lossless;
       webp_config.method        = 6;  /* better quality */
       webp_config.alpha_quality = alpha_quality;
+      webp_config.thread_level  = 1;  /* use libwebp's worker threads */
 
       /* Prepare the WebP structure */
       WebPPictureInit (&picture);
@@ -704,6 +705,7 @@ save_animation (GFile         *file,
           webp_config.method        = 6;  /* better quality */
           webp_config.alpha_quality = alpha_quality;
           webp_config.exact         = 1;
+          webp_config.thread_level  = 1;
 
           WebPMemoryWriterInit (&mw);
 
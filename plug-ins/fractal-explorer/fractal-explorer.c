@@ -84,6 +84,29 @@ struct _ExplorerClass
 };
 
 
+/* the rows are rendered in parallel into bands of BAND_HEIGHT rows, each of
+ * which is written at once when done.  N_BANDS bands are in flight, so that
+ * the render threads don't wait for a band to be written.
+ */
+#define BAND_HEIGHT 64
+#define N_BANDS     3
+
+typedef struct
+{
+  guchar *dest;
+  gint    row;
+  gint    n_rows;
+  gint    width;
+  gint    bpp;
+  gint    next_row;
+
+  GMutex  mutex;
+  GCond   cond;
+  gint    slot_band[N_BANDS];
+  gint    slot_n_done[N_BANDS];
+} ExplorerRender;
+
+
 #define EXPLORER_TYPE  (explorer_get_type ())
 #define EXPLORER (obj) (G_TYPE_CHECK_INSTANCE_CAST ((obj), EXPLORER_TYPE, Explorer))
 
@@ -102,6 +125,7 @@ static GimpValueArray * explorer_run              (GimpProcedure        *procedu
                                                    gpointer              run_data);
 
 static void       explorer                         (GimpDrawable       *drawable);
+static gpointer   explorer_render_func             (ExplorerRender     *render);
 
 static void       delete_dialog_callback           (GtkWidget          *widget,
                                                     gboolean            value,
@@ -508,19 +532,21 @@ explorer_run (GimpProcedure        *procedure,
 static void
 explorer (GimpDrawable *drawable)
 {
-  GeglBuffer *src_buffer;
-  GeglBuffer *dest_buffer;
-  const Babl *format;
-  gint        width;
-  gint        height;
-  gint        bpp;
-  gint        row;
-  gint        x;
-  gint        y;
-  gint        w;
-  gint        h;
-  guchar     *src_row;
-  guchar     *dest_row;
+  GeglBuffer    *dest_buffer;
+  const Babl    *format;
+  gint           width;
+  gint           height;
+  gint           bpp;
+  gint           n_threads;
+  GThread      **threads;
+  ExplorerRender render;
+  gint           n_bands;
+  gint           band;
+  gint           x;
+  gint           y;
+  gint           w;
+  gint           h;
+  gint           i;
 
   /* Get the input area. This is the bounding box of the selection in
    *  the image (or the entire image if there is no selection). Only
@@ -544,11 +570,9 @@ explorer (GimpDrawable *drawable)
 
   bpp = babl_format_get_bytes_per_pixel (format);
 
-  /*  allocate row buffers  */
-  src_row  = g_new (guchar, bpp * w);
-  dest_row = g_new (guchar, bpp * w);
-
-  src_buffer  = gimp_drawable_get_buffer (drawable);
+  /*  the rendered pixels don't depend on the source pixels, so only the
+   *  destination is accessed
+   */
   dest_buffer = gimp_drawable_get_shadow_buffer (drawable);
 
   xbild = width;
@@ -556,31 +580,79 @@ explorer (GimpDrawable *drawable)
   xdiff = (xmax - xmin) / xbild;
   ydiff = (ymax - ymin) / ybild;
 
-  for (row = y; row < y + h; row++)
+  /*  explorer_render_row() only reads the global parameters, so the rows
+   *  can be rendered on several threads at once.  the threads are started
+   *  once, and take rows from a single counter, while this thread writes
+   *  the bands they fill, in order.
+   */
+  n_threads = MAX (gimp_get_num_processors (), 1);
+  threads   = g_new (GThread *, n_threads);
+
+  render.dest     = g_new (guchar, bpp * w * BAND_HEIGHT * N_BANDS);
+  render.row      = y;
+  render.n_rows   = h;
+  render.width    = w;
+  render.bpp      = bpp;
+  render.next_row = 0;
+
+  g_mutex_init (&render.mutex);
+  g_cond_init (&render.cond);
+
+  for (i = 0; i < N_BANDS; i++)
     {
-      gegl_buffer_get (src_buffer, GEGL_RECTANGLE (x, row, w, 1), 1.0,
-                       format, src_row,
-                       GEGL_AUTO_ROWSTRIDE, GEGL_ABYSS_NONE);
-
-      explorer_render_row (src_row,
-                           dest_row,
-                           row,
-                           w,
-                           bpp);
-
-      gegl_buffer_set (dest_buffer, GEGL_RECTANGLE (x, row, w, 1), 0,
-                       format, dest_row,
+      render.slot_band[i]   = i;
+      render.slot_n_done[i] = 0;
+    }
+
+  for (i = 0; i < n_threads; i++)
+    threads[i] = g_thread_new ("fractal-explorer",
+                               (GThreadFunc) explorer_render_func,
+                               &render);
+
+  n_bands = (h + BAND_HEIGHT - 1) / BAND_HEIGHT;
+
+  for (band = 0; band < n_bands; band++)
+    {
+      gint slot   = band % N_BANDS;
+      gint n_rows = MIN (BAND_HEIGHT, h - band * BAND_HEIGHT);
+
+      g_mutex_lock (&render.mutex);
+
+      while (render.slot_n_done[slot] < n_rows)
+        g_cond_wait (&render.cond, &render.mutex);
+
+      g_mutex_unlock (&render.mutex);
+
+      gegl_buffer_set (dest_buffer,
+                       GEGL_RECTANGLE (x, y + band * BAND_HEIGHT, w, n_rows),
+                       0, format,
+                       render.dest + slot * BAND_HEIGHT * w * bpp,
                        GEGL_AUTO_ROWSTRIDE);
 
-      if ((row % 10) == 0)
-        gimp_progress_update ((double) row / (double) h);
+      /*  hand the slot over to the band after the ones in flight  */
+      g_mutex_lock (&render.mutex);
+
+      render.slot_band[slot]   = band + N_BANDS;
+      render.slot_n_done[slot] = 0;
+
+      g_cond_broadcast (&render.cond);
+
+      g_mutex_unlock (&render.mutex);
+
+      gimp_progress_update ((double) (band * BAND_HEIGHT + n_rows) /
+                            (double) h);
     }
 
-  g_object_unref (src_buffer);
+  for (i = 0; i < n_threads; i++)
+    g_thread_join (threads[i]);
+
+  g_mutex_clear (&render.mutex);
+  g_cond_clear (&render.cond);
+
   g_object_unref (dest_buffer);
 
-  g_free (src_row);
-  g_free (dest_row);
+  g_free (render.dest);
+  g_free (threads);
 
   gimp_progress_update (1.0);
 
@@ -589,6 +661,47 @@ explorer (GimpDrawable *drawable)
   gimp_drawable_update (drawable, x, y, w, h);
 }
 
+static gpointer
+explorer_render_func (ExplorerRender *render)
+{
+  gint i;
+
+  while ((i = g_atomic_int_add (&render->next_row, 1)) < render->n_rows)
+    {
+      gint band = i / BAND_HEIGHT;
+      gint slot = band % N_BANDS;
+
+      /*  wait for the band's slot to be written, and handed over to it  */
+      g_mutex_lock (&render->mutex);
+
+      while (render->slot_band[slot] != band)
+        g_cond_wait (&render->cond, &render->mutex);
+
+      g_mutex_unlock (&render->mutex);
+
+      explorer_render_row (NULL,
+                           render->dest +
+                           (slot * BAND_HEIGHT + i % BAND_HEIGHT) *
+                           render->width * render->bpp,
+                           render->row + i,
+                           render->width,
+                           render->bpp);
+
+      g_mutex_lock (&render->mutex);
+
+      /*  wake up the writing thread once the band is done  */
+      if (++render->slot_n_done[slot] ==
+          MIN (BAND_HEIGHT, render->n_rows - band * BAND_HEIGHT))
+        {
+          g_cond_broadcast (&render->cond);
+        }
+
+      g_mutex_unlock (&render->mutex);
+    }
+
+  return NULL;
+}
+
 /**********************************************************************
  FUNCTION: explorer_render_row
  *********************************************************************/
@@ -191,6 +191,14 @@ choose_best_brush (ppm_t *p, ppm_t *a, int tx, int ty,
                     dev += a->col[(ty + y) * a->width * 3 + (tx + x) * 3] * v;
                 }
             }
+
+          /* The deviation can only grow from here on, so once it is
+           * worse than the best one so far, this brush can be neither
+           * chosen nor tied with it.  The best one is never below
+           * devthresh either, or the search would have stopped there.
+           */
+          if (best >= 0 && dev / thissum > bestdev)
+            break;
         }
       dev /= thissum;
 
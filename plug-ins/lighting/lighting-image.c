@@ -26,6 +26,13 @@ const Babl   *bump_format;
 GimpDrawable *env_drawable;
 GeglBuffer   *env_buffer;
 
+/* Samplers keep the tiles around the last sampled pixel at hand, instead
+ * of looking them up again for every pixel, as gegl_buffer_sample() does.
+ */
+static GeglSampler *source_sampler = NULL;
+static gboolean     source_has_alpha;
+static GeglSampler *env_sampler    = NULL;
+
 guchar          *preview_rgb_data = NULL;
 gint             preview_rgb_stride;
 cairo_surface_t *preview_surface = NULL;
@@ -73,11 +80,9 @@ peek (gint x,
 {
   GimpRGB color;
 
-  gegl_buffer_sample (source_buffer, x, y, NULL,
-                      &color, babl_format ("R'G'B'A double"),
-                      GEGL_SAMPLER_NEAREST, GEGL_ABYSS_NONE);
+  gegl_sampler_get (source_sampler, x, y, NULL, &color, GEGL_ABYSS_NONE);
 
-  if (! babl_format_has_alpha (gegl_buffer_get_format (source_buffer)))
+  if (! source_has_alpha)
     color.a = 1.0;
 
   return color;
@@ -98,9 +103,7 @@ peek_env_map (gint x,
   else if (y >= env_height)
     y = env_height - 1;
 
-  gegl_buffer_sample (env_buffer, x, y, NULL,
-                      &color, babl_format ("R'G'B'A double"),
-                      GEGL_SAMPLER_NEAREST, GEGL_ABYSS_NONE);
+  gegl_sampler_get (env_sampler, x, y, NULL, &color, GEGL_ABYSS_NONE);
 
   color.a = 1.0;
 
@@ -363,6 +366,13 @@ image_setup (GimpDrawable *drawable,
 
   source_buffer = gimp_drawable_get_buffer (input_drawable);
 
+  g_clear_object (&source_sampler);
+  source_sampler = gegl_buffer_sampler_new (source_buffer,
+                                            babl_format ("R'G'B'A double"),
+                                            GEGL_SAMPLER_NEAREST);
+  source_has_alpha =
+    babl_format_has_alpha (gegl_buffer_get_format (source_buffer));
+
   maxcounter = (glong) width * (glong) height;
 
   if (interactive)
@@ -403,5 +413,9 @@ envmap_setup (GimpDrawable *envmap)
       env_height = gimp_drawable_get_height (envmap);
 
       env_buffer = gimp_drawable_get_buffer (envmap);
+
+      env_sampler = gegl_buffer_sampler_new (env_buffer,
+                                             babl_format ("R'G'B'A double"),
+                                             GEGL_SAMPLER_NEAREST);
     }
 }
@@ -135,7 +135,14 @@ init_compute (void)
           {
             box_drawables[i] = gimp_drawable_get_by_id (mapvals.boxmap_id[i]);
 
+            g_clear_object (&box_buffers[i]);
             box_buffers[i] = gimp_drawable_get_buffer (box_drawables[i]);
+
+            g_clear_object (&box_samplers[i]);
+            box_samplers[i] =
+              gegl_buffer_sampler_new (box_buffers[i],
+                                       babl_format ("R'G'B'A double"),
+                                       GEGL_SAMPLER_NEAREST);
           }
 
         break;
@@ -172,7 +179,14 @@ init_compute (void)
           {
             cylinder_drawables[i] = gimp_drawable_get_by_id (mapvals.cylindermap_id[i]);;
 
+            g_clear_object (&cylinder_buffers[i]);
             cylinder_buffers[i] = gimp_drawable_get_buffer (cylinder_drawables[i]);
+
+            g_clear_object (&cylinder_samplers[i]);
+            cylinder_samplers[i] =
+              gegl_buffer_sampler_new (cylinder_buffers[i],
+                                       babl_format ("R'G'B'A double"),
+                                       GEGL_SAMPLER_NEAREST);
           }
         break;
     }
@@ -307,6 +321,8 @@ compute_image (void)
                                       NULL);
     }
 
+  poke_flush ();
+
   gimp_progress_update (1.0);
 
   g_object_unref (source_buffer);
@@ -32,9 +32,25 @@ GeglBuffer   *dest_buffer;
 
 GimpDrawable *box_drawables[6];
 GeglBuffer   *box_buffers[6];
+GeglSampler  *box_samplers[6];
 
 GimpDrawable *cylinder_drawables[2];
 GeglBuffer   *cylinder_buffers[2];
+GeglSampler  *cylinder_samplers[2];
+
+/* Samplers keep the tiles around the last sampled pixel at hand, instead
+ * of looking them up again for every pixel, as gegl_buffer_sample() does.
+ */
+static GeglSampler *source_sampler = NULL;
+static gboolean     source_has_alpha;
+
+/* poke() collects consecutive pixels of a row here, and writes them to
+ * dest_buffer in one go.
+ */
+static GimpRGB *dest_row   = NULL;
+static gint     dest_row_y = -1;
+static gint     dest_row_x1;
+static gint     dest_row_x2;
 
 guchar          *preview_rgb_data = NULL;
 gint             preview_rgb_stride;
@@ -56,11 +72,9 @@ peek (gint x,
 {
   GimpRGB color;
 
-  gegl_buffer_sample (source_buffer, x, y, NULL,
-                      &color, babl_format ("R'G'B'A double"),
-                      GEGL_SAMPLER_NEAREST, GEGL_ABYSS_NONE);
+  gegl_sampler_get (source_sampler, x, y, NULL, &color, GEGL_ABYSS_NONE);
 
-  if (! babl_format_has_alpha (gegl_buffer_get_format (source_buffer)))
+  if (! source_has_alpha)
     color.a = 1.0;
 
   return color;
@@ -73,9 +87,8 @@ peek_box_image (gint image,
 {
   GimpRGB color;
 
-  gegl_buffer_sample (box_buffers[image], x, y, NULL,
-                      &color, babl_format ("R'G'B'A double"),
-                      GEGL_SAMPLER_NEAREST, GEGL_ABYSS_NONE);
+  gegl_sampler_get (box_samplers[image], x, y, NULL, &color,
+                    GEGL_ABYSS_NONE);
 
   if (! babl_format_has_alpha (gegl_buffer_get_format (box_buffers[image])))
     color.a = 1.0;
@@ -90,9 +103,8 @@ peek_cylinder_image (gint image,
 {
   GimpRGB color;
 
-  gegl_buffer_sample (cylinder_buffers[image], x, y, NULL,
-                      &color, babl_format ("R'G'B'A double"),
-                      GEGL_SAMPLER_NEAREST, GEGL_ABYSS_NONE);
+  gegl_sampler_get (cylinder_samplers[image], x, y, NULL, &color,
+                    GEGL_ABYSS_NONE);
 
   if (! babl_format_has_alpha (gegl_buffer_get_format (cylinder_buffers[image])))
     color.a = 1.0;
@@ -106,9 +118,31 @@ poke (gint      x,
       GimpRGB  *color,
       gpointer  user_data)
 {
-  gegl_buffer_set (dest_buffer, GEGL_RECTANGLE (x, y, 1, 1), 0,
-                   babl_format ("R'G'B'A double"), color,
+  if (y != dest_row_y || x != dest_row_x2 + 1)
+    {
+      poke_flush ();
+
+      dest_row_y  = y;
+      dest_row_x1 = x;
+    }
+
+  dest_row[x] = *color;
+  dest_row_x2 = x;
+}
+
+void
+poke_flush (void)
+{
+  if (dest_row_y < 0)
+    return;
+
+  gegl_buffer_set (dest_buffer,
+                   GEGL_RECTANGLE (dest_row_x1, dest_row_y,
+                                   dest_row_x2 - dest_row_x1 + 1, 1), 0,
+                   babl_format ("R'G'B'A double"), &dest_row[dest_row_x1],
                    GEGL_AUTO_ROWSTRIDE);
+
+  dest_row_y = -1;
 }
 
 gint
@@ -326,6 +360,17 @@ image_setup (GimpDrawable *drawable,
 
   source_buffer = gimp_drawable_get_buffer (input_drawable);
 
+  g_clear_object (&source_sampler);
+  source_sampler = gegl_buffer_sampler_new (source_buffer,
+                                            babl_format ("R'G'B'A double"),
+                                            GEGL_SAMPLER_NEAREST);
+  source_has_alpha =
+    babl_format_has_alpha (gegl_buffer_get_format (source_buffer));
+
+  g_free (dest_row);
+  dest_row   = g_new (GimpRGB, width);
+  dest_row_y = -1;
+
   maxcounter = (glong) width * (glong) height;
 
   if (mapvals.transparent_background == TRUE)
@@ -13,9 +13,11 @@ extern GeglBuffer   *dest_buffer;
 
 extern GimpDrawable *box_drawables[6];
 extern GeglBuffer   *box_buffers[6];
+extern GeglSampler  *box_samplers[6];
 
 extern GimpDrawable *cylinder_drawables[2];
 extern GeglBuffer   *cylinder_buffers[2];
+extern GeglSampler  *cylinder_samplers[2];
 
 extern guchar          *preview_rgb_data;
 extern gint             preview_rgb_stride;
@@ -44,6 +46,7 @@ extern void        poke                     (gint          x,
                                              gint          y,
                                              GimpRGB      *color,
                                              gpointer      user_data);
+extern void        poke_flush               (void);
 extern GimpVector3 int_to_pos               (gint          x,
                                              gint          y);
 extern void        pos_to_int               (gdouble       x,
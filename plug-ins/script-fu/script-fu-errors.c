@@ -153,16 +153,27 @@ implementation_error (scheme       *sc,
 
 /* Debug helpers.
  * Enabled by G_MESSAGES_DEBUG=scriptfu env var.
- * FUTURE: For performance, return early if not debugging.
- * Or conditionally compile.
+ * They are called for every argument of every PDB call,
+ * so return early if not debugging.
  */
 
+static gboolean
+debug_enabled (void)
+{
+  return ! g_log_writer_default_would_drop (G_LOG_LEVEL_DEBUG, G_LOG_DOMAIN);
+}
+
 void
 debug_vector (scheme        *sc,
               const pointer  vector,
               const char    *format)
 {
-  glong count = sc->vptr->vector_length (vector);
+  glong count;
+
+  if (! debug_enabled ())
+    return;
+
+  count = sc->vptr->vector_length (vector);
 
   g_debug ("vector has %ld elements", count);
   if (count > 0)
@@ -195,6 +206,9 @@ debug_list (scheme       *sc,
             const char   *format,
             const guint   num_elements)
 {
+  if (! debug_enabled ())
+    return;
+
   g_return_if_fail (num_elements == sc->vptr->list_length (sc, list));
   g_debug ("list has %d elements", num_elements);
   if (num_elements > 0)
@@ -220,6 +234,9 @@ debug_in_arg (scheme           *sc,
               const guint       arg_index,
               const gchar      *type_name )
 {
+  if (! debug_enabled ())
+    return;
+
   g_debug ("param %d - expecting type %s", arg_index + 1, type_name );
   g_debug ("actual arg is type %s (%d)",
            ts_types[ type(sc->vptr->pair_car (a)) ],
@@ -235,6 +252,9 @@ debug_gvalue (const GValue     *value)
   char        *contents_str;
   const char  *type_name;
 
+  if (! debug_enabled ())
+    return;
+
   type_name = G_VALUE_TYPE_NAME(value);
   contents_str = g_strdup_value_contents (value);
   g_debug ("Value: %s Type: %s", contents_str, type_name);
@@ -61,6 +61,7 @@ typedef struct
   gchar      *last_command;
   gint        command_count;
   gint        consec_command_count;
+  gint64      last_report_time;
 
   gboolean    running;
 } SFInterface;
@@ -137,6 +138,8 @@ script_fu_interface_is_active (void)
 void
 script_fu_interface_report_cc (const gchar *command)
 {
+  gint64 now;
+
   if (sf_interface == NULL)
     return;
 
@@ -144,17 +147,6 @@ script_fu_interface_report_cc (const gchar *command)
       strcmp (sf_interface->last_command, command) == 0)
     {
       sf_interface->command_count++;
-
-      if (! g_str_has_prefix (command, "gimp-progress-"))
-        {
-          gchar *new_command;
-
-          new_command = g_strdup_printf ("%s <%d>",
-                                         command, sf_interface->command_count);
-          gtk_label_set_text (GTK_LABEL (sf_interface->progress_label),
-                              new_command);
-          g_free (new_command);
-        }
     }
   else
     {
@@ -162,16 +154,37 @@ script_fu_interface_report_cc (const gchar *command)
 
       g_free (sf_interface->last_command);
       sf_interface->last_command = g_strdup (command);
+    }
 
-      if (! g_str_has_prefix (command, "gimp-progress-"))
-        {
-          gtk_label_set_text (GTK_LABEL (sf_interface->progress_label),
-                              command);
-        }
-      else
-        {
-          gtk_label_set_text (GTK_LABEL (sf_interface->progress_label), "");
-        }
+  /*  this is called for every PDB call a script makes, updating the
+   *  label and running the main loop on each of them would make tight
+   *  loops crawl
+   */
+  now = g_get_monotonic_time ();
+
+  if (now - sf_interface->last_report_time < G_TIME_SPAN_SECOND / 20)
+    return;
+
+  sf_interface->last_report_time = now;
+
+  if (g_str_has_prefix (command, "gimp-progress-"))
+    {
+      gtk_label_set_text (GTK_LABEL (sf_interface->progress_label), "");
+    }
+  else if (sf_interface->command_count > 1)
+    {
+      gchar *new_command;
+
+      new_command = g_strdup_printf ("%s <%d>",
+                                     command, sf_interface->command_count);
+      gtk_label_set_text (GTK_LABEL (sf_interface->progress_label),
+                          new_command);
+      g_free (new_command);
+    }
+  else
+    {
+      gtk_label_set_text (GTK_LABEL (sf_interface->progress_label),
+                          command);
     }
 
   while (gtk_events_pending ())
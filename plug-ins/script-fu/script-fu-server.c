@@ -165,6 +165,9 @@ static void      server_start       (const gchar *listen_ip,
                                      gint         port,
                                      const gchar *logfile);
 static gboolean  execute_command    (SFCommand   *cmd);
+static gboolean  send_to_client     (gint         filedes,
+                                     const gchar *data,
+                                     gsize        len);
 static gint      read_from_client   (gint         filedes);
 static gint      make_socket        (const struct addrinfo
                                                  *ai);
@@ -551,7 +554,6 @@ execute_command (SFCommand *cmd)
   GString    *response;
   time_t      clocknow;
   gboolean    error;
-  gint        i;
   gdouble     total_time;
   GTimer     *timer;
 
@@ -587,28 +589,47 @@ execute_command (SFCommand *cmd)
   buffer[RSP_LEN_H_BYTE] = (guchar) (response->len >> 8);
   buffer[RSP_LEN_L_BYTE] = (guchar) (response->len & 0xFF);
 
-  /*  Write the response to the client  */
-  for (i = 0; i < RESPONSE_HEADER; i++)
-    if (cmd->filedes > 0 && send (cmd->filedes, (const void *) (buffer + i), 1, 0) < 0)
-      {
-        /*  Write error  */
-        print_socket_api_error ("send");
-        return FALSE;
-      }
+  /*  Write the response to the client, header and all in one go, instead
+   *  of a send() per byte, and without giving Nagle's algorithm a small
+   *  header packet to hold back
+   */
+  g_string_prepend_len (response, (const gchar *) buffer, RESPONSE_HEADER);
 
-  for (i = 0; i < response->len; i++)
-    if (cmd->filedes > 0 && send (cmd->filedes, response->str + i, 1, 0) < 0)
-      {
-        /*  Write error  */
-        print_socket_api_error ("send");
-        return FALSE;
-      }
+  if (cmd->filedes > 0)
+    send_to_client (cmd->filedes, response->str, response->len);
 
   g_string_free (response, TRUE);
 
   return FALSE;
 }
 
+static gboolean
+send_to_client (gint         filedes,
+                const gchar *data,
+                gsize        len)
+{
+  while (len > 0)
+    {
+      gint nbytes = send (filedes, (const void *) data, len, 0);
+
+      if (nbytes < 0)
+        {
+#ifndef G_OS_WIN32
+          if (errno == EINTR)
+            continue;
+#endif
+          /*  Write error  */
+          print_socket_api_error ("send");
+          return FALSE;
+        }
+
+      data += nbytes;
+      len  -= nbytes;
+    }
+
+  return TRUE;
+}
+
 static gint
 read_from_client (gint filedes)
 {